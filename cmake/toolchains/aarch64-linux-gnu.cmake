@@ -0,0 +1,31 @@
+# Cross build for AArch64 Linux, tested under qemu-user:
+#
+#   cmake -S . -B build-a64 -DCMAKE_TOOLCHAIN_FILE=cmake/toolchains/aarch64-linux-gnu.cmake
+#   cmake --build build-a64 && ctest --test-dir build-a64 --output-on-failure
+#
+# Needs gcc-aarch64-linux-gnu (or set FAYASM_CROSS_PREFIX) and qemu-user.
+# ctest prefixes every test with CMAKE_CROSSCOMPILING_EMULATOR, so the
+# native-tier tests run AArch64 code generated by src/fa_jit_native_a64.c.
+set(CMAKE_SYSTEM_NAME Linux)
+set(CMAKE_SYSTEM_PROCESSOR aarch64)
+
+if(NOT DEFINED FAYASM_CROSS_PREFIX)
+    set(FAYASM_CROSS_PREFIX aarch64-linux-gnu-)
+endif()
+if(NOT DEFINED FAYASM_CROSS_SYSROOT)
+    set(FAYASM_CROSS_SYSROOT /usr/aarch64-linux-gnu)
+endif()
+
+set(CMAKE_C_COMPILER ${FAYASM_CROSS_PREFIX}gcc)
+set(CMAKE_FIND_ROOT_PATH ${FAYASM_CROSS_SYSROOT})
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+
+find_program(FAYASM_QEMU_AARCH64 NAMES qemu-aarch64 qemu-aarch64-static)
+if(NOT FAYASM_QEMU_AARCH64)
+    message(FATAL_ERROR "qemu-aarch64 not found: install qemu-user to run the AArch64 tests")
+endif()
+set(CMAKE_CROSSCOMPILING_EMULATOR ${FAYASM_QEMU_AARCH64} -L ${FAYASM_CROSS_SYSROOT})
+
+set(FAYASM_JIT_NATIVE_AARCH64 ON CACHE BOOL "Run the AArch64 native JIT backend on AArch64 Linux hosts" FORCE)
@@ -0,0 +1,93 @@
+#include "fa_aot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void print_usage(const char* exe) {
+    const char* name = (exe && exe[0] != '\0') ? exe : "fayasm_aot";
+    printf("Usage: %s <module.wasm> [-o <output.c>] [--prefix <name>]\n", name);
+    printf("Translates the module's functions into a C99 translation unit for fa_Runtime_setAotFunctions.\n");
+    printf("Writes to stdout without -o; the default symbol prefix is fa_aot.\n");
+    printf("Example: %s module.wasm -o module_aot.c --prefix module\n", name);
+}
+
+static WasmModule* load_module_from_path(const char* path) {
+    WasmModule* module = wasm_module_init(path);
+    if (!module) {
+        return NULL;
+    }
+    if (wasm_load_header(module) != 0 ||
+        wasm_scan_sections(module) != 0 ||
+        wasm_load_types(module) != 0 ||
+        wasm_load_functions(module) != 0 ||
+        wasm_load_memories(module) != 0 ||
+        wasm_load_globals(module) != 0) {
+        wasm_module_free(module);
+        return NULL;
+    }
+    return module;
+}
+
+int main(int argc, char** argv) {
+    const char* input = NULL;
+    const char* output = NULL;
+    fa_AotOptions options;
+    memset(&options, 0, sizeof(options));
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--prefix") == 0 && i + 1 < argc) {
+            options.prefix = argv[++i];
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!input && argv[i][0] != '-') {
+            input = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!input) {
+        print_usage(argc > 0 ? argv[0] : NULL);
+        return 2;
+    }
+    WasmModule* module = load_module_from_path(input);
+    if (!module) {
+        fprintf(stderr, "error: failed to load module '%s'\n", input);
+        return 1;
+    }
+    const char* base = strrchr(input, '/');
+    options.source_name = base ? base + 1 : input;
+    char* text = NULL;
+    size_t size = 0;
+    fa_AotStats stats;
+    if (!fa_aot_emit_c(module, &options, &text, &size, &stats)) {
+        fprintf(stderr, "error: code generation failed (is the prefix a C identifier?)\n");
+        wasm_module_free(module);
+        return 1;
+    }
+    wasm_module_free(module);
+    FILE* out = output ? fopen(output, "wb") : stdout;
+    if (!out) {
+        fprintf(stderr, "error: cannot open '%s' for writing\n", output);
+        free(text);
+        return 1;
+    }
+    const bool written = fwrite(text, 1, size, out) == size;
+    if (output && fclose(out) != 0) {
+        free(text);
+        fprintf(stderr, "error: failed to write '%s'\n", output);
+        return 1;
+    }
+    free(text);
+    if (!written) {
+        fprintf(stderr, "error: short write\n");
+        return 1;
+    }
+    fprintf(stderr, "fayasm_aot: %u functions, %u compiled, %u imported, %u left to the interpreter\n",
+            stats.function_count, stats.compiled_count, stats.imported_count,
+            stats.function_count - stats.compiled_count - stats.imported_count);
+    return 0;
+}
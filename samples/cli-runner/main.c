@@ -70,20 +70,12 @@ static int module_find_exported_function(const WasmModule* module,
     if (!module || !export_name || !out_function_index) {
         return 0;
     }
-    if (!module->exports || module->num_exports == 0) {
+    const WasmExport* export_desc = wasm_module_find_export(module, export_name, WASM_EXTERNAL_FUNCTION);
+    if (!export_desc) {
         return 0;
     }
-    for (uint32_t i = 0; i < module->num_exports; ++i) {
-        const WasmExport* export_desc = &module->exports[i];
-        if (!export_desc->name || export_desc->kind != 0) {
-            continue;
-        }
-        if (strcmp(export_desc->name, export_name) == 0) {
-            *out_function_index = export_desc->index;
-            return 1;
-        }
-    }
-    return 0;
+    *out_function_index = export_desc->index;
+    return 1;
 }
 
 static int value_matches_type(const fa_JobValue* value, uint32_t valtype) {
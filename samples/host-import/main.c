@@ -55,13 +55,7 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    if (fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK) {
-        fprintf(stderr, "Failed to attach module.\n");
-        fa_Runtime_free(runtime);
-        wasm_module_free(module);
-        return 1;
-    }
-
+    /* Bind first: a start function runs during attach and may call imports. */
     if (fa_Runtime_bindHostFunctionFromLibrary(runtime,
                                                     "env",
                                                     "host_add",
@@ -73,6 +67,13 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    if (fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK) {
+        fprintf(stderr, "Failed to attach module.\n");
+        fa_Runtime_free(runtime);
+        wasm_module_free(module);
+        return 1;
+    }
+
     fa_Job* job = fa_Runtime_createJob(runtime);
     if (!job) {
         fprintf(stderr, "Failed to create job.\n");
@@ -0,0 +1,298 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "fa_runtime.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Instantiation benchmark: what it costs to go from a loaded module to a
+ * runnable instance, kept apart from execution benchmarks such as
+ * fayasm_bench_bulk.
+ *
+ * The module is generated: one memory sized for `data_kib` KiB of active data
+ * split into 4 KiB segments, a 256-entry funcref table filled by four element
+ * segments, and a start function that stores to memory. Each row times one
+ * way of instantiating it, averaged over enough repetitions to run for about
+ * BENCH_TARGET_SECONDS.
+ */
+
+#define BENCH_SEGMENT_BYTES 4096U
+#define BENCH_TABLE_SIZE 256U
+#define BENCH_ELEMENT_SEGMENTS 4U
+#define BENCH_DEFAULT_KIB 256U
+#define BENCH_MAX_KIB (64U * 1024U)
+#define BENCH_TARGET_SECONDS 0.25
+#define BENCH_MAX_REPS 100000U
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    int failed;
+} Bytes;
+
+static void put_bytes(Bytes* out, const void* data, size_t size) {
+    if (out->failed) {
+        return;
+    }
+    if (out->size + size > out->capacity) {
+        size_t capacity = out->capacity ? out->capacity : 256U;
+        while (capacity < out->size + size) {
+            capacity *= 2U;
+        }
+        uint8_t* grown = (uint8_t*)realloc(out->data, capacity);
+        if (!grown) {
+            out->failed = 1;
+            return;
+        }
+        out->data = grown;
+        out->capacity = capacity;
+    }
+    memcpy(out->data + out->size, data, size);
+    out->size += size;
+}
+
+static void put_u8(Bytes* out, uint8_t value) {
+    put_bytes(out, &value, 1);
+}
+
+static void put_uleb(Bytes* out, uint32_t value) {
+    do {
+        uint8_t byte = (uint8_t)(value & 0x7FU);
+        value >>= 7;
+        put_u8(out, value ? (uint8_t)(byte | 0x80U) : byte);
+    } while (value);
+}
+
+static void put_i32_const(Bytes* out, uint32_t value) {
+    put_u8(out, 0x41);
+    int32_t signed_value = (int32_t)value;
+    for (;;) {
+        uint8_t byte = (uint8_t)(signed_value & 0x7F);
+        signed_value >>= 7;
+        if ((signed_value == 0 && !(byte & 0x40)) || (signed_value == -1 && (byte & 0x40))) {
+            put_u8(out, byte);
+            break;
+        }
+        put_u8(out, (uint8_t)(byte | 0x80U));
+    }
+    put_u8(out, 0x0B);
+}
+
+static void put_section(Bytes* out, uint8_t id, Bytes* payload) {
+    put_u8(out, id);
+    put_uleb(out, (uint32_t)payload->size);
+    put_bytes(out, payload->data, payload->size);
+    out->failed |= payload->failed;
+    payload->size = 0;
+}
+
+static int build_module(Bytes* out, uint32_t data_kib) {
+    static const uint8_t header[] = { 0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00 };
+    /* f0: mem[0] = 1 (the start function); f1: returns nothing */
+    static const uint8_t start_body[] = { 0x00, 0x41, 0x00, 0x41, 0x01, 0x36, 0x02, 0x00, 0x0B };
+    static const uint8_t empty_body[] = { 0x00, 0x0B };
+    const uint32_t segments = data_kib * 1024U / BENCH_SEGMENT_BYTES;
+    const uint32_t pages = (data_kib * 1024U + 65535U) / 65536U + 1U;
+    Bytes payload = {0};
+    put_bytes(out, header, sizeof(header));
+
+    put_uleb(&payload, 1);
+    put_u8(&payload, 0x60);
+    put_uleb(&payload, 0);
+    put_uleb(&payload, 0);
+    put_section(out, 1, &payload);
+
+    put_uleb(&payload, 2);
+    put_uleb(&payload, 0);
+    put_uleb(&payload, 0);
+    put_section(out, 3, &payload);
+
+    put_uleb(&payload, 1);
+    put_u8(&payload, 0x70);
+    put_uleb(&payload, 0);
+    put_uleb(&payload, BENCH_TABLE_SIZE);
+    put_section(out, 4, &payload);
+
+    put_uleb(&payload, 1);
+    put_uleb(&payload, 0);
+    put_uleb(&payload, pages);
+    put_section(out, 5, &payload);
+
+    put_uleb(&payload, 0);
+    put_section(out, 8, &payload);
+
+    const uint32_t per_segment = BENCH_TABLE_SIZE / BENCH_ELEMENT_SEGMENTS;
+    put_uleb(&payload, BENCH_ELEMENT_SEGMENTS);
+    for (uint32_t i = 0; i < BENCH_ELEMENT_SEGMENTS; ++i) {
+        put_uleb(&payload, 0);
+        put_i32_const(&payload, i * per_segment);
+        put_uleb(&payload, per_segment);
+        for (uint32_t j = 0; j < per_segment; ++j) {
+            put_uleb(&payload, j & 1U);
+        }
+    }
+    put_section(out, 9, &payload);
+
+    put_uleb(&payload, 2);
+    put_uleb(&payload, sizeof(start_body));
+    put_bytes(&payload, start_body, sizeof(start_body));
+    put_uleb(&payload, sizeof(empty_body));
+    put_bytes(&payload, empty_body, sizeof(empty_body));
+    put_section(out, 10, &payload);
+
+    uint8_t chunk[BENCH_SEGMENT_BYTES];
+    put_uleb(&payload, segments);
+    for (uint32_t i = 0; i < segments; ++i) {
+        memset(chunk, (int)(i & 0xFFU), sizeof(chunk));
+        put_uleb(&payload, 0);
+        put_i32_const(&payload, 16U + i * BENCH_SEGMENT_BYTES);
+        put_uleb(&payload, BENCH_SEGMENT_BYTES);
+        put_bytes(&payload, chunk, sizeof(chunk));
+    }
+    put_section(out, 11, &payload);
+    free(payload.data);
+    return !out->failed;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static WasmModule* load_module(const Bytes* bytes) {
+    WasmModule* module = wasm_module_init_from_memory(bytes->data, bytes->size);
+    if (!module ||
+        wasm_load_header(module) != 0 ||
+        wasm_scan_sections(module) != 0 ||
+        wasm_load_types(module) != 0 ||
+        wasm_load_functions(module) != 0 ||
+        wasm_load_tables(module) != 0 ||
+        wasm_load_memories(module) != 0 ||
+        wasm_load_globals(module) != 0 ||
+        wasm_load_elements(module) != 0 ||
+        wasm_load_data(module) != 0) {
+        wasm_module_free(module);
+        return NULL;
+    }
+    return module;
+}
+
+typedef enum {
+    BENCH_LOAD = 0,
+    BENCH_ATTACH,
+    BENCH_ATTACH_IMAGE,
+    BENCH_INSTANCE
+} BenchCase;
+
+typedef struct {
+    const Bytes* bytes;
+    WasmModule* module;
+    fa_Runtime* runtime;
+    fa_CompiledModule* compiled;
+} BenchState;
+
+/* One instantiation the way `which` does it; false on failure. */
+static int bench_once(BenchState* state, BenchCase which) {
+    switch (which) {
+        case BENCH_LOAD:
+        {
+            WasmModule* module = load_module(state->bytes);
+            wasm_module_free(module);
+            return module != NULL;
+        }
+        case BENCH_ATTACH:
+        case BENCH_ATTACH_IMAGE:
+            /* attachModule detaches the previous instance first. */
+            return fa_Runtime_attachModule(state->runtime, state->module) == FA_RUNTIME_OK &&
+                   state->runtime->memories[0].data[0] == 1U;
+        case BENCH_INSTANCE:
+        {
+            fa_Instance* instance = fa_Instance_create(state->compiled);
+            const int ok = instance && instance->memories[0].data[0] == 1U;
+            fa_Instance_free(instance);
+            return ok;
+        }
+    }
+    return 0;
+}
+
+/* Returns microseconds per instantiation, or a negative value on failure. */
+static double bench_case(BenchState* state, BenchCase which) {
+    if (!bench_once(state, which)) {
+        return -1.0;
+    }
+    uint32_t reps = 0;
+    const double start = now_seconds();
+    double elapsed = 0.0;
+    while (elapsed < BENCH_TARGET_SECONDS && reps < BENCH_MAX_REPS) {
+        if (!bench_once(state, which)) {
+            return -1.0;
+        }
+        ++reps;
+        elapsed = now_seconds() - start;
+    }
+    return elapsed * 1e6 / (double)reps;
+}
+
+static void print_row(const char* name, double us) {
+    if (us < 0.0) {
+        printf("%-28s %12s\n", name, "failed");
+        return;
+    }
+    printf("%-28s %12.2f\n", name, us);
+}
+
+int main(int argc, char** argv) {
+    uint32_t data_kib = BENCH_DEFAULT_KIB;
+    if (argc > 1) {
+        const unsigned long parsed = strtoul(argv[1], NULL, 0);
+        if (parsed < 4U || parsed > BENCH_MAX_KIB) {
+            fprintf(stderr, "usage: %s [data_kib (4..%u)]\n", argv[0], BENCH_MAX_KIB);
+            return 2;
+        }
+        data_kib = (uint32_t)parsed;
+    }
+
+    Bytes bytes = {0};
+    BenchState state = {0};
+    state.bytes = &bytes;
+    state.module = build_module(&bytes, data_kib) ? load_module(&bytes) : NULL;
+    state.runtime = state.module ? fa_Runtime_init() : NULL;
+    WasmModule* shared = state.runtime ? load_module(&bytes) : NULL;
+    state.compiled = shared ? fa_CompiledModule_create(shared) : NULL;
+    fa_RuntimeMemoryImage* image = state.compiled ? fa_RuntimeMemoryImage_create(state.module) : NULL;
+    if (!image) {
+        fprintf(stderr, "error: failed to build the benchmark module\n");
+        if (!state.compiled) {
+            wasm_module_free(shared);
+        }
+        fa_CompiledModule_release(state.compiled);
+        fa_Runtime_free(state.runtime);
+        wasm_module_free(state.module);
+        free(bytes.data);
+        return 1;
+    }
+
+    printf("module: %zu bytes, %u KiB active data in %u segments, %u table slots\n", bytes.size, data_kib,
+           data_kib * 1024U / BENCH_SEGMENT_BYTES, BENCH_TABLE_SIZE);
+    printf("%-28s %12s\n", "case", "us/instance");
+    print_row("load (parse only)", bench_case(&state, BENCH_LOAD));
+    print_row("attachModule", bench_case(&state, BENCH_ATTACH));
+    fa_Runtime_setMemoryImage(state.runtime, image);
+    print_row("attachModule + memory image", bench_case(&state, BENCH_ATTACH_IMAGE));
+    fa_Runtime_setMemoryImage(state.runtime, NULL);
+    print_row("fa_Instance_create", bench_case(&state, BENCH_INSTANCE));
+
+    fa_Runtime_free(state.runtime);
+    fa_RuntimeMemoryImage_free(image);
+    fa_CompiledModule_release(state.compiled);
+    wasm_module_free(state.module);
+    free(bytes.data);
+    return 0;
+}
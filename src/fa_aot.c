@@ -0,0 +1,399 @@
+#include "fa_aot.h"
+#include "fa_jit_native_ir.h"
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------------------------------------------------------------------- *
+ * AOT emitter.
+ *
+ * Two passes: every function is lowered to slot IR first, so call sites
+ * know whether the callee became a C function (direct call) or must go
+ * through call_slow; then each IR instruction prints as one statement over
+ * the slot array `s`. Labels are printed only when something jumps to them.
+ * ------------------------------------------------------------------------- */
+
+#define AOT_COUNT(table) ((uint8_t)(sizeof(table) / sizeof((table)[0])))
+
+typedef struct {
+    char* text;
+    size_t len;
+    size_t cap;
+    bool failed;
+} fa_AotBuffer;
+
+static void aot_printf(fa_AotBuffer* out, const char* format, ...) {
+    if (out->failed) {
+        return;
+    }
+    for (;;) {
+        va_list args;
+        va_start(args, format);
+        const int needed = vsnprintf(out->text ? out->text + out->len : NULL,
+                                     out->text ? out->cap - out->len : 0, format, args);
+        va_end(args);
+        if (needed < 0) {
+            out->failed = true;
+            return;
+        }
+        if (out->text && out->len + (size_t)needed < out->cap) {
+            out->len += (size_t)needed;
+            return;
+        }
+        size_t cap = out->cap ? out->cap : 4096U;
+        while (cap <= out->len + (size_t)needed) {
+            cap *= 2U;
+        }
+        char* grown = (char*)realloc(out->text, cap);
+        if (!grown) {
+            out->failed = true;
+            return;
+        }
+        out->text = grown;
+        out->cap = cap;
+    }
+}
+
+static const char* const kIntBinary[] = {
+    "add", "sub", "mul", "and", "or", "xor", "shl", "shr_s", "shr_u", "rotl", "rotr",
+    "div_s", "div_u", "rem_s", "rem_u"
+};
+static const char* const kIntCompare[] = {
+    "eq", "ne", "lt_s", "lt_u", "gt_s", "gt_u", "le_s", "le_u", "ge_s", "ge_u"
+};
+static const char* const kIntUnary[] = { "eqz", "clz", "ctz" };
+static const char* const kFloatBinary[] = { "add", "sub", "mul", "div", "copysign" };
+static const char* const kFloatUnary[] = { "abs", "neg", "sqrt" };
+static const char* const kFloatCompare[] = { "eq", "ne", "lt", "gt", "le", "ge" };
+static const char* const kConvert[] = {
+    "i64_extend_i32_s", "i64_extend_i32_u", "i32_extend8_s", "i32_extend16_s",
+    "i64_extend8_s", "i64_extend16_s", "i64_extend32_s", "f32_demote_f64",
+    "f64_promote_f32", "i32_trunc_f32_s", "i32_trunc_f32_u", "i32_trunc_f64_s",
+    "i32_trunc_f64_u", "i64_trunc_f32_s", "i64_trunc_f64_s", "f32_convert_i32_s",
+    "f32_convert_i32_u", "f32_convert_i64_s", "f64_convert_i32_s", "f64_convert_i32_u",
+    "f64_convert_i64_s"
+};
+/* fa_JitNativeIrLoad order. */
+static const char* const kLoad[] = {
+    "u32", "u64", "u32", "u64", "i32_8s", "u8", "i32_16s", "u16",
+    "i64_8s", "u8", "i64_16s", "u16", "i64_32s", "u32"
+};
+
+static const char* aot_pick(const char* const* table, uint8_t count, uint8_t sub) {
+    return sub < count ? table[sub] : NULL;
+}
+
+static bool aot_prefix_ok(const char* prefix) {
+    if (!prefix || !prefix[0] || (prefix[0] >= '0' && prefix[0] <= '9')) {
+        return false;
+    }
+    for (const char* p = prefix; *p; ++p) {
+        const char c = *p;
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+typedef struct {
+    const char* prefix;
+    const bool* compiled; /* by function index */
+    uint32_t function_count;
+    bool* label_used;
+    bool uses_trap;
+} fa_AotFunctionState;
+
+/* Prints one IR instruction. Returns false for anything the tables do not
+   name, which drops the whole function back to interpretation. */
+static bool aot_emit_insn(fa_AotBuffer* out, fa_AotFunctionState* state, const fa_JitNativeIrInsn* insn) {
+    const unsigned bits = insn->wide ? 64U : 32U;
+    const char* name = NULL;
+    switch (insn->op) {
+        case FA_NIR_LABEL:
+            if (state->label_used[insn->label]) {
+                aot_printf(out, "L%" PRIu32 ":;\n", insn->label);
+            }
+            return true;
+        case FA_NIR_JUMP:
+            aot_printf(out, "    goto L%" PRIu32 ";\n", insn->label);
+            return true;
+        case FA_NIR_JUMP_IF_ZERO:
+            aot_printf(out, "    if ((uint32_t)s[%" PRIu32 "] == 0U) goto L%" PRIu32 ";\n", insn->a, insn->label);
+            return true;
+        case FA_NIR_JUMP_IF_NE_IMM:
+            aot_printf(out, "    if ((uint32_t)s[%" PRIu32 "] != %" PRIu32 "U) goto L%" PRIu32 ";\n",
+                       insn->a, (uint32_t)insn->imm, insn->label);
+            return true;
+        case FA_NIR_TRAP:
+            state->uses_trap = true;
+            aot_printf(out, "    goto trap;\n");
+            return true;
+        case FA_NIR_RETURN:
+            aot_printf(out, "    goto out;\n");
+            return true;
+        case FA_NIR_CONST:
+            aot_printf(out, "    s[%" PRIu32 "] = UINT64_C(0x%016" PRIx64 ");\n", insn->dst, insn->imm);
+            return true;
+        case FA_NIR_MOVE:
+            aot_printf(out, "    s[%" PRIu32 "] = s[%" PRIu32 "];\n", insn->dst, insn->a);
+            return true;
+        case FA_NIR_IBIN:
+            name = aot_pick(kIntBinary, AOT_COUNT(kIntBinary), insn->sub);
+            if (name && insn->sub >= FA_NIR_DIV_S) {
+                state->uses_trap = true;
+                aot_printf(out, "    if (!fa_aot_i%u_%s(&s[%" PRIu32 "], s[%" PRIu32 "], s[%" PRIu32 "])) goto trap;\n",
+                           bits, name, insn->dst, insn->a, insn->b);
+                return true;
+            }
+            break;
+        case FA_NIR_ICMP:
+            name = aot_pick(kIntCompare, AOT_COUNT(kIntCompare), insn->sub);
+            break;
+        case FA_NIR_FBIN:
+            name = aot_pick(kFloatBinary, AOT_COUNT(kFloatBinary), insn->sub);
+            break;
+        case FA_NIR_FCMP:
+            name = aot_pick(kFloatCompare, AOT_COUNT(kFloatCompare), insn->sub);
+            break;
+        case FA_NIR_IUNARY:
+            name = aot_pick(kIntUnary, AOT_COUNT(kIntUnary), insn->sub);
+            if (name) {
+                aot_printf(out, "    s[%" PRIu32 "] = fa_aot_i%u_%s(s[%" PRIu32 "]);\n", insn->dst, bits, name, insn->a);
+            }
+            return name != NULL;
+        case FA_NIR_FUNARY:
+            name = aot_pick(kFloatUnary, AOT_COUNT(kFloatUnary), insn->sub);
+            if (name) {
+                aot_printf(out, "    s[%" PRIu32 "] = fa_aot_f%u_%s(s[%" PRIu32 "]);\n", insn->dst, bits, name, insn->a);
+            }
+            return name != NULL;
+        case FA_NIR_CONVERT:
+            name = aot_pick(kConvert, AOT_COUNT(kConvert), insn->sub);
+            if (!name) {
+                return false;
+            }
+            if (insn->sub >= FA_NIR_I32_TRUNC_F32_S && insn->sub <= FA_NIR_I64_TRUNC_F64_S) {
+                state->uses_trap = true;
+                aot_printf(out, "    if (!fa_aot_%s(&s[%" PRIu32 "], s[%" PRIu32 "])) goto trap;\n",
+                           name, insn->dst, insn->a);
+            } else {
+                aot_printf(out, "    s[%" PRIu32 "] = fa_aot_%s(s[%" PRIu32 "]);\n", insn->dst, name, insn->a);
+            }
+            return true;
+        case FA_NIR_LOAD:
+            name = aot_pick(kLoad, AOT_COUNT(kLoad), insn->sub);
+            if (!name) {
+                return false;
+            }
+            state->uses_trap = true;
+            aot_printf(out, "    if (!fa_aot_load_%s(ctx, &s[%" PRIu32 "], s[%" PRIu32 "], %" PRIu32 "U)) goto trap;\n",
+                       name, insn->dst, insn->a, (uint32_t)insn->imm);
+            return true;
+        case FA_NIR_STORE:
+            if (insn->sub != 1U && insn->sub != 2U && insn->sub != 4U && insn->sub != 8U) {
+                return false;
+            }
+            state->uses_trap = true;
+            aot_printf(out, "    if (!fa_aot_store_%u(ctx, s[%" PRIu32 "], %" PRIu32 "U, s[%" PRIu32 "])) goto trap;\n",
+                       (unsigned)insn->sub * 8U, insn->a, (uint32_t)insn->imm, insn->b);
+            return true;
+        case FA_NIR_MEMORY_SIZE:
+            aot_printf(out, "    s[%" PRIu32 "] = fa_aot_memory_size(ctx);\n", insn->dst);
+            return true;
+        case FA_NIR_MEMORY_GROW:
+            aot_printf(out, "    s[%" PRIu32 "] = fa_aot_memory_grow(ctx, s[%" PRIu32 "]);\n", insn->dst, insn->a);
+            return true;
+        case FA_NIR_GLOBAL_GET:
+            aot_printf(out, "    s[%" PRIu32 "] = ctx->globals[%" PRIu64 "].payload.%s;\n",
+                       insn->dst, insn->imm, insn->wide ? "u64_value" : "u32_value");
+            return true;
+        case FA_NIR_GLOBAL_SET:
+            if (insn->wide) {
+                aot_printf(out, "    ctx->globals[%" PRIu64 "].payload.u64_value = s[%" PRIu32 "];\n",
+                           insn->imm, insn->a);
+            } else {
+                aot_printf(out, "    ctx->globals[%" PRIu64 "].payload.u32_value = (uint32_t)s[%" PRIu32 "];\n",
+                           insn->imm, insn->a);
+            }
+            return true;
+        case FA_NIR_SELECT:
+            aot_printf(out, "    s[%" PRIu32 "] = (uint32_t)s[%" PRIu32 "] != 0U ? s[%" PRIu32 "] : s[%" PRIu32 "];\n",
+                       insn->dst, insn->c, insn->a, insn->b);
+            return true;
+        case FA_NIR_CALL:
+            if (insn->imm < state->function_count && state->compiled[insn->imm]) {
+                aot_printf(out, "    status = %s_f%" PRIu64 "(ctx, s + %" PRIu32 ");\n", state->prefix, insn->imm, insn->a);
+            } else {
+                aot_printf(out, "    status = ctx->call_slow(ctx, s + %" PRIu32 ", %" PRIu64 "U);\n", insn->a, insn->imm);
+            }
+            aot_printf(out, "    if (status != FA_RUNTIME_OK) goto out;\n");
+            return true;
+        default:
+            return false;
+    }
+    /* Non-trapping binary operators and compares. */
+    if (!name) {
+        return false;
+    }
+    aot_printf(out, "    s[%" PRIu32 "] = fa_aot_%c%u_%s(s[%" PRIu32 "], s[%" PRIu32 "]);\n",
+               insn->dst, (insn->op == FA_NIR_FBIN || insn->op == FA_NIR_FCMP) ? 'f' : 'i',
+               bits, name, insn->a, insn->b);
+    return true;
+}
+
+static bool aot_emit_function(fa_AotBuffer* out, fa_AotFunctionState* state, uint32_t index, const fa_JitNativeIr* ir) {
+    state->label_used = (bool*)calloc(ir->label_count + 1U, sizeof(bool));
+    if (!state->label_used) {
+        out->failed = true;
+        return false;
+    }
+    state->uses_trap = false;
+    for (uint32_t i = 0; i < ir->count; ++i) {
+        const fa_JitNativeIrInsn* insn = &ir->insns[i];
+        if ((insn->op == FA_NIR_JUMP || insn->op == FA_NIR_JUMP_IF_ZERO || insn->op == FA_NIR_JUMP_IF_NE_IMM) &&
+            insn->label < ir->label_count) {
+            state->label_used[insn->label] = true;
+        }
+    }
+    aot_printf(out, "\nstatic int %s_f%" PRIu32 "(fa_JitNativeContext* ctx, uint64_t* s) {\n", state->prefix, index);
+    aot_printf(out, "    int status = fa_aot_enter(ctx, s, %" PRIu32 "U);\n", ir->frame_slots);
+    aot_printf(out, "    if (status != FA_RUNTIME_OK) {\n        return status;\n    }\n");
+    if (ir->local_count > ir->param_count) {
+        aot_printf(out, "    memset(s + %" PRIu32 ", 0, %" PRIu32 "U * sizeof(uint64_t));\n",
+                   ir->param_count, ir->local_count - ir->param_count);
+    }
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < ir->count; ++i) {
+        ok = aot_emit_insn(out, state, &ir->insns[i]);
+    }
+    if (state->uses_trap) {
+        if (ir->count == 0 || ir->insns[ir->count - 1U].op != FA_NIR_RETURN) {
+            aot_printf(out, "    goto out;\n");
+        }
+        aot_printf(out, "trap:\n    status = FA_RUNTIME_ERR_TRAP;\n");
+    }
+    aot_printf(out, "out:\n    ctx->depth--;\n    return status;\n}\n");
+    free(state->label_used);
+    state->label_used = NULL;
+    return ok;
+}
+
+static bool aot_build_ir(WasmModule* module, uint32_t index, fa_JitNativeIr* ir) {
+    const WasmFunction* function = &module->functions[index];
+    if (function->is_imported || function->body_size == 0) {
+        return false;
+    }
+    uint8_t* body = wasm_load_function_body(module, index);
+    if (!body) {
+        return false;
+    }
+    fa_JitNativeRequest request;
+    memset(&request, 0, sizeof(request));
+    request.module = module;
+    request.func_index = index;
+    request.body = body;
+    request.body_size = function->body_size;
+    request.memory_flat = module->num_memories > 0 && module->memories && !module->memories[0].is_memory64;
+    const bool ok = fa_jit_native_build_ir(&request, ir);
+    free(body);
+    return ok;
+}
+
+bool fa_aot_emit_c(WasmModule* module,
+                   const fa_AotOptions* options,
+                   char** text_out,
+                   size_t* size_out,
+                   fa_AotStats* stats_out) {
+    if (text_out) {
+        *text_out = NULL;
+    }
+    if (size_out) {
+        *size_out = 0;
+    }
+    const char* prefix = options && options->prefix ? options->prefix : "fa_aot";
+    if (!module || !text_out || !aot_prefix_ok(prefix) || (module->num_functions > 0 && !module->functions)) {
+        return false;
+    }
+    const uint32_t count = module->num_functions;
+    fa_JitNativeIr* irs = (fa_JitNativeIr*)calloc(count + 1U, sizeof(fa_JitNativeIr));
+    bool* compiled = (bool*)calloc(count + 1U, sizeof(bool));
+    fa_AotBuffer out;
+    memset(&out, 0, sizeof(out));
+    out.failed = !irs || !compiled;
+    fa_AotStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.function_count = count;
+    for (uint32_t i = 0; !out.failed && i < count; ++i) {
+        stats.imported_count += module->functions[i].is_imported ? 1U : 0U;
+        compiled[i] = aot_build_ir(module, i, &irs[i]);
+    }
+
+    /* Dry run: a function whose IR uses something the tables cannot print
+       must not be called directly, so settle `compiled` before printing. */
+    fa_AotFunctionState state;
+    memset(&state, 0, sizeof(state));
+    state.prefix = prefix;
+    state.compiled = compiled;
+    state.function_count = count;
+    for (uint32_t i = 0; !out.failed && i < count; ++i) {
+        if (!compiled[i]) {
+            continue;
+        }
+        fa_AotBuffer scratch;
+        memset(&scratch, 0, sizeof(scratch));
+        compiled[i] = aot_emit_function(&scratch, &state, i, &irs[i]) && !scratch.failed;
+        free(scratch.text);
+    }
+
+    aot_printf(&out, "/* Generated by fayasm_aot%s%s%s: %" PRIu32 " functions, do not edit. */\n",
+               options && options->source_name ? " from \"" : "",
+               options && options->source_name ? options->source_name : "",
+               options && options->source_name ? "\"" : "", count);
+    aot_printf(&out, "#include \"fa_aot_runtime.h\"\n\n");
+    for (uint32_t i = 0; i < count; ++i) {
+        if (compiled[i]) {
+            aot_printf(&out, "static int %s_f%" PRIu32 "(fa_JitNativeContext* ctx, uint64_t* s);\n", prefix, i);
+        }
+    }
+    for (uint32_t i = 0; !out.failed && i < count; ++i) {
+        if (compiled[i]) {
+            stats.compiled_count++;
+            (void)aot_emit_function(&out, &state, i, &irs[i]);
+        }
+    }
+    aot_printf(&out, "\nconst fa_JitNativeEntry %s_functions[%" PRIu32 "] = {\n", prefix, count > 0 ? count : 1U);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (compiled[i]) {
+            aot_printf(&out, "    %s_f%" PRIu32 ",\n", prefix, i);
+        } else {
+            aot_printf(&out, "    NULL, /* f%" PRIu32 ": %s */\n", i,
+                       module->functions[i].is_imported ? "imported" : "interpreted");
+        }
+    }
+    if (count == 0) {
+        aot_printf(&out, "    NULL\n");
+    }
+    aot_printf(&out, "};\nconst uint32_t %s_function_count = %" PRIu32 "U;\n", prefix, count);
+
+    for (uint32_t i = 0; irs && i < count; ++i) {
+        fa_jit_native_ir_free(&irs[i]);
+    }
+    free(irs);
+    free(compiled);
+    if (out.failed) {
+        free(out.text);
+        return false;
+    }
+    *text_out = out.text;
+    if (size_out) {
+        *size_out = out.len;
+    }
+    if (stats_out) {
+        *stats_out = stats;
+    }
+    return true;
+}
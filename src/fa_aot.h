@@ -0,0 +1,47 @@
+#pragma once
+
+#include "fa_wasm.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------- *
+ * Ahead-of-time compilation to C (fayasm_aot).
+ *
+ * Lowers every function of a parsed module through the native tier's slot IR
+ * (fa_jit_native_ir.h) and prints it as a portable C99 translation unit, so
+ * firmware can build its wasm code with its own toolchain and run it without
+ * any runtime code generation. The output includes fa_aot_runtime.h and
+ * defines, for a symbol prefix P:
+ *
+ *   const fa_JitNativeEntry P_functions[];  // by function index
+ *   const uint32_t P_function_count;        // == module->num_functions
+ *
+ * Register the table with fa_Runtime_setAotFunctions after attaching the same
+ * module. Entries use the native calling convention; memory, globals,
+ * memory.grow, imports and functions outside the subset go through the
+ * runtime's context (call_slow), and NULL entries stay interpreted. Calls
+ * between compiled functions are direct C calls.
+ * ------------------------------------------------------------------------- */
+
+typedef struct {
+    const char* prefix;      /* C identifier prefix; NULL means "fa_aot" */
+    const char* source_name; /* shown in the banner comment, may be NULL */
+} fa_AotOptions;
+
+typedef struct {
+    uint32_t function_count;
+    uint32_t compiled_count;
+    uint32_t imported_count;
+} fa_AotStats;
+
+/* Emits the translation unit for `module` (types, functions and memories
+   loaded) into a malloc'd NUL-terminated buffer. Returns false on allocation
+   failure or an invalid prefix; functions the frontend rejects are not an
+   error, they get a NULL entry. */
+bool fa_aot_emit_c(WasmModule* module,
+                   const fa_AotOptions* options,
+                   char** text_out,
+                   size_t* size_out,
+                   fa_AotStats* stats_out);
@@ -0,0 +1,300 @@
+#pragma once
+
+#include "fa_runtime.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* ------------------------------------------------------------------------- *
+ * Support code for translation units emitted by fayasm_aot (fa_aot.h).
+ *
+ * Generated functions use the native-tier calling convention
+ * (fa_JitNativeEntry): arguments and results in 64-bit slots, i32/f32 in the
+ * low half, an FA_RUNTIME_* status as the return value. Each IR operation
+ * maps to one of the small inline helpers below, so the emitted code stays
+ * readable and the firmware toolchain folds it back into straight-line
+ * arithmetic. Operations that can trap return false and leave the result
+ * untouched. Semantics match the native backends and the closure tier.
+ * ------------------------------------------------------------------------- */
+
+static inline float fa_aot_f32(uint64_t slot) {
+    const uint32_t bits = (uint32_t)slot;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline uint64_t fa_aot_from_f32(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline double fa_aot_f64(uint64_t slot) {
+    double value;
+    memcpy(&value, &slot, sizeof(value));
+    return value;
+}
+
+static inline uint64_t fa_aot_from_f64(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/* ----- integer operators ----- */
+
+#define FA_AOT_BINARY(name, type, expr)                                \
+    static inline uint64_t name(uint64_t a_slot, uint64_t b_slot) {    \
+        const type a = (type)a_slot;                                   \
+        const type b = (type)b_slot;                                   \
+        return (uint64_t)(type)(expr);                                 \
+    }
+
+#define FA_AOT_INT_FAMILY(bits, utype, stype)                                                          \
+    FA_AOT_BINARY(fa_aot_i##bits##_add, utype, a + b)                                                  \
+    FA_AOT_BINARY(fa_aot_i##bits##_sub, utype, a - b)                                                  \
+    FA_AOT_BINARY(fa_aot_i##bits##_mul, utype, a * b)                                                  \
+    FA_AOT_BINARY(fa_aot_i##bits##_and, utype, a & b)                                                  \
+    FA_AOT_BINARY(fa_aot_i##bits##_or, utype, a | b)                                                   \
+    FA_AOT_BINARY(fa_aot_i##bits##_xor, utype, a ^ b)                                                  \
+    FA_AOT_BINARY(fa_aot_i##bits##_shl, utype, a << (b & (bits - 1U)))                                 \
+    FA_AOT_BINARY(fa_aot_i##bits##_shr_s, utype, (utype)((stype)a >> (b & (bits - 1U))))               \
+    FA_AOT_BINARY(fa_aot_i##bits##_shr_u, utype, a >> (b & (bits - 1U)))                               \
+    FA_AOT_BINARY(fa_aot_i##bits##_rotl, utype,                                                        \
+                  (a << (b & (bits - 1U))) | (a >> ((bits - (b & (bits - 1U))) & (bits - 1U))))        \
+    FA_AOT_BINARY(fa_aot_i##bits##_rotr, utype,                                                        \
+                  (a >> (b & (bits - 1U))) | (a << ((bits - (b & (bits - 1U))) & (bits - 1U))))        \
+    static inline bool fa_aot_i##bits##_div_s(uint64_t* dst, uint64_t a_slot, uint64_t b_slot) {       \
+        const stype a = (stype)(utype)a_slot;                                                          \
+        const stype b = (stype)(utype)b_slot;                                                          \
+        if (b == 0 || (b == -1 && a == (stype)((utype)1 << (bits - 1U)))) {                            \
+            return false;                                                                              \
+        }                                                                                              \
+        *dst = (uint64_t)(utype)(a / b);                                                               \
+        return true;                                                                                   \
+    }                                                                                                  \
+    static inline bool fa_aot_i##bits##_div_u(uint64_t* dst, uint64_t a_slot, uint64_t b_slot) {       \
+        if ((utype)b_slot == 0U) {                                                                     \
+            return false;                                                                              \
+        }                                                                                              \
+        *dst = (uint64_t)((utype)a_slot / (utype)b_slot);                                              \
+        return true;                                                                                   \
+    }                                                                                                  \
+    static inline bool fa_aot_i##bits##_rem_s(uint64_t* dst, uint64_t a_slot, uint64_t b_slot) {       \
+        const stype a = (stype)(utype)a_slot;                                                          \
+        const stype b = (stype)(utype)b_slot;                                                          \
+        if (b == 0) {                                                                                  \
+            return false;                                                                              \
+        }                                                                                              \
+        *dst = b == -1 ? 0U : (uint64_t)(utype)(a % b);                                                \
+        return true;                                                                                   \
+    }                                                                                                  \
+    static inline bool fa_aot_i##bits##_rem_u(uint64_t* dst, uint64_t a_slot, uint64_t b_slot) {       \
+        if ((utype)b_slot == 0U) {                                                                     \
+            return false;                                                                              \
+        }                                                                                              \
+        *dst = (uint64_t)((utype)a_slot % (utype)b_slot);                                              \
+        return true;                                                                                   \
+    }                                                                                                  \
+    FA_AOT_BINARY(fa_aot_i##bits##_eq, utype, a == b)                                                  \
+    FA_AOT_BINARY(fa_aot_i##bits##_ne, utype, a != b)                                                  \
+    FA_AOT_BINARY(fa_aot_i##bits##_lt_s, utype, (stype)a < (stype)b)                                   \
+    FA_AOT_BINARY(fa_aot_i##bits##_lt_u, utype, a < b)                                                 \
+    FA_AOT_BINARY(fa_aot_i##bits##_gt_s, utype, (stype)a > (stype)b)                                   \
+    FA_AOT_BINARY(fa_aot_i##bits##_gt_u, utype, a > b)                                                 \
+    FA_AOT_BINARY(fa_aot_i##bits##_le_s, utype, (stype)a <= (stype)b)                                  \
+    FA_AOT_BINARY(fa_aot_i##bits##_le_u, utype, a <= b)                                                \
+    FA_AOT_BINARY(fa_aot_i##bits##_ge_s, utype, (stype)a >= (stype)b)                                  \
+    FA_AOT_BINARY(fa_aot_i##bits##_ge_u, utype, a >= b)                                                \
+    static inline uint64_t fa_aot_i##bits##_eqz(uint64_t a) {                                          \
+        return (utype)a == 0U ? 1U : 0U;                                                               \
+    }                                                                                                  \
+    static inline uint64_t fa_aot_i##bits##_clz(uint64_t a) {                                          \
+        utype value = (utype)a;                                                                        \
+        uint64_t count = bits;                                                                         \
+        while (value != 0U) {                                                                          \
+            value >>= 1U;                                                                              \
+            --count;                                                                                   \
+        }                                                                                              \
+        return count;                                                                                  \
+    }                                                                                                  \
+    static inline uint64_t fa_aot_i##bits##_ctz(uint64_t a) {                                          \
+        utype value = (utype)a;                                                                        \
+        uint64_t count = 0;                                                                            \
+        if (value == 0U) {                                                                             \
+            return bits;                                                                               \
+        }                                                                                              \
+        while ((value & 1U) == 0U) {                                                                   \
+            value >>= 1U;                                                                              \
+            ++count;                                                                                   \
+        }                                                                                              \
+        return count;                                                                                  \
+    }
+
+FA_AOT_INT_FAMILY(32, uint32_t, int32_t)
+FA_AOT_INT_FAMILY(64, uint64_t, int64_t)
+
+/* ----- float operators ----- */
+
+#define FA_AOT_FLOAT_BINARY(name, type, read, write, expr)             \
+    static inline uint64_t name(uint64_t a_slot, uint64_t b_slot) {    \
+        const type a = read(a_slot);                                   \
+        const type b = read(b_slot);                                   \
+        return write(expr);                                            \
+    }
+
+#define FA_AOT_FLOAT_COMPARE(name, type, read, expr)                   \
+    static inline uint64_t name(uint64_t a_slot, uint64_t b_slot) {    \
+        const type a = read(a_slot);                                   \
+        const type b = read(b_slot);                                   \
+        return (expr) ? 1U : 0U;                                       \
+    }
+
+#define FA_AOT_FLOAT_FAMILY(bits, type, read, write, root, sign)                                       \
+    FA_AOT_FLOAT_BINARY(fa_aot_f##bits##_add, type, read, write, a + b)                                \
+    FA_AOT_FLOAT_BINARY(fa_aot_f##bits##_sub, type, read, write, a - b)                                \
+    FA_AOT_FLOAT_BINARY(fa_aot_f##bits##_mul, type, read, write, a * b)                                \
+    FA_AOT_FLOAT_BINARY(fa_aot_f##bits##_div, type, read, write, a / b)                                \
+    static inline uint64_t fa_aot_f##bits##_copysign(uint64_t a, uint64_t b) {                         \
+        return (a & (sign - 1U)) | (b & sign);                                                         \
+    }                                                                                                  \
+    static inline uint64_t fa_aot_f##bits##_abs(uint64_t a) {                                          \
+        return a & (sign - 1U);                                                                        \
+    }                                                                                                  \
+    static inline uint64_t fa_aot_f##bits##_neg(uint64_t a) {                                          \
+        return (a ^ sign) & (sign | (sign - 1U));                                                      \
+    }                                                                                                  \
+    static inline uint64_t fa_aot_f##bits##_sqrt(uint64_t a) {                                         \
+        return write(root(read(a)));                                                                   \
+    }                                                                                                  \
+    FA_AOT_FLOAT_COMPARE(fa_aot_f##bits##_eq, type, read, a == b)                                      \
+    FA_AOT_FLOAT_COMPARE(fa_aot_f##bits##_ne, type, read, a != b)                                      \
+    FA_AOT_FLOAT_COMPARE(fa_aot_f##bits##_lt, type, read, a < b)                                       \
+    FA_AOT_FLOAT_COMPARE(fa_aot_f##bits##_gt, type, read, a > b)                                       \
+    FA_AOT_FLOAT_COMPARE(fa_aot_f##bits##_le, type, read, a <= b)                                      \
+    FA_AOT_FLOAT_COMPARE(fa_aot_f##bits##_ge, type, read, a >= b)
+
+FA_AOT_FLOAT_FAMILY(32, float, fa_aot_f32, fa_aot_from_f32, sqrtf, 0x80000000ULL)
+FA_AOT_FLOAT_FAMILY(64, double, fa_aot_f64, fa_aot_from_f64, sqrt, 0x8000000000000000ULL)
+
+/* ----- conversions ----- */
+
+#define FA_AOT_CONVERT(name, expr)               \
+    static inline uint64_t name(uint64_t a) {    \
+        return (expr);                           \
+    }
+
+/* Truncations trap on NaN (every comparison fails) and out-of-range input. */
+#define FA_AOT_TRUNCATE(name, read, low, high, type)                   \
+    static inline bool name(uint64_t* dst, uint64_t a) {               \
+        const double value = (double)read(a);                          \
+        if (!(value > (low) && value < (high))) {                      \
+            return false;                                              \
+        }                                                              \
+        *dst = (uint64_t)(uint32_t)(type)value;                        \
+        return true;                                                   \
+    }
+
+#define FA_AOT_TRUNCATE_I64(name, read)                                                \
+    static inline bool name(uint64_t* dst, uint64_t a) {                               \
+        const double value = (double)read(a);                                          \
+        if (!(value >= -9223372036854775808.0 && value < 9223372036854775808.0)) {     \
+            return false;                                                              \
+        }                                                                              \
+        *dst = (uint64_t)(int64_t)value;                                               \
+        return true;                                                                   \
+    }
+
+FA_AOT_CONVERT(fa_aot_i64_extend_i32_s, (uint64_t)(int64_t)(int32_t)(uint32_t)a)
+FA_AOT_CONVERT(fa_aot_i64_extend_i32_u, (uint64_t)(uint32_t)a)
+FA_AOT_CONVERT(fa_aot_i32_extend8_s, (uint64_t)(uint32_t)(int32_t)(int8_t)(uint8_t)a)
+FA_AOT_CONVERT(fa_aot_i32_extend16_s, (uint64_t)(uint32_t)(int32_t)(int16_t)(uint16_t)a)
+FA_AOT_CONVERT(fa_aot_i64_extend8_s, (uint64_t)(int64_t)(int8_t)(uint8_t)a)
+FA_AOT_CONVERT(fa_aot_i64_extend16_s, (uint64_t)(int64_t)(int16_t)(uint16_t)a)
+FA_AOT_CONVERT(fa_aot_i64_extend32_s, (uint64_t)(int64_t)(int32_t)(uint32_t)a)
+FA_AOT_CONVERT(fa_aot_f32_demote_f64, fa_aot_from_f32((float)fa_aot_f64(a)))
+FA_AOT_CONVERT(fa_aot_f64_promote_f32, fa_aot_from_f64((double)fa_aot_f32(a)))
+FA_AOT_TRUNCATE(fa_aot_i32_trunc_f32_s, fa_aot_f32, -2147483649.0, 2147483648.0, int32_t)
+FA_AOT_TRUNCATE(fa_aot_i32_trunc_f32_u, fa_aot_f32, -1.0, 4294967296.0, uint32_t)
+FA_AOT_TRUNCATE(fa_aot_i32_trunc_f64_s, fa_aot_f64, -2147483649.0, 2147483648.0, int32_t)
+FA_AOT_TRUNCATE(fa_aot_i32_trunc_f64_u, fa_aot_f64, -1.0, 4294967296.0, uint32_t)
+FA_AOT_TRUNCATE_I64(fa_aot_i64_trunc_f32_s, fa_aot_f32)
+FA_AOT_TRUNCATE_I64(fa_aot_i64_trunc_f64_s, fa_aot_f64)
+FA_AOT_CONVERT(fa_aot_f32_convert_i32_s, fa_aot_from_f32((float)(int32_t)(uint32_t)a))
+FA_AOT_CONVERT(fa_aot_f32_convert_i32_u, fa_aot_from_f32((float)(uint32_t)a))
+FA_AOT_CONVERT(fa_aot_f32_convert_i64_s, fa_aot_from_f32((float)(int64_t)a))
+FA_AOT_CONVERT(fa_aot_f64_convert_i32_s, fa_aot_from_f64((double)(int32_t)(uint32_t)a))
+FA_AOT_CONVERT(fa_aot_f64_convert_i32_u, fa_aot_from_f64((double)(uint32_t)a))
+FA_AOT_CONVERT(fa_aot_f64_convert_i64_s, fa_aot_from_f64((double)(int64_t)a))
+
+/* ----- linear memory (memory 0 through the context) ----- */
+
+/* Host address of [base + offset, base + offset + bytes), NULL when out of
+   bounds. Re-read on every access: memory.grow may move the data. */
+static inline uint8_t* fa_aot_address(fa_JitNativeContext* ctx, uint64_t base, uint32_t offset, uint32_t bytes) {
+    const fa_RuntimeMemory* memory = (const fa_RuntimeMemory*)ctx->memory;
+    const uint64_t addr = (uint64_t)(uint32_t)base + (uint64_t)offset;
+    if (!memory || !memory->data || addr + bytes > memory->size_bytes) {
+        return NULL;
+    }
+    return memory->data + (size_t)addr;
+}
+
+#define FA_AOT_LOAD(name, type, expr)                                                              \
+    static inline bool name(fa_JitNativeContext* ctx, uint64_t* dst, uint64_t base, uint32_t offset) { \
+        const uint8_t* at = fa_aot_address(ctx, base, offset, (uint32_t)sizeof(type));             \
+        type v;                                                                                    \
+        if (!at) {                                                                                 \
+            return false;                                                                          \
+        }                                                                                          \
+        memcpy(&v, at, sizeof(v));                                                                 \
+        *dst = (expr);                                                                             \
+        return true;                                                                               \
+    }
+
+#define FA_AOT_STORE(name, type)                                                                   \
+    static inline bool name(fa_JitNativeContext* ctx, uint64_t base, uint32_t offset, uint64_t value) { \
+        uint8_t* at = fa_aot_address(ctx, base, offset, (uint32_t)sizeof(type));                   \
+        const type v = (type)value;                                                                \
+        if (!at) {                                                                                 \
+            return false;                                                                          \
+        }                                                                                          \
+        memcpy(at, &v, sizeof(v));                                                                 \
+        return true;                                                                               \
+    }
+
+FA_AOT_LOAD(fa_aot_load_u32, uint32_t, (uint64_t)v)
+FA_AOT_LOAD(fa_aot_load_u64, uint64_t, v)
+FA_AOT_LOAD(fa_aot_load_i32_8s, int8_t, (uint64_t)(uint32_t)(int32_t)v)
+FA_AOT_LOAD(fa_aot_load_u8, uint8_t, (uint64_t)v)
+FA_AOT_LOAD(fa_aot_load_i32_16s, int16_t, (uint64_t)(uint32_t)(int32_t)v)
+FA_AOT_LOAD(fa_aot_load_u16, uint16_t, (uint64_t)v)
+FA_AOT_LOAD(fa_aot_load_i64_8s, int8_t, (uint64_t)(int64_t)v)
+FA_AOT_LOAD(fa_aot_load_i64_16s, int16_t, (uint64_t)(int64_t)v)
+FA_AOT_LOAD(fa_aot_load_i64_32s, int32_t, (uint64_t)(int64_t)v)
+FA_AOT_STORE(fa_aot_store_8, uint8_t)
+FA_AOT_STORE(fa_aot_store_16, uint16_t)
+FA_AOT_STORE(fa_aot_store_32, uint32_t)
+FA_AOT_STORE(fa_aot_store_64, uint64_t)
+
+static inline uint64_t fa_aot_memory_size(fa_JitNativeContext* ctx) {
+    const fa_RuntimeMemory* memory = (const fa_RuntimeMemory*)ctx->memory;
+    return memory ? (uint32_t)(memory->size_bytes >> 16) : 0U;
+}
+
+static inline uint64_t fa_aot_memory_grow(fa_JitNativeContext* ctx, uint64_t delta_pages) {
+    return (uint32_t)(int32_t)ctx->memory_grow(ctx, (uint32_t)delta_pages);
+}
+
+/* Prologue shared by every generated function: the same frame and depth
+   limits the native backends enforce. */
+static inline int fa_aot_enter(fa_JitNativeContext* ctx, uint64_t* slots, uint32_t frame_slots) {
+    if (slots + frame_slots > ctx->slot_limit || ctx->depth >= ctx->max_depth) {
+        return FA_RUNTIME_ERR_CALL_DEPTH_EXCEEDED;
+    }
+    ctx->depth++;
+    return FA_RUNTIME_OK;
+}
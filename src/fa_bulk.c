@@ -0,0 +1,120 @@
+#include "fa_bulk.h"
+#include "fa_arch.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(FA_ARCH_CPU_X86_64) && defined(__SSE2__) && FA_BULK_NONTEMPORAL_BYTES > 0
+#include <emmintrin.h>
+#define FA_BULK_HAS_STREAM 1
+#endif
+
+#define FA_BULK_STREAM_BLOCK 64U
+
+#if defined(FA_BULK_HAS_STREAM)
+/* Leading bytes go through memcpy/memset until `dst` is 16-byte aligned, the
+   body is written in 64-byte blocks with movntdq, and the tail falls back to
+   the cached path. The sfence orders the streamed stores before any later
+   load of the same bytes. */
+static size_t bulk_stream_head(const uint8_t* dst, size_t size) {
+    const size_t misalign = (size_t)((uintptr_t)dst & 15U);
+    const size_t head = misalign ? 16U - misalign : 0U;
+    return head < size ? head : size;
+}
+
+static void bulk_stream_copy(uint8_t* dst, const uint8_t* src, size_t size) {
+    const size_t head = bulk_stream_head(dst, size);
+    memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    size -= head;
+    while (size >= FA_BULK_STREAM_BLOCK) {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(const void*)(src + 0));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(const void*)(src + 16));
+        const __m128i c = _mm_loadu_si128((const __m128i*)(const void*)(src + 32));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(const void*)(src + 48));
+        _mm_stream_si128((__m128i*)(void*)(dst + 0), a);
+        _mm_stream_si128((__m128i*)(void*)(dst + 16), b);
+        _mm_stream_si128((__m128i*)(void*)(dst + 32), c);
+        _mm_stream_si128((__m128i*)(void*)(dst + 48), d);
+        dst += FA_BULK_STREAM_BLOCK;
+        src += FA_BULK_STREAM_BLOCK;
+        size -= FA_BULK_STREAM_BLOCK;
+    }
+    _mm_sfence();
+    memcpy(dst, src, size);
+}
+
+static void bulk_stream_fill(uint8_t* dst, uint8_t value, size_t size) {
+    const size_t head = bulk_stream_head(dst, size);
+    memset(dst, value, head);
+    dst += head;
+    size -= head;
+    const __m128i pattern = _mm_set1_epi8((char)value);
+    while (size >= FA_BULK_STREAM_BLOCK) {
+        _mm_stream_si128((__m128i*)(void*)(dst + 0), pattern);
+        _mm_stream_si128((__m128i*)(void*)(dst + 16), pattern);
+        _mm_stream_si128((__m128i*)(void*)(dst + 32), pattern);
+        _mm_stream_si128((__m128i*)(void*)(dst + 48), pattern);
+        dst += FA_BULK_STREAM_BLOCK;
+        size -= FA_BULK_STREAM_BLOCK;
+    }
+    _mm_sfence();
+    memset(dst, value, size);
+}
+#endif
+
+void fa_bulk_copy(void* dst, const void* src, size_t size) {
+    uint8_t* out = (uint8_t*)dst;
+    const uint8_t* in = (const uint8_t*)src;
+    if (size == 0 || out == in) {
+        return;
+    }
+    const uintptr_t out_addr = (uintptr_t)out;
+    const uintptr_t in_addr = (uintptr_t)in;
+    const bool disjoint = out_addr >= in_addr ? out_addr - in_addr >= size : in_addr - out_addr >= size;
+    if (!disjoint) {
+        /* memmove already walks forward or backward by overlap direction. */
+        memmove(out, in, size);
+        return;
+    }
+#if defined(FA_BULK_HAS_STREAM)
+    if (size >= FA_BULK_NONTEMPORAL_BYTES) {
+        bulk_stream_copy(out, in, size);
+        return;
+    }
+#endif
+    memcpy(out, in, size);
+}
+
+void fa_bulk_fill(void* dst, uint8_t value, size_t size) {
+    if (size == 0) {
+        return;
+    }
+#if defined(FA_BULK_HAS_STREAM)
+    if (size >= FA_BULK_NONTEMPORAL_BYTES) {
+        bulk_stream_fill((uint8_t*)dst, value, size);
+        return;
+    }
+#endif
+    memset(dst, value, size);
+}
+
+void fa_bulk_copy_refs(fa_ptr* dst, const fa_ptr* src, size_t count) {
+    fa_bulk_copy(dst, src, count * sizeof(fa_ptr));
+}
+
+/* Seeds one slot, then doubles the filled prefix with memcpy so long fills
+   run at copy bandwidth instead of one store per slot. */
+void fa_bulk_fill_refs(fa_ptr* dst, fa_ptr value, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    dst[0] = value;
+    size_t filled = 1;
+    while (filled < count) {
+        const size_t chunk = filled < count - filled ? filled : count - filled;
+        memcpy(dst + filled, dst, chunk * sizeof(fa_ptr));
+        filled += chunk;
+    }
+}
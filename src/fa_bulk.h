@@ -0,0 +1,30 @@
+#pragma once
+
+#include "fa_types.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------- *
+ * Bulk copy/fill kernels behind memory.copy/fill and table.copy/fill.
+ *
+ * Disjoint copies take the memcpy path, overlapping ones go through memmove
+ * (which walks forward or backward by overlap direction), and copies/fills
+ * at or above FA_BULK_NONTEMPORAL_BYTES use streaming stores where the
+ * target has them so a buffer-sized memset does not evict the working set.
+ * The default sits above typical last-level-cache shares: below it cached
+ * memcpy/memset measure faster (see samples/bulk-bench).
+ * Callers bounds-check once; the kernels do no validation beyond size == 0.
+ * ------------------------------------------------------------------------- */
+#ifndef FA_BULK_NONTEMPORAL_BYTES
+#if defined(FAYASM_TARGET_ESP32) || defined(ESP_PLATFORM)
+#define FA_BULK_NONTEMPORAL_BYTES 0U /* disabled: no streaming stores */
+#else
+#define FA_BULK_NONTEMPORAL_BYTES (32U << 20)
+#endif
+#endif
+
+void fa_bulk_copy(void* dst, const void* src, size_t size);
+void fa_bulk_fill(void* dst, uint8_t value, size_t size);
+void fa_bulk_copy_refs(fa_ptr* dst, const fa_ptr* src, size_t count);
+void fa_bulk_fill_refs(fa_ptr* dst, fa_ptr value, size_t count);
@@ -1,4 +1,5 @@
 #include "fa_jit.h"
+#include "fa_jit_closure.h"
 #include "fa_runtime.h"
 #include "fa_arch.h"
 
@@ -44,6 +45,56 @@ static bool jit_env_flag(const char* name, bool* out) {
     return false;
 }
 
+static bool jit_env_eviction(const char* name, fa_JitEvictionPolicy* out) {
+    if (!name || !out) {
+        return false;
+    }
+    const char* value = getenv(name);
+    if (!value) {
+        return false;
+    }
+    if (strcmp(value, "lfu") == 0) {
+        *out = FA_JIT_EVICT_LFU;
+        return true;
+    }
+    if (strcmp(value, "clock") == 0) {
+        *out = FA_JIT_EVICT_CLOCK;
+        return true;
+    }
+    if (strcmp(value, "round-robin") == 0) {
+        *out = FA_JIT_EVICT_ROUND_ROBIN;
+        return true;
+    }
+    return false;
+}
+
+static bool jit_env_u32(const char* name, uint32_t* out) {
+    if (!name || !out) {
+        return false;
+    }
+    const char* value = getenv(name);
+    if (!value || *value == '\0') {
+        return false;
+    }
+    char* end = NULL;
+    const unsigned long parsed = strtoul(value, &end, 10);
+    if (!end || *end != '\0' || parsed > UINT32_MAX) {
+        return false;
+    }
+    *out = (uint32_t)parsed;
+    return true;
+}
+
+/* A thread count, or "auto" for FA_JIT_PRESCAN_THREADS_AUTO. */
+static bool jit_env_threads(const char* name, uint32_t* out) {
+    const char* value = name ? getenv(name) : NULL;
+    if (value && strcmp(value, "auto") == 0 && out) {
+        *out = FA_JIT_PRESCAN_THREADS_AUTO;
+        return true;
+    }
+    return jit_env_u32(name, out);
+}
+
 fa_JitProbe fa_jit_probe_system(void) {
     fa_JitProbe probe;
     memset(&probe, 0, sizeof(probe));
@@ -114,7 +165,28 @@ fa_JitConfig fa_jit_default_config(void) {
     config.min_advantage_score = 0.55f;
     config.prescan_functions = false;
     config.prescan_force = false;
+    config.native_tier = false;
+    config.closure_tier = false;
+    config.eviction_policy = FA_JIT_EVICT_LFU;
+    config.eviction_aging_interval = 1024U;
+    config.native_threshold = 1U;
+    config.osr_threshold = 64U;
+    config.worker_threads = 0U;
+    config.prescan_threads = 0U;
+    config.prescan_lazy = false;
+    config.prescan_prefetch = false;
+    config.fuse_ops = true;
     (void)jit_env_flag("FAYASM_JIT_PRESCAN", &config.prescan_functions);
+    (void)jit_env_flag("FAYASM_JIT_NATIVE", &config.native_tier);
+    (void)jit_env_flag("FAYASM_JIT_CLOSURE", &config.closure_tier);
+    (void)jit_env_eviction("FAYASM_JIT_EVICTION", &config.eviction_policy);
+    (void)jit_env_u32("FAYASM_JIT_NATIVE_THRESHOLD", &config.native_threshold);
+    (void)jit_env_u32("FAYASM_JIT_OSR_THRESHOLD", &config.osr_threshold);
+    (void)jit_env_u32("FAYASM_JIT_WORKERS", &config.worker_threads);
+    (void)jit_env_threads("FAYASM_JIT_PRESCAN_THREADS", &config.prescan_threads);
+    (void)jit_env_flag("FAYASM_JIT_PRESCAN_LAZY", &config.prescan_lazy);
+    (void)jit_env_flag("FAYASM_JIT_PRESCAN_PREFETCH", &config.prescan_prefetch);
+    (void)jit_env_flag("FAYASM_JIT_FUSE", &config.fuse_ops);
     bool force_prescan = false;
     if (jit_env_flag("FAYASM_JIT_PRESCAN_FORCE", &force_prescan) && force_prescan) {
         config.prescan_functions = true;
@@ -183,7 +255,11 @@ fa_JitDecision fa_jit_decide(const fa_JitProbe* probe, const fa_JitConfig* confi
         decision.reason = FA_JIT_DECISION_LOW_ADVANTAGE;
         return decision;
     }
-    decision.tier = FA_JIT_TIER_MICROCODE;
+    if (config->native_tier && fa_jit_native_supported()) {
+        decision.tier = FA_JIT_TIER_NATIVE;
+    } else {
+        decision.tier = config->closure_tier ? FA_JIT_TIER_CLOSURE : FA_JIT_TIER_MICROCODE;
+    }
     decision.reason = FA_JIT_DECISION_OK;
     return decision;
 }
@@ -214,6 +290,25 @@ void fa_jit_context_apply_env_overrides(fa_JitContext* ctx) {
     if (jit_env_flag("FAYASM_JIT_PRESCAN", &prescan)) {
         ctx->config.prescan_functions = prescan;
     }
+    bool native = ctx->config.native_tier;
+    if (jit_env_flag("FAYASM_JIT_NATIVE", &native)) {
+        ctx->config.native_tier = native;
+    }
+    bool closure = ctx->config.closure_tier;
+    if (jit_env_flag("FAYASM_JIT_CLOSURE", &closure)) {
+        ctx->config.closure_tier = closure;
+    }
+    (void)jit_env_eviction("FAYASM_JIT_EVICTION", &ctx->config.eviction_policy);
+    (void)jit_env_u32("FAYASM_JIT_NATIVE_THRESHOLD", &ctx->config.native_threshold);
+    (void)jit_env_u32("FAYASM_JIT_OSR_THRESHOLD", &ctx->config.osr_threshold);
+    (void)jit_env_u32("FAYASM_JIT_WORKERS", &ctx->config.worker_threads);
+    (void)jit_env_threads("FAYASM_JIT_PRESCAN_THREADS", &ctx->config.prescan_threads);
+    (void)jit_env_flag("FAYASM_JIT_PRESCAN_LAZY", &ctx->config.prescan_lazy);
+    (void)jit_env_flag("FAYASM_JIT_PRESCAN_PREFETCH", &ctx->config.prescan_prefetch);
+    bool fuse = ctx->config.fuse_ops;
+    if (jit_env_flag("FAYASM_JIT_FUSE", &fuse)) {
+        ctx->config.fuse_ops = fuse;
+    }
     bool force = ctx->config.prescan_force;
     if (jit_env_flag("FAYASM_JIT_PRESCAN_FORCE", &force)) {
         ctx->config.prescan_force = force;
@@ -235,9 +330,11 @@ void fa_jit_program_free(fa_JitProgram* program) {
         return;
     }
     free(program->ops);
+    fa_jit_closure_free(program->closure);
     program->ops = NULL;
     program->count = 0;
     program->capacity = 0;
+    program->closure = NULL;
 }
 
 bool fa_jit_prepare_op(const fa_WasmOp* descriptor, fa_JitPreparedOp* out) {
@@ -254,6 +351,8 @@ bool fa_jit_prepare_op(const fa_WasmOp* descriptor, fa_JitPreparedOp* out) {
         }
         memcpy(out->steps, mc_steps, (size_t)mc_count * sizeof(Operation));
         out->step_count = mc_count;
+        /* A single step is already its own fused handler. */
+        out->fused = mc_count == 1 ? mc_steps[0] : NULL;
         return true;
     }
     if (!descriptor->operation) {
@@ -261,6 +360,7 @@ bool fa_jit_prepare_op(const fa_WasmOp* descriptor, fa_JitPreparedOp* out) {
     }
     out->steps[0] = descriptor->operation;
     out->step_count = 1;
+    out->fused = descriptor->operation;
     return true;
 }
 
@@ -318,6 +418,33 @@ bool fa_jit_program_import_opcodes(const uint8_t* opcodes, size_t opcode_count,
     return fa_jit_prepare_program_from_opcodes(opcodes, opcode_count, program_out);
 }
 
+size_t fa_jit_program_fuse(fa_JitProgram* program, const uint32_t* offsets, size_t offset_count) {
+    if (!program || !program->ops || !offsets) {
+        return 0;
+    }
+    const size_t count = program->count < offset_count ? program->count : offset_count;
+    size_t pairs = 0;
+    for (size_t i = 0; i + 1U < count; ++i) {
+        fa_JitPreparedOp* op = &program->ops[i];
+        const fa_JitPreparedOp* next = &program->ops[i + 1U];
+        if (op->fused_ops > 0 || offsets[i + 1U] != offsets[i] + 1U) {
+            continue;
+        }
+        if (!op->descriptor || !next->descriptor ||
+            op->descriptor->num_args != 0 || next->descriptor->num_args != 0) {
+            continue;
+        }
+        Operation handler = NULL;
+        if (!fa_ops_get_fused_pair(op->descriptor->id, next->descriptor->id, &handler)) {
+            continue;
+        }
+        op->fused = handler;
+        op->fused_ops = 1;
+        pairs++;
+    }
+    return pairs;
+}
+
 /* ------------------------------------------------------------------------- *
  * Shared spill envelope (see fa_jit.h for the layout). Both the JIT opcode
  * serializer below and the runtime memory serializer encode through these so
@@ -368,13 +495,17 @@ bool fa_spill_read_header(const uint8_t* in,
 }
 
 size_t fa_jit_program_serialized_size(const fa_JitProgram* program) {
-    if (!program || program->count == 0) {
+    if (!program || (program->count == 0 && !program->closure)) {
+        return 0;
+    }
+    const size_t closure_bytes = fa_jit_closure_serialized_size(program->closure);
+    if (program->closure && closure_bytes == 0) {
         return 0;
     }
-    if (program->count > SIZE_MAX - FA_SPILL_HEADER_BYTES) {
+    if (program->count > SIZE_MAX - FA_SPILL_HEADER_BYTES - closure_bytes) {
         return 0;
     }
-    return (size_t)FA_SPILL_HEADER_BYTES + program->count;
+    return (program->count > 0 ? (size_t)FA_SPILL_HEADER_BYTES + program->count : 0) + closure_bytes;
 }
 
 bool fa_jit_program_serialize(const fa_JitProgram* program,
@@ -388,14 +519,23 @@ bool fa_jit_program_serialize(const fa_JitProgram* program,
     if (needed == 0 || !out || capacity < needed) {
         return false;
     }
-    if (fa_spill_write_header(out, capacity, (uint16_t)FA_SPILL_KIND_JIT_OPCODES,
-                              (uint64_t)program->count) != FA_SPILL_HEADER_BYTES) {
-        return false;
+    size_t at = 0;
+    if (program->count > 0) {
+        if (fa_spill_write_header(out, capacity, (uint16_t)FA_SPILL_KIND_JIT_OPCODES,
+                                  (uint64_t)program->count) != FA_SPILL_HEADER_BYTES) {
+            return false;
+        }
+        size_t opcode_count = 0;
+        if (!fa_jit_program_export_opcodes(program, out + FA_SPILL_HEADER_BYTES,
+                                           capacity - FA_SPILL_HEADER_BYTES, &opcode_count) ||
+            opcode_count != program->count) {
+            return false;
+        }
+        at = FA_SPILL_HEADER_BYTES + program->count;
     }
-    size_t opcode_count = 0;
-    if (!fa_jit_program_export_opcodes(program, out + FA_SPILL_HEADER_BYTES,
-                                       capacity - FA_SPILL_HEADER_BYTES, &opcode_count) ||
-        opcode_count != program->count) {
+    size_t closure_written = 0;
+    if (program->closure &&
+        !fa_jit_closure_serialize(program->closure, out + at, capacity - at, &closure_written)) {
         return false;
     }
     if (written_out) {
@@ -408,24 +548,44 @@ bool fa_jit_program_deserialize(const uint8_t* buffer, size_t size, fa_JitProgra
     if (!program_out) {
         return false;
     }
-    uint16_t kind = 0;
-    uint64_t payload = 0;
-    if (!fa_spill_read_header(buffer, size, &kind, &payload)) {
-        return false;
-    }
-    if (kind != (uint16_t)FA_SPILL_KIND_JIT_OPCODES) {
-        return false;
-    }
-    if (payload == 0 || payload > (uint64_t)SIZE_MAX) {
-        return false;
+    fa_JitProgram loaded;
+    fa_jit_program_init(&loaded);
+    size_t at = 0;
+    uint16_t previous = 0;
+    while (at == 0 || at < size) {
+        uint16_t kind = 0;
+        uint64_t payload = 0;
+        if (!fa_spill_read_header(buffer + at, size - at, &kind, &payload) || payload == 0 ||
+            payload > (uint64_t)SIZE_MAX || kind <= previous) {
+            fa_jit_program_free(&loaded);
+            return false;
+        }
+        const size_t bytes = (size_t)FA_SPILL_HEADER_BYTES + (size_t)payload;
+        bool ok = false;
+        if (kind == (uint16_t)FA_SPILL_KIND_JIT_OPCODES) {
+            ok = fa_jit_program_import_opcodes(buffer + at + FA_SPILL_HEADER_BYTES, (size_t)payload, &loaded);
+        } else if (kind == (uint16_t)FA_SPILL_KIND_JIT_CLOSURES) {
+            ok = fa_jit_closure_deserialize(buffer + at, bytes, &loaded.closure);
+        }
+        if (!ok) {
+            fa_jit_program_free(&loaded);
+            return false;
+        }
+        previous = kind;
+        at += bytes;
     }
-    return fa_jit_program_import_opcodes(buffer + FA_SPILL_HEADER_BYTES, (size_t)payload, program_out);
+    fa_jit_program_free(program_out);
+    *program_out = loaded;
+    return true;
 }
 
 OP_RETURN_TYPE fa_jit_execute_prepared_op(const fa_JitPreparedOp* prepared, struct fa_Runtime* runtime, fa_Job* job) {
     if (!prepared || !prepared->descriptor) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
+    if (prepared->fused) {
+        return prepared->fused(runtime, job, prepared->descriptor);
+    }
     if (prepared->step_count == 0) {
         return FA_RUNTIME_ERR_UNIMPLEMENTED_OPCODE;
     }
@@ -443,8 +603,9 @@ OP_RETURN_TYPE fa_jit_execute_prepared_op(const fa_JitPreparedOp* prepared, stru
 }
 
 size_t fa_jit_program_estimate_bytes(const fa_JitProgram* program) {
-    if (!program || !program->ops) {
+    if (!program) {
         return 0;
     }
-    return program->count * sizeof(fa_JitPreparedOp);
+    const size_t ops = program->ops ? program->count * sizeof(fa_JitPreparedOp) : 0;
+    return ops + fa_jit_closure_estimate_bytes(program->closure);
 }
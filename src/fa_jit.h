@@ -1,6 +1,8 @@
 #pragma once
 
 #include "fa_ops.h"
+#include "fa_wasm.h"
+#include "fa_arch.h"
 
 #include <stddef.h>
 #include <stdint.h>
@@ -19,7 +21,10 @@
  * little-endian byte order (no struct packing / host-endianness assumptions),
  * which is what makes the blobs portable on embedded targets. Raw function
  * pointers are never serialized: JIT programs persist as opcode streams and are
- * recompiled to microcode on load.
+ * recompiled to microcode on load, and closure-tier records persist as IR
+ * handler triples with successor indices that are rebound on load. The
+ * on-disk code cache (FA_SPILL_KIND_JIT_CODE) stores native code as-is, since
+ * it addresses everything through its context and never embeds a pointer.
  *
  * Header layout:
  *   offset 0  u32  magic           (FA_SPILL_MAGIC)
@@ -33,7 +38,10 @@
 
 typedef enum {
     FA_SPILL_KIND_JIT_OPCODES = 1,
-    FA_SPILL_KIND_MEMORY = 2
+    FA_SPILL_KIND_MEMORY = 2,
+    FA_SPILL_KIND_JIT_CLOSURES = 3,
+    FA_SPILL_KIND_JIT_CODE = 4, /* persisted compiled code (fa_jit_persist.h) */
+    FA_SPILL_KIND_MODULE_BUNDLE = 5 /* precompiled module (fa_CompiledModule_writeBundle) */
 } fa_SpillKind;
 
 /* Little-endian primitive accessors shared by every spill payload so the
@@ -82,7 +90,8 @@ bool fa_spill_read_header(const uint8_t* in,
 typedef enum {
     FA_JIT_TIER_OFF = 0,
     FA_JIT_TIER_MICROCODE = 1,
-    FA_JIT_TIER_NATIVE = 2
+    FA_JIT_TIER_NATIVE = 2,
+    FA_JIT_TIER_CLOSURE = 3 /* portable compiled tier (fa_jit_closure.h) */
 } fa_JitTier;
 
 typedef enum {
@@ -97,6 +106,18 @@ typedef struct {
     bool ok;
 } fa_JitProbe;
 
+/* Victim selection when the JIT cache budget is exhausted. Functions with an
+   interpreted or native frame on the stack are never picked. */
+typedef enum {
+    FA_JIT_EVICT_LFU = 0,     /* fewest aged accesses (calls + loop back-edges) */
+    FA_JIT_EVICT_CLOCK,       /* generalized CLOCK: the hand decays small access weights */
+    FA_JIT_EVICT_ROUND_ROBIN  /* cursor order, ignores hotness */
+} fa_JitEvictionPolicy;
+
+#define FA_JIT_CLOCK_MAX_WEIGHT 3U
+
+#define FA_JIT_PRESCAN_THREADS_AUTO 0xFFFFFFFFu
+
 typedef struct {
     uint64_t min_ram_bytes;
     uint32_t min_cpu_count;
@@ -108,6 +129,35 @@ typedef struct {
     float min_advantage_score;
     bool prescan_functions;
     bool prescan_force;
+    bool native_tier; /* allow FA_JIT_TIER_NATIVE where a backend exists (FAYASM_JIT_NATIVE) */
+    /* Use FA_JIT_TIER_CLOSURE whenever the native tier is not taken
+       (FAYASM_JIT_CLOSURE): with native_tier also set, hosts without a
+       backend fall back to closures instead of microcode. */
+    bool closure_tier;
+    fa_JitEvictionPolicy eviction_policy; /* FAYASM_JIT_EVICTION=lfu|clock|round-robin */
+    uint32_t eviction_aging_interval;     /* accesses between LFU counter halvings, 0 = never */
+    /* Tier-up: a function is compiled to native code (or closures) once its
+       calls plus loop back-edges reach `native_threshold`
+       (FAYASM_JIT_NATIVE_THRESHOLD); an interpreted frame whose loop takes
+       `osr_threshold` back-edges moves into compiled code at that loop header
+       (FAYASM_JIT_OSR_THRESHOLD, 0 = no OSR). */
+    uint32_t native_threshold;
+    uint32_t osr_threshold;
+    /* Background compile threads (FAYASM_JIT_WORKERS, fa_jit_worker.h); 0
+       compiles synchronously inside the execution loop. */
+    uint32_t worker_threads;
+    /* Load-time prescan on a worker pool (FAYASM_JIT_PRESCAN_THREADS); 0 scans
+       on the attaching thread, FA_JIT_PRESCAN_THREADS_AUTO sizes the pool from
+       the probed cpu_count. Only used when the prescan runs. */
+    uint32_t prescan_threads;
+    /* Prescan each function on its first interpreted call instead of at attach
+       (FAYASM_JIT_PRESCAN_LAZY); with prescan_prefetch
+       (FAYASM_JIT_PRESCAN_PREFETCH) and worker_threads > 0, the direct call
+       targets of every newly prescanned function are prescanned in the
+       background ahead of their own first call. */
+    bool prescan_lazy;
+    bool prescan_prefetch;
+    bool fuse_ops; /* run adjacent op pairs through fused handlers (FAYASM_JIT_FUSE) */
 } fa_JitConfig;
 
 typedef struct {
@@ -133,12 +183,22 @@ typedef struct {
     const fa_WasmOp* descriptor;
     Operation steps[FA_JIT_MAX_STEPS_PER_OP];
     uint8_t step_count;
+    /* One handler standing in for every step, NULL when the steps must run in
+       turn. With fused_ops > 0 it also executes the next fused_ops ops of the
+       basic block and the caller skips past them. */
+    Operation fused;
+    uint8_t fused_ops;
 } fa_JitPreparedOp;
 
+struct fa_JitClosureProgram;
+
 typedef struct {
     fa_JitPreparedOp* ops;
     size_t count;
     size_t capacity;
+    /* Closure-tier records for the whole function, NULL until compiled. Owned
+       by the program, so budgeting, eviction and spilling cover both. */
+    struct fa_JitClosureProgram* closure;
 } fa_JitProgram;
 
 typedef struct {
@@ -166,11 +226,18 @@ bool fa_jit_program_export_opcodes(const fa_JitProgram* program,
                                    size_t opcodes_capacity,
                                    size_t* opcode_count_out);
 bool fa_jit_program_import_opcodes(const uint8_t* opcodes, size_t opcode_count, fa_JitProgram* program_out);
+/* Fuses adjacent prepared ops that have a pre-generated pair handler
+   (fa_ops_get_fused_pair). `offsets[i]` is the body offset of op i; only ops
+   at consecutive offsets, i.e. immediate-free neighbours in one basic block,
+   are paired. Returns the number of pairs. */
+size_t fa_jit_program_fuse(fa_JitProgram* program, const uint32_t* offsets, size_t offset_count);
 size_t fa_jit_program_estimate_bytes(const fa_JitProgram* program);
 
 /* Versioned spill serialization for a prepared program. The blob is the shared
    spill envelope (kind FA_SPILL_KIND_JIT_OPCODES) followed by the opcode stream,
-   so it persists across boots and rebuilds microcode on load. */
+   so it persists across boots and rebuilds microcode on load. Programs holding
+   closure records append a second envelope (FA_SPILL_KIND_JIT_CLOSURES); either
+   part may be absent, but not both. */
 size_t fa_jit_program_serialized_size(const fa_JitProgram* program);
 bool fa_jit_program_serialize(const fa_JitProgram* program,
                               uint8_t* out,
@@ -178,3 +245,102 @@ bool fa_jit_program_serialize(const fa_JitProgram* program,
                               size_t* written_out);
 bool fa_jit_program_deserialize(const uint8_t* buffer, size_t size, fa_JitProgram* program_out);
 OP_RETURN_TYPE fa_jit_execute_prepared_op(const fa_JitPreparedOp* prepared, struct fa_Runtime* runtime, fa_Job* job);
+
+/* ------------------------------------------------------------------------- *
+ * Native tier (FA_JIT_TIER_NATIVE).
+ *
+ * A baseline compiler lowers whole function bodies to a slot IR and then to
+ * x86-64 or AArch64 machine code (Linux hosts). Compiled functions keep every
+ * local and operand-stack value in a flat array of 64-bit slots: arguments
+ * arrive in slots[0..params), results are returned in slots[0..results), and
+ * callees reuse the caller's slots starting at their first argument. The
+ * entry returns an FA_RUNTIME_* status, so traps unwind through ordinary
+ * returns. Functions using anything outside the baseline subset are rejected
+ * at compile time and stay interpreted.
+ *
+ * The AArch64 backend only runs when built with FAYASM_JIT_NATIVE_AARCH64
+ * (the CMake option of the same name, on in the cross toolchain file
+ * cmake/toolchains/aarch64-linux-gnu.cmake, whose ctest runs the suite under
+ * qemu-user). Otherwise AArch64 hosts stay interpreted, and the backend is
+ * only exercised as an emitter.
+ * ------------------------------------------------------------------------- */
+#if defined(FA_ARCH_CPU_X86_64) && defined(__linux__) && !defined(FAYASM_TARGET_ESP32)
+#define FA_JIT_NATIVE_X86_64 1
+#elif defined(FA_ARCH_CPU_AARCH64) && defined(__linux__) && !defined(FAYASM_TARGET_ESP32) && \
+    defined(FAYASM_JIT_NATIVE_AARCH64)
+#define FA_JIT_NATIVE_AARCH64 1
+#endif
+#if defined(FA_JIT_NATIVE_X86_64) || defined(FA_JIT_NATIVE_AARCH64)
+#define FA_JIT_NATIVE_HOST 1
+#endif
+
+typedef enum {
+    FA_JIT_NATIVE_ARCH_X86_64 = 0,
+    FA_JIT_NATIVE_ARCH_AARCH64
+} fa_JitNativeArch;
+
+#if defined(FA_JIT_NATIVE_AARCH64)
+#define FA_JIT_NATIVE_ARCH_HOST FA_JIT_NATIVE_ARCH_AARCH64
+#else
+#define FA_JIT_NATIVE_ARCH_HOST FA_JIT_NATIVE_ARCH_X86_64
+#endif
+
+typedef struct fa_JitNativeContext fa_JitNativeContext;
+typedef int (*fa_JitNativeEntry)(fa_JitNativeContext* ctx, uint64_t* slots);
+
+struct fa_JitNativeContext {
+    const fa_JitNativeEntry* entries; /* by function index; NULL while not compiled */
+    /* Runs `function_index` (imported, interpreted or not yet compiled) with
+       its arguments in slots[0..params); results land in slots[0..results). */
+    int (*call_slow)(fa_JitNativeContext* ctx, uint64_t* slots, uint32_t function_index);
+    /* memory.grow on memory 0; returns the previous page count or -1. */
+    int64_t (*memory_grow)(fa_JitNativeContext* ctx, uint32_t delta_pages);
+    void* memory;        /* fa_RuntimeMemory* of memory 0, or NULL */
+    fa_JobValue* globals;
+    uint64_t* slot_limit; /* one past the last usable slot */
+    uint32_t depth;
+    uint32_t max_depth;
+    struct fa_Runtime* runtime;
+};
+
+typedef struct {
+    const WasmModule* module;
+    uint32_t func_index;
+    const uint8_t* body; /* full body: local declarations followed by code */
+    uint32_t body_size;
+    bool memory_flat;    /* memory 0 exists, is 32-bit and is not demand-paged */
+    /* Non-zero: compile an on-stack-replacement entry instead. The code starts
+       at the loop whose body begins at body offset `osr_pc` (just past the
+       loop's block type) with locals and operand values already in the slots;
+       see fa_JitNativeCode.osr_height. */
+    uint32_t osr_pc;
+} fa_JitNativeRequest;
+
+struct fa_JitCodeCache;
+
+typedef struct {
+    void* map;
+    size_t map_bytes;     /* charged bytes: the cache block, or the whole mapping */
+    size_t code_bytes;
+    uint32_t frame_slots;
+    uint32_t osr_height;  /* OSR entries: live slots at the loop header (locals + operands) */
+    fa_JitNativeEntry entry;
+    struct fa_JitCodeCache* cache; /* owning code cache, NULL for a private mapping */
+} fa_JitNativeCode;
+
+bool fa_jit_native_supported(void);
+/* Compiles into read+execute memory (written while read+write, then flipped):
+   a block of `cache` (fa_jit_code_cache.h) or, with a NULL cache, a private
+   mapping. Returns false, leaving `out` zeroed, when the body is outside the
+   subset or no executable memory is available. */
+bool fa_jit_native_compile(const fa_JitNativeRequest* request, struct fa_JitCodeCache* cache, fa_JitNativeCode* out);
+/* The mapping half of fa_jit_native_compile: installs host code produced by
+   fa_jit_native_emit (e.g. on another thread). `code` stays the caller's. */
+bool fa_jit_native_install(const uint8_t* code, size_t code_bytes, uint32_t frame_slots,
+                           struct fa_JitCodeCache* cache, fa_JitNativeCode* out);
+void fa_jit_native_free(fa_JitNativeCode* code);
+/* Lowers `request` for `arch` into a malloc'd buffer without mapping it. Both
+   backends are plain byte emitters, so any host can produce either target's
+   code (e.g. to inspect it, or to cross-check it under qemu-user). */
+bool fa_jit_native_emit(const fa_JitNativeRequest* request, fa_JitNativeArch arch,
+                        uint8_t** code_out, size_t* size_out, uint32_t* frame_slots_out);
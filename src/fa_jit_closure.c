@@ -0,0 +1,808 @@
+#include "fa_jit_closure.h"
+#include "fa_jit_native_ir.h"
+#include "fa_runtime.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------------------------------------------------------------------- *
+ * Closure tier: handlers, lowering and persistence.
+ *
+ * Every handler implements one IR operation at one width with the native
+ * backends' semantics (wasm traps for division, truncation and out-of-bounds
+ * accesses; i32/f32 values in the low half of a slot). Handlers reach the
+ * operands through the frame's slot array and hand the trampoline their
+ * successor, so control flow costs one pointer load.
+ * ------------------------------------------------------------------------- */
+
+#define CLOSURE_NONE UINT32_MAX
+#define CLOSURE_SHAPE_BYTES 28U
+#define CLOSURE_RECORD_BYTES 36U
+#define CLOSURE_COUNT(table) ((uint8_t)(sizeof(table) / sizeof((table)[0])))
+
+#define S(index) (frame->slots[(index)])
+
+static const fa_JitClosure* closure_fail(fa_JitClosureFrame* frame, int status) {
+    frame->status = status;
+    return NULL;
+}
+
+static float closure_f32(uint64_t slot) {
+    const uint32_t bits = (uint32_t)slot;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static uint64_t closure_from_f32(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double closure_f64(uint64_t slot) {
+    double value;
+    memcpy(&value, &slot, sizeof(value));
+    return value;
+}
+
+static uint64_t closure_from_f64(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/* ----- control ----- */
+
+static const fa_JitClosure* closure_jump(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    (void)frame;
+    return self->target;
+}
+
+static const fa_JitClosure* closure_jump_if_zero(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    return (uint32_t)S(self->a) == 0U ? self->target : self->next;
+}
+
+static const fa_JitClosure* closure_jump_if_ne_imm(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    return (uint32_t)S(self->a) != (uint32_t)self->imm ? self->target : self->next;
+}
+
+static const fa_JitClosure* closure_trap(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    (void)self;
+    return closure_fail(frame, FA_RUNTIME_ERR_TRAP);
+}
+
+static const fa_JitClosure* closure_return(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    (void)self;
+    (void)frame;
+    return NULL;
+}
+
+static const fa_JitClosure* closure_const(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    S(self->dst) = self->imm;
+    return self->next;
+}
+
+static const fa_JitClosure* closure_move(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    S(self->dst) = S(self->a);
+    return self->next;
+}
+
+static const fa_JitClosure* closure_select(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    S(self->dst) = (uint32_t)S(self->c) != 0U ? S(self->a) : S(self->b);
+    return self->next;
+}
+
+/* ----- integer operators ----- */
+
+#define CLOSURE_BINARY(name, type, expr)                                                       \
+    static const fa_JitClosure* name(const fa_JitClosure* self, fa_JitClosureFrame* frame) {  \
+        const type a = (type)S(self->a);                                                       \
+        const type b = (type)S(self->b);                                                       \
+        S(self->dst) = (uint64_t)(type)(expr);                                                 \
+        return self->next;                                                                     \
+    }
+
+#define CLOSURE_INT_FAMILY(bits, utype, stype)                                                         \
+    CLOSURE_BINARY(closure_i##bits##_add, utype, a + b)                                                \
+    CLOSURE_BINARY(closure_i##bits##_sub, utype, a - b)                                                \
+    CLOSURE_BINARY(closure_i##bits##_mul, utype, a * b)                                                \
+    CLOSURE_BINARY(closure_i##bits##_and, utype, a & b)                                                \
+    CLOSURE_BINARY(closure_i##bits##_or, utype, a | b)                                                 \
+    CLOSURE_BINARY(closure_i##bits##_xor, utype, a ^ b)                                                \
+    CLOSURE_BINARY(closure_i##bits##_shl, utype, a << (b & (bits - 1U)))                               \
+    CLOSURE_BINARY(closure_i##bits##_shr_s, utype, (utype)((stype)a >> (b & (bits - 1U))))             \
+    CLOSURE_BINARY(closure_i##bits##_shr_u, utype, a >> (b & (bits - 1U)))                             \
+    CLOSURE_BINARY(closure_i##bits##_rotl, utype,                                                      \
+                   (a << (b & (bits - 1U))) | (a >> ((bits - (b & (bits - 1U))) & (bits - 1U))))       \
+    CLOSURE_BINARY(closure_i##bits##_rotr, utype,                                                      \
+                   (a >> (b & (bits - 1U))) | (a << ((bits - (b & (bits - 1U))) & (bits - 1U))))       \
+    static const fa_JitClosure* closure_i##bits##_div_s(const fa_JitClosure* self,                     \
+                                                         fa_JitClosureFrame* frame) {                  \
+        const stype a = (stype)(utype)S(self->a);                                                      \
+        const stype b = (stype)(utype)S(self->b);                                                      \
+        if (b == 0 || (b == -1 && a == (stype)((utype)1 << (bits - 1U)))) {                            \
+            return closure_fail(frame, FA_RUNTIME_ERR_TRAP);                                           \
+        }                                                                                              \
+        S(self->dst) = (uint64_t)(utype)(a / b);                                                       \
+        return self->next;                                                                             \
+    }                                                                                                  \
+    static const fa_JitClosure* closure_i##bits##_div_u(const fa_JitClosure* self,                     \
+                                                         fa_JitClosureFrame* frame) {                  \
+        const utype b = (utype)S(self->b);                                                             \
+        if (b == 0U) {                                                                                 \
+            return closure_fail(frame, FA_RUNTIME_ERR_TRAP);                                           \
+        }                                                                                              \
+        S(self->dst) = (uint64_t)((utype)S(self->a) / b);                                              \
+        return self->next;                                                                             \
+    }                                                                                                  \
+    static const fa_JitClosure* closure_i##bits##_rem_s(const fa_JitClosure* self,                     \
+                                                         fa_JitClosureFrame* frame) {                  \
+        const stype a = (stype)(utype)S(self->a);                                                      \
+        const stype b = (stype)(utype)S(self->b);                                                      \
+        if (b == 0) {                                                                                  \
+            return closure_fail(frame, FA_RUNTIME_ERR_TRAP);                                           \
+        }                                                                                              \
+        S(self->dst) = b == -1 ? 0U : (uint64_t)(utype)(a % b);                                        \
+        return self->next;                                                                             \
+    }                                                                                                  \
+    static const fa_JitClosure* closure_i##bits##_rem_u(const fa_JitClosure* self,                     \
+                                                         fa_JitClosureFrame* frame) {                  \
+        const utype b = (utype)S(self->b);                                                             \
+        if (b == 0U) {                                                                                 \
+            return closure_fail(frame, FA_RUNTIME_ERR_TRAP);                                           \
+        }                                                                                              \
+        S(self->dst) = (uint64_t)((utype)S(self->a) % b);                                              \
+        return self->next;                                                                             \
+    }                                                                                                  \
+    CLOSURE_BINARY(closure_i##bits##_eq, utype, a == b)                                                \
+    CLOSURE_BINARY(closure_i##bits##_ne, utype, a != b)                                                \
+    CLOSURE_BINARY(closure_i##bits##_lt_s, utype, (stype)a < (stype)b)                                 \
+    CLOSURE_BINARY(closure_i##bits##_lt_u, utype, a < b)                                               \
+    CLOSURE_BINARY(closure_i##bits##_gt_s, utype, (stype)a > (stype)b)                                 \
+    CLOSURE_BINARY(closure_i##bits##_gt_u, utype, a > b)                                               \
+    CLOSURE_BINARY(closure_i##bits##_le_s, utype, (stype)a <= (stype)b)                                \
+    CLOSURE_BINARY(closure_i##bits##_le_u, utype, a <= b)                                              \
+    CLOSURE_BINARY(closure_i##bits##_ge_s, utype, (stype)a >= (stype)b)                                \
+    CLOSURE_BINARY(closure_i##bits##_ge_u, utype, a >= b)                                              \
+    static const fa_JitClosure* closure_i##bits##_eqz(const fa_JitClosure* self,                       \
+                                                       fa_JitClosureFrame* frame) {                    \
+        S(self->dst) = (utype)S(self->a) == 0U ? 1U : 0U;                                              \
+        return self->next;                                                                             \
+    }                                                                                                  \
+    static const fa_JitClosure* closure_i##bits##_clz(const fa_JitClosure* self,                       \
+                                                       fa_JitClosureFrame* frame) {                    \
+        utype value = (utype)S(self->a);                                                               \
+        uint64_t count = bits;                                                                         \
+        while (value != 0U) {                                                                          \
+            value >>= 1U;                                                                              \
+            --count;                                                                                   \
+        }                                                                                              \
+        S(self->dst) = count;                                                                          \
+        return self->next;                                                                             \
+    }                                                                                                  \
+    static const fa_JitClosure* closure_i##bits##_ctz(const fa_JitClosure* self,                       \
+                                                       fa_JitClosureFrame* frame) {                    \
+        utype value = (utype)S(self->a);                                                               \
+        uint64_t count = 0;                                                                            \
+        if (value == 0U) {                                                                             \
+            count = bits;                                                                              \
+        }                                                                                              \
+        while (value != 0U && (value & 1U) == 0U) {                                                    \
+            value >>= 1U;                                                                              \
+            ++count;                                                                                   \
+        }                                                                                              \
+        S(self->dst) = count;                                                                          \
+        return self->next;                                                                             \
+    }
+
+CLOSURE_INT_FAMILY(32, uint32_t, int32_t)
+CLOSURE_INT_FAMILY(64, uint64_t, int64_t)
+
+/* ----- float operators ----- */
+
+#define CLOSURE_FLOAT_BINARY(name, type, read, write, expr)                                    \
+    static const fa_JitClosure* name(const fa_JitClosure* self, fa_JitClosureFrame* frame) {  \
+        const type a = read(S(self->a));                                                       \
+        const type b = read(S(self->b));                                                       \
+        S(self->dst) = write(expr);                                                            \
+        return self->next;                                                                     \
+    }
+
+#define CLOSURE_FLOAT_COMPARE(name, type, read, expr)                                          \
+    static const fa_JitClosure* name(const fa_JitClosure* self, fa_JitClosureFrame* frame) {  \
+        const type a = read(S(self->a));                                                       \
+        const type b = read(S(self->b));                                                       \
+        S(self->dst) = (expr) ? 1U : 0U;                                                       \
+        return self->next;                                                                     \
+    }
+
+#define CLOSURE_FLOAT_FAMILY(bits, type, read, write, root, sign)                                      \
+    CLOSURE_FLOAT_BINARY(closure_f##bits##_add, type, read, write, a + b)                              \
+    CLOSURE_FLOAT_BINARY(closure_f##bits##_sub, type, read, write, a - b)                              \
+    CLOSURE_FLOAT_BINARY(closure_f##bits##_mul, type, read, write, a * b)                              \
+    CLOSURE_FLOAT_BINARY(closure_f##bits##_div, type, read, write, a / b)                              \
+    static const fa_JitClosure* closure_f##bits##_copysign(const fa_JitClosure* self,                  \
+                                                            fa_JitClosureFrame* frame) {               \
+        S(self->dst) = (S(self->a) & (sign - 1U)) | (S(self->b) & sign);                               \
+        return self->next;                                                                             \
+    }                                                                                                  \
+    static const fa_JitClosure* closure_f##bits##_abs(const fa_JitClosure* self,                       \
+                                                       fa_JitClosureFrame* frame) {                    \
+        S(self->dst) = S(self->a) & (sign - 1U);                                                       \
+        return self->next;                                                                             \
+    }                                                                                                  \
+    static const fa_JitClosure* closure_f##bits##_neg(const fa_JitClosure* self,                       \
+                                                       fa_JitClosureFrame* frame) {                    \
+        S(self->dst) = (S(self->a) ^ sign) & (sign | (sign - 1U));                                     \
+        return self->next;                                                                             \
+    }                                                                                                  \
+    static const fa_JitClosure* closure_f##bits##_sqrt(const fa_JitClosure* self,                      \
+                                                        fa_JitClosureFrame* frame) {                   \
+        S(self->dst) = write(root(read(S(self->a))));                                                  \
+        return self->next;                                                                             \
+    }                                                                                                  \
+    CLOSURE_FLOAT_COMPARE(closure_f##bits##_eq, type, read, a == b)                                    \
+    CLOSURE_FLOAT_COMPARE(closure_f##bits##_ne, type, read, a != b)                                    \
+    CLOSURE_FLOAT_COMPARE(closure_f##bits##_lt, type, read, a < b)                                     \
+    CLOSURE_FLOAT_COMPARE(closure_f##bits##_gt, type, read, a > b)                                     \
+    CLOSURE_FLOAT_COMPARE(closure_f##bits##_le, type, read, a <= b)                                    \
+    CLOSURE_FLOAT_COMPARE(closure_f##bits##_ge, type, read, a >= b)
+
+CLOSURE_FLOAT_FAMILY(32, float, closure_f32, closure_from_f32, sqrtf, 0x80000000ULL)
+CLOSURE_FLOAT_FAMILY(64, double, closure_f64, closure_from_f64, sqrt, 0x8000000000000000ULL)
+
+/* ----- conversions ----- */
+
+#define CLOSURE_CONVERT(name, expr)                                                            \
+    static const fa_JitClosure* name(const fa_JitClosure* self, fa_JitClosureFrame* frame) {  \
+        const uint64_t a = S(self->a);                                                         \
+        S(self->dst) = (expr);                                                                 \
+        return self->next;                                                                     \
+    }
+
+/* Truncations trap on NaN (every comparison fails) and out-of-range input;
+   the bounds are exclusive and exact in double. */
+#define CLOSURE_TRUNCATE(name, read, low, high, type)                                          \
+    static const fa_JitClosure* name(const fa_JitClosure* self, fa_JitClosureFrame* frame) {  \
+        const double value = (double)read(S(self->a));                                         \
+        if (!(value > (low) && value < (high))) {                                              \
+            return closure_fail(frame, FA_RUNTIME_ERR_TRAP);                                   \
+        }                                                                                      \
+        S(self->dst) = (uint64_t)(uint32_t)(type)value;                                        \
+        return self->next;                                                                     \
+    }
+
+CLOSURE_CONVERT(closure_i64_extend_i32_s, (uint64_t)(int64_t)(int32_t)(uint32_t)a)
+CLOSURE_CONVERT(closure_i64_extend_i32_u, (uint64_t)(uint32_t)a)
+CLOSURE_CONVERT(closure_i32_extend8_s, (uint64_t)(uint32_t)(int32_t)(int8_t)(uint8_t)a)
+CLOSURE_CONVERT(closure_i32_extend16_s, (uint64_t)(uint32_t)(int32_t)(int16_t)(uint16_t)a)
+CLOSURE_CONVERT(closure_i64_extend8_s, (uint64_t)(int64_t)(int8_t)(uint8_t)a)
+CLOSURE_CONVERT(closure_i64_extend16_s, (uint64_t)(int64_t)(int16_t)(uint16_t)a)
+CLOSURE_CONVERT(closure_i64_extend32_s, (uint64_t)(int64_t)(int32_t)(uint32_t)a)
+CLOSURE_CONVERT(closure_f32_demote_f64, closure_from_f32((float)closure_f64(a)))
+CLOSURE_CONVERT(closure_f64_promote_f32, closure_from_f64((double)closure_f32(a)))
+CLOSURE_TRUNCATE(closure_i32_trunc_f32_s, closure_f32, -2147483649.0, 2147483648.0, int32_t)
+CLOSURE_TRUNCATE(closure_i32_trunc_f32_u, closure_f32, -1.0, 4294967296.0, uint32_t)
+CLOSURE_TRUNCATE(closure_i32_trunc_f64_s, closure_f64, -2147483649.0, 2147483648.0, int32_t)
+CLOSURE_TRUNCATE(closure_i32_trunc_f64_u, closure_f64, -1.0, 4294967296.0, uint32_t)
+CLOSURE_CONVERT(closure_f32_convert_i32_s, closure_from_f32((float)(int32_t)(uint32_t)a))
+CLOSURE_CONVERT(closure_f32_convert_i32_u, closure_from_f32((float)(uint32_t)a))
+CLOSURE_CONVERT(closure_f32_convert_i64_s, closure_from_f32((float)(int64_t)a))
+CLOSURE_CONVERT(closure_f64_convert_i32_s, closure_from_f64((double)(int32_t)(uint32_t)a))
+CLOSURE_CONVERT(closure_f64_convert_i32_u, closure_from_f64((double)(uint32_t)a))
+CLOSURE_CONVERT(closure_f64_convert_i64_s, closure_from_f64((double)(int64_t)a))
+
+/* i64 targets: -2^63 itself is in range, so the lower bound is inclusive. */
+#define CLOSURE_TRUNCATE_I64(name, read)                                                       \
+    static const fa_JitClosure* name(const fa_JitClosure* self, fa_JitClosureFrame* frame) {  \
+        const double value = (double)read(S(self->a));                                         \
+        if (!(value >= -9223372036854775808.0 && value < 9223372036854775808.0)) {             \
+            return closure_fail(frame, FA_RUNTIME_ERR_TRAP);                                   \
+        }                                                                                      \
+        S(self->dst) = (uint64_t)(int64_t)value;                                               \
+        return self->next;                                                                     \
+    }
+
+CLOSURE_TRUNCATE_I64(closure_i64_trunc_f32_s, closure_f32)
+CLOSURE_TRUNCATE_I64(closure_i64_trunc_f64_s, closure_f64)
+
+/* ----- memory, globals, calls ----- */
+
+/* Host address of [a + imm, a + imm + bytes) in memory 0, NULL when out of
+   bounds. */
+static uint8_t* closure_address(const fa_JitClosure* self, const fa_JitClosureFrame* frame, uint32_t bytes) {
+    const fa_RuntimeMemory* memory = (const fa_RuntimeMemory*)frame->ctx->memory;
+    const uint64_t addr = (uint64_t)(uint32_t)S(self->a) + (uint64_t)(uint32_t)self->imm;
+    if (!memory || !memory->data || addr + bytes > memory->size_bytes) {
+        return NULL;
+    }
+    return memory->data + (size_t)addr;
+}
+
+#define CLOSURE_LOAD(name, type, expr)                                                         \
+    static const fa_JitClosure* name(const fa_JitClosure* self, fa_JitClosureFrame* frame) {  \
+        const uint8_t* at = closure_address(self, frame, (uint32_t)sizeof(type));              \
+        if (!at) {                                                                             \
+            return closure_fail(frame, FA_RUNTIME_ERR_TRAP);                                   \
+        }                                                                                      \
+        type v;                                                                                \
+        memcpy(&v, at, sizeof(v));                                                             \
+        S(self->dst) = (expr);                                                                 \
+        return self->next;                                                                     \
+    }
+
+#define CLOSURE_STORE(name, type)                                                              \
+    static const fa_JitClosure* name(const fa_JitClosure* self, fa_JitClosureFrame* frame) {  \
+        uint8_t* at = closure_address(self, frame, (uint32_t)sizeof(type));                    \
+        if (!at) {                                                                             \
+            return closure_fail(frame, FA_RUNTIME_ERR_TRAP);                                   \
+        }                                                                                      \
+        const type v = (type)S(self->b);                                                       \
+        memcpy(at, &v, sizeof(v));                                                             \
+        return self->next;                                                                     \
+    }
+
+CLOSURE_LOAD(closure_load_u32, uint32_t, (uint64_t)v)
+CLOSURE_LOAD(closure_load_u64, uint64_t, v)
+CLOSURE_LOAD(closure_load_i32_8s, int8_t, (uint64_t)(uint32_t)(int32_t)v)
+CLOSURE_LOAD(closure_load_u8, uint8_t, (uint64_t)v)
+CLOSURE_LOAD(closure_load_i32_16s, int16_t, (uint64_t)(uint32_t)(int32_t)v)
+CLOSURE_LOAD(closure_load_u16, uint16_t, (uint64_t)v)
+CLOSURE_LOAD(closure_load_i64_8s, int8_t, (uint64_t)(int64_t)v)
+CLOSURE_LOAD(closure_load_i64_16s, int16_t, (uint64_t)(int64_t)v)
+CLOSURE_LOAD(closure_load_i64_32s, int32_t, (uint64_t)(int64_t)v)
+CLOSURE_STORE(closure_store_8, uint8_t)
+CLOSURE_STORE(closure_store_16, uint16_t)
+CLOSURE_STORE(closure_store_32, uint32_t)
+CLOSURE_STORE(closure_store_64, uint64_t)
+
+static const fa_JitClosure* closure_memory_size(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    const fa_RuntimeMemory* memory = (const fa_RuntimeMemory*)frame->ctx->memory;
+    S(self->dst) = memory ? (uint32_t)(memory->size_bytes >> 16) : 0U;
+    return self->next;
+}
+
+static const fa_JitClosure* closure_memory_grow(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    const int64_t previous = frame->ctx->memory_grow(frame->ctx, (uint32_t)S(self->a));
+    S(self->dst) = (uint32_t)(int32_t)previous;
+    return self->next;
+}
+
+static const fa_JitClosure* closure_global_get_32(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    S(self->dst) = frame->ctx->globals[self->imm].payload.u32_value;
+    return self->next;
+}
+
+static const fa_JitClosure* closure_global_get_64(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    S(self->dst) = frame->ctx->globals[self->imm].payload.u64_value;
+    return self->next;
+}
+
+static const fa_JitClosure* closure_global_set_32(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    frame->ctx->globals[self->imm].payload.u32_value = (uint32_t)S(self->a);
+    return self->next;
+}
+
+static const fa_JitClosure* closure_global_set_64(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    frame->ctx->globals[self->imm].payload.u64_value = S(self->a);
+    return self->next;
+}
+
+/* Every call goes through call_slow, which checks traps, pins the callee and
+   runs it in whichever tier it has reached. */
+static const fa_JitClosure* closure_call(const fa_JitClosure* self, fa_JitClosureFrame* frame) {
+    const int status = frame->ctx->call_slow(frame->ctx, frame->slots + self->a, (uint32_t)self->imm);
+    if (status != FA_RUNTIME_OK) {
+        return closure_fail(frame, status);
+    }
+    return self->next;
+}
+
+#undef S
+
+/* ----- handler binding ----- */
+
+static const fa_JitClosureHandler kIntBinary32[] = {
+    closure_i32_add, closure_i32_sub, closure_i32_mul, closure_i32_and, closure_i32_or,
+    closure_i32_xor, closure_i32_shl, closure_i32_shr_s, closure_i32_shr_u, closure_i32_rotl,
+    closure_i32_rotr, closure_i32_div_s, closure_i32_div_u, closure_i32_rem_s, closure_i32_rem_u
+};
+static const fa_JitClosureHandler kIntBinary64[] = {
+    closure_i64_add, closure_i64_sub, closure_i64_mul, closure_i64_and, closure_i64_or,
+    closure_i64_xor, closure_i64_shl, closure_i64_shr_s, closure_i64_shr_u, closure_i64_rotl,
+    closure_i64_rotr, closure_i64_div_s, closure_i64_div_u, closure_i64_rem_s, closure_i64_rem_u
+};
+static const fa_JitClosureHandler kIntCompare32[] = {
+    closure_i32_eq, closure_i32_ne, closure_i32_lt_s, closure_i32_lt_u, closure_i32_gt_s,
+    closure_i32_gt_u, closure_i32_le_s, closure_i32_le_u, closure_i32_ge_s, closure_i32_ge_u
+};
+static const fa_JitClosureHandler kIntCompare64[] = {
+    closure_i64_eq, closure_i64_ne, closure_i64_lt_s, closure_i64_lt_u, closure_i64_gt_s,
+    closure_i64_gt_u, closure_i64_le_s, closure_i64_le_u, closure_i64_ge_s, closure_i64_ge_u
+};
+static const fa_JitClosureHandler kIntUnary32[] = { closure_i32_eqz, closure_i32_clz, closure_i32_ctz };
+static const fa_JitClosureHandler kIntUnary64[] = { closure_i64_eqz, closure_i64_clz, closure_i64_ctz };
+static const fa_JitClosureHandler kFloatBinary32[] = {
+    closure_f32_add, closure_f32_sub, closure_f32_mul, closure_f32_div, closure_f32_copysign
+};
+static const fa_JitClosureHandler kFloatBinary64[] = {
+    closure_f64_add, closure_f64_sub, closure_f64_mul, closure_f64_div, closure_f64_copysign
+};
+static const fa_JitClosureHandler kFloatUnary32[] = { closure_f32_abs, closure_f32_neg, closure_f32_sqrt };
+static const fa_JitClosureHandler kFloatUnary64[] = { closure_f64_abs, closure_f64_neg, closure_f64_sqrt };
+static const fa_JitClosureHandler kFloatCompare32[] = {
+    closure_f32_eq, closure_f32_ne, closure_f32_lt, closure_f32_gt, closure_f32_le, closure_f32_ge
+};
+static const fa_JitClosureHandler kFloatCompare64[] = {
+    closure_f64_eq, closure_f64_ne, closure_f64_lt, closure_f64_gt, closure_f64_le, closure_f64_ge
+};
+static const fa_JitClosureHandler kConvert[] = {
+    closure_i64_extend_i32_s, closure_i64_extend_i32_u, closure_i32_extend8_s, closure_i32_extend16_s,
+    closure_i64_extend8_s, closure_i64_extend16_s, closure_i64_extend32_s, closure_f32_demote_f64,
+    closure_f64_promote_f32, closure_i32_trunc_f32_s, closure_i32_trunc_f32_u, closure_i32_trunc_f64_s,
+    closure_i32_trunc_f64_u, closure_i64_trunc_f32_s, closure_i64_trunc_f64_s, closure_f32_convert_i32_s,
+    closure_f32_convert_i32_u, closure_f32_convert_i64_s, closure_f64_convert_i32_s, closure_f64_convert_i32_u,
+    closure_f64_convert_i64_s
+};
+/* fa_JitNativeIrLoad order. */
+static const fa_JitClosureHandler kLoad[] = {
+    closure_load_u32, closure_load_u64, closure_load_u32, closure_load_u64,
+    closure_load_i32_8s, closure_load_u8, closure_load_i32_16s, closure_load_u16,
+    closure_load_i64_8s, closure_load_u8, closure_load_i64_16s, closure_load_u16,
+    closure_load_i64_32s, closure_load_u32
+};
+
+static fa_JitClosureHandler closure_pick(const fa_JitClosureHandler* table, uint8_t count, uint8_t sub) {
+    return sub < count ? table[sub] : NULL;
+}
+
+/* Handler for one IR instruction; NULL for LABEL and anything unknown. */
+static fa_JitClosureHandler closure_bind(uint8_t op, uint8_t sub, bool wide) {
+    switch (op) {
+        case FA_NIR_JUMP: return closure_jump;
+        case FA_NIR_JUMP_IF_ZERO: return closure_jump_if_zero;
+        case FA_NIR_JUMP_IF_NE_IMM: return closure_jump_if_ne_imm;
+        case FA_NIR_TRAP: return closure_trap;
+        case FA_NIR_RETURN: return closure_return;
+        case FA_NIR_CONST: return closure_const;
+        case FA_NIR_MOVE: return closure_move;
+        case FA_NIR_IBIN:
+            return wide ? closure_pick(kIntBinary64, CLOSURE_COUNT(kIntBinary64), sub)
+                        : closure_pick(kIntBinary32, CLOSURE_COUNT(kIntBinary32), sub);
+        case FA_NIR_ICMP:
+            return wide ? closure_pick(kIntCompare64, CLOSURE_COUNT(kIntCompare64), sub)
+                        : closure_pick(kIntCompare32, CLOSURE_COUNT(kIntCompare32), sub);
+        case FA_NIR_IUNARY:
+            return wide ? closure_pick(kIntUnary64, CLOSURE_COUNT(kIntUnary64), sub)
+                        : closure_pick(kIntUnary32, CLOSURE_COUNT(kIntUnary32), sub);
+        case FA_NIR_FBIN:
+            return wide ? closure_pick(kFloatBinary64, CLOSURE_COUNT(kFloatBinary64), sub)
+                        : closure_pick(kFloatBinary32, CLOSURE_COUNT(kFloatBinary32), sub);
+        case FA_NIR_FUNARY:
+            return wide ? closure_pick(kFloatUnary64, CLOSURE_COUNT(kFloatUnary64), sub)
+                        : closure_pick(kFloatUnary32, CLOSURE_COUNT(kFloatUnary32), sub);
+        case FA_NIR_FCMP:
+            return wide ? closure_pick(kFloatCompare64, CLOSURE_COUNT(kFloatCompare64), sub)
+                        : closure_pick(kFloatCompare32, CLOSURE_COUNT(kFloatCompare32), sub);
+        case FA_NIR_CONVERT: return closure_pick(kConvert, CLOSURE_COUNT(kConvert), sub);
+        case FA_NIR_LOAD: return closure_pick(kLoad, CLOSURE_COUNT(kLoad), sub);
+        case FA_NIR_STORE:
+            switch (sub) {
+                case 1: return closure_store_8;
+                case 2: return closure_store_16;
+                case 4: return closure_store_32;
+                case 8: return closure_store_64;
+                default: return NULL;
+            }
+        case FA_NIR_MEMORY_SIZE: return closure_memory_size;
+        case FA_NIR_MEMORY_GROW: return closure_memory_grow;
+        case FA_NIR_GLOBAL_GET: return wide ? closure_global_get_64 : closure_global_get_32;
+        case FA_NIR_GLOBAL_SET: return wide ? closure_global_set_64 : closure_global_set_32;
+        case FA_NIR_SELECT: return closure_select;
+        case FA_NIR_CALL: return closure_call;
+        default: return NULL;
+    }
+}
+
+static bool closure_is_branch(uint8_t op) {
+    return op == FA_NIR_JUMP || op == FA_NIR_JUMP_IF_ZERO || op == FA_NIR_JUMP_IF_NE_IMM;
+}
+
+/* ----- lowering ----- */
+
+static fa_JitClosureProgram* closure_program_alloc(uint32_t count) {
+    fa_JitClosureProgram* program = (fa_JitClosureProgram*)calloc(1, sizeof(fa_JitClosureProgram));
+    if (!program) {
+        return NULL;
+    }
+    program->records = (fa_JitClosure*)calloc(count, sizeof(fa_JitClosure));
+    if (!program->records) {
+        free(program);
+        return NULL;
+    }
+    program->count = count;
+    return program;
+}
+
+/* Record reached when control arrives at `index`: unconditional jumps are
+   skipped (bounded, so a jump cycle keeps its own record). */
+static uint32_t closure_thread(const fa_JitClosure* records,
+                               const uint32_t* branch_to,
+                               uint32_t count,
+                               uint32_t index) {
+    uint32_t at = index;
+    for (uint32_t steps = 0; steps < count; ++steps) {
+        if (records[at].op != FA_NIR_JUMP) {
+            return at;
+        }
+        at = branch_to[at];
+    }
+    return index;
+}
+
+static fa_JitClosureProgram* closure_lower(const fa_JitNativeIr* ir) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < ir->count; ++i) {
+        count += ir->insns[i].op != FA_NIR_LABEL ? 1U : 0U;
+    }
+    if (count == 0) {
+        return NULL;
+    }
+    uint32_t* label_at = (uint32_t*)malloc((ir->label_count + 1U) * sizeof(uint32_t));
+    uint32_t* branch_to = (uint32_t*)malloc(count * sizeof(uint32_t));
+    fa_JitClosureProgram* program = closure_program_alloc(count);
+    bool ok = label_at && branch_to && program;
+    for (uint32_t i = 0; ok && i <= ir->label_count; ++i) {
+        label_at[i] = CLOSURE_NONE;
+    }
+    uint32_t at = 0;
+    for (uint32_t i = 0; ok && i < ir->count; ++i) {
+        const fa_JitNativeIrInsn* insn = &ir->insns[i];
+        if (insn->op == FA_NIR_LABEL) {
+            ok = insn->label < ir->label_count;
+            if (ok) {
+                label_at[insn->label] = at;
+            }
+            continue;
+        }
+        fa_JitClosure* record = &program->records[at];
+        record->handler = closure_bind(insn->op, insn->sub, insn->wide);
+        record->op = insn->op;
+        record->sub = insn->sub;
+        record->wide = insn->wide;
+        record->dst = insn->dst;
+        record->a = insn->a;
+        record->b = insn->b;
+        record->c = insn->c;
+        record->imm = insn->imm;
+        branch_to[at] = closure_is_branch(insn->op) && insn->label < ir->label_count ? insn->label : CLOSURE_NONE;
+        ok = record->handler != NULL && (!closure_is_branch(insn->op) || branch_to[at] != CLOSURE_NONE);
+        at++;
+    }
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        if (branch_to[i] != CLOSURE_NONE) {
+            branch_to[i] = label_at[branch_to[i]];
+            ok = branch_to[i] < count;
+        }
+    }
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        fa_JitClosure* record = &program->records[i];
+        record->next = i + 1U < count ? &program->records[closure_thread(program->records, branch_to, count, i + 1U)]
+                                      : NULL;
+        if (branch_to[i] != CLOSURE_NONE) {
+            record->target = &program->records[closure_thread(program->records, branch_to, count, branch_to[i])];
+        }
+    }
+    free(label_at);
+    free(branch_to);
+    if (!ok) {
+        fa_jit_closure_free(program);
+        return NULL;
+    }
+    program->param_count = ir->param_count;
+    program->local_count = ir->local_count;
+    program->result_count = ir->result_count;
+    program->frame_slots = ir->frame_slots;
+    program->osr_entry = ir->osr_entry;
+    program->osr_height = ir->osr_height;
+    return program;
+}
+
+bool fa_jit_closure_compile(const fa_JitNativeRequest* request, fa_JitClosureProgram** out) {
+    if (!out) {
+        return false;
+    }
+    *out = NULL;
+    fa_JitNativeIr ir;
+    if (!fa_jit_native_build_ir(request, &ir)) {
+        return false;
+    }
+    *out = closure_lower(&ir);
+    fa_jit_native_ir_free(&ir);
+    return *out != NULL;
+}
+
+void fa_jit_closure_free(fa_JitClosureProgram* program) {
+    if (!program) {
+        return;
+    }
+    free(program->records);
+    free(program);
+}
+
+size_t fa_jit_closure_estimate_bytes(const fa_JitClosureProgram* program) {
+    if (!program) {
+        return 0;
+    }
+    return sizeof(fa_JitClosureProgram) + (size_t)program->count * sizeof(fa_JitClosure);
+}
+
+int fa_jit_closure_run(const fa_JitClosureProgram* program, fa_JitNativeContext* ctx, uint64_t* slots) {
+    if (!program || !ctx || !slots) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    if (slots + program->frame_slots > ctx->slot_limit || ctx->depth >= ctx->max_depth) {
+        return FA_RUNTIME_ERR_CALL_DEPTH_EXCEEDED;
+    }
+    ctx->depth++;
+    if (!program->osr_entry && program->local_count > program->param_count) {
+        memset(slots + program->param_count, 0,
+               (size_t)(program->local_count - program->param_count) * sizeof(uint64_t));
+    }
+    fa_JitClosureFrame frame;
+    frame.ctx = ctx;
+    frame.slots = slots;
+    frame.status = FA_RUNTIME_OK;
+    const fa_JitClosure* pc = program->records;
+    while (pc) {
+        pc = pc->handler(pc, &frame);
+    }
+    ctx->depth--;
+    return frame.status;
+}
+
+/* ----- persistence ----- */
+
+static uint32_t closure_index_of(const fa_JitClosureProgram* program, const fa_JitClosure* record) {
+    return record ? (uint32_t)(record - program->records) : CLOSURE_NONE;
+}
+
+size_t fa_jit_closure_serialized_size(const fa_JitClosureProgram* program) {
+    if (!program || program->count == 0) {
+        return 0;
+    }
+    return (size_t)FA_SPILL_HEADER_BYTES + CLOSURE_SHAPE_BYTES + (size_t)program->count * CLOSURE_RECORD_BYTES;
+}
+
+bool fa_jit_closure_serialize(const fa_JitClosureProgram* program,
+                              uint8_t* out,
+                              size_t capacity,
+                              size_t* written_out) {
+    if (written_out) {
+        *written_out = 0;
+    }
+    const size_t needed = fa_jit_closure_serialized_size(program);
+    if (needed == 0 || !out || capacity < needed) {
+        return false;
+    }
+    if (fa_spill_write_header(out, capacity, (uint16_t)FA_SPILL_KIND_JIT_CLOSURES,
+                              (uint64_t)(needed - FA_SPILL_HEADER_BYTES)) != FA_SPILL_HEADER_BYTES) {
+        return false;
+    }
+    uint8_t* p = out + FA_SPILL_HEADER_BYTES;
+    fa_spill_put_u32(p + 0, program->count);
+    fa_spill_put_u32(p + 4, program->param_count);
+    fa_spill_put_u32(p + 8, program->local_count);
+    fa_spill_put_u32(p + 12, program->result_count);
+    fa_spill_put_u32(p + 16, program->frame_slots);
+    fa_spill_put_u32(p + 20, program->osr_height);
+    fa_spill_put_u32(p + 24, program->osr_entry ? 1U : 0U);
+    p += CLOSURE_SHAPE_BYTES;
+    for (uint32_t i = 0; i < program->count; ++i, p += CLOSURE_RECORD_BYTES) {
+        const fa_JitClosure* record = &program->records[i];
+        p[0] = record->op;
+        p[1] = record->sub;
+        p[2] = record->wide ? 1U : 0U;
+        p[3] = 0;
+        fa_spill_put_u32(p + 4, closure_index_of(program, record->next));
+        fa_spill_put_u32(p + 8, closure_index_of(program, record->target));
+        fa_spill_put_u32(p + 12, record->dst);
+        fa_spill_put_u32(p + 16, record->a);
+        fa_spill_put_u32(p + 20, record->b);
+        fa_spill_put_u32(p + 24, record->c);
+        fa_spill_put_u64(p + 28, record->imm);
+    }
+    if (written_out) {
+        *written_out = needed;
+    }
+    return true;
+}
+
+/* Unused operand fields are zero. */
+static bool closure_slot_ok(uint32_t slot, uint32_t frame_slots) {
+    return slot == 0U || slot < frame_slots;
+}
+
+bool fa_jit_closure_deserialize(const uint8_t* buffer, size_t size, fa_JitClosureProgram** out) {
+    if (!out) {
+        return false;
+    }
+    *out = NULL;
+    uint16_t kind = 0;
+    uint64_t payload = 0;
+    if (!fa_spill_read_header(buffer, size, &kind, &payload) || kind != (uint16_t)FA_SPILL_KIND_JIT_CLOSURES ||
+        payload < CLOSURE_SHAPE_BYTES) {
+        return false;
+    }
+    const uint8_t* p = buffer + FA_SPILL_HEADER_BYTES;
+    const uint32_t count = fa_spill_get_u32(p);
+    if (count == 0 || (payload - CLOSURE_SHAPE_BYTES) / CLOSURE_RECORD_BYTES != count ||
+        (payload - CLOSURE_SHAPE_BYTES) % CLOSURE_RECORD_BYTES != 0) {
+        return false;
+    }
+    fa_JitClosureProgram* program = closure_program_alloc(count);
+    if (!program) {
+        return false;
+    }
+    program->param_count = fa_spill_get_u32(p + 4);
+    program->local_count = fa_spill_get_u32(p + 8);
+    program->result_count = fa_spill_get_u32(p + 12);
+    program->frame_slots = fa_spill_get_u32(p + 16);
+    program->osr_height = fa_spill_get_u32(p + 20);
+    program->osr_entry = fa_spill_get_u32(p + 24) != 0U;
+    bool ok = program->param_count <= program->local_count && program->local_count <= program->frame_slots;
+    p += CLOSURE_SHAPE_BYTES;
+    for (uint32_t i = 0; ok && i < count; ++i, p += CLOSURE_RECORD_BYTES) {
+        fa_JitClosure* record = &program->records[i];
+        record->op = p[0];
+        record->sub = p[1];
+        record->wide = p[2] != 0U;
+        record->handler = closure_bind(record->op, record->sub, record->wide);
+        const uint32_t next = fa_spill_get_u32(p + 4);
+        const uint32_t target = fa_spill_get_u32(p + 8);
+        record->dst = fa_spill_get_u32(p + 12);
+        record->a = fa_spill_get_u32(p + 16);
+        record->b = fa_spill_get_u32(p + 20);
+        record->c = fa_spill_get_u32(p + 24);
+        record->imm = fa_spill_get_u64(p + 28);
+        record->next = next < count ? &program->records[next] : NULL;
+        record->target = target < count ? &program->records[target] : NULL;
+        /* Handlers index slots unchecked: every operand must lie in the frame
+           (a call's argument base may sit right above it). */
+        ok = record->handler != NULL && (next < count || next == CLOSURE_NONE) &&
+             (closure_is_branch(record->op) ? target < count : target == CLOSURE_NONE) &&
+             closure_slot_ok(record->dst, program->frame_slots) && closure_slot_ok(record->b, program->frame_slots) &&
+             closure_slot_ok(record->c, program->frame_slots) &&
+             (record->op == FA_NIR_CALL ? record->a <= program->frame_slots
+                                        : closure_slot_ok(record->a, program->frame_slots));
+    }
+    if (!ok) {
+        fa_jit_closure_free(program);
+        return false;
+    }
+    *out = program;
+    return true;
+}
+
+bool fa_jit_closure_globals_valid(const fa_JitClosureProgram* program, const WasmModule* module) {
+    if (!program || !module) {
+        return false;
+    }
+    for (uint32_t i = 0; i < program->count; ++i) {
+        const fa_JitClosure* record = &program->records[i];
+        if (record->op != FA_NIR_GLOBAL_GET && record->op != FA_NIR_GLOBAL_SET) {
+            continue;
+        }
+        if (record->imm >= module->num_globals || !module->globals) {
+            return false;
+        }
+        const WasmGlobal* global = &module->globals[record->imm];
+        const bool wide = global->valtype == VALTYPE_I64 || global->valtype == VALTYPE_F64;
+        if (record->wide != wide || (record->op == FA_NIR_GLOBAL_SET && !global->is_mutable)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "fa_jit.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------- *
+ * Closure tier (FA_JIT_TIER_CLOSURE).
+ *
+ * A portable compiled tier for targets without a native backend. The body
+ * goes through the same frontend as the native tier (fa_jit_native_ir.h) and
+ * each IR instruction becomes one pre-bound closure record: a handler
+ * specialised for the operation and operand width, its decoded slot operands
+ * and immediate, and direct pointers to its successors. Labels disappear,
+ * unconditional jumps are threaded into their predecessors' successor
+ * pointers, so a basic block is a contiguous run of records that a
+ * `while (pc) pc = pc->handler(pc, frame)` trampoline walks without decoding
+ * anything. Frames, slots, calls and traps follow the native calling
+ * convention, so the runtime enters records exactly like native code.
+ *
+ * Records persist through the spill envelope (FA_SPILL_KIND_JIT_CLOSURES):
+ * handlers are stored as their (op, sub, wide) IR triple and successors as
+ * record indices, and both are rebound on load.
+ * ------------------------------------------------------------------------- */
+
+typedef struct fa_JitClosure fa_JitClosure;
+
+typedef struct {
+    fa_JitNativeContext* ctx;
+    uint64_t* slots;
+    int status; /* FA_RUNTIME_* once a handler returns NULL */
+} fa_JitClosureFrame;
+
+/* Runs one record and returns the next one, or NULL to leave the function. */
+typedef const fa_JitClosure* (*fa_JitClosureHandler)(const fa_JitClosure* self, fa_JitClosureFrame* frame);
+
+struct fa_JitClosure {
+    fa_JitClosureHandler handler;
+    const fa_JitClosure* next;   /* fall-through successor */
+    const fa_JitClosure* target; /* branch successor */
+    uint32_t dst;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint64_t imm;
+    uint8_t op;  /* fa_JitNativeIrOp, with sub and wide naming the handler */
+    uint8_t sub;
+    bool wide;
+};
+
+typedef struct fa_JitClosureProgram {
+    fa_JitClosure* records; /* records[0] is the entry */
+    uint32_t count;
+    uint32_t param_count;
+    uint32_t local_count;
+    uint32_t result_count;
+    uint32_t frame_slots;
+    bool osr_entry;
+    uint32_t osr_height; /* OSR entries: live slots at the loop header */
+} fa_JitClosureProgram;
+
+/* Builds the closure program for `request`. Returns false, leaving `*out`
+   NULL, when the body is outside the frontend's subset. */
+bool fa_jit_closure_compile(const fa_JitNativeRequest* request, fa_JitClosureProgram** out);
+void fa_jit_closure_free(fa_JitClosureProgram* program);
+size_t fa_jit_closure_estimate_bytes(const fa_JitClosureProgram* program);
+/* Same contract as a fa_JitNativeEntry: arguments in slots[0..params),
+   results in slots[0..results), FA_RUNTIME_* status. */
+int fa_jit_closure_run(const fa_JitClosureProgram* program, fa_JitNativeContext* ctx, uint64_t* slots);
+
+/* Spill blob: the shared envelope followed by the program shape and the
+   records with handler triples and successor indices. */
+size_t fa_jit_closure_serialized_size(const fa_JitClosureProgram* program);
+bool fa_jit_closure_serialize(const fa_JitClosureProgram* program,
+                              uint8_t* out,
+                              size_t capacity,
+                              size_t* written_out);
+bool fa_jit_closure_deserialize(const uint8_t* buffer, size_t size, fa_JitClosureProgram** out);
+/* Global records index the context's globals unchecked, and a blob only
+   knows the module it came from by key: every global.get/global.set must name
+   a global of `module` with the recorded width (and be mutable for a set).
+   The runtime checks this before adopting records from a hook or the disk. */
+bool fa_jit_closure_globals_valid(const fa_JitClosureProgram* program, const WasmModule* module);
@@ -0,0 +1,243 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "fa_jit_code_cache.h"
+#include "fa_jit.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(FA_JIT_NATIVE_HOST)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+bool fa_jit_code_cache_supported(void) {
+#if defined(FA_JIT_NATIVE_HOST)
+    return true;
+#else
+    return false;
+#endif
+}
+
+static size_t code_cache_page_bytes(void) {
+#if defined(FA_JIT_NATIVE_HOST)
+    const long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (size_t)page : 4096U;
+#else
+    return 4096U;
+#endif
+}
+
+static size_t code_cache_round_up(size_t value, size_t align) {
+    return (value + align - 1U) / align * align;
+}
+
+void fa_jit_code_cache_init(fa_JitCodeCache* cache, size_t slab_bytes) {
+    if (!cache) {
+        return;
+    }
+    memset(cache, 0, sizeof(*cache));
+    if (slab_bytes == 0) {
+        slab_bytes = FA_JIT_CODE_SLAB_BYTES;
+    }
+    cache->slab_bytes = code_cache_round_up(slab_bytes, code_cache_page_bytes());
+}
+
+static void code_cache_unmap(fa_JitCodeSlab* slab) {
+#if defined(FA_JIT_NATIVE_HOST)
+    if (slab->base) {
+        munmap(slab->base, slab->bytes);
+    }
+#endif
+    free(slab->free);
+    memset(slab, 0, sizeof(*slab));
+}
+
+void fa_jit_code_cache_destroy(fa_JitCodeCache* cache) {
+    if (!cache) {
+        return;
+    }
+    for (uint32_t i = 0; i < cache->slab_count; ++i) {
+        code_cache_unmap(&cache->slabs[i]);
+    }
+    free(cache->slabs);
+    const size_t slab_bytes = cache->slab_bytes;
+    memset(cache, 0, sizeof(*cache));
+    cache->slab_bytes = slab_bytes;
+}
+
+static bool code_cache_extent_insert(fa_JitCodeSlab* slab, uint32_t at, size_t offset, size_t bytes) {
+    if (slab->free_count == slab->free_capacity) {
+        const uint32_t capacity = slab->free_capacity ? slab->free_capacity * 2U : 8U;
+        fa_JitCodeExtent* grown = (fa_JitCodeExtent*)realloc(slab->free, capacity * sizeof(fa_JitCodeExtent));
+        if (!grown) {
+            return false;
+        }
+        slab->free = grown;
+        slab->free_capacity = capacity;
+    }
+    memmove(&slab->free[at + 1U], &slab->free[at], (slab->free_count - at) * sizeof(fa_JitCodeExtent));
+    slab->free[at].offset = offset;
+    slab->free[at].bytes = bytes;
+    slab->free_count++;
+    return true;
+}
+
+static void code_cache_extent_remove(fa_JitCodeSlab* slab, uint32_t at) {
+    memmove(&slab->free[at], &slab->free[at + 1U], (slab->free_count - at - 1U) * sizeof(fa_JitCodeExtent));
+    slab->free_count--;
+}
+
+static fa_JitCodeSlab* code_cache_add_slab(fa_JitCodeCache* cache, size_t min_bytes) {
+#if defined(FA_JIT_NATIVE_HOST)
+    if (cache->slab_count == cache->slab_capacity) {
+        const uint32_t capacity = cache->slab_capacity ? cache->slab_capacity * 2U : 4U;
+        fa_JitCodeSlab* grown = (fa_JitCodeSlab*)realloc(cache->slabs, capacity * sizeof(fa_JitCodeSlab));
+        if (!grown) {
+            return NULL;
+        }
+        cache->slabs = grown;
+        cache->slab_capacity = capacity;
+    }
+    size_t bytes = cache->slab_bytes;
+    if (min_bytes > bytes) {
+        bytes = code_cache_round_up(min_bytes, code_cache_page_bytes());
+    }
+    void* map = mmap(NULL, bytes, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+    fa_JitCodeSlab* slab = &cache->slabs[cache->slab_count];
+    memset(slab, 0, sizeof(*slab));
+    slab->base = (uint8_t*)map;
+    slab->bytes = bytes;
+    if (!code_cache_extent_insert(slab, 0, 0, bytes)) {
+        munmap(map, bytes);
+        memset(slab, 0, sizeof(*slab));
+        return NULL;
+    }
+    cache->slab_count++;
+    cache->mapped_bytes += bytes;
+    return slab;
+#else
+    (void)cache;
+    (void)min_bytes;
+    return NULL;
+#endif
+}
+
+/* Copies `code` into [block, block + size) with the covering pages briefly
+   writable. The pages are never writable and executable at once. */
+static bool code_cache_write(uint8_t* block, const uint8_t* code, size_t size) {
+#if defined(FA_JIT_NATIVE_HOST)
+    const size_t page = code_cache_page_bytes();
+    uint8_t* first = (uint8_t*)((uintptr_t)block & ~(uintptr_t)(page - 1U));
+    const size_t span = code_cache_round_up((size_t)(block + size - first), page);
+    if (mprotect(first, span, PROT_READ | PROT_WRITE) != 0) {
+        return false;
+    }
+    memcpy(block, code, size);
+    if (mprotect(first, span, PROT_READ | PROT_EXEC) != 0) {
+        return false;
+    }
+#if defined(FA_JIT_NATIVE_AARCH64)
+    /* AArch64 instruction fetch is not coherent with data writes. */
+    __builtin___clear_cache((char*)block, (char*)block + size);
+#endif
+    return true;
+#else
+    (void)block;
+    (void)code;
+    (void)size;
+    return false;
+#endif
+}
+
+void* fa_jit_code_cache_install(fa_JitCodeCache* cache, const uint8_t* code, size_t size, size_t* block_bytes_out) {
+    if (block_bytes_out) {
+        *block_bytes_out = 0;
+    }
+    if (!cache || !code || size == 0 || cache->slab_bytes == 0) {
+        return NULL;
+    }
+    const size_t bytes = code_cache_round_up(size, FA_JIT_CODE_ALIGN);
+    fa_JitCodeSlab* slab = NULL;
+    uint32_t at = 0;
+    for (uint32_t s = 0; s < cache->slab_count && !slab; ++s) {
+        fa_JitCodeSlab* candidate = &cache->slabs[s];
+        for (uint32_t i = 0; i < candidate->free_count; ++i) {
+            if (candidate->free[i].bytes >= bytes) {
+                slab = candidate;
+                at = i;
+                break;
+            }
+        }
+    }
+    if (!slab) {
+        slab = code_cache_add_slab(cache, bytes);
+        if (!slab) {
+            return NULL;
+        }
+        at = 0;
+    }
+    fa_JitCodeExtent* extent = &slab->free[at];
+    uint8_t* block = slab->base + extent->offset;
+    if (!code_cache_write(block, code, size)) {
+        return NULL;
+    }
+    extent->offset += bytes;
+    extent->bytes -= bytes;
+    if (extent->bytes == 0) {
+        code_cache_extent_remove(slab, at);
+    }
+    slab->live_bytes += bytes;
+    cache->live_bytes += bytes;
+    cache->installs++;
+    if (block_bytes_out) {
+        *block_bytes_out = bytes;
+    }
+    return block;
+}
+
+void fa_jit_code_cache_release(fa_JitCodeCache* cache, void* block, size_t block_bytes) {
+    if (!cache || !block || block_bytes == 0) {
+        return;
+    }
+    uint8_t* at_ptr = (uint8_t*)block;
+    for (uint32_t s = 0; s < cache->slab_count; ++s) {
+        fa_JitCodeSlab* slab = &cache->slabs[s];
+        if (at_ptr < slab->base || at_ptr + block_bytes > slab->base + slab->bytes) {
+            continue;
+        }
+        const size_t offset = (size_t)(at_ptr - slab->base);
+        uint32_t at = 0;
+        while (at < slab->free_count && slab->free[at].offset < offset) {
+            ++at;
+        }
+        const bool joins_prev = at > 0 && slab->free[at - 1U].offset + slab->free[at - 1U].bytes == offset;
+        const bool joins_next = at < slab->free_count && offset + block_bytes == slab->free[at].offset;
+        if (joins_prev && joins_next) {
+            slab->free[at - 1U].bytes += block_bytes + slab->free[at].bytes;
+            code_cache_extent_remove(slab, at);
+        } else if (joins_prev) {
+            slab->free[at - 1U].bytes += block_bytes;
+        } else if (joins_next) {
+            slab->free[at].offset = offset;
+            slab->free[at].bytes += block_bytes;
+        } else if (!code_cache_extent_insert(slab, at, offset, block_bytes)) {
+            return; /* leaks the block's space until the cache is destroyed */
+        }
+        slab->live_bytes -= block_bytes;
+        cache->live_bytes -= block_bytes;
+        cache->releases++;
+        if (slab->live_bytes == 0) {
+            cache->mapped_bytes -= slab->bytes;
+            code_cache_unmap(slab);
+            cache->slabs[s] = cache->slabs[cache->slab_count - 1U];
+            cache->slab_count--;
+        }
+        return;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------- *
+ * Executable code cache for the native tier.
+ *
+ * Code lives in mmap'd slabs carved into FA_JIT_CODE_ALIGN-aligned blocks
+ * (first fit, free extents coalesced on release), so small functions share
+ * pages instead of each taking a whole mapping. Slab pages stay read+execute;
+ * installing a block flips only the pages it touches to read+write for the
+ * copy and back (W^X), then flushes the instruction cache where the target
+ * needs it. Code larger than a slab gets a dedicated slab, and slabs are
+ * unmapped once their last block is released. The cache does no budgeting:
+ * callers charge `block_bytes` against their own limit.
+ * ------------------------------------------------------------------------- */
+#ifndef FA_JIT_CODE_SLAB_BYTES
+#define FA_JIT_CODE_SLAB_BYTES (64U * 1024U)
+#endif
+
+#define FA_JIT_CODE_ALIGN 16U
+
+typedef struct {
+    size_t offset;
+    size_t bytes;
+} fa_JitCodeExtent;
+
+typedef struct {
+    uint8_t* base;
+    size_t bytes;
+    size_t live_bytes;
+    fa_JitCodeExtent* free; /* sorted by offset, never adjacent */
+    uint32_t free_count;
+    uint32_t free_capacity;
+} fa_JitCodeSlab;
+
+typedef struct fa_JitCodeCache {
+    fa_JitCodeSlab* slabs;
+    uint32_t slab_count;
+    uint32_t slab_capacity;
+    size_t slab_bytes;
+    size_t live_bytes;   /* sum of installed block sizes */
+    size_t mapped_bytes; /* sum of slab sizes */
+    uint64_t installs;
+    uint64_t releases;
+} fa_JitCodeCache;
+
+bool fa_jit_code_cache_supported(void);
+/* `slab_bytes` of 0 selects FA_JIT_CODE_SLAB_BYTES; it is rounded up to pages. */
+void fa_jit_code_cache_init(fa_JitCodeCache* cache, size_t slab_bytes);
+/* Unmaps every slab; blocks still handed out become invalid. */
+void fa_jit_code_cache_destroy(fa_JitCodeCache* cache);
+/* Copies `size` bytes of machine code into an executable block. Returns the
+   block (NULL on failure) and its charged size in `block_bytes_out`. */
+void* fa_jit_code_cache_install(fa_JitCodeCache* cache, const uint8_t* code, size_t size, size_t* block_bytes_out);
+void fa_jit_code_cache_release(fa_JitCodeCache* cache, void* block, size_t block_bytes);
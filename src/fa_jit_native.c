@@ -0,0 +1,1143 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "fa_jit_code_cache.h"
+#include "fa_jit_native_ir.h"
+#include "fa_runtime.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(FA_JIT_NATIVE_HOST)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/* ------------------------------------------------------------------------- *
+ * Native tier frontend.
+ *
+ * Decodes and validates a function body once, producing the slot IR from
+ * fa_jit_native_ir.h: every operand-stack position has a fixed slot known at
+ * compile time, so each opcode becomes one or two IR instructions over slot
+ * indices, and branches to a block copy their results down to the block's
+ * base height before jumping, mirroring the interpreter's control frames.
+ * The per-architecture backends (fa_jit_native_x64.c, fa_jit_native_a64.c)
+ * turn the IR into machine code; this file also owns the code buffer shared
+ * by both and installs the result into the executable code cache
+ * (fa_jit_code_cache.c) or a private W^X mapping.
+ * ------------------------------------------------------------------------- */
+
+#define NATIVE_MAX_LOCALS 4096U
+#define NATIVE_MAX_SLOTS 65536U
+#define NATIVE_MAX_CONTROL 1024U
+
+bool fa_jit_native_supported(void) {
+#if defined(FA_JIT_NATIVE_HOST)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void fa_jit_native_free(fa_JitNativeCode* code) {
+    if (!code) {
+        return;
+    }
+    if (code->map && code->cache) {
+        fa_jit_code_cache_release(code->cache, code->map, code->map_bytes);
+    }
+#if defined(FA_JIT_NATIVE_HOST)
+    else if (code->map) {
+        munmap(code->map, code->map_bytes);
+    }
+#endif
+    memset(code, 0, sizeof(*code));
+}
+
+/* ----- code buffer ----- */
+
+void fa_jit_native_buffer_free(fa_JitNativeBuffer* buffer) {
+    if (!buffer) {
+        return;
+    }
+    free(buffer->bytes);
+    free(buffer->labels);
+    free(buffer->fixups);
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+void fa_jit_native_buffer_u8(fa_JitNativeBuffer* buffer, uint8_t value) {
+    if (buffer->failed) {
+        return;
+    }
+    if (buffer->len == buffer->cap) {
+        size_t next = buffer->cap ? buffer->cap * 2U : 1024U;
+        uint8_t* grown = (uint8_t*)realloc(buffer->bytes, next);
+        if (!grown) {
+            buffer->failed = true;
+            return;
+        }
+        buffer->bytes = grown;
+        buffer->cap = next;
+    }
+    buffer->bytes[buffer->len++] = value;
+}
+
+void fa_jit_native_buffer_u32(fa_JitNativeBuffer* buffer, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        fa_jit_native_buffer_u8(buffer, (uint8_t)(value >> (8 * i)));
+    }
+}
+
+uint32_t fa_jit_native_buffer_label(fa_JitNativeBuffer* buffer) {
+    if (buffer->label_count == buffer->label_cap) {
+        uint32_t next = buffer->label_cap ? buffer->label_cap * 2U : 64U;
+        size_t* grown = (size_t*)realloc(buffer->labels, next * sizeof(size_t));
+        if (!grown) {
+            buffer->failed = true;
+            return 0;
+        }
+        buffer->labels = grown;
+        buffer->label_cap = next;
+    }
+    buffer->labels[buffer->label_count] = 0;
+    return buffer->label_count++;
+}
+
+void fa_jit_native_buffer_bind(fa_JitNativeBuffer* buffer, uint32_t label) {
+    if (!buffer->failed && label < buffer->label_count) {
+        buffer->labels[label] = buffer->len + 1U;
+    }
+}
+
+void fa_jit_native_buffer_fixup(fa_JitNativeBuffer* buffer, uint32_t label, uint8_t kind) {
+    if (buffer->failed) {
+        return;
+    }
+    if (buffer->fixup_count == buffer->fixup_cap) {
+        uint32_t next = buffer->fixup_cap ? buffer->fixup_cap * 2U : 64U;
+        fa_JitNativeFixup* grown = (fa_JitNativeFixup*)realloc(buffer->fixups, next * sizeof(fa_JitNativeFixup));
+        if (!grown) {
+            buffer->failed = true;
+            return;
+        }
+        buffer->fixups = grown;
+        buffer->fixup_cap = next;
+    }
+    fa_JitNativeFixup* fixup = &buffer->fixups[buffer->fixup_count++];
+    fixup->at = buffer->len;
+    fixup->label = label;
+    fixup->kind = kind;
+}
+
+size_t fa_jit_native_buffer_label_offset(const fa_JitNativeBuffer* buffer, uint32_t label) {
+    if (label >= buffer->label_count || buffer->labels[label] == 0) {
+        return SIZE_MAX;
+    }
+    return buffer->labels[label] - 1U;
+}
+
+/* ----- IR construction ----- */
+
+typedef enum {
+    NATIVE_CTRL_FUNC = 0,
+    NATIVE_CTRL_BLOCK,
+    NATIVE_CTRL_LOOP,
+    NATIVE_CTRL_IF
+} NativeCtrlKind;
+
+typedef struct {
+    NativeCtrlKind kind;
+    uint32_t label;      /* branch target: loop head or block end */
+    uint32_t else_label; /* IF: taken when the condition is zero */
+    uint32_t height;     /* slot index of the block's first parameter */
+    uint32_t params;
+    uint32_t results;
+    bool has_else;
+} NativeCtrl;
+
+typedef struct {
+    const fa_JitNativeRequest* request;
+    const uint8_t* code;
+    uint32_t size;
+    uint32_t pos;
+
+    fa_JitNativeIr* ir;
+    bool failed;
+    fa_JitNativeIrInsn scratch; /* target of emits after an allocation failure */
+
+    NativeCtrl ctrl[NATIVE_MAX_CONTROL];
+    uint32_t ctrl_depth;
+    uint32_t sp;
+    uint32_t max_sp;
+    uint32_t local_count;
+    uint32_t param_count;
+    uint32_t result_count;
+    bool dead;
+    uint32_t dead_nesting;
+    uint32_t osr_label;
+    bool osr_bound;
+} NativeCompiler;
+
+void fa_jit_native_ir_free(fa_JitNativeIr* ir) {
+    if (!ir) {
+        return;
+    }
+    free(ir->insns);
+    memset(ir, 0, sizeof(*ir));
+}
+
+static fa_JitNativeIrInsn* ir_emit(NativeCompiler* c, uint8_t op, uint8_t sub, bool wide) {
+    fa_JitNativeIr* ir = c->ir;
+    if (!c->failed && ir->count == ir->capacity) {
+        uint32_t next = ir->capacity ? ir->capacity * 2U : 256U;
+        fa_JitNativeIrInsn* grown = (fa_JitNativeIrInsn*)realloc(ir->insns, next * sizeof(fa_JitNativeIrInsn));
+        if (!grown) {
+            c->failed = true;
+        } else {
+            ir->insns = grown;
+            ir->capacity = next;
+        }
+    }
+    fa_JitNativeIrInsn* insn = c->failed ? &c->scratch : &ir->insns[ir->count++];
+    memset(insn, 0, sizeof(*insn));
+    insn->op = op;
+    insn->sub = sub;
+    insn->wide = wide;
+    return insn;
+}
+
+static uint32_t ir_label(NativeCompiler* c) {
+    return c->ir->label_count++;
+}
+
+static void ir_bind(NativeCompiler* c, uint32_t label) {
+    ir_emit(c, FA_NIR_LABEL, 0, false)->label = label;
+}
+
+static void ir_jump(NativeCompiler* c, uint32_t label) {
+    ir_emit(c, FA_NIR_JUMP, 0, false)->label = label;
+}
+
+static void ir_jump_if_zero(NativeCompiler* c, uint32_t slot, uint32_t label) {
+    fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_JUMP_IF_ZERO, 0, false);
+    insn->a = slot;
+    insn->label = label;
+}
+
+static void ir_unary(NativeCompiler* c, uint8_t op, uint8_t sub, bool wide, uint32_t slot) {
+    fa_JitNativeIrInsn* insn = ir_emit(c, op, sub, wide);
+    insn->dst = slot;
+    insn->a = slot;
+}
+
+/* a <op> b over the top two slots; the result replaces a. */
+static void ir_binary(NativeCompiler* c, uint8_t op, uint8_t sub, bool wide) {
+    fa_JitNativeIrInsn* insn = ir_emit(c, op, sub, wide);
+    insn->dst = c->sp - 2U;
+    insn->a = c->sp - 2U;
+    insn->b = c->sp - 1U;
+    c->sp--;
+}
+
+static void move_values(NativeCompiler* c, uint32_t from, uint32_t to, uint32_t count) {
+    if (from == to) {
+        return;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_MOVE, 0, true);
+        insn->dst = to + i;
+        insn->a = from + i;
+    }
+}
+
+/* ----- body reader ----- */
+
+static bool rd_u8(NativeCompiler* c, uint8_t* out) {
+    if (c->pos >= c->size) {
+        return false;
+    }
+    *out = c->code[c->pos++];
+    return true;
+}
+
+static bool rd_uleb(NativeCompiler* c, uint64_t* out, uint32_t max_bits) {
+    uint64_t result = 0;
+    uint32_t shift = 0;
+    uint8_t byte = 0;
+    do {
+        if (shift >= max_bits || !rd_u8(c, &byte)) {
+            return false;
+        }
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    *out = result;
+    return true;
+}
+
+static bool rd_u32(NativeCompiler* c, uint32_t* out) {
+    uint64_t value = 0;
+    if (!rd_uleb(c, &value, 35) || value > UINT32_MAX) {
+        return false;
+    }
+    *out = (uint32_t)value;
+    return true;
+}
+
+static bool rd_sleb(NativeCompiler* c, int64_t* out, uint32_t max_bits) {
+    int64_t result = 0;
+    uint32_t shift = 0;
+    uint8_t byte = 0;
+    do {
+        if (shift >= max_bits || !rd_u8(c, &byte)) {
+            return false;
+        }
+        result |= (int64_t)((uint64_t)(byte & 0x7F) << shift);
+        shift += 7;
+    } while (byte & 0x80);
+    if (shift < 64 && (byte & 0x40)) {
+        result |= (int64_t)(~(uint64_t)0 << shift);
+    }
+    *out = result;
+    return true;
+}
+
+static bool rd_block_type(NativeCompiler* c, uint32_t* params, uint32_t* results) {
+    if (c->pos >= c->size) {
+        return false;
+    }
+    const uint8_t byte = c->code[c->pos];
+    if (byte == 0x40) {
+        c->pos++;
+        *params = 0;
+        *results = 0;
+        return true;
+    }
+    if (byte == VALTYPE_I32 || byte == VALTYPE_I64 || byte == VALTYPE_F32 || byte == VALTYPE_F64) {
+        c->pos++;
+        *params = 0;
+        *results = 1;
+        return true;
+    }
+    int64_t type_index = 0;
+    const WasmModule* module = c->request->module;
+    if (!rd_sleb(c, &type_index, 35) || type_index < 0 || (uint64_t)type_index >= module->num_types) {
+        return false;
+    }
+    *params = module->types[type_index].num_params;
+    *results = module->types[type_index].num_results;
+    return true;
+}
+
+/* memarg: alignment hint (multi-memory bit rejected) + 32-bit offset. */
+static bool rd_memarg(NativeCompiler* c, uint32_t* offset) {
+    uint32_t align = 0;
+    if (!rd_u32(c, &align) || (align & 0x40U) != 0) {
+        return false;
+    }
+    return rd_u32(c, offset);
+}
+
+static bool numeric_valtype(uint32_t valtype) {
+    return valtype == VALTYPE_I32 || valtype == VALTYPE_I64 || valtype == VALTYPE_F32 || valtype == VALTYPE_F64;
+}
+
+/* ----- stack helpers ----- */
+
+static bool need(NativeCompiler* c, uint32_t count) {
+    const uint32_t height = c->ctrl_depth > 0 ? c->ctrl[c->ctrl_depth - 1U].height : 0U;
+    return c->sp >= height + count;
+}
+
+static bool push_slot(NativeCompiler* c, uint32_t* slot) {
+    if (c->sp + 1U >= NATIVE_MAX_SLOTS) {
+        return false;
+    }
+    *slot = c->sp++;
+    if (c->sp > c->max_sp) {
+        c->max_sp = c->sp;
+    }
+    return true;
+}
+
+static uint32_t branch_arity(const NativeCtrl* target) {
+    return target->kind == NATIVE_CTRL_LOOP ? target->params : target->results;
+}
+
+/* Moves the branch values into place and jumps to `depth`'s target. */
+static bool emit_branch(NativeCompiler* c, uint32_t depth) {
+    if (depth >= c->ctrl_depth) {
+        return false;
+    }
+    const NativeCtrl* target = &c->ctrl[c->ctrl_depth - 1U - depth];
+    const uint32_t arity = branch_arity(target);
+    if (c->sp < arity) {
+        return false;
+    }
+    move_values(c, c->sp - arity, target->height, arity);
+    ir_jump(c, target->label);
+    return true;
+}
+
+static bool push_ctrl(NativeCompiler* c, NativeCtrlKind kind, uint32_t params, uint32_t results) {
+    if (c->ctrl_depth >= NATIVE_MAX_CONTROL || !need(c, params)) {
+        return false;
+    }
+    NativeCtrl* ctrl = &c->ctrl[c->ctrl_depth++];
+    memset(ctrl, 0, sizeof(*ctrl));
+    ctrl->kind = kind;
+    ctrl->label = ir_label(c);
+    ctrl->height = c->sp - params;
+    ctrl->params = params;
+    ctrl->results = results;
+    return true;
+}
+
+/* ----- operator lowering ----- */
+
+static bool emit_load(NativeCompiler* c, uint8_t opcode) {
+    uint32_t offset = 0;
+    if (!c->request->memory_flat || !rd_memarg(c, &offset) || !need(c, 1)) {
+        return false;
+    }
+    fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_LOAD, (uint8_t)(opcode - 0x28), false);
+    insn->dst = c->sp - 1U;
+    insn->a = c->sp - 1U;
+    insn->imm = offset;
+    return true;
+}
+
+static bool emit_store(NativeCompiler* c, uint8_t opcode) {
+    uint32_t offset = 0;
+    if (!c->request->memory_flat || !rd_memarg(c, &offset) || !need(c, 2)) {
+        return false;
+    }
+    static const uint8_t kBytes[] = { 4, 8, 4, 8, 1, 2, 1, 2, 4 };
+    fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_STORE, kBytes[opcode - 0x36], false);
+    insn->a = c->sp - 2U;
+    insn->b = c->sp - 1U;
+    insn->imm = offset;
+    c->sp -= 2U;
+    return true;
+}
+
+static bool emit_call(NativeCompiler* c, uint32_t function_index) {
+    const WasmModule* module = c->request->module;
+    if (function_index >= module->num_functions ||
+        module->functions[function_index].type_index >= module->num_types) {
+        return false;
+    }
+    const WasmFunctionType* type = &module->types[module->functions[function_index].type_index];
+    for (uint32_t i = 0; i < type->num_params; ++i) {
+        if (!numeric_valtype(type->param_types[i])) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < type->num_results; ++i) {
+        if (!numeric_valtype(type->result_types[i])) {
+            return false;
+        }
+    }
+    if (!need(c, type->num_params)) {
+        return false;
+    }
+    const uint32_t base = c->sp - type->num_params;
+    if (base + type->num_results >= NATIVE_MAX_SLOTS) {
+        return false;
+    }
+    fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_CALL, 0, false);
+    insn->a = base;
+    insn->imm = function_index;
+    c->sp = base + type->num_results;
+    if (c->sp > c->max_sp) {
+        c->max_sp = c->sp;
+    }
+    return true;
+}
+
+static bool global_valtype(NativeCompiler* c, uint32_t index, uint8_t* valtype, bool* is_mutable) {
+    const WasmModule* module = c->request->module;
+    if (!module->globals || index >= module->num_globals || !numeric_valtype(module->globals[index].valtype)) {
+        return false;
+    }
+    *valtype = module->globals[index].valtype;
+    *is_mutable = module->globals[index].is_mutable;
+    return true;
+}
+
+/* ----- skipping unreachable code ----- */
+
+static bool skip_immediates(NativeCompiler* c, uint8_t opcode) {
+    uint32_t u = 0;
+    int64_t s = 0;
+    switch (opcode) {
+        case 0x02: case 0x03: case 0x04: {
+            uint32_t params = 0;
+            uint32_t results = 0;
+            return rd_block_type(c, &params, &results);
+        }
+        case 0x0C: case 0x0D: case 0x10: case 0x20: case 0x21: case 0x22: case 0x23: case 0x24:
+        case 0x3F: case 0x40:
+            return rd_u32(c, &u);
+        case 0x0E: {
+            uint32_t count = 0;
+            if (!rd_u32(c, &count)) {
+                return false;
+            }
+            for (uint32_t i = 0; i <= count; ++i) {
+                if (!rd_u32(c, &u)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case 0x1C: {
+            uint32_t count = 0;
+            if (!rd_u32(c, &count) || count != 1) {
+                return false;
+            }
+            uint8_t valtype = 0;
+            return rd_u8(c, &valtype);
+        }
+        case 0x41:
+            return rd_sleb(c, &s, 35);
+        case 0x42:
+            return rd_sleb(c, &s, 70);
+        case 0x43:
+            c->pos += 4U;
+            return c->pos <= c->size;
+        case 0x44:
+            c->pos += 8U;
+            return c->pos <= c->size;
+        default:
+            if (opcode >= 0x28 && opcode <= 0x3E) {
+                return rd_memarg(c, &u);
+            }
+            /* Everything else the compiler accepts has no immediates; unknown
+               or prefixed opcodes reject the function. */
+            return opcode <= 0x01 || opcode == 0x05 || opcode == 0x0B || opcode == 0x0F ||
+                   opcode == 0x1A || opcode == 0x1B || (opcode >= 0x45 && opcode <= 0xC4);
+    }
+}
+
+/* ----- main lowering loop ----- */
+
+static bool compile_end(NativeCompiler* c) {
+    NativeCtrl* ctrl = &c->ctrl[c->ctrl_depth - 1U];
+    if (!c->dead && c->sp != ctrl->height + ctrl->results) {
+        return false;
+    }
+    if (ctrl->kind == NATIVE_CTRL_IF && !ctrl->has_else) {
+        if (ctrl->params != ctrl->results) {
+            return false;
+        }
+        ir_bind(c, ctrl->else_label);
+    }
+    if (ctrl->kind != NATIVE_CTRL_LOOP) {
+        ir_bind(c, ctrl->label);
+    }
+    c->sp = ctrl->height + ctrl->results;
+    c->dead = false;
+    c->ctrl_depth--;
+    return true;
+}
+
+static bool compile_numeric(NativeCompiler* c, uint8_t opcode);
+
+static bool compile_op(NativeCompiler* c, uint8_t opcode) {
+    uint32_t index = 0;
+    uint32_t slot = 0;
+    switch (opcode) {
+        case 0x00: /* unreachable */
+            ir_emit(c, FA_NIR_TRAP, 0, false);
+            c->dead = true;
+            return true;
+        case 0x01:
+            return true;
+        case 0x02: case 0x03: {
+            uint32_t params = 0;
+            uint32_t results = 0;
+            if (!rd_block_type(c, &params, &results) ||
+                !push_ctrl(c, opcode == 0x02 ? NATIVE_CTRL_BLOCK : NATIVE_CTRL_LOOP, params, results)) {
+                return false;
+            }
+            if (opcode == 0x03) {
+                ir_bind(c, c->ctrl[c->ctrl_depth - 1U].label);
+                if (c->request->osr_pc != 0 && c->pos == c->request->osr_pc) {
+                    ir_bind(c, c->osr_label);
+                    c->ir->osr_height = c->sp;
+                    c->osr_bound = true;
+                }
+            }
+            return true;
+        }
+        case 0x04: {
+            uint32_t params = 0;
+            uint32_t results = 0;
+            if (!rd_block_type(c, &params, &results) || !need(c, 1)) {
+                return false;
+            }
+            c->sp--;
+            const uint32_t cond = c->sp;
+            if (!push_ctrl(c, NATIVE_CTRL_IF, params, results)) {
+                return false;
+            }
+            NativeCtrl* ctrl = &c->ctrl[c->ctrl_depth - 1U];
+            ctrl->else_label = ir_label(c);
+            ir_jump_if_zero(c, cond, ctrl->else_label);
+            return true;
+        }
+        case 0x05: {
+            NativeCtrl* ctrl = &c->ctrl[c->ctrl_depth - 1U];
+            if (ctrl->kind != NATIVE_CTRL_IF || ctrl->has_else) {
+                return false;
+            }
+            if (!c->dead && c->sp != ctrl->height + ctrl->results) {
+                return false;
+            }
+            ir_jump(c, ctrl->label);
+            ir_bind(c, ctrl->else_label);
+            ctrl->has_else = true;
+            c->sp = ctrl->height + ctrl->params;
+            c->dead = false;
+            return true;
+        }
+        case 0x0B:
+            return compile_end(c);
+        case 0x0C:
+            if (!rd_u32(c, &index) || !emit_branch(c, index)) {
+                return false;
+            }
+            c->dead = true;
+            return true;
+        case 0x0D: {
+            if (!rd_u32(c, &index) || !need(c, 1) || index >= c->ctrl_depth) {
+                return false;
+            }
+            c->sp--;
+            const uint32_t skip = ir_label(c);
+            ir_jump_if_zero(c, c->sp, skip);
+            if (!emit_branch(c, index)) {
+                return false;
+            }
+            ir_bind(c, skip);
+            return true;
+        }
+        case 0x0E: {
+            uint32_t count = 0;
+            if (!rd_u32(c, &count) || !need(c, 1) || count > 0xFFFFU) {
+                return false;
+            }
+            /* Branch moves only write below the index slot, so it stays
+               readable for every comparison. */
+            c->sp--;
+            for (uint32_t i = 0; i <= count; ++i) {
+                uint32_t depth = 0;
+                if (!rd_u32(c, &depth)) {
+                    return false;
+                }
+                if (i == count) {
+                    if (!emit_branch(c, depth)) {
+                        return false;
+                    }
+                    break;
+                }
+                const uint32_t next = ir_label(c);
+                fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_JUMP_IF_NE_IMM, 0, false);
+                insn->a = c->sp;
+                insn->imm = i;
+                insn->label = next;
+                if (!emit_branch(c, depth)) {
+                    return false;
+                }
+                ir_bind(c, next);
+            }
+            c->dead = true;
+            return true;
+        }
+        case 0x0F:
+            if (c->sp < c->result_count) {
+                return false;
+            }
+            move_values(c, c->sp - c->result_count, 0, c->result_count);
+            ir_emit(c, FA_NIR_RETURN, 0, false);
+            c->dead = true;
+            return true;
+        case 0x10:
+            return rd_u32(c, &index) && emit_call(c, index);
+        case 0x1A:
+            if (!need(c, 1)) {
+                return false;
+            }
+            c->sp--;
+            return true;
+        case 0x1C: {
+            uint32_t count = 0;
+            uint8_t valtype = 0;
+            if (!rd_u32(c, &count) || count != 1 || !rd_u8(c, &valtype) || !numeric_valtype(valtype)) {
+                return false;
+            }
+        }
+            /* fall through */
+        case 0x1B: {
+            if (!need(c, 3)) {
+                return false;
+            }
+            fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_SELECT, 0, true);
+            insn->dst = c->sp - 3U;
+            insn->a = c->sp - 3U;
+            insn->b = c->sp - 2U;
+            insn->c = c->sp - 1U;
+            c->sp -= 2U;
+            return true;
+        }
+        case 0x20:
+            if (!rd_u32(c, &index) || index >= c->local_count || !push_slot(c, &slot)) {
+                return false;
+            }
+            move_values(c, index, slot, 1);
+            return true;
+        case 0x21: case 0x22:
+            if (!rd_u32(c, &index) || index >= c->local_count || !need(c, 1)) {
+                return false;
+            }
+            move_values(c, c->sp - 1U, index, 1);
+            if (opcode == 0x21) {
+                c->sp--;
+            }
+            return true;
+        case 0x23: case 0x24: {
+            uint8_t valtype = 0;
+            bool is_mutable = false;
+            if (!rd_u32(c, &index) || !global_valtype(c, index, &valtype, &is_mutable)) {
+                return false;
+            }
+            const bool wide = valtype == VALTYPE_I64 || valtype == VALTYPE_F64;
+            if (opcode == 0x23) {
+                if (!push_slot(c, &slot)) {
+                    return false;
+                }
+                fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_GLOBAL_GET, 0, wide);
+                insn->dst = slot;
+                insn->imm = index;
+                return true;
+            }
+            if (!is_mutable || !need(c, 1)) {
+                return false;
+            }
+            c->sp--;
+            fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_GLOBAL_SET, 0, wide);
+            insn->a = c->sp;
+            insn->imm = index;
+            return true;
+        }
+        case 0x3F: case 0x40: {
+            uint8_t memory_index = 0;
+            if (!c->request->memory_flat || !rd_u8(c, &memory_index) || memory_index != 0) {
+                return false;
+            }
+            if (opcode == 0x3F) {
+                if (!push_slot(c, &slot)) {
+                    return false;
+                }
+                ir_emit(c, FA_NIR_MEMORY_SIZE, 0, false)->dst = slot;
+                return true;
+            }
+            if (!need(c, 1)) {
+                return false;
+            }
+            ir_unary(c, FA_NIR_MEMORY_GROW, 0, false, c->sp - 1U);
+            return true;
+        }
+        case 0x41: case 0x42: {
+            int64_t value = 0;
+            if (!rd_sleb(c, &value, opcode == 0x41 ? 35U : 70U) || !push_slot(c, &slot)) {
+                return false;
+            }
+            fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_CONST, 0, opcode == 0x42);
+            insn->dst = slot;
+            insn->imm = opcode == 0x41 ? (uint64_t)(uint32_t)value : (uint64_t)value;
+            return true;
+        }
+        case 0x43: case 0x44: {
+            const uint32_t bytes = opcode == 0x43 ? 4U : 8U;
+            if (c->pos + bytes > c->size || !push_slot(c, &slot)) {
+                return false;
+            }
+            uint64_t bits = 0;
+            for (uint32_t i = 0; i < bytes; ++i) {
+                bits |= (uint64_t)c->code[c->pos + i] << (8U * i);
+            }
+            c->pos += bytes;
+            fa_JitNativeIrInsn* insn = ir_emit(c, FA_NIR_CONST, 0, opcode == 0x44);
+            insn->dst = slot;
+            insn->imm = bits;
+            return true;
+        }
+        default:
+            break;
+    }
+
+    if (opcode >= 0x28 && opcode <= 0x35) {
+        return emit_load(c, opcode);
+    }
+    if (opcode >= 0x36 && opcode <= 0x3E) {
+        return emit_store(c, opcode);
+    }
+    return compile_numeric(c, opcode);
+}
+
+static bool compile_numeric(NativeCompiler* c, uint8_t opcode) {
+    /* Unary ops need one operand, binary ops two. */
+    const bool unary = opcode == 0x45 || opcode == 0x50 || (opcode >= 0x67 && opcode <= 0x69) ||
+                       (opcode >= 0x79 && opcode <= 0x7B) || (opcode >= 0x8B && opcode <= 0x91) ||
+                       (opcode >= 0x99 && opcode <= 0x9F) || opcode >= 0xA7;
+    if (!need(c, unary ? 1U : 2U)) {
+        return false;
+    }
+    const uint32_t top = c->sp - 1U;
+    if (opcode >= 0x46 && opcode <= 0x5A && opcode != 0x50) {
+        const bool wide = opcode > 0x50;
+        ir_binary(c, FA_NIR_ICMP, (uint8_t)(opcode - (wide ? 0x51 : 0x46)), wide);
+        return true;
+    }
+    if ((opcode >= 0x6A && opcode <= 0x78) || (opcode >= 0x7C && opcode <= 0x8A)) {
+        /* add sub mul div_s div_u rem_s rem_u and or xor shl shr_s shr_u rotl rotr */
+        static const uint8_t kIntOps[] = {
+            FA_NIR_ADD, FA_NIR_SUB, FA_NIR_MUL, FA_NIR_DIV_S, FA_NIR_DIV_U, FA_NIR_REM_S, FA_NIR_REM_U,
+            FA_NIR_AND, FA_NIR_OR, FA_NIR_XOR, FA_NIR_SHL, FA_NIR_SHR_S, FA_NIR_SHR_U, FA_NIR_ROTL, FA_NIR_ROTR
+        };
+        const bool wide = opcode >= 0x7C;
+        ir_binary(c, FA_NIR_IBIN, kIntOps[opcode - (wide ? 0x7C : 0x6A)], wide);
+        return true;
+    }
+    if ((opcode >= 0x5B && opcode <= 0x66)) {
+        const bool wide = opcode >= 0x61;
+        ir_binary(c, FA_NIR_FCMP, (uint8_t)(opcode - (wide ? 0x61 : 0x5B)), wide);
+        return true;
+    }
+    switch (opcode) {
+        case 0x45: case 0x50: ir_unary(c, FA_NIR_IUNARY, FA_NIR_EQZ, opcode == 0x50, top); return true;
+        case 0x67: case 0x79: ir_unary(c, FA_NIR_IUNARY, FA_NIR_CLZ, opcode == 0x79, top); return true;
+        case 0x68: case 0x7A: ir_unary(c, FA_NIR_IUNARY, FA_NIR_CTZ, opcode == 0x7A, top); return true;
+        case 0x8B: case 0x99: ir_unary(c, FA_NIR_FUNARY, FA_NIR_FABS, opcode == 0x99, top); return true;
+        case 0x8C: case 0x9A: ir_unary(c, FA_NIR_FUNARY, FA_NIR_FNEG, opcode == 0x9A, top); return true;
+        case 0x91: case 0x9F: ir_unary(c, FA_NIR_FUNARY, FA_NIR_FSQRT, opcode == 0x9F, top); return true;
+        case 0x92: case 0xA0: ir_binary(c, FA_NIR_FBIN, FA_NIR_FADD, opcode == 0xA0); return true;
+        case 0x93: case 0xA1: ir_binary(c, FA_NIR_FBIN, FA_NIR_FSUB, opcode == 0xA1); return true;
+        case 0x94: case 0xA2: ir_binary(c, FA_NIR_FBIN, FA_NIR_FMUL, opcode == 0xA2); return true;
+        case 0x95: case 0xA3: ir_binary(c, FA_NIR_FBIN, FA_NIR_FDIV, opcode == 0xA3); return true;
+        case 0x98: case 0xA6: ir_binary(c, FA_NIR_FBIN, FA_NIR_FCOPYSIGN, opcode == 0xA6); return true;
+        case 0xA7: /* i32.wrap_i64: consumers read the low 32 bits */
+        case 0xBC: case 0xBD: case 0xBE: case 0xBF: /* reinterpret: bits unchanged */
+            return true;
+        default:
+            break;
+    }
+    static const struct {
+        uint8_t opcode;
+        uint8_t convert;
+    } kConverts[] = {
+        { 0xA8, FA_NIR_I32_TRUNC_F32_S }, { 0xA9, FA_NIR_I32_TRUNC_F32_U },
+        { 0xAA, FA_NIR_I32_TRUNC_F64_S }, { 0xAB, FA_NIR_I32_TRUNC_F64_U },
+        { 0xAC, FA_NIR_I64_EXTEND_I32_S }, { 0xAD, FA_NIR_I64_EXTEND_I32_U },
+        { 0xAE, FA_NIR_I64_TRUNC_F32_S }, { 0xB0, FA_NIR_I64_TRUNC_F64_S },
+        { 0xB2, FA_NIR_F32_CONVERT_I32_S }, { 0xB3, FA_NIR_F32_CONVERT_I32_U },
+        { 0xB4, FA_NIR_F32_CONVERT_I64_S }, { 0xB6, FA_NIR_F32_DEMOTE_F64 },
+        { 0xB7, FA_NIR_F64_CONVERT_I32_S }, { 0xB8, FA_NIR_F64_CONVERT_I32_U },
+        { 0xB9, FA_NIR_F64_CONVERT_I64_S }, { 0xBB, FA_NIR_F64_PROMOTE_F32 },
+        { 0xC0, FA_NIR_I32_EXTEND8_S }, { 0xC1, FA_NIR_I32_EXTEND16_S },
+        { 0xC2, FA_NIR_I64_EXTEND8_S }, { 0xC3, FA_NIR_I64_EXTEND16_S },
+        { 0xC4, FA_NIR_I64_EXTEND32_S }
+    };
+    for (size_t i = 0; i < sizeof(kConverts) / sizeof(kConverts[0]); ++i) {
+        if (kConverts[i].opcode == opcode) {
+            ir_unary(c, FA_NIR_CONVERT, kConverts[i].convert, false, top);
+            return true;
+        }
+    }
+    /* popcnt, ceil/floor/trunc/nearest, min/max, u64 conversions, call_indirect,
+       reference/table ops and every prefixed opcode stay interpreted. */
+    return false;
+}
+
+static bool parse_locals(NativeCompiler* c) {
+    const WasmModule* module = c->request->module;
+    const WasmFunction* function = &module->functions[c->request->func_index];
+    if (function->type_index >= module->num_types) {
+        return false;
+    }
+    const WasmFunctionType* type = &module->types[function->type_index];
+    for (uint32_t i = 0; i < type->num_params; ++i) {
+        if (!numeric_valtype(type->param_types[i])) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < type->num_results; ++i) {
+        if (!numeric_valtype(type->result_types[i])) {
+            return false;
+        }
+    }
+    c->param_count = type->num_params;
+    c->result_count = type->num_results;
+    uint64_t total = type->num_params;
+    uint32_t groups = 0;
+    if (!rd_u32(c, &groups)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < groups; ++i) {
+        uint32_t count = 0;
+        uint8_t valtype = 0;
+        if (!rd_u32(c, &count) || !rd_u8(c, &valtype) || !numeric_valtype(valtype)) {
+            return false;
+        }
+        total += count;
+        if (total > NATIVE_MAX_LOCALS) {
+            return false;
+        }
+    }
+    c->local_count = (uint32_t)total;
+    return true;
+}
+
+static bool compile_body(NativeCompiler* c) {
+    if (!parse_locals(c)) {
+        return false;
+    }
+    c->sp = c->local_count;
+    c->max_sp = c->sp;
+    c->ctrl_depth = 0;
+    if (!push_ctrl(c, NATIVE_CTRL_FUNC, 0, c->result_count)) {
+        return false;
+    }
+    if (c->request->osr_pc != 0) {
+        /* OSR entry: jump straight to the loop header; the slots already
+           hold the interpreter's locals and operand stack. */
+        c->osr_label = ir_label(c);
+        c->ir->osr_entry = true;
+        ir_jump(c, c->osr_label);
+    }
+    bool finished = false;
+    while (!c->failed && c->pos < c->size) {
+        uint8_t opcode = 0;
+        if (!rd_u8(c, &opcode)) {
+            return false;
+        }
+        if (c->dead) {
+            /* Unreachable tail of a block: track nesting until its else/end. */
+            if (opcode == 0x02 || opcode == 0x03 || opcode == 0x04) {
+                c->dead_nesting++;
+            } else if ((opcode == 0x0B || opcode == 0x05) && c->dead_nesting > 0) {
+                if (opcode == 0x0B) {
+                    c->dead_nesting--;
+                }
+                continue;
+            }
+            if (c->dead_nesting > 0 || (opcode != 0x0B && opcode != 0x05)) {
+                if (!skip_immediates(c, opcode)) {
+                    return false;
+                }
+                continue;
+            }
+        }
+        if (!compile_op(c, opcode)) {
+            return false;
+        }
+        if (c->ctrl_depth == 0) {
+            finished = true;
+            break;
+        }
+    }
+    if (!finished || c->failed || (c->request->osr_pc != 0 && !c->osr_bound)) {
+        return false;
+    }
+    /* Falling off the end (or br to the function block) leaves the results
+       at the function's base height, directly above the locals. */
+    move_values(c, c->local_count, 0, c->result_count);
+    ir_emit(c, FA_NIR_RETURN, 0, false);
+    return !c->failed;
+}
+
+bool fa_jit_native_build_ir(const fa_JitNativeRequest* request, fa_JitNativeIr* ir) {
+    if (!ir) {
+        return false;
+    }
+    memset(ir, 0, sizeof(*ir));
+    if (!request || !request->module || !request->body || request->body_size == 0 ||
+        request->func_index >= request->module->num_functions ||
+        request->module->functions[request->func_index].is_imported) {
+        return false;
+    }
+    NativeCompiler* c = (NativeCompiler*)calloc(1, sizeof(NativeCompiler));
+    if (!c) {
+        return false;
+    }
+    c->request = request;
+    c->code = request->body;
+    c->size = request->body_size;
+    c->ir = ir;
+    const bool ok = compile_body(c);
+    if (ok) {
+        ir->param_count = c->param_count;
+        ir->local_count = c->local_count;
+        ir->result_count = c->result_count;
+        ir->frame_slots = c->max_sp;
+    } else {
+        fa_jit_native_ir_free(ir);
+    }
+    free(c);
+    return ok;
+}
+
+/* ----- backends and mapping ----- */
+
+static bool native_lower(const fa_JitNativeIr* ir, fa_JitNativeArch arch, fa_JitNativeBuffer* out) {
+    switch (arch) {
+        case FA_JIT_NATIVE_ARCH_X86_64:
+            return fa_jit_native_lower_x86_64(ir, out);
+        case FA_JIT_NATIVE_ARCH_AARCH64:
+            return fa_jit_native_lower_aarch64(ir, out);
+        default:
+            return false;
+    }
+}
+
+/* Builds and lowers the IR; `shape` receives its slot counts. */
+static bool native_emit(const fa_JitNativeRequest* request, fa_JitNativeArch arch,
+                        uint8_t** code_out, size_t* size_out, fa_JitNativeIr* shape) {
+    if (!code_out || !size_out) {
+        return false;
+    }
+    *code_out = NULL;
+    *size_out = 0;
+    fa_JitNativeIr ir;
+    if (!fa_jit_native_build_ir(request, &ir)) {
+        return false;
+    }
+    fa_JitNativeBuffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    const bool ok = native_lower(&ir, arch, &buffer) && !buffer.failed && buffer.len > 0;
+    if (ok) {
+        *code_out = buffer.bytes;
+        *size_out = buffer.len;
+        buffer.bytes = NULL;
+        if (shape) {
+            *shape = ir;
+            shape->insns = NULL;
+            shape->count = 0;
+            shape->capacity = 0;
+        }
+    }
+    fa_jit_native_buffer_free(&buffer);
+    fa_jit_native_ir_free(&ir);
+    return ok;
+}
+
+bool fa_jit_native_emit(const fa_JitNativeRequest* request, fa_JitNativeArch arch,
+                        uint8_t** code_out, size_t* size_out, uint32_t* frame_slots_out) {
+    fa_JitNativeIr shape;
+    if (!native_emit(request, arch, code_out, size_out, &shape)) {
+        return false;
+    }
+    if (frame_slots_out) {
+        *frame_slots_out = shape.frame_slots;
+    }
+    return true;
+}
+
+#if !defined(FA_JIT_NATIVE_HOST)
+
+bool fa_jit_native_install(const uint8_t* code, size_t code_bytes, uint32_t frame_slots,
+                           struct fa_JitCodeCache* cache, fa_JitNativeCode* out) {
+    (void)code;
+    (void)code_bytes;
+    (void)frame_slots;
+    (void)cache;
+    if (out) {
+        memset(out, 0, sizeof(*out));
+    }
+    return false;
+}
+
+bool fa_jit_native_compile(const fa_JitNativeRequest* request, struct fa_JitCodeCache* cache, fa_JitNativeCode* out) {
+    (void)request;
+    (void)cache;
+    if (out) {
+        memset(out, 0, sizeof(*out));
+    }
+    return false;
+}
+
+#else
+
+bool fa_jit_native_install(const uint8_t* code, size_t code_bytes, uint32_t frame_slots,
+                           struct fa_JitCodeCache* cache, fa_JitNativeCode* out) {
+    if (!out) {
+        return false;
+    }
+    memset(out, 0, sizeof(*out));
+    if (!code || code_bytes == 0) {
+        return false;
+    }
+    if (cache) {
+        size_t block_bytes = 0;
+        void* block = fa_jit_code_cache_install(cache, code, code_bytes, &block_bytes);
+        if (!block) {
+            return false;
+        }
+        out->map = block;
+        out->map_bytes = block_bytes;
+        out->code_bytes = code_bytes;
+        out->frame_slots = frame_slots;
+        out->cache = cache;
+        memcpy(&out->entry, &out->map, sizeof(out->entry));
+        return true;
+    }
+    const long page = sysconf(_SC_PAGESIZE);
+    const size_t page_bytes = page > 0 ? (size_t)page : 4096U;
+    const size_t map_bytes = (code_bytes + page_bytes - 1U) / page_bytes * page_bytes;
+    void* map = mmap(NULL, map_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    memcpy(map, code, code_bytes);
+    /* W^X: the page is never writable and executable at once. */
+    if (mprotect(map, map_bytes, PROT_READ | PROT_EXEC) != 0) {
+        munmap(map, map_bytes);
+        return false;
+    }
+#if defined(FA_JIT_NATIVE_AARCH64)
+    /* AArch64 instruction fetch is not coherent with data writes. */
+    __builtin___clear_cache((char*)map, (char*)map + code_bytes);
+#endif
+    out->map = map;
+    out->map_bytes = map_bytes;
+    out->code_bytes = code_bytes;
+    out->frame_slots = frame_slots;
+    memcpy(&out->entry, &out->map, sizeof(out->entry));
+    return true;
+}
+
+bool fa_jit_native_compile(const fa_JitNativeRequest* request, struct fa_JitCodeCache* cache, fa_JitNativeCode* out) {
+    if (!out) {
+        return false;
+    }
+    memset(out, 0, sizeof(*out));
+    uint8_t* code = NULL;
+    size_t code_bytes = 0;
+    fa_JitNativeIr shape;
+    if (!native_emit(request, FA_JIT_NATIVE_ARCH_HOST, &code, &code_bytes, &shape)) {
+        return false;
+    }
+    const bool ok = fa_jit_native_install(code, code_bytes, shape.frame_slots, cache, out);
+    free(code);
+    if (ok) {
+        out->osr_height = shape.osr_height;
+    }
+    return ok;
+}
+
+#endif
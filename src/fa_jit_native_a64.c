@@ -0,0 +1,739 @@
+#include "fa_jit_native_ir.h"
+#include "fa_runtime.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* ------------------------------------------------------------------------- *
+ * AArch64 native backend.
+ *
+ * Register plan (AAPCS64): x19 = slot base, x20 = fa_JitNativeContext*, both
+ * callee-saved so they survive calls; x0-x3 and d0/d1 are scratch, x16 holds
+ * call targets and x17 materialises offsets that do not fit an immediate
+ * field. Every IR instruction lowers to loads from [x19 + 8*slot], a short
+ * compute sequence and a store, like the x86-64 backend. Conditional branches
+ * use the 19-bit forms (+-1 MiB), which bounds a compiled function well above
+ * anything the frontend accepts.
+ * ------------------------------------------------------------------------- */
+
+enum {
+    X0 = 0, X1 = 1, X2 = 2, X3 = 3, X16 = 16, X17 = 17,
+    X_SLOTS = 19, X_CTX = 20, X29 = 29, X30 = 30, XZR = 31
+};
+
+enum {
+    COND_EQ = 0x0, COND_NE = 0x1, COND_HS = 0x2, COND_LO = 0x3, COND_MI = 0x4, COND_VS = 0x6,
+    COND_HI = 0x8, COND_LS = 0x9, COND_GE = 0xA, COND_LT = 0xB, COND_GT = 0xC, COND_LE = 0xD
+};
+
+enum {
+    A64_FIXUP_B26 = 0, /* B */
+    A64_FIXUP_B19 = 1  /* B.cond, CBZ, CBNZ */
+};
+
+/* 32-bit base encodings; SF selects the 64-bit form, FTYPE_D the double one. */
+#define SF 0x80000000U
+#define FTYPE_D 0x00400000U
+
+#define OP_ADD 0x0B000000U
+#define OP_SUB 0x4B000000U
+#define OP_SUBS 0x6B000000U
+#define OP_AND 0x0A000000U
+#define OP_ORR 0x2A000000U
+#define OP_EOR 0x4A000000U
+#define OP_MUL 0x1B007C00U
+#define OP_MSUB 0x1B008000U
+#define OP_SDIV 0x1AC00C00U
+#define OP_UDIV 0x1AC00800U
+#define OP_LSLV 0x1AC02000U
+#define OP_LSRV 0x1AC02400U
+#define OP_ASRV 0x1AC02800U
+#define OP_RORV 0x1AC02C00U
+#define OP_CLZ 0x5AC01000U
+#define OP_RBIT 0x5AC00000U
+#define OP_CSEL 0x1A800000U
+#define OP_CSINC 0x1A800400U
+#define OP_ADD_IMM 0x11000000U
+#define OP_SUB_IMM 0x51000000U
+#define OP_SUBS_IMM 0x71000000U
+#define OP_ADDS_IMM 0x31000000U
+#define OP_MOVZ 0x52800000U
+#define OP_MOVK 0x72800000U
+#define OP_MOVN 0x12800000U
+
+#define OP_FADD 0x1E202800U
+#define OP_FSUB 0x1E203800U
+#define OP_FMUL 0x1E200800U
+#define OP_FDIV 0x1E201800U
+#define OP_FSQRT 0x1E21C000U
+#define OP_FCMP 0x1E202000U
+
+/* Load/store pairs: unsigned scaled immediate form, register-offset form. */
+typedef struct {
+    uint32_t imm;
+    uint32_t reg;
+    uint8_t scale_log2;
+} A64MemOp;
+
+static const A64MemOp kLdrX = { 0xF9400000U, 0xF8606800U, 3 };
+static const A64MemOp kStrX = { 0xF9000000U, 0xF8206800U, 3 };
+static const A64MemOp kLdrW = { 0xB9400000U, 0xB8606800U, 2 };
+static const A64MemOp kStrW = { 0xB9000000U, 0xB8206800U, 2 };
+static const A64MemOp kLdrD = { 0xFD400000U, 0xFC606800U, 3 };
+static const A64MemOp kStrD = { 0xFD000000U, 0xFC206800U, 3 };
+static const A64MemOp kLdrS = { 0xBD400000U, 0xBC606800U, 2 };
+static const A64MemOp kStrS = { 0xBD000000U, 0xBC206800U, 2 };
+
+typedef struct {
+    fa_JitNativeBuffer* buf;
+    const fa_JitNativeIr* ir;
+    uint32_t trap_label;
+    uint32_t exit_label;
+    uint32_t exit_nodepth_label;
+    uint32_t ret_label;
+    uint32_t overflow_label;
+} A64;
+
+/* ----- instruction encoding ----- */
+
+static void ins(A64* a, uint32_t word) {
+    fa_jit_native_buffer_u32(a->buf, word);
+}
+
+static uint32_t new_label(A64* a) {
+    return fa_jit_native_buffer_label(a->buf);
+}
+
+static void bind(A64* a, uint32_t label) {
+    fa_jit_native_buffer_bind(a->buf, label);
+}
+
+static void b(A64* a, uint32_t label) {
+    fa_jit_native_buffer_fixup(a->buf, label, A64_FIXUP_B26);
+    ins(a, 0x14000000U);
+}
+
+static void b_cond(A64* a, uint8_t cond, uint32_t label) {
+    fa_jit_native_buffer_fixup(a->buf, label, A64_FIXUP_B19);
+    ins(a, 0x54000000U | cond);
+}
+
+static void cbz(A64* a, bool sf, bool nonzero, uint8_t rt, uint32_t label) {
+    fa_jit_native_buffer_fixup(a->buf, label, A64_FIXUP_B19);
+    ins(a, (sf ? SF : 0U) | (nonzero ? 0x35000000U : 0x34000000U) | rt);
+}
+
+static void blr(A64* a, uint8_t rn) {
+    ins(a, 0xD63F0000U | ((uint32_t)rn << 5));
+}
+
+static void dp(A64* a, uint32_t op, bool sf, uint8_t rd, uint8_t rn, uint8_t rm) {
+    ins(a, op | (sf ? SF : 0U) | ((uint32_t)rm << 16) | ((uint32_t)rn << 5) | rd);
+}
+
+/* rd = ra - rn * rm */
+static void msub(A64* a, bool sf, uint8_t rd, uint8_t rn, uint8_t rm, uint8_t ra) {
+    ins(a, OP_MSUB | (sf ? SF : 0U) | ((uint32_t)rm << 16) | ((uint32_t)ra << 10) | ((uint32_t)rn << 5) | rd);
+}
+
+static void dp_imm(A64* a, uint32_t op, bool sf, uint8_t rd, uint8_t rn, uint32_t imm12) {
+    ins(a, op | (sf ? SF : 0U) | ((imm12 & 0xFFFU) << 10) | ((uint32_t)rn << 5) | rd);
+}
+
+static void mov_reg(A64* a, uint8_t rd, uint8_t rm) {
+    dp(a, OP_ORR, true, rd, XZR, rm);
+}
+
+static void cmp(A64* a, bool sf, uint8_t rn, uint8_t rm) {
+    dp(a, OP_SUBS, sf, XZR, rn, rm);
+}
+
+static void cmp_imm(A64* a, bool sf, uint8_t rn, uint32_t imm12) {
+    dp_imm(a, OP_SUBS_IMM, sf, XZR, rn, imm12);
+}
+
+/* cset wd, cond == csinc wd, wzr, wzr, !cond */
+static void cset(A64* a, uint8_t rd, uint8_t cond) {
+    ins(a, OP_CSINC | ((uint32_t)XZR << 16) | ((uint32_t)(cond ^ 1U) << 12) | ((uint32_t)XZR << 5) | rd);
+}
+
+/* Immediate shifts are UBFM aliases. */
+static void lsl_imm(A64* a, bool sf, uint8_t rd, uint8_t rn, uint32_t shift) {
+    const uint32_t bits = sf ? 64U : 32U;
+    const uint32_t base = sf ? 0xD3400000U : 0x53000000U;
+    ins(a, base | (((bits - shift) % bits) << 16) | ((bits - 1U - shift) << 10) | ((uint32_t)rn << 5) | rd);
+}
+
+static void lsr_imm(A64* a, bool sf, uint8_t rd, uint8_t rn, uint32_t shift) {
+    const uint32_t base = sf ? 0xD3400000U : 0x53000000U;
+    ins(a, base | (shift << 16) | ((sf ? 63U : 31U) << 10) | ((uint32_t)rn << 5) | rd);
+}
+
+static void mov_imm(A64* a, bool sf, uint8_t rd, uint64_t value) {
+    const uint32_t chunks = sf ? 4U : 2U;
+    const uint64_t mask = sf ? UINT64_MAX : 0xFFFFFFFFULL;
+    value &= mask;
+    const uint64_t inverted = ~value & mask;
+    uint32_t zero_chunks = 0;
+    uint32_t ones_chunks = 0;
+    for (uint32_t i = 0; i < chunks; ++i) {
+        const uint32_t chunk = (uint32_t)(value >> (16U * i)) & 0xFFFFU;
+        zero_chunks += chunk == 0U;
+        ones_chunks += chunk == 0xFFFFU;
+    }
+    /* MOVN starts from all-ones, MOVZ from zero; MOVK patches the rest. */
+    const bool use_movn = ones_chunks > zero_chunks;
+    const uint32_t skip = use_movn ? 0xFFFFU : 0U;
+    const uint64_t start = use_movn ? inverted : value;
+    uint32_t first = 0;
+    while (first + 1U < chunks && ((start >> (16U * first)) & 0xFFFFU) == 0U) {
+        first++;
+    }
+    const uint32_t sf_bit = sf ? SF : 0U;
+    ins(a, (use_movn ? OP_MOVN : OP_MOVZ) | sf_bit | (first << 21) |
+           ((uint32_t)((start >> (16U * first)) & 0xFFFFU) << 5) | rd);
+    for (uint32_t i = first + 1U; i < chunks; ++i) {
+        const uint32_t chunk = (uint32_t)(value >> (16U * i)) & 0xFFFFU;
+        if (chunk != skip) {
+            ins(a, OP_MOVK | sf_bit | (i << 21) | (chunk << 5) | rd);
+        }
+    }
+}
+
+/* rd = rn + offset (64-bit). */
+static void add_offset(A64* a, uint8_t rd, uint8_t rn, uint64_t offset) {
+    if (offset < 4096U) {
+        dp_imm(a, OP_ADD_IMM, true, rd, rn, (uint32_t)offset);
+        return;
+    }
+    mov_imm(a, true, X17, offset);
+    dp(a, OP_ADD, true, rd, rn, X17);
+}
+
+/* [rn + offset] through the scaled immediate form when it fits, otherwise
+   via a register offset in x17 (so rn/rt must not be x17). */
+static void mem_off(A64* a, const A64MemOp* op, uint8_t rt, uint8_t rn, uint64_t offset) {
+    const uint64_t scaled = offset >> op->scale_log2;
+    if ((offset & ((1U << op->scale_log2) - 1U)) == 0U && scaled <= 0xFFFU) {
+        ins(a, op->imm | ((uint32_t)scaled << 10) | ((uint32_t)rn << 5) | rt);
+        return;
+    }
+    mov_imm(a, true, X17, offset);
+    ins(a, op->reg | ((uint32_t)X17 << 16) | ((uint32_t)rn << 5) | rt);
+}
+
+static void load_slot(A64* a, bool sf, uint8_t rt, uint32_t slot) {
+    mem_off(a, sf ? &kLdrX : &kLdrW, rt, X_SLOTS, (uint64_t)slot * 8U);
+}
+
+static void store_slot(A64* a, bool sf, uint32_t slot, uint8_t rt) {
+    mem_off(a, sf ? &kStrX : &kStrW, rt, X_SLOTS, (uint64_t)slot * 8U);
+}
+
+static void load_fslot(A64* a, bool f64, uint8_t vt, uint32_t slot) {
+    mem_off(a, f64 ? &kLdrD : &kLdrS, vt, X_SLOTS, (uint64_t)slot * 8U);
+}
+
+static void store_fslot(A64* a, bool f64, uint32_t slot, uint8_t vt) {
+    mem_off(a, f64 ? &kStrD : &kStrS, vt, X_SLOTS, (uint64_t)slot * 8U);
+}
+
+static void ctx_load(A64* a, bool sf, uint8_t rt, size_t field) {
+    mem_off(a, sf ? &kLdrX : &kLdrW, rt, X_CTX, field);
+}
+
+static void ctx_store32(A64* a, size_t field, uint8_t rt) {
+    mem_off(a, &kStrW, rt, X_CTX, field);
+}
+
+/* ----- integer operators ----- */
+
+/* div/rem with the wasm traps: divide by zero, and INT_MIN / -1 for div_s.
+   sdiv defines INT_MIN / -1 as INT_MIN, so msub yields the required 0 for
+   rem_s without a special case. */
+static void emit_divide(A64* a, const fa_JitNativeIrInsn* insn, bool is_signed, bool remainder) {
+    const bool sf = insn->wide;
+    load_slot(a, sf, X0, insn->a);
+    load_slot(a, sf, X1, insn->b);
+    cbz(a, sf, false, X1, a->trap_label);
+    if (is_signed && !remainder) {
+        const uint32_t do_label = new_label(a);
+        dp_imm(a, OP_ADDS_IMM, sf, XZR, X1, 1); /* cmn x1, #1 */
+        b_cond(a, COND_NE, do_label);
+        mov_imm(a, sf, X2, sf ? 0x8000000000000000ULL : 0x80000000ULL);
+        cmp(a, sf, X0, X2);
+        b_cond(a, COND_EQ, a->trap_label);
+        bind(a, do_label);
+    }
+    dp(a, is_signed ? OP_SDIV : OP_UDIV, sf, X2, X0, X1);
+    if (remainder) {
+        msub(a, sf, X2, X2, X1, X0);
+    }
+    store_slot(a, sf, insn->dst, X2);
+}
+
+static void emit_ibin(A64* a, const fa_JitNativeIrInsn* insn) {
+    static const uint32_t kOps[] = {
+        OP_ADD, OP_SUB, OP_MUL, OP_AND, OP_ORR, OP_EOR, OP_LSLV, OP_ASRV, OP_LSRV, OP_RORV, OP_RORV
+    };
+    const bool sf = insn->wide;
+    switch (insn->sub) {
+        case FA_NIR_DIV_S: emit_divide(a, insn, true, false); return;
+        case FA_NIR_DIV_U: emit_divide(a, insn, false, false); return;
+        case FA_NIR_REM_S: emit_divide(a, insn, true, true); return;
+        case FA_NIR_REM_U: emit_divide(a, insn, false, true); return;
+        default: break;
+    }
+    load_slot(a, sf, X0, insn->a);
+    load_slot(a, sf, X1, insn->b);
+    if (insn->sub == FA_NIR_ROTL) {
+        dp(a, OP_SUB, sf, X1, XZR, X1); /* rotl n == rotr -n (mod width) */
+    }
+    dp(a, kOps[insn->sub], sf, X0, X0, X1);
+    store_slot(a, sf, insn->dst, X0);
+}
+
+static void emit_icmp(A64* a, const fa_JitNativeIrInsn* insn) {
+    static const uint8_t kConditions[] = {
+        COND_EQ, COND_NE, COND_LT, COND_LO, COND_GT, COND_HI, COND_LE, COND_LS, COND_GE, COND_HS
+    };
+    load_slot(a, insn->wide, X0, insn->a);
+    load_slot(a, insn->wide, X1, insn->b);
+    cmp(a, insn->wide, X0, X1);
+    cset(a, X0, kConditions[insn->sub]);
+    store_slot(a, false, insn->dst, X0);
+}
+
+static void emit_iunary(A64* a, const fa_JitNativeIrInsn* insn) {
+    const bool sf = insn->wide;
+    load_slot(a, sf, X0, insn->a);
+    if (insn->sub == FA_NIR_EQZ) {
+        cmp_imm(a, sf, X0, 0);
+        cset(a, X0, COND_EQ);
+        store_slot(a, false, insn->dst, X0);
+        return;
+    }
+    if (insn->sub == FA_NIR_CTZ) {
+        dp(a, OP_RBIT, sf, X0, X0, 0);
+    }
+    dp(a, OP_CLZ, sf, X0, X0, 0); /* clz/ctz of zero is the bit width, as in wasm */
+    store_slot(a, true, insn->dst, X0);
+}
+
+/* ----- float operators ----- */
+
+static void emit_fbin(A64* a, const fa_JitNativeIrInsn* insn) {
+    const bool f64 = insn->wide;
+    if (insn->sub == FA_NIR_FCOPYSIGN) {
+        /* Bit operations only, so NaN payloads pass through unchanged. */
+        const uint32_t sign = f64 ? 63U : 31U;
+        load_slot(a, f64, X0, insn->a);
+        load_slot(a, f64, X1, insn->b);
+        lsl_imm(a, f64, X0, X0, 1);
+        lsr_imm(a, f64, X0, X0, 1);
+        lsr_imm(a, f64, X1, X1, sign);
+        lsl_imm(a, f64, X1, X1, sign);
+        dp(a, OP_ORR, f64, X0, X0, X1);
+        store_slot(a, f64, insn->dst, X0);
+        return;
+    }
+    static const uint32_t kOps[] = { OP_FADD, OP_FSUB, OP_FMUL, OP_FDIV };
+    load_fslot(a, f64, 0, insn->a);
+    load_fslot(a, f64, 1, insn->b);
+    ins(a, kOps[insn->sub] | (f64 ? FTYPE_D : 0U) | (1U << 16));
+    store_fslot(a, f64, insn->dst, 0);
+}
+
+static void emit_funary(A64* a, const fa_JitNativeIrInsn* insn) {
+    const bool f64 = insn->wide;
+    if (insn->sub == FA_NIR_FSQRT) {
+        load_fslot(a, f64, 0, insn->a);
+        ins(a, OP_FSQRT | (f64 ? FTYPE_D : 0U));
+        store_fslot(a, f64, insn->dst, 0);
+        return;
+    }
+    load_slot(a, f64, X0, insn->a);
+    if (insn->sub == FA_NIR_FABS) {
+        lsl_imm(a, f64, X0, X0, 1);
+        lsr_imm(a, f64, X0, X0, 1);
+    } else {
+        mov_imm(a, f64, X1, f64 ? 0x8000000000000000ULL : 0x80000000ULL);
+        dp(a, OP_EOR, f64, X0, X0, X1);
+    }
+    store_slot(a, f64, insn->dst, X0);
+}
+
+/* fcmp sets NZCV to 0011 for unordered operands; each condition below is
+   false for NaN except NE, matching wasm. lt/le use MI/LS (not LT/LE, which
+   are true when unordered). */
+static void emit_fcmp(A64* a, const fa_JitNativeIrInsn* insn) {
+    static const uint8_t kConditions[] = { COND_EQ, COND_NE, COND_MI, COND_GT, COND_LS, COND_GE };
+    load_fslot(a, insn->wide, 0, insn->a);
+    load_fslot(a, insn->wide, 1, insn->b);
+    ins(a, OP_FCMP | (insn->wide ? FTYPE_D : 0U) | (1U << 16));
+    cset(a, X0, kConditions[insn->sub]);
+    store_slot(a, false, insn->dst, X0);
+}
+
+/* ----- conversions ----- */
+
+/* fcvtzs saturates and maps NaN to 0, so the wasm traps are explicit: NaN
+   first, then a range check on the 64-bit result. For i64 targets INT64_MAX
+   is only produced by overflow, and INT64_MIN is valid only for exactly
+   -2^63. */
+static void emit_truncate(A64* a, const fa_JitNativeIrInsn* insn, bool from_f64, bool to_i64, bool is_signed) {
+    const uint32_t ftype = from_f64 ? FTYPE_D : 0U;
+    load_fslot(a, from_f64, 0, insn->a);
+    ins(a, OP_FCMP | ftype);                       /* fcmp v0, v0 */
+    b_cond(a, COND_VS, a->trap_label);
+    ins(a, 0x9E380000U | ftype);                   /* fcvtzs x0, v0 */
+    if (!to_i64) {
+        if (is_signed) {
+            ins(a, 0xEB20C01FU);                   /* cmp x0, w0, sxtw */
+            b_cond(a, COND_NE, a->trap_label);
+        } else {
+            lsr_imm(a, true, X1, X0, 32);
+            cbz(a, true, true, X1, a->trap_label);
+        }
+        store_slot(a, false, insn->dst, X0);
+        return;
+    }
+    const uint32_t ok_label = new_label(a);
+    mov_imm(a, true, X1, 0x7FFFFFFFFFFFFFFFULL);
+    cmp(a, true, X0, X1);
+    b_cond(a, COND_EQ, a->trap_label);
+    mov_imm(a, true, X1, 0x8000000000000000ULL);
+    cmp(a, true, X0, X1);
+    b_cond(a, COND_NE, ok_label);
+    if (from_f64) {
+        mov_imm(a, true, X1, 0xC3E0000000000000ULL); /* -2^63 */
+        ins(a, 0x9E670021U);                         /* fmov d1, x1 */
+    } else {
+        mov_imm(a, false, X1, 0xDF000000U);          /* -2^63f */
+        ins(a, 0x1E270021U);                         /* fmov s1, w1 */
+    }
+    ins(a, OP_FCMP | ftype | (1U << 16));            /* fcmp v0, v1 */
+    b_cond(a, COND_NE, a->trap_label);
+    bind(a, ok_label);
+    store_slot(a, true, insn->dst, X0);
+}
+
+static void emit_convert(A64* a, const fa_JitNativeIrInsn* insn) {
+    switch (insn->sub) {
+        case FA_NIR_I64_EXTEND_I32_U:
+            load_slot(a, false, X0, insn->a); /* ldr w zero-extends */
+            store_slot(a, true, insn->dst, X0);
+            return;
+        case FA_NIR_I64_EXTEND_I32_S:
+        case FA_NIR_I32_EXTEND8_S:
+        case FA_NIR_I32_EXTEND16_S:
+        case FA_NIR_I64_EXTEND8_S:
+        case FA_NIR_I64_EXTEND16_S:
+        case FA_NIR_I64_EXTEND32_S: {
+            /* sxtw x / sxtb w / sxth w / sxtb x / sxth x / sxtw x */
+            static const uint32_t kSbfm[] = {
+                0x93407C00U, 0, 0x13001C00U, 0x13003C00U, 0x93401C00U, 0x93403C00U, 0x93407C00U
+            };
+            load_slot(a, false, X0, insn->a);
+            ins(a, kSbfm[insn->sub]);
+            store_slot(a, true, insn->dst, X0);
+            return;
+        }
+        case FA_NIR_F32_DEMOTE_F64:
+            load_fslot(a, true, 0, insn->a);
+            ins(a, 0x1E624000U); /* fcvt s0, d0 */
+            store_fslot(a, false, insn->dst, 0);
+            return;
+        case FA_NIR_F64_PROMOTE_F32:
+            load_fslot(a, false, 0, insn->a);
+            ins(a, 0x1E22C000U); /* fcvt d0, s0 */
+            store_fslot(a, true, insn->dst, 0);
+            return;
+        case FA_NIR_I32_TRUNC_F32_S: emit_truncate(a, insn, false, false, true); return;
+        case FA_NIR_I32_TRUNC_F32_U: emit_truncate(a, insn, false, false, false); return;
+        case FA_NIR_I32_TRUNC_F64_S: emit_truncate(a, insn, true, false, true); return;
+        case FA_NIR_I32_TRUNC_F64_U: emit_truncate(a, insn, true, false, false); return;
+        case FA_NIR_I64_TRUNC_F32_S: emit_truncate(a, insn, false, true, true); return;
+        case FA_NIR_I64_TRUNC_F64_S: emit_truncate(a, insn, true, true, true); return;
+        default:
+            break;
+    }
+    /* scvtf / ucvtf v0, w0|x0 */
+    const bool from_i64 = insn->sub == FA_NIR_F32_CONVERT_I64_S || insn->sub == FA_NIR_F64_CONVERT_I64_S;
+    const bool to_f64 = insn->sub >= FA_NIR_F64_CONVERT_I32_S;
+    const bool is_unsigned = insn->sub == FA_NIR_F32_CONVERT_I32_U || insn->sub == FA_NIR_F64_CONVERT_I32_U;
+    load_slot(a, from_i64, X0, insn->a);
+    ins(a, 0x1E220000U | (from_i64 ? SF : 0U) | (to_f64 ? FTYPE_D : 0U) | (is_unsigned ? 0x10000U : 0U));
+    store_fslot(a, to_f64, insn->dst, 0);
+}
+
+/* ----- memory, globals, calls ----- */
+
+/* x0 = effective address; traps unless [x0, x0 + bytes) is inside memory 0,
+   then leaves the memory base in x1. */
+static void emit_address(A64* a, uint32_t addr_slot, uint32_t offset, uint32_t bytes) {
+    load_slot(a, false, X0, addr_slot);
+    if (offset != 0) {
+        if (offset < 4096U) {
+            dp_imm(a, OP_ADD_IMM, true, X0, X0, offset);
+        } else {
+            mov_imm(a, false, X1, offset);
+            dp(a, OP_ADD, true, X0, X0, X1);
+        }
+    }
+    dp_imm(a, OP_ADD_IMM, true, X2, X0, bytes);
+    ctx_load(a, true, X1, offsetof(fa_JitNativeContext, memory));
+    mem_off(a, &kLdrX, X3, X1, offsetof(fa_RuntimeMemory, size_bytes));
+    cmp(a, true, X2, X3);
+    b_cond(a, COND_HI, a->trap_label);
+    mem_off(a, &kLdrX, X1, X1, offsetof(fa_RuntimeMemory, data));
+    cbz(a, true, false, X1, a->trap_label);
+}
+
+static void emit_load(A64* a, const fa_JitNativeIrInsn* insn) {
+    static const uint8_t kBytes[] = { 4, 8, 4, 8, 1, 1, 2, 2, 1, 1, 2, 2, 4, 4 };
+    /* ldr w / ldr x / ldr w / ldr x / ldrsb w / ldrb / ldrsh w / ldrh /
+       ldrsb x / ldrb / ldrsh x / ldrh / ldrsw / ldr w, all [x1, x0] */
+    static const uint32_t kOps[] = {
+        0xB8606800U, 0xF8606800U, 0xB8606800U, 0xF8606800U, 0x38E06800U, 0x38606800U, 0x78E06800U,
+        0x78606800U, 0x38A06800U, 0x38606800U, 0x78A06800U, 0x78606800U, 0xB8A06800U, 0xB8606800U
+    };
+    emit_address(a, insn->a, (uint32_t)insn->imm, kBytes[insn->sub]);
+    ins(a, kOps[insn->sub] | ((uint32_t)X0 << 16) | ((uint32_t)X1 << 5) | X0);
+    store_slot(a, true, insn->dst, X0);
+}
+
+static void emit_store(A64* a, const fa_JitNativeIrInsn* insn) {
+    uint32_t op = 0xF8206800U; /* str x */
+    switch (insn->sub) {
+        case 1: op = 0x38206800U; break; /* strb */
+        case 2: op = 0x78206800U; break; /* strh */
+        case 4: op = 0xB8206800U; break; /* str w */
+        default: break;
+    }
+    emit_address(a, insn->a, (uint32_t)insn->imm, insn->sub);
+    load_slot(a, true, X2, insn->b);
+    ins(a, op | ((uint32_t)X0 << 16) | ((uint32_t)X1 << 5) | X2);
+}
+
+static uint64_t global_offset(uint64_t index) {
+    return index * sizeof(fa_JobValue) + offsetof(fa_JobValue, payload);
+}
+
+static void emit_call(A64* a, const fa_JitNativeIrInsn* insn) {
+    const uint32_t function_index = (uint32_t)insn->imm;
+    const uint32_t slow_label = new_label(a);
+    const uint32_t done_label = new_label(a);
+    mov_reg(a, X0, X_CTX);
+    add_offset(a, X1, X_SLOTS, (uint64_t)insn->a * 8U);
+    ctx_load(a, true, X16, offsetof(fa_JitNativeContext, entries));
+    mem_off(a, &kLdrX, X16, X16, (uint64_t)function_index * sizeof(fa_JitNativeEntry));
+    cbz(a, true, false, X16, slow_label);
+    blr(a, X16);
+    b(a, done_label);
+    bind(a, slow_label);
+    mov_imm(a, false, X2, function_index);
+    ctx_load(a, true, X16, offsetof(fa_JitNativeContext, call_slow));
+    blr(a, X16);
+    bind(a, done_label);
+    cbz(a, false, true, X0, a->exit_label);
+}
+
+static void emit_insn(A64* a, const fa_JitNativeIrInsn* insn) {
+    switch (insn->op) {
+        case FA_NIR_LABEL:
+            bind(a, insn->label);
+            break;
+        case FA_NIR_JUMP:
+            b(a, insn->label);
+            break;
+        case FA_NIR_JUMP_IF_ZERO:
+            load_slot(a, false, X0, insn->a);
+            cbz(a, false, false, X0, insn->label);
+            break;
+        case FA_NIR_JUMP_IF_NE_IMM:
+            load_slot(a, false, X0, insn->a);
+            if (insn->imm < 4096U) {
+                cmp_imm(a, false, X0, (uint32_t)insn->imm);
+            } else {
+                mov_imm(a, false, X1, insn->imm);
+                cmp(a, false, X0, X1);
+            }
+            b_cond(a, COND_NE, insn->label);
+            break;
+        case FA_NIR_TRAP:
+            b(a, a->trap_label);
+            break;
+        case FA_NIR_RETURN:
+            b(a, a->ret_label);
+            break;
+        case FA_NIR_CONST:
+            if (insn->imm == 0) {
+                store_slot(a, true, insn->dst, XZR);
+            } else {
+                mov_imm(a, insn->wide, X0, insn->imm);
+                store_slot(a, insn->wide, insn->dst, X0);
+            }
+            break;
+        case FA_NIR_MOVE:
+            load_slot(a, true, X0, insn->a);
+            store_slot(a, true, insn->dst, X0);
+            break;
+        case FA_NIR_IBIN: emit_ibin(a, insn); break;
+        case FA_NIR_ICMP: emit_icmp(a, insn); break;
+        case FA_NIR_IUNARY: emit_iunary(a, insn); break;
+        case FA_NIR_FBIN: emit_fbin(a, insn); break;
+        case FA_NIR_FUNARY: emit_funary(a, insn); break;
+        case FA_NIR_FCMP: emit_fcmp(a, insn); break;
+        case FA_NIR_CONVERT: emit_convert(a, insn); break;
+        case FA_NIR_LOAD: emit_load(a, insn); break;
+        case FA_NIR_STORE: emit_store(a, insn); break;
+        case FA_NIR_MEMORY_SIZE:
+            ctx_load(a, true, X1, offsetof(fa_JitNativeContext, memory));
+            mem_off(a, &kLdrX, X0, X1, offsetof(fa_RuntimeMemory, size_bytes));
+            lsr_imm(a, true, X0, X0, 16);
+            store_slot(a, false, insn->dst, X0);
+            break;
+        case FA_NIR_MEMORY_GROW:
+            mov_reg(a, X0, X_CTX);
+            load_slot(a, false, X1, insn->a);
+            ctx_load(a, true, X16, offsetof(fa_JitNativeContext, memory_grow));
+            blr(a, X16);
+            store_slot(a, false, insn->dst, X0);
+            break;
+        case FA_NIR_GLOBAL_GET:
+            ctx_load(a, true, X1, offsetof(fa_JitNativeContext, globals));
+            mem_off(a, &kLdrX, X0, X1, global_offset(insn->imm));
+            store_slot(a, true, insn->dst, X0);
+            break;
+        case FA_NIR_GLOBAL_SET:
+            ctx_load(a, true, X1, offsetof(fa_JitNativeContext, globals));
+            load_slot(a, true, X0, insn->a);
+            mem_off(a, insn->wide ? &kStrX : &kStrW, X0, X1, global_offset(insn->imm));
+            break;
+        case FA_NIR_SELECT:
+            load_slot(a, false, X2, insn->c);
+            load_slot(a, true, X0, insn->a);
+            load_slot(a, true, X1, insn->b);
+            cmp_imm(a, false, X2, 0);
+            ins(a, OP_CSEL | SF | ((uint32_t)X1 << 16) | ((uint32_t)COND_NE << 12) | ((uint32_t)X0 << 5) | X0);
+            store_slot(a, true, insn->dst, X0);
+            break;
+        case FA_NIR_CALL:
+            emit_call(a, insn);
+            break;
+        default:
+            a->buf->failed = true;
+            break;
+    }
+}
+
+/* ----- prologue / epilogue ----- */
+
+static void emit_prologue(A64* a) {
+    const fa_JitNativeIr* ir = a->ir;
+    ins(a, 0xA9BE7BFDU); /* stp x29, x30, [sp, #-32]! */
+    ins(a, 0x910003FDU); /* mov x29, sp */
+    ins(a, 0xA90153F3U); /* stp x19, x20, [sp, #16] */
+    mov_reg(a, X_CTX, X0);
+    mov_reg(a, X_SLOTS, X1);
+    add_offset(a, X0, X_SLOTS, (uint64_t)ir->frame_slots * 8U);
+    ctx_load(a, true, X1, offsetof(fa_JitNativeContext, slot_limit));
+    cmp(a, true, X0, X1);
+    b_cond(a, COND_HI, a->overflow_label);
+    ctx_load(a, false, X0, offsetof(fa_JitNativeContext, depth));
+    ctx_load(a, false, X1, offsetof(fa_JitNativeContext, max_depth));
+    cmp(a, false, X0, X1);
+    b_cond(a, COND_HS, a->overflow_label);
+    dp_imm(a, OP_ADD_IMM, false, X0, X0, 1);
+    ctx_store32(a, offsetof(fa_JitNativeContext, depth), X0);
+    const uint32_t zeroed = ir->osr_entry ? 0 : ir->local_count - ir->param_count;
+    if (zeroed <= 16U) {
+        for (uint32_t i = 0; i < zeroed; ++i) {
+            store_slot(a, true, ir->param_count + i, XZR);
+        }
+    } else {
+        const uint32_t loop_label = new_label(a);
+        add_offset(a, X0, X_SLOTS, (uint64_t)ir->param_count * 8U);
+        mov_imm(a, true, X1, zeroed);
+        bind(a, loop_label);
+        ins(a, 0xF800841FU); /* str xzr, [x0], #8 */
+        dp_imm(a, OP_SUBS_IMM, true, X1, X1, 1);
+        b_cond(a, COND_NE, loop_label);
+    }
+}
+
+static void emit_epilogue(A64* a) {
+    bind(a, a->ret_label);
+    mov_imm(a, false, X0, 0);
+    bind(a, a->exit_label);
+    ctx_load(a, false, X1, offsetof(fa_JitNativeContext, depth));
+    dp_imm(a, OP_SUB_IMM, false, X1, X1, 1);
+    ctx_store32(a, offsetof(fa_JitNativeContext, depth), X1);
+    bind(a, a->exit_nodepth_label);
+    ins(a, 0xA94153F3U); /* ldp x19, x20, [sp, #16] */
+    ins(a, 0xA8C27BFDU); /* ldp x29, x30, [sp], #32 */
+    ins(a, 0xD65F03C0U); /* ret */
+    bind(a, a->trap_label);
+    mov_imm(a, false, X0, (uint32_t)FA_RUNTIME_ERR_TRAP);
+    b(a, a->exit_label);
+    bind(a, a->overflow_label);
+    mov_imm(a, false, X0, (uint32_t)FA_RUNTIME_ERR_CALL_DEPTH_EXCEEDED);
+    b(a, a->exit_nodepth_label);
+}
+
+static bool resolve_fixups(fa_JitNativeBuffer* buf) {
+    for (uint32_t i = 0; i < buf->fixup_count; ++i) {
+        const fa_JitNativeFixup* fixup = &buf->fixups[i];
+        const size_t target = fa_jit_native_buffer_label_offset(buf, fixup->label);
+        if (target == SIZE_MAX) {
+            return false;
+        }
+        const int64_t rel = ((int64_t)target - (int64_t)fixup->at) / 4;
+        uint8_t* field = buf->bytes + fixup->at;
+        uint32_t word = (uint32_t)field[0] | ((uint32_t)field[1] << 8) | ((uint32_t)field[2] << 16) |
+                        ((uint32_t)field[3] << 24);
+        if (fixup->kind == A64_FIXUP_B26) {
+            if (rel < -(1LL << 25) || rel >= (1LL << 25)) {
+                return false;
+            }
+            word |= (uint32_t)rel & 0x03FFFFFFU;
+        } else {
+            if (rel < -(1LL << 18) || rel >= (1LL << 18)) {
+                return false;
+            }
+            word |= ((uint32_t)rel & 0x7FFFFU) << 5;
+        }
+        for (int i = 0; i < 4; ++i) {
+            field[i] = (uint8_t)(word >> (8 * i));
+        }
+    }
+    return true;
+}
+
+bool fa_jit_native_lower_aarch64(const fa_JitNativeIr* ir, fa_JitNativeBuffer* out) {
+    if (!ir || !out) {
+        return false;
+    }
+    A64 a;
+    memset(&a, 0, sizeof(a));
+    a.buf = out;
+    a.ir = ir;
+    for (uint32_t i = 0; i < ir->label_count; ++i) {
+        (void)new_label(&a);
+    }
+    a.trap_label = new_label(&a);
+    a.exit_label = new_label(&a);
+    a.exit_nodepth_label = new_label(&a);
+    a.ret_label = new_label(&a);
+    a.overflow_label = new_label(&a);
+    emit_prologue(&a);
+    for (uint32_t i = 0; i < ir->count && !out->failed; ++i) {
+        if (ir->insns[i].op == FA_NIR_RETURN && i + 1U == ir->count) {
+            break; /* the epilogue follows directly */
+        }
+        emit_insn(&a, &ir->insns[i]);
+    }
+    emit_epilogue(&a);
+    return !out->failed && resolve_fixups(out);
+}
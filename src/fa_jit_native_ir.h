@@ -0,0 +1,172 @@
+#pragma once
+
+#include "fa_jit.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------- *
+ * Slot IR shared by the native backends.
+ *
+ * The frontend (fa_jit_native.c) validates a function body against the
+ * baseline subset and lowers it to a flat list of instructions over 64-bit
+ * slots: locals first, then one slot per operand-stack depth. Labels are
+ * plain indices. Backends only translate instructions; all stack tracking,
+ * block typing and branch-value movement already happened in the frontend.
+ *
+ * Slot contents: i64/f64 use all 64 bits, i32/f32 only the low 32 bits
+ * (upper bits are unspecified and never read).
+ * ------------------------------------------------------------------------- */
+
+typedef enum {
+    FA_NIR_LABEL = 0,        /* label */
+    FA_NIR_JUMP,             /* label */
+    FA_NIR_JUMP_IF_ZERO,     /* a (i32), label */
+    FA_NIR_JUMP_IF_NE_IMM,   /* a (i32) != imm -> label */
+    FA_NIR_TRAP,
+    FA_NIR_RETURN,           /* results already in slots [0, results) */
+    FA_NIR_CONST,            /* dst = imm */
+    FA_NIR_MOVE,             /* dst = a (64-bit copy) */
+    FA_NIR_IBIN,             /* dst = a <sub> b */
+    FA_NIR_ICMP,             /* dst (i32) = a <sub> b */
+    FA_NIR_IUNARY,           /* dst = <sub> a */
+    FA_NIR_FBIN,
+    FA_NIR_FUNARY,
+    FA_NIR_FCMP,
+    FA_NIR_CONVERT,          /* dst = <sub>(a) */
+    FA_NIR_LOAD,             /* dst = mem[a + imm] */
+    FA_NIR_STORE,            /* mem[a + imm] = b, sub = byte width */
+    FA_NIR_MEMORY_SIZE,      /* dst = pages */
+    FA_NIR_MEMORY_GROW,      /* dst = grow(a) */
+    FA_NIR_GLOBAL_GET,       /* dst = globals[imm] */
+    FA_NIR_GLOBAL_SET,       /* globals[imm] = a, wide selects 64-bit */
+    FA_NIR_SELECT,           /* dst = c ? a : b */
+    FA_NIR_CALL              /* call imm with arguments at slot a */
+} fa_JitNativeIrOp;
+
+typedef enum {
+    FA_NIR_ADD = 0, FA_NIR_SUB, FA_NIR_MUL, FA_NIR_AND, FA_NIR_OR, FA_NIR_XOR,
+    FA_NIR_SHL, FA_NIR_SHR_S, FA_NIR_SHR_U, FA_NIR_ROTL, FA_NIR_ROTR,
+    FA_NIR_DIV_S, FA_NIR_DIV_U, FA_NIR_REM_S, FA_NIR_REM_U
+} fa_JitNativeIrIntOp;
+
+typedef enum {
+    FA_NIR_EQ = 0, FA_NIR_NE, FA_NIR_LT_S, FA_NIR_LT_U, FA_NIR_GT_S, FA_NIR_GT_U,
+    FA_NIR_LE_S, FA_NIR_LE_U, FA_NIR_GE_S, FA_NIR_GE_U
+} fa_JitNativeIrIntCond;
+
+typedef enum {
+    FA_NIR_EQZ = 0, FA_NIR_CLZ, FA_NIR_CTZ
+} fa_JitNativeIrIntUnary;
+
+typedef enum {
+    FA_NIR_FADD = 0, FA_NIR_FSUB, FA_NIR_FMUL, FA_NIR_FDIV, FA_NIR_FCOPYSIGN
+} fa_JitNativeIrFloatOp;
+
+typedef enum {
+    FA_NIR_FABS = 0, FA_NIR_FNEG, FA_NIR_FSQRT
+} fa_JitNativeIrFloatUnary;
+
+/* Same order as the wasm opcodes (f32.eq .. f32.ge). */
+typedef enum {
+    FA_NIR_FEQ = 0, FA_NIR_FNE, FA_NIR_FLT, FA_NIR_FGT, FA_NIR_FLE, FA_NIR_FGE
+} fa_JitNativeIrFloatCond;
+
+typedef enum {
+    FA_NIR_I64_EXTEND_I32_S = 0,
+    FA_NIR_I64_EXTEND_I32_U,
+    FA_NIR_I32_EXTEND8_S,
+    FA_NIR_I32_EXTEND16_S,
+    FA_NIR_I64_EXTEND8_S,
+    FA_NIR_I64_EXTEND16_S,
+    FA_NIR_I64_EXTEND32_S,
+    FA_NIR_F32_DEMOTE_F64,
+    FA_NIR_F64_PROMOTE_F32,
+    FA_NIR_I32_TRUNC_F32_S,
+    FA_NIR_I32_TRUNC_F32_U,
+    FA_NIR_I32_TRUNC_F64_S,
+    FA_NIR_I32_TRUNC_F64_U,
+    FA_NIR_I64_TRUNC_F32_S,
+    FA_NIR_I64_TRUNC_F64_S,
+    FA_NIR_F32_CONVERT_I32_S,
+    FA_NIR_F32_CONVERT_I32_U,
+    FA_NIR_F32_CONVERT_I64_S,
+    FA_NIR_F64_CONVERT_I32_S,
+    FA_NIR_F64_CONVERT_I32_U,
+    FA_NIR_F64_CONVERT_I64_S
+} fa_JitNativeIrConvert;
+
+/* Same order as the wasm load opcodes 0x28..0x35 (f32/f64 loads are plain
+   32/64-bit loads). */
+typedef enum {
+    FA_NIR_LOAD_I32 = 0, FA_NIR_LOAD_I64, FA_NIR_LOAD_F32, FA_NIR_LOAD_F64,
+    FA_NIR_LOAD_I32_8S, FA_NIR_LOAD_I32_8U, FA_NIR_LOAD_I32_16S, FA_NIR_LOAD_I32_16U,
+    FA_NIR_LOAD_I64_8S, FA_NIR_LOAD_I64_8U, FA_NIR_LOAD_I64_16S, FA_NIR_LOAD_I64_16U,
+    FA_NIR_LOAD_I64_32S, FA_NIR_LOAD_I64_32U
+} fa_JitNativeIrLoad;
+
+typedef struct {
+    uint8_t op;
+    uint8_t sub;
+    bool wide; /* i64 / f64 operation */
+    uint32_t dst;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint32_t label;
+    uint64_t imm;
+} fa_JitNativeIrInsn;
+
+typedef struct {
+    fa_JitNativeIrInsn* insns;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t label_count;
+    uint32_t param_count;
+    uint32_t local_count;
+    uint32_t result_count;
+    uint32_t frame_slots; /* highest slot index used + 1 */
+    bool osr_entry;       /* entered mid-function: the prologue must not zero locals */
+    uint32_t osr_height;  /* slots live at the OSR loop header */
+} fa_JitNativeIr;
+
+bool fa_jit_native_build_ir(const fa_JitNativeRequest* request, fa_JitNativeIr* ir);
+void fa_jit_native_ir_free(fa_JitNativeIr* ir);
+
+/* ----- code buffer shared by the backends ----- */
+
+typedef struct {
+    size_t at;
+    uint32_t label;
+    uint8_t kind; /* backend-defined relocation kind */
+} fa_JitNativeFixup;
+
+typedef struct {
+    uint8_t* bytes;
+    size_t len;
+    size_t cap;
+    bool failed;
+    size_t* labels; /* bound offset + 1, 0 while unbound */
+    uint32_t label_count;
+    uint32_t label_cap;
+    fa_JitNativeFixup* fixups;
+    uint32_t fixup_count;
+    uint32_t fixup_cap;
+} fa_JitNativeBuffer;
+
+void fa_jit_native_buffer_free(fa_JitNativeBuffer* buffer);
+void fa_jit_native_buffer_u8(fa_JitNativeBuffer* buffer, uint8_t value);
+void fa_jit_native_buffer_u32(fa_JitNativeBuffer* buffer, uint32_t value);
+uint32_t fa_jit_native_buffer_label(fa_JitNativeBuffer* buffer);
+void fa_jit_native_buffer_bind(fa_JitNativeBuffer* buffer, uint32_t label);
+/* Records a relocation at the current offset; the backend emits the field. */
+void fa_jit_native_buffer_fixup(fa_JitNativeBuffer* buffer, uint32_t label, uint8_t kind);
+/* Label offset, or SIZE_MAX while unbound. */
+size_t fa_jit_native_buffer_label_offset(const fa_JitNativeBuffer* buffer, uint32_t label);
+
+/* Backends: translate `ir` into `out`, resolving their own fixups. IR label i
+   is buffer label i, so backends allocate their internal labels afterwards.
+   Both are plain byte emitters and build on every host. */
+bool fa_jit_native_lower_x86_64(const fa_JitNativeIr* ir, fa_JitNativeBuffer* out);
+bool fa_jit_native_lower_aarch64(const fa_JitNativeIr* ir, fa_JitNativeBuffer* out);
@@ -0,0 +1,715 @@
+#include "fa_jit_native_ir.h"
+#include "fa_runtime.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* ------------------------------------------------------------------------- *
+ * x86-64 native backend.
+ *
+ * Register plan (System V): rbx = slot base, rbp = fa_JitNativeContext*,
+ * rax/rcx/rdx/rsi/rdi and xmm0/xmm1 are scratch. Each IR instruction lowers
+ * to a short load/compute/store sequence against [rbx + 8*slot] with no
+ * register allocation. Branches use rel32 displacements.
+ * ------------------------------------------------------------------------- */
+
+enum {
+    RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7
+};
+
+enum {
+    CC_O = 0x0, CC_B = 0x2, CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5, CC_BE = 0x6, CC_A = 0x7,
+    CC_P = 0xA, CC_NP = 0xB, CC_L = 0xC, CC_GE = 0xD, CC_LE = 0xE, CC_G = 0xF
+};
+
+enum {
+    X64_FIXUP_REL32 = 0
+};
+
+typedef struct {
+    fa_JitNativeBuffer* buf;
+    const fa_JitNativeIr* ir;
+    uint32_t trap_label;
+    uint32_t exit_label;
+    uint32_t exit_nodepth_label;
+    uint32_t ret_label;
+    uint32_t overflow_label;
+} X64;
+
+/* ----- instruction encoding ----- */
+
+static void emit_u8(X64* x, uint8_t value) {
+    fa_jit_native_buffer_u8(x->buf, value);
+}
+
+static void emit_u32(X64* x, uint32_t value) {
+    fa_jit_native_buffer_u32(x->buf, value);
+}
+
+static void emit_u64(X64* x, uint64_t value) {
+    emit_u32(x, (uint32_t)value);
+    emit_u32(x, (uint32_t)(value >> 32));
+}
+
+static uint32_t new_label(X64* x) {
+    return fa_jit_native_buffer_label(x->buf);
+}
+
+static void bind(X64* x, uint32_t label) {
+    fa_jit_native_buffer_bind(x->buf, label);
+}
+
+static void rel32(X64* x, uint32_t label) {
+    fa_jit_native_buffer_fixup(x->buf, label, X64_FIXUP_REL32);
+    emit_u32(x, 0);
+}
+
+static void jmp(X64* x, uint32_t label) {
+    emit_u8(x, 0xE9);
+    rel32(x, label);
+}
+
+static void jcc(X64* x, uint8_t cc, uint32_t label) {
+    emit_u8(x, 0x0F);
+    emit_u8(x, (uint8_t)(0x80 | cc));
+    rel32(x, label);
+}
+
+static int32_t slot_disp(uint32_t slot) {
+    return (int32_t)(slot * 8U);
+}
+
+static void x64_opcode(X64* x, uint8_t prefix, bool w, uint32_t opcode, uint8_t opcode_len) {
+    if (prefix) {
+        emit_u8(x, prefix);
+    }
+    if (w) {
+        emit_u8(x, 0x48);
+    }
+    for (int i = (int)opcode_len - 1; i >= 0; --i) {
+        emit_u8(x, (uint8_t)(opcode >> (8 * i)));
+    }
+}
+
+/* [prefix] [REX.W] opcode... modrm(mod=10, reg, base) disp32. `base` is one of
+   rax/rcx/rdx/rbx/rbp/rsi/rdi (never rsp, which would need a SIB byte). */
+static void x64_mem(X64* x, uint8_t prefix, bool w, uint32_t opcode, uint8_t opcode_len,
+                    uint8_t reg, uint8_t base, int32_t disp) {
+    x64_opcode(x, prefix, w, opcode, opcode_len);
+    emit_u8(x, (uint8_t)(0x80 | ((reg & 7U) << 3) | (base & 7U)));
+    emit_u32(x, (uint32_t)disp);
+}
+
+static void x64_reg(X64* x, uint8_t prefix, bool w, uint32_t opcode, uint8_t opcode_len,
+                    uint8_t reg, uint8_t rm) {
+    x64_opcode(x, prefix, w, opcode, opcode_len);
+    emit_u8(x, (uint8_t)(0xC0 | ((reg & 7U) << 3) | (rm & 7U)));
+}
+
+/* Linear-memory operand [rcx + rax] (SIB, no displacement). */
+static void x64_heap(X64* x, uint8_t prefix, bool w, uint32_t opcode, uint8_t opcode_len, uint8_t reg) {
+    x64_opcode(x, prefix, w, opcode, opcode_len);
+    emit_u8(x, (uint8_t)(((reg & 7U) << 3) | 4U));
+    emit_u8(x, (uint8_t)((RAX << 3) | RCX));
+}
+
+static void load32(X64* x, uint8_t reg, uint32_t slot) {
+    x64_mem(x, 0, false, 0x8B, 1, reg, RBX, slot_disp(slot));
+}
+
+static void load64(X64* x, uint8_t reg, uint32_t slot) {
+    x64_mem(x, 0, true, 0x8B, 1, reg, RBX, slot_disp(slot));
+}
+
+static void store32(X64* x, uint32_t slot, uint8_t reg) {
+    x64_mem(x, 0, false, 0x89, 1, reg, RBX, slot_disp(slot));
+}
+
+static void store64(X64* x, uint32_t slot, uint8_t reg) {
+    x64_mem(x, 0, true, 0x89, 1, reg, RBX, slot_disp(slot));
+}
+
+static void mov_imm32(X64* x, uint8_t reg, uint32_t value) {
+    emit_u8(x, (uint8_t)(0xB8 + reg));
+    emit_u32(x, value);
+}
+
+static void mov_imm64(X64* x, uint8_t reg, uint64_t value) {
+    emit_u8(x, 0x48);
+    emit_u8(x, (uint8_t)(0xB8 + reg));
+    emit_u64(x, value);
+}
+
+static void ctx_load64(X64* x, uint8_t reg, size_t field) {
+    x64_mem(x, 0, true, 0x8B, 1, reg, RBP, (int32_t)field);
+}
+
+/* setcc al; movzx eax, al; store the i32 result. */
+static void set_bool(X64* x, uint8_t cc, uint32_t slot) {
+    x64_reg(x, 0, false, 0x0F90U | cc, 2, 0, RAX);
+    x64_reg(x, 0, false, 0x0FB6, 2, RAX, RAX);
+    store32(x, slot, RAX);
+}
+
+/* ----- integer operators ----- */
+
+static void emit_int_binary(X64* x, const fa_JitNativeIrInsn* insn, uint32_t opcode) {
+    const bool w = insn->wide;
+    x64_mem(x, 0, w, 0x8B, 1, RAX, RBX, slot_disp(insn->a));
+    x64_mem(x, 0, w, opcode, opcode > 0xFF ? 2 : 1, RAX, RBX, slot_disp(insn->b));
+    x64_mem(x, 0, w, 0x89, 1, RAX, RBX, slot_disp(insn->dst));
+}
+
+static void emit_shift(X64* x, const fa_JitNativeIrInsn* insn, uint8_t ext) {
+    const bool w = insn->wide;
+    x64_mem(x, 0, w, 0x8B, 1, RAX, RBX, slot_disp(insn->a));
+    load32(x, RCX, insn->b);
+    x64_reg(x, 0, w, 0xD3, 1, ext, RAX);
+    x64_mem(x, 0, w, 0x89, 1, RAX, RBX, slot_disp(insn->dst));
+}
+
+/* div/rem with the wasm traps: divide by zero, and INT_MIN / -1 for div_s
+   (rem_s of INT_MIN by -1 is defined as 0). */
+static void emit_divide(X64* x, const fa_JitNativeIrInsn* insn, bool is_signed, bool remainder) {
+    const bool w = insn->wide;
+    const uint32_t do_label = new_label(x);
+    const uint32_t done_label = new_label(x);
+    x64_mem(x, 0, w, 0x8B, 1, RAX, RBX, slot_disp(insn->a));
+    x64_mem(x, 0, w, 0x8B, 1, RCX, RBX, slot_disp(insn->b));
+    x64_reg(x, 0, w, 0x85, 1, RCX, RCX);
+    jcc(x, CC_E, x->trap_label);
+    if (is_signed) {
+        /* cmp rcx, -1 */
+        if (w) {
+            emit_u8(x, 0x48);
+        }
+        emit_u8(x, 0x83);
+        emit_u8(x, 0xF9);
+        emit_u8(x, 0xFF);
+        jcc(x, CC_NE, do_label);
+        if (remainder) {
+            x64_reg(x, 0, false, 0x31, 1, RDX, RDX);
+            jmp(x, done_label);
+        } else {
+            if (w) {
+                mov_imm64(x, RDX, 0x8000000000000000ULL);
+            } else {
+                mov_imm32(x, RDX, 0x80000000U);
+            }
+            x64_reg(x, 0, w, 0x39, 1, RDX, RAX);
+            jcc(x, CC_E, x->trap_label);
+        }
+        bind(x, do_label);
+        if (w) {
+            emit_u8(x, 0x48);
+        }
+        emit_u8(x, 0x99); /* cdq / cqo */
+        x64_reg(x, 0, w, 0xF7, 1, 7, RCX);
+    } else {
+        bind(x, do_label);
+        x64_reg(x, 0, false, 0x31, 1, RDX, RDX);
+        x64_reg(x, 0, w, 0xF7, 1, 6, RCX);
+    }
+    bind(x, done_label);
+    x64_mem(x, 0, w, 0x89, 1, remainder ? RDX : RAX, RBX, slot_disp(insn->dst));
+}
+
+static void emit_ibin(X64* x, const fa_JitNativeIrInsn* insn) {
+    switch (insn->sub) {
+        case FA_NIR_ADD: emit_int_binary(x, insn, 0x03); break;
+        case FA_NIR_SUB: emit_int_binary(x, insn, 0x2B); break;
+        case FA_NIR_MUL: emit_int_binary(x, insn, 0x0FAF); break;
+        case FA_NIR_AND: emit_int_binary(x, insn, 0x23); break;
+        case FA_NIR_OR: emit_int_binary(x, insn, 0x0B); break;
+        case FA_NIR_XOR: emit_int_binary(x, insn, 0x33); break;
+        case FA_NIR_SHL: emit_shift(x, insn, 4); break;
+        case FA_NIR_SHR_S: emit_shift(x, insn, 7); break;
+        case FA_NIR_SHR_U: emit_shift(x, insn, 5); break;
+        case FA_NIR_ROTL: emit_shift(x, insn, 0); break;
+        case FA_NIR_ROTR: emit_shift(x, insn, 1); break;
+        case FA_NIR_DIV_S: emit_divide(x, insn, true, false); break;
+        case FA_NIR_DIV_U: emit_divide(x, insn, false, false); break;
+        case FA_NIR_REM_S: emit_divide(x, insn, true, true); break;
+        default: emit_divide(x, insn, false, true); break;
+    }
+}
+
+static void emit_icmp(X64* x, const fa_JitNativeIrInsn* insn) {
+    static const uint8_t kConditions[] = {
+        CC_E, CC_NE, CC_L, CC_B, CC_G, CC_A, CC_LE, CC_BE, CC_GE, CC_AE
+    };
+    x64_mem(x, 0, insn->wide, 0x8B, 1, RAX, RBX, slot_disp(insn->a));
+    x64_mem(x, 0, insn->wide, 0x3B, 1, RAX, RBX, slot_disp(insn->b));
+    set_bool(x, kConditions[insn->sub], insn->dst);
+}
+
+static void emit_iunary(X64* x, const fa_JitNativeIrInsn* insn) {
+    const bool w = insn->wide;
+    if (insn->sub == FA_NIR_EQZ) {
+        x64_mem(x, 0, w, 0x8B, 1, RAX, RBX, slot_disp(insn->a));
+        x64_reg(x, 0, w, 0x85, 1, RAX, RAX);
+        set_bool(x, CC_E, insn->dst);
+        return;
+    }
+    const bool leading = insn->sub == FA_NIR_CLZ;
+    const uint32_t bits = w ? 64U : 32U;
+    /* bsr/bsf leave ZF set for zero input; cmov substitutes the wasm result. */
+    mov_imm32(x, RDX, leading ? (bits * 2U - 1U) : bits);
+    x64_mem(x, 0, w, leading ? 0x0FBDU : 0x0FBCU, 2, RAX, RBX, slot_disp(insn->a));
+    x64_reg(x, 0, w, 0x0F44, 2, RAX, RDX);
+    if (leading) {
+        emit_u8(x, 0x83);
+        emit_u8(x, 0xF0); /* xor eax, imm8 */
+        emit_u8(x, (uint8_t)(bits - 1U));
+    }
+    store64(x, insn->dst, RAX);
+}
+
+/* ----- float operators ----- */
+
+static void emit_fbin(X64* x, const fa_JitNativeIrInsn* insn) {
+    const bool f64 = insn->wide;
+    if (insn->sub == FA_NIR_FCOPYSIGN) {
+        if (f64) {
+            load64(x, RAX, insn->a);
+            x64_reg(x, 0, true, 0x0FBA, 2, 6, RAX); /* btr rax, 63 */
+            emit_u8(x, 63);
+            load64(x, RCX, insn->b);
+            x64_reg(x, 0, true, 0xC1, 1, 5, RCX); /* shr rcx, 63 */
+            emit_u8(x, 63);
+            x64_reg(x, 0, true, 0xC1, 1, 4, RCX); /* shl rcx, 63 */
+            emit_u8(x, 63);
+            x64_reg(x, 0, true, 0x09, 1, RCX, RAX);
+            store64(x, insn->dst, RAX);
+        } else {
+            load32(x, RAX, insn->a);
+            x64_reg(x, 0, false, 0x81, 1, 4, RAX);
+            emit_u32(x, 0x7FFFFFFFU);
+            load32(x, RCX, insn->b);
+            x64_reg(x, 0, false, 0x81, 1, 4, RCX);
+            emit_u32(x, 0x80000000U);
+            x64_reg(x, 0, false, 0x09, 1, RCX, RAX);
+            store32(x, insn->dst, RAX);
+        }
+        return;
+    }
+    static const uint8_t kOps[] = { 0x58, 0x5C, 0x59, 0x5E }; /* add sub mul div */
+    const uint8_t prefix = f64 ? 0xF2 : 0xF3;
+    x64_mem(x, prefix, false, 0x0F10, 2, 0, RBX, slot_disp(insn->a));
+    x64_mem(x, prefix, false, 0x0F00U | kOps[insn->sub], 2, 0, RBX, slot_disp(insn->b));
+    x64_mem(x, prefix, false, 0x0F11, 2, 0, RBX, slot_disp(insn->dst));
+}
+
+static void emit_funary(X64* x, const fa_JitNativeIrInsn* insn) {
+    const bool f64 = insn->wide;
+    if (insn->sub == FA_NIR_FSQRT) {
+        const uint8_t prefix = f64 ? 0xF2 : 0xF3;
+        x64_mem(x, prefix, false, 0x0F51, 2, 0, RBX, slot_disp(insn->a));
+        x64_mem(x, prefix, false, 0x0F11, 2, 0, RBX, slot_disp(insn->dst));
+        return;
+    }
+    const bool abs = insn->sub == FA_NIR_FABS;
+    if (f64) {
+        load64(x, RAX, insn->a);
+        x64_reg(x, 0, true, 0x0FBA, 2, abs ? 6 : 7, RAX); /* btr / btc rax, 63 */
+        emit_u8(x, 63);
+        store64(x, insn->dst, RAX);
+    } else {
+        load32(x, RAX, insn->a);
+        x64_reg(x, 0, false, 0x81, 1, abs ? 4 : 6, RAX); /* and / xor */
+        emit_u32(x, abs ? 0x7FFFFFFFU : 0x80000000U);
+        store32(x, insn->dst, RAX);
+    }
+}
+
+/* ucomis{s,d}: an unordered (NaN) compare sets ZF, PF and CF, so "above" and
+   "above or equal" are false for NaN; eq/ne additionally consult PF. */
+static void emit_fcmp(X64* x, const fa_JitNativeIrInsn* insn) {
+    const uint8_t prefix = insn->wide ? 0x66 : 0;
+    const uint8_t load_prefix = insn->wide ? 0xF2 : 0xF3;
+    uint32_t lhs = insn->a;
+    uint32_t rhs = insn->b;
+    uint8_t cc = CC_E;
+    switch (insn->sub) {
+        case FA_NIR_FEQ:
+        case FA_NIR_FNE:
+            break;
+        case FA_NIR_FLT: /* b > a */
+            lhs = insn->b;
+            rhs = insn->a;
+            cc = CC_A;
+            break;
+        case FA_NIR_FGT:
+            cc = CC_A;
+            break;
+        case FA_NIR_FLE: /* b >= a */
+            lhs = insn->b;
+            rhs = insn->a;
+            cc = CC_AE;
+            break;
+        default:
+            cc = CC_AE;
+            break;
+    }
+    x64_mem(x, load_prefix, false, 0x0F10, 2, 0, RBX, slot_disp(lhs));
+    x64_mem(x, prefix, false, 0x0F2E, 2, 0, RBX, slot_disp(rhs));
+    if (insn->sub == FA_NIR_FEQ || insn->sub == FA_NIR_FNE) {
+        const bool eq = insn->sub == FA_NIR_FEQ;
+        x64_reg(x, 0, false, 0x0F90U | (eq ? CC_E : CC_NE), 2, 0, RAX);
+        x64_reg(x, 0, false, 0x0F90U | (eq ? CC_NP : CC_P), 2, 0, RCX);
+        emit_u8(x, eq ? 0x20 : 0x08); /* and/or al, cl */
+        emit_u8(x, 0xC8);
+        x64_reg(x, 0, false, 0x0FB6, 2, RAX, RAX);
+        store32(x, insn->dst, RAX);
+    } else {
+        set_bool(x, cc, insn->dst);
+    }
+}
+
+/* ----- conversions ----- */
+
+/* Float -> int truncation with wasm trap semantics. The 64-bit cvtt result is
+   range-checked for i32 targets; i64 signed targets re-check the "indefinite"
+   INT64_MIN against the exact -2^63 input. */
+static void emit_truncate(X64* x, const fa_JitNativeIrInsn* insn, bool from_f64, bool to_i64, bool is_signed) {
+    const uint8_t prefix = from_f64 ? 0xF2 : 0xF3;
+    x64_mem(x, prefix, false, 0x0F10, 2, 0, RBX, slot_disp(insn->a));
+    x64_reg(x, prefix, true, 0x0F2C, 2, RAX, 0); /* cvtts?2si rax, xmm0 */
+    if (!to_i64) {
+        if (is_signed) {
+            x64_reg(x, 0, true, 0x63, 1, RCX, RAX); /* movsxd rcx, eax */
+            x64_reg(x, 0, true, 0x39, 1, RAX, RCX);
+            jcc(x, CC_NE, x->trap_label);
+        } else {
+            x64_reg(x, 0, true, 0x89, 1, RAX, RCX);
+            x64_reg(x, 0, true, 0xC1, 1, 5, RCX); /* shr rcx, 32 */
+            emit_u8(x, 32);
+            jcc(x, CC_NE, x->trap_label);
+        }
+        store32(x, insn->dst, RAX);
+        return;
+    }
+    const uint32_t ok_label = new_label(x);
+    mov_imm64(x, RCX, 0x8000000000000000ULL);
+    x64_reg(x, 0, true, 0x39, 1, RCX, RAX);
+    jcc(x, CC_NE, ok_label);
+    if (from_f64) {
+        mov_imm64(x, RCX, 0xC3E0000000000000ULL); /* -2^63 */
+        x64_reg(x, 0x66, true, 0x0F6E, 2, 1, RCX);  /* movq xmm1, rcx */
+        x64_reg(x, 0x66, false, 0x0F2E, 2, 0, 1);   /* ucomisd xmm0, xmm1 */
+    } else {
+        mov_imm32(x, RCX, 0xDF000000U);             /* -2^63f */
+        x64_reg(x, 0x66, false, 0x0F6E, 2, 1, RCX); /* movd xmm1, ecx */
+        x64_reg(x, 0, false, 0x0F2E, 2, 0, 1);      /* ucomiss xmm0, xmm1 */
+    }
+    jcc(x, CC_NE, x->trap_label);
+    jcc(x, CC_P, x->trap_label);
+    bind(x, ok_label);
+    store64(x, insn->dst, RAX);
+}
+
+static void emit_int_to_float(X64* x, const fa_JitNativeIrInsn* insn, bool to_f64, bool from_i64, bool is_signed) {
+    const uint8_t prefix = to_f64 ? 0xF2 : 0xF3;
+    if (from_i64) {
+        x64_mem(x, prefix, true, 0x0F2A, 2, 0, RBX, slot_disp(insn->a));
+    } else if (is_signed) {
+        x64_mem(x, prefix, false, 0x0F2A, 2, 0, RBX, slot_disp(insn->a));
+    } else {
+        load32(x, RAX, insn->a); /* zero-extends; convert as a signed 64-bit value */
+        x64_reg(x, prefix, true, 0x0F2A, 2, 0, RAX);
+    }
+    x64_mem(x, prefix, false, 0x0F11, 2, 0, RBX, slot_disp(insn->dst));
+}
+
+static void emit_convert(X64* x, const fa_JitNativeIrInsn* insn) {
+    switch (insn->sub) {
+        case FA_NIR_I64_EXTEND_I32_S:
+            x64_mem(x, 0, true, 0x63, 1, RAX, RBX, slot_disp(insn->a));
+            store64(x, insn->dst, RAX);
+            break;
+        case FA_NIR_I64_EXTEND_I32_U:
+            load32(x, RAX, insn->a);
+            store64(x, insn->dst, RAX);
+            break;
+        case FA_NIR_I32_EXTEND8_S:
+        case FA_NIR_I32_EXTEND16_S:
+        case FA_NIR_I64_EXTEND8_S:
+        case FA_NIR_I64_EXTEND16_S:
+        case FA_NIR_I64_EXTEND32_S: {
+            const bool w = insn->sub >= FA_NIR_I64_EXTEND8_S;
+            const uint32_t op = (insn->sub == FA_NIR_I32_EXTEND8_S || insn->sub == FA_NIR_I64_EXTEND8_S) ? 0x0FBEU
+                                : (insn->sub == FA_NIR_I64_EXTEND32_S ? 0x63U : 0x0FBFU);
+            x64_mem(x, 0, w, op, op > 0xFF ? 2 : 1, RAX, RBX, slot_disp(insn->a));
+            store64(x, insn->dst, RAX);
+            break;
+        }
+        case FA_NIR_F32_DEMOTE_F64:
+        case FA_NIR_F64_PROMOTE_F32: {
+            /* cvtsd2ss / cvtss2sd */
+            const bool demote = insn->sub == FA_NIR_F32_DEMOTE_F64;
+            x64_mem(x, demote ? 0xF2 : 0xF3, false, 0x0F5A, 2, 0, RBX, slot_disp(insn->a));
+            x64_mem(x, demote ? 0xF3 : 0xF2, false, 0x0F11, 2, 0, RBX, slot_disp(insn->dst));
+            break;
+        }
+        case FA_NIR_I32_TRUNC_F32_S: emit_truncate(x, insn, false, false, true); break;
+        case FA_NIR_I32_TRUNC_F32_U: emit_truncate(x, insn, false, false, false); break;
+        case FA_NIR_I32_TRUNC_F64_S: emit_truncate(x, insn, true, false, true); break;
+        case FA_NIR_I32_TRUNC_F64_U: emit_truncate(x, insn, true, false, false); break;
+        case FA_NIR_I64_TRUNC_F32_S: emit_truncate(x, insn, false, true, true); break;
+        case FA_NIR_I64_TRUNC_F64_S: emit_truncate(x, insn, true, true, true); break;
+        case FA_NIR_F32_CONVERT_I32_S: emit_int_to_float(x, insn, false, false, true); break;
+        case FA_NIR_F32_CONVERT_I32_U: emit_int_to_float(x, insn, false, false, false); break;
+        case FA_NIR_F32_CONVERT_I64_S: emit_int_to_float(x, insn, false, true, true); break;
+        case FA_NIR_F64_CONVERT_I32_S: emit_int_to_float(x, insn, true, false, true); break;
+        case FA_NIR_F64_CONVERT_I32_U: emit_int_to_float(x, insn, true, false, false); break;
+        default: emit_int_to_float(x, insn, true, true, true); break;
+    }
+}
+
+/* ----- memory, globals, calls ----- */
+
+/* rax = effective address; traps unless [rax, rax + bytes) is inside memory 0,
+   then leaves the memory base in rcx. */
+static void emit_address(X64* x, uint32_t addr_slot, uint32_t offset, uint32_t bytes) {
+    load32(x, RAX, addr_slot);
+    if (offset != 0) {
+        mov_imm32(x, RCX, offset);
+        x64_reg(x, 0, true, 0x01, 1, RCX, RAX);
+    }
+    x64_mem(x, 0, true, 0x8D, 1, RDX, RAX, (int32_t)bytes);
+    ctx_load64(x, RCX, offsetof(fa_JitNativeContext, memory));
+    x64_mem(x, 0, true, 0x3B, 1, RDX, RCX, (int32_t)offsetof(fa_RuntimeMemory, size_bytes));
+    jcc(x, CC_A, x->trap_label);
+    x64_mem(x, 0, true, 0x8B, 1, RCX, RCX, (int32_t)offsetof(fa_RuntimeMemory, data));
+    x64_reg(x, 0, true, 0x85, 1, RCX, RCX);
+    jcc(x, CC_E, x->trap_label);
+}
+
+static void emit_load(X64* x, const fa_JitNativeIrInsn* insn) {
+    static const uint8_t kBytes[] = { 4, 8, 4, 8, 1, 1, 2, 2, 1, 1, 2, 2, 4, 4 };
+    emit_address(x, insn->a, (uint32_t)insn->imm, kBytes[insn->sub]);
+    switch (insn->sub) {
+        case FA_NIR_LOAD_I32: case FA_NIR_LOAD_F32: case FA_NIR_LOAD_I64_32U:
+            x64_heap(x, 0, false, 0x8B, 1, RAX);
+            break;
+        case FA_NIR_LOAD_I64: case FA_NIR_LOAD_F64:
+            x64_heap(x, 0, true, 0x8B, 1, RAX);
+            break;
+        case FA_NIR_LOAD_I32_8S: x64_heap(x, 0, false, 0x0FBE, 2, RAX); break;
+        case FA_NIR_LOAD_I32_8U: case FA_NIR_LOAD_I64_8U: x64_heap(x, 0, false, 0x0FB6, 2, RAX); break;
+        case FA_NIR_LOAD_I32_16S: x64_heap(x, 0, false, 0x0FBF, 2, RAX); break;
+        case FA_NIR_LOAD_I32_16U: case FA_NIR_LOAD_I64_16U: x64_heap(x, 0, false, 0x0FB7, 2, RAX); break;
+        case FA_NIR_LOAD_I64_8S: x64_heap(x, 0, true, 0x0FBE, 2, RAX); break;
+        case FA_NIR_LOAD_I64_16S: x64_heap(x, 0, true, 0x0FBF, 2, RAX); break;
+        default: x64_heap(x, 0, true, 0x63, 1, RAX); break; /* i64.load32_s */
+    }
+    store64(x, insn->dst, RAX);
+}
+
+static void emit_store(X64* x, const fa_JitNativeIrInsn* insn) {
+    emit_address(x, insn->a, (uint32_t)insn->imm, insn->sub);
+    load64(x, RDX, insn->b);
+    switch (insn->sub) {
+        case 1: x64_heap(x, 0, false, 0x88, 1, RDX); break;
+        case 2: x64_heap(x, 0x66, false, 0x89, 1, RDX); break;
+        case 4: x64_heap(x, 0, false, 0x89, 1, RDX); break;
+        default: x64_heap(x, 0, true, 0x89, 1, RDX); break;
+    }
+}
+
+static int32_t global_disp(uint64_t index) {
+    return (int32_t)(index * sizeof(fa_JobValue) + offsetof(fa_JobValue, payload));
+}
+
+static void emit_call(X64* x, const fa_JitNativeIrInsn* insn) {
+    const uint32_t function_index = (uint32_t)insn->imm;
+    const uint32_t slow_label = new_label(x);
+    const uint32_t done_label = new_label(x);
+    x64_reg(x, 0, true, 0x89, 1, RBP, RDI);                     /* mov rdi, rbp */
+    x64_mem(x, 0, true, 0x8D, 1, RSI, RBX, slot_disp(insn->a)); /* lea rsi, [rbx + base] */
+    ctx_load64(x, RAX, offsetof(fa_JitNativeContext, entries));
+    x64_mem(x, 0, true, 0x8B, 1, RAX, RAX, (int32_t)(function_index * sizeof(fa_JitNativeEntry)));
+    x64_reg(x, 0, true, 0x85, 1, RAX, RAX);
+    jcc(x, CC_E, slow_label);
+    x64_reg(x, 0, false, 0xFF, 1, 2, RAX);                      /* call rax */
+    jmp(x, done_label);
+    bind(x, slow_label);
+    mov_imm32(x, RDX, function_index);
+    x64_mem(x, 0, false, 0xFF, 1, 2, RBP, (int32_t)offsetof(fa_JitNativeContext, call_slow));
+    bind(x, done_label);
+    x64_reg(x, 0, false, 0x85, 1, RAX, RAX);
+    jcc(x, CC_NE, x->exit_label);
+}
+
+static void emit_insn(X64* x, const fa_JitNativeIrInsn* insn) {
+    switch (insn->op) {
+        case FA_NIR_LABEL:
+            bind(x, insn->label);
+            break;
+        case FA_NIR_JUMP:
+            jmp(x, insn->label);
+            break;
+        case FA_NIR_JUMP_IF_ZERO:
+            load32(x, RAX, insn->a);
+            x64_reg(x, 0, false, 0x85, 1, RAX, RAX);
+            jcc(x, CC_E, insn->label);
+            break;
+        case FA_NIR_JUMP_IF_NE_IMM:
+            load32(x, RAX, insn->a);
+            emit_u8(x, 0x3D); /* cmp eax, imm32 */
+            emit_u32(x, (uint32_t)insn->imm);
+            jcc(x, CC_NE, insn->label);
+            break;
+        case FA_NIR_TRAP:
+            jmp(x, x->trap_label);
+            break;
+        case FA_NIR_RETURN:
+            jmp(x, x->ret_label);
+            break;
+        case FA_NIR_CONST:
+            if (insn->wide) {
+                mov_imm64(x, RAX, insn->imm);
+                store64(x, insn->dst, RAX);
+            } else {
+                x64_mem(x, 0, false, 0xC7, 1, 0, RBX, slot_disp(insn->dst));
+                emit_u32(x, (uint32_t)insn->imm);
+            }
+            break;
+        case FA_NIR_MOVE:
+            load64(x, RAX, insn->a);
+            store64(x, insn->dst, RAX);
+            break;
+        case FA_NIR_IBIN: emit_ibin(x, insn); break;
+        case FA_NIR_ICMP: emit_icmp(x, insn); break;
+        case FA_NIR_IUNARY: emit_iunary(x, insn); break;
+        case FA_NIR_FBIN: emit_fbin(x, insn); break;
+        case FA_NIR_FUNARY: emit_funary(x, insn); break;
+        case FA_NIR_FCMP: emit_fcmp(x, insn); break;
+        case FA_NIR_CONVERT: emit_convert(x, insn); break;
+        case FA_NIR_LOAD: emit_load(x, insn); break;
+        case FA_NIR_STORE: emit_store(x, insn); break;
+        case FA_NIR_MEMORY_SIZE:
+            ctx_load64(x, RCX, offsetof(fa_JitNativeContext, memory));
+            x64_mem(x, 0, true, 0x8B, 1, RAX, RCX, (int32_t)offsetof(fa_RuntimeMemory, size_bytes));
+            x64_reg(x, 0, true, 0xC1, 1, 5, RAX); /* shr rax, 16 */
+            emit_u8(x, 16);
+            store32(x, insn->dst, RAX);
+            break;
+        case FA_NIR_MEMORY_GROW:
+            x64_reg(x, 0, true, 0x89, 1, RBP, RDI);
+            load32(x, RSI, insn->a);
+            x64_mem(x, 0, false, 0xFF, 1, 2, RBP, (int32_t)offsetof(fa_JitNativeContext, memory_grow));
+            store32(x, insn->dst, RAX);
+            break;
+        case FA_NIR_GLOBAL_GET:
+            ctx_load64(x, RCX, offsetof(fa_JitNativeContext, globals));
+            x64_mem(x, 0, true, 0x8B, 1, RAX, RCX, global_disp(insn->imm));
+            store64(x, insn->dst, RAX);
+            break;
+        case FA_NIR_GLOBAL_SET:
+            ctx_load64(x, RCX, offsetof(fa_JitNativeContext, globals));
+            load64(x, RAX, insn->a);
+            x64_mem(x, 0, insn->wide, 0x89, 1, RAX, RCX, global_disp(insn->imm));
+            break;
+        case FA_NIR_SELECT:
+            load32(x, RCX, insn->c);
+            load64(x, RAX, insn->a);
+            x64_reg(x, 0, false, 0x85, 1, RCX, RCX);
+            x64_mem(x, 0, true, 0x0F44, 2, RAX, RBX, slot_disp(insn->b)); /* cmovz rax, [b] */
+            store64(x, insn->dst, RAX);
+            break;
+        case FA_NIR_CALL:
+            emit_call(x, insn);
+            break;
+        default:
+            x->buf->failed = true;
+            break;
+    }
+}
+
+/* ----- prologue / epilogue ----- */
+
+static void emit_prologue(X64* x) {
+    const fa_JitNativeIr* ir = x->ir;
+    emit_u8(x, 0x53);                       /* push rbx */
+    emit_u8(x, 0x55);                       /* push rbp */
+    emit_u8(x, 0x48); emit_u8(x, 0x83); emit_u8(x, 0xEC); emit_u8(x, 0x08); /* sub rsp, 8 */
+    x64_reg(x, 0, true, 0x89, 1, RDI, RBP); /* mov rbp, rdi */
+    x64_reg(x, 0, true, 0x89, 1, RSI, RBX); /* mov rbx, rsi */
+    /* lea rax, [rbx + frame_bytes]; cmp rax, [rbp + slot_limit]; ja overflow */
+    x64_mem(x, 0, true, 0x8D, 1, RAX, RBX, slot_disp(ir->frame_slots));
+    x64_mem(x, 0, true, 0x3B, 1, RAX, RBP, (int32_t)offsetof(fa_JitNativeContext, slot_limit));
+    jcc(x, CC_A, x->overflow_label);
+    x64_mem(x, 0, false, 0x8B, 1, RAX, RBP, (int32_t)offsetof(fa_JitNativeContext, depth));
+    x64_mem(x, 0, false, 0x3B, 1, RAX, RBP, (int32_t)offsetof(fa_JitNativeContext, max_depth));
+    jcc(x, CC_AE, x->overflow_label);
+    x64_mem(x, 0, false, 0x83, 1, 0, RBP, (int32_t)offsetof(fa_JitNativeContext, depth)); /* add dword, 1 */
+    emit_u8(x, 1);
+    if (!ir->osr_entry && ir->local_count > ir->param_count) {
+        x64_mem(x, 0, true, 0x8D, 1, RDI, RBX, slot_disp(ir->param_count));
+        mov_imm32(x, RCX, ir->local_count - ir->param_count);
+        x64_reg(x, 0, false, 0x31, 1, RAX, RAX);
+        emit_u8(x, 0xF3); emit_u8(x, 0x48); emit_u8(x, 0xAB); /* rep stosq */
+    }
+}
+
+static void emit_epilogue(X64* x) {
+    bind(x, x->ret_label);
+    x64_reg(x, 0, false, 0x31, 1, RAX, RAX);
+    bind(x, x->exit_label);
+    x64_mem(x, 0, false, 0x83, 1, 5, RBP, (int32_t)offsetof(fa_JitNativeContext, depth)); /* sub dword, 1 */
+    emit_u8(x, 1);
+    bind(x, x->exit_nodepth_label);
+    emit_u8(x, 0x48); emit_u8(x, 0x83); emit_u8(x, 0xC4); emit_u8(x, 0x08); /* add rsp, 8 */
+    emit_u8(x, 0x5D);                       /* pop rbp */
+    emit_u8(x, 0x5B);                       /* pop rbx */
+    emit_u8(x, 0xC3);                       /* ret */
+    bind(x, x->trap_label);
+    mov_imm32(x, RAX, (uint32_t)FA_RUNTIME_ERR_TRAP);
+    jmp(x, x->exit_label);
+    bind(x, x->overflow_label);
+    mov_imm32(x, RAX, (uint32_t)FA_RUNTIME_ERR_CALL_DEPTH_EXCEEDED);
+    jmp(x, x->exit_nodepth_label);
+}
+
+static bool resolve_fixups(fa_JitNativeBuffer* buf) {
+    for (uint32_t i = 0; i < buf->fixup_count; ++i) {
+        const fa_JitNativeFixup* fixup = &buf->fixups[i];
+        const size_t target = fa_jit_native_buffer_label_offset(buf, fixup->label);
+        if (target == SIZE_MAX || fixup->kind != X64_FIXUP_REL32) {
+            return false;
+        }
+        const int32_t rel = (int32_t)((int64_t)target - (int64_t)(fixup->at + 4U));
+        for (int b = 0; b < 4; ++b) {
+            buf->bytes[fixup->at + (size_t)b] = (uint8_t)((uint32_t)rel >> (8 * b));
+        }
+    }
+    return true;
+}
+
+bool fa_jit_native_lower_x86_64(const fa_JitNativeIr* ir, fa_JitNativeBuffer* out) {
+    if (!ir || !out) {
+        return false;
+    }
+    X64 x;
+    memset(&x, 0, sizeof(x));
+    x.buf = out;
+    x.ir = ir;
+    for (uint32_t i = 0; i < ir->label_count; ++i) {
+        (void)new_label(&x);
+    }
+    x.trap_label = new_label(&x);
+    x.exit_label = new_label(&x);
+    x.exit_nodepth_label = new_label(&x);
+    x.ret_label = new_label(&x);
+    x.overflow_label = new_label(&x);
+    emit_prologue(&x);
+    for (uint32_t i = 0; i < ir->count && !out->failed; ++i) {
+        if (ir->insns[i].op == FA_NIR_RETURN && i + 1U == ir->count) {
+            break; /* the epilogue follows directly */
+        }
+        emit_insn(&x, &ir->insns[i]);
+    }
+    emit_epilogue(&x);
+    return !out->failed && resolve_fixups(out);
+}
@@ -0,0 +1,233 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include "fa_jit_persist.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__APPLE__) || defined(__unix__) || defined(__linux__)) && \
+    !defined(FAYASM_TARGET_ESP32) && !defined(ESP_PLATFORM)
+#include <sys/stat.h>
+#include <unistd.h>
+#define FA_JIT_PERSIST_POSIX 1
+#endif
+
+#define PERSIST_FNV_OFFSET 0xCBF29CE484222325ULL
+#define PERSIST_FNV_PRIME  0x00000100000001B3ULL
+
+static uint64_t persist_checksum(const uint8_t* data, size_t size) {
+    uint64_t hash = PERSIST_FNV_OFFSET;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= PERSIST_FNV_PRIME;
+    }
+    return hash;
+}
+
+bool fa_jit_persist_path(const char* dir, const fa_JitPersistKey* key, char* out, size_t capacity) {
+    if (!dir || dir[0] == '\0' || !key || !out || capacity == 0) {
+        return false;
+    }
+    const size_t dir_len = strlen(dir);
+    const char* sep = dir[dir_len - 1] == '/' ? "" : "/";
+    uint64_t prefix = 0;
+    for (int i = 0; i < 8; ++i) {
+        prefix = (prefix << 8) | key->module_digest[i];
+    }
+    const int written = snprintf(out, capacity, "%s%s%016" PRIx64 "-%08" PRIx32 "-%c%c%c-f%" PRIu32 ".fyc",
+                                 dir, sep, prefix, key->abi,
+                                 key->tier == (uint8_t)FA_JIT_TIER_NATIVE ? 'n' : 'c',
+                                 key->arch == (uint8_t)FA_JIT_NATIVE_ARCH_AARCH64 ? 'a' : 'x',
+                                 key->memory_flat ? 'f' : 'p',
+                                 key->func_index);
+    return written > 0 && (size_t)written < capacity;
+}
+
+bool fa_jit_persist_encode(const fa_JitPersistKey* key,
+                           uint32_t frame_slots,
+                           const uint8_t* data,
+                           size_t data_bytes,
+                           uint8_t** blob_out,
+                           size_t* blob_bytes_out) {
+    if (blob_out) {
+        *blob_out = NULL;
+    }
+    if (blob_bytes_out) {
+        *blob_bytes_out = 0;
+    }
+    if (!key || !data || data_bytes == 0 || !blob_out || !blob_bytes_out) {
+        return false;
+    }
+    const size_t payload = FA_JIT_PERSIST_KEY_BYTES + data_bytes;
+    const size_t total = FA_SPILL_HEADER_BYTES + payload;
+    uint8_t* blob = (uint8_t*)malloc(total);
+    if (!blob) {
+        return false;
+    }
+    (void)fa_spill_write_header(blob, total, (uint16_t)FA_SPILL_KIND_JIT_CODE, (uint64_t)payload);
+    uint8_t* p = blob + FA_SPILL_HEADER_BYTES;
+    memcpy(p, key->module_digest, FA_SHA256_BYTES);
+    fa_spill_put_u32(p + 32, key->abi);
+    fa_spill_put_u32(p + 36, key->func_index);
+    p[40] = key->tier;
+    p[41] = key->arch;
+    p[42] = key->memory_flat ? 1u : 0u;
+    p[43] = 0u;
+    fa_spill_put_u32(p + 44, frame_slots);
+    fa_spill_put_u64(p + 48, persist_checksum(data, data_bytes));
+    memcpy(p + FA_JIT_PERSIST_KEY_BYTES, data, data_bytes);
+    *blob_out = blob;
+    *blob_bytes_out = total;
+    return true;
+}
+
+bool fa_jit_persist_decode(const uint8_t* blob,
+                           size_t blob_bytes,
+                           const fa_JitPersistKey* key,
+                           uint32_t* frame_slots_out,
+                           const uint8_t** data_out,
+                           size_t* data_bytes_out) {
+    if (!key || !frame_slots_out || !data_out || !data_bytes_out) {
+        return false;
+    }
+    uint16_t kind = 0;
+    uint64_t payload = 0;
+    if (!fa_spill_read_header(blob, blob_bytes, &kind, &payload) || kind != (uint16_t)FA_SPILL_KIND_JIT_CODE ||
+        payload <= FA_JIT_PERSIST_KEY_BYTES) {
+        return false;
+    }
+    const uint8_t* p = blob + FA_SPILL_HEADER_BYTES;
+    if (memcmp(p, key->module_digest, FA_SHA256_BYTES) != 0 || fa_spill_get_u32(p + 32) != key->abi ||
+        fa_spill_get_u32(p + 36) != key->func_index || p[40] != key->tier || p[41] != key->arch ||
+        p[42] != (key->memory_flat ? 1u : 0u)) {
+        return false;
+    }
+    const uint8_t* data = p + FA_JIT_PERSIST_KEY_BYTES;
+    const size_t data_bytes = (size_t)payload - FA_JIT_PERSIST_KEY_BYTES;
+    if (persist_checksum(data, data_bytes) != fa_spill_get_u64(p + 48)) {
+        return false;
+    }
+    *frame_slots_out = fa_spill_get_u32(p + 44);
+    *data_out = data;
+    *data_bytes_out = data_bytes;
+    return true;
+}
+
+bool fa_jit_persist_dir_trusted(const char* dir) {
+    if (!dir || dir[0] == '\0') {
+        return false;
+    }
+#if defined(FA_JIT_PERSIST_POSIX)
+    struct stat st;
+    if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return false;
+    }
+    return st.st_uid == geteuid() && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#else
+    return true;
+#endif
+}
+
+bool fa_jit_persist_publish(const char* path, const uint8_t* data, size_t size) {
+    if (!path || path[0] == '\0' || (!data && size > 0)) {
+        return false;
+    }
+    const size_t path_len = strlen(path);
+    char* temp = (char*)malloc(path_len + 8u);
+    if (!temp) {
+        return false;
+    }
+    memcpy(temp, path, path_len);
+#if defined(FA_JIT_PERSIST_POSIX)
+    /* A unique name per writer: two processes storing the same entry never
+       share (and truncate) one temporary. */
+    memcpy(temp + path_len, ".XXXXXX", 8u);
+    const int fd = mkstemp(temp);
+    /* mkstemp creates 0600; keep the read access fopen would have given. */
+    FILE* file = fd >= 0 && fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) == 0 ? fdopen(fd, "wb") : NULL;
+    if (fd >= 0 && !file) {
+        (void)close(fd);
+        (void)remove(temp);
+    }
+#else
+    memcpy(temp + path_len, ".tmp", 5u);
+    FILE* file = fopen(temp, "wb");
+#endif
+    if (!file) {
+        free(temp);
+        return false;
+    }
+    const bool written = fwrite(data, 1, size, file) == size;
+    bool ok = fclose(file) == 0 && written;
+    /* Readers only ever see a complete file: a crash mid-write leaves the
+       temporary behind, never a truncated entry under the real name, and
+       rename replaces an existing entry without a window where it is gone. */
+    if (ok && rename(temp, path) != 0) {
+#if defined(FA_JIT_PERSIST_POSIX)
+        ok = false;
+#else
+        /* Some embedded filesystems refuse to rename over an existing file. */
+        (void)remove(path);
+        ok = rename(temp, path) == 0;
+#endif
+    }
+    if (!ok) {
+        (void)remove(temp);
+    }
+    free(temp);
+    return ok;
+}
+
+bool fa_jit_persist_store(const char* dir,
+                          const fa_JitPersistKey* key,
+                          uint32_t frame_slots,
+                          const uint8_t* data,
+                          size_t data_bytes) {
+    char path[FA_JIT_PERSIST_PATH_MAX];
+    if (!fa_jit_persist_path(dir, key, path, sizeof(path)) || !fa_jit_persist_dir_trusted(dir)) {
+        return false;
+    }
+    uint8_t* blob = NULL;
+    size_t blob_bytes = 0;
+    if (!fa_jit_persist_encode(key, frame_slots, data, data_bytes, &blob, &blob_bytes)) {
+        return false;
+    }
+    const bool ok = fa_jit_persist_publish(path, blob, blob_bytes);
+    free(blob);
+    return ok;
+}
+
+uint8_t* fa_jit_persist_read(const char* dir, const fa_JitPersistKey* key, size_t* blob_bytes_out) {
+    if (blob_bytes_out) {
+        *blob_bytes_out = 0;
+    }
+    char path[FA_JIT_PERSIST_PATH_MAX];
+    if (!blob_bytes_out || !fa_jit_persist_path(dir, key, path, sizeof(path)) ||
+        !fa_jit_persist_dir_trusted(dir)) {
+        return NULL;
+    }
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    uint8_t* blob = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        size = ftell(file);
+    }
+    if (size > (long)FA_SPILL_HEADER_BYTES && fseek(file, 0, SEEK_SET) == 0) {
+        blob = (uint8_t*)malloc((size_t)size);
+        if (blob && fread(blob, 1, (size_t)size, file) != (size_t)size) {
+            free(blob);
+            blob = NULL;
+        }
+    }
+    fclose(file);
+    if (blob) {
+        *blob_bytes_out = (size_t)size;
+    }
+    return blob;
+}
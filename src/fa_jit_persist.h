@@ -0,0 +1,93 @@
+#pragma once
+
+#include "fa_jit.h"
+#include "fa_sha256.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------- *
+ * Persisted compiled-code cache.
+ *
+ * Native machine code is position independent (every call, memory access and
+ * helper goes through fa_JitNativeContext) and closure records persist as
+ * handler triples, so both survive a restart byte for byte. One file per
+ * function holds the shared spill envelope (kind FA_SPILL_KIND_JIT_CODE)
+ * followed by the key it was compiled under:
+ *
+ *   offset 0   u8[32] module_digest (wasm_module_content_digest, SHA-256)
+ *   offset 32  u32  abi          (FA_JIT_PERSIST_ABI_VERSION + context layout)
+ *   offset 36  u32  func_index
+ *   offset 40  u8   tier         (FA_JIT_TIER_NATIVE / FA_JIT_TIER_CLOSURE)
+ *   offset 41  u8   arch         (fa_JitNativeArch, native code only)
+ *   offset 42  u8   memory_flat
+ *   offset 43  u8   reserved (0)
+ *   offset 44  u32  frame_slots
+ *   offset 48  u64  checksum     (FNV-1a of the data)
+ *   offset 56  ...  data: machine code, or a FA_SPILL_KIND_JIT_CLOSURES blob
+ *
+ * A file whose key or checksum does not match is ignored (and overwritten by
+ * the next compile), so a rebuilt runtime or an edited module never picks up
+ * stale code. The module is identified by its full SHA-256 digest: generated
+ * code indexes the entry and global tables by the module's own indices, so
+ * adopting code compiled for a colliding module would escape the sandbox.
+ * The checksum only catches accidental damage. Writes go to a unique temporary name and are renamed into
+ * place. Native code read back is mapped executable, so the directory must
+ * belong to the current user and not be group- or world-writable; any other
+ * directory is neither read nor written.
+ * ------------------------------------------------------------------------- */
+
+/* Bump whenever generated code or the closure handler tables change meaning
+   without the context layout changing. */
+#define FA_JIT_PERSIST_ABI_VERSION 2u
+#define FA_JIT_PERSIST_KEY_BYTES   56u
+#ifndef FA_JIT_PERSIST_PATH_MAX
+#define FA_JIT_PERSIST_PATH_MAX    512u
+#endif
+
+typedef struct {
+    uint8_t module_digest[FA_SHA256_BYTES];
+    uint32_t abi;
+    uint32_t func_index;
+    uint8_t tier;
+    uint8_t arch;
+    bool memory_flat;
+} fa_JitPersistKey;
+
+/* "<dir>/<digest prefix>-<abi>-<tier><arch><flat>-f<func_index>.fyc". Returns
+   false when it does not fit in `capacity`. */
+bool fa_jit_persist_path(const char* dir, const fa_JitPersistKey* key, char* out, size_t capacity);
+
+/* Builds the file image for `data` into a malloc'd buffer. */
+bool fa_jit_persist_encode(const fa_JitPersistKey* key,
+                           uint32_t frame_slots,
+                           const uint8_t* data,
+                           size_t data_bytes,
+                           uint8_t** blob_out,
+                           size_t* blob_bytes_out);
+/* Validates `blob` against `key` and points `data_out` into it. */
+bool fa_jit_persist_decode(const uint8_t* blob,
+                           size_t blob_bytes,
+                           const fa_JitPersistKey* key,
+                           uint32_t* frame_slots_out,
+                           const uint8_t** data_out,
+                           size_t* data_bytes_out);
+
+/* True when `dir` is a directory owned by the effective user that neither
+   its group nor others can write. Always true where there are no users. */
+bool fa_jit_persist_dir_trusted(const char* dir);
+/* Writes `data` to a fresh temporary next to `path` and renames it over
+   `path`, so readers see the old file or the new one and nothing between. */
+bool fa_jit_persist_publish(const char* path, const uint8_t* data, size_t size);
+
+/* Encodes and publishes the entry for `key`; false for an untrusted `dir`. */
+bool fa_jit_persist_store(const char* dir,
+                          const fa_JitPersistKey* key,
+                          uint32_t frame_slots,
+                          const uint8_t* data,
+                          size_t data_bytes);
+/* Reads the file for `key` into a malloc'd buffer (the whole file image; use
+   fa_jit_persist_decode on it). NULL when missing, unreadable, or `dir` is
+   not trusted. */
+uint8_t* fa_jit_persist_read(const char* dir, const fa_JitPersistKey* key, size_t* blob_bytes_out);
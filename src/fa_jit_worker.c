@@ -0,0 +1,254 @@
+#include "fa_jit_worker.h"
+#include "fa_ops.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(FA_JIT_WORKERS_HOST)
+#include <pthread.h>
+#endif
+
+void fa_jit_task_free(fa_JitTask* task) {
+    if (!task) {
+        return;
+    }
+    free(task->opcodes);
+    free((void*)task->request.body);
+    free(task->body);
+    if (task->release) {
+        task->release(task->user);
+    }
+    fa_jit_program_free(&task->program);
+    free(task->code);
+    free(task);
+}
+
+static void jit_task_run(fa_JitTask* task) {
+    switch (task->kind) {
+        case FA_JIT_TASK_MICROCODE:
+            task->ok = fa_jit_prepare_program_from_opcodes(task->opcodes, task->opcode_count, &task->program);
+            break;
+        case FA_JIT_TASK_NATIVE:
+            task->ok = fa_jit_native_emit(&task->request, FA_JIT_NATIVE_ARCH_HOST,
+                                          &task->code, &task->code_bytes, &task->frame_slots);
+            break;
+        case FA_JIT_TASK_PRESCAN:
+            task->status = task->prescan ? task->prescan(task) : -1;
+            break;
+        default:
+            task->ok = false;
+            break;
+    }
+}
+
+#if !defined(FA_JIT_WORKERS_HOST)
+
+bool fa_jit_workers_supported(void) {
+    return false;
+}
+
+fa_JitWorkerPool* fa_jit_workers_create(uint32_t thread_count) {
+    (void)thread_count;
+    (void)jit_task_run;
+    return NULL;
+}
+
+void fa_jit_workers_destroy(fa_JitWorkerPool* pool) {
+    (void)pool;
+}
+
+bool fa_jit_workers_submit(fa_JitWorkerPool* pool, fa_JitTask* task) {
+    (void)pool;
+    (void)task;
+    return false;
+}
+
+bool fa_jit_workers_has_done(fa_JitWorkerPool* pool) {
+    (void)pool;
+    return false;
+}
+
+fa_JitTask* fa_jit_workers_take_done(fa_JitWorkerPool* pool) {
+    (void)pool;
+    return NULL;
+}
+
+void fa_jit_workers_wait_idle(fa_JitWorkerPool* pool) {
+    (void)pool;
+}
+
+#else
+
+struct fa_JitWorkerPool {
+    pthread_mutex_t lock;
+    pthread_cond_t work;  /* signalled on submit and on shutdown */
+    pthread_cond_t idle;  /* signalled when the last running task finishes */
+    pthread_t threads[FA_JIT_WORKERS_MAX];
+    uint32_t thread_count;
+    fa_JitTask* queue_head;
+    fa_JitTask* queue_tail;
+    fa_JitTask* done_head;
+    fa_JitTask* done_tail;
+    uint32_t running;
+    uint32_t done_count; /* read without the lock by fa_jit_workers_has_done */
+    bool stopping;
+};
+
+bool fa_jit_workers_supported(void) {
+    return true;
+}
+
+static void jit_task_list_free(fa_JitTask* task) {
+    while (task) {
+        fa_JitTask* next = task->next;
+        fa_jit_task_free(task);
+        task = next;
+    }
+}
+
+static void* jit_worker_main(void* arg) {
+    fa_JitWorkerPool* pool = (fa_JitWorkerPool*)arg;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->queue_head && !pool->stopping) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+        if (pool->stopping) {
+            break;
+        }
+        fa_JitTask* task = pool->queue_head;
+        pool->queue_head = task->next;
+        if (!pool->queue_head) {
+            pool->queue_tail = NULL;
+        }
+        task->next = NULL;
+        pool->running++;
+        pthread_mutex_unlock(&pool->lock);
+
+        jit_task_run(task);
+
+        pthread_mutex_lock(&pool->lock);
+        if (pool->done_tail) {
+            pool->done_tail->next = task;
+        } else {
+            pool->done_head = task;
+        }
+        pool->done_tail = task;
+        __atomic_store_n(&pool->done_count, pool->done_count + 1U, __ATOMIC_RELEASE);
+        pool->running--;
+        if (pool->running == 0 && !pool->queue_head) {
+            pthread_cond_broadcast(&pool->idle);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+fa_JitWorkerPool* fa_jit_workers_create(uint32_t thread_count) {
+    if (thread_count == 0) {
+        return NULL;
+    }
+    if (thread_count > FA_JIT_WORKERS_MAX) {
+        thread_count = FA_JIT_WORKERS_MAX;
+    }
+    /* The op tables initialize lazily and without locking; do it here,
+       before any worker can race on them. */
+    (void)fa_get_op(0x00);
+    (void)fa_ops_microcode_enabled();
+    fa_JitWorkerPool* pool = (fa_JitWorkerPool*)calloc(1, sizeof(fa_JitWorkerPool));
+    if (!pool) {
+        return NULL;
+    }
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->work, NULL) != 0) {
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->idle, NULL) != 0) {
+        pthread_cond_destroy(&pool->work);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        if (pthread_create(&pool->threads[i], NULL, jit_worker_main, pool) != 0) {
+            break;
+        }
+        pool->thread_count++;
+    }
+    if (pool->thread_count == 0) {
+        fa_jit_workers_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void fa_jit_workers_destroy(fa_JitWorkerPool* pool) {
+    if (!pool) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (uint32_t i = 0; i < pool->thread_count; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    jit_task_list_free(pool->queue_head);
+    jit_task_list_free(pool->done_head);
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+bool fa_jit_workers_submit(fa_JitWorkerPool* pool, fa_JitTask* task) {
+    if (!pool || !task) {
+        return false;
+    }
+    task->next = NULL;
+    pthread_mutex_lock(&pool->lock);
+    if (pool->queue_tail) {
+        pool->queue_tail->next = task;
+    } else {
+        pool->queue_head = task;
+    }
+    pool->queue_tail = task;
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    return true;
+}
+
+bool fa_jit_workers_has_done(fa_JitWorkerPool* pool) {
+    return pool && __atomic_load_n(&pool->done_count, __ATOMIC_ACQUIRE) > 0;
+}
+
+fa_JitTask* fa_jit_workers_take_done(fa_JitWorkerPool* pool) {
+    if (!fa_jit_workers_has_done(pool)) {
+        return NULL;
+    }
+    pthread_mutex_lock(&pool->lock);
+    fa_JitTask* done = pool->done_head;
+    pool->done_head = NULL;
+    pool->done_tail = NULL;
+    __atomic_store_n(&pool->done_count, 0U, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&pool->lock);
+    return done;
+}
+
+void fa_jit_workers_wait_idle(fa_JitWorkerPool* pool) {
+    if (!pool) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    while (pool->queue_head || pool->running > 0) {
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+#endif
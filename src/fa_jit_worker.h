@@ -0,0 +1,78 @@
+#pragma once
+
+#include "fa_jit.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------- *
+ * Background JIT workers.
+ *
+ * A small pthread pool that runs the pure half of JIT compilation off the
+ * execution thread: microcode preparation from a snapshot of the recorded
+ * opcodes, and native IR building + lowering into a plain buffer. Workers
+ * never touch runtime state. Finished tasks wait on a done list until the
+ * runtime takes them at a safe point (a call or loop back-edge) and installs
+ * the result itself, so budgets, the code cache and the entry table stay
+ * single-threaded. Targets without threads report no support and the runtime
+ * keeps compiling synchronously.
+ * ------------------------------------------------------------------------- */
+#if !defined(FAYASM_TARGET_EMBEDDED) && (defined(__unix__) || defined(__APPLE__))
+#define FA_JIT_WORKERS_HOST 1
+#endif
+
+#ifndef FA_JIT_WORKERS_MAX
+#define FA_JIT_WORKERS_MAX 8U
+#endif
+
+typedef enum {
+    FA_JIT_TASK_MICROCODE = 0,
+    FA_JIT_TASK_NATIVE,
+    FA_JIT_TASK_PRESCAN
+} fa_JitTaskKind;
+
+typedef struct fa_JitTask {
+    fa_JitTaskKind kind;
+    uint32_t func_index;
+    /* inputs, owned by the task */
+    uint8_t* opcodes;            /* MICROCODE: recorded opcodes at submit time */
+    size_t opcode_count;
+    fa_JitNativeRequest request; /* NATIVE: request.body is owned */
+    /* PRESCAN: scan supplied by the submitter. It may write the state `user`
+       points at for `func_index` and nothing shared: either the pool is
+       drained before the submitter looks again (load-time prescan), or
+       `user` is scratch private to the task (prefetch). `release`, when set,
+       frees `user` with the task. */
+    int (*prescan)(struct fa_JitTask* task);
+    void* user;
+    void (*release)(void* user);
+    uint8_t* body;               /* PRESCAN: owned function body */
+    uint32_t body_size;
+    /* outputs */
+    int status;                  /* PRESCAN: the scan's FA_RUNTIME_* status */
+    bool ok;
+    fa_JitProgram program;       /* MICROCODE */
+    uint8_t* code;               /* NATIVE: host code for fa_jit_native_install */
+    size_t code_bytes;
+    uint32_t frame_slots;
+    struct fa_JitTask* next;
+} fa_JitTask;
+
+typedef struct fa_JitWorkerPool fa_JitWorkerPool;
+
+bool fa_jit_workers_supported(void);
+/* Starts `thread_count` workers (clamped to FA_JIT_WORKERS_MAX); NULL when
+   threads are unavailable. */
+fa_JitWorkerPool* fa_jit_workers_create(uint32_t thread_count);
+/* Drops queued tasks, joins the workers and frees every task still held. */
+void fa_jit_workers_destroy(fa_JitWorkerPool* pool);
+/* Queues `task`; the pool owns it until it comes back from take_done. */
+bool fa_jit_workers_submit(fa_JitWorkerPool* pool, fa_JitTask* task);
+/* Lock-free check for finished tasks. */
+bool fa_jit_workers_has_done(fa_JitWorkerPool* pool);
+/* Detaches the finished tasks in completion order (NULL when none). */
+fa_JitTask* fa_jit_workers_take_done(fa_JitWorkerPool* pool);
+/* Blocks until no task is queued or running. */
+void fa_jit_workers_wait_idle(fa_JitWorkerPool* pool);
+void fa_jit_task_free(fa_JitTask* task);
@@ -1,6 +1,7 @@
 #include "fa_ops.h"
 #include "fa_runtime.h"
 #include "fa_arch.h"
+#include "fa_bulk.h"
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -38,7 +39,8 @@ static bool g_microcode_enabled = false;
  * Reading guide:
  * 1) Core stack/register helpers and type conversion guards.
  * 2) Opcode handlers plus delegate tables (control/memory/table/ref/simd).
- * 3) Macro-generated microcode helpers for arithmetic/convert/float ops.
+ * 3) Macro-generated microcode helpers for arithmetic/convert/float ops, and
+ *    fused handlers for common adjacent op pairs (`g_fused_pairs`).
  * 4) Opcode and microcode tables (`fa_ops_defs_populate`, `init_microcode_once`).
  *
  * Maintenance rule for future edits:
@@ -194,10 +196,7 @@ static u64 mask_unsigned_value(u64 value, uint8_t bits) {
     return value & mask;
 }
 
-static bool push_int_value(fa_Job* job, u64 value, uint8_t bit_width, bool is_signed) {
-    if (!job) {
-        return false;
-    }
+static fa_JobValue make_int_value(u64 value, uint8_t bit_width, bool is_signed) {
     if (bit_width == 0) {
         bit_width = is_signed ? 32U : 32U;
     }
@@ -222,6 +221,14 @@ static bool push_int_value(fa_Job* job, u64 value, uint8_t bit_width, bool is_si
             v.payload.i64_value = (i64)value;
         }
     }
+    return v;
+}
+
+static bool push_int_value(fa_Job* job, u64 value, uint8_t bit_width, bool is_signed) {
+    if (!job) {
+        return false;
+    }
+    const fa_JobValue v = make_int_value(value, bit_width, is_signed);
     return fa_JobStack_push(&job->stack, &v);
 }
 
@@ -695,7 +702,7 @@ static int push_v128_checked(fa_Job* job, const fa_V128* value) {
 
 /* Common runtime guards for memory/table/segment lookup and validation. */
 static int memory_bounds_check(const fa_RuntimeMemory* memory, u64 addr, size_t size) {
-    if (!memory || !memory->data) {
+    if (!memory || (!memory->data && !memory->pager)) {
         return FA_RUNTIME_ERR_TRAP;
     }
     if (size == 0) {
@@ -710,6 +717,19 @@ static int memory_bounds_check(const fa_RuntimeMemory* memory, u64 addr, size_t
     return FA_RUNTIME_OK;
 }
 
+/* memory.copy validates both ranges in one pass: each address must leave
+   room for `size` bytes, so no `addr + size` is formed and nothing overflows. */
+static int memory_copy_bounds_check(const fa_RuntimeMemory* dst, u64 dst_addr,
+                                    const fa_RuntimeMemory* src, u64 src_addr, size_t size) {
+    if (!dst || !src || (!dst->data && !dst->pager) || (!src->data && !src->pager)) {
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    const u64 len = (u64)size;
+    const bool out_of_range = (len > dst->size_bytes) | (len > src->size_bytes) ||
+                              (dst_addr > dst->size_bytes - len) | (src_addr > src->size_bytes - len);
+    return out_of_range ? FA_RUNTIME_ERR_TRAP : FA_RUNTIME_OK;
+}
+
 static fa_RuntimeMemory* runtime_get_memory(fa_Runtime* runtime, u64 index) {
     if (!runtime || !runtime->memories) {
         return NULL;
@@ -736,6 +756,35 @@ static int runtime_require_memory(fa_Runtime* runtime, u64 index, fa_RuntimeMemo
     return FA_RUNTIME_OK;
 }
 
+/* Paged memories have no flat `data`: an access inside one page the TLB
+   already maps is served inline, anything else goes to the pager. Flat
+   memories keep the direct memcpy. Callers bounds-check. */
+static int memory_load_bytes(fa_Runtime* runtime, const fa_RuntimeMemory* memory, u64 addr, void* out, size_t size) {
+    if (memory->pager) {
+        const uint8_t* page = fa_RuntimeMemoryTlb_lookup(memory->tlb, addr, size, false);
+        if (!page) {
+            return fa_Runtime_pagedRead(runtime, memory, addr, out, size);
+        }
+        memcpy(out, page, size);
+        return FA_RUNTIME_OK;
+    }
+    memcpy(out, memory->data + (size_t)addr, size);
+    return FA_RUNTIME_OK;
+}
+
+static int memory_store_bytes(fa_Runtime* runtime, fa_RuntimeMemory* memory, u64 addr, const void* data, size_t size) {
+    if (memory->pager) {
+        uint8_t* page = fa_RuntimeMemoryTlb_lookup(memory->tlb, addr, size, true);
+        if (!page) {
+            return fa_Runtime_pagedWrite(runtime, memory, addr, data, size);
+        }
+        memcpy(page, data, size);
+        return FA_RUNTIME_OK;
+    }
+    memcpy(memory->data + (size_t)addr, data, size);
+    return FA_RUNTIME_OK;
+}
+
 static fa_RuntimeTable* runtime_get_table(fa_Runtime* runtime, u64 index) {
     if (!runtime || !runtime->tables) {
         return NULL;
@@ -1286,7 +1335,10 @@ static OP_RETURN_TYPE op_load(OP_ARGUMENTS) {
     }
 
     u64 raw = 0;
-    memcpy(&raw, memory->data + (size_t)addr, bytes_to_read);
+    status = memory_load_bytes(runtime, memory, addr, &raw, bytes_to_read);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
 
     if (descriptor->type.type == wt_float) {
         if (descriptor->type.size == 8) {
@@ -1380,16 +1432,16 @@ static OP_RETURN_TYPE op_store(OP_ARGUMENTS) {
                 restore_stack_value(job, &value);
                 return FA_RUNTIME_ERR_TRAP;
             }
-            memcpy(memory->data + (size_t)addr, &data, sizeof(data));
+            status = memory_store_bytes(runtime, memory, addr, &data, sizeof(data));
         } else {
             f32 data = 0.0f;
             if (!job_value_to_f32(&value, &data)) {
                 restore_stack_value(job, &value);
                 return FA_RUNTIME_ERR_TRAP;
             }
-            memcpy(memory->data + (size_t)addr, &data, sizeof(data));
+            status = memory_store_bytes(runtime, memory, addr, &data, sizeof(data));
         }
-        return FA_RUNTIME_OK;
+        return status;
     }
 
     u64 raw = 0;
@@ -1398,8 +1450,7 @@ static OP_RETURN_TYPE op_store(OP_ARGUMENTS) {
         return FA_RUNTIME_ERR_TRAP;
     }
     raw = mask_unsigned_value(raw, (uint8_t)bits_to_write);
-    memcpy(memory->data + (size_t)addr, &raw, bytes_to_write);
-    return FA_RUNTIME_OK;
+    return memory_store_bytes(runtime, memory, addr, &raw, bytes_to_write);
 }
 
 static OP_RETURN_TYPE op_const(OP_ARGUMENTS) {
@@ -2726,6 +2777,103 @@ DEFINE_MICROCODE(mc_select, op_select)
 #undef DEFINE_REINTERPRET_FLOAT_TO_INT_OP
 #undef DEFINE_REINTERPRET_INT_TO_FLOAT_OP
 
+/*
+ * Fused op pairs.
+ * Two immediate-free ops that sit back to back in a basic block can run as
+ * one handler (see `fa_jit_program_fuse`): operands are popped once, the
+ * intermediate value never goes through the operand stack and the result
+ * overwrites the deepest operand in place. The fast path only takes operands
+ * of the exact wasm type; anything else replays the two regular handlers, so
+ * traps and error codes are unchanged.
+ */
+static OP_RETURN_TYPE fused_fallback(fa_Runtime* runtime, fa_Job* job, const fa_WasmOp* first, uint8_t second) {
+    const int status = first->operation(runtime, job, first);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    const fa_WasmOp* next = &g_ops[second];
+    return next->operation(runtime, job, next);
+}
+
+/* Drops the top `count` values and replaces the one below them. */
+static void fused_replace_operands(fa_Job* job, uint8_t count, const fa_JobValue* result) {
+    fa_JobValue discarded;
+    for (uint8_t i = 0; i < count; ++i) {
+        (void)fa_JobStack_pop(&job->stack, &discarded);
+    }
+    job->stack.tail->value = *result;
+}
+
+/* Macro family: `a b OP1` then `x _ OP2`, i.e. x OP2 (a OP1 b). */
+#define DEFINE_FUSED_BINARY_BINARY(name, value_kind, member, utype, bits, second, expr) \
+    static OP_RETURN_TYPE name(OP_ARGUMENTS) {                                   \
+        if (!job || !descriptor) {                                               \
+            return FA_RUNTIME_ERR_INVALID_ARGUMENT;                              \
+        }                                                                        \
+        const fa_JobValue* b = fa_JobStack_peek(&job->stack, 0);                 \
+        const fa_JobValue* a = fa_JobStack_peek(&job->stack, 1);                 \
+        const fa_JobValue* x = fa_JobStack_peek(&job->stack, 2);                 \
+        if (!b || !a || !x || b->kind != value_kind || a->kind != value_kind ||  \
+            x->kind != value_kind) {                                             \
+            return fused_fallback(runtime, job, descriptor, second);             \
+        }                                                                        \
+        const utype right = (utype)b->payload.member;                            \
+        const utype left = (utype)a->payload.member;                             \
+        const utype outer = (utype)x->payload.member;                            \
+        const fa_JobValue result = make_int_value((u64)(utype)(expr), bits, true); \
+        fused_replace_operands(job, 2, &result);                                 \
+        return FA_RUNTIME_OK;                                                    \
+    }
+
+/* Macro family: `a b OP` then `eqz`. */
+#define DEFINE_FUSED_BINARY_EQZ(name, value_kind, member, utype, second, expr)   \
+    static OP_RETURN_TYPE name(OP_ARGUMENTS) {                                   \
+        if (!job || !descriptor) {                                               \
+            return FA_RUNTIME_ERR_INVALID_ARGUMENT;                              \
+        }                                                                        \
+        const fa_JobValue* b = fa_JobStack_peek(&job->stack, 0);                 \
+        const fa_JobValue* a = fa_JobStack_peek(&job->stack, 1);                 \
+        if (!b || !a || b->kind != value_kind || a->kind != value_kind) {        \
+            return fused_fallback(runtime, job, descriptor, second);             \
+        }                                                                        \
+        const utype right = (utype)b->payload.member;                            \
+        const utype left = (utype)a->payload.member;                             \
+        const fa_JobValue result = make_int_value((utype)(expr) == 0 ? 1U : 0U, 32U, false); \
+        fused_replace_operands(job, 1, &result);                                 \
+        return FA_RUNTIME_OK;                                                    \
+    }
+
+DEFINE_FUSED_BINARY_BINARY(op_fused_i32_mul_add, fa_job_value_i32, i32_value, u32, 32U, 0x6A, outer + left * right)
+DEFINE_FUSED_BINARY_BINARY(op_fused_i32_shl_add, fa_job_value_i32, i32_value, u32, 32U, 0x6A, outer + (left << (right & 31U)))
+DEFINE_FUSED_BINARY_BINARY(op_fused_i32_add_add, fa_job_value_i32, i32_value, u32, 32U, 0x6A, outer + (left + right))
+DEFINE_FUSED_BINARY_BINARY(op_fused_i64_mul_add, fa_job_value_i64, i64_value, u64, 64U, 0x7C, outer + left * right)
+DEFINE_FUSED_BINARY_BINARY(op_fused_i64_shl_add, fa_job_value_i64, i64_value, u64, 64U, 0x7C, outer + (left << (right & 63U)))
+DEFINE_FUSED_BINARY_BINARY(op_fused_i64_add_add, fa_job_value_i64, i64_value, u64, 64U, 0x7C, outer + (left + right))
+DEFINE_FUSED_BINARY_EQZ(op_fused_i32_and_eqz, fa_job_value_i32, i32_value, u32, 0x45, left & right)
+DEFINE_FUSED_BINARY_EQZ(op_fused_i64_and_eqz, fa_job_value_i64, i64_value, u64, 0x50, left & right)
+
+#undef DEFINE_FUSED_BINARY_BINARY
+#undef DEFINE_FUSED_BINARY_EQZ
+
+typedef struct {
+    uint8_t first;
+    uint8_t second;
+    Operation handler;
+} fa_FusedPair;
+
+/* Pairs picked from common compiler output: address arithmetic
+   (`shl; add`, `mul; add`, `add; add`) and bit tests (`and; eqz`). */
+static const fa_FusedPair g_fused_pairs[] = {
+    { 0x6C, 0x6A, op_fused_i32_mul_add }, // i32.mul; i32.add
+    { 0x74, 0x6A, op_fused_i32_shl_add }, // i32.shl; i32.add
+    { 0x6A, 0x6A, op_fused_i32_add_add }, // i32.add; i32.add
+    { 0x71, 0x45, op_fused_i32_and_eqz }, // i32.and; i32.eqz
+    { 0x7E, 0x7C, op_fused_i64_mul_add }, // i64.mul; i64.add
+    { 0x86, 0x7C, op_fused_i64_shl_add }, // i64.shl; i64.add
+    { 0x7C, 0x7C, op_fused_i64_add_add }, // i64.add; i64.add
+    { 0x83, 0x50, op_fused_i64_and_eqz }, // i64.and; i64.eqz
+};
+
 static OP_RETURN_TYPE op_drop(OP_ARGUMENTS) {
     (void)runtime;
     (void)descriptor;
@@ -2791,23 +2939,7 @@ static bool runtime_function_signature_matches(const WasmModule* module, uint32_
     if (function_type_index >= module->num_types) {
         return false;
     }
-    if (function_type_index == type_index) {
-        return true;
-    }
-    const WasmFunctionType* expected = &module->types[type_index];
-    const WasmFunctionType* actual = &module->types[function_type_index];
-    if (expected->num_params != actual->num_params || expected->num_results != actual->num_results) {
-        return false;
-    }
-    if (expected->num_params > 0 &&
-        memcmp(expected->param_types, actual->param_types, expected->num_params * sizeof(uint32_t)) != 0) {
-        return false;
-    }
-    if (expected->num_results > 0 &&
-        memcmp(expected->result_types, actual->result_types, expected->num_results * sizeof(uint32_t)) != 0) {
-        return false;
-    }
-    return true;
+    return module->types[function_type_index].canonical_index == module->types[type_index].canonical_index;
 }
 
 static OP_RETURN_TYPE op_call_indirect(OP_ARGUMENTS) {
@@ -2979,9 +3111,6 @@ static OP_RETURN_TYPE op_bulk_memory_init(OP_ARGUMENTS) {
     if (length > SIZE_MAX || src_offset > UINT64_MAX - length) {
         return FA_RUNTIME_ERR_TRAP;
     }
-    if (!segment->data && length > 0) {
-        return FA_RUNTIME_ERR_TRAP;
-    }
     const uint64_t segment_end = src_offset + length;
     if (segment_end > segment->size) {
         return FA_RUNTIME_ERR_TRAP;
@@ -2990,8 +3119,8 @@ static OP_RETURN_TYPE op_bulk_memory_init(OP_ARGUMENTS) {
     if (memory_bounds_check(memory, dst_addr, len) != FA_RUNTIME_OK) {
         return FA_RUNTIME_ERR_TRAP;
     }
-    memcpy(memory->data + (size_t)dst_addr, segment->data + (size_t)src_offset, len);
-    return FA_RUNTIME_OK;
+    /* Borrowed or fd-backed segment bytes are resolved by the runtime. */
+    return fa_Runtime_initMemory(runtime, (uint32_t)mem_index, dst_addr, (uint32_t)data_index, src_offset, len);
 }
 
 static OP_RETURN_TYPE op_bulk_data_drop(OP_ARGUMENTS) {
@@ -3008,7 +3137,12 @@ static OP_RETURN_TYPE op_bulk_data_drop(OP_ARGUMENTS) {
         data_index >= runtime->data_segments_count) {
         return FA_RUNTIME_ERR_TRAP;
     }
-    runtime->data_segments_dropped[data_index] = true;
+    if (!runtime->data_segments_dropped[data_index]) {
+        runtime->data_segments_dropped[data_index] = true;
+        if (runtime->module->data_segments[data_index].is_passive) {
+            wasm_unpin_data_segment(runtime->module, (uint32_t)data_index);
+        }
+    }
     return FA_RUNTIME_OK;
 }
 
@@ -3050,11 +3184,13 @@ static OP_RETURN_TYPE op_bulk_memory_copy(OP_ARGUMENTS) {
         return FA_RUNTIME_ERR_TRAP;
     }
     size_t len = (size_t)length;
-    if (memory_bounds_check(src_memory, src_addr, len) != FA_RUNTIME_OK ||
-        memory_bounds_check(dst_memory, dst_addr, len) != FA_RUNTIME_OK) {
+    if (memory_copy_bounds_check(dst_memory, dst_addr, src_memory, src_addr, len) != FA_RUNTIME_OK) {
         return FA_RUNTIME_ERR_TRAP;
     }
-    memmove(dst_memory->data + (size_t)dst_addr, src_memory->data + (size_t)src_addr, len);
+    if (dst_memory->pager || src_memory->pager) {
+        return fa_Runtime_copyMemory(runtime, (uint32_t)dst_index, dst_addr, (uint32_t)src_index, src_addr, len);
+    }
+    fa_bulk_copy(dst_memory->data + (size_t)dst_addr, src_memory->data + (size_t)src_addr, len);
     return FA_RUNTIME_OK;
 }
 
@@ -3091,7 +3227,10 @@ static OP_RETURN_TYPE op_bulk_memory_fill(OP_ARGUMENTS) {
     if (memory_bounds_check(memory, dst_addr, len) != FA_RUNTIME_OK) {
         return FA_RUNTIME_ERR_TRAP;
     }
-    memset(memory->data + (size_t)dst_addr, byte_value, len);
+    if (memory->pager) {
+        return fa_Runtime_fillMemory(runtime, (uint32_t)mem_index, dst_addr, byte_value, len);
+    }
+    fa_bulk_fill(memory->data + (size_t)dst_addr, byte_value, len);
     return FA_RUNTIME_OK;
 }
 
@@ -3197,13 +3336,10 @@ static OP_RETURN_TYPE op_bulk_table_copy(OP_ARGUMENTS) {
     if (pop_u32_checked(job, &dst) != FA_RUNTIME_OK) {
         return FA_RUNTIME_ERR_TRAP;
     }
-    if ((uint64_t)src + length > src_table->size ||
-        (uint64_t)dst + length > dst_table->size) {
+    if (((uint64_t)src + length > src_table->size) | ((uint64_t)dst + length > dst_table->size)) {
         return FA_RUNTIME_ERR_TRAP;
     }
-    if (length > 0) {
-        memmove(dst_table->data + dst, src_table->data + src, length * sizeof(fa_ptr));
-    }
+    fa_bulk_copy_refs(dst_table->data + dst, src_table->data + src, length);
     return FA_RUNTIME_OK;
 }
 
@@ -3283,9 +3419,7 @@ static OP_RETURN_TYPE op_bulk_table_fill(OP_ARGUMENTS) {
     if ((uint64_t)start + length > table->size) {
         return FA_RUNTIME_ERR_TRAP;
     }
-    for (uint32_t i = 0; i < length; ++i) {
-        table->data[start + i] = value;
-    }
+    fa_bulk_fill_refs(table->data + start, value, length);
     return FA_RUNTIME_OK;
 }
 
@@ -3470,26 +3604,24 @@ static int simd_resolve_memarg_address(fa_Runtime* runtime, fa_Job* job, u64* ad
     return FA_RUNTIME_OK;
 }
 
-static int simd_load_bytes(fa_RuntimeMemory* memory, u64 addr, void* out, size_t size) {
-    if (!memory || !out) {
+static int simd_load_bytes(fa_Runtime* runtime, fa_RuntimeMemory* memory, u64 addr, void* out, size_t size) {
+    if (!runtime || !memory || !out) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
     if (memory_bounds_check(memory, addr, size) != FA_RUNTIME_OK) {
         return FA_RUNTIME_ERR_TRAP;
     }
-    memcpy(out, memory->data + (size_t)addr, size);
-    return FA_RUNTIME_OK;
+    return memory_load_bytes(runtime, memory, addr, out, size);
 }
 
-static int simd_store_bytes(fa_RuntimeMemory* memory, u64 addr, const void* data, size_t size) {
-    if (!memory || !data) {
+static int simd_store_bytes(fa_Runtime* runtime, fa_RuntimeMemory* memory, u64 addr, const void* data, size_t size) {
+    if (!runtime || !memory || !data) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
     if (memory_bounds_check(memory, addr, size) != FA_RUNTIME_OK) {
         return FA_RUNTIME_ERR_TRAP;
     }
-    memcpy(memory->data + (size_t)addr, data, size);
-    return FA_RUNTIME_OK;
+    return memory_store_bytes(runtime, memory, addr, data, size);
 }
 
 static int8_t simd_saturate_i8(int32_t value) {
@@ -3666,7 +3798,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             fa_V128 value = {0};
-            status = simd_load_bytes(memory, addr, &value, sizeof(value));
+            status = simd_load_bytes(runtime, memory, addr, &value, sizeof(value));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3681,7 +3813,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint8_t raw[8] = {0};
-            status = simd_load_bytes(memory, addr, raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3700,7 +3832,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint8_t raw[8] = {0};
-            status = simd_load_bytes(memory, addr, raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3719,7 +3851,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint16_t raw[4] = {0};
-            status = simd_load_bytes(memory, addr, raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3738,7 +3870,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint16_t raw[4] = {0};
-            status = simd_load_bytes(memory, addr, raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3757,7 +3889,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint32_t raw[2] = {0};
-            status = simd_load_bytes(memory, addr, raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3776,7 +3908,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint32_t raw[2] = {0};
-            status = simd_load_bytes(memory, addr, raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3794,7 +3926,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint8_t raw = 0;
-            status = simd_load_bytes(memory, addr, &raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, &raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3811,7 +3943,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint16_t raw = 0;
-            status = simd_load_bytes(memory, addr, &raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, &raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3830,7 +3962,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint32_t raw = 0;
-            status = simd_load_bytes(memory, addr, &raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, &raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3849,7 +3981,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint64_t raw = 0;
-            status = simd_load_bytes(memory, addr, &raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, &raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3872,7 +4004,7 @@ static OP_RETURN_TYPE op_simd_mem(OP_ARGUMENTS, u64 subopcode) {
                 restore_stack_value(job, &value_raw);
                 return status;
             }
-            return simd_store_bytes(memory, addr, &value, sizeof(value));
+            return simd_store_bytes(runtime, memory, addr, &value, sizeof(value));
         }
         default:
             return FA_RUNTIME_ERR_UNIMPLEMENTED_OPCODE;
@@ -4659,7 +4791,7 @@ static OP_RETURN_TYPE op_simd_memlane(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint8_t byte = 0;
-            status = simd_load_bytes(memory, addr, &byte, sizeof(byte));
+            status = simd_load_bytes(runtime, memory, addr, &byte, sizeof(byte));
             if (status != FA_RUNTIME_OK) {
                 restore_stack_value(job, &value_raw);
                 return status;
@@ -4689,7 +4821,7 @@ static OP_RETURN_TYPE op_simd_memlane(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint16_t lane_value = 0;
-            status = simd_load_bytes(memory, addr, &lane_value, sizeof(lane_value));
+            status = simd_load_bytes(runtime, memory, addr, &lane_value, sizeof(lane_value));
             if (status != FA_RUNTIME_OK) {
                 restore_stack_value(job, &value_raw);
                 return status;
@@ -4719,7 +4851,7 @@ static OP_RETURN_TYPE op_simd_memlane(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint32_t lane_value = 0;
-            status = simd_load_bytes(memory, addr, &lane_value, sizeof(lane_value));
+            status = simd_load_bytes(runtime, memory, addr, &lane_value, sizeof(lane_value));
             if (status != FA_RUNTIME_OK) {
                 restore_stack_value(job, &value_raw);
                 return status;
@@ -4749,7 +4881,7 @@ static OP_RETURN_TYPE op_simd_memlane(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint64_t lane_value = 0;
-            status = simd_load_bytes(memory, addr, &lane_value, sizeof(lane_value));
+            status = simd_load_bytes(runtime, memory, addr, &lane_value, sizeof(lane_value));
             if (status != FA_RUNTIME_OK) {
                 restore_stack_value(job, &value_raw);
                 return status;
@@ -4781,7 +4913,7 @@ static OP_RETURN_TYPE op_simd_memlane(OP_ARGUMENTS, u64 subopcode) {
             fa_V128Lanes lanes = {0};
             v128_to_lanes(&value, &lanes);
             const uint8_t lane_value = lanes.u8[lane];
-            return simd_store_bytes(memory, addr, &lane_value, sizeof(lane_value));
+            return simd_store_bytes(runtime, memory, addr, &lane_value, sizeof(lane_value));
         }
         case 0x59: /* v128.store16_lane */
         {
@@ -4805,7 +4937,7 @@ static OP_RETURN_TYPE op_simd_memlane(OP_ARGUMENTS, u64 subopcode) {
             fa_V128Lanes lanes = {0};
             v128_to_lanes(&value, &lanes);
             const uint16_t lane_value = lanes.u16[lane];
-            return simd_store_bytes(memory, addr, &lane_value, sizeof(lane_value));
+            return simd_store_bytes(runtime, memory, addr, &lane_value, sizeof(lane_value));
         }
         case 0x5a: /* v128.store32_lane */
         {
@@ -4829,7 +4961,7 @@ static OP_RETURN_TYPE op_simd_memlane(OP_ARGUMENTS, u64 subopcode) {
             fa_V128Lanes lanes = {0};
             v128_to_lanes(&value, &lanes);
             const uint32_t lane_value = lanes.u32[lane];
-            return simd_store_bytes(memory, addr, &lane_value, sizeof(lane_value));
+            return simd_store_bytes(runtime, memory, addr, &lane_value, sizeof(lane_value));
         }
         case 0x5b: /* v128.store64_lane */
         {
@@ -4853,7 +4985,7 @@ static OP_RETURN_TYPE op_simd_memlane(OP_ARGUMENTS, u64 subopcode) {
             fa_V128Lanes lanes = {0};
             v128_to_lanes(&value, &lanes);
             const uint64_t lane_value = lanes.u64[lane];
-            return simd_store_bytes(memory, addr, &lane_value, sizeof(lane_value));
+            return simd_store_bytes(runtime, memory, addr, &lane_value, sizeof(lane_value));
         }
         case 0x5c: /* v128.load32_zero */
         {
@@ -4864,7 +4996,7 @@ static OP_RETURN_TYPE op_simd_memlane(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint32_t raw = 0;
-            status = simd_load_bytes(memory, addr, &raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, &raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -4881,7 +5013,7 @@ static OP_RETURN_TYPE op_simd_memlane(OP_ARGUMENTS, u64 subopcode) {
                 return status;
             }
             uint64_t raw = 0;
-            status = simd_load_bytes(memory, addr, &raw, sizeof(raw));
+            status = simd_load_bytes(runtime, memory, addr, &raw, sizeof(raw));
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -6539,64 +6671,10 @@ static int runtime_table_grow(fa_Runtime* runtime, u64 table_index, u64 delta, f
  * - hard runtime faults still return an error code
  */
 static int runtime_memory_grow(fa_Runtime* runtime, u64 mem_index, u64 delta_pages, u64* prev_pages_out, bool* grew_out) {
-    if (!runtime || !prev_pages_out || !grew_out) {
+    if (mem_index > UINT32_MAX) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
-    fa_RuntimeMemory* memory = runtime_get_memory(runtime, mem_index);
-    if (!memory) {
-        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
-    }
-    int status = fa_Runtime_ensureMemoryLoaded(runtime, (uint32_t)mem_index);
-    if (status != FA_RUNTIME_OK) {
-        return status;
-    }
-    const uint64_t prev_pages = memory->size_bytes / FA_WASM_PAGE_SIZE;
-    if (!memory->is_memory64 && prev_pages > UINT32_MAX) {
-        return FA_RUNTIME_ERR_UNSUPPORTED;
-    }
-    *prev_pages_out = prev_pages;
-    *grew_out = false;
-    if (delta_pages == 0) {
-        *grew_out = true;
-        return FA_RUNTIME_OK;
-    }
-    if (!memory->owns_data) {
-        return FA_RUNTIME_OK;
-    }
-    const uint64_t new_pages = prev_pages + delta_pages;
-    if (new_pages < prev_pages) {
-        return FA_RUNTIME_OK;
-    }
-    if (memory->has_max) {
-        const uint64_t max_pages = memory->max_size_bytes / FA_WASM_PAGE_SIZE;
-        if (new_pages > max_pages) {
-            return FA_RUNTIME_OK;
-        }
-    }
-    if (new_pages > (UINT64_MAX / FA_WASM_PAGE_SIZE)) {
-        return FA_RUNTIME_OK;
-    }
-    const uint64_t new_size_bytes = new_pages * FA_WASM_PAGE_SIZE;
-    if (new_size_bytes > SIZE_MAX || new_size_bytes > (uint64_t)INT_MAX) {
-        return FA_RUNTIME_OK;
-    }
-    uint8_t* new_data = (uint8_t*)runtime->malloc((int)new_size_bytes);
-    if (!new_data) {
-        return FA_RUNTIME_OK;
-    }
-    if (memory->data && memory->size_bytes > 0) {
-        memcpy(new_data, memory->data, (size_t)memory->size_bytes);
-    }
-    if (new_size_bytes > memory->size_bytes) {
-        memset(new_data + memory->size_bytes, 0, (size_t)(new_size_bytes - memory->size_bytes));
-    }
-    if (memory->data) {
-        runtime->free(memory->data);
-    }
-    memory->data = new_data;
-    memory->size_bytes = new_size_bytes;
-    *grew_out = true;
-    return FA_RUNTIME_OK;
+    return fa_Runtime_growMemory(runtime, (uint32_t)mem_index, delta_pages, prev_pages_out, grew_out);
 }
 
 static OP_RETURN_TYPE op_memory_size(OP_ARGUMENTS) {
@@ -6988,6 +7066,19 @@ bool fa_ops_microcode_enabled(void) {
     return g_microcode_enabled;
 }
 
+bool fa_ops_get_fused_pair(uint8_t first, uint8_t second, Operation* handler_out) {
+    init_ops_once();
+    for (size_t i = 0; i < sizeof(g_fused_pairs) / sizeof(g_fused_pairs[0]); ++i) {
+        if (g_fused_pairs[i].first == first && g_fused_pairs[i].second == second) {
+            if (handler_out) {
+                *handler_out = g_fused_pairs[i].handler;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
 bool fa_ops_get_microcode_steps(uint8_t opcode, const Operation** steps_out, uint8_t* step_count_out) {
     init_ops_once();
     if (!g_microcode_enabled) {
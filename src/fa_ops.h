@@ -79,3 +79,6 @@ OP_RETURN_TYPE fa_execute_op(uint8_t opcode, struct fa_Runtime* runtime, fa_Job*
 void fa_ops_defs_populate(fa_WasmOp* ops);
 bool fa_ops_microcode_enabled(void);
 bool fa_ops_get_microcode_steps(uint8_t opcode, const Operation** steps_out, uint8_t* step_count_out);
+/* Handler that runs `first` then `second` (adjacent, immediate-free) in one
+   call; false when the pair has no fused form. */
+bool fa_ops_get_fused_pair(uint8_t first, uint8_t second, Operation* handler_out);
@@ -1,7 +1,16 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
 #define LIST_IMPLEMENTATION
 #include "fa_runtime.h"
 #include "fa_ops.h"
+#include "fa_bulk.h"
+#include "fa_jit_closure.h"
+#include "fa_jit_code_cache.h"
+#include "fa_jit_persist.h"
+#include "fa_jit_worker.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
@@ -15,10 +24,28 @@
 #define FA_RUNTIME_HAS_DLOPEN 1
 #endif
 
+#if defined(__linux__) && !defined(FAYASM_TARGET_ESP32) && !defined(ESP_PLATFORM)
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(MFD_CLOEXEC)
+#define FA_RUNTIME_HAS_MEMFD 1
+#endif
+#endif
+
+#if (defined(__APPLE__) || defined(__unix__) || defined(__linux__)) && \
+    !defined(FAYASM_TARGET_ESP32) && !defined(ESP_PLATFORM)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FA_RUNTIME_HAS_MMAP 1
+#endif
+
 typedef struct {
     uint32_t func_index;
     uint8_t* body;
     uint32_t body_size;
+    bool body_borrowed; /* points into the attached fa_CompiledModule */
     uint32_t pc;
     uint32_t code_start;
     fa_JobValue* locals;
@@ -26,6 +53,7 @@ typedef struct {
     struct fa_RuntimeControlFrame* control_stack;
     uint32_t control_depth;
     uint32_t control_capacity;
+    bool osr_pending; /* a loop crossed the OSR threshold; checked after the branch */
 } fa_RuntimeCallFrame;
 
 typedef enum {
@@ -45,8 +73,17 @@ typedef struct fa_RuntimeControlFrame {
     uint32_t result_count;
     bool preserve_stack;
     size_t stack_height;
+    uint32_t back_edges; /* loops: branches back to the header in this activation */
 } fa_RuntimeControlFrame;
 
+/* Control side table built by the prescan, sorted by start_pc: block, loop
+   and if entries resolve here instead of rescanning the body for their end. */
+typedef struct {
+    uint32_t start_pc; /* first byte after the block type */
+    uint32_t else_pc;  /* first byte after the block's own else, 0 when none */
+    uint32_t end_pc;   /* first byte after the matching end */
+} fa_RuntimeBlockTarget;
+
 typedef struct fa_JitProgramCacheEntry {
     uint32_t func_index;
     uint32_t body_size;
@@ -61,8 +98,48 @@ typedef struct fa_JitProgramCacheEntry {
     size_t prepared_count;
     bool ready;
     bool spilled;
+    fa_JitNativeCode native;
+    bool native_attempted;
+    uint64_t hits;        /* aged accesses: calls entered through the runtime + loop back-edges */
+    uint8_t clock_weight; /* saturating access weight for FA_JIT_EVICT_CLOCK */
+    uint32_t pins;        /* live interpreted/native frames; pinned entries are never evicted */
+    bool evicted;         /* program dropped by eviction and not rebuilt or reloaded yet */
+    uint32_t tier_hits;   /* calls + loop back-edges, never aged; gates native compilation */
+    bool osr_failed;      /* the body has no OSR entry (outside the native subset) */
+    bool prepare_pending; /* a background microcode preparation is in flight */
+    bool closure_attempted; /* closure lowering ran (program.closure stays NULL on failure) */
+    fa_RuntimeBlockTarget* blocks; /* prescan control side table, NULL until prescanned */
+    uint32_t block_count;
+    bool prescanned;       /* scanned and validated (at attach, on first call or by prefetch) */
+    bool prefetch_pending; /* a background prefetch scan is in flight */
+    bool shared;           /* opcodes/offsets/pc_to_index/blocks borrowed from an fa_CompiledModule */
+    bool program_shared;   /* program.ops borrowed too; program.closure is still this runtime's */
 } fa_JitProgramCacheEntry;
 
+/* Tier-up code one instance of a compiled module produced, for the others. */
+typedef struct {
+    uint32_t frame_slots;
+    size_t data_bytes;
+    uint8_t data[];                /* emitted native code or serialized closure records */
+} fa_CompiledTierCode;
+
+#define FA_COMPILED_TIER_SLOTS 4u  /* {native, closure} x {flat, other} memory */
+
+struct fa_CompiledModule {
+    WasmModule* module;
+    fa_JitProgramCacheEntry* code; /* frozen prescan results, by function index */
+    uint32_t code_count;
+    fa_CompiledTierCode** tier_code; /* code_count * FA_COMPILED_TIER_SLOTS, filled once each */
+    const uint8_t** bodies;        /* function bodies, by function index (NULL for imports) */
+    uint8_t* body_bytes;           /* backing store for `bodies` unless they point into module->buffer */
+    uint64_t prescan_blocks;
+    uint32_t prescan_programs;
+    uint32_t refs;
+    void* bundle_map;              /* fa_CompiledModule_loadBundle mapping the module borrows */
+    size_t bundle_map_bytes;
+    uint8_t* bundle_copy;          /* read fallback where mmap is unavailable */
+};
+
 typedef struct fa_RuntimeHostBinding {
     char* module;
     char* name;
@@ -180,6 +257,9 @@ static void runtime_host_bindings_clear(fa_Runtime* runtime) {
     runtime->host_bindings = NULL;
     runtime->host_binding_count = 0;
     runtime->host_binding_capacity = 0;
+    if (runtime->host_import_slots) {
+        memset(runtime->host_import_slots, 0, runtime->host_import_slot_count * sizeof(uint32_t));
+    }
 }
 
 static int runtime_host_bindings_reserve(fa_Runtime* runtime, uint32_t count) {
@@ -207,12 +287,50 @@ static int runtime_host_bindings_reserve(fa_Runtime* runtime, uint32_t count) {
     return FA_RUNTIME_OK;
 }
 
+/* Imported functions resolve to their binding through host_import_slots, kept
+   in step with host_bindings: filled at attach and whenever a binding is
+   added, so a call never searches by name. */
+static void runtime_host_import_resolve(fa_Runtime* runtime, uint32_t binding_index) {
+    if (!runtime->module || !runtime->host_import_slots || binding_index >= runtime->host_binding_count) {
+        return;
+    }
+    const fa_RuntimeHostBinding* binding = &runtime->host_bindings[binding_index];
+    const WasmImport* import = wasm_module_find_import(runtime->module, binding->module, binding->name,
+                                                       WASM_EXTERNAL_FUNCTION);
+    for (; import; import = wasm_module_next_import(runtime->module, import)) {
+        if (import->index < runtime->host_import_slot_count) {
+            runtime->host_import_slots[import->index] = binding_index + 1U;
+        }
+    }
+}
+
+static fa_RuntimeHostBinding* runtime_host_import_binding(fa_Runtime* runtime, uint32_t function_index) {
+    if (!runtime->host_import_slots || function_index >= runtime->host_import_slot_count) {
+        return NULL;
+    }
+    const uint32_t slot = runtime->host_import_slots[function_index];
+    return (slot != 0 && slot <= runtime->host_binding_count) ? &runtime->host_bindings[slot - 1U] : NULL;
+}
+
+static void runtime_host_imports_reset(fa_Runtime* runtime) {
+    free(runtime->host_import_slots);
+    runtime->host_import_slots = NULL;
+    runtime->host_import_slot_count = 0;
+}
+
 static fa_RuntimeHostBinding* runtime_find_host_binding(fa_Runtime* runtime,
                                                         const char* module_name,
                                                         const char* import_name) {
     if (!runtime || !module_name || !import_name) {
         return NULL;
     }
+    /* A name the attached module imports is answered by its slot. */
+    const WasmImport* import = runtime->module
+        ? wasm_module_find_import(runtime->module, module_name, import_name, WASM_EXTERNAL_FUNCTION)
+        : NULL;
+    if (import && runtime->host_import_slots) {
+        return runtime_host_import_binding(runtime, import->index);
+    }
     for (uint32_t i = 0; i < runtime->host_binding_count; ++i) {
         fa_RuntimeHostBinding* binding = &runtime->host_bindings[i];
         if (!binding->module || !binding->name) {
@@ -261,6 +379,7 @@ static int runtime_add_host_binding(fa_Runtime* runtime,
     binding->user_data = user_data;
     binding->library_handle = library_handle;
     runtime->host_binding_count += 1U;
+    runtime_host_import_resolve(runtime, runtime->host_binding_count - 1U);
     return FA_RUNTIME_OK;
 }
 
@@ -332,17 +451,6 @@ static fa_RuntimeHostMemoryBinding* runtime_find_host_memory_binding(fa_Runtime*
     return NULL;
 }
 
-static bool runtime_import_matches(const char* module_name,
-                                   const char* import_name,
-                                   const char* candidate_module,
-                                   const char* candidate_name) {
-    if (!module_name || !import_name || !candidate_module || !candidate_name) {
-        return false;
-    }
-    return strcmp(module_name, candidate_module) == 0 &&
-           strcmp(import_name, candidate_name) == 0;
-}
-
 static int runtime_validate_imported_memory_binding(const WasmMemory* memory,
                                                     const fa_RuntimeHostMemory* binding_memory) {
     if (!memory || !binding_memory) {
@@ -396,36 +504,23 @@ static int runtime_apply_attached_memory_rebind(fa_Runtime* runtime,
     const uint32_t limit = (runtime->memories_count < runtime->module->num_memories)
         ? runtime->memories_count
         : runtime->module->num_memories;
-    bool matched = false;
+    const WasmImport* first = wasm_module_find_import(runtime->module, module_name, import_name, WASM_EXTERNAL_MEMORY);
 
-    for (uint32_t i = 0; i < limit; ++i) {
-        const WasmMemory* imported = &runtime->module->memories[i];
-        if (!imported->is_imported) {
-            continue;
-        }
-        if (!runtime_import_matches(module_name, import_name, imported->import_module, imported->import_name)) {
+    for (const WasmImport* import = first; import; import = wasm_module_next_import(runtime->module, import)) {
+        if (import->index >= limit) {
             continue;
         }
-        int status = runtime_validate_imported_memory_binding(imported, memory);
+        int status = runtime_validate_imported_memory_binding(&runtime->module->memories[import->index], memory);
         if (status != FA_RUNTIME_OK) {
             return status;
         }
-        matched = true;
     }
 
-    if (!matched) {
-        return FA_RUNTIME_OK;
-    }
-
-    for (uint32_t i = 0; i < limit; ++i) {
-        const WasmMemory* imported = &runtime->module->memories[i];
-        if (!imported->is_imported) {
-            continue;
-        }
-        if (!runtime_import_matches(module_name, import_name, imported->import_module, imported->import_name)) {
+    for (const WasmImport* import = first; import; import = wasm_module_next_import(runtime->module, import)) {
+        if (import->index >= limit) {
             continue;
         }
-        fa_RuntimeMemory* dst = &runtime->memories[i];
+        fa_RuntimeMemory* dst = &runtime->memories[import->index];
         dst->data = memory->data;
         dst->size_bytes = memory->size_bytes;
         dst->is_host = true;
@@ -581,36 +676,23 @@ static int runtime_apply_attached_table_rebind(fa_Runtime* runtime,
     const uint32_t limit = (runtime->tables_count < runtime->module->num_tables)
         ? runtime->tables_count
         : runtime->module->num_tables;
-    bool matched = false;
+    const WasmImport* first = wasm_module_find_import(runtime->module, module_name, import_name, WASM_EXTERNAL_TABLE);
 
-    for (uint32_t i = 0; i < limit; ++i) {
-        const WasmTable* imported = &runtime->module->tables[i];
-        if (!imported->is_imported) {
-            continue;
-        }
-        if (!runtime_import_matches(module_name, import_name, imported->import_module, imported->import_name)) {
+    for (const WasmImport* import = first; import; import = wasm_module_next_import(runtime->module, import)) {
+        if (import->index >= limit) {
             continue;
         }
-        int status = runtime_validate_imported_table_binding(imported, table);
+        int status = runtime_validate_imported_table_binding(&runtime->module->tables[import->index], table);
         if (status != FA_RUNTIME_OK) {
             return status;
         }
-        matched = true;
     }
 
-    if (!matched) {
-        return FA_RUNTIME_OK;
-    }
-
-    for (uint32_t i = 0; i < limit; ++i) {
-        const WasmTable* imported = &runtime->module->tables[i];
-        if (!imported->is_imported) {
-            continue;
-        }
-        if (!runtime_import_matches(module_name, import_name, imported->import_module, imported->import_name)) {
+    for (const WasmImport* import = first; import; import = wasm_module_next_import(runtime->module, import)) {
+        if (import->index >= limit) {
             continue;
         }
-        fa_RuntimeTable* dst = &runtime->tables[i];
+        fa_RuntimeTable* dst = &runtime->tables[import->index];
         dst->data = table->data;
         dst->size = table->size;
         dst->is_host = true;
@@ -660,14 +742,552 @@ static int runtime_add_host_table_binding(fa_Runtime* runtime,
     return FA_RUNTIME_OK;
 }
 
+/* ------------------------------------------------------------------------- *
+ * Demand-paged linear memory.
+ *
+ * A paged memory keeps `data == NULL` and owns a fixed pool of page frames.
+ * Every access resolves its page through a small direct-mapped software TLB
+ * (the interpreter's load/store ops probe it inline, see fa_runtime.h); a TLB
+ * miss looks the page up in a hashed page->frame index and, failing that,
+ * faults the page in over a CLOCK victim. Dirty victims go out through `page_spill`, and a bitmap of
+ * spilled pages decides whether a fault needs `page_load` or a zero fill.
+ * ------------------------------------------------------------------------- */
+#define FA_RUNTIME_PAGER_NO_PAGE UINT64_MAX
+#define FA_RUNTIME_PAGER_NO_FRAME UINT32_MAX
+
+typedef struct fa_RuntimeMemoryPager {
+    uint32_t page_shift;
+    uint32_t page_bytes;
+    uint32_t frame_count;
+    uint32_t clock_hand;
+    fa_RuntimeMemoryFrame* frames;
+    uint8_t* frame_storage;
+    uint8_t* spilled_bitmap;
+    uint64_t spilled_bitmap_pages;
+    /* page->frame index: `index_heads[page & index_mask]` starts a chain of
+       resident frames linked through `index_next`. */
+    uint32_t* index_heads;
+    uint32_t* index_next;
+    uint32_t index_mask;
+    fa_RuntimeMemoryTlb tlb;
+    fa_RuntimeMemoryPagingStats stats;
+} fa_RuntimeMemoryPager;
+
+static bool runtime_paging_config_valid(const fa_RuntimeMemoryPaging* paging) {
+    if (!paging || !paging->page_spill || !paging->page_load || paging->resident_pages == 0) {
+        return false;
+    }
+    const uint32_t page_bytes = paging->page_bytes;
+    if (page_bytes < FA_RUNTIME_MEMORY_PAGE_BYTES_MIN || page_bytes > FA_WASM_PAGE_SIZE) {
+        return false;
+    }
+    if ((page_bytes & (page_bytes - 1U)) != 0) {
+        return false;
+    }
+    return (uint64_t)page_bytes * (uint64_t)paging->resident_pages <= (uint64_t)INT_MAX;
+}
+
+static void runtime_pager_free(fa_Runtime* runtime, fa_RuntimeMemoryPager* pager) {
+    if (!runtime || !pager) {
+        return;
+    }
+    if (pager->frame_storage) {
+        runtime->free(pager->frame_storage);
+    }
+    free(pager->frames);
+    free(pager->index_heads);
+    free(pager->index_next);
+    free(pager->spilled_bitmap);
+    free(pager);
+}
+
+static fa_RuntimeMemoryPager* runtime_pager_create(fa_Runtime* runtime, const fa_RuntimeMemoryPaging* paging) {
+    if (!runtime || !runtime_paging_config_valid(paging)) {
+        return NULL;
+    }
+    fa_RuntimeMemoryPager* pager = (fa_RuntimeMemoryPager*)calloc(1, sizeof(fa_RuntimeMemoryPager));
+    if (!pager) {
+        return NULL;
+    }
+    pager->page_bytes = paging->page_bytes;
+    while ((1U << pager->page_shift) < pager->page_bytes) {
+        pager->page_shift++;
+    }
+    pager->frame_count = paging->resident_pages;
+    /* At least as many buckets as frames keeps the index chains short. */
+    uint32_t buckets = 16U;
+    while (buckets < pager->frame_count && buckets < (1U << 31)) {
+        buckets <<= 1;
+    }
+    pager->index_mask = buckets - 1U;
+    pager->frames = (fa_RuntimeMemoryFrame*)calloc(pager->frame_count, sizeof(fa_RuntimeMemoryFrame));
+    pager->index_heads = (uint32_t*)malloc((size_t)buckets * sizeof(uint32_t));
+    pager->index_next = (uint32_t*)malloc((size_t)pager->frame_count * sizeof(uint32_t));
+    pager->frame_storage = (uint8_t*)runtime->malloc((int)(pager->page_bytes * pager->frame_count));
+    if (!pager->frames || !pager->index_heads || !pager->index_next || !pager->frame_storage) {
+        runtime_pager_free(runtime, pager);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < buckets; ++i) {
+        pager->index_heads[i] = FA_RUNTIME_PAGER_NO_FRAME;
+    }
+    for (uint32_t i = 0; i < pager->frame_count; ++i) {
+        pager->frames[i].page_index = FA_RUNTIME_PAGER_NO_PAGE;
+        pager->frames[i].data = pager->frame_storage + (size_t)i * pager->page_bytes;
+        pager->index_next[i] = FA_RUNTIME_PAGER_NO_FRAME;
+    }
+    pager->tlb.page_shift = pager->page_shift;
+    for (uint32_t i = 0; i < FA_RUNTIME_MEMORY_TLB_ENTRIES; ++i) {
+        pager->tlb.entries[i].page_index = FA_RUNTIME_PAGER_NO_PAGE;
+    }
+    return pager;
+}
+
+static uint32_t runtime_pager_index_find(const fa_RuntimeMemoryPager* pager, uint64_t page_index) {
+    uint32_t frame_index = pager->index_heads[page_index & pager->index_mask];
+    while (frame_index != FA_RUNTIME_PAGER_NO_FRAME && pager->frames[frame_index].page_index != page_index) {
+        frame_index = pager->index_next[frame_index];
+    }
+    return frame_index;
+}
+
+static void runtime_pager_index_insert(fa_RuntimeMemoryPager* pager, uint32_t frame_index) {
+    uint32_t* head = &pager->index_heads[pager->frames[frame_index].page_index & pager->index_mask];
+    pager->index_next[frame_index] = *head;
+    *head = frame_index;
+}
+
+static void runtime_pager_index_remove(fa_RuntimeMemoryPager* pager, uint32_t frame_index) {
+    uint32_t* link = &pager->index_heads[pager->frames[frame_index].page_index & pager->index_mask];
+    while (*link != FA_RUNTIME_PAGER_NO_FRAME) {
+        if (*link == frame_index) {
+            *link = pager->index_next[frame_index];
+            break;
+        }
+        link = &pager->index_next[*link];
+    }
+    pager->index_next[frame_index] = FA_RUNTIME_PAGER_NO_FRAME;
+}
+
+static bool runtime_pager_is_spilled(const fa_RuntimeMemoryPager* pager, uint64_t page_index) {
+    if (page_index >= pager->spilled_bitmap_pages) {
+        return false;
+    }
+    return (pager->spilled_bitmap[page_index >> 3] & (uint8_t)(1U << (page_index & 7U))) != 0;
+}
+
+static int runtime_pager_mark_spilled(fa_RuntimeMemoryPager* pager, uint64_t page_index) {
+    if (page_index >= pager->spilled_bitmap_pages) {
+        uint64_t pages = pager->spilled_bitmap_pages ? pager->spilled_bitmap_pages : 64U;
+        while (pages <= page_index) {
+            pages *= 2U;
+        }
+        if (pages / 8U > SIZE_MAX) {
+            return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+        }
+        const size_t old_bytes = (size_t)(pager->spilled_bitmap_pages / 8U);
+        const size_t new_bytes = (size_t)(pages / 8U);
+        uint8_t* bitmap = (uint8_t*)realloc(pager->spilled_bitmap, new_bytes);
+        if (!bitmap) {
+            return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+        }
+        memset(bitmap + old_bytes, 0, new_bytes - old_bytes);
+        pager->spilled_bitmap = bitmap;
+        pager->spilled_bitmap_pages = pages;
+    }
+    pager->spilled_bitmap[page_index >> 3] |= (uint8_t)(1U << (page_index & 7U));
+    return FA_RUNTIME_OK;
+}
+
+static int runtime_pager_write_back(fa_Runtime* runtime,
+                                    uint32_t memory_index,
+                                    fa_RuntimeMemoryPager* pager,
+                                    fa_RuntimeMemoryFrame* frame) {
+    if (frame->page_index == FA_RUNTIME_PAGER_NO_PAGE || !frame->dirty) {
+        return FA_RUNTIME_OK;
+    }
+    /* Reserve the bitmap bit first so a successful spill is never lost. */
+    int status = runtime_pager_mark_spilled(pager, frame->page_index);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    status = runtime->memory_paging.page_spill(runtime, memory_index, frame->page_index, frame->data,
+                                               pager->page_bytes, runtime->memory_paging.user_data);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    pager->stats.page_spills++;
+    frame->dirty = false;
+    return FA_RUNTIME_OK;
+}
+
+static int runtime_pager_evict_frame(fa_Runtime* runtime,
+                                     uint32_t memory_index,
+                                     fa_RuntimeMemoryPager* pager,
+                                     fa_RuntimeMemoryFrame* frame) {
+    if (frame->page_index == FA_RUNTIME_PAGER_NO_PAGE) {
+        return FA_RUNTIME_OK;
+    }
+    int status = runtime_pager_write_back(runtime, memory_index, pager, frame);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    fa_RuntimeMemoryTlbEntry* tlb = &pager->tlb.entries[frame->page_index & (FA_RUNTIME_MEMORY_TLB_ENTRIES - 1U)];
+    if (tlb->page_index == frame->page_index) {
+        tlb->page_index = FA_RUNTIME_PAGER_NO_PAGE;
+    }
+    runtime_pager_index_remove(pager, (uint32_t)(frame - pager->frames));
+    frame->page_index = FA_RUNTIME_PAGER_NO_PAGE;
+    frame->referenced = false;
+    return FA_RUNTIME_OK;
+}
+
+static uint32_t runtime_pager_pick_victim(fa_RuntimeMemoryPager* pager) {
+    for (;;) {
+        const uint32_t index = pager->clock_hand;
+        fa_RuntimeMemoryFrame* frame = &pager->frames[index];
+        pager->clock_hand = (index + 1U) % pager->frame_count;
+        if (frame->page_index == FA_RUNTIME_PAGER_NO_PAGE || !frame->referenced) {
+            return index;
+        }
+        frame->referenced = false;
+    }
+}
+
+static int runtime_pager_resolve(fa_Runtime* runtime,
+                                 uint32_t memory_index,
+                                 fa_RuntimeMemoryPager* pager,
+                                 uint64_t page_index,
+                                 bool for_write,
+                                 uint8_t** data_out) {
+    fa_RuntimeMemoryTlbEntry* tlb = &pager->tlb.entries[page_index & (FA_RUNTIME_MEMORY_TLB_ENTRIES - 1U)];
+    fa_RuntimeMemoryFrame* frame = NULL;
+    if (tlb->page_index == page_index) {
+        frame = tlb->frame;
+        pager->tlb.hits++;
+    } else {
+        uint32_t frame_index = runtime_pager_index_find(pager, page_index);
+        if (frame_index == FA_RUNTIME_PAGER_NO_FRAME) {
+            pager->stats.page_faults++;
+            frame_index = runtime_pager_pick_victim(pager);
+            frame = &pager->frames[frame_index];
+            int status = runtime_pager_evict_frame(runtime, memory_index, pager, frame);
+            if (status != FA_RUNTIME_OK) {
+                return status;
+            }
+            if (runtime_pager_is_spilled(pager, page_index)) {
+                status = runtime->memory_paging.page_load(runtime, memory_index, page_index, frame->data,
+                                                          pager->page_bytes, runtime->memory_paging.user_data);
+                if (status != FA_RUNTIME_OK) {
+                    return status;
+                }
+                pager->stats.page_loads++;
+            } else {
+                memset(frame->data, 0, pager->page_bytes);
+            }
+            frame->page_index = page_index;
+            runtime_pager_index_insert(pager, frame_index);
+        }
+        frame = &pager->frames[frame_index];
+        tlb->page_index = page_index;
+        tlb->frame = frame;
+    }
+    frame->referenced = true;
+    if (for_write) {
+        frame->dirty = true;
+    }
+    *data_out = frame->data;
+    return FA_RUNTIME_OK;
+}
+
+typedef enum {
+    FA_RUNTIME_PAGER_READ = 0,
+    FA_RUNTIME_PAGER_WRITE,
+    FA_RUNTIME_PAGER_FILL
+} fa_RuntimePagerAccess;
+
+/* Walks [offset, offset + size) page by page; the caller has bounds-checked. */
+static int runtime_pager_access(fa_Runtime* runtime,
+                                uint32_t memory_index,
+                                fa_RuntimeMemoryPager* pager,
+                                uint64_t offset,
+                                uint8_t* buffer,
+                                uint8_t fill_value,
+                                size_t size,
+                                fa_RuntimePagerAccess access) {
+    const uint64_t page_mask = (uint64_t)pager->page_bytes - 1U;
+    while (size > 0) {
+        const uint64_t page_index = offset >> pager->page_shift;
+        const size_t in_page = (size_t)(offset & page_mask);
+        size_t chunk = pager->page_bytes - in_page;
+        if (chunk > size) {
+            chunk = size;
+        }
+        uint8_t* page = NULL;
+        int status = runtime_pager_resolve(runtime, memory_index, pager, page_index,
+                                           access != FA_RUNTIME_PAGER_READ, &page);
+        if (status != FA_RUNTIME_OK) {
+            return status;
+        }
+        switch (access) {
+            case FA_RUNTIME_PAGER_READ:
+                memcpy(buffer, page + in_page, chunk);
+                buffer += chunk;
+                break;
+            case FA_RUNTIME_PAGER_WRITE:
+                memcpy(page + in_page, buffer, chunk);
+                buffer += chunk;
+                break;
+            case FA_RUNTIME_PAGER_FILL:
+                memset(page + in_page, fill_value, chunk);
+                break;
+        }
+        offset += chunk;
+        size -= chunk;
+    }
+    return FA_RUNTIME_OK;
+}
+
+/* Writes back every dirty frame; with `drop` the frames are released too. */
+static int runtime_pager_flush(fa_Runtime* runtime, uint32_t memory_index, fa_RuntimeMemoryPager* pager, bool drop) {
+    for (uint32_t i = 0; i < pager->frame_count; ++i) {
+        fa_RuntimeMemoryFrame* frame = &pager->frames[i];
+        int status = drop ? runtime_pager_evict_frame(runtime, memory_index, pager, frame)
+                          : runtime_pager_write_back(runtime, memory_index, pager, frame);
+        if (status != FA_RUNTIME_OK) {
+            return status;
+        }
+    }
+    return FA_RUNTIME_OK;
+}
+
+/* Releases a runtime-owned memory buffer, whichever way it was obtained. */
+static void runtime_memory_release_data(fa_Runtime* runtime, fa_RuntimeMemory* memory) {
+    if (!runtime || !memory || !memory->data) {
+        return;
+    }
+#if defined(FA_RUNTIME_HAS_MEMFD)
+    if (memory->mapped_bytes > 0) {
+        (void)munmap(memory->data, memory->mapped_bytes);
+        memory->data = NULL;
+        memory->mapped_bytes = 0;
+        return;
+    }
+#endif
+    runtime->free(memory->data);
+    memory->data = NULL;
+    memory->mapped_bytes = 0;
+}
+
+/* ------------------------------------------------------------------------- *
+ * Shared memory images.
+ *
+ * All runtime-owned memories of a module are laid out back to back (each
+ * starting on a Wasm page boundary, hence mmap-offset aligned) in one image
+ * with the active data segments applied. With memfd the image is a sparse
+ * file, so untouched zero pages cost nothing until an instance writes them.
+ * ------------------------------------------------------------------------- */
+typedef struct {
+    uint64_t size_bytes;
+    uint64_t image_offset;
+    bool present;
+} fa_RuntimeMemoryImageEntry;
+
+struct fa_RuntimeMemoryImage {
+    const WasmModule* module;
+    fa_RuntimeMemoryImageEntry* memories;
+    uint32_t memory_count;
+    uint64_t total_bytes;
+    int fd;         // memfd holding the image, -1 when it lives in `bytes`
+    uint8_t* bytes;
+};
+
+static bool runtime_memory_image_write(fa_RuntimeMemoryImage* image,
+                                       uint64_t offset,
+                                       const uint8_t* data,
+                                       size_t size) {
+#if defined(FA_RUNTIME_HAS_MEMFD)
+    if (image->fd >= 0) {
+        while (size > 0) {
+            ssize_t written = pwrite(image->fd, data, size, (off_t)offset);
+            if (written <= 0) {
+                return false;
+            }
+            data += written;
+            offset += (uint64_t)written;
+            size -= (size_t)written;
+        }
+        return true;
+    }
+#endif
+    memcpy(image->bytes + (size_t)offset, data, size);
+    return true;
+}
+
+static bool runtime_memory_image_copy_segment(fa_RuntimeMemoryImage* image, uint32_t data_index, uint64_t offset) {
+    /* The image never writes back into the module; reads only move its
+       stream position. */
+    WasmModule* module = (WasmModule*)image->module;
+    const WasmDataSegment* segment = &module->data_segments[data_index];
+    if (segment->data) {
+        return runtime_memory_image_write(image, offset, segment->data, segment->size);
+    }
+    uint8_t bounce[256];
+    size_t done = 0;
+    while (done < segment->size) {
+        const size_t chunk = segment->size - done < sizeof(bounce) ? segment->size - done : sizeof(bounce);
+        if (wasm_read_data_segment(module, data_index, done, bounce, chunk) != 0 ||
+            !runtime_memory_image_write(image, offset + done, bounce, chunk)) {
+            return false;
+        }
+        done += chunk;
+    }
+    return true;
+}
+
+fa_RuntimeMemoryImage* fa_RuntimeMemoryImage_create(const WasmModule* module) {
+    if (!module) {
+        return NULL;
+    }
+    fa_RuntimeMemoryImage* image = (fa_RuntimeMemoryImage*)calloc(1, sizeof(fa_RuntimeMemoryImage));
+    if (!image) {
+        return NULL;
+    }
+    image->module = module;
+    image->fd = -1;
+    if (module->num_memories > 0 && module->memories) {
+        image->memories = (fa_RuntimeMemoryImageEntry*)calloc(module->num_memories,
+                                                              sizeof(fa_RuntimeMemoryImageEntry));
+        if (!image->memories) {
+            fa_RuntimeMemoryImage_free(image);
+            return NULL;
+        }
+        image->memory_count = module->num_memories;
+    }
+    for (uint32_t i = 0; i < image->memory_count; ++i) {
+        const WasmMemory* memory = &module->memories[i];
+        if (memory->is_imported) {
+            continue;
+        }
+        /* Same per-memory ceiling as the flat allocator in runtime_memory_init. */
+        if (memory->initial_size > (uint64_t)INT_MAX / FA_WASM_PAGE_SIZE) {
+            fa_RuntimeMemoryImage_free(image);
+            return NULL;
+        }
+        fa_RuntimeMemoryImageEntry* entry = &image->memories[i];
+        entry->size_bytes = memory->initial_size * FA_WASM_PAGE_SIZE;
+        entry->image_offset = image->total_bytes;
+        entry->present = true;
+        image->total_bytes += entry->size_bytes;
+    }
+    if (image->total_bytes > 0) {
+#if defined(FA_RUNTIME_HAS_MEMFD)
+        image->fd = memfd_create("fayasm-memory-image", MFD_CLOEXEC);
+        if (image->fd >= 0 && ftruncate(image->fd, (off_t)image->total_bytes) != 0) {
+            close(image->fd);
+            image->fd = -1;
+        }
+#endif
+        if (image->fd < 0) {
+            if (image->total_bytes > SIZE_MAX) {
+                fa_RuntimeMemoryImage_free(image);
+                return NULL;
+            }
+            image->bytes = (uint8_t*)calloc(1, (size_t)image->total_bytes);
+            if (!image->bytes) {
+                fa_RuntimeMemoryImage_free(image);
+                return NULL;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < module->num_data_segments && module->data_segments; ++i) {
+        const WasmDataSegment* segment = &module->data_segments[i];
+        if (segment->is_passive || segment->memory_index >= image->memory_count ||
+            !image->memories[segment->memory_index].present) {
+            continue;
+        }
+        const fa_RuntimeMemoryImageEntry* entry = &image->memories[segment->memory_index];
+        if (segment->offset > entry->size_bytes || segment->size > entry->size_bytes - segment->offset) {
+            fa_RuntimeMemoryImage_free(image);
+            return NULL;
+        }
+        if (segment->size > 0 && !runtime_memory_image_copy_segment(image, i, entry->image_offset + segment->offset)) {
+            fa_RuntimeMemoryImage_free(image);
+            return NULL;
+        }
+    }
+    return image;
+}
+
+void fa_RuntimeMemoryImage_free(fa_RuntimeMemoryImage* image) {
+    if (!image) {
+        return;
+    }
+#if defined(FA_RUNTIME_HAS_MEMFD)
+    if (image->fd >= 0) {
+        close(image->fd);
+    }
+#endif
+    free(image->bytes);
+    free(image->memories);
+    free(image);
+}
+
+bool fa_RuntimeMemoryImage_isShared(const fa_RuntimeMemoryImage* image) {
+    return image && image->fd >= 0;
+}
+
+static int runtime_memory_from_image(fa_Runtime* runtime,
+                                     const fa_RuntimeMemoryImage* image,
+                                     const fa_RuntimeMemoryImageEntry* entry,
+                                     fa_RuntimeMemory* dst) {
+    dst->from_image = true;
+    dst->size_bytes = entry->size_bytes;
+    if (entry->size_bytes == 0) {
+        return FA_RUNTIME_OK;
+    }
+#if defined(FA_RUNTIME_HAS_MEMFD)
+    if (image->fd >= 0) {
+        void* mapped = mmap(NULL, (size_t)entry->size_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                            image->fd, (off_t)entry->image_offset);
+        if (mapped != MAP_FAILED) {
+            dst->data = (uint8_t*)mapped;
+            dst->mapped_bytes = (size_t)entry->size_bytes;
+            return FA_RUNTIME_OK;
+        }
+    }
+#endif
+    uint8_t* data = (uint8_t*)runtime->malloc((int)entry->size_bytes);
+    if (!data) {
+        return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+    }
+    if (image->bytes) {
+        memcpy(data, image->bytes + (size_t)entry->image_offset, (size_t)entry->size_bytes);
+    }
+#if defined(FA_RUNTIME_HAS_MEMFD)
+    else if (pread(image->fd, data, (size_t)entry->size_bytes, (off_t)entry->image_offset) !=
+             (ssize_t)entry->size_bytes) {
+        runtime->free(data);
+        return FA_RUNTIME_ERR_STREAM;
+    }
+#endif
+    dst->data = data;
+    return FA_RUNTIME_OK;
+}
+
 static void runtime_memory_reset(fa_Runtime* runtime) {
     if (!runtime) {
         return;
     }
     if (runtime->memories) {
         for (uint32_t i = 0; i < runtime->memories_count; ++i) {
-            if (runtime->memories[i].data && runtime->memories[i].owns_data) {
-                runtime->free(runtime->memories[i].data);
+            if (runtime->memories[i].owns_data) {
+                runtime_memory_release_data(runtime, &runtime->memories[i]);
+            }
+            if (runtime->memories[i].pager) {
+                runtime_pager_free(runtime, runtime->memories[i].pager);
+                runtime->memories[i].pager = NULL;
+                runtime->memories[i].tlb = NULL;
             }
             runtime->memories[i].data = NULL;
             runtime->memories[i].size_bytes = 0;
@@ -677,6 +1297,8 @@ static void runtime_memory_reset(fa_Runtime* runtime) {
             runtime->memories[i].is_spilled = false;
             runtime->memories[i].is_host = false;
             runtime->memories[i].owns_data = false;
+            runtime->memories[i].from_image = false;
+            runtime->memories[i].mapped_bytes = 0;
         }
         free(runtime->memories);
         runtime->memories = NULL;
@@ -712,6 +1334,12 @@ static void runtime_segments_reset(fa_Runtime* runtime) {
         return;
     }
     if (runtime->data_segments_dropped) {
+        /* Passive segments still live here release their pin. */
+        for (uint32_t i = 0; runtime->module && i < runtime->data_segments_count; ++i) {
+            if (!runtime->data_segments_dropped[i] && runtime->module->data_segments[i].is_passive) {
+                wasm_unpin_data_segment(runtime->module, i);
+            }
+        }
         free(runtime->data_segments_dropped);
         runtime->data_segments_dropped = NULL;
     }
@@ -1010,14 +1638,33 @@ static int runtime_memory_init(fa_Runtime* runtime, const WasmModule* module) {
         }
 
         dst->owns_data = true;
-        if (memory->initial_size == 0) {
-            dst->size_bytes = 0;
-            continue;
-        }
         if (memory->initial_size > (UINT64_MAX / FA_WASM_PAGE_SIZE)) {
             status = FA_RUNTIME_ERR_UNSUPPORTED;
             goto cleanup;
         }
+        if (runtime->memory_paging.page_bytes != 0) {
+            /* Paged memories reserve only their frame pool, so they may exceed RAM. */
+            dst->pager = runtime_pager_create(runtime, &runtime->memory_paging);
+            if (!dst->pager) {
+                status = FA_RUNTIME_ERR_OUT_OF_MEMORY;
+                goto cleanup;
+            }
+            dst->tlb = &dst->pager->tlb;
+            dst->size_bytes = memory->initial_size * FA_WASM_PAGE_SIZE;
+            continue;
+        }
+        const fa_RuntimeMemoryImage* image = runtime->memory_image;
+        if (image && image->module == module && i < image->memory_count && image->memories[i].present) {
+            status = runtime_memory_from_image(runtime, image, &image->memories[i], dst);
+            if (status != FA_RUNTIME_OK) {
+                goto cleanup;
+            }
+            continue;
+        }
+        if (memory->initial_size == 0) {
+            dst->size_bytes = 0;
+            continue;
+        }
         const uint64_t size_bytes = memory->initial_size * FA_WASM_PAGE_SIZE;
         if (size_bytes > SIZE_MAX || size_bytes > (uint64_t)INT_MAX) {
             status = FA_RUNTIME_ERR_OUT_OF_MEMORY;
@@ -1119,7 +1766,7 @@ cleanup:
 }
 
 static int runtime_memory_bounds_check(const fa_RuntimeMemory* memory, uint64_t offset, size_t size) {
-    if (!memory || !memory->data) {
+    if (!memory || (!memory->data && !memory->pager)) {
         return FA_RUNTIME_ERR_TRAP;
     }
     if (size == 0) {
@@ -1173,11 +1820,51 @@ static int runtime_resolve_element_ref(const fa_Runtime* runtime,
     return FA_RUNTIME_OK;
 }
 
-static int runtime_segments_init(fa_Runtime* runtime, const WasmModule* module) {
-    if (!runtime || !module) {
-        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+/* Active segments are all range-checked before any of them is applied, so a
+   failing instantiation never leaves a half-initialized memory or table. */
+static int runtime_segments_validate(const fa_Runtime* runtime, const WasmModule* module) {
+    for (uint32_t i = 0; i < module->num_data_segments && module->data_segments; ++i) {
+        const WasmDataSegment* segment = &module->data_segments[i];
+        if (segment->is_passive) {
+            continue;
+        }
+        if (segment->memory_index >= runtime->memories_count) {
+            return FA_RUNTIME_ERR_UNSUPPORTED;
+        }
+        if (runtime_memory_bounds_check(&runtime->memories[segment->memory_index], segment->offset,
+                                        (size_t)segment->size) != FA_RUNTIME_OK) {
+            return FA_RUNTIME_ERR_TRAP;
+        }
+    }
+    for (uint32_t i = 0; i < module->num_elements && module->elements; ++i) {
+        const WasmElementSegment* segment = &module->elements[i];
+        if (segment->is_declarative || segment->is_passive) {
+            continue;
+        }
+        if (segment->table_index >= runtime->tables_count) {
+            return FA_RUNTIME_ERR_UNSUPPORTED;
+        }
+        const fa_RuntimeTable* table = &runtime->tables[segment->table_index];
+        if (segment->elem_type != table->elem_type) {
+            return FA_RUNTIME_ERR_UNSUPPORTED;
+        }
+        if (segment->offset > UINT64_MAX - segment->element_count ||
+            segment->offset + segment->element_count > table->size) {
+            return FA_RUNTIME_ERR_TRAP;
+        }
+    }
+    return FA_RUNTIME_OK;
+}
+
+static int runtime_segments_init(fa_Runtime* runtime, WasmModule* module) {
+    if (!runtime || !module) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
     runtime_segments_reset(runtime);
+    int status = runtime_segments_validate(runtime, module);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
 
     if (module->num_data_segments > 0 && module->data_segments) {
         runtime->data_segments_dropped = (bool*)calloc(module->num_data_segments, sizeof(bool));
@@ -1186,23 +1873,30 @@ static int runtime_segments_init(fa_Runtime* runtime, const WasmModule* module)
         }
         runtime->data_segments_count = module->num_data_segments;
 
+        /* Pinned before anything can fail, so a reset unpins exactly these. A
+           segment whose copy is already gone starts out dropped. */
+        for (uint32_t i = 0; i < module->num_data_segments; ++i) {
+            if (module->data_segments[i].is_passive && !wasm_pin_data_segment(module, i)) {
+                runtime->data_segments_dropped[i] = true;
+            }
+        }
         for (uint32_t i = 0; i < module->num_data_segments; ++i) {
             const WasmDataSegment* segment = &module->data_segments[i];
             if (segment->is_passive) {
                 continue;
             }
-            if (segment->memory_index >= runtime->memories_count) {
-                return FA_RUNTIME_ERR_UNSUPPORTED;
-            }
             fa_RuntimeMemory* memory = &runtime->memories[segment->memory_index];
-            const size_t length = (size_t)segment->size;
-            if ((uint32_t)length != segment->size) {
-                return FA_RUNTIME_ERR_UNSUPPORTED;
-            }
-            if (runtime_memory_bounds_check(memory, segment->offset, length) != FA_RUNTIME_OK) {
-                return FA_RUNTIME_ERR_TRAP;
+            if (memory->from_image || segment->size == 0) {
+                /* A shared image already carries this segment's bytes. */
+            } else if (segment->data && memory->data && !memory->pager) {
+                memcpy(memory->data + (size_t)segment->offset, segment->data, segment->size);
+            } else {
+                status = fa_Runtime_initMemory(runtime, segment->memory_index, segment->offset, i, 0,
+                                               (size_t)segment->size);
+                if (status != FA_RUNTIME_OK) {
+                    return status;
+                }
             }
-            memcpy(memory->data + (size_t)segment->offset, segment->data, length);
             runtime->data_segments_dropped[i] = true;
         }
     }
@@ -1223,31 +1917,18 @@ static int runtime_segments_init(fa_Runtime* runtime, const WasmModule* module)
             if (segment->is_passive) {
                 continue;
             }
-            if (segment->table_index >= runtime->tables_count) {
-                return FA_RUNTIME_ERR_UNSUPPORTED;
-            }
             fa_RuntimeTable* table = &runtime->tables[segment->table_index];
-            if (segment->elem_type != table->elem_type) {
-                return FA_RUNTIME_ERR_UNSUPPORTED;
-            }
-            if (segment->offset > UINT64_MAX - segment->element_count) {
-                return FA_RUNTIME_ERR_TRAP;
-            }
-            const uint64_t end = segment->offset + segment->element_count;
-            if (end > table->size) {
-                return FA_RUNTIME_ERR_TRAP;
-            }
+            fa_ptr* slots = table->data + (size_t)segment->offset;
             for (uint32_t j = 0; j < segment->element_count; ++j) {
                 fa_ptr ref_value = 0;
-                int status = runtime_resolve_element_ref(runtime, segment, j, &ref_value);
-                if (status != FA_RUNTIME_OK) {
-                    return status;
+                status = runtime_resolve_element_ref(runtime, segment, j, &ref_value);
+                if (status == FA_RUNTIME_OK) {
+                    status = runtime_validate_table_ref_value(module, table, ref_value);
                 }
-                status = runtime_validate_table_ref_value(module, table, ref_value);
                 if (status != FA_RUNTIME_OK) {
                     return status;
                 }
-                table->data[(size_t)segment->offset + j] = ref_value;
+                slots[j] = ref_value;
             }
             runtime->elem_segments_dropped[i] = true;
         }
@@ -1310,9 +1991,9 @@ static int runtime_control_push(fa_RuntimeCallFrame* frame,
                                 uint32_t start_pc,
                                 uint32_t else_pc,
                                 uint32_t end_pc,
-                                const uint32_t* param_types,
+                                const uint8_t* param_types,
                                 uint32_t param_count,
-                                const uint32_t* result_types,
+                                const uint8_t* result_types,
                                 uint32_t result_count,
                                 bool preserve_stack,
                                 size_t stack_height) {
@@ -1328,6 +2009,7 @@ static int runtime_control_push(fa_RuntimeCallFrame* frame,
     runtime_control_frame_clear(entry);
     entry->type = type;
     entry->start_pc = start_pc;
+    entry->back_edges = 0;
     entry->else_pc = else_pc;
     entry->end_pc = end_pc;
     entry->param_count = param_count;
@@ -1337,13 +2019,7 @@ static int runtime_control_push(fa_RuntimeCallFrame* frame,
         if (!entry->param_types) {
             return FA_RUNTIME_ERR_OUT_OF_MEMORY;
         }
-        for (uint32_t i = 0; i < param_count; ++i) {
-            if (param_types[i] > UINT8_MAX) {
-                runtime_control_frame_clear(entry);
-                return FA_RUNTIME_ERR_UNSUPPORTED;
-            }
-            entry->param_types[i] = (uint8_t)param_types[i];
-        }
+        memcpy(entry->param_types, param_types, param_count * sizeof(uint8_t));
     }
     if (result_count > 0) {
         entry->result_types = (uint8_t*)malloc(result_count * sizeof(uint8_t));
@@ -1351,13 +2027,7 @@ static int runtime_control_push(fa_RuntimeCallFrame* frame,
             runtime_control_frame_clear(entry);
             return FA_RUNTIME_ERR_OUT_OF_MEMORY;
         }
-        for (uint32_t i = 0; i < result_count; ++i) {
-            if (result_types[i] > UINT8_MAX) {
-                runtime_control_frame_clear(entry);
-                return FA_RUNTIME_ERR_UNSUPPORTED;
-            }
-            entry->result_types[i] = (uint8_t)result_types[i];
-        }
+        memcpy(entry->result_types, result_types, result_count * sizeof(uint8_t));
     }
     entry->preserve_stack = preserve_stack;
     entry->stack_height = stack_height;
@@ -1442,11 +2112,11 @@ static int runtime_init_value_from_valtype(fa_JobValue* out, uint32_t valtype) {
 }
 
 typedef struct {
-    const uint32_t* param_types;
+    const uint8_t* param_types;
     uint32_t param_count;
-    const uint32_t* result_types;
+    const uint8_t* result_types;
     uint32_t result_count;
-    uint32_t inline_result_type;
+    uint8_t inline_result_type;
 } fa_RuntimeBlockSignature;
 
 static int runtime_decode_block_signature(const fa_Runtime* runtime,
@@ -1538,8 +2208,11 @@ static void runtime_free_frame_resources(fa_RuntimeCallFrame* frame) {
         return;
     }
     if (frame->body) {
-        free(frame->body);
+        if (!frame->body_borrowed) {
+            free(frame->body);
+        }
         frame->body = NULL;
+        frame->body_borrowed = false;
     }
     if (frame->locals) {
         free(frame->locals);
@@ -1571,47 +2244,136 @@ static void runtime_jit_cache_release_program(fa_Runtime* runtime, fa_JitProgram
     if (runtime && entry->program_bytes > 0 && runtime->jit_cache_bytes >= entry->program_bytes) {
         runtime->jit_cache_bytes -= entry->program_bytes;
     }
-    fa_jit_program_free(&entry->program);
+    if (entry->program_shared) {
+        fa_jit_closure_free(entry->program.closure);
+        fa_jit_program_init(&entry->program);
+        entry->program_shared = false;
+    } else {
+        fa_jit_program_free(&entry->program);
+    }
     entry->program_bytes = 0;
     entry->prepared_count = 0;
     entry->ready = false;
 }
 
+static void runtime_jit_native_reclaim(fa_Runtime* runtime) {
+    for (uint32_t i = 0; i < runtime->jit_native_retired_count; ++i) {
+        fa_jit_native_free(&runtime->jit_native_retired[i]);
+    }
+    runtime->jit_native_retired_count = 0;
+}
+
+/* Drops the native code of `entry` and uncharges it. Callers only reach code
+   through jit_native_entries, so unpublishing is the whole relocation: the
+   next call goes through call_slow and recompiles. While native frames are
+   live the code may still be on the machine stack, so it is parked until the
+   outermost native call returns instead of being released. Returns false
+   (leaving the code resident) only when parking fails. */
+static bool runtime_jit_native_evict(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry) {
+    if (!entry || !entry->native.map) {
+        if (entry) {
+            entry->native_attempted = false;
+        }
+        return true;
+    }
+    const size_t bytes = entry->native.map_bytes;
+    if (runtime && runtime->jit_native_active > 0) {
+        if (runtime->jit_native_retired_count == runtime->jit_native_retired_capacity) {
+            const uint32_t capacity = runtime->jit_native_retired_capacity ? runtime->jit_native_retired_capacity * 2U : 4U;
+            fa_JitNativeCode* grown = (fa_JitNativeCode*)realloc(runtime->jit_native_retired,
+                                                                 capacity * sizeof(fa_JitNativeCode));
+            if (!grown) {
+                return false;
+            }
+            runtime->jit_native_retired = grown;
+            runtime->jit_native_retired_capacity = capacity;
+        }
+        runtime->jit_native_retired[runtime->jit_native_retired_count++] = entry->native;
+        memset(&entry->native, 0, sizeof(entry->native));
+    }
+    if (runtime && runtime->jit_cache_bytes >= bytes) {
+        runtime->jit_cache_bytes -= bytes;
+    }
+    if (runtime && runtime->jit_native_entries && entry->func_index < runtime->jit_cache_count) {
+        runtime->jit_native_entries[entry->func_index] = NULL;
+    }
+    fa_jit_native_free(&entry->native);
+    entry->native_attempted = false;
+    return true;
+}
+
 static void runtime_jit_cache_entry_free(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry) {
     if (!entry) {
         return;
     }
     runtime_jit_cache_release_program(runtime, entry);
-    free(entry->opcodes);
-    free(entry->offsets);
-    free(entry->pc_to_index);
+    if (!entry->shared) {
+        free(entry->opcodes);
+        free(entry->offsets);
+        free(entry->pc_to_index);
+        free(entry->blocks);
+    }
+    entry->shared = false;
     entry->opcodes = NULL;
     entry->offsets = NULL;
     entry->pc_to_index = NULL;
+    entry->blocks = NULL;
+    entry->block_count = 0;
+    entry->prescanned = false;
+    entry->prefetch_pending = false;
     entry->count = 0;
     entry->capacity = 0;
     entry->pc_to_index_len = 0;
     entry->spilled = false;
+    runtime_jit_native_evict(runtime, entry);
+    entry->hits = 0;
+    entry->clock_weight = 0;
+    entry->pins = 0;
+    entry->evicted = false;
+    entry->tier_hits = 0;
+    entry->osr_failed = false;
+    entry->prepare_pending = false;
+    entry->closure_attempted = false;
 }
 
 static void runtime_jit_cache_clear(fa_Runtime* runtime) {
     if (!runtime) {
         return;
     }
+    /* Workers read the module and hold tasks for these entries. */
+    fa_jit_workers_destroy(runtime->jit_workers);
+    runtime->jit_workers = NULL;
     if (runtime->jit_cache) {
         for (uint32_t i = 0; i < runtime->jit_cache_count; ++i) {
             runtime_jit_cache_entry_free(runtime, &runtime->jit_cache[i]);
         }
         free(runtime->jit_cache);
     }
+    runtime_jit_native_reclaim(runtime);
+    free(runtime->jit_native_retired);
+    if (runtime->jit_code_cache) {
+        fa_jit_code_cache_destroy(runtime->jit_code_cache);
+        free(runtime->jit_code_cache);
+    }
+    free(runtime->jit_native_entries);
+    free(runtime->jit_native_slots);
+    runtime->jit_code_cache = NULL;
+    runtime->jit_native_retired = NULL;
+    runtime->jit_native_retired_capacity = 0;
+    runtime->jit_native_entries = NULL;
+    runtime->jit_native_slots = NULL;
+    runtime->jit_native_slot_top = 0;
     runtime->jit_cache = NULL;
     runtime->jit_cache_count = 0;
     runtime->jit_cache_bytes = 0;
-    runtime->jit_cache_eviction_cursor = 0;
+    runtime->jit_cache_clock_hand = 0;
+    runtime->jit_cache_access_ticks = 0;
     runtime->jit_cache_prescanned = false;
-    runtime->host_bindings = NULL;
-    runtime->host_binding_count = 0;
-    runtime->host_binding_capacity = 0;
+}
+
+/* Microcode ready to run or closure records: what eviction drops and spills. */
+static bool runtime_jit_cache_program_resident(const fa_JitProgramCacheEntry* entry) {
+    return (entry->ready && entry->program.count > 0) || entry->program.closure != NULL;
 }
 
 static void runtime_jit_cache_evict_entry(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry) {
@@ -1619,7 +2381,7 @@ static void runtime_jit_cache_evict_entry(fa_Runtime* runtime, fa_JitProgramCach
         return;
     }
     bool spilled = false;
-    if (entry->ready && entry->program.count > 0 && runtime->spill_hooks.jit_spill) {
+    if (runtime_jit_cache_program_resident(entry) && runtime->spill_hooks.jit_spill) {
         int status = runtime->spill_hooks.jit_spill(runtime,
                                                     entry->func_index,
                                                     &entry->program,
@@ -1629,6 +2391,115 @@ static void runtime_jit_cache_evict_entry(fa_Runtime* runtime, fa_JitProgramCach
     }
     runtime_jit_cache_release_program(runtime, entry);
     entry->spilled = spilled;
+    entry->evicted = true;
+    entry->closure_attempted = false;
+}
+
+static size_t runtime_jit_cache_resident_bytes(const fa_JitProgramCacheEntry* entry) {
+    size_t bytes = entry->native.map ? entry->native.map_bytes : 0;
+    if (runtime_jit_cache_program_resident(entry)) {
+        bytes += entry->program_bytes;
+    }
+    return bytes;
+}
+
+/* Records one access (a call entered through the runtime or a loop
+   back-edge). LFU counters are halved every `eviction_aging_interval`
+   accesses so functions that were hot long ago do not stay resident. */
+static void runtime_jit_cache_touch(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry) {
+    if (!runtime || !entry) {
+        return;
+    }
+    entry->hits++;
+    if (entry->tier_hits < UINT32_MAX) {
+        entry->tier_hits++;
+    }
+    if (entry->clock_weight < FA_JIT_CLOCK_MAX_WEIGHT) {
+        entry->clock_weight++;
+    }
+    const uint32_t interval = runtime->jit_context.config.eviction_aging_interval;
+    if (interval == 0 || ++runtime->jit_cache_access_ticks < interval) {
+        return;
+    }
+    runtime->jit_cache_access_ticks = 0;
+    for (uint32_t i = 0; i < runtime->jit_cache_count; ++i) {
+        runtime->jit_cache[i].hits >>= 1;
+    }
+}
+
+static bool runtime_jit_cache_evictable(const fa_JitProgramCacheEntry* entry, uint32_t protect_index) {
+    return entry->func_index != protect_index && entry->pins == 0 && runtime_jit_cache_resident_bytes(entry) > 0;
+}
+
+/* LFU: fewest aged accesses and, among equally cold functions, the largest,
+   so each eviction frees as much as possible. */
+static fa_JitProgramCacheEntry* runtime_jit_cache_victim_lfu(fa_Runtime* runtime, uint32_t protect_index) {
+    fa_JitProgramCacheEntry* victim = NULL;
+    size_t victim_bytes = 0;
+    for (uint32_t i = 0; i < runtime->jit_cache_count; ++i) {
+        fa_JitProgramCacheEntry* entry = &runtime->jit_cache[i];
+        if (!runtime_jit_cache_evictable(entry, protect_index)) {
+            continue;
+        }
+        const size_t bytes = runtime_jit_cache_resident_bytes(entry);
+        if (!victim || entry->hits < victim->hits || (entry->hits == victim->hits && bytes > victim_bytes)) {
+            victim = entry;
+            victim_bytes = bytes;
+        }
+    }
+    return victim;
+}
+
+/* CLOCK / round-robin: walk from the hand. CLOCK decays each candidate's
+   weight as the hand passes and takes the first one already at zero, so a
+   function survives one sweep per recent access (up to the weight cap). */
+static fa_JitProgramCacheEntry* runtime_jit_cache_victim_clock(fa_Runtime* runtime,
+                                                               uint32_t protect_index,
+                                                               bool decay) {
+    const uint32_t count = runtime->jit_cache_count;
+    const uint32_t steps = count * (decay ? FA_JIT_CLOCK_MAX_WEIGHT + 1U : 1U);
+    for (uint32_t step = 0; step < steps; ++step) {
+        const uint32_t index = runtime->jit_cache_clock_hand % count;
+        runtime->jit_cache_clock_hand = (index + 1U) % count;
+        fa_JitProgramCacheEntry* entry = &runtime->jit_cache[index];
+        if (!runtime_jit_cache_evictable(entry, protect_index)) {
+            continue;
+        }
+        if (decay && entry->clock_weight > 0) {
+            entry->clock_weight--;
+            continue;
+        }
+        return entry;
+    }
+    return NULL;
+}
+
+/* Evicts both tiers of one function chosen by the configured policy. */
+static bool runtime_jit_cache_evict_one(fa_Runtime* runtime, uint32_t protect_index) {
+    fa_JitProgramCacheEntry* victim = NULL;
+    switch (runtime->jit_context.config.eviction_policy) {
+        case FA_JIT_EVICT_CLOCK:
+            victim = runtime_jit_cache_victim_clock(runtime, protect_index, true);
+            break;
+        case FA_JIT_EVICT_ROUND_ROBIN:
+            victim = runtime_jit_cache_victim_clock(runtime, protect_index, false);
+            break;
+        case FA_JIT_EVICT_LFU:
+        default:
+            victim = runtime_jit_cache_victim_lfu(runtime, protect_index);
+            break;
+    }
+    if (!victim) {
+        return false;
+    }
+    if (runtime_jit_cache_program_resident(victim)) {
+        runtime_jit_cache_evict_entry(runtime, victim);
+    }
+    if (!runtime_jit_native_evict(runtime, victim)) {
+        return false;
+    }
+    runtime->jit_cache_evictions++;
+    return true;
 }
 
 static bool runtime_jit_cache_reserve_bytes(fa_Runtime* runtime, size_t bytes_needed, uint32_t protect_index) {
@@ -1648,25 +2519,32 @@ static bool runtime_jit_cache_reserve_bytes(fa_Runtime* runtime, size_t bytes_ne
     if (!runtime->jit_cache || runtime->jit_cache_count == 0) {
         return false;
     }
-    size_t attempts = runtime->jit_cache_count;
-    while (runtime->jit_cache_bytes + bytes_needed > budget && attempts > 0) {
-        uint32_t index = runtime->jit_cache_eviction_cursor % runtime->jit_cache_count;
-        runtime->jit_cache_eviction_cursor = (index + 1U) % runtime->jit_cache_count;
-        if (index == protect_index) {
-            --attempts;
-            continue;
-        }
-        fa_JitProgramCacheEntry* entry = &runtime->jit_cache[index];
-        if (!entry->ready || entry->program.count == 0) {
-            --attempts;
-            continue;
+    while (runtime->jit_cache_bytes + bytes_needed > budget) {
+        if (!runtime_jit_cache_evict_one(runtime, protect_index)) {
+            break;
         }
-        runtime_jit_cache_evict_entry(runtime, entry);
-        --attempts;
     }
     return runtime->jit_cache_bytes + bytes_needed <= budget;
 }
 
+/* Pairs up adjacent ops of the entry's program that have a fused handler. */
+static void runtime_jit_fuse_program(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry) {
+    if (runtime->jit_context.config.fuse_ops) {
+        (void)fa_jit_program_fuse(&entry->program, entry->offsets, entry->count);
+    }
+}
+
+/* Keeps the entry's closure records across a program swap: they may be
+   running, and a reloaded copy would be identical. */
+static void runtime_jit_closure_carry(fa_JitProgramCacheEntry* entry, fa_JitProgram* program) {
+    if (!entry->program.closure) {
+        return;
+    }
+    fa_jit_closure_free(program->closure);
+    program->closure = entry->program.closure;
+    entry->program.closure = NULL;
+}
+
 static int runtime_jit_cache_load_entry(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry) {
     if (!runtime || !entry) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
@@ -1674,7 +2552,8 @@ static int runtime_jit_cache_load_entry(fa_Runtime* runtime, fa_JitProgramCacheE
     if (!runtime->spill_hooks.jit_load) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
-    if (!entry->pc_to_index || entry->pc_to_index_len == 0) {
+    const bool mapped = entry->pc_to_index && entry->pc_to_index_len > 0;
+    if (!mapped && runtime->jit_context.decision.tier != FA_JIT_TIER_CLOSURE) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
     fa_JitProgram loaded;
@@ -1684,34 +2563,92 @@ static int runtime_jit_cache_load_entry(fa_Runtime* runtime, fa_JitProgramCacheE
         fa_jit_program_free(&loaded);
         return status;
     }
+    if (loaded.closure && !fa_jit_closure_globals_valid(loaded.closure, runtime->module)) {
+        fa_jit_program_free(&loaded);
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    if (!mapped) {
+        /* Only ever entered through its closure records: the microcode half
+           has no pc map to run against, so keep just the records. */
+        fa_JitClosureProgram* closure = loaded.closure;
+        loaded.closure = NULL;
+        fa_jit_program_free(&loaded);
+        fa_jit_program_init(&loaded);
+        loaded.closure = closure;
+        if (!closure) {
+            return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+        }
+    }
     size_t bytes = fa_jit_program_estimate_bytes(&loaded);
     if (!runtime_jit_cache_reserve_bytes(runtime, bytes, entry->func_index)) {
         fa_jit_program_free(&loaded);
         return FA_RUNTIME_ERR_OUT_OF_MEMORY;
     }
+    runtime_jit_closure_carry(entry, &loaded);
     runtime_jit_cache_release_program(runtime, entry);
     entry->program = loaded;
-    entry->program_bytes = bytes;
-    runtime->jit_cache_bytes += bytes;
+    entry->program_bytes = fa_jit_program_estimate_bytes(&entry->program);
+    runtime->jit_cache_bytes += entry->program_bytes;
     entry->prepared_count = entry->program.count;
+    runtime_jit_fuse_program(runtime, entry);
     entry->ready = entry->program.count > 0;
     entry->spilled = false;
-    return entry->ready ? FA_RUNTIME_OK : FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    entry->evicted = false;
+    return runtime_jit_cache_program_resident(entry) ? FA_RUNTIME_OK : FA_RUNTIME_ERR_INVALID_ARGUMENT;
 }
 
 static bool runtime_jit_prepare_program(fa_Runtime* runtime,
                                         fa_JitProgramCacheEntry* entry,
                                         size_t opcode_count);
+static bool runtime_jit_install_program(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry, fa_JitProgram* program);
+static bool runtime_jit_adopt_program(fa_Runtime* runtime,
+                                      fa_JitProgramCacheEntry* entry,
+                                      size_t opcode_count,
+                                      fa_JitProgram* lowered);
 static int runtime_jit_cache_prescan(fa_Runtime* runtime);
 
+/* Points every entry at the compiled module's scan results and lowered
+   programs. Nothing is copied or charged: the entries only become private
+   when this runtime lowers a longer program, spills or is evicted. */
+static void runtime_jit_cache_borrow(fa_Runtime* runtime, const fa_CompiledModule* compiled) {
+    for (uint32_t i = 0; i < runtime->jit_cache_count && i < compiled->code_count; ++i) {
+        const fa_JitProgramCacheEntry* code = &compiled->code[i];
+        fa_JitProgramCacheEntry* entry = &runtime->jit_cache[i];
+        entry->shared = true;
+        entry->opcodes = code->opcodes;
+        entry->offsets = code->offsets;
+        entry->count = code->count;
+        entry->capacity = code->count;
+        entry->pc_to_index = code->pc_to_index;
+        entry->pc_to_index_len = code->pc_to_index_len;
+        entry->blocks = code->blocks;
+        entry->block_count = code->block_count;
+        entry->prescanned = code->prescanned;
+        if (code->ready && code->program.count > 0) {
+            entry->program = code->program;
+            entry->program.closure = NULL;
+            entry->program_shared = true;
+            entry->prepared_count = code->prepared_count;
+            entry->ready = true;
+        }
+    }
+    runtime->jit_prescan_blocks = compiled->prescan_blocks;
+    runtime->jit_prescan_programs = compiled->prescan_programs;
+    runtime->jit_cache_prescanned = true;
+}
+
 static int runtime_jit_cache_init(fa_Runtime* runtime) {
     if (!runtime || !runtime->module) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
     runtime_jit_cache_clear(runtime);
     runtime->jit_cache_bytes = 0;
-    runtime->jit_cache_eviction_cursor = 0;
     runtime->jit_cache_prescanned = false;
+    runtime->jit_prescan_threads = 0;
+    runtime->jit_prescan_blocks = 0;
+    runtime->jit_prescan_programs = 0;
+    runtime->jit_prescan_lazy = 0;
+    runtime->jit_prescan_prefetched = 0;
     if (runtime->module->num_functions == 0) {
         return FA_RUNTIME_OK;
     }
@@ -1727,7 +2664,12 @@ static int runtime_jit_cache_init(fa_Runtime* runtime) {
         runtime->jit_cache[i].program_bytes = 0;
         runtime->jit_cache[i].spilled = false;
     }
-    if (runtime->jit_context.config.prescan_functions || runtime->jit_context.config.prescan_force) {
+    if (runtime->compiled) {
+        runtime_jit_cache_borrow(runtime, runtime->compiled);
+        return FA_RUNTIME_OK;
+    }
+    if ((runtime->jit_context.config.prescan_functions || runtime->jit_context.config.prescan_force) &&
+        !runtime->jit_context.config.prescan_lazy) {
         int status = runtime_jit_cache_prescan(runtime);
         if (status != FA_RUNTIME_OK) {
             runtime_jit_cache_clear(runtime);
@@ -1775,7 +2717,8 @@ static int runtime_jit_cache_record_opcode(fa_JitProgramCacheEntry* entry, uint3
     if (!entry) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
-    if (opcode_pc >= entry->body_size) {
+    if (opcode_pc >= entry->body_size || entry->shared) {
+        /* A shared entry was prescanned: every opcode is already recorded. */
         return FA_RUNTIME_OK;
     }
     if (!entry->pc_to_index) {
@@ -2068,11 +3011,51 @@ static int runtime_prescan_skip_immediates(const fa_Runtime* runtime,
     }
 }
 
+static int runtime_block_targets_push(fa_RuntimeBlockTarget** blocks,
+                                      uint32_t* count,
+                                      uint32_t* capacity,
+                                      uint32_t start_pc) {
+    if (*count == *capacity) {
+        const uint32_t next_capacity = *capacity ? *capacity * 2U : 8U;
+        fa_RuntimeBlockTarget* next =
+            (fa_RuntimeBlockTarget*)realloc(*blocks, (size_t)next_capacity * sizeof(fa_RuntimeBlockTarget));
+        if (!next) {
+            return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+        }
+        *blocks = next;
+        *capacity = next_capacity;
+    }
+    fa_RuntimeBlockTarget* target = &(*blocks)[(*count)++];
+    target->start_pc = start_pc;
+    target->else_pc = 0;
+    target->end_pc = 0;
+    return FA_RUNTIME_OK;
+}
+
+static int runtime_block_stack_push(uint32_t** stack, uint32_t* depth, uint32_t* capacity, uint32_t index) {
+    if (*depth == *capacity) {
+        const uint32_t next_capacity = *capacity ? *capacity * 2U : 8U;
+        uint32_t* next = (uint32_t*)realloc(*stack, (size_t)next_capacity * sizeof(uint32_t));
+        if (!next) {
+            return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+        }
+        *stack = next;
+        *capacity = next_capacity;
+    }
+    (*stack)[(*depth)++] = index;
+    return FA_RUNTIME_OK;
+}
+
+/* Records every opcode of `body` and builds its control side table. Touches
+   only `entry` and reads the module, so prescan workers can run it for
+   different functions at once. Mismatched block nesting fails validation. */
 static int runtime_jit_prescan_function(fa_Runtime* runtime,
                                         fa_JitProgramCacheEntry* entry,
                                         const uint8_t* body,
                                         uint32_t body_size) {
-    if (!runtime || !entry || !body) {
+    /* A shared entry's tables belong to the compiled module (or its bundle),
+       which prescanned every defined function up front. */
+    if (!runtime || !entry || !body || entry->shared) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
     uint32_t cursor = 0;
@@ -2080,21 +3063,61 @@ static int runtime_jit_prescan_function(fa_Runtime* runtime,
     if (status != FA_RUNTIME_OK) {
         return status;
     }
-    while (cursor < body_size) {
+    free(entry->blocks);
+    entry->blocks = NULL;
+    entry->block_count = 0;
+    fa_RuntimeBlockTarget* blocks = NULL;
+    uint32_t block_count = 0;
+    uint32_t block_capacity = 0;
+    uint32_t* open = NULL; /* indices into `blocks` of the enclosing blocks */
+    uint32_t open_count = 0;
+    uint32_t open_capacity = 0;
+    bool ended = false;
+    while (cursor < body_size && status == FA_RUNTIME_OK) {
         uint32_t opcode_pc = cursor;
         uint8_t opcode = body[cursor++];
         status = runtime_jit_cache_record_opcode(entry, opcode_pc, opcode);
         if (status != FA_RUNTIME_OK) {
-            return status;
+            break;
         }
         status = runtime_prescan_skip_immediates(runtime, body, body_size, &cursor, opcode);
         if (status != FA_RUNTIME_OK) {
-            return status;
-        }
-        if (opcode == 0x0B && cursor >= body_size) {
             break;
         }
+        if (opcode == 0x02 || opcode == 0x03 || opcode == 0x04) {
+            status = runtime_block_stack_push(&open, &open_count, &open_capacity, block_count);
+            if (status == FA_RUNTIME_OK) {
+                status = runtime_block_targets_push(&blocks, &block_count, &block_capacity, cursor);
+            }
+        } else if (opcode == 0x05) {
+            if (open_count == 0) {
+                status = FA_RUNTIME_ERR_STREAM;
+            } else if (blocks[open[open_count - 1U]].else_pc == 0) {
+                blocks[open[open_count - 1U]].else_pc = cursor;
+            }
+        } else if (opcode == 0x0B) {
+            if (open_count > 0) {
+                blocks[open[--open_count]].end_pc = cursor;
+            } else {
+                /* The function's own end must be the last byte. */
+                ended = true;
+                if (cursor < body_size) {
+                    status = FA_RUNTIME_ERR_STREAM;
+                }
+            }
+        }
     }
+    free(open);
+    if (status == FA_RUNTIME_OK && (!ended || open_count > 0)) {
+        status = FA_RUNTIME_ERR_STREAM;
+    }
+    if (status != FA_RUNTIME_OK) {
+        free(blocks);
+        return status;
+    }
+    entry->blocks = blocks;
+    entry->block_count = block_count;
+    entry->prescanned = true;
     return FA_RUNTIME_OK;
 }
 
@@ -2113,15 +3136,157 @@ static bool runtime_jit_precompile_allowed(const fa_Runtime* runtime) {
     return fa_ops_microcode_enabled();
 }
 
+/* How many opcodes of `entry` the prescan lowers, 0 for none. Lowering walks
+   functions in index order until `max_chunks` programs or the cache budget
+   are used up, whichever thread did the scanning. */
+static size_t runtime_jit_prescan_lower_count(const fa_Runtime* runtime,
+                                              const fa_JitProgramCacheEntry* entry,
+                                              uint32_t precompiled) {
+    const fa_JitBudget* budget = &runtime->jit_context.decision.budget;
+    if (entry->count == 0 || budget->cache_budget_bytes == 0 ||
+        (budget->max_chunks > 0 && precompiled >= budget->max_chunks)) {
+        return 0;
+    }
+    size_t opcode_count = entry->count;
+    if (budget->max_ops_per_chunk > 0 && opcode_count > budget->max_ops_per_chunk) {
+        opcode_count = budget->max_ops_per_chunk;
+    }
+    const size_t estimate = runtime_jit_program_bytes_for_ops(opcode_count);
+    if (runtime->jit_cache_bytes + estimate > (size_t)budget->cache_budget_bytes) {
+        return 0;
+    }
+    return opcode_count;
+}
+
+/* Worker side of the parallel prescan: scan, then lower speculatively; the
+   attaching thread decides in index order whether the program is kept. */
+static int runtime_jit_prescan_task(fa_JitTask* task) {
+    fa_Runtime* runtime = (fa_Runtime*)task->user;
+    fa_JitProgramCacheEntry* entry = &runtime->jit_cache[task->func_index];
+    int status = runtime_jit_prescan_function(runtime, entry, task->body, task->body_size);
+    free(task->body);
+    task->body = NULL;
+    if (status == FA_RUNTIME_OK && task->opcode_count > 0 && entry->count > 0) {
+        const size_t opcode_count = entry->count < task->opcode_count ? entry->count : task->opcode_count;
+        task->ok = fa_jit_prepare_program_from_opcodes(entry->opcodes, opcode_count, &task->program);
+    }
+    return status;
+}
+
+static uint32_t runtime_jit_prescan_thread_count(const fa_Runtime* runtime) {
+    uint32_t threads = runtime->jit_context.config.prescan_threads;
+    if (threads == FA_JIT_PRESCAN_THREADS_AUTO) {
+        threads = runtime->jit_context.probe.cpu_count;
+    }
+    if (threads > FA_JIT_WORKERS_MAX) {
+        threads = FA_JIT_WORKERS_MAX;
+    }
+    return fa_jit_workers_supported() ? threads : 0U;
+}
+
+/* Fans the scan out over a pool that lives for this call only. Bodies are
+   read on this thread (module reads are not thread safe) and scanned as they
+   are handed over; results are installed in index order afterwards, so the
+   cache ends up exactly as the serial walk leaves it. Returns false without
+   touching any entry when no pool could be started. */
+static bool runtime_jit_cache_prescan_parallel(fa_Runtime* runtime,
+                                               uint32_t threads,
+                                               bool allow_precompile,
+                                               int* status_out) {
+    WasmModule* module = runtime->module;
+    fa_JitTask** tasks = (fa_JitTask**)calloc(module->num_functions, sizeof(fa_JitTask*));
+    fa_JitWorkerPool* pool = tasks ? fa_jit_workers_create(threads) : NULL;
+    if (!pool) {
+        free(tasks);
+        return false;
+    }
+    const uint32_t max_ops = runtime->jit_context.decision.budget.max_ops_per_chunk;
+    const bool lower = allow_precompile && runtime->jit_context.decision.budget.cache_budget_bytes > 0;
+    int status = FA_RUNTIME_OK;
+    uint32_t submitted_end = module->num_functions;
+    for (uint32_t i = 0; i < module->num_functions; ++i) {
+        if (module->functions[i].is_imported) {
+            continue;
+        }
+        fa_JitTask* task = (fa_JitTask*)calloc(1, sizeof(fa_JitTask));
+        uint8_t* body = task ? wasm_load_function_body(module, i) : NULL;
+        if (!body) {
+            free(task);
+            status = task ? FA_RUNTIME_ERR_STREAM : FA_RUNTIME_ERR_OUT_OF_MEMORY;
+            submitted_end = i;
+            break;
+        }
+        task->kind = FA_JIT_TASK_PRESCAN;
+        task->func_index = i;
+        task->prescan = runtime_jit_prescan_task;
+        task->user = runtime;
+        task->body = body;
+        task->body_size = runtime->jit_cache[i].body_size;
+        task->opcode_count = lower ? (max_ops > 0 ? (size_t)max_ops : SIZE_MAX) : 0;
+        fa_jit_program_init(&task->program);
+        if (!fa_jit_workers_submit(pool, task)) {
+            fa_jit_task_free(task);
+            status = FA_RUNTIME_ERR_OUT_OF_MEMORY;
+            submitted_end = i;
+            break;
+        }
+    }
+    fa_jit_workers_wait_idle(pool);
+    for (fa_JitTask* task = fa_jit_workers_take_done(pool); task;) {
+        fa_JitTask* next = task->next;
+        task->next = NULL;
+        tasks[task->func_index] = task;
+        task = next;
+    }
+    runtime->jit_prescan_threads = threads;
+    fa_jit_workers_destroy(pool);
+
+    /* The first failure in index order wins, as in the serial walk. */
+    for (uint32_t i = 0; i < submitted_end; ++i) {
+        if (tasks[i] && tasks[i]->status != FA_RUNTIME_OK) {
+            status = tasks[i]->status;
+            break;
+        }
+    }
+    for (uint32_t i = 0; i < module->num_functions; ++i) {
+        fa_JitTask* task = tasks[i];
+        if (!task) {
+            continue;
+        }
+        if (status == FA_RUNTIME_OK) {
+            fa_JitProgramCacheEntry* entry = &runtime->jit_cache[i];
+            runtime->jit_prescan_blocks += entry->block_count;
+            const size_t opcode_count =
+                allow_precompile ? runtime_jit_prescan_lower_count(runtime, entry, runtime->jit_prescan_programs) : 0;
+            if (opcode_count > 0 && task->ok &&
+                runtime_jit_adopt_program(runtime, entry, opcode_count, &task->program)) {
+                runtime->jit_prescan_programs++;
+            }
+        }
+        fa_jit_task_free(task);
+    }
+    free(tasks);
+    *status_out = status;
+    return true;
+}
+
 static int runtime_jit_cache_prescan(fa_Runtime* runtime) {
     if (!runtime || !runtime->module) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
     const bool allow_precompile = runtime_jit_precompile_allowed(runtime);
-    const size_t budget_bytes = (size_t)runtime->jit_context.decision.budget.cache_budget_bytes;
-    const uint32_t max_ops_per_chunk = runtime->jit_context.decision.budget.max_ops_per_chunk;
-    const uint32_t max_chunks = runtime->jit_context.decision.budget.max_chunks;
-    uint32_t precompiled = 0;
+    runtime->jit_prescan_threads = 0;
+    runtime->jit_prescan_blocks = 0;
+    runtime->jit_prescan_programs = 0;
+    const uint32_t threads = runtime_jit_prescan_thread_count(runtime);
+    int status = FA_RUNTIME_OK;
+    if (threads > 0 && runtime->jit_cache &&
+        runtime_jit_cache_prescan_parallel(runtime, threads, allow_precompile, &status)) {
+        if (status == FA_RUNTIME_OK) {
+            runtime->jit_cache_prescanned = true;
+        }
+        return status;
+    }
     for (uint32_t i = 0; i < runtime->module->num_functions; ++i) {
         if (runtime->module->functions[i].is_imported) {
             continue;
@@ -2134,26 +3299,16 @@ static int runtime_jit_cache_prescan(fa_Runtime* runtime) {
         if (!body) {
             return FA_RUNTIME_ERR_STREAM;
         }
-        int status = runtime_jit_prescan_function(runtime, entry, body, entry->body_size);
+        status = runtime_jit_prescan_function(runtime, entry, body, entry->body_size);
         free(body);
         if (status != FA_RUNTIME_OK) {
             return status;
         }
-        if (allow_precompile && entry->count > 0) {
-            if (max_chunks == 0 || precompiled < max_chunks) {
-                if (budget_bytes > 0) {
-                    size_t opcode_count = entry->count;
-                    if (max_ops_per_chunk > 0 && opcode_count > max_ops_per_chunk) {
-                        opcode_count = max_ops_per_chunk;
-                    }
-                    const size_t estimate = runtime_jit_program_bytes_for_ops(opcode_count);
-                    if (runtime->jit_cache_bytes + estimate <= budget_bytes) {
-                        if (runtime_jit_prepare_program(runtime, entry, opcode_count)) {
-                            precompiled++;
-                        }
-                    }
-                }
-            }
+        runtime->jit_prescan_blocks += entry->block_count;
+        const size_t opcode_count =
+            allow_precompile ? runtime_jit_prescan_lower_count(runtime, entry, runtime->jit_prescan_programs) : 0;
+        if (opcode_count > 0 && runtime_jit_prepare_program(runtime, entry, opcode_count)) {
+            runtime->jit_prescan_programs++;
         }
     }
     runtime->jit_cache_prescanned = true;
@@ -2193,26 +3348,90 @@ static bool runtime_jit_prepare_program(fa_Runtime* runtime, fa_JitProgramCacheE
         fa_jit_program_free(&temp);
         return false;
     }
-    const size_t program_bytes = fa_jit_program_estimate_bytes(&temp);
+    return runtime_jit_install_program(runtime, entry, &temp);
+}
+
+/* runtime_jit_prepare_program for a program a prescan worker already lowered
+   from the same `opcode_count` opcodes; takes ownership of `lowered`. */
+static bool runtime_jit_adopt_program(fa_Runtime* runtime,
+                                      fa_JitProgramCacheEntry* entry,
+                                      size_t opcode_count,
+                                      fa_JitProgram* lowered) {
+    const size_t estimate_bytes = runtime_jit_program_bytes_for_ops(opcode_count);
+    if (!runtime_jit_cache_reserve_bytes(runtime, estimate_bytes, entry->func_index)) {
+        fa_jit_program_free(lowered);
+        return false;
+    }
+    return runtime_jit_install_program(runtime, entry, lowered);
+}
+
+/* Charges `program` to the cache budget and makes it the entry's program,
+   taking ownership (it is freed when the budget cannot fit it). */
+static bool runtime_jit_install_program(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry, fa_JitProgram* program) {
+    const size_t program_bytes = fa_jit_program_estimate_bytes(program);
     if (!runtime_jit_cache_reserve_bytes(runtime, program_bytes, entry->func_index)) {
-        fa_jit_program_free(&temp);
+        fa_jit_program_free(program);
         return false;
     }
+    runtime_jit_closure_carry(entry, program);
     runtime_jit_cache_release_program(runtime, entry);
-    entry->program = temp;
-    entry->program_bytes = program_bytes;
-    runtime->jit_cache_bytes += program_bytes;
+    entry->program = *program;
+    fa_jit_program_init(program);
+    entry->program_bytes = fa_jit_program_estimate_bytes(&entry->program);
+    runtime->jit_cache_bytes += entry->program_bytes;
     entry->prepared_count = entry->program.count;
+    runtime_jit_fuse_program(runtime, entry);
     entry->ready = true;
     entry->spilled = false;
+    if (entry->evicted) {
+        runtime->jit_cache_reprepares++;
+        entry->evicted = false;
+    }
     return true;
 }
 
+/* The background pool, started on first use when worker_threads > 0. */
+static fa_JitWorkerPool* runtime_jit_workers(fa_Runtime* runtime) {
+    if (!runtime->jit_workers && runtime->jit_context.config.worker_threads > 0 && fa_jit_workers_supported()) {
+        runtime->jit_workers = fa_jit_workers_create(runtime->jit_context.config.worker_threads);
+    }
+    return runtime->jit_workers;
+}
+
+/* Queues a preparation of the opcodes recorded so far. The interpreter keeps
+   running the ops past the installed program until the result lands. */
+static void runtime_jit_submit_prepare(fa_JitWorkerPool* workers,
+                                       fa_JitProgramCacheEntry* entry,
+                                       size_t opcode_count) {
+    if (entry->prepare_pending) {
+        return;
+    }
+    fa_JitTask* task = (fa_JitTask*)calloc(1, sizeof(fa_JitTask));
+    if (!task) {
+        return;
+    }
+    task->kind = FA_JIT_TASK_MICROCODE;
+    task->func_index = entry->func_index;
+    task->opcodes = (uint8_t*)malloc(opcode_count);
+    task->opcode_count = opcode_count;
+    fa_jit_program_init(&task->program);
+    if (!task->opcodes) {
+        fa_jit_task_free(task);
+        return;
+    }
+    memcpy(task->opcodes, entry->opcodes, opcode_count);
+    if (!fa_jit_workers_submit(workers, task)) {
+        fa_jit_task_free(task);
+        return;
+    }
+    entry->prepare_pending = true;
+}
+
 static void runtime_jit_maybe_prepare(fa_Runtime* runtime, fa_RuntimeCallFrame* frame) {
     if (!runtime || !frame) {
         return;
     }
-    if (runtime->jit_context.decision.tier != FA_JIT_TIER_MICROCODE) {
+    if (runtime->jit_context.decision.tier == FA_JIT_TIER_OFF) {
         return;
     }
     if (!fa_ops_microcode_enabled()) {
@@ -2235,6 +3454,14 @@ static void runtime_jit_maybe_prepare(fa_Runtime* runtime, fa_RuntimeCallFrame*
         opcode_count > runtime->jit_context.decision.budget.max_ops_per_chunk) {
         opcode_count = runtime->jit_context.decision.budget.max_ops_per_chunk;
     }
+    fa_JitWorkerPool* workers = runtime_jit_workers(runtime);
+    if (workers) {
+        if (entry->ready && entry->program.count >= opcode_count) {
+            return;
+        }
+        runtime_jit_submit_prepare(workers, entry, opcode_count);
+        return;
+    }
     (void)runtime_jit_prepare_program(runtime, entry, opcode_count);
 }
 
@@ -2244,7 +3471,7 @@ static const fa_JitPreparedOp* runtime_jit_lookup_prepared(fa_Runtime* runtime,
     if (!runtime || !frame) {
         return NULL;
     }
-    if (runtime->jit_context.decision.tier != FA_JIT_TIER_MICROCODE) {
+    if (runtime->jit_context.decision.tier == FA_JIT_TIER_OFF) {
         return NULL;
     }
     if (!fa_ops_microcode_enabled()) {
@@ -2605,13 +3832,43 @@ static int runtime_scan_block(const uint8_t* body,
     return FA_RUNTIME_ERR_STREAM;
 }
 
-static bool runtime_job_value_truthy(const fa_JobValue* value) {
-    if (!value) {
-        return false;
-    }
-    switch (value->kind) {
-        case fa_job_value_i32:
-            return value->payload.i32_value != 0;
+/* Side-table lookup for the block whose body starts at frame->pc, falling back
+   to a forward scan when the function was not prescanned. */
+static int runtime_find_block(fa_Runtime* runtime,
+                              const fa_RuntimeCallFrame* frame,
+                              const uint8_t* body,
+                              uint32_t body_size,
+                              uint32_t* else_pc_out,
+                              uint32_t* end_pc_out) {
+    const fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, frame->func_index);
+    if (entry && entry->block_count > 0) {
+        uint32_t lo = 0;
+        uint32_t hi = entry->block_count;
+        while (lo < hi) {
+            const uint32_t mid = lo + (hi - lo) / 2U;
+            const fa_RuntimeBlockTarget* target = &entry->blocks[mid];
+            if (target->start_pc == frame->pc) {
+                *else_pc_out = target->else_pc;
+                *end_pc_out = target->end_pc;
+                return FA_RUNTIME_OK;
+            }
+            if (target->start_pc < frame->pc) {
+                lo = mid + 1U;
+            } else {
+                hi = mid;
+            }
+        }
+    }
+    return runtime_scan_block(body, body_size, runtime, frame->pc, else_pc_out, end_pc_out);
+}
+
+static bool runtime_job_value_truthy(const fa_JobValue* value) {
+    if (!value) {
+        return false;
+    }
+    switch (value->kind) {
+        case fa_job_value_i32:
+            return value->payload.i32_value != 0;
         case fa_job_value_i64:
             return value->payload.i64_value != 0;
         case fa_job_value_f32:
@@ -2648,30 +3905,6 @@ static bool runtime_job_value_matches_valtype(const fa_JobValue* value, uint8_t
     }
 }
 
-static int runtime_stack_check_types_u32(const fa_JobStack* stack, const uint32_t* types, uint32_t count) {
-    if (!stack) {
-        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
-    }
-    if (count == 0) {
-        return FA_RUNTIME_OK;
-    }
-    if (!types) {
-        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
-    }
-    if (stack->size < count) {
-        return FA_RUNTIME_ERR_TRAP;
-    }
-    for (uint32_t i = 0; i < count; ++i) {
-        const fa_JobValue* value = fa_JobStack_peek(stack, i);
-        const uint32_t type_index = count - 1U - i;
-        if (!value || types[type_index] > UINT8_MAX ||
-            !runtime_job_value_matches_valtype(value, (uint8_t)types[type_index])) {
-            return FA_RUNTIME_ERR_TRAP;
-        }
-    }
-    return FA_RUNTIME_OK;
-}
-
 static int runtime_stack_check_types_u8(const fa_JobStack* stack, const uint8_t* types, uint32_t count) {
     if (!stack) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
@@ -2916,9 +4149,7 @@ static int runtime_call_imported(fa_Runtime* runtime, fa_Job* job, uint32_t func
     if (func->type_index >= runtime->module->num_types) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
-    fa_RuntimeHostBinding* binding = runtime_find_host_binding(runtime,
-                                                               func->import_module,
-                                                               func->import_name);
+    fa_RuntimeHostBinding* binding = runtime_host_import_binding(runtime, function_index);
     if (!binding || !binding->function) {
         return FA_RUNTIME_ERR_TRAP;
     }
@@ -2956,8 +4187,7 @@ static int runtime_call_imported(fa_Runtime* runtime, fa_Job* job, uint32_t func
             free(results);
             return FA_RUNTIME_ERR_TRAP;
         }
-        if (sig->param_types[type_index] > UINT8_MAX ||
-            !runtime_job_value_matches_valtype(&args[type_index], (uint8_t)sig->param_types[type_index])) {
+        if (!runtime_job_value_matches_valtype(&args[type_index], sig->param_types[type_index])) {
             free(args);
             free(results);
             return FA_RUNTIME_ERR_TRAP;
@@ -2983,8 +4213,7 @@ static int runtime_call_imported(fa_Runtime* runtime, fa_Job* job, uint32_t func
     }
 
     for (uint32_t i = 0; i < result_count; ++i) {
-        if (sig->result_types[i] > UINT8_MAX ||
-            !runtime_job_value_matches_valtype(&results[i], (uint8_t)sig->result_types[i])) {
+        if (!runtime_job_value_matches_valtype(&results[i], sig->result_types[i])) {
             free(args);
             free(results);
             return FA_RUNTIME_ERR_TRAP;
@@ -3001,6 +4230,31 @@ static int runtime_call_imported(fa_Runtime* runtime, fa_Job* job, uint32_t func
     return FA_RUNTIME_OK;
 }
 
+/* The compiled module's copy of a function body, NULL when the runtime was
+   attached to a bare module (or for imports). */
+static const uint8_t* runtime_shared_body(const fa_Runtime* runtime, uint32_t function_index) {
+    const fa_CompiledModule* compiled = runtime->compiled;
+    if (!compiled || function_index >= compiled->code_count) {
+        return NULL;
+    }
+    return compiled->bodies[function_index];
+}
+
+/* A malloc'd body the caller owns. Copied from the compiled module when there
+   is one, so instances never move the shared module's read cursor. */
+static uint8_t* runtime_load_function_body(fa_Runtime* runtime, uint32_t function_index) {
+    const uint8_t* shared = runtime_shared_body(runtime, function_index);
+    if (!shared) {
+        return wasm_load_function_body(runtime->module, function_index);
+    }
+    const uint32_t body_size = runtime->module->functions[function_index].body_size;
+    uint8_t* body = (uint8_t*)malloc(body_size);
+    if (body) {
+        memcpy(body, shared, body_size);
+    }
+    return body;
+}
+
 static int runtime_push_frame(fa_Runtime* runtime,
                               fa_RuntimeCallFrame* frames,
                               uint32_t* depth,
@@ -3020,7 +4274,8 @@ static int runtime_push_frame(fa_Runtime* runtime,
         return FA_RUNTIME_ERR_CALL_DEPTH_EXCEEDED;
     }
 
-    uint8_t* body = wasm_load_function_body(runtime->module, function_index);
+    const uint8_t* shared_body = runtime_shared_body(runtime, function_index);
+    uint8_t* body = shared_body ? (uint8_t*)shared_body : wasm_load_function_body(runtime->module, function_index);
     if (!body) {
         return FA_RUNTIME_ERR_STREAM;
     }
@@ -3029,6 +4284,7 @@ static int runtime_push_frame(fa_Runtime* runtime,
     memset(frame, 0, sizeof(*frame));
     frame->func_index = function_index;
     frame->body = body;
+    frame->body_borrowed = shared_body != NULL;
     frame->body_size = runtime->module->functions[function_index].body_size;
 
     int status = runtime_parse_locals(runtime, frame);
@@ -3055,8 +4311,7 @@ static int runtime_push_frame(fa_Runtime* runtime,
                     const uint32_t param_index = type->num_params - 1U - i;
                     fa_JobValue arg_value;
                     if (!fa_JobStack_pop(&job->stack, &arg_value) ||
-                        type->param_types[param_index] > UINT8_MAX ||
-                        !runtime_job_value_matches_valtype(&arg_value, (uint8_t)type->param_types[param_index])) {
+                        !runtime_job_value_matches_valtype(&arg_value, type->param_types[param_index])) {
                         runtime_free_frame_resources(frame);
                         return FA_RUNTIME_ERR_TRAP;
                     }
@@ -3086,204 +4341,1814 @@ static int runtime_push_frame(fa_Runtime* runtime,
                                   type ? type->result_types : NULL,
                                   type ? type->num_results : 0,
                                   false,
-                                  0);
+                                  job->stack.size);
     if (status != FA_RUNTIME_OK) {
         runtime_free_frame_resources(frame);
         return status;
     }
 
+    fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, function_index);
+    if (entry) {
+        entry->pins++;
+    }
     *depth += 1;
     return FA_RUNTIME_OK;
 }
 
-static int runtime_call_function(fa_Runtime* runtime,
-                                 fa_RuntimeCallFrame* frames,
-                                 uint32_t* depth,
-                                 fa_Job* job,
-                                 uint32_t function_index) {
-    if (!runtime || !frames || !depth || !job) {
-        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+/* ------------------------------------------------------------------------- *
+ * Native tier glue.
+ *
+ * Compiled functions are published in `jit_native_entries`, which native
+ * callers index directly. Functions flagged with a trap stay unpublished so
+ * every call reaches call_slow (and runtime_check_function_trap). Native
+ * frames share one slot array: the interpreter enters at jit_native_slot_top
+ * and a nested interpreter started from call_slow moves the top above the
+ * native caller's live values. The closure tier uses the same context, slots
+ * and call_slow; its records live in the entry's program instead of the entry
+ * table, so every closure-to-closure call takes call_slow.
+ * ------------------------------------------------------------------------- */
+#ifndef FA_RUNTIME_JIT_NATIVE_SLOTS
+#define FA_RUNTIME_JIT_NATIVE_SLOTS 65536U
+#endif
+
+static int runtime_run_function(fa_Runtime* runtime, fa_Job* job, uint32_t function_index);
+
+static bool runtime_jit_native_memory_flat(const fa_Runtime* runtime) {
+    if (!runtime->memories || runtime->memories_count == 0) {
+        return false;
     }
-    if (!runtime->module) {
-        return FA_RUNTIME_ERR_NO_MODULE;
+    const fa_RuntimeMemory* memory = &runtime->memories[0];
+    return !memory->is_memory64 && !memory->pager;
+}
+
+/* Ahead-of-time compiled entry for `function_index`, NULL when none. */
+static fa_JitNativeEntry runtime_aot_entry(const fa_Runtime* runtime, uint32_t function_index) {
+    if (!runtime->aot_entries || function_index >= runtime->aot_entry_count) {
+        return NULL;
     }
-    if (function_index >= runtime->module->num_functions) {
-        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    return runtime->aot_entries[function_index];
+}
+
+/* Key of `function_index` in the on-disk code cache. False when the cache is
+   off or the module image cannot be hashed. */
+static bool runtime_jit_persist_key(fa_Runtime* runtime,
+                                    uint32_t function_index,
+                                    fa_JitTier tier,
+                                    fa_JitPersistKey* key) {
+    if (!runtime->jit_persist_dir || !runtime->module) {
+        return false;
     }
-    int status = runtime_check_function_trap(runtime, function_index);
-    if (status != FA_RUNTIME_OK) {
-        return status;
+    memset(key, 0, sizeof(*key));
+    if (wasm_module_content_digest(runtime->module, key->module_digest) != 0) {
+        return false;
     }
-    if (runtime->module->functions[function_index].is_imported) {
-        return runtime_call_imported(runtime, job, function_index);
+    /* Generated code addresses these structures by offset. */
+    uint32_t abi = FA_JIT_PERSIST_ABI_VERSION;
+    abi = abi * 131u + (uint32_t)sizeof(fa_JitNativeContext);
+    abi = abi * 131u + (uint32_t)sizeof(fa_RuntimeMemory);
+    abi = abi * 131u + (uint32_t)sizeof(fa_JobValue);
+    key->abi = abi;
+    key->func_index = function_index;
+    key->tier = (uint8_t)tier;
+    key->arch = tier == FA_JIT_TIER_NATIVE ? (uint8_t)FA_JIT_NATIVE_ARCH_HOST : 0u;
+    key->memory_flat = runtime_jit_native_memory_flat(runtime);
+    return true;
+}
+
+static void runtime_jit_persist_store(fa_Runtime* runtime,
+                                      uint32_t function_index,
+                                      fa_JitTier tier,
+                                      uint32_t frame_slots,
+                                      const uint8_t* data,
+                                      size_t data_bytes) {
+    fa_JitPersistKey key;
+    if (runtime_jit_persist_key(runtime, function_index, tier, &key) &&
+        fa_jit_persist_store(runtime->jit_persist_dir, &key, frame_slots, data, data_bytes)) {
+        runtime->jit_persist_stores++;
     }
-    return runtime_push_frame(runtime, frames, depth, job, function_index);
 }
 
-static void runtime_pop_frame(fa_RuntimeCallFrame* frames, uint32_t* depth) {
-    if (!frames || !depth || *depth == 0) {
+
+/* Reads the cached file for `function_index`; NULL on a miss or a stale or
+   damaged entry. `data_out` points into the returned buffer. */
+static uint8_t* runtime_jit_persist_lookup(fa_Runtime* runtime,
+                                           uint32_t function_index,
+                                           fa_JitTier tier,
+                                           uint32_t* frame_slots_out,
+                                           const uint8_t** data_out,
+                                           size_t* data_bytes_out) {
+    fa_JitPersistKey key;
+    if (!runtime_jit_persist_key(runtime, function_index, tier, &key)) {
+        return NULL;
+    }
+    size_t blob_bytes = 0;
+    uint8_t* blob = fa_jit_persist_read(runtime->jit_persist_dir, &key, &blob_bytes);
+    if (blob && !fa_jit_persist_decode(blob, blob_bytes, &key, frame_slots_out, data_out, data_bytes_out)) {
+        free(blob);
+        blob = NULL;
+    }
+    return blob;
+}
+
+/* ------------------------------------------------------------------------- *
+ * Tier-up code shared through fa_CompiledModule.
+ *
+ * Native code and closure records are position independent (which is what
+ * lets them go to the on-disk cache), so the first instance of a compiled
+ * module to tier a function up publishes the bytes there, and every other
+ * instance installs them instead of lowering and emitting the body again.
+ * Each instance still copies native code into its own code cache. A slot is
+ * set once with a compare-and-swap and never changes afterwards, so readers
+ * need no lock.
+ * ------------------------------------------------------------------------- */
+static fa_CompiledTierCode** runtime_jit_shared_slot(fa_Runtime* runtime, uint32_t function_index, fa_JitTier tier) {
+    fa_CompiledModule* compiled = runtime->compiled;
+    if (!compiled || !compiled->tier_code || function_index >= compiled->code_count) {
+        return NULL;
+    }
+    const uint32_t variant = (tier == FA_JIT_TIER_CLOSURE ? 2u : 0u) + (runtime_jit_native_memory_flat(runtime) ? 1u : 0u);
+    return &compiled->tier_code[(size_t)function_index * FA_COMPILED_TIER_SLOTS + variant];
+}
+
+static const fa_CompiledTierCode* runtime_jit_shared_lookup(fa_Runtime* runtime,
+                                                            uint32_t function_index,
+                                                            fa_JitTier tier) {
+    fa_CompiledTierCode** slot = runtime_jit_shared_slot(runtime, function_index, tier);
+    return slot ? __atomic_load_n(slot, __ATOMIC_ACQUIRE) : NULL;
+}
+
+static void runtime_jit_shared_publish(fa_Runtime* runtime,
+                                       uint32_t function_index,
+                                       fa_JitTier tier,
+                                       uint32_t frame_slots,
+                                       const uint8_t* data,
+                                       size_t data_bytes) {
+    fa_CompiledTierCode** slot = runtime_jit_shared_slot(runtime, function_index, tier);
+    if (!slot || __atomic_load_n(slot, __ATOMIC_ACQUIRE)) {
         return;
     }
-    fa_RuntimeCallFrame* frame = &frames[*depth - 1];
-    runtime_free_frame_resources(frame);
-    *depth -= 1;
+    fa_CompiledTierCode* code = (fa_CompiledTierCode*)malloc(sizeof(fa_CompiledTierCode) + data_bytes);
+    if (!code) {
+        return;
+    }
+    code->frame_slots = frame_slots;
+    code->data_bytes = data_bytes;
+    memcpy(code->data, data, data_bytes);
+    fa_CompiledTierCode* expected = NULL;
+    if (!__atomic_compare_exchange_n(slot, &expected, code, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        free(code); /* another instance got there first with the same code */
+    }
 }
 
-static bool runtime_is_function_end(const fa_RuntimeCallFrame* frame, uint8_t opcode) {
-    if (!frame) {
-        return false;
+/* Hands freshly compiled code to the other instances and the on-disk cache. */
+static void runtime_jit_code_store(fa_Runtime* runtime,
+                                   uint32_t function_index,
+                                   fa_JitTier tier,
+                                   uint32_t frame_slots,
+                                   const uint8_t* data,
+                                   size_t data_bytes) {
+    runtime_jit_shared_publish(runtime, function_index, tier, frame_slots, data, data_bytes);
+    runtime_jit_persist_store(runtime, function_index, tier, frame_slots, data, data_bytes);
+}
+
+static void runtime_jit_code_store_closure(fa_Runtime* runtime,
+                                           uint32_t function_index,
+                                           const fa_JitClosureProgram* closure) {
+    if (!runtime->jit_persist_dir && !runtime->compiled) {
+        return;
     }
-    if (opcode != 0x0B) {
-        return false;
+    const size_t bytes = fa_jit_closure_serialized_size(closure);
+    uint8_t* blob = bytes > 0 ? (uint8_t*)malloc(bytes) : NULL;
+    size_t written = 0;
+    if (blob && fa_jit_closure_serialize(closure, blob, bytes, &written)) {
+        runtime_jit_code_store(runtime, function_index, FA_JIT_TIER_CLOSURE, 0, blob, written);
     }
-    return frame->control_depth == 1;
+    free(blob);
 }
 
-fa_Runtime* fa_Runtime_init(void) {
-    fa_Runtime* runtime = (fa_Runtime*)calloc(1, sizeof(fa_Runtime));
-    if (!runtime) {
-        return NULL;
+static void runtime_jit_native_publish(fa_Runtime* runtime, uint32_t function_index) {
+    if (!runtime || !runtime->jit_native_entries) {
+        return;
     }
-    runtime->malloc = fa_default_malloc;
-    runtime->free = fa_default_free;
-    runtime->jobs = list_create(4);
-    runtime->module = NULL;
-    runtime->stream = NULL;
-    runtime->next_job_id = 1;
-    runtime->max_call_depth = 64;
-    runtime->active_locals = NULL;
-    runtime->active_locals_count = 0;
-    runtime->memories = NULL;
-    runtime->memories_count = 0;
-    runtime->tables = NULL;
-    runtime->tables_count = 0;
-    runtime->data_segments_dropped = NULL;
-    runtime->data_segments_count = 0;
-    runtime->elem_segments_dropped = NULL;
-    runtime->elem_segments_count = 0;
-    runtime->globals = NULL;
-    runtime->globals_count = 0;
-    fa_jit_context_init(&runtime->jit_context, NULL);
-    memset(&runtime->jit_stats, 0, sizeof(runtime->jit_stats));
-    runtime->jit_prepared_executions = 0;
-    runtime->jit_cache_bytes = 0;
-    runtime->jit_cache_eviction_cursor = 0;
-    runtime->jit_cache_prescanned = false;
-    runtime->function_traps = NULL;
-    runtime->function_trap_count = 0;
-    if (!runtime->jobs) {
-        fa_Runtime_free(runtime);
+    fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, function_index);
+    if (!entry) {
+        return;
+    }
+    const bool trapped = runtime->function_traps && function_index < runtime->function_trap_count &&
+                         runtime->function_traps[function_index];
+    runtime->jit_native_entries[function_index] = trapped ? NULL : entry->native.entry;
+}
+
+static fa_JitCodeCache* runtime_jit_code_cache(fa_Runtime* runtime) {
+    if (!runtime->jit_code_cache && fa_jit_code_cache_supported()) {
+        runtime->jit_code_cache = (fa_JitCodeCache*)malloc(sizeof(fa_JitCodeCache));
+        if (runtime->jit_code_cache) {
+            fa_jit_code_cache_init(runtime->jit_code_cache, 0);
+        }
+    }
+    return runtime->jit_code_cache;
+}
+
+static fa_JitNativeEntry runtime_jit_native_adopt(fa_Runtime* runtime,
+                                                  fa_JitProgramCacheEntry* entry,
+                                                  fa_JitNativeCode* code);
+
+/* Installs code another instance of the compiled module or a previous run
+   (the on-disk cache) already emitted, NULL on a miss. */
+static fa_JitNativeEntry runtime_jit_native_load_persisted(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry) {
+    const fa_CompiledTierCode* shared = runtime_jit_shared_lookup(runtime, entry->func_index, FA_JIT_TIER_NATIVE);
+    uint32_t frame_slots = shared ? shared->frame_slots : 0;
+    const uint8_t* data = shared ? shared->data : NULL;
+    size_t data_bytes = shared ? shared->data_bytes : 0;
+    uint8_t* blob = shared ? NULL
+                           : runtime_jit_persist_lookup(runtime, entry->func_index, FA_JIT_TIER_NATIVE,
+                                                        &frame_slots, &data, &data_bytes);
+    if (!shared && !blob) {
         return NULL;
     }
-    return runtime;
+    fa_JitNativeCode code;
+    fa_JitCodeCache* cache = runtime_jit_code_cache(runtime);
+    fa_JitNativeEntry native = NULL;
+    if (cache && fa_jit_native_install(data, data_bytes, frame_slots, cache, &code)) {
+        native = runtime_jit_native_adopt(runtime, entry, &code);
+    }
+    if (native && shared) {
+        runtime->jit_shared_hits++;
+    } else if (native) {
+        runtime->jit_persist_hits++;
+        runtime_jit_shared_publish(runtime, entry->func_index, FA_JIT_TIER_NATIVE, frame_slots, data, data_bytes);
+    }
+    free(blob);
+    return native;
 }
 
-void fa_Runtime_free(fa_Runtime* runtime) {
-    if (!runtime) {
-        return;
+/* Returns the compiled entry for `function_index`, compiling it once the
+   function's tier-up counter reaches native_threshold. NULL means the
+   function stays interpreted (for now). */
+static fa_JitNativeEntry runtime_jit_native_ensure(fa_Runtime* runtime, uint32_t function_index) {
+    if (!runtime || !runtime->module || runtime->jit_context.decision.tier != FA_JIT_TIER_NATIVE) {
+        return NULL;
     }
-    if (runtime->jobs) {
-        while (list_count(runtime->jobs) > 0) {
-            fa_Job* job = (fa_Job*)list_pop(runtime->jobs);
-            if (job) {
-                fa_JobStack_free(&job->stack);
-                runtime_job_reg_clear(job);
-                free(job);
-            }
+    fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, function_index);
+    if (!entry) {
+        return NULL;
+    }
+    if (entry->native.entry || entry->native_attempted) {
+        return entry->native.entry;
+    }
+    if (entry->tier_hits < runtime->jit_context.config.native_threshold) {
+        return NULL;
+    }
+    entry->native_attempted = true;
+    const WasmFunction* function = &runtime->module->functions[function_index];
+    if (function->is_imported || function->body_size == 0) {
+        return NULL;
+    }
+    if (!runtime->jit_native_entries) {
+        runtime->jit_native_entries = (fa_JitNativeEntry*)calloc(runtime->jit_cache_count, sizeof(fa_JitNativeEntry));
+        if (!runtime->jit_native_entries) {
+            return NULL;
         }
-        list_destroy(runtime->jobs);
-        runtime->jobs = NULL;
     }
-    fa_Runtime_detachModule(runtime);
-    runtime_host_bindings_clear(runtime);
-    runtime_host_memory_bindings_clear(runtime);
-    runtime_host_table_bindings_clear(runtime);
-    free(runtime);
+    fa_JitNativeEntry persisted = runtime_jit_native_load_persisted(runtime, entry);
+    if (persisted) {
+        return persisted;
+    }
+    uint8_t* body = runtime_load_function_body(runtime, function_index);
+    if (!body) {
+        return NULL;
+    }
+    fa_JitNativeRequest request;
+    memset(&request, 0, sizeof(request));
+    request.module = runtime->module;
+    request.func_index = function_index;
+    request.body = body;
+    request.body_size = function->body_size;
+    request.memory_flat = runtime_jit_native_memory_flat(runtime);
+    fa_JitWorkerPool* workers = runtime_jit_workers(runtime);
+    if (workers) {
+        /* Lowered in the background; this call and any until the next safe
+           point after it finishes stay interpreted. */
+        fa_JitTask* task = (fa_JitTask*)calloc(1, sizeof(fa_JitTask));
+        if (!task) {
+            free(body);
+            return NULL;
+        }
+        task->kind = FA_JIT_TASK_NATIVE;
+        task->func_index = function_index;
+        task->request = request;
+        fa_jit_program_init(&task->program);
+        if (!fa_jit_workers_submit(workers, task)) {
+            fa_jit_task_free(task);
+        }
+        return NULL;
+    }
+    /* Emitted and installed in two steps so the position-independent code
+       can also go to the on-disk cache. */
+    uint8_t* emitted = NULL;
+    size_t emitted_bytes = 0;
+    uint32_t frame_slots = 0;
+    fa_JitNativeCode code;
+    fa_JitCodeCache* cache = runtime_jit_code_cache(runtime);
+    const bool compiled = cache &&
+                          fa_jit_native_emit(&request, FA_JIT_NATIVE_ARCH_HOST, &emitted, &emitted_bytes, &frame_slots) &&
+                          fa_jit_native_install(emitted, emitted_bytes, frame_slots, cache, &code);
+    free(body);
+    fa_JitNativeEntry native = compiled ? runtime_jit_native_adopt(runtime, entry, &code) : NULL;
+    if (native) {
+        runtime_jit_code_store(runtime, function_index, FA_JIT_TIER_NATIVE, frame_slots, emitted, emitted_bytes);
+    }
+    free(emitted);
+    return native;
+}
+
+/* Charges compiled code to the cache budget and publishes it. */
+static fa_JitNativeEntry runtime_jit_native_adopt(fa_Runtime* runtime,
+                                                  fa_JitProgramCacheEntry* entry,
+                                                  fa_JitNativeCode* code) {
+    if (!runtime_jit_cache_reserve_bytes(runtime, code->map_bytes, entry->func_index)) {
+        fa_jit_native_free(code);
+        return NULL;
+    }
+    runtime->jit_cache_bytes += code->map_bytes;
+    entry->native = *code;
+    runtime_jit_native_publish(runtime, entry->func_index);
+    return entry->native.entry;
 }
 
-int fa_Runtime_attachModule(fa_Runtime* runtime, WasmModule* module) {
-    if (!runtime || !module) {
-        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+/* Charges closure records to the cache budget and attaches them. */
+static const fa_JitClosureProgram* runtime_jit_closure_adopt(fa_Runtime* runtime,
+                                                             fa_JitProgramCacheEntry* entry,
+                                                             fa_JitClosureProgram* closure) {
+    const size_t bytes = fa_jit_closure_estimate_bytes(closure);
+    if (!runtime_jit_cache_reserve_bytes(runtime, bytes, entry->func_index)) {
+        fa_jit_closure_free(closure);
+        return NULL;
     }
-    fa_Runtime_detachModule(runtime);
-    fa_jit_context_apply_env_overrides(&runtime->jit_context);
-    fa_jit_context_update(&runtime->jit_context, &runtime->jit_stats);
-    runtime->module = module;
-    runtime->stream = wasm_instruction_stream_init(module);
-    if (!runtime->stream) {
-        runtime->module = NULL;
-        return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+    entry->program.closure = closure;
+    entry->program_bytes += bytes;
+    runtime->jit_cache_bytes += bytes;
+    return closure;
+}
+
+/* Closure-tier counterpart of runtime_jit_native_ensure. A spilled program is
+   reloaded first, which brings persisted records back without lowering the
+   body again. Lowering is cheap enough to stay on the execution thread. */
+static const fa_JitClosureProgram* runtime_jit_closure_ensure(fa_Runtime* runtime, uint32_t function_index) {
+    if (!runtime || !runtime->module || runtime->jit_context.decision.tier != FA_JIT_TIER_CLOSURE) {
+        return NULL;
     }
-    int status = runtime_memory_init(runtime, module);
-    if (status != FA_RUNTIME_OK) {
-        wasm_instruction_stream_free(runtime->stream);
-        runtime->stream = NULL;
-        runtime->module = NULL;
-        return status;
+    fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, function_index);
+    if (!entry) {
+        return NULL;
     }
-    status = runtime_tables_init(runtime, module);
-    if (status != FA_RUNTIME_OK) {
-        wasm_instruction_stream_free(runtime->stream);
-        runtime->stream = NULL;
-        runtime_memory_reset(runtime);
-        runtime->module = NULL;
-        return status;
+    if (entry->program.closure || entry->closure_attempted ||
+        entry->tier_hits < runtime->jit_context.config.native_threshold) {
+        return entry->program.closure;
     }
-    status = runtime_segments_init(runtime, module);
-    if (status != FA_RUNTIME_OK) {
-        wasm_instruction_stream_free(runtime->stream);
-        runtime->stream = NULL;
-        runtime_segments_reset(runtime);
-        runtime_tables_reset(runtime);
-        runtime_memory_reset(runtime);
-        runtime->module = NULL;
-        return status;
+    if (entry->spilled && runtime->spill_hooks.jit_load &&
+        runtime_jit_cache_load_entry(runtime, entry) == FA_RUNTIME_OK && entry->program.closure) {
+        return entry->program.closure;
     }
-    status = runtime_init_globals(runtime, module);
-    if (status != FA_RUNTIME_OK) {
-        wasm_instruction_stream_free(runtime->stream);
-        runtime->stream = NULL;
-        runtime_globals_reset(runtime);
-        runtime_segments_reset(runtime);
-        runtime_tables_reset(runtime);
-        runtime_memory_reset(runtime);
-        runtime->module = NULL;
-        return status;
+    entry->closure_attempted = true;
+    const WasmFunction* function = &runtime->module->functions[function_index];
+    if (function->is_imported || function->body_size == 0) {
+        return NULL;
+    }
+    fa_JitClosureProgram* closure = NULL;
+    const fa_CompiledTierCode* shared = runtime_jit_shared_lookup(runtime, function_index, FA_JIT_TIER_CLOSURE);
+    uint32_t frame_slots = 0;
+    const uint8_t* data = shared ? shared->data : NULL;
+    size_t data_bytes = shared ? shared->data_bytes : 0;
+    uint8_t* blob = shared ? NULL
+                           : runtime_jit_persist_lookup(runtime, function_index, FA_JIT_TIER_CLOSURE,
+                                                        &frame_slots, &data, &data_bytes);
+    bool persisted = (shared || blob) && fa_jit_closure_deserialize(data, data_bytes, &closure);
+    if (persisted && !fa_jit_closure_globals_valid(closure, runtime->module)) {
+        fa_jit_closure_free(closure);
+        closure = NULL;
+        persisted = false;
+    }
+    if (persisted && shared) {
+        runtime->jit_shared_hits++;
+    } else if (persisted) {
+        runtime->jit_persist_hits++;
+        runtime_jit_shared_publish(runtime, function_index, FA_JIT_TIER_CLOSURE, 0, data, data_bytes);
+    }
+    free(blob);
+    if (persisted) {
+        return runtime_jit_closure_adopt(runtime, entry, closure);
+    }
+    uint8_t* body = runtime_load_function_body(runtime, function_index);
+    if (!body) {
+        return NULL;
+    }
+    fa_JitNativeRequest request;
+    memset(&request, 0, sizeof(request));
+    request.module = runtime->module;
+    request.func_index = function_index;
+    request.body = body;
+    request.body_size = function->body_size;
+    request.memory_flat = runtime_jit_native_memory_flat(runtime);
+    const bool compiled = fa_jit_closure_compile(&request, &closure);
+    free(body);
+    if (!compiled) {
+        return NULL;
+    }
+    runtime_jit_code_store_closure(runtime, function_index, closure);
+    return runtime_jit_closure_adopt(runtime, entry, closure);
+}
+
+/* Safe point: installs whatever the background workers finished. Runs only
+   between instructions (calls, loop back-edges, job start), where swapping a
+   microcode program or publishing a native entry is what the synchronous
+   path would have done at that point anyway. */
+/* ------------------------------------------------------------------------- *
+ * Lazy prescan and callee prefetch (fa_JitConfig.prescan_lazy / _prefetch).
+ *
+ * A function is scanned, validated and lowered on its first interpreted call
+ * rather than at attach, so modules where a few exports are used pay only for
+ * what runs. The prefetcher reads the direct `call` targets of each function
+ * just scanned and queues them on the background pool. Workers scan into a
+ * private scratch entry, and the result is moved into the cache at the next
+ * safe point unless the callee was reached (and scanned) first.
+ * ------------------------------------------------------------------------- */
+
+typedef struct {
+    fa_Runtime* runtime;
+    fa_JitProgramCacheEntry entry;
+} fa_RuntimePrefetch;
+
+static void runtime_jit_prefetch_release(void* user) {
+    fa_RuntimePrefetch* prefetch = (fa_RuntimePrefetch*)user;
+    if (!prefetch) {
+        return;
+    }
+    free(prefetch->entry.opcodes);
+    free(prefetch->entry.offsets);
+    free(prefetch->entry.pc_to_index);
+    free(prefetch->entry.blocks);
+    free(prefetch);
+}
+
+static int runtime_jit_prefetch_task(fa_JitTask* task) {
+    fa_RuntimePrefetch* prefetch = (fa_RuntimePrefetch*)task->user;
+    fa_JitProgramCacheEntry* entry = &prefetch->entry;
+    int status = runtime_jit_prescan_function(prefetch->runtime, entry, task->body, task->body_size);
+    free(task->body);
+    task->body = NULL;
+    if (status == FA_RUNTIME_OK && task->opcode_count > 0 && entry->count > 0) {
+        const size_t opcode_count = entry->count < task->opcode_count ? entry->count : task->opcode_count;
+        task->ok = fa_jit_prepare_program_from_opcodes(entry->opcodes, opcode_count, &task->program);
+    }
+    return status;
+}
+
+/* Same lowering decision as the attach-time walk, charged to the running
+   count of prescan programs. A first call with a pool running queues the
+   lowering instead of doing it inline. */
+static void runtime_jit_prescan_lower(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry, fa_JitProgram* lowered) {
+    const size_t opcode_count = runtime_jit_precompile_allowed(runtime)
+        ? runtime_jit_prescan_lower_count(runtime, entry, runtime->jit_prescan_programs)
+        : 0;
+    if (opcode_count == 0) {
+        fa_jit_program_free(lowered);
+        return;
+    }
+    fa_JitWorkerPool* workers = lowered ? NULL : runtime_jit_workers(runtime);
+    if (workers) {
+        runtime_jit_submit_prepare(workers, entry, opcode_count);
+        return;
+    }
+    const bool installed = lowered ? runtime_jit_adopt_program(runtime, entry, opcode_count, lowered)
+                                   : runtime_jit_prepare_program(runtime, entry, opcode_count);
+    if (installed) {
+        runtime->jit_prescan_programs++;
+    }
+}
+
+static void runtime_jit_prefetch_callees(fa_Runtime* runtime,
+                                         const fa_JitProgramCacheEntry* entry,
+                                         const uint8_t* body) {
+    fa_JitWorkerPool* workers = runtime_jit_workers(runtime);
+    if (!workers) {
+        return;
+    }
+    const WasmModule* module = runtime->module;
+    const bool lower = runtime_jit_precompile_allowed(runtime) &&
+                       runtime->jit_context.decision.budget.cache_budget_bytes > 0;
+    const uint32_t max_ops = runtime->jit_context.decision.budget.max_ops_per_chunk;
+    for (size_t i = 0; i < entry->count; ++i) {
+        if (entry->opcodes[i] != 0x10) {
+            continue;
+        }
+        uint32_t cursor = entry->offsets[i] + 1U;
+        uint64_t target = 0;
+        if (runtime_read_uleb128(body, entry->body_size, &cursor, &target) != FA_RUNTIME_OK ||
+            target >= module->num_functions || module->functions[target].is_imported) {
+            continue;
+        }
+        fa_JitProgramCacheEntry* callee = runtime_jit_cache_entry(runtime, (uint32_t)target);
+        if (!callee || callee->prescanned || callee->prefetch_pending) {
+            continue;
+        }
+        fa_JitTask* task = (fa_JitTask*)calloc(1, sizeof(fa_JitTask));
+        fa_RuntimePrefetch* prefetch = task ? (fa_RuntimePrefetch*)calloc(1, sizeof(fa_RuntimePrefetch)) : NULL;
+        uint8_t* callee_body = prefetch ? runtime_load_function_body(runtime, (uint32_t)target) : NULL;
+        if (!callee_body) {
+            free(prefetch);
+            free(task);
+            return;
+        }
+        prefetch->runtime = runtime;
+        prefetch->entry.func_index = (uint32_t)target;
+        prefetch->entry.body_size = callee->body_size;
+        task->kind = FA_JIT_TASK_PRESCAN;
+        task->func_index = (uint32_t)target;
+        task->prescan = runtime_jit_prefetch_task;
+        task->user = prefetch;
+        task->release = runtime_jit_prefetch_release;
+        task->body = callee_body;
+        task->body_size = callee->body_size;
+        task->opcode_count = lower ? (max_ops > 0 ? (size_t)max_ops : SIZE_MAX) : 0;
+        fa_jit_program_init(&task->program);
+        if (!fa_jit_workers_submit(workers, task)) {
+            fa_jit_task_free(task);
+            return;
+        }
+        callee->prefetch_pending = true;
+    }
+}
+
+/* Safe-point install of a prefetched scan. Dropped when the function got
+   there first; a failed scan is dropped too, so the first call reports it. */
+static void runtime_jit_prefetch_adopt(fa_Runtime* runtime, fa_JitProgramCacheEntry* entry, fa_JitTask* task) {
+    entry->prefetch_pending = false;
+    fa_RuntimePrefetch* prefetch = (fa_RuntimePrefetch*)task->user;
+    if (entry->prescanned || entry->count > 0 || task->status != FA_RUNTIME_OK || !prefetch) {
+        return;
+    }
+    fa_JitProgramCacheEntry* scratch = &prefetch->entry;
+    free(entry->opcodes);
+    free(entry->offsets);
+    free(entry->pc_to_index);
+    free(entry->blocks);
+    entry->opcodes = scratch->opcodes;
+    entry->offsets = scratch->offsets;
+    entry->count = scratch->count;
+    entry->capacity = scratch->capacity;
+    entry->pc_to_index = scratch->pc_to_index;
+    entry->pc_to_index_len = scratch->pc_to_index_len;
+    entry->blocks = scratch->blocks;
+    entry->block_count = scratch->block_count;
+    scratch->opcodes = NULL;
+    scratch->offsets = NULL;
+    scratch->pc_to_index = NULL;
+    scratch->blocks = NULL;
+    entry->prescanned = true;
+    runtime->jit_prescan_blocks += entry->block_count;
+    runtime->jit_prescan_prefetched++;
+    if (task->ok) {
+        runtime_jit_prescan_lower(runtime, entry, &task->program);
+    }
+}
+
+/* First-call hook from runtime_call_function. */
+static int runtime_jit_prescan_lazy(fa_Runtime* runtime, uint32_t function_index) {
+    fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, function_index);
+    if (!entry || entry->prescanned) {
+        return FA_RUNTIME_OK;
+    }
+    uint8_t* body = runtime_load_function_body(runtime, function_index);
+    if (!body) {
+        return FA_RUNTIME_ERR_STREAM;
+    }
+    int status = runtime_jit_prescan_function(runtime, entry, body, entry->body_size);
+    if (status == FA_RUNTIME_OK) {
+        runtime->jit_prescan_blocks += entry->block_count;
+        runtime->jit_prescan_lazy++;
+        runtime_jit_prescan_lower(runtime, entry, NULL);
+        if (runtime->jit_context.config.prescan_prefetch) {
+            runtime_jit_prefetch_callees(runtime, entry, body);
+        }
+    }
+    free(body);
+    return status;
+}
+
+static void runtime_jit_workers_poll(fa_Runtime* runtime) {
+    fa_JitTask* task = fa_jit_workers_take_done(runtime->jit_workers);
+    while (task) {
+        fa_JitTask* next = task->next;
+        fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, task->func_index);
+        if (entry && task->kind == FA_JIT_TASK_MICROCODE) {
+            entry->prepare_pending = false;
+            if (task->ok && (!entry->ready || task->program.count > entry->program.count) &&
+                runtime_jit_install_program(runtime, entry, &task->program)) {
+                runtime->jit_async_installs++;
+            }
+        } else if (entry && task->kind == FA_JIT_TASK_NATIVE && !entry->native.entry) {
+            fa_JitNativeCode code;
+            fa_JitCodeCache* cache = runtime_jit_code_cache(runtime);
+            if (task->request.memory_flat != runtime_jit_native_memory_flat(runtime)) {
+                entry->native_attempted = false; /* memory changed shape: lower again */
+            } else if (task->ok && cache &&
+                       fa_jit_native_install(task->code, task->code_bytes, task->frame_slots, cache, &code) &&
+                       runtime_jit_native_adopt(runtime, entry, &code)) {
+                runtime->jit_async_installs++;
+                runtime_jit_code_store(runtime, task->func_index, FA_JIT_TIER_NATIVE, task->frame_slots,
+                                       task->code, task->code_bytes);
+            }
+        } else if (entry && task->kind == FA_JIT_TASK_PRESCAN) {
+            runtime_jit_prefetch_adopt(runtime, entry, task);
+        }
+        fa_jit_task_free(task);
+        task = next;
+    }
+}
+
+static int64_t runtime_jit_native_memory_grow(fa_JitNativeContext* ctx, uint32_t delta_pages) {
+    uint64_t prev_pages = 0;
+    bool grew = false;
+    if (fa_Runtime_growMemory(ctx->runtime, 0, delta_pages, &prev_pages, &grew) != FA_RUNTIME_OK || !grew) {
+        return -1;
+    }
+    return (int64_t)prev_pages;
+}
+
+static bool runtime_jit_native_slot_to_value(uint64_t slot, uint32_t valtype, fa_JobValue* out) {
+    if (runtime_init_value_from_valtype(out, valtype) != FA_RUNTIME_OK) {
+        return false;
+    }
+    if (valtype == VALTYPE_I32 || valtype == VALTYPE_F32) {
+        out->payload.u32_value = (u32)slot;
+    } else {
+        out->payload.u64_value = slot;
+    }
+    return true;
+}
+
+static uint64_t runtime_jit_native_value_to_slot(const fa_JobValue* value, uint32_t valtype) {
+    if (valtype == VALTYPE_I32 || valtype == VALTYPE_F32) {
+        return (uint64_t)value->payload.u32_value;
+    }
+    return value->payload.u64_value;
+}
+
+static int runtime_jit_native_call_slow(fa_JitNativeContext* ctx, uint64_t* slots, uint32_t function_index) {
+    fa_Runtime* runtime = ctx->runtime;
+    if (!runtime || !runtime->module || function_index >= runtime->module->num_functions) {
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    int status = runtime_check_function_trap(runtime, function_index);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    if (ctx->depth >= ctx->max_depth) {
+        return FA_RUNTIME_ERR_CALL_DEPTH_EXCEEDED;
+    }
+    const WasmFunction* function = &runtime->module->functions[function_index];
+    if (runtime->jit_workers) {
+        runtime_jit_workers_poll(runtime);
+    }
+    fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, function_index);
+    runtime_jit_cache_touch(runtime, entry);
+    if (!function->is_imported) {
+        fa_JitNativeEntry native = runtime_aot_entry(runtime, function_index);
+        if (native) {
+            runtime->jit_aot_calls++;
+        } else {
+            native = runtime_jit_native_ensure(runtime, function_index);
+            runtime->jit_native_calls += native ? 1U : 0U;
+        }
+        if (native) {
+            entry->pins++;
+            status = native(ctx, slots);
+            entry->pins--;
+            return status;
+        }
+        const fa_JitClosureProgram* closure = runtime_jit_closure_ensure(runtime, function_index);
+        if (closure) {
+            runtime->jit_closure_calls++;
+            entry->pins++;
+            status = fa_jit_closure_run(closure, ctx, slots);
+            entry->pins--;
+            return status;
+        }
+    }
+    if (function->type_index >= runtime->module->num_types) {
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    const WasmFunctionType* type = &runtime->module->types[function->type_index];
+    fa_Job* job = fa_Job_init();
+    if (!job) {
+        return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = 0; i < type->num_params && status == FA_RUNTIME_OK; ++i) {
+        fa_JobValue value;
+        if (!runtime_jit_native_slot_to_value(slots[i], type->param_types[i], &value)) {
+            status = FA_RUNTIME_ERR_TRAP;
+        } else if (!fa_JobStack_push(&job->stack, &value)) {
+            status = FA_RUNTIME_ERR_OUT_OF_MEMORY;
+        }
+    }
+    if (status == FA_RUNTIME_OK) {
+        fa_JobValue* saved_locals = runtime->active_locals;
+        const uint32_t saved_locals_count = runtime->active_locals_count;
+        const size_t saved_top = runtime->jit_native_slot_top;
+        runtime->jit_native_slot_top = (size_t)(slots - runtime->jit_native_slots);
+        ctx->depth++;
+        if (function->is_imported) {
+            status = runtime_call_imported(runtime, job, function_index);
+        } else {
+            status = runtime_run_function(runtime, job, function_index);
+        }
+        ctx->depth--;
+        runtime->jit_native_slot_top = saved_top;
+        runtime->active_locals = saved_locals;
+        runtime->active_locals_count = saved_locals_count;
+        /* The callee may have spilled memory 0 (a host import calling
+           fa_Runtime_spillMemory); the compiled caller only checked it on
+           entry and reads memory->data directly. */
+        if (status == FA_RUNTIME_OK && runtime->memories_count > 0) {
+            status = fa_Runtime_ensureMemoryLoaded(runtime, 0);
+        }
+    }
+    for (uint32_t i = type->num_results; i > 0 && status == FA_RUNTIME_OK; --i) {
+        fa_JobValue value;
+        if (!fa_JobStack_pop(&job->stack, &value) ||
+            !runtime_job_value_matches_valtype(&value, (uint8_t)type->result_types[i - 1U])) {
+            status = FA_RUNTIME_ERR_TRAP;
+            break;
+        }
+        slots[i - 1U] = runtime_jit_native_value_to_slot(&value, type->result_types[i - 1U]);
+    }
+    fa_JobStack_free(&job->stack);
+    runtime_job_reg_clear(job);
+    free(job);
+    return status;
+}
+
+static uint64_t* runtime_jit_native_slot_base(fa_Runtime* runtime, size_t needed) {
+    if (!runtime->jit_native_slots) {
+        runtime->jit_native_slots = (uint64_t*)malloc(FA_RUNTIME_JIT_NATIVE_SLOTS * sizeof(uint64_t));
+        if (!runtime->jit_native_slots) {
+            return NULL;
+        }
+    }
+    const size_t top = runtime->jit_native_slot_top;
+    if (top + needed >= FA_RUNTIME_JIT_NATIVE_SLOTS) {
+        return NULL;
+    }
+    return runtime->jit_native_slots + top;
+}
+
+/* Enters native code, or closure records when `closure` is set, from the
+   interpreter. `interpreter_depth` interpreted frames count against
+   max_call_depth; `entry` stays pinned while the code runs and code evicted
+   meanwhile is reclaimed once the outermost entry returns. */
+static int runtime_jit_native_invoke(fa_Runtime* runtime,
+                                     fa_JitProgramCacheEntry* entry,
+                                     fa_JitNativeEntry native,
+                                     const fa_JitClosureProgram* closure,
+                                     uint64_t* slots,
+                                     uint32_t interpreter_depth) {
+    if (runtime->memories_count > 0) {
+        int status = fa_Runtime_ensureMemoryLoaded(runtime, 0);
+        if (status != FA_RUNTIME_OK) {
+            return status;
+        }
+    }
+    fa_JitNativeContext* ctx = &runtime->jit_native;
+    ctx->entries = runtime->jit_native_entries;
+    ctx->call_slow = runtime_jit_native_call_slow;
+    ctx->memory_grow = runtime_jit_native_memory_grow;
+    ctx->memory = runtime->memories_count > 0 ? (void*)&runtime->memories[0] : NULL;
+    ctx->globals = runtime->globals;
+    ctx->slot_limit = runtime->jit_native_slots + FA_RUNTIME_JIT_NATIVE_SLOTS;
+    ctx->max_depth = runtime->max_call_depth ? runtime->max_call_depth : 64U;
+    ctx->runtime = runtime;
+    const uint32_t saved_depth = ctx->depth;
+    ctx->depth = saved_depth + interpreter_depth;
+    if (closure) {
+        runtime->jit_closure_calls++;
+    } else if (native == runtime_aot_entry(runtime, entry->func_index)) {
+        runtime->jit_aot_calls++;
+    } else {
+        runtime->jit_native_calls++;
+    }
+    runtime->jit_native_active++;
+    entry->pins++;
+    int status = closure ? fa_jit_closure_run(closure, ctx, slots) : native(ctx, slots);
+    entry->pins--;
+    if (--runtime->jit_native_active == 0 && runtime->jit_native_retired_count > 0) {
+        runtime_jit_native_reclaim(runtime);
+    }
+    ctx->depth = saved_depth;
+    return status;
+}
+
+static int runtime_jit_native_push_results(fa_Job* job, const WasmFunctionType* type, const uint64_t* slots) {
+    for (uint32_t i = 0; i < type->num_results; ++i) {
+        fa_JobValue value;
+        if (!runtime_jit_native_slot_to_value(slots[i], type->result_types[i], &value)) {
+            return FA_RUNTIME_ERR_TRAP;
+        }
+        if (!fa_JobStack_push(&job->stack, &value)) {
+            return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+        }
+    }
+    return FA_RUNTIME_OK;
+}
+
+/* Runs a compiled function (native code or closure records) with its
+   arguments taken from the job stack and its results pushed back, as
+   runtime_push_frame + the interpreter would. */
+static int runtime_call_native(fa_Runtime* runtime,
+                               fa_Job* job,
+                               uint32_t function_index,
+                               uint32_t interpreter_depth,
+                               fa_JitNativeEntry native,
+                               const fa_JitClosureProgram* closure) {
+    const WasmFunction* function = &runtime->module->functions[function_index];
+    const WasmFunctionType* type = &runtime->module->types[function->type_index];
+    uint64_t* slots = runtime_jit_native_slot_base(runtime, type->num_params > type->num_results
+                                                                ? type->num_params
+                                                                : type->num_results);
+    if (!slots) {
+        return runtime->jit_native_slots ? FA_RUNTIME_ERR_CALL_DEPTH_EXCEEDED : FA_RUNTIME_ERR_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = type->num_params; i > 0; --i) {
+        fa_JobValue value;
+        if (!fa_JobStack_pop(&job->stack, &value) ||
+            !runtime_job_value_matches_valtype(&value, (uint8_t)type->param_types[i - 1U])) {
+            return FA_RUNTIME_ERR_TRAP;
+        }
+        slots[i - 1U] = runtime_jit_native_value_to_slot(&value, type->param_types[i - 1U]);
+    }
+    fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, function_index);
+    int status = runtime_jit_native_invoke(runtime, entry, native, closure, slots, interpreter_depth);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    return runtime_jit_native_push_results(job, type, slots);
+}
+
+static int runtime_call_function(fa_Runtime* runtime,
+                                 fa_RuntimeCallFrame* frames,
+                                 uint32_t* depth,
+                                 fa_Job* job,
+                                 uint32_t function_index) {
+    if (!runtime || !frames || !depth || !job) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    if (!runtime->module) {
+        return FA_RUNTIME_ERR_NO_MODULE;
+    }
+    if (function_index >= runtime->module->num_functions) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    int status = runtime_check_function_trap(runtime, function_index);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    if (runtime->module->functions[function_index].is_imported) {
+        return runtime_call_imported(runtime, job, function_index);
+    }
+    if (runtime->jit_workers) {
+        runtime_jit_workers_poll(runtime);
+    }
+    runtime_jit_cache_touch(runtime, runtime_jit_cache_entry(runtime, function_index));
+    fa_JitNativeEntry native = runtime_aot_entry(runtime, function_index);
+    if (!native) {
+        native = runtime_jit_native_ensure(runtime, function_index);
+    }
+    const fa_JitClosureProgram* closure = native ? NULL : runtime_jit_closure_ensure(runtime, function_index);
+    if ((native || closure) && runtime_jit_native_memory_flat(runtime) == (runtime->memories_count > 0)) {
+        const uint32_t type_index = runtime->module->functions[function_index].type_index;
+        if (job->stack.size >= runtime->module->types[type_index].num_params) {
+            return runtime_call_native(runtime, job, function_index, *depth, native, closure);
+        }
+    }
+    if (runtime->jit_context.config.prescan_lazy) {
+        status = runtime_jit_prescan_lazy(runtime, function_index);
+        if (status != FA_RUNTIME_OK) {
+            return status;
+        }
+    }
+    return runtime_push_frame(runtime, frames, depth, job, function_index);
+}
+
+static void runtime_pop_frame(fa_Runtime* runtime, fa_RuntimeCallFrame* frames, uint32_t* depth) {
+    if (!frames || !depth || *depth == 0) {
+        return;
+    }
+    fa_RuntimeCallFrame* frame = &frames[*depth - 1];
+    fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, frame->func_index);
+    if (entry && entry->pins > 0) {
+        entry->pins--;
+    }
+    runtime_free_frame_resources(frame);
+    *depth -= 1;
+}
+
+/* ------------------------------------------------------------------------- *
+ * On-stack replacement.
+ *
+ * A frame that keeps looping in the interpreter after the native (or closure)
+ * tier was chosen (typically the entry function, which was already running
+ * when the tier flipped) moves into code compiled with an extra entry at that
+ * loop header. Locals and the operand values above the frame's base become
+ * slots [0, osr_height); the control stack needs no transfer because the
+ * compiled code's block structure is static. The OSR code is single-use: it
+ * is installed for this transfer and released when the function returns,
+ * while later calls take the regular entry.
+ * ------------------------------------------------------------------------- */
+
+static bool runtime_jit_osr_value_to_slot(const fa_JobValue* value, uint64_t* slot) {
+    switch (value->kind) {
+        case fa_job_value_i32:
+        case fa_job_value_f32:
+            *slot = (uint64_t)value->payload.u32_value;
+            return true;
+        case fa_job_value_i64:
+        case fa_job_value_f64:
+            *slot = value->payload.u64_value;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Sets `entered` when the frame was replaced: it is popped and, on success,
+   its results are on the job stack. Otherwise the interpreter carries on. */
+static int runtime_jit_osr_enter(fa_Runtime* runtime,
+                                 fa_RuntimeCallFrame* frames,
+                                 uint32_t* depth,
+                                 fa_Job* job,
+                                 bool* entered) {
+    *entered = false;
+    fa_RuntimeCallFrame* frame = &frames[*depth - 1U];
+    fa_JitProgramCacheEntry* entry = runtime_jit_cache_entry(runtime, frame->func_index);
+    if (!entry || entry->osr_failed || frame->control_depth == 0 ||
+        runtime_jit_native_memory_flat(runtime) != (runtime->memories_count > 0) ||
+        (runtime->function_traps && frame->func_index < runtime->function_trap_count &&
+         runtime->function_traps[frame->func_index])) {
+        return FA_RUNTIME_OK;
+    }
+    const size_t base = frame->control_stack[0].stack_height;
+    if (job->stack.size < base) {
+        return FA_RUNTIME_OK;
+    }
+    const size_t operands = job->stack.size - base;
+    fa_JitNativeRequest request;
+    memset(&request, 0, sizeof(request));
+    request.module = runtime->module;
+    request.func_index = frame->func_index;
+    request.body = frame->body;
+    request.body_size = frame->body_size;
+    request.memory_flat = runtime_jit_native_memory_flat(runtime);
+    request.osr_pc = frame->pc;
+    fa_JitNativeCode code;
+    memset(&code, 0, sizeof(code));
+    fa_JitClosureProgram* closure = NULL;
+    if (runtime->jit_context.decision.tier == FA_JIT_TIER_CLOSURE) {
+        if (!fa_jit_closure_compile(&request, &closure)) {
+            entry->osr_failed = true;
+            return FA_RUNTIME_OK;
+        }
+    } else {
+        fa_JitCodeCache* cache = runtime_jit_code_cache(runtime);
+        if (!cache || !fa_jit_native_compile(&request, cache, &code)) {
+            entry->osr_failed = true;
+            return FA_RUNTIME_OK;
+        }
+    }
+    const uint32_t osr_height = closure ? closure->osr_height : code.osr_height;
+    const WasmFunctionType* type = &runtime->module->types[runtime->module->functions[frame->func_index].type_index];
+    const size_t needed = osr_height > type->num_results ? osr_height : type->num_results;
+    uint64_t* slots = osr_height == frame->locals_count + operands ? runtime_jit_native_slot_base(runtime, needed)
+                                                                   : NULL;
+    bool transferable = slots != NULL;
+    for (uint32_t i = 0; i < frame->locals_count && transferable; ++i) {
+        transferable = runtime_jit_osr_value_to_slot(&frame->locals[i], &slots[i]);
+    }
+    const fa_JobStackValue* node = job->stack.tail;
+    for (size_t i = operands; i > 0 && transferable; --i) {
+        transferable = runtime_jit_osr_value_to_slot(&node->value, &slots[frame->locals_count + i - 1U]);
+        node = node->prev;
+    }
+    if (!transferable) {
+        fa_jit_native_free(&code);
+        fa_jit_closure_free(closure);
+        return FA_RUNTIME_OK;
+    }
+    for (size_t i = 0; i < operands; ++i) {
+        (void)fa_JobStack_pop(&job->stack, NULL);
+    }
+    *entered = true;
+    runtime->jit_osr_entries++;
+    int status = runtime_jit_native_invoke(runtime, entry, code.entry, closure, slots, *depth - 1U);
+    fa_jit_native_free(&code);
+    fa_jit_closure_free(closure);
+    runtime_pop_frame(runtime, frames, depth);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    return runtime_jit_native_push_results(job, type, slots);
+}
+
+static bool runtime_is_function_end(const fa_RuntimeCallFrame* frame, uint8_t opcode) {
+    if (!frame) {
+        return false;
+    }
+    if (opcode != 0x0B) {
+        return false;
+    }
+    return frame->control_depth == 1;
+}
+
+fa_Runtime* fa_Runtime_init(void) {
+    fa_Runtime* runtime = (fa_Runtime*)calloc(1, sizeof(fa_Runtime));
+    if (!runtime) {
+        return NULL;
+    }
+    runtime->malloc = fa_default_malloc;
+    runtime->free = fa_default_free;
+    runtime->jobs = list_create(4);
+    runtime->module = NULL;
+    runtime->stream = NULL;
+    runtime->next_job_id = 1;
+    runtime->max_call_depth = 64;
+    runtime->active_locals = NULL;
+    runtime->active_locals_count = 0;
+    runtime->memories = NULL;
+    runtime->memories_count = 0;
+    runtime->tables = NULL;
+    runtime->tables_count = 0;
+    runtime->data_segments_dropped = NULL;
+    runtime->data_segments_count = 0;
+    runtime->elem_segments_dropped = NULL;
+    runtime->elem_segments_count = 0;
+    runtime->globals = NULL;
+    runtime->globals_count = 0;
+    fa_jit_context_init(&runtime->jit_context, NULL);
+    memset(&runtime->jit_stats, 0, sizeof(runtime->jit_stats));
+    runtime->jit_prepared_executions = 0;
+    runtime->jit_fused_executions = 0;
+    runtime->jit_cache_bytes = 0;
+    runtime->jit_cache_prescanned = false;
+    runtime->function_traps = NULL;
+    runtime->function_trap_count = 0;
+    if (!runtime->jobs) {
+        fa_Runtime_free(runtime);
+        return NULL;
+    }
+    (void)fa_Runtime_setJitCacheDir(runtime, getenv("FAYASM_JIT_CACHE_DIR"));
+    return runtime;
+}
+
+void fa_Runtime_free(fa_Runtime* runtime) {
+    if (!runtime) {
+        return;
+    }
+    if (runtime->jobs) {
+        while (list_count(runtime->jobs) > 0) {
+            fa_Job* job = (fa_Job*)list_pop(runtime->jobs);
+            if (job) {
+                fa_JobStack_free(&job->stack);
+                runtime_job_reg_clear(job);
+                free(job);
+            }
+        }
+        list_destroy(runtime->jobs);
+        runtime->jobs = NULL;
+    }
+    fa_Runtime_detachModule(runtime);
+    runtime_host_bindings_clear(runtime);
+    runtime_host_memory_bindings_clear(runtime);
+    runtime_host_table_bindings_clear(runtime);
+    free(runtime->jit_persist_dir);
+    free(runtime);
+}
+
+static int runtime_attach_module(fa_Runtime* runtime, WasmModule* module);
+
+int fa_Runtime_attachModule(fa_Runtime* runtime, WasmModule* module) {
+    if (!runtime || !module) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    fa_Runtime_detachModule(runtime);
+    return runtime_attach_module(runtime, module);
+}
+
+int fa_Runtime_attachCompiled(fa_Runtime* runtime, fa_CompiledModule* compiled) {
+    if (!runtime || !compiled) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    fa_Runtime_detachModule(runtime);
+    runtime->compiled = fa_CompiledModule_retain(compiled);
+    int status = runtime_attach_module(runtime, compiled->module);
+    if (status != FA_RUNTIME_OK) {
+        fa_CompiledModule_release(runtime->compiled);
+        runtime->compiled = NULL;
+    }
+    return status;
+}
+
+/* Last instantiation step: the start function runs on a job of its own once
+   memories, tables, globals and host imports are in place. A trap fails the
+   attach. */
+static int runtime_run_start(fa_Runtime* runtime) {
+    if (!runtime->module->has_start) {
+        return FA_RUNTIME_OK;
+    }
+    fa_Job* job = fa_Runtime_createJob(runtime);
+    if (!job) {
+        return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+    }
+    const int status = fa_Runtime_executeJob(runtime, job, runtime->module->start_function);
+    (void)fa_Runtime_destroyJob(runtime, job);
+    return status;
+}
+
+/* Attach proper, on a detached runtime: memories, tables, globals, active
+   segments (validated as a batch, then copied), host imports, code, and
+   finally the start function. */
+static int runtime_attach_module(fa_Runtime* runtime, WasmModule* module) {
+    fa_jit_context_apply_env_overrides(&runtime->jit_context);
+    fa_jit_context_update(&runtime->jit_context, &runtime->jit_stats);
+    runtime->module = module;
+    runtime->stream = wasm_instruction_stream_init(module);
+    if (!runtime->stream) {
+        runtime->module = NULL;
+        return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+    }
+    int status = runtime_memory_init(runtime, module);
+    if (status != FA_RUNTIME_OK) {
+        wasm_instruction_stream_free(runtime->stream);
+        runtime->stream = NULL;
+        runtime->module = NULL;
+        return status;
+    }
+    status = runtime_tables_init(runtime, module);
+    if (status != FA_RUNTIME_OK) {
+        wasm_instruction_stream_free(runtime->stream);
+        runtime->stream = NULL;
+        runtime_memory_reset(runtime);
+        runtime->module = NULL;
+        return status;
+    }
+    /* Globals first: element segments may initialize from global.get. */
+    status = runtime_init_globals(runtime, module);
+    if (status != FA_RUNTIME_OK) {
+        wasm_instruction_stream_free(runtime->stream);
+        runtime->stream = NULL;
+        runtime_globals_reset(runtime);
+        runtime_tables_reset(runtime);
+        runtime_memory_reset(runtime);
+        runtime->module = NULL;
+        return status;
+    }
+    status = runtime_segments_init(runtime, module);
+    if (status != FA_RUNTIME_OK) {
+        wasm_instruction_stream_free(runtime->stream);
+        runtime->stream = NULL;
+        runtime_globals_reset(runtime);
+        runtime_segments_reset(runtime);
+        runtime_tables_reset(runtime);
+        runtime_memory_reset(runtime);
+        runtime->module = NULL;
+        return status;
+    }
+    runtime_traps_reset(runtime);
+    if (module->num_functions > 0) {
+        runtime->function_traps = (uint8_t*)calloc(module->num_functions, sizeof(uint8_t));
+        if (!runtime->function_traps) {
+            fa_Runtime_detachModule(runtime);
+            return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+        }
+        runtime->function_trap_count = module->num_functions;
+    }
+    if (module->num_imported_functions > 0) {
+        runtime->host_import_slots = (uint32_t*)calloc(module->num_imported_functions, sizeof(uint32_t));
+        if (!runtime->host_import_slots) {
+            fa_Runtime_detachModule(runtime);
+            return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+        }
+        runtime->host_import_slot_count = module->num_imported_functions;
+        for (uint32_t i = 0; i < runtime->host_binding_count; ++i) {
+            runtime_host_import_resolve(runtime, i);
+        }
+    }
+    status = runtime_jit_cache_init(runtime);
+    if (status == FA_RUNTIME_OK) {
+        status = runtime_run_start(runtime);
+    }
+    if (status != FA_RUNTIME_OK) {
+        fa_Runtime_detachModule(runtime);
+        return status;
+    }
+    return FA_RUNTIME_OK;
+}
+
+void fa_Runtime_detachModule(fa_Runtime* runtime) {
+    if (!runtime) {
+        return;
+    }
+    if (runtime->stream) {
+        wasm_instruction_stream_free(runtime->stream);
+        runtime->stream = NULL;
+    }
+    runtime_globals_reset(runtime);
+    runtime_segments_reset(runtime);
+    runtime_tables_reset(runtime);
+    runtime_memory_reset(runtime);
+    runtime_jit_cache_clear(runtime);
+    runtime_traps_reset(runtime);
+    runtime_host_imports_reset(runtime);
+    runtime->aot_entries = NULL;
+    runtime->aot_entry_count = 0;
+    runtime->module = NULL;
+    fa_CompiledModule_release(runtime->compiled);
+    runtime->compiled = NULL;
+    runtime->active_locals = NULL;
+    runtime->active_locals_count = 0;
+}
+
+/* ------------------------------------------------------------------------- *
+ * Compiled modules.
+ *
+ * fa_CompiledModule_create runs the eager attach-time prescan once, on a
+ * scratch runtime that never instantiates anything, and keeps the resulting
+ * cache entries (scan results, side tables, lowered programs) plus a copy of
+ * every body. Instances borrow both (runtime_jit_cache_borrow,
+ * runtime_shared_body) and never write to them; the first time an instance
+ * needs something different (a longer program, a spill, an eviction) it
+ * drops its borrowed pointer and builds a private copy, as a bare attach
+ * would have.
+ * ------------------------------------------------------------------------- */
+
+static void compiled_module_free(fa_CompiledModule* compiled) {
+    if (compiled->code) {
+        for (uint32_t i = 0; i < compiled->code_count; ++i) {
+            runtime_jit_cache_entry_free(NULL, &compiled->code[i]);
+        }
+        free(compiled->code);
+    }
+    if (compiled->tier_code) {
+        for (size_t i = 0; i < (size_t)compiled->code_count * FA_COMPILED_TIER_SLOTS; ++i) {
+            free(compiled->tier_code[i]);
+        }
+        free(compiled->tier_code);
+    }
+    free(compiled->bodies);
+    free(compiled->body_bytes);
+    wasm_module_free(compiled->module);
+#if defined(FA_RUNTIME_HAS_MMAP)
+    if (compiled->bundle_map) {
+        munmap(compiled->bundle_map, compiled->bundle_map_bytes);
+    }
+#endif
+    free(compiled->bundle_copy);
+    free(compiled);
+}
+
+static bool compiled_module_init_tier_code(fa_CompiledModule* compiled) {
+    if (compiled->code_count == 0) {
+        return true;
+    }
+    compiled->tier_code = (fa_CompiledTierCode**)calloc((size_t)compiled->code_count * FA_COMPILED_TIER_SLOTS,
+                                                       sizeof(fa_CompiledTierCode*));
+    return compiled->tier_code != NULL;
+}
+
+/* Buffer-backed modules lend their bytes; anything else is read once into
+   one block so instances never seek the module. */
+static bool compiled_module_load_bodies(fa_CompiledModule* compiled) {
+    WasmModule* module = compiled->module;
+    if (module->num_functions == 0) {
+        return true;
+    }
+    compiled->bodies = (const uint8_t**)calloc(module->num_functions, sizeof(const uint8_t*));
+    if (!compiled->bodies) {
+        return false;
+    }
+    size_t total = 0;
+    for (uint32_t i = 0; i < module->num_functions; ++i) {
+        const WasmFunction* function = &module->functions[i];
+        if (function->is_imported || function->body_size == 0) {
+            continue;
+        }
+        if (module->buffer) {
+            if ((uint64_t)function->body_offset + function->body_size > (uint64_t)module->buffer_size) {
+                return false;
+            }
+            compiled->bodies[i] = module->buffer + function->body_offset;
+        }
+        total += function->body_size;
+    }
+    if (module->buffer || total == 0) {
+        return true;
+    }
+    compiled->body_bytes = (uint8_t*)malloc(total);
+    if (!compiled->body_bytes) {
+        return false;
+    }
+    size_t offset = 0;
+    for (uint32_t i = 0; i < module->num_functions; ++i) {
+        const WasmFunction* function = &module->functions[i];
+        if (function->is_imported || function->body_size == 0) {
+            continue;
+        }
+        uint8_t* body = wasm_load_function_body(module, i);
+        if (!body) {
+            return false;
+        }
+        memcpy(compiled->body_bytes + offset, body, function->body_size);
+        free(body);
+        compiled->bodies[i] = compiled->body_bytes + offset;
+        offset += function->body_size;
+    }
+    return true;
+}
+
+fa_CompiledModule* fa_CompiledModule_create(WasmModule* module) {
+    if (!module) {
+        return NULL;
+    }
+    fa_CompiledModule* compiled = (fa_CompiledModule*)calloc(1, sizeof(fa_CompiledModule));
+    fa_Runtime* scratch = compiled ? fa_Runtime_init() : NULL;
+    if (!scratch) {
+        free(compiled);
+        return NULL;
+    }
+    compiled->module = module;
+    compiled->refs = 1;
+    /* Cached on the module now, so persisted-code lookups stay read-only; the
+       opcode tables are filled in here too, before instances race for them. */
+    uint8_t digest[FA_SHA256_BYTES];
+    (void)wasm_module_content_digest(module, digest);
+    (void)fa_instance_ops();
+
+    /* The JIT decision an attach would make, always with the eager prescan. */
+    fa_jit_context_apply_env_overrides(&scratch->jit_context);
+    fa_jit_context_update(&scratch->jit_context, &scratch->jit_stats);
+    scratch->jit_context.config.prescan_force = true;
+    scratch->jit_context.config.prescan_lazy = false;
+    scratch->module = module;
+    int status = runtime_jit_cache_init(scratch);
+    if (status == FA_RUNTIME_OK) {
+        compiled->code = scratch->jit_cache;
+        compiled->code_count = scratch->jit_cache_count;
+        compiled->prescan_blocks = scratch->jit_prescan_blocks;
+        compiled->prescan_programs = scratch->jit_prescan_programs;
+        scratch->jit_cache = NULL;
+        scratch->jit_cache_count = 0;
+    }
+    scratch->module = NULL;
+    fa_Runtime_free(scratch);
+    if (status != FA_RUNTIME_OK || !compiled_module_load_bodies(compiled) ||
+        !compiled_module_init_tier_code(compiled)) {
+        compiled->module = NULL; /* still the caller's */
+        compiled_module_free(compiled);
+        return NULL;
+    }
+    return compiled;
+}
+
+fa_CompiledModule* fa_CompiledModule_retain(fa_CompiledModule* compiled) {
+    if (compiled) {
+        (void)__atomic_add_fetch(&compiled->refs, 1U, __ATOMIC_RELAXED);
+    }
+    return compiled;
+}
+
+void fa_CompiledModule_release(fa_CompiledModule* compiled) {
+    if (compiled && __atomic_sub_fetch(&compiled->refs, 1U, __ATOMIC_ACQ_REL) == 0U) {
+        compiled_module_free(compiled);
+    }
+}
+
+const WasmModule* fa_CompiledModule_module(const fa_CompiledModule* compiled) {
+    return compiled ? compiled->module : NULL;
+}
+
+fa_Instance* fa_Instance_create(fa_CompiledModule* compiled) {
+    if (!compiled) {
+        return NULL;
+    }
+    fa_Runtime* runtime = fa_Runtime_init();
+    if (runtime && fa_Runtime_attachCompiled(runtime, compiled) != FA_RUNTIME_OK) {
+        fa_Runtime_free(runtime);
+        return NULL;
+    }
+    return runtime;
+}
+
+void fa_Instance_free(fa_Instance* instance) {
+    fa_Runtime_free(instance);
+}
+
+/* ------------------------------------------------------------------------- *
+ * Module bundles (layout in fa_runtime.h).
+ *
+ * A bundle is the compiled module frozen to bytes: the module image followed
+ * by the prescan results of every function in the layout the cache entries
+ * use in memory, so a little-endian host points its entries straight into the
+ * (mapped) bundle. Only what holds pointers is rebuilt on open: the module
+ * metadata, read back from the embedded image, and the lowered programs,
+ * whose ops carry handler addresses and are re-lowered from the stored
+ * opcode streams.
+ * ------------------------------------------------------------------------- */
+
+#define BUNDLE_HEADER_BYTES 80u
+#define BUNDLE_RECORD_BYTES 20u
+#define BUNDLE_FLAG_PRESCANNED 0x1u
+
+static size_t bundle_align4(size_t size) {
+    return (size + 3u) & ~(size_t)3u;
+}
+
+static uint32_t bundle_lowered_count(const fa_JitProgramCacheEntry* entry) {
+    return entry->ready && entry->program.count > 0 ? (uint32_t)entry->prepared_count : 0u;
+}
+
+static size_t bundle_record_bytes(const fa_JitProgramCacheEntry* entry) {
+    return BUNDLE_RECORD_BYTES + entry->count * sizeof(uint32_t) + entry->pc_to_index_len * sizeof(int32_t) +
+           (size_t)entry->block_count * 3u * sizeof(uint32_t) + bundle_align4(entry->count);
+}
+
+static uint8_t* bundle_put_record(uint8_t* out, const fa_JitProgramCacheEntry* entry) {
+    fa_spill_put_u32(out + 0, (uint32_t)entry->count);
+    fa_spill_put_u32(out + 4, (uint32_t)entry->pc_to_index_len);
+    fa_spill_put_u32(out + 8, entry->block_count);
+    fa_spill_put_u32(out + 12, bundle_lowered_count(entry));
+    fa_spill_put_u32(out + 16, entry->prescanned ? BUNDLE_FLAG_PRESCANNED : 0u);
+    out += BUNDLE_RECORD_BYTES;
+    for (size_t i = 0; i < entry->count; ++i, out += 4) {
+        fa_spill_put_u32(out, entry->offsets[i]);
+    }
+    for (size_t i = 0; i < entry->pc_to_index_len; ++i, out += 4) {
+        fa_spill_put_u32(out, (uint32_t)entry->pc_to_index[i]);
+    }
+    for (uint32_t i = 0; i < entry->block_count; ++i, out += 12) {
+        fa_spill_put_u32(out + 0, entry->blocks[i].start_pc);
+        fa_spill_put_u32(out + 4, entry->blocks[i].else_pc);
+        fa_spill_put_u32(out + 8, entry->blocks[i].end_pc);
+    }
+    if (entry->count > 0) {
+        memcpy(out, entry->opcodes, entry->count);
+    }
+    memset(out + entry->count, 0, bundle_align4(entry->count) - entry->count);
+    return out + bundle_align4(entry->count);
+}
+
+size_t fa_CompiledModule_bundleSize(const fa_CompiledModule* compiled) {
+    if (!compiled || !compiled->module || !compiled->module->buffer ||
+        compiled->module->buffer_size > (size_t)UINT32_MAX) {
+        return 0;
+    }
+    size_t records = 0;
+    for (uint32_t i = 0; i < compiled->code_count; ++i) {
+        records += bundle_record_bytes(&compiled->code[i]);
+    }
+    if (records > (size_t)UINT32_MAX) {
+        return 0;
+    }
+    return FA_SPILL_HEADER_BYTES + BUNDLE_HEADER_BYTES + bundle_align4(compiled->module->buffer_size) + records;
+}
+
+bool fa_CompiledModule_writeBundle(const fa_CompiledModule* compiled,
+                                   uint8_t* out,
+                                   size_t capacity,
+                                   size_t* written_out) {
+    if (written_out) {
+        *written_out = 0;
+    }
+    const size_t total = fa_CompiledModule_bundleSize(compiled);
+    uint8_t digest[FA_SHA256_BYTES];
+    if (total == 0 || !out || capacity < total || wasm_module_content_digest(compiled->module, digest) != 0) {
+        return false;
+    }
+    const WasmModule* module = compiled->module;
+    const size_t wasm_bytes = module->buffer_size;
+    (void)fa_spill_write_header(out, capacity, (uint16_t)FA_SPILL_KIND_MODULE_BUNDLE,
+                                (uint64_t)(total - FA_SPILL_HEADER_BYTES));
+    uint8_t* header = out + FA_SPILL_HEADER_BYTES;
+    uint8_t* body = header + BUNDLE_HEADER_BYTES;
+    memcpy(body, module->buffer, wasm_bytes);
+    memset(body + wasm_bytes, 0, bundle_align4(wasm_bytes) - wasm_bytes);
+    uint8_t* cursor = body + bundle_align4(wasm_bytes);
+    for (uint32_t i = 0; i < compiled->code_count; ++i) {
+        cursor = bundle_put_record(cursor, &compiled->code[i]);
+    }
+    memcpy(header + 0, digest, FA_SHA256_BYTES);
+    fa_spill_put_u32(header + 32, FA_BUNDLE_ABI_VERSION);
+    fa_spill_put_u32(header + 36, compiled->code_count);
+    fa_spill_put_u32(header + 40, (uint32_t)wasm_bytes);
+    fa_spill_put_u32(header + 44, (uint32_t)(cursor - body - bundle_align4(wasm_bytes)));
+    fa_sha256(body + wasm_bytes, (size_t)(cursor - body) - wasm_bytes, header + 48);
+    if (written_out) {
+        *written_out = total;
+    }
+    return true;
+}
+
+int fa_CompiledModule_saveBundle(const fa_CompiledModule* compiled, const char* path) {
+    if (!path || path[0] == '\0') {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    const size_t total = fa_CompiledModule_bundleSize(compiled);
+    if (total == 0) {
+        return FA_RUNTIME_ERR_UNSUPPORTED;
+    }
+    uint8_t* blob = (uint8_t*)malloc(total);
+    if (!blob) {
+        return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+    }
+    int status = fa_CompiledModule_writeBundle(compiled, blob, total, NULL) ? FA_RUNTIME_OK
+                                                                            : FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    /* Same publish step as the code cache: readers never map a torn bundle. */
+    if (status == FA_RUNTIME_OK && !fa_jit_persist_publish(path, blob, total)) {
+        status = FA_RUNTIME_ERR_STREAM;
+    }
+    free(blob);
+    return status;
+}
+
+/* The checksum only catches accidental damage: a record is trusted as far as
+   it agrees with the function body it describes. A defined function must be
+   prescanned (shared entries are never scanned again), its opcodes recorded
+   at strictly increasing pcs inside the body with the bytes found there, the
+   pc map the exact inverse of the offsets, and its blocks sorted by start
+   with else/end pcs inside the block and the body. */
+static bool bundle_record_valid(const fa_JitProgramCacheEntry* entry, const uint8_t* body) {
+    const uint32_t body_size = entry->body_size;
+    if (body_size == 0) {
+        return entry->count == 0 && entry->pc_to_index_len == 0 && entry->block_count == 0;
+    }
+    if (!body || !entry->prescanned || entry->count == 0 || entry->pc_to_index_len != body_size) {
+        return false;
+    }
+    for (uint32_t i = 0; i < entry->count; ++i) {
+        const uint32_t pc = entry->offsets[i];
+        if (pc >= body_size || (i > 0 && pc <= entry->offsets[i - 1u]) || body[pc] != entry->opcodes[i]) {
+            return false;
+        }
+    }
+    for (uint32_t pc = 0; pc < body_size; ++pc) {
+        const int32_t index = entry->pc_to_index[pc];
+        if (index != -1 && (index < 0 || (uint32_t)index >= entry->count || entry->offsets[index] != pc)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < entry->block_count; ++i) {
+        const fa_RuntimeBlockTarget* block = &entry->blocks[i];
+        if ((i > 0 && block->start_pc <= entry->blocks[i - 1u].start_pc) || block->end_pc <= block->start_pc ||
+            block->end_pc > body_size ||
+            (block->else_pc != 0 && (block->else_pc <= block->start_pc || block->else_pc >= block->end_pc))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Fills `entry` from the record at `*cursor`, pointing into the bundle when
+   `in_place` and decoding private copies otherwise. */
+static bool bundle_read_record(const uint8_t** cursor,
+                               const uint8_t* end,
+                               bool in_place,
+                               const fa_JitContext* jit_context,
+                               const uint8_t* body,
+                               fa_JitProgramCacheEntry* entry) {
+    const uint8_t* p = *cursor;
+    if ((size_t)(end - p) < BUNDLE_RECORD_BYTES) {
+        return false;
+    }
+    const uint32_t count = fa_spill_get_u32(p + 0);
+    const uint32_t pc_len = fa_spill_get_u32(p + 4);
+    const uint32_t block_count = fa_spill_get_u32(p + 8);
+    const uint32_t lowered = fa_spill_get_u32(p + 12);
+    const uint32_t flags = fa_spill_get_u32(p + 16);
+    /* Every opcode takes at least a byte and the pc map one slot per byte. */
+    if (count > entry->body_size || pc_len > entry->body_size || lowered > count ||
+        block_count > entry->body_size) {
+        return false;
+    }
+    p += BUNDLE_RECORD_BYTES;
+    const size_t need = (size_t)count * 4u + (size_t)pc_len * 4u + (size_t)block_count * 12u + bundle_align4(count);
+    if ((size_t)(end - p) < need) {
+        return false;
+    }
+    const uint8_t* offsets = p;
+    const uint8_t* pc_to_index = offsets + (size_t)count * 4u;
+    const uint8_t* blocks = pc_to_index + (size_t)pc_len * 4u;
+    const uint8_t* opcodes = blocks + (size_t)block_count * 12u;
+    *cursor = p + need;
+    if (in_place) {
+        /* The entries never write through these while shared. */
+        entry->shared = true;
+        entry->offsets = count ? (uint32_t*)(uintptr_t)offsets : NULL;
+        entry->pc_to_index = pc_len ? (int32_t*)(uintptr_t)pc_to_index : NULL;
+        entry->blocks = block_count ? (fa_RuntimeBlockTarget*)(uintptr_t)blocks : NULL;
+        entry->opcodes = count ? (uint8_t*)(uintptr_t)opcodes : NULL;
+    } else {
+        entry->offsets = count ? (uint32_t*)malloc((size_t)count * sizeof(uint32_t)) : NULL;
+        entry->pc_to_index = pc_len ? (int32_t*)malloc((size_t)pc_len * sizeof(int32_t)) : NULL;
+        entry->blocks = block_count ? (fa_RuntimeBlockTarget*)malloc(block_count * sizeof(fa_RuntimeBlockTarget))
+                                    : NULL;
+        entry->opcodes = count ? (uint8_t*)malloc(count) : NULL;
+        if ((count && (!entry->offsets || !entry->opcodes)) || (pc_len && !entry->pc_to_index) ||
+            (block_count && !entry->blocks)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            entry->offsets[i] = fa_spill_get_u32(offsets + (size_t)i * 4u);
+        }
+        for (uint32_t i = 0; i < pc_len; ++i) {
+            entry->pc_to_index[i] = (int32_t)fa_spill_get_u32(pc_to_index + (size_t)i * 4u);
+        }
+        for (uint32_t i = 0; i < block_count; ++i) {
+            entry->blocks[i].start_pc = fa_spill_get_u32(blocks + (size_t)i * 12u + 0u);
+            entry->blocks[i].else_pc = fa_spill_get_u32(blocks + (size_t)i * 12u + 4u);
+            entry->blocks[i].end_pc = fa_spill_get_u32(blocks + (size_t)i * 12u + 8u);
+        }
+        if (count > 0) {
+            memcpy(entry->opcodes, opcodes, count);
+        }
+    }
+    entry->count = count;
+    entry->capacity = count;
+    entry->pc_to_index_len = pc_len;
+    entry->block_count = block_count;
+    entry->prescanned = (flags & BUNDLE_FLAG_PRESCANNED) != 0;
+    if (!bundle_record_valid(entry, body)) {
+        return false;
+    }
+    if (lowered > 0) {
+        if (!fa_jit_prepare_program_from_opcodes(entry->opcodes, lowered, &entry->program)) {
+            return false;
+        }
+        entry->prepared_count = entry->program.count;
+        if (jit_context->config.fuse_ops) {
+            (void)fa_jit_program_fuse(&entry->program, entry->offsets, entry->count);
+        }
+        entry->program_bytes = fa_jit_program_estimate_bytes(&entry->program);
+        entry->ready = true;
     }
-    runtime_traps_reset(runtime);
-    if (module->num_functions > 0) {
-        runtime->function_traps = (uint8_t*)calloc(module->num_functions, sizeof(uint8_t));
-        if (!runtime->function_traps) {
-            fa_Runtime_detachModule(runtime);
-            return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+    return true;
+}
+
+static WasmModule* bundle_load_module(const uint8_t* bytes, size_t size) {
+    WasmModule* module = wasm_module_init_borrowed(bytes, size);
+    if (!module) {
+        return NULL;
+    }
+    bool ok = wasm_load_header(module) == 0 && wasm_scan_sections(module) == 0 && wasm_load_types(module) == 0 &&
+              wasm_load_functions(module) == 0 && wasm_load_tables(module) == 0 &&
+              wasm_load_memories(module) == 0 && wasm_load_globals(module) == 0 &&
+              wasm_load_elements(module) == 0 && wasm_load_data(module) == 0;
+    /* wasm_load_exports fails on a module without an export section. */
+    for (uint32_t i = 0; ok && i < module->num_sections; ++i) {
+        if (module->sections[i].type == SECTION_EXPORT) {
+            ok = wasm_load_exports(module) == 0;
+            break;
         }
-        runtime->function_trap_count = module->num_functions;
     }
-    status = runtime_jit_cache_init(runtime);
-    if (status != FA_RUNTIME_OK) {
-        fa_Runtime_detachModule(runtime);
-        return status;
+    if (!ok) {
+        wasm_module_free(module);
+        return NULL;
     }
-    return FA_RUNTIME_OK;
+    return module;
 }
 
-void fa_Runtime_detachModule(fa_Runtime* runtime) {
-    if (!runtime) {
-        return;
+fa_CompiledModule* fa_CompiledModule_openBundle(const uint8_t* bytes, size_t size) {
+    uint16_t kind = 0;
+    uint64_t payload = 0;
+    if (!fa_spill_read_header(bytes, size, &kind, &payload) || kind != (uint16_t)FA_SPILL_KIND_MODULE_BUNDLE ||
+        payload < BUNDLE_HEADER_BYTES) {
+        return NULL;
     }
-    if (runtime->stream) {
-        wasm_instruction_stream_free(runtime->stream);
-        runtime->stream = NULL;
+    const uint8_t* header = bytes + FA_SPILL_HEADER_BYTES;
+    const uint8_t* body = header + BUNDLE_HEADER_BYTES;
+    const size_t body_bytes = (size_t)payload - BUNDLE_HEADER_BYTES;
+    const uint32_t function_count = fa_spill_get_u32(header + 36);
+    const uint32_t wasm_bytes = fa_spill_get_u32(header + 40);
+    const uint32_t record_bytes = fa_spill_get_u32(header + 44);
+    if (fa_spill_get_u32(header + 32) != FA_BUNDLE_ABI_VERSION || wasm_bytes == 0 ||
+        (uint64_t)bundle_align4(wasm_bytes) + record_bytes != (uint64_t)body_bytes) {
+        return NULL;
     }
-    runtime_globals_reset(runtime);
-    runtime_segments_reset(runtime);
-    runtime_tables_reset(runtime);
-    runtime_memory_reset(runtime);
-    runtime_jit_cache_clear(runtime);
-    runtime_traps_reset(runtime);
-    runtime->module = NULL;
-    runtime->active_locals = NULL;
-    runtime->active_locals_count = 0;
+    /* The image digest is recomputed, never taken from the header: it keys
+       the persisted code cache, so a bundle must not be able to claim
+       another module's identity. */
+    uint8_t module_digest[FA_SHA256_BYTES];
+    uint8_t record_digest[FA_SHA256_BYTES];
+    fa_sha256(body, wasm_bytes, module_digest);
+    fa_sha256(body + wasm_bytes, body_bytes - wasm_bytes, record_digest);
+    if (memcmp(module_digest, header + 0, FA_SHA256_BYTES) != 0 ||
+        memcmp(record_digest, header + 48, FA_SHA256_BYTES) != 0) {
+        return NULL;
+    }
+
+    fa_CompiledModule* compiled = (fa_CompiledModule*)calloc(1, sizeof(fa_CompiledModule));
+    WasmModule* module = compiled ? bundle_load_module(body, wasm_bytes) : NULL;
+    if (!module || module->num_functions != function_count) {
+        wasm_module_free(module);
+        free(compiled);
+        return NULL;
+    }
+    memcpy(module->content_digest, module_digest, FA_SHA256_BYTES);
+    module->content_digest_valid = true;
+    compiled->module = module;
+    compiled->refs = 1;
+    compiled->code_count = function_count;
+    compiled->code = function_count
+                         ? (fa_JitProgramCacheEntry*)calloc(function_count, sizeof(fa_JitProgramCacheEntry))
+                         : NULL;
+    bool ok = function_count == 0 || compiled->code != NULL;
+
+    fa_JitContext jit_context;
+    fa_jit_context_init(&jit_context, NULL);
+    fa_jit_context_apply_env_overrides(&jit_context);
+    const bool in_place = FA_ARCH_LITTLE_ENDIAN && sizeof(fa_RuntimeBlockTarget) == 12u && ((uintptr_t)bytes & 3u) == 0;
+    const uint8_t* cursor = body + bundle_align4(wasm_bytes);
+    const uint8_t* end = body + body_bytes;
+    /* Bodies first: every record is checked against its function's bytes. */
+    ok = ok && compiled_module_load_bodies(compiled) && compiled_module_init_tier_code(compiled);
+    for (uint32_t i = 0; ok && i < function_count; ++i) {
+        fa_JitProgramCacheEntry* entry = &compiled->code[i];
+        entry->func_index = i;
+        entry->body_size = module->functions[i].body_size;
+        fa_jit_program_init(&entry->program);
+        ok = bundle_read_record(&cursor, end, in_place, &jit_context, compiled->bodies[i], entry);
+        if (ok) {
+            compiled->prescan_blocks += entry->block_count;
+            compiled->prescan_programs += entry->ready ? 1u : 0u;
+        }
+    }
+    ok = ok && cursor == end;
+    if (!ok) {
+        compiled_module_free(compiled);
+        return NULL;
+    }
+    (void)fa_instance_ops();
+    return compiled;
+}
+
+fa_CompiledModule* fa_CompiledModule_loadBundle(const char* path) {
+    if (!path) {
+        return NULL;
+    }
+#if defined(FA_RUNTIME_HAS_MMAP)
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0 && (uint64_t)st.st_size <= (uint64_t)SIZE_MAX) {
+        mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return NULL;
+    }
+    fa_CompiledModule* compiled = fa_CompiledModule_openBundle((const uint8_t*)mapped, (size_t)st.st_size);
+    if (!compiled) {
+        munmap(mapped, (size_t)st.st_size);
+        return NULL;
+    }
+    compiled->bundle_map = mapped;
+    compiled->bundle_map_bytes = (size_t)st.st_size;
+    return compiled;
+#else
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    uint8_t* blob = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        size = ftell(file);
+    }
+    if (size > (long)FA_SPILL_HEADER_BYTES && fseek(file, 0, SEEK_SET) == 0) {
+        blob = (uint8_t*)malloc((size_t)size);
+        if (blob && fread(blob, 1, (size_t)size, file) != (size_t)size) {
+            free(blob);
+            blob = NULL;
+        }
+    }
+    fclose(file);
+    fa_CompiledModule* compiled = blob ? fa_CompiledModule_openBundle(blob, (size_t)size) : NULL;
+    if (!compiled) {
+        free(blob);
+        return NULL;
+    }
+    compiled->bundle_copy = blob;
+    return compiled;
+#endif
 }
 
 fa_Job* fa_Runtime_createJob(fa_Runtime* runtime) {
@@ -3580,6 +6445,7 @@ int fa_Runtime_setFunctionTrap(fa_Runtime* runtime, uint32_t function_index, boo
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
     runtime->function_traps[function_index] = enabled ? 1U : 0U;
+    runtime_jit_native_publish(runtime, function_index);
     return FA_RUNTIME_OK;
 }
 
@@ -3588,6 +6454,9 @@ void fa_Runtime_clearFunctionTraps(fa_Runtime* runtime) {
         return;
     }
     memset(runtime->function_traps, 0, runtime->function_trap_count * sizeof(uint8_t));
+    for (uint32_t i = 0; i < runtime->function_trap_count; ++i) {
+        runtime_jit_native_publish(runtime, i);
+    }
 }
 
 void fa_Runtime_setSpillHooks(fa_Runtime* runtime, const fa_RuntimeSpillHooks* hooks) {
@@ -3609,7 +6478,7 @@ int fa_Runtime_jitSpillProgram(fa_Runtime* runtime, uint32_t function_index) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
     fa_JitProgramCacheEntry* entry = &runtime->jit_cache[function_index];
-    if (!entry->ready || entry->program.count == 0) {
+    if (!runtime_jit_cache_program_resident(entry)) {
         return FA_RUNTIME_OK;
     }
     runtime_jit_cache_evict_entry(runtime, entry);
@@ -3630,6 +6499,64 @@ int fa_Runtime_jitLoadProgram(fa_Runtime* runtime, uint32_t function_index) {
     return runtime_jit_cache_load_entry(runtime, entry);
 }
 
+bool fa_Runtime_jitIsNative(const fa_Runtime* runtime, uint32_t function_index) {
+    if (!runtime || !runtime->jit_cache || function_index >= runtime->jit_cache_count) {
+        return false;
+    }
+    return runtime->jit_cache[function_index].native.entry != NULL;
+}
+
+bool fa_Runtime_jitIsClosure(const fa_Runtime* runtime, uint32_t function_index) {
+    if (!runtime || !runtime->jit_cache || function_index >= runtime->jit_cache_count) {
+        return false;
+    }
+    return runtime->jit_cache[function_index].program.closure != NULL;
+}
+
+int fa_Runtime_setJitCacheDir(fa_Runtime* runtime, const char* dir) {
+    if (!runtime) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    char* copy = NULL;
+    if (dir && dir[0] != '\0') {
+        copy = runtime_strdup(dir);
+        if (!copy) {
+            return FA_RUNTIME_ERR_OUT_OF_MEMORY;
+        }
+    }
+    free(runtime->jit_persist_dir);
+    runtime->jit_persist_dir = copy;
+    return FA_RUNTIME_OK;
+}
+
+int fa_Runtime_setAotFunctions(fa_Runtime* runtime, const fa_JitNativeEntry* entries, uint32_t count) {
+    if (!runtime) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    if (!entries) {
+        runtime->aot_entries = NULL;
+        runtime->aot_entry_count = 0;
+        return FA_RUNTIME_OK;
+    }
+    if (!runtime->module) {
+        return FA_RUNTIME_ERR_NO_MODULE;
+    }
+    if (count != runtime->module->num_functions) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    runtime->aot_entries = entries;
+    runtime->aot_entry_count = count;
+    return FA_RUNTIME_OK;
+}
+
+void fa_Runtime_jitFlush(fa_Runtime* runtime) {
+    if (!runtime || !runtime->jit_workers) {
+        return;
+    }
+    fa_jit_workers_wait_idle(runtime->jit_workers);
+    runtime_jit_workers_poll(runtime);
+}
+
 int fa_Runtime_spillMemory(fa_Runtime* runtime, uint32_t memory_index) {
     if (!runtime || !runtime->memories) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
@@ -3641,6 +6568,10 @@ int fa_Runtime_spillMemory(fa_Runtime* runtime, uint32_t memory_index) {
     if (!memory->owns_data) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
+    if (memory->pager) {
+        /* Paged memories spill page by page; this releases every frame. */
+        return runtime_pager_flush(runtime, memory_index, memory->pager, true);
+    }
     if (memory->size_bytes == 0) {
         memory->is_spilled = false;
         return FA_RUNTIME_OK;
@@ -3656,8 +6587,7 @@ int fa_Runtime_spillMemory(fa_Runtime* runtime, uint32_t memory_index) {
     if (status != FA_RUNTIME_OK) {
         return status;
     }
-    runtime->free(memory->data);
-    memory->data = NULL;
+    runtime_memory_release_data(runtime, memory);
     memory->is_spilled = true;
     return FA_RUNTIME_OK;
 }
@@ -3673,7 +6603,7 @@ int fa_Runtime_loadMemory(fa_Runtime* runtime, uint32_t memory_index) {
     if (!memory->owns_data) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
-    if (memory->size_bytes == 0) {
+    if (memory->size_bytes == 0 || memory->pager) {
         memory->is_spilled = false;
         return FA_RUNTIME_OK;
     }
@@ -3703,7 +6633,8 @@ int fa_Runtime_ensureMemoryLoaded(fa_Runtime* runtime, uint32_t memory_index) {
         return FA_RUNTIME_ERR_INVALID_ARGUMENT;
     }
     fa_RuntimeMemory* memory = &runtime->memories[memory_index];
-    if (memory->size_bytes == 0) {
+    /* Paged memories fault individual pages in on access instead. */
+    if (memory->size_bytes == 0 || memory->pager) {
         return FA_RUNTIME_OK;
     }
     if (memory->data) {
@@ -3727,6 +6658,282 @@ int fa_Runtime_ensureMemoryLoaded(fa_Runtime* runtime, uint32_t memory_index) {
     return FA_RUNTIME_OK;
 }
 
+int fa_Runtime_growMemory(fa_Runtime* runtime,
+                          uint32_t memory_index,
+                          uint64_t delta_pages,
+                          uint64_t* prev_pages_out,
+                          bool* grew_out) {
+    if (!runtime || !prev_pages_out || !grew_out || !runtime->memories || memory_index >= runtime->memories_count) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    fa_RuntimeMemory* memory = &runtime->memories[memory_index];
+    int status = fa_Runtime_ensureMemoryLoaded(runtime, memory_index);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    const uint64_t prev_pages = memory->size_bytes / FA_WASM_PAGE_SIZE;
+    if (!memory->is_memory64 && prev_pages > UINT32_MAX) {
+        return FA_RUNTIME_ERR_UNSUPPORTED;
+    }
+    *prev_pages_out = prev_pages;
+    *grew_out = false;
+    if (delta_pages == 0) {
+        *grew_out = true;
+        return FA_RUNTIME_OK;
+    }
+    if (!memory->owns_data) {
+        return FA_RUNTIME_OK;
+    }
+    const uint64_t new_pages = prev_pages + delta_pages;
+    if (new_pages < prev_pages) {
+        return FA_RUNTIME_OK;
+    }
+    if (memory->has_max) {
+        const uint64_t max_pages = memory->max_size_bytes / FA_WASM_PAGE_SIZE;
+        if (new_pages > max_pages) {
+            return FA_RUNTIME_OK;
+        }
+    }
+    if (new_pages > (UINT64_MAX / FA_WASM_PAGE_SIZE)) {
+        return FA_RUNTIME_OK;
+    }
+    const uint64_t new_size_bytes = new_pages * FA_WASM_PAGE_SIZE;
+    if (memory->pager) {
+        /* Fresh pages were never spilled, so they fault in zero-filled. */
+        memory->size_bytes = new_size_bytes;
+        *grew_out = true;
+        return FA_RUNTIME_OK;
+    }
+    if (new_size_bytes > SIZE_MAX || new_size_bytes > (uint64_t)INT_MAX) {
+        return FA_RUNTIME_OK;
+    }
+    uint8_t* new_data = (uint8_t*)runtime->malloc((int)new_size_bytes);
+    if (!new_data) {
+        return FA_RUNTIME_OK;
+    }
+    if (memory->data && memory->size_bytes > 0) {
+        memcpy(new_data, memory->data, (size_t)memory->size_bytes);
+    }
+    if (new_size_bytes > memory->size_bytes) {
+        memset(new_data + memory->size_bytes, 0, (size_t)(new_size_bytes - memory->size_bytes));
+    }
+    runtime_memory_release_data(runtime, memory);
+    memory->data = new_data;
+    memory->size_bytes = new_size_bytes;
+    *grew_out = true;
+    return FA_RUNTIME_OK;
+}
+
+void fa_Runtime_setMemoryImage(fa_Runtime* runtime, const fa_RuntimeMemoryImage* image) {
+    if (!runtime) {
+        return;
+    }
+    runtime->memory_image = image;
+}
+
+int fa_Runtime_setMemoryPaging(fa_Runtime* runtime, const fa_RuntimeMemoryPaging* paging) {
+    if (!runtime) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    if (!paging) {
+        memset(&runtime->memory_paging, 0, sizeof(runtime->memory_paging));
+        return FA_RUNTIME_OK;
+    }
+    if (!runtime_paging_config_valid(paging)) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    runtime->memory_paging = *paging;
+    return FA_RUNTIME_OK;
+}
+
+int fa_Runtime_getMemoryPagingStats(const fa_Runtime* runtime,
+                                    uint32_t memory_index,
+                                    fa_RuntimeMemoryPagingStats* stats_out) {
+    if (!runtime || !stats_out || !runtime->memories || memory_index >= runtime->memories_count) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    const fa_RuntimeMemory* memory = &runtime->memories[memory_index];
+    if (!memory->pager) {
+        return FA_RUNTIME_ERR_UNSUPPORTED;
+    }
+    *stats_out = memory->pager->stats;
+    stats_out->tlb_hits = memory->pager->tlb.hits;
+    return FA_RUNTIME_OK;
+}
+
+static int runtime_memory_require_range(fa_Runtime* runtime,
+                                        uint32_t memory_index,
+                                        uint64_t offset,
+                                        size_t size,
+                                        fa_RuntimeMemory** memory_out) {
+    if (!runtime || !runtime->memories || memory_index >= runtime->memories_count) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    int status = fa_Runtime_ensureMemoryLoaded(runtime, memory_index);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    fa_RuntimeMemory* memory = &runtime->memories[memory_index];
+    if (runtime_memory_bounds_check(memory, offset, size) != FA_RUNTIME_OK) {
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    *memory_out = memory;
+    return FA_RUNTIME_OK;
+}
+
+int fa_Runtime_readMemory(fa_Runtime* runtime, uint32_t memory_index, uint64_t offset, void* out, size_t size) {
+    if (!out && size > 0) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    fa_RuntimeMemory* memory = NULL;
+    int status = runtime_memory_require_range(runtime, memory_index, offset, size, &memory);
+    if (status != FA_RUNTIME_OK || size == 0) {
+        return status;
+    }
+    if (memory->pager) {
+        return runtime_pager_access(runtime, memory_index, memory->pager, offset, (uint8_t*)out, 0, size,
+                                    FA_RUNTIME_PAGER_READ);
+    }
+    memcpy(out, memory->data + (size_t)offset, size);
+    return FA_RUNTIME_OK;
+}
+
+int fa_Runtime_writeMemory(fa_Runtime* runtime, uint32_t memory_index, uint64_t offset, const void* data, size_t size) {
+    if (!data && size > 0) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    fa_RuntimeMemory* memory = NULL;
+    int status = runtime_memory_require_range(runtime, memory_index, offset, size, &memory);
+    if (status != FA_RUNTIME_OK || size == 0) {
+        return status;
+    }
+    if (memory->pager) {
+        return runtime_pager_access(runtime, memory_index, memory->pager, offset, (uint8_t*)data, 0, size,
+                                    FA_RUNTIME_PAGER_WRITE);
+    }
+    memcpy(memory->data + (size_t)offset, data, size);
+    return FA_RUNTIME_OK;
+}
+
+int fa_Runtime_pagedRead(fa_Runtime* runtime, const fa_RuntimeMemory* memory, uint64_t offset, void* out, size_t size) {
+    if (!runtime || !memory || !memory->pager || (!out && size > 0)) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    return runtime_pager_access(runtime, (uint32_t)(memory - runtime->memories), memory->pager, offset,
+                                (uint8_t*)out, 0, size, FA_RUNTIME_PAGER_READ);
+}
+
+int fa_Runtime_pagedWrite(fa_Runtime* runtime, fa_RuntimeMemory* memory, uint64_t offset, const void* data, size_t size) {
+    if (!runtime || !memory || !memory->pager || (!data && size > 0)) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    return runtime_pager_access(runtime, (uint32_t)(memory - runtime->memories), memory->pager, offset,
+                                (uint8_t*)data, 0, size, FA_RUNTIME_PAGER_WRITE);
+}
+
+int fa_Runtime_fillMemory(fa_Runtime* runtime, uint32_t memory_index, uint64_t offset, uint8_t value, size_t size) {
+    fa_RuntimeMemory* memory = NULL;
+    int status = runtime_memory_require_range(runtime, memory_index, offset, size, &memory);
+    if (status != FA_RUNTIME_OK || size == 0) {
+        return status;
+    }
+    if (memory->pager) {
+        return runtime_pager_access(runtime, memory_index, memory->pager, offset, NULL, value, size,
+                                    FA_RUNTIME_PAGER_FILL);
+    }
+    fa_bulk_fill(memory->data + (size_t)offset, value, size);
+    return FA_RUNTIME_OK;
+}
+
+int fa_Runtime_copyMemory(fa_Runtime* runtime,
+                          uint32_t dst_index,
+                          uint64_t dst_offset,
+                          uint32_t src_index,
+                          uint64_t src_offset,
+                          size_t size) {
+    fa_RuntimeMemory* dst = NULL;
+    fa_RuntimeMemory* src = NULL;
+    int status = runtime_memory_require_range(runtime, src_index, src_offset, size, &src);
+    if (status != FA_RUNTIME_OK) {
+        return status;
+    }
+    status = runtime_memory_require_range(runtime, dst_index, dst_offset, size, &dst);
+    if (status != FA_RUNTIME_OK || size == 0) {
+        return status;
+    }
+    if (!dst->pager && !src->pager) {
+        fa_bulk_copy(dst->data + (size_t)dst_offset, src->data + (size_t)src_offset, size);
+        return FA_RUNTIME_OK;
+    }
+    /* Bounce through a stack buffer; walk backwards when an in-place copy
+       moves data up so overlapping bytes are read before they are clobbered. */
+    uint8_t bounce[256];
+    const bool backward = dst_index == src_index && dst_offset > src_offset;
+    size_t remaining = size;
+    while (remaining > 0) {
+        const size_t chunk = remaining < sizeof(bounce) ? remaining : sizeof(bounce);
+        const uint64_t at = backward ? (uint64_t)(remaining - chunk) : (uint64_t)(size - remaining);
+        status = fa_Runtime_readMemory(runtime, src_index, src_offset + at, bounce, chunk);
+        if (status != FA_RUNTIME_OK) {
+            return status;
+        }
+        status = fa_Runtime_writeMemory(runtime, dst_index, dst_offset + at, bounce, chunk);
+        if (status != FA_RUNTIME_OK) {
+            return status;
+        }
+        remaining -= chunk;
+    }
+    return FA_RUNTIME_OK;
+}
+
+int fa_Runtime_initMemory(fa_Runtime* runtime,
+                          uint32_t memory_index,
+                          uint64_t offset,
+                          uint32_t data_index,
+                          uint64_t src_offset,
+                          size_t size) {
+    if (!runtime || !runtime->module) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    WasmModule* module = runtime->module;
+    if (data_index >= module->num_data_segments || !module->data_segments) {
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    const WasmDataSegment* segment = &module->data_segments[data_index];
+    if (src_offset > segment->size || (uint64_t)size > segment->size - src_offset) {
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    fa_RuntimeMemory* memory = NULL;
+    int status = runtime_memory_require_range(runtime, memory_index, offset, size, &memory);
+    if (status != FA_RUNTIME_OK || size == 0) {
+        return status;
+    }
+    if (segment->data) {
+        return fa_Runtime_writeMemory(runtime, memory_index, offset, segment->data + (size_t)src_offset, size);
+    }
+    if (!memory->pager) {
+        return wasm_read_data_segment(module, data_index, src_offset, memory->data + (size_t)offset, size) == 0
+            ? FA_RUNTIME_OK
+            : FA_RUNTIME_ERR_STREAM;
+    }
+    /* Segment bytes still live in the module file: stream them through a
+       bounce buffer so paged memory never needs the whole segment resident. */
+    uint8_t bounce[256];
+    size_t done = 0;
+    while (done < size) {
+        const size_t chunk = size - done < sizeof(bounce) ? size - done : sizeof(bounce);
+        if (wasm_read_data_segment(module, data_index, src_offset + done, bounce, chunk) != 0) {
+            return FA_RUNTIME_ERR_STREAM;
+        }
+        status = fa_Runtime_writeMemory(runtime, memory_index, offset + done, bounce, chunk);
+        if (status != FA_RUNTIME_OK) {
+            return status;
+        }
+        done += chunk;
+    }
+    return FA_RUNTIME_OK;
+}
+
 /* ------------------------------------------------------------------------- *
  * Versioned linear-memory serialization.
  *
@@ -3761,7 +6968,7 @@ bool fa_Runtime_serializeMemory(fa_Runtime* runtime,
     }
     fa_RuntimeMemory* memory = &runtime->memories[memory_index];
     /* A spilled (unloaded) memory has no bytes to capture. */
-    if (!memory->data && memory->size_bytes != 0) {
+    if (!memory->data && !memory->pager && memory->size_bytes != 0) {
         return false;
     }
     size_t needed = fa_Runtime_serializedMemorySize(runtime, memory_index);
@@ -3776,7 +6983,12 @@ bool fa_Runtime_serializeMemory(fa_Runtime* runtime,
     memset(body, 0, FA_SPILL_MEMORY_BODY_HEADER_BYTES);
     body[0] = (uint8_t)(memory->is_memory64 ? 0x01u : 0x00u);
     fa_spill_put_u64(body + 8, memory->size_bytes);
-    if (memory->size_bytes != 0) {
+    if (memory->pager) {
+        if (fa_Runtime_readMemory(runtime, memory_index, 0, body + FA_SPILL_MEMORY_BODY_HEADER_BYTES,
+                                  (size_t)memory->size_bytes) != FA_RUNTIME_OK) {
+            return false;
+        }
+    } else if (memory->size_bytes != 0) {
         memcpy(body + FA_SPILL_MEMORY_BODY_HEADER_BYTES, memory->data, (size_t)memory->size_bytes);
     }
     if (written_out) {
@@ -3806,10 +7018,20 @@ bool fa_Runtime_deserializeMemory(fa_Runtime* runtime,
     if (size_bytes != payload - (uint64_t)FA_SPILL_MEMORY_BODY_HEADER_BYTES) {
         return false;
     }
+    fa_RuntimeMemory* memory = &runtime->memories[memory_index];
+    if (memory->has_max && size_bytes > memory->max_size_bytes) {
+        return false;
+    }
+    if (memory->pager) {
+        /* Every page of the image is rewritten, so stale spilled pages never resurface. */
+        memory->size_bytes = size_bytes;
+        memory->is_memory64 = (flags & 0x01u) != 0;
+        return fa_Runtime_writeMemory(runtime, memory_index, 0, body + FA_SPILL_MEMORY_BODY_HEADER_BYTES,
+                                      (size_t)size_bytes) == FA_RUNTIME_OK;
+    }
     if (size_bytes > (uint64_t)INT_MAX) {
         return false;
     }
-    fa_RuntimeMemory* memory = &runtime->memories[memory_index];
     /* Never clobber a host-provided buffer the runtime does not own. */
     if (!memory->owns_data && memory->data) {
         return false;
@@ -3822,9 +7044,7 @@ bool fa_Runtime_deserializeMemory(fa_Runtime* runtime,
         }
         memcpy(data, body + FA_SPILL_MEMORY_BODY_HEADER_BYTES, (size_t)size_bytes);
     }
-    if (memory->data) {
-        runtime->free(memory->data);
-    }
+    runtime_memory_release_data(runtime, memory);
     memory->data = data;
     memory->size_bytes = size_bytes;
     memory->is_memory64 = (flags & 0x01u) != 0;
@@ -3888,11 +7108,11 @@ static int runtime_decode_instruction(const uint8_t* body,
             }
             uint32_t else_pc = 0;
             uint32_t end_pc = 0;
-            status = runtime_scan_block(body, body_size, runtime, frame->pc, &else_pc, &end_pc);
+            status = runtime_find_block(runtime, frame, body, body_size, &else_pc, &end_pc);
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
-            status = runtime_stack_check_types_u32(&job->stack, sig.param_types, sig.param_count);
+            status = runtime_stack_check_types_u8(&job->stack, sig.param_types, sig.param_count);
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -3931,7 +7151,7 @@ static int runtime_decode_instruction(const uint8_t* body,
             }
             uint32_t else_pc = 0;
             uint32_t end_pc = 0;
-            status = runtime_scan_block(body, body_size, runtime, frame->pc, &else_pc, &end_pc);
+            status = runtime_find_block(runtime, frame, body, body_size, &else_pc, &end_pc);
             if (status != FA_RUNTIME_OK) {
                 return status;
             }
@@ -4632,6 +7852,10 @@ static int runtime_branch_to_label(fa_Runtime* runtime, fa_RuntimeCallFrame* fra
         }
     }
     if (target_copy.type == FA_CONTROL_LOOP && runtime) {
+        if (runtime->jit_workers) {
+            runtime_jit_workers_poll(runtime);
+        }
+        runtime_jit_cache_touch(runtime, runtime_jit_cache_entry(runtime, frame->func_index));
         runtime->jit_stats.hot_loop_hits++;
         if (runtime->jit_stats.hot_loop_hits == runtime->jit_context.config.min_hot_loop_hits) {
             fa_jit_context_update(&runtime->jit_context, &runtime->jit_stats);
@@ -4641,6 +7865,14 @@ static int runtime_branch_to_label(fa_Runtime* runtime, fa_RuntimeCallFrame* fra
     if (target_copy.type == FA_CONTROL_LOOP) {
         frame->pc = target_copy.start_pc;
         runtime_control_pop_to(frame, label_index, true);
+        fa_RuntimeControlFrame* loop = &frame->control_stack[frame->control_depth - 1U];
+        loop->back_edges++;
+        const uint32_t osr_threshold = runtime ? runtime->jit_context.config.osr_threshold : 0;
+        if (osr_threshold > 0 && loop->back_edges % osr_threshold == 0 &&
+            (runtime->jit_context.decision.tier == FA_JIT_TIER_NATIVE ||
+             runtime->jit_context.decision.tier == FA_JIT_TIER_CLOSURE)) {
+            frame->osr_pending = true;
+        }
     } else {
         frame->pc = target_copy.end_pc;
         runtime_control_pop_to(frame, label_index, false);
@@ -4789,8 +8021,7 @@ static int runtime_execute_job_internal(fa_Runtime* runtime,
             return FA_RUNTIME_ERR_INVALID_ARGUMENT;
         }
         for (uint32_t i = 0; i < arg_count; ++i) {
-            if (target_signature->param_types[i] > UINT8_MAX ||
-                !runtime_job_value_matches_valtype(&args[i], (uint8_t)target_signature->param_types[i])) {
+            if (!runtime_job_value_matches_valtype(&args[i], target_signature->param_types[i])) {
                 return FA_RUNTIME_ERR_INVALID_ARGUMENT;
             }
         }
@@ -4804,14 +8035,25 @@ static int runtime_execute_job_internal(fa_Runtime* runtime,
     }
     memset(&runtime->jit_stats, 0, sizeof(runtime->jit_stats));
     runtime->jit_prepared_executions = 0;
+    runtime->jit_fused_executions = 0;
     fa_jit_context_update(&runtime->jit_context, &runtime->jit_stats);
-    if (runtime->jit_context.config.prescan_force && !runtime->jit_cache_prescanned) {
+    if (runtime->jit_workers) {
+        runtime_jit_workers_poll(runtime);
+    }
+    if (runtime->jit_context.config.prescan_force && !runtime->jit_context.config.prescan_lazy &&
+        !runtime->jit_cache_prescanned) {
         int prescan_status = runtime_jit_cache_prescan(runtime);
         if (prescan_status != FA_RUNTIME_OK) {
             return prescan_status;
         }
     }
 
+    return runtime_run_function(runtime, job, function_index);
+}
+
+/* Interpreter loop for one top-level call; arguments are already on the job
+   stack. Also re-entered from native code that calls interpreted functions. */
+static int runtime_run_function(fa_Runtime* runtime, fa_Job* job, uint32_t function_index) {
     fa_RuntimeCallFrame* frames = runtime_alloc_frames(runtime);
     if (!frames) {
         return FA_RUNTIME_ERR_OUT_OF_MEMORY;
@@ -4827,7 +8069,7 @@ static int runtime_execute_job_internal(fa_Runtime* runtime,
     while (status == FA_RUNTIME_OK && depth > 0) {
         fa_RuntimeCallFrame* frame = &frames[depth - 1];
         if (frame->pc >= frame->body_size) {
-            runtime_pop_frame(frames, &depth);
+            runtime_pop_frame(runtime, frames, &depth);
             continue;
         }
         runtime->active_locals = frame->locals;
@@ -4857,9 +8099,14 @@ static int runtime_execute_job_internal(fa_Runtime* runtime,
                 break;
             }
             if (ctx.request_return || ctx.request_end) {
-                runtime_pop_frame(frames, &depth);
+                runtime_pop_frame(runtime, frames, &depth);
                 continue;
             }
+            if (frame->osr_pending) {
+                bool entered = false;
+                frame->osr_pending = false;
+                status = runtime_jit_osr_enter(runtime, frames, &depth, job, &entered);
+            }
             continue;
         }
 
@@ -4874,6 +8121,12 @@ static int runtime_execute_job_internal(fa_Runtime* runtime,
         if (prepared) {
             status = fa_jit_execute_prepared_op(prepared, runtime, job);
             runtime->jit_prepared_executions++;
+            if (prepared->fused_ops > 0 && status == FA_RUNTIME_OK) {
+                /* The fused partners are one-byte, immediate-free opcodes. */
+                frame->pc += prepared->fused_ops;
+                runtime->jit_stats.executed_ops += prepared->fused_ops;
+                runtime->jit_fused_executions++;
+            }
         } else {
             status = fa_execute_op(opcode, runtime, job);
         }
@@ -4902,7 +8155,7 @@ static int runtime_execute_job_internal(fa_Runtime* runtime,
         }
 
         if (ctx.request_return || ctx.request_end) {
-            runtime_pop_frame(frames, &depth);
+            runtime_pop_frame(runtime, frames, &depth);
             runtime_instruction_context_free(&ctx);
             continue;
         }
@@ -4911,7 +8164,7 @@ static int runtime_execute_job_internal(fa_Runtime* runtime,
     }
 
     while (depth > 0) {
-        runtime_pop_frame(frames, &depth);
+        runtime_pop_frame(runtime, frames, &depth);
     }
     runtime->active_locals = NULL;
     runtime->active_locals_count = 0;
@@ -7,9 +7,15 @@
 #include "fa_jit.h"
 
 struct fa_JitProgramCacheEntry;
+struct fa_JitCodeCache;
+struct fa_JitWorkerPool;
 struct fa_RuntimeHostBinding;
 struct fa_RuntimeHostMemoryBinding;
 struct fa_RuntimeHostTableBinding;
+struct fa_RuntimeMemoryPager;
+struct fa_RuntimeMemoryTlb;
+struct fa_RuntimeMemoryImage;
+struct fa_CompiledModule;
 
 #define FA_WASM_PAGE_SIZE 65536U
 
@@ -34,6 +40,10 @@ typedef struct {
     bool is_spilled;
     bool is_host;
     bool owns_data;
+    bool from_image;      // data came pre-initialized from a shared fa_RuntimeMemoryImage
+    size_t mapped_bytes;  // non-zero when data is a private (copy-on-write) mapping
+    struct fa_RuntimeMemoryPager* pager; // non-NULL when the memory is demand-paged (data stays NULL)
+    struct fa_RuntimeMemoryTlb* tlb;     // the pager's TLB, set together with `pager`
 } fa_RuntimeMemory;
 
 typedef struct {
@@ -82,6 +92,84 @@ typedef struct {
     void* user_data;
 } fa_RuntimeSpillHooks;
 
+/* Demand-paged linear memory. When enabled (see fa_Runtime_setMemoryPaging),
+   every runtime-owned memory is split into fixed `page_bytes` pages and only
+   `resident_pages` of them are held in RAM at once. Misses fault pages in
+   through `page_load`; dirty victims chosen by a CLOCK sweep are written back
+   through `page_spill`. Pages never spilled read back as zeroes without a hook
+   call, so the backing store only ever sees pages the module actually wrote. */
+#define FA_RUNTIME_MEMORY_PAGE_BYTES_DEFAULT 4096U
+#define FA_RUNTIME_MEMORY_PAGE_BYTES_MIN 256U
+#define FA_RUNTIME_MEMORY_TLB_ENTRIES 16U
+
+typedef int (*fa_RuntimeMemoryPageSpillHook)(struct fa_Runtime* runtime,
+                                             uint32_t memory_index,
+                                             uint64_t page_index,
+                                             const uint8_t* data,
+                                             uint32_t page_bytes,
+                                             void* user_data);
+
+typedef int (*fa_RuntimeMemoryPageLoadHook)(struct fa_Runtime* runtime,
+                                            uint32_t memory_index,
+                                            uint64_t page_index,
+                                            uint8_t* data_out,
+                                            uint32_t page_bytes,
+                                            void* user_data);
+
+typedef struct {
+    uint32_t page_bytes;      // power of two in [FA_RUNTIME_MEMORY_PAGE_BYTES_MIN, FA_WASM_PAGE_SIZE]
+    uint32_t resident_pages;  // page frames kept in RAM per memory
+    fa_RuntimeMemoryPageSpillHook page_spill;
+    fa_RuntimeMemoryPageLoadHook page_load;
+    void* user_data;
+} fa_RuntimeMemoryPaging;
+
+typedef struct {
+    uint64_t page_faults;
+    uint64_t page_loads;
+    uint64_t page_spills;
+    uint64_t tlb_hits;
+} fa_RuntimeMemoryPagingStats;
+
+/* Page frames and the TLB of a paged memory are visible here so the
+   interpreter's load/store ops can take a TLB hit inline; victim choice, the
+   spill bitmap and the page->frame index stay private to the pager. */
+typedef struct {
+    uint64_t page_index;
+    uint8_t* data;
+    bool dirty;
+    bool referenced;
+} fa_RuntimeMemoryFrame;
+
+typedef struct {
+    uint64_t page_index;
+    fa_RuntimeMemoryFrame* frame;
+} fa_RuntimeMemoryTlbEntry;
+
+typedef struct fa_RuntimeMemoryTlb {
+    uint32_t page_shift;
+    uint64_t hits;
+    fa_RuntimeMemoryTlbEntry entries[FA_RUNTIME_MEMORY_TLB_ENTRIES];
+} fa_RuntimeMemoryTlb;
+
+/* Frame bytes backing [addr, addr + size) when that range sits in one page
+   the TLB already maps, NULL otherwise (the caller then goes through
+   fa_Runtime_pagedRead/fa_Runtime_pagedWrite). The caller bounds-checks. */
+static inline uint8_t* fa_RuntimeMemoryTlb_lookup(fa_RuntimeMemoryTlb* tlb, uint64_t addr, size_t size, bool for_write) {
+    const uint64_t page_index = addr >> tlb->page_shift;
+    const uint64_t page_mask = ((uint64_t)1 << tlb->page_shift) - 1U;
+    const fa_RuntimeMemoryTlbEntry* entry = &tlb->entries[page_index & (FA_RUNTIME_MEMORY_TLB_ENTRIES - 1U)];
+    if (entry->page_index != page_index || (addr & page_mask) + size > page_mask + 1U) {
+        return NULL;
+    }
+    entry->frame->referenced = true;
+    if (for_write) {
+        entry->frame->dirty = true;
+    }
+    tlb->hits++;
+    return entry->frame->data + (size_t)(addr & page_mask);
+}
+
 typedef struct {
     const WasmFunctionType* signature;
     const fa_JobValue* args;
@@ -133,12 +221,44 @@ typedef struct fa_Runtime {
     struct fa_JitProgramCacheEntry* jit_cache;
     uint32_t jit_cache_count;
     uint64_t jit_prepared_executions;
+    uint64_t jit_fused_executions;   /* prepared ops that also ran the next op(s) through a fused handler */
     size_t jit_cache_bytes;
-    uint32_t jit_cache_eviction_cursor;
+    uint64_t jit_cache_evictions;
+    uint64_t jit_cache_reprepares;   /* programs rebuilt after their entry was evicted */
+    uint32_t jit_cache_clock_hand;   /* CLOCK / round-robin cursor */
+    uint32_t jit_cache_access_ticks; /* accesses since the last LFU aging pass */
     bool jit_cache_prescanned;
+    uint32_t jit_prescan_threads;    /* workers the last prescan ran on, 0 = the attaching thread */
+    uint64_t jit_prescan_blocks;     /* control side-table entries built by the prescan */
+    uint32_t jit_prescan_programs;   /* programs it lowered, counted against max_chunks */
+    uint64_t jit_prescan_lazy;       /* functions prescanned on their first call (prescan_lazy) */
+    uint64_t jit_prescan_prefetched; /* functions prescanned ahead of it by the callee prefetcher */
+    fa_JitNativeContext jit_native;
+    fa_JitNativeEntry* jit_native_entries; /* published entries, by function index */
+    uint64_t* jit_native_slots;
+    size_t jit_native_slot_top;
+    uint64_t jit_native_calls;
+    uint64_t jit_closure_calls;             /* entries into closure-tier records */
+    uint64_t jit_osr_entries;               /* interpreted frames moved into native code at a loop header */
+    struct fa_JitCodeCache* jit_code_cache; /* slabs holding compiled native code */
+    fa_JitNativeCode* jit_native_retired;   /* evicted while native frames were live */
+    uint32_t jit_native_retired_count;
+    uint32_t jit_native_retired_capacity;
+    uint32_t jit_native_active;             /* interpreter -> native entries in flight */
+    struct fa_JitWorkerPool* jit_workers;   /* background compilation, NULL when synchronous */
+    uint64_t jit_async_installs;            /* background results installed at a safe point */
+    const fa_JitNativeEntry* aot_entries;   /* fa_Runtime_setAotFunctions table, by function index */
+    uint32_t aot_entry_count;
+    uint64_t jit_aot_calls;                 /* entries into ahead-of-time compiled functions */
+    char* jit_persist_dir;                  /* on-disk code cache (fa_Runtime_setJitCacheDir), NULL = off */
+    uint64_t jit_persist_hits;              /* functions installed from the on-disk code cache */
+    uint64_t jit_persist_stores;            /* compiled functions written to it */
+    uint64_t jit_shared_hits;               /* functions installed from code another instance compiled */
     struct fa_RuntimeHostBinding* host_bindings;
     uint32_t host_binding_count;
     uint32_t host_binding_capacity;
+    uint32_t* host_import_slots;            /* per imported function: host_bindings index + 1, 0 = unbound */
+    uint32_t host_import_slot_count;
     struct fa_RuntimeHostMemoryBinding* host_memory_bindings;
     uint32_t host_memory_binding_count;
     uint32_t host_memory_binding_capacity;
@@ -149,14 +269,101 @@ typedef struct fa_Runtime {
     uint32_t function_trap_count;
     fa_RuntimeTrapHooks trap_hooks;
     fa_RuntimeSpillHooks spill_hooks;
+    fa_RuntimeMemoryPaging memory_paging;
+    const struct fa_RuntimeMemoryImage* memory_image;
+    struct fa_CompiledModule* compiled;     /* shared code borrowed by this instance, NULL for attachModule */
 } fa_Runtime;
 
 fa_Runtime* fa_Runtime_init(void);
 void fa_Runtime_free(fa_Runtime* runtime);
 
+/* Instantiates `module`: memories, tables, globals, active segments, then the
+   start function, which runs before this returns. Bind host imports
+   (fa_Runtime_bindHostFunction and friends) before attaching: a start
+   function that calls an import still unbound fails the attach with
+   FA_RUNTIME_ERR_TRAP. Bindings persist across attaches. */
 int fa_Runtime_attachModule(fa_Runtime* runtime, WasmModule* module);
 void fa_Runtime_detachModule(fa_Runtime* runtime);
 
+/* Shareable compiled module. Holds a loaded module together with everything
+   the runtime derives from it without looking at instance state: validated
+   control side tables, per-function opcode maps, the microcode programs the
+   load-time prescan lowers, and a private copy of every function body. It is
+   immutable once created and reference counted (atomically), so any number
+   of runtimes on any threads can attach it at once; each keeps only its own
+   memories, tables, globals, host bindings and counters, and programs
+   borrowed from the compiled module are not charged to its cache budget.
+
+   Tier-up code is shared too, once it exists: the first instance to compile
+   a function to native code or closure records publishes the bytes on the
+   compiled module, and the others install those instead of lowering the
+   body again (fa_Runtime.jit_shared_hits). Installing still gives each
+   instance its own executable copy in its code cache, charged to its budget;
+   instances share the work of compiling, not the mapped code.
+
+   fa_CompiledModule_create takes ownership of `module` on success (the module
+   is freed with the last reference) and leaves it with the caller on
+   failure. fd- and reader-backed modules still read passive data segments
+   through the module when memory.init runs, so load modules into memory (or
+   mmap them) before sharing them across threads. */
+typedef struct fa_CompiledModule fa_CompiledModule;
+fa_CompiledModule* fa_CompiledModule_create(WasmModule* module);
+fa_CompiledModule* fa_CompiledModule_retain(fa_CompiledModule* compiled);
+void fa_CompiledModule_release(fa_CompiledModule* compiled);
+const WasmModule* fa_CompiledModule_module(const fa_CompiledModule* compiled);
+/* Like fa_Runtime_attachModule, but borrows the compiled module's code
+   instead of scanning and lowering again. Holds a reference until detach. */
+int fa_Runtime_attachCompiled(fa_Runtime* runtime, fa_CompiledModule* compiled);
+
+/* Module bundles: a compiled module saved as one relocatable file, so a later
+   process (or a device reading it straight from flash) skips validation, the
+   prescan and control side-table construction. The file is the shared spill
+   envelope (kind FA_SPILL_KIND_MODULE_BUNDLE) followed by:
+
+     offset 0   u8[32] module_digest (SHA-256 of the module image)
+     offset 32  u32  abi            (FA_BUNDLE_ABI_VERSION)
+     offset 36  u32  function_count
+     offset 40  u32  wasm_bytes
+     offset 44  u32  record_bytes
+     offset 48  u8[32] record_digest (SHA-256 of everything after the image)
+     offset 80  ...  the module image, zero-padded to 4 bytes, then one record
+                     per function: u32 count, pc_map_len, block_count,
+                     lowered_count, flags; u32 offsets[count]; i32
+                     pc_map[pc_map_len]; block targets (3 x u32 each); the
+                     u8 opcode stream, zero-padded to 4 bytes.
+
+   All integers are little-endian, and every array starts 4-byte aligned, so
+   on little-endian hosts the opened module reads its tables from the bundle
+   bytes in place. Metadata is re-read from the embedded image and programs
+   are re-lowered from the opcode streams (both hold host pointers). Only
+   modules loaded from memory (or mmap'd) can be bundled. Opening recomputes
+   both digests, and the module digest it keys the code cache with is the
+   recomputed one. */
+#define FA_BUNDLE_ABI_VERSION 2u
+/* 0 when `compiled` cannot be bundled. */
+size_t fa_CompiledModule_bundleSize(const fa_CompiledModule* compiled);
+bool fa_CompiledModule_writeBundle(const fa_CompiledModule* compiled,
+                                   uint8_t* out,
+                                   size_t capacity,
+                                   size_t* written_out);
+/* Writes to a temporary name and renames it into place. */
+int fa_CompiledModule_saveBundle(const fa_CompiledModule* compiled, const char* path);
+/* Opens a bundle in place: `bytes` (e.g. a flash partition mapping) must stay
+   valid and unchanged until the last reference is released. NULL when the
+   envelope, ABI or either digest does not match, or when a record leaves a
+   defined function unscanned or disagrees with its body (opcode pcs, pc map,
+   block targets). */
+fa_CompiledModule* fa_CompiledModule_openBundle(const uint8_t* bytes, size_t size);
+/* mmaps `path` (reads it where mmap is unavailable) and opens it; the mapping
+   lives as long as the compiled module. */
+fa_CompiledModule* fa_CompiledModule_loadBundle(const char* path);
+
+/* An instance is a runtime attached to a compiled module; every fa_Runtime_*
+   call applies to it. */
+typedef fa_Runtime fa_Instance;
+fa_Instance* fa_Instance_create(fa_CompiledModule* compiled);
+void fa_Instance_free(fa_Instance* instance);
+
 fa_Job* fa_Runtime_createJob(fa_Runtime* runtime);
 int fa_Runtime_destroyJob(fa_Runtime* runtime, fa_Job* job);
 
@@ -207,10 +414,87 @@ void fa_Runtime_clearFunctionTraps(fa_Runtime* runtime);
 void fa_Runtime_setSpillHooks(fa_Runtime* runtime, const fa_RuntimeSpillHooks* hooks);
 int fa_Runtime_jitSpillProgram(fa_Runtime* runtime, uint32_t function_index);
 int fa_Runtime_jitLoadProgram(fa_Runtime* runtime, uint32_t function_index);
+/* True once `function_index` runs as native code (FA_JIT_TIER_NATIVE). */
+bool fa_Runtime_jitIsNative(const fa_Runtime* runtime, uint32_t function_index);
+/* True while `function_index` has closure-tier records (FA_JIT_TIER_CLOSURE). */
+bool fa_Runtime_jitIsClosure(const fa_Runtime* runtime, uint32_t function_index);
+/* Registers ahead-of-time compiled functions (fayasm_aot output, see fa_aot.h)
+   for the attached module; `count` must equal its function count. Non-NULL
+   entries run instead of any JIT tier whenever memory 0 is flat, the same
+   condition the native tier has. Function traps are checked when the runtime
+   enters a compiled function, not on direct calls between compiled functions.
+   The table is borrowed and must outlive the attachment; NULL clears it, and
+   so does detaching the module. */
+int fa_Runtime_setAotFunctions(fa_Runtime* runtime, const fa_JitNativeEntry* entries, uint32_t count);
+/* Persists native code and closure records under `dir` (which must exist,
+   belong to the current user and not be group- or world-writable), keyed
+   by the module's SHA-256 digest and the runtime ABI, and reuses them before
+   compiling a function, so warm starts skip lowering and code generation. The path is copied; NULL turns the cache off. Defaults to
+   FAYASM_JIT_CACHE_DIR. */
+int fa_Runtime_setJitCacheDir(fa_Runtime* runtime, const char* dir);
+/* Waits for background JIT compilations (fa_JitConfig.worker_threads) and
+   installs their results; a no-op when compiling synchronously. */
+void fa_Runtime_jitFlush(fa_Runtime* runtime);
 int fa_Runtime_spillMemory(fa_Runtime* runtime, uint32_t memory_index);
 int fa_Runtime_loadMemory(fa_Runtime* runtime, uint32_t memory_index);
 int fa_Runtime_ensureMemoryLoaded(fa_Runtime* runtime, uint32_t memory_index);
 
+/* Grows a runtime-owned memory by `delta_pages` Wasm pages. Limit or allocation
+   failures leave `*grew_out` false (memory.grow returns -1); hard faults return
+   an error code. */
+int fa_Runtime_growMemory(fa_Runtime* runtime,
+                          uint32_t memory_index,
+                          uint64_t delta_pages,
+                          uint64_t* prev_pages_out,
+                          bool* grew_out);
+
+/* Shared pre-initialized memory image. Built once per module with the active
+   data segments already applied; every runtime that attaches the same module
+   with the image set starts from it instead of zero-filling and re-copying
+   segments. On Linux the image lives in a memfd and instances map it
+   MAP_PRIVATE (copy-on-write, clean pages shared across instances); elsewhere
+   each instance copies the image. The image must outlive the attached
+   runtimes that reference it. */
+typedef struct fa_RuntimeMemoryImage fa_RuntimeMemoryImage;
+fa_RuntimeMemoryImage* fa_RuntimeMemoryImage_create(const WasmModule* module);
+void fa_RuntimeMemoryImage_free(fa_RuntimeMemoryImage* image);
+bool fa_RuntimeMemoryImage_isShared(const fa_RuntimeMemoryImage* image);
+/* Applies to the next fa_Runtime_attachModule of the image's module; NULL clears. */
+void fa_Runtime_setMemoryImage(fa_Runtime* runtime, const fa_RuntimeMemoryImage* image);
+
+/* Paging applies to memories created by the next fa_Runtime_attachModule; pass
+   NULL to go back to flat memories. Host-imported memories are never paged. */
+int fa_Runtime_setMemoryPaging(fa_Runtime* runtime, const fa_RuntimeMemoryPaging* paging);
+int fa_Runtime_getMemoryPagingStats(const fa_Runtime* runtime,
+                                    uint32_t memory_index,
+                                    fa_RuntimeMemoryPagingStats* stats_out);
+
+/* Bounds-checked linear-memory accessors that work for both flat and paged
+   memories. Out-of-range accesses return FA_RUNTIME_ERR_TRAP. */
+int fa_Runtime_readMemory(fa_Runtime* runtime, uint32_t memory_index, uint64_t offset, void* out, size_t size);
+int fa_Runtime_writeMemory(fa_Runtime* runtime, uint32_t memory_index, uint64_t offset, const void* data, size_t size);
+int fa_Runtime_fillMemory(fa_Runtime* runtime, uint32_t memory_index, uint64_t offset, uint8_t value, size_t size);
+int fa_Runtime_copyMemory(fa_Runtime* runtime,
+                          uint32_t dst_index,
+                          uint64_t dst_offset,
+                          uint32_t src_index,
+                          uint64_t src_offset,
+                          size_t size);
+/* Paged-memory accessors for callers that already resolved `memory` (one of
+   the runtime's paged memories) and bounds-checked the range: no index lookup,
+   no second range check. */
+int fa_Runtime_pagedRead(fa_Runtime* runtime, const fa_RuntimeMemory* memory, uint64_t offset, void* out, size_t size);
+int fa_Runtime_pagedWrite(fa_Runtime* runtime, fa_RuntimeMemory* memory, uint64_t offset, const void* data, size_t size);
+/* memory.init semantics against the attached module's data segment
+   `data_index`: borrowed segment bytes are copied directly, fd-backed ones are
+   streamed from the module file. Either range out of bounds traps. */
+int fa_Runtime_initMemory(fa_Runtime* runtime,
+                          uint32_t memory_index,
+                          uint64_t offset,
+                          uint32_t data_index,
+                          uint64_t src_offset,
+                          size_t size);
+
 /* Versioned spill serialization for linear memory. The blob is the shared spill
    envelope (kind FA_SPILL_KIND_MEMORY) followed by a fixed memory sub-header
    (flags + size) and the raw bytes, so a loaded blob restores the post-grow
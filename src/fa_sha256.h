@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------- *
+ * SHA-256 (FIPS 180-4).
+ *
+ * Identifies module images wherever a match lets the runtime adopt code it
+ * did not compile itself (the persisted code cache, module bundles): unlike
+ * the FNV hashes used for tables and damage checks, two different modules
+ * cannot be made to share a digest.
+ * ------------------------------------------------------------------------- */
+#define FA_SHA256_BYTES 32u
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;
+    uint8_t block[64];
+    uint32_t used;
+} fa_Sha256;
+
+void fa_sha256_init(fa_Sha256* ctx);
+void fa_sha256_update(fa_Sha256* ctx, const uint8_t* data, size_t size);
+void fa_sha256_final(fa_Sha256* ctx, uint8_t digest[FA_SHA256_BYTES]);
+/* One-shot digest of `size` bytes. */
+void fa_sha256(const uint8_t* data, size_t size, uint8_t digest[FA_SHA256_BYTES]);
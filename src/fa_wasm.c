@@ -1,3 +1,7 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include "fa_wasm.h"
 
 #include <stdio.h>
@@ -10,6 +14,12 @@
 #include <unistd.h>
 #include <sys/stat.h>
 
+#if (defined(__APPLE__) || defined(__unix__) || defined(__linux__)) && \
+    !defined(FAYASM_TARGET_ESP32) && !defined(ESP_PLATFORM)
+#include <sys/mman.h>
+#define FA_WASM_HAS_MMAP 1
+#endif
+
 static char* wasm_strdup(const char* value) {
     if (!value) {
         return NULL;
@@ -24,18 +34,266 @@ static char* wasm_strdup(const char* value) {
     return copy;
 }
 
+#define WASM_NAME_HASH_SEED  0x811C9DC5U
+#define WASM_NAME_HASH_PRIME 0x01000193U
+
+static uint32_t wasm_name_hash(uint32_t hash, const char* name, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) {
+        hash ^= (uint8_t)name[i];
+        hash *= WASM_NAME_HASH_PRIME;
+    }
+    /* Mixing the length in keeps ("ab", "c") and ("a", "bc") apart. */
+    hash ^= len;
+    hash *= WASM_NAME_HASH_PRIME;
+    return hash;
+}
+
+static bool wasm_name_equals(const char* a, uint32_t a_len, const char* b, uint32_t b_len) {
+    return a_len == b_len && (a_len == 0 || memcmp(a, b, a_len) == 0);
+}
+
+/* ------------------------------------------------------------------------- *
+ * Metadata arena (WasmArena).
+ *
+ * Allocations are zeroed and 8-byte aligned. An interned name is stored as a
+ * WasmArenaName header followed by its NUL-terminated bytes; the set of names
+ * lives in the arena too and is reallocated there when it fills up.
+ * ------------------------------------------------------------------------- */
+#define WASM_ARENA_ALIGN       8U
+#define WASM_ARENA_MIN_NAMES   16U
+
+typedef struct {
+    uint32_t hash;
+    uint32_t len;
+} WasmArenaName;
+
+static uint8_t* wasm_arena_block_data(WasmArenaBlock* block) {
+    return (uint8_t*)(block + 1);
+}
+
+static WasmArenaBlock* wasm_arena_block_new(size_t capacity) {
+    WasmArenaBlock* block = (WasmArenaBlock*)calloc(1, sizeof(WasmArenaBlock) + capacity);
+    if (block) {
+        block->capacity = capacity;
+    }
+    return block;
+}
+
+static void* wasm_arena_alloc(WasmArena* arena, size_t size) {
+    if (size > SIZE_MAX - sizeof(WasmArenaBlock) - WASM_ARENA_ALIGN) {
+        return NULL;
+    }
+    size = size == 0 ? WASM_ARENA_ALIGN : (size + WASM_ARENA_ALIGN - 1U) & ~(size_t)(WASM_ARENA_ALIGN - 1U);
+    WasmArenaBlock* head = arena->head;
+    if (!head || head->capacity - head->used < size) {
+        size_t capacity = arena->next_block_bytes ? arena->next_block_bytes : WASM_ARENA_BLOCK_BYTES;
+        if (size > capacity) {
+            /* Oversized: a block of its own, linked behind the head so the
+               head keeps serving small requests. */
+            WasmArenaBlock* block = wasm_arena_block_new(size);
+            if (!block) {
+                return NULL;
+            }
+            block->used = size;
+            if (head) {
+                block->next = head->next;
+                head->next = block;
+            } else {
+                arena->head = block;
+            }
+            arena->num_blocks++;
+            arena->bytes += size;
+            return wasm_arena_block_data(block);
+        }
+        head = wasm_arena_block_new(capacity);
+        if (!head) {
+            return NULL;
+        }
+        head->next = arena->head;
+        arena->head = head;
+        arena->num_blocks++;
+        arena->next_block_bytes = capacity < WASM_ARENA_MAX_BLOCK_BYTES / 2U ? capacity * 2U : WASM_ARENA_MAX_BLOCK_BYTES;
+    }
+    void* out = wasm_arena_block_data(head) + head->used;
+    head->used += size;
+    arena->bytes += size;
+    return out;
+}
+
+static void* wasm_arena_calloc(WasmArena* arena, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    return wasm_arena_alloc(arena, count * size);
+}
+
+static void wasm_arena_free(WasmArena* arena) {
+    WasmArenaBlock* block = arena->head;
+    while (block) {
+        WasmArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    memset(arena, 0, sizeof(*arena));
+}
+
+static const WasmArenaName* wasm_arena_name_header(const char* name) {
+    return (const WasmArenaName*)(const void*)name - 1;
+}
+
+/* Returns the interned copy of `name` (which already sits in the arena, as
+   the most recent allocation of `name_bytes`), giving those bytes back when
+   the name was seen before. */
+static const char* wasm_arena_intern_tail(WasmArena* arena, char* name, size_t name_bytes) {
+    WasmArenaName* header = (WasmArenaName*)(void*)name - 1;
+    uint32_t mask = arena->names_mask;
+    uint32_t slot = header->hash & mask;
+    while (arena->names && arena->names[slot]) {
+        const char* other = arena->names[slot];
+        const WasmArenaName* other_header = wasm_arena_name_header(other);
+        if (other_header->hash == header->hash &&
+            wasm_name_equals(other, other_header->len, name, header->len)) {
+            WasmArenaBlock* head = arena->head;
+            const size_t size = (name_bytes + WASM_ARENA_ALIGN - 1U) & ~(size_t)(WASM_ARENA_ALIGN - 1U);
+            if (head && (uint8_t*)header + size == wasm_arena_block_data(head) + head->used) {
+                memset(header, 0, size);
+                head->used -= size;
+                arena->bytes -= size;
+            }
+            return other;
+        }
+        slot = (slot + 1U) & mask;
+    }
+    if (!arena->names || (arena->num_names + 1U) * 2U > mask + 1U) {
+        const uint32_t slots = arena->names ? (mask + 1U) * 2U : WASM_ARENA_MIN_NAMES;
+        const char** names = (const char**)wasm_arena_calloc(arena, slots, sizeof(const char*));
+        if (!names) {
+            return NULL;
+        }
+        for (uint32_t i = 0; arena->names && i <= mask; ++i) {
+            const char* held = arena->names[i];
+            if (held) {
+                uint32_t to = wasm_arena_name_header(held)->hash & (slots - 1U);
+                while (names[to]) {
+                    to = (to + 1U) & (slots - 1U);
+                }
+                names[to] = held;
+            }
+        }
+        arena->names = names;
+        arena->names_mask = slots - 1U;
+        mask = arena->names_mask;
+        slot = header->hash & mask;
+        while (names[slot]) {
+            slot = (slot + 1U) & mask;
+        }
+    }
+    arena->names[slot] = name;
+    arena->num_names++;
+    return name;
+}
+
+/* Fills `out` from the read-ahead window. A miss refills the window with one
+   block read starting at the block boundary below the cursor, so short
+   backward seeks (re-reading a section header) stay inside it. Reads of at
+   least a full window bypass it and go straight to the fd. */
+static ssize_t wasm_stream_read_fd(WasmModule* module, uint8_t* out, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        const off_t window_end = module->read_ahead_start + (off_t)module->read_ahead_len;
+        if (module->read_ahead && module->cursor >= module->read_ahead_start && module->cursor < window_end) {
+            size_t chunk = (size_t)(window_end - module->cursor);
+            if (chunk > size - total) {
+                chunk = size - total;
+            }
+            memcpy(out + total, module->read_ahead + (module->cursor - module->read_ahead_start), chunk);
+            module->cursor += (off_t)chunk;
+            total += chunk;
+            continue;
+        }
+        if (module->cursor >= module->stream_size) {
+            break;
+        }
+        if (!module->read_ahead && module->read_ahead_capacity > 0) {
+            module->read_ahead = (uint8_t*)malloc(module->read_ahead_capacity);
+        }
+        if (!module->read_ahead || size - total >= module->read_ahead_capacity) {
+            if (lseek(module->fd, module->cursor, SEEK_SET) < 0) {
+                return total > 0 ? (ssize_t)total : -1;
+            }
+            const ssize_t read_bytes = read(module->fd, out + total, size - total);
+            if (read_bytes <= 0) {
+                return total > 0 ? (ssize_t)total : read_bytes;
+            }
+            module->cursor += read_bytes;
+            total += (size_t)read_bytes;
+            continue;
+        }
+        const off_t block_start = module->cursor & ~((off_t)module->read_ahead_capacity - 1);
+        if (lseek(module->fd, block_start, SEEK_SET) < 0) {
+            return total > 0 ? (ssize_t)total : -1;
+        }
+        const ssize_t read_bytes = read(module->fd, module->read_ahead, module->read_ahead_capacity);
+        module->read_ahead_refills++;
+        if (read_bytes <= 0 || block_start + (off_t)read_bytes <= module->cursor) {
+            module->read_ahead_len = 0;
+            return total > 0 ? (ssize_t)total : (read_bytes < 0 ? -1 : 0);
+        }
+        module->read_ahead_start = block_start;
+        module->read_ahead_len = (size_t)read_bytes;
+    }
+    return (ssize_t)total;
+}
+
+/* Streamed modules: bytes of a section still held by the parser come from
+   its window, everything else from the embedder's reader. */
+static ssize_t wasm_stream_read_streamed(WasmModule* module, uint8_t* out, size_t size) {
+    size_t total = 0;
+    while (total < size && module->cursor < module->stream_size) {
+        size_t chunk = size - total;
+        if ((off_t)chunk > module->stream_size - module->cursor) {
+            chunk = (size_t)(module->stream_size - module->cursor);
+        }
+        const WasmStreamWindow* window = NULL;
+        for (uint32_t i = 0; i < module->num_windows; ++i) {
+            const WasmStreamWindow* candidate = &module->windows[i];
+            if (module->cursor >= candidate->offset &&
+                module->cursor < candidate->offset + (off_t)candidate->filled) {
+                window = candidate;
+                break;
+            }
+        }
+        size_t got = 0;
+        if (window) {
+            const size_t at = (size_t)(module->cursor - window->offset);
+            got = window->filled - at < chunk ? window->filled - at : chunk;
+            memcpy(out + total, window->data + at, got);
+        } else if (module->reader.read) {
+            got = module->reader.read(module->reader.user, (uint64_t)module->cursor, out + total, chunk);
+            if (got > chunk) {
+                got = 0;
+            }
+        }
+        if (got == 0) {
+            return total > 0 ? (ssize_t)total : -1;
+        }
+        module->cursor += (off_t)got;
+        total += got;
+    }
+    return (ssize_t)total;
+}
+
 static ssize_t wasm_stream_read(WasmModule* module, void* out, size_t size) {
     if (!module || !out || size == 0) {
         return 0;
     }
     if (module->fd >= 0) {
-        const ssize_t read_bytes = read(module->fd, out, size);
-        if (read_bytes > 0) {
-            module->cursor += read_bytes;
-        }
-        return read_bytes;
+        return wasm_stream_read_fd(module, (uint8_t*)out, size);
     }
-    if (!module->buffer || module->buffer_size == 0) {
+    if (!module->buffer) {
+        return wasm_stream_read_streamed(module, (uint8_t*)out, size);
+    }
+    if (module->buffer_size == 0) {
         return -1;
     }
     if (module->cursor < 0 || (size_t)module->cursor >= module->buffer_size) {
@@ -65,17 +323,14 @@ static bool wasm_is_supported_valtype(uint8_t valtype) {
     }
 }
 
+static off_t wasm_stream_size(const WasmModule* module);
+
 static off_t wasm_stream_seek(WasmModule* module, off_t offset, int whence) {
     if (!module) {
         return -1;
     }
-    if (module->fd >= 0) {
-        const off_t pos = lseek(module->fd, offset, whence);
-        if (pos >= 0) {
-            module->cursor = pos;
-        }
-        return pos;
-    }
+    /* Seeks only move the cursor; fd-backed reads reposition lazily on refill. */
+    const off_t size = wasm_stream_size(module);
     off_t base = 0;
     switch (whence) {
         case SEEK_SET:
@@ -85,13 +340,13 @@ static off_t wasm_stream_seek(WasmModule* module, off_t offset, int whence) {
             base = module->cursor;
             break;
         case SEEK_END:
-            base = (off_t)module->buffer_size;
+            base = size;
             break;
         default:
             return -1;
     }
     off_t pos = base + offset;
-    if (pos < 0 || (size_t)pos > module->buffer_size) {
+    if (pos < 0 || pos > size) {
         return -1;
     }
     module->cursor = pos;
@@ -102,7 +357,7 @@ static off_t wasm_stream_size(const WasmModule* module) {
     if (!module) {
         return 0;
     }
-    if (module->fd >= 0) {
+    if (module->fd >= 0 || !module->buffer) {
         return module->stream_size;
     }
     return (off_t)module->buffer_size;
@@ -323,12 +578,44 @@ char* read_string(WasmModule* module, uint32_t* len) {
     return str;
 }
 
+/* Reads a length-prefixed name into the module arena and interns it; an
+   empty name is "". NULL on a short read or allocation failure. */
+static const char* wasm_read_name(WasmModule* module, uint32_t* len) {
+    uint32_t size_read;
+    *len = read_uleb128(module, &size_read);
+    if ((off_t)*len > wasm_stream_size(module) - module->cursor) {
+        return NULL;
+    }
+    const size_t name_bytes = sizeof(WasmArenaName) + (size_t)*len + 1U;
+    WasmArenaName* header = (WasmArenaName*)wasm_arena_alloc(&module->arena, name_bytes);
+    if (!header) {
+        return NULL;
+    }
+    char* name = (char*)(header + 1);
+    if (*len > 0 && wasm_stream_read(module, name, *len) != (ssize_t)*len) {
+        return NULL;
+    }
+    header->len = *len;
+    header->hash = wasm_name_hash(WASM_NAME_HASH_SEED, name, *len);
+    return wasm_arena_intern_tail(&module->arena, name, name_bytes);
+}
+
 ///
 ///
 ///
 
-// Inizializza il modulo WASM
-WasmModule* wasm_module_init(const char* filename) {
+static size_t wasm_read_ahead_capacity(size_t requested) {
+    size_t capacity = WASM_READ_AHEAD_MIN_BYTES;
+    while (capacity < requested && capacity < WASM_READ_AHEAD_MAX_BYTES) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static WasmModule* wasm_module_open(const char* filename, bool allow_map, size_t read_ahead_bytes) {
+    if (!filename) {
+        return NULL;
+    }
     WasmModule* module = (WasmModule*)malloc(sizeof(WasmModule));
     if (!module) {
         return NULL;
@@ -353,10 +640,36 @@ WasmModule* wasm_module_init(const char* filename) {
     }
     module->cursor = 0;
     module->stream_size = st.st_size;
-    
+    module->read_ahead_capacity = wasm_read_ahead_capacity(read_ahead_bytes);
+
+#if defined(FA_WASM_HAS_MMAP)
+    /* Parse straight out of the page cache; the fd is only the fallback. */
+    if (allow_map && st.st_size > 0 && (uint64_t)st.st_size <= (uint64_t)SIZE_MAX) {
+        void* mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, module->fd, 0);
+        if (mapped != MAP_FAILED) {
+            module->buffer = (const uint8_t*)mapped;
+            module->buffer_size = (size_t)st.st_size;
+            module->buffer_mapped = true;
+            close(module->fd);
+            module->fd = -1;
+        }
+    }
+#else
+    (void)allow_map;
+#endif
+
     return module;
 }
 
+// Inizializza il modulo WASM
+WasmModule* wasm_module_init(const char* filename) {
+    return wasm_module_open(filename, true, WASM_READ_AHEAD_BYTES);
+}
+
+WasmModule* wasm_module_init_buffered(const char* filename, size_t read_ahead_bytes) {
+    return wasm_module_open(filename, false, read_ahead_bytes);
+}
+
 WasmModule* wasm_module_init_from_memory(const uint8_t* data, size_t size) {
     if (!data || size == 0) {
         return NULL;
@@ -383,7 +696,26 @@ WasmModule* wasm_module_init_from_memory(const uint8_t* data, size_t size) {
     return module;
 }
 
+WasmModule* wasm_module_init_borrowed(const uint8_t* data, size_t size) {
+    if (!data || size == 0) {
+        return NULL;
+    }
+    WasmModule* module = (WasmModule*)calloc(1, sizeof(WasmModule));
+    if (!module) {
+        return NULL;
+    }
+    module->buffer = data;
+    module->buffer_size = size;
+    module->stream_size = (off_t)size;
+    module->fd = -1;
+    module->filename = wasm_strdup("<memory>");
+    return module;
+}
+
 // Libera la memoria del modulo
+static void wasm_name_index_free(WasmNameIndex* index);
+static void wasm_free_data_copies(WasmModule* module);
+
 void wasm_module_free(WasmModule* module) {
     if (!module) {
         return;
@@ -397,82 +729,30 @@ void wasm_module_free(WasmModule* module) {
         free((void*)module->buffer);
         module->buffer = NULL;
     }
-    
-    if (module->filename) {
-        free(module->filename);
-    }
-    
-    if (module->sections) {
-        for (uint32_t i = 0; i < module->num_sections; i++) {
-            if (module->sections[i].name) {
-                free(module->sections[i].name);
-            }
-        }
-        free(module->sections);
-    }
-    
-    if (module->types) {
-        for (uint32_t i = 0; i < module->num_types; i++) {
-            if (module->types[i].param_types) {
-                free(module->types[i].param_types);
-            }
-            if (module->types[i].result_types) {
-                free(module->types[i].result_types);
-            }
-        }
-        free(module->types);
+#if defined(FA_WASM_HAS_MMAP)
+    if (module->buffer_mapped && module->buffer) {
+        munmap((void*)module->buffer, module->buffer_size);
+        module->buffer = NULL;
     }
-    
-    if (module->functions) {
-        for (uint32_t i = 0; i < module->num_functions; i++) {
-            free(module->functions[i].import_module);
-            free(module->functions[i].import_name);
-        }
-        free(module->functions);
+#endif
+    free(module->read_ahead);
+    for (uint32_t i = 0; i < module->num_windows; ++i) {
+        free(module->windows[i].data);
     }
+    free(module->windows);
     
-    if (module->exports) {
-        for (uint32_t i = 0; i < module->num_exports; i++) {
-            if (module->exports[i].name) {
-                free(module->exports[i].name);
-            }
-        }
-        free(module->exports);
-    }
-
-    if (module->tables) {
-        for (uint32_t i = 0; i < module->num_tables; i++) {
-            free(module->tables[i].import_module);
-            free(module->tables[i].import_name);
-        }
-        free(module->tables);
-    }
-
-    if (module->elements) {
-        for (uint32_t i = 0; i < module->num_elements; i++) {
-            free(module->elements[i].elements);
-        }
-        free(module->elements);
-    }
-
-    if (module->data_segments) {
-        for (uint32_t i = 0; i < module->num_data_segments; i++) {
-            free(module->data_segments[i].data);
-        }
-        free(module->data_segments);
+    if (module->filename) {
+        free(module->filename);
     }
     
-    if (module->memories) {
-        for (uint32_t i = 0; i < module->num_memories; i++) {
-            free(module->memories[i].import_module);
-            free(module->memories[i].import_name);
-        }
-        free(module->memories);
-    }
-
-    if (module->globals) {
-        free(module->globals);
-    }
+    /* Everything the loaders parsed lives in the arena, except passive data
+       copies. */
+    wasm_free_data_copies(module);
+    free(module->sections);
+    wasm_name_index_free(&module->export_index);
+    free(module->imports);
+    wasm_name_index_free(&module->import_index);
+    wasm_arena_free(&module->arena);
     
     free(module);
 }
@@ -572,7 +852,7 @@ int wasm_scan_sections(WasmModule* module) {
         
         // Se è una sezione custom, leggi il nome
         if (section_id == SECTION_CUSTOM) {
-            module->sections[i].name = read_string(module, &module->sections[i].name_len);
+            module->sections[i].name = wasm_read_name(module, &module->sections[i].name_len);
         }
         if (wasm_stream_seek(module, module->sections[i].offset + module->sections[i].size, SEEK_SET) < 0) {
             break;
@@ -585,6 +865,49 @@ int wasm_scan_sections(WasmModule* module) {
 }
 
 // Carica i tipi di funzione dalla sezione Type
+static uint32_t wasm_type_hash(const WasmFunctionType* type) {
+    uint32_t hash = wasm_name_hash(WASM_NAME_HASH_SEED, (const char*)type->param_types, type->num_params);
+    return wasm_name_hash(hash, (const char*)type->result_types, type->num_results);
+}
+
+static bool wasm_type_equals(const WasmFunctionType* a, const WasmFunctionType* b) {
+    return wasm_name_equals((const char*)a->param_types, a->num_params, (const char*)b->param_types, b->num_params) &&
+           wasm_name_equals((const char*)a->result_types, a->num_results, (const char*)b->result_types,
+                            b->num_results);
+}
+
+/* Points every type at the first one with the same signature, so
+   call_indirect compares one index instead of two valtype arrays. */
+static int wasm_canonicalize_types(WasmModule* module) {
+    uint32_t slots_count = 8U;
+    while (slots_count < module->num_types * 2U) {
+        slots_count <<= 1;
+    }
+    uint32_t* slots = (uint32_t*)calloc(slots_count, sizeof(uint32_t));
+    if (!slots) {
+        return -1;
+    }
+    const uint32_t mask = slots_count - 1U;
+    for (uint32_t i = 0; i < module->num_types; ++i) {
+        WasmFunctionType* type = &module->types[i];
+        uint32_t slot = wasm_type_hash(type) & mask;
+        type->canonical_index = i;
+        while (slots[slot] != 0) {
+            const WasmFunctionType* seen = &module->types[slots[slot] - 1U];
+            if (wasm_type_equals(seen, type)) {
+                type->canonical_index = seen->canonical_index;
+                break;
+            }
+            slot = (slot + 1U) & mask;
+        }
+        if (slots[slot] == 0) {
+            slots[slot] = i + 1U;
+        }
+    }
+    free(slots);
+    return 0;
+}
+
 int wasm_load_types(WasmModule* module) {
     for (uint32_t i = 0; i < module->num_sections; i++) {
         if (module->sections[i].type == SECTION_TYPE) {
@@ -596,11 +919,10 @@ int wasm_load_types(WasmModule* module) {
             uint32_t count = read_uleb128(module, &size_read);
             
             module->num_types = count;
-            module->types = (WasmFunctionType*)malloc(count * sizeof(WasmFunctionType));
+            module->types = (WasmFunctionType*)wasm_arena_calloc(&module->arena, count, sizeof(WasmFunctionType));
             if (!module->types) {
                 return -1;
             }
-            memset(module->types, 0, count * sizeof(WasmFunctionType));
             
             module->types_offset = module->sections[i].offset + size_read;
             
@@ -610,48 +932,271 @@ int wasm_load_types(WasmModule* module) {
                     return -1;  // Attualmente, solo il form 0x60 (func) è supportato
                 }
                 
-                // Leggi i tipi dei parametri
-                module->types[j].num_params = read_uleb128(module, &size_read);
-                if (module->types[j].num_params > 0) {
-                    module->types[j].param_types = (uint32_t*)malloc(module->types[j].num_params * sizeof(uint32_t));
-                    if (!module->types[j].param_types) {
+                // Leggi i tipi dei parametri (un byte per valtype)
+                WasmFunctionType* type = &module->types[j];
+                type->num_params = read_uleb128(module, &size_read);
+                if (type->num_params > 0) {
+                    type->param_types = (uint8_t*)wasm_arena_alloc(&module->arena, type->num_params);
+                    if (!type->param_types ||
+                        wasm_stream_read(module, type->param_types, type->num_params) != (ssize_t)type->num_params) {
                         return -1;
                     }
-                    
-                    for (uint32_t k = 0; k < module->types[j].num_params; k++) {
-                        uint8_t param_type;
-                        if (wasm_stream_read(module, &param_type, 1) != 1) {
-                            return -1;
-                        }
-                        module->types[j].param_types[k] = param_type;
-                    }
                 }
                 
                 // Leggi i tipi dei risultati
-                module->types[j].num_results = read_uleb128(module, &size_read);
-                if (module->types[j].num_results > 0) {
-                    module->types[j].result_types = (uint32_t*)malloc(module->types[j].num_results * sizeof(uint32_t));
-                    if (!module->types[j].result_types) {
+                type->num_results = read_uleb128(module, &size_read);
+                if (type->num_results > 0) {
+                    type->result_types = (uint8_t*)wasm_arena_alloc(&module->arena, type->num_results);
+                    if (!type->result_types ||
+                        wasm_stream_read(module, type->result_types, type->num_results) != (ssize_t)type->num_results) {
                         return -1;
                     }
-                    
-                    for (uint32_t k = 0; k < module->types[j].num_results; k++) {
-                        uint8_t result_type;
-                        if (wasm_stream_read(module, &result_type, 1) != 1) {
-                            return -1;
-                        }
-                        module->types[j].result_types[k] = result_type;
-                    }
                 }
             }
             
-            return 0;
+            return wasm_canonicalize_types(module);
         }
     }
     
     return -1;  // Sezione Type non trovata
 }
 
+/* ------------------------------------------------------------------------- *
+ * Export and import name indices.
+ *
+ * Built once at parse time so export lookups and host import binding cost one
+ * hash probe instead of a strcmp walk. Names are hashed with FNV-1a over their
+ * bytes and length (an import key hashes module then name); collisions probe
+ * linearly, and the tables stay at most half full.
+ * ------------------------------------------------------------------------- */
+#define WASM_NAME_INDEX_MIN_SLOTS 8U
+
+static void wasm_name_index_free(WasmNameIndex* index) {
+    free(index->slots);
+    index->slots = NULL;
+    index->mask = 0;
+}
+
+static int wasm_name_index_alloc(WasmNameIndex* index, uint32_t count) {
+    wasm_name_index_free(index);
+    if (count == 0) {
+        return 0;
+    }
+    if (count > (UINT32_MAX >> 2)) {
+        return -1;
+    }
+    uint32_t slots = WASM_NAME_INDEX_MIN_SLOTS;
+    while (slots < count * 2U) {
+        slots <<= 1;
+    }
+    index->slots = (uint32_t*)calloc(slots, sizeof(uint32_t));
+    if (!index->slots) {
+        return -1;
+    }
+    index->mask = slots - 1U;
+    return 0;
+}
+
+/* Export names are unique in a valid module; should a malformed one repeat a
+   (name, kind) pair, the first export keeps it. */
+static int wasm_index_exports(WasmModule* module) {
+    if (wasm_name_index_alloc(&module->export_index, module->num_exports) != 0) {
+        return -1;
+    }
+    const WasmNameIndex* index = &module->export_index;
+    for (uint32_t i = 0; i < module->num_exports; ++i) {
+        const WasmExport* export_desc = &module->exports[i];
+        uint32_t slot = wasm_name_hash(WASM_NAME_HASH_SEED, export_desc->name, export_desc->name_len) & index->mask;
+        for (;;) {
+            const uint32_t held = index->slots[slot];
+            if (held == 0) {
+                index->slots[slot] = i + 1U;
+                break;
+            }
+            const WasmExport* other = &module->exports[held - 1U];
+            if (other->kind == export_desc->kind &&
+                wasm_name_equals(other->name, other->name_len, export_desc->name, export_desc->name_len)) {
+                break;
+            }
+            slot = (slot + 1U) & index->mask;
+        }
+    }
+    return 0;
+}
+
+static void wasm_import_names(const WasmModule* module,
+                              const WasmImport* import,
+                              const char** module_name,
+                              uint32_t* module_len,
+                              const char** name,
+                              uint32_t* name_len) {
+    switch (import->kind) {
+        case WASM_EXTERNAL_FUNCTION:
+            *module_name = module->functions[import->index].import_module;
+            *module_len = module->functions[import->index].import_module_len;
+            *name = module->functions[import->index].import_name;
+            *name_len = module->functions[import->index].import_name_len;
+            break;
+        case WASM_EXTERNAL_TABLE:
+            *module_name = module->tables[import->index].import_module;
+            *module_len = module->tables[import->index].import_module_len;
+            *name = module->tables[import->index].import_name;
+            *name_len = module->tables[import->index].import_name_len;
+            break;
+        default:
+            *module_name = module->memories[import->index].import_module;
+            *module_len = module->memories[import->index].import_module_len;
+            *name = module->memories[import->index].import_name;
+            *name_len = module->memories[import->index].import_name_len;
+            break;
+    }
+}
+
+static uint32_t wasm_import_key_hash(const char* module_name, uint32_t module_len, const char* name, uint32_t name_len) {
+    return wasm_name_hash(wasm_name_hash(WASM_NAME_HASH_SEED, module_name, module_len), name, name_len);
+}
+
+static void wasm_import_push(WasmImport* imports, uint32_t* count, uint32_t kind, uint32_t index, bool is_imported) {
+    if (!is_imported) {
+        return;
+    }
+    imports[*count].kind = kind;
+    imports[*count].index = index;
+    imports[*count].next = 0;
+    (*count)++;
+}
+
+/* Rebuilt from whatever import kinds are loaded so far, so the loaders can run
+   in any order. Each slot holds the first import with its names; the rest
+   hang off `next` in function, table, memory order. */
+static int wasm_index_imports(WasmModule* module) {
+    free(module->imports);
+    module->imports = NULL;
+    module->num_imports = 0;
+    wasm_name_index_free(&module->import_index);
+    const uint64_t total = (uint64_t)module->num_imported_functions + module->num_imported_tables +
+                           module->num_imported_memories;
+    if (total == 0) {
+        return 0;
+    }
+    if (total > UINT32_MAX) {
+        return -1;
+    }
+    WasmImport* imports = (WasmImport*)calloc((size_t)total, sizeof(WasmImport));
+    if (!imports) {
+        return -1;
+    }
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < module->num_imported_functions && i < module->num_functions; ++i) {
+        wasm_import_push(imports, &count, WASM_EXTERNAL_FUNCTION, i, module->functions[i].is_imported);
+    }
+    for (uint32_t i = 0; i < module->num_imported_tables && i < module->num_tables; ++i) {
+        wasm_import_push(imports, &count, WASM_EXTERNAL_TABLE, i, module->tables[i].is_imported);
+    }
+    for (uint32_t i = 0; i < module->num_imported_memories && i < module->num_memories; ++i) {
+        wasm_import_push(imports, &count, WASM_EXTERNAL_MEMORY, i, module->memories[i].is_imported);
+    }
+    module->imports = imports;
+    module->num_imports = count;
+    if (wasm_name_index_alloc(&module->import_index, count) != 0) {
+        return -1;
+    }
+    const WasmNameIndex* index = &module->import_index;
+    for (uint32_t i = 0; i < count; ++i) {
+        const char* module_name = NULL;
+        const char* name = NULL;
+        uint32_t module_len = 0;
+        uint32_t name_len = 0;
+        wasm_import_names(module, &imports[i], &module_name, &module_len, &name, &name_len);
+        uint32_t slot = wasm_import_key_hash(module_name, module_len, name, name_len) & index->mask;
+        for (;;) {
+            const uint32_t held = index->slots[slot];
+            if (held == 0) {
+                index->slots[slot] = i + 1U;
+                break;
+            }
+            const char* other_module = NULL;
+            const char* other_name = NULL;
+            uint32_t other_module_len = 0;
+            uint32_t other_name_len = 0;
+            wasm_import_names(module, &imports[held - 1U], &other_module, &other_module_len, &other_name, &other_name_len);
+            if (wasm_name_equals(other_module, other_module_len, module_name, module_len) &&
+                wasm_name_equals(other_name, other_name_len, name, name_len)) {
+                uint32_t tail = held - 1U;
+                while (imports[tail].next != 0) {
+                    tail = imports[tail].next - 1U;
+                }
+                imports[tail].next = i + 1U;
+                break;
+            }
+            slot = (slot + 1U) & index->mask;
+        }
+    }
+    return 0;
+}
+
+const WasmExport* wasm_module_find_export(const WasmModule* module, const char* name, uint32_t kind) {
+    if (!module || !name || !module->export_index.slots) {
+        return NULL;
+    }
+    const WasmNameIndex* index = &module->export_index;
+    const uint32_t name_len = (uint32_t)strlen(name);
+    uint32_t slot = wasm_name_hash(WASM_NAME_HASH_SEED, name, name_len) & index->mask;
+    for (uint32_t held = index->slots[slot]; held != 0; held = index->slots[slot]) {
+        const WasmExport* export_desc = &module->exports[held - 1U];
+        if (export_desc->kind == kind && wasm_name_equals(export_desc->name, export_desc->name_len, name, name_len)) {
+            return export_desc;
+        }
+        slot = (slot + 1U) & index->mask;
+    }
+    return NULL;
+}
+
+static const WasmImport* wasm_import_chain_kind(const WasmModule* module, uint32_t link, uint32_t kind) {
+    while (link != 0) {
+        const WasmImport* import = &module->imports[link - 1U];
+        if (import->kind == kind) {
+            return import;
+        }
+        link = import->next;
+    }
+    return NULL;
+}
+
+const WasmImport* wasm_module_find_import(const WasmModule* module,
+                                          const char* module_name,
+                                          const char* name,
+                                          uint32_t kind) {
+    if (!module || !module_name || !name || !module->import_index.slots) {
+        return NULL;
+    }
+    const WasmNameIndex* index = &module->import_index;
+    const uint32_t module_len = (uint32_t)strlen(module_name);
+    const uint32_t name_len = (uint32_t)strlen(name);
+    uint32_t slot = wasm_import_key_hash(module_name, module_len, name, name_len) & index->mask;
+    for (uint32_t held = index->slots[slot]; held != 0; held = index->slots[slot]) {
+        const char* other_module = NULL;
+        const char* other_name = NULL;
+        uint32_t other_module_len = 0;
+        uint32_t other_name_len = 0;
+        wasm_import_names(module, &module->imports[held - 1U], &other_module, &other_module_len, &other_name,
+                          &other_name_len);
+        if (wasm_name_equals(other_module, other_module_len, module_name, module_len) &&
+            wasm_name_equals(other_name, other_name_len, name, name_len)) {
+            return wasm_import_chain_kind(module, held, kind);
+        }
+        slot = (slot + 1U) & index->mask;
+    }
+    return NULL;
+}
+
+const WasmImport* wasm_module_next_import(const WasmModule* module, const WasmImport* import) {
+    if (!module || !import) {
+        return NULL;
+    }
+    return wasm_import_chain_kind(module, import->next, import->kind);
+}
+
 // Carica gli indici dei tipi delle funzioni dalla sezione Function
 int wasm_load_functions(WasmModule* module) {
     if (!module) {
@@ -683,25 +1228,15 @@ int wasm_load_functions(WasmModule* module) {
         for (uint32_t j = 0; j < count; j++) {
             uint32_t module_len = 0;
             uint32_t name_len = 0;
-            char* module_name = read_string(module, &module_len);
-            char* import_name = read_string(module, &name_len);
-            if (!module_name && module_len == 0) {
-                module_name = (char*)calloc(1, 1);
-            }
-            if (!import_name && name_len == 0) {
-                import_name = (char*)calloc(1, 1);
-            }
+            const char* module_name = wasm_read_name(module, &module_len);
+            const char* import_name = wasm_read_name(module, &name_len);
             if (!module_name || !import_name) {
-                free(module_name);
-                free(import_name);
                 free(imported_functions);
                 return -1;
             }
 
             uint8_t kind = 0;
             if (wasm_stream_read(module, &kind, 1) != 1) {
-                free(module_name);
-                free(import_name);
                 free(imported_functions);
                 return -1;
             }
@@ -718,16 +1253,12 @@ int wasm_load_functions(WasmModule* module) {
                     func->import_module_len = module_len;
                     func->import_name = import_name;
                     func->import_name_len = name_len;
-                    module_name = NULL;
-                    import_name = NULL;
                     break;
                 }
                 case 1: /* table */
                 {
                     uint8_t elem_type = 0;
                     if (wasm_stream_read(module, &elem_type, 1) != 1) {
-                        free(module_name);
-                        free(import_name);
                         free(imported_functions);
                         return -1;
                     }
@@ -761,21 +1292,15 @@ int wasm_load_functions(WasmModule* module) {
                     uint8_t mutability = 0;
                     if (wasm_stream_read(module, &valtype, 1) != 1 ||
                         wasm_stream_read(module, &mutability, 1) != 1) {
-                        free(module_name);
-                        free(import_name);
                         free(imported_functions);
                         return -1;
                     }
                     break;
                 }
                 default:
-                    free(module_name);
-                    free(import_name);
                     free(imported_functions);
                     return -1;
             }
-            free(module_name);
-            free(import_name);
         }
         break;
     }
@@ -797,7 +1322,7 @@ int wasm_load_functions(WasmModule* module) {
 
             const uint32_t total_functions = imported_count + defined_count;
             if (total_functions > 0) {
-                module->functions = (WasmFunction*)calloc(total_functions, sizeof(WasmFunction));
+                module->functions = (WasmFunction*)wasm_arena_calloc(&module->arena, total_functions, sizeof(WasmFunction));
                 if (!module->functions) {
                     free(imported_functions);
                     return -1;
@@ -851,13 +1376,19 @@ int wasm_load_functions(WasmModule* module) {
                 }
             }
 
-            return 0;
+            return wasm_index_imports(module) == 0 ? wasm_load_start(module) : -1;
         }
     }
 
     if (!found_function_section) {
         if (imported_count > 0) {
-            module->functions = imported_functions;
+            module->functions = (WasmFunction*)wasm_arena_calloc(&module->arena, imported_count, sizeof(WasmFunction));
+            if (!module->functions) {
+                free(imported_functions);
+                return -1;
+            }
+            memcpy(module->functions, imported_functions, imported_count * sizeof(WasmFunction));
+            free(imported_functions);
             module->num_functions = imported_count;
             module->num_imported_functions = imported_count;
         } else {
@@ -866,14 +1397,42 @@ int wasm_load_functions(WasmModule* module) {
             module->num_imported_functions = 0;
         }
         module->functions_offset = 0;
-        return 0;
+        return wasm_index_imports(module) == 0 ? wasm_load_start(module) : -1;
     }
 
     free(imported_functions);
     return -1;  // Sezione Function non trovata
 }
 
-// Carica gli export dalla sezione Export
+int wasm_load_start(WasmModule* module) {
+    module->has_start = false;
+    module->start_function = 0;
+    for (uint32_t i = 0; i < module->num_sections; i++) {
+        if (module->sections[i].type != SECTION_START) {
+            continue;
+        }
+        if (wasm_stream_seek(module, module->sections[i].offset, SEEK_SET) < 0) {
+            return -1;
+        }
+        uint32_t size_read;
+        const uint32_t function_index = read_uleb128(module, &size_read);
+        if (size_read == 0 || size_read != module->sections[i].size || function_index >= module->num_functions) {
+            return -1;
+        }
+        /* The start function takes and returns nothing. */
+        const uint32_t type_index = module->functions[function_index].type_index;
+        if (module->types && (type_index >= module->num_types || module->types[type_index].num_params != 0 ||
+                              module->types[type_index].num_results != 0)) {
+            return -1;
+        }
+        module->has_start = true;
+        module->start_function = function_index;
+        return 0;
+    }
+    return 0;
+}
+
+// Carica gli export dalla sezione Export
 int wasm_load_exports(WasmModule* module) {
     for (uint32_t i = 0; i < module->num_sections; i++) {
         if (module->sections[i].type == SECTION_EXPORT) {
@@ -885,16 +1444,18 @@ int wasm_load_exports(WasmModule* module) {
             uint32_t count = read_uleb128(module, &size_read);
             
             module->num_exports = count;
-            module->exports = (WasmExport*)malloc(count * sizeof(WasmExport));
+            module->exports = (WasmExport*)wasm_arena_calloc(&module->arena, count, sizeof(WasmExport));
             if (!module->exports) {
                 return -1;
             }
-            memset(module->exports, 0, count * sizeof(WasmExport));
             
             module->exports_offset = module->sections[i].offset + size_read;
             
             for (uint32_t j = 0; j < count; j++) {
-                module->exports[j].name = read_string(module, &module->exports[j].name_len);
+                module->exports[j].name = wasm_read_name(module, &module->exports[j].name_len);
+                if (!module->exports[j].name) {
+                    return -1;
+                }
                 
                 if (wasm_stream_read(module, &module->exports[j].kind, 1) != 1) {
                     return -1;
@@ -903,7 +1464,7 @@ int wasm_load_exports(WasmModule* module) {
                 module->exports[j].index = read_uleb128(module, &size_read);
             }
             
-            return 0;
+            return wasm_index_exports(module);
         }
     }
     
@@ -941,25 +1502,15 @@ int wasm_load_tables(WasmModule* module) {
         for (uint32_t j = 0; j < count; j++) {
             uint32_t module_len = 0;
             uint32_t name_len = 0;
-            char* module_name = read_string(module, &module_len);
-            char* import_name = read_string(module, &name_len);
-            if (!module_name && module_len == 0) {
-                module_name = (char*)calloc(1, 1);
-            }
-            if (!import_name && name_len == 0) {
-                import_name = (char*)calloc(1, 1);
-            }
+            const char* module_name = wasm_read_name(module, &module_len);
+            const char* import_name = wasm_read_name(module, &name_len);
             if (!module_name || !import_name) {
-                free(module_name);
-                free(import_name);
                 free(imported_tables);
                 return -1;
             }
 
             uint8_t kind = 0;
             if (wasm_stream_read(module, &kind, 1) != 1) {
-                free(module_name);
-                free(import_name);
                 free(imported_tables);
                 return -1;
             }
@@ -971,14 +1522,10 @@ int wasm_load_tables(WasmModule* module) {
                 {
                     uint8_t elem_type = 0;
                     if (wasm_stream_read(module, &elem_type, 1) != 1) {
-                        free(module_name);
-                        free(import_name);
                         free(imported_tables);
                         return -1;
                     }
                     if (elem_type != VALTYPE_FUNCREF && elem_type != VALTYPE_EXTERNREF) {
-                        free(module_name);
-                        free(import_name);
                         free(imported_tables);
                         return -1;
                     }
@@ -999,8 +1546,6 @@ int wasm_load_tables(WasmModule* module) {
                     table->import_module_len = module_len;
                     table->import_name = import_name;
                     table->import_name_len = name_len;
-                    module_name = NULL;
-                    import_name = NULL;
                     break;
                 }
                 case 2: /* memory */
@@ -1026,21 +1571,15 @@ int wasm_load_tables(WasmModule* module) {
                     uint8_t mutability = 0;
                     if (wasm_stream_read(module, &valtype, 1) != 1 ||
                         wasm_stream_read(module, &mutability, 1) != 1) {
-                        free(module_name);
-                        free(import_name);
                         free(imported_tables);
                         return -1;
                     }
                     break;
                 }
                 default:
-                    free(module_name);
-                    free(import_name);
                     free(imported_tables);
                     return -1;
             }
-            free(module_name);
-            free(import_name);
         }
         break;
     }
@@ -1062,7 +1601,7 @@ int wasm_load_tables(WasmModule* module) {
 
             const uint32_t total_tables = imported_count + defined_count;
             if (total_tables > 0) {
-                module->tables = (WasmTable*)calloc(total_tables, sizeof(WasmTable));
+                module->tables = (WasmTable*)wasm_arena_calloc(&module->arena, total_tables, sizeof(WasmTable));
                 if (!module->tables) {
                     free(imported_tables);
                     return -1;
@@ -1097,13 +1636,19 @@ int wasm_load_tables(WasmModule* module) {
                 }
             }
 
-            return 0;
+            return wasm_index_imports(module);
         }
     }
 
     if (!found_table_section) {
         if (imported_count > 0) {
-            module->tables = imported_tables;
+            module->tables = (WasmTable*)wasm_arena_calloc(&module->arena, imported_count, sizeof(WasmTable));
+            if (!module->tables) {
+                free(imported_tables);
+                return -1;
+            }
+            memcpy(module->tables, imported_tables, imported_count * sizeof(WasmTable));
+            free(imported_tables);
             module->num_tables = imported_count;
             module->num_imported_tables = imported_count;
         } else {
@@ -1112,7 +1657,7 @@ int wasm_load_tables(WasmModule* module) {
             module->num_imported_tables = 0;
         }
         module->tables_offset = 0;
-        return 0;
+        return wasm_index_imports(module);
     }
 
     free(imported_tables);
@@ -1150,25 +1695,15 @@ int wasm_load_memories(WasmModule* module) {
         for (uint32_t j = 0; j < count; j++) {
             uint32_t module_len = 0;
             uint32_t name_len = 0;
-            char* module_name = read_string(module, &module_len);
-            char* import_name = read_string(module, &name_len);
-            if (!module_name && module_len == 0) {
-                module_name = (char*)calloc(1, 1);
-            }
-            if (!import_name && name_len == 0) {
-                import_name = (char*)calloc(1, 1);
-            }
+            const char* module_name = wasm_read_name(module, &module_len);
+            const char* import_name = wasm_read_name(module, &name_len);
             if (!module_name || !import_name) {
-                free(module_name);
-                free(import_name);
                 free(imported_memories);
                 return -1;
             }
 
             uint8_t kind = 0;
             if (wasm_stream_read(module, &kind, 1) != 1) {
-                free(module_name);
-                free(import_name);
                 free(imported_memories);
                 return -1;
             }
@@ -1180,8 +1715,6 @@ int wasm_load_memories(WasmModule* module) {
                 {
                     uint8_t elem_type = 0;
                     if (wasm_stream_read(module, &elem_type, 1) != 1) {
-                        free(module_name);
-                        free(import_name);
                         free(imported_memories);
                         return -1;
                     }
@@ -1219,8 +1752,6 @@ int wasm_load_memories(WasmModule* module) {
                     memory->import_module_len = module_len;
                     memory->import_name = import_name;
                     memory->import_name_len = name_len;
-                    module_name = NULL;
-                    import_name = NULL;
                     break;
                 }
                 case 3: /* global */
@@ -1229,21 +1760,15 @@ int wasm_load_memories(WasmModule* module) {
                     uint8_t mutability = 0;
                     if (wasm_stream_read(module, &valtype, 1) != 1 ||
                         wasm_stream_read(module, &mutability, 1) != 1) {
-                        free(module_name);
-                        free(import_name);
                         free(imported_memories);
                         return -1;
                     }
                     break;
                 }
                 default:
-                    free(module_name);
-                    free(import_name);
                     free(imported_memories);
                     return -1;
             }
-            free(module_name);
-            free(import_name);
         }
         break;
     }
@@ -1265,7 +1790,7 @@ int wasm_load_memories(WasmModule* module) {
 
             const uint32_t total_memories = imported_count + defined_count;
             if (total_memories > 0) {
-                module->memories = (WasmMemory*)calloc(total_memories, sizeof(WasmMemory));
+                module->memories = (WasmMemory*)wasm_arena_calloc(&module->arena, total_memories, sizeof(WasmMemory));
                 if (!module->memories) {
                     free(imported_memories);
                     return -1;
@@ -1304,13 +1829,19 @@ int wasm_load_memories(WasmModule* module) {
                 }
             }
 
-            return 0;
+            return wasm_index_imports(module);
         }
     }
 
     if (!found_memory_section) {
         if (imported_count > 0) {
-            module->memories = imported_memories;
+            module->memories = (WasmMemory*)wasm_arena_calloc(&module->arena, imported_count, sizeof(WasmMemory));
+            if (!module->memories) {
+                free(imported_memories);
+                return -1;
+            }
+            memcpy(module->memories, imported_memories, imported_count * sizeof(WasmMemory));
+            free(imported_memories);
             module->num_memories = imported_count;
             module->num_imported_memories = imported_count;
         } else {
@@ -1319,7 +1850,7 @@ int wasm_load_memories(WasmModule* module) {
             module->num_imported_memories = 0;
         }
         module->memories_offset = 0;
-        return 0;
+        return wasm_index_imports(module);
     }
 
     free(imported_memories);
@@ -1352,13 +1883,9 @@ int wasm_load_globals(WasmModule* module) {
 
         for (uint32_t j = 0; j < count; j++) {
             uint32_t name_len = 0;
-            char* module_name = read_string(module, &name_len);
-            char* import_name = read_string(module, &name_len);
-            if (module_name) {
-                free(module_name);
-            }
-            if (import_name) {
-                free(import_name);
+            if (!wasm_read_name(module, &name_len) || !wasm_read_name(module, &name_len)) {
+                free(imported_globals);
+                return -1;
             }
 
             uint8_t kind = 0;
@@ -1453,7 +1980,7 @@ int wasm_load_globals(WasmModule* module) {
 
     const uint32_t total_globals = imported_count + defined_count;
     if (total_globals > 0) {
-        globals = (WasmGlobal*)calloc(total_globals, sizeof(WasmGlobal));
+        globals = (WasmGlobal*)wasm_arena_calloc(&module->arena, total_globals, sizeof(WasmGlobal));
         if (!globals) {
             free(imported_globals);
             return -1;
@@ -1575,11 +2102,10 @@ int wasm_load_elements(WasmModule* module) {
             uint32_t count = read_uleb128(module, &size_read);
 
             module->num_elements = count;
-            module->elements = (WasmElementSegment*)malloc(count * sizeof(WasmElementSegment));
+            module->elements = (WasmElementSegment*)wasm_arena_calloc(&module->arena, count, sizeof(WasmElementSegment));
             if (!module->elements) {
                 return -1;
             }
-            memset(module->elements, 0, count * sizeof(WasmElementSegment));
 
             module->elements_offset = module->sections[i].offset + size_read;
 
@@ -1687,7 +2213,8 @@ int wasm_load_elements(WasmModule* module) {
                 }
                 segment->element_count = elem_count;
                 if (elem_count > 0) {
-                    segment->elements = (WasmElementInit*)calloc(elem_count, sizeof(WasmElementInit));
+                    segment->elements = (WasmElementInit*)wasm_arena_calloc(&module->arena, elem_count,
+                                                                            sizeof(WasmElementInit));
                     if (!segment->elements) {
                         return -1;
                     }
@@ -1718,8 +2245,46 @@ int wasm_load_elements(WasmModule* module) {
     return 0;
 }
 
+// Carica il numero di data segment dalla sezione DataCount
+int wasm_load_data_count(WasmModule* module) {
+    module->has_data_count = false;
+    module->data_count = 0;
+    for (uint32_t i = 0; i < module->num_sections; i++) {
+        if (module->sections[i].type != SECTION_DATA_COUNT) {
+            continue;
+        }
+        if (wasm_stream_seek(module, module->sections[i].offset, SEEK_SET) < 0) {
+            return -1;
+        }
+        uint32_t size_read;
+        const uint32_t count = read_uleb128(module, &size_read);
+        if (size_read == 0 || size_read != module->sections[i].size) {
+            return -1;
+        }
+        module->has_data_count = true;
+        module->data_count = count;
+        return 0;
+    }
+    return 0;
+}
+
+static void wasm_free_data_copies(WasmModule* module) {
+    for (uint32_t i = 0; i < module->num_data_segments && module->data_segments; ++i) {
+        WasmDataSegment* segment = &module->data_segments[i];
+        if (segment->is_passive && segment->data_owned) {
+            free((void*)segment->data);
+            segment->data = NULL;
+        }
+    }
+}
+
 // Carica i data segment dalla sezione Data
 int wasm_load_data(WasmModule* module) {
+    /* Streamed modules read it with their metadata; its window is gone now. */
+    if (!module->has_data_count && wasm_load_data_count(module) != 0) {
+        return -1;
+    }
+    wasm_free_data_copies(module);
     for (uint32_t i = 0; i < module->num_sections; i++) {
         if (module->sections[i].type == SECTION_DATA) {
             if (wasm_stream_seek(module, module->sections[i].offset, SEEK_SET) < 0) {
@@ -1728,13 +2293,15 @@ int wasm_load_data(WasmModule* module) {
 
             uint32_t size_read;
             uint32_t count = read_uleb128(module, &size_read);
+            if (module->has_data_count && count != module->data_count) {
+                return -1;
+            }
 
             module->num_data_segments = count;
-            module->data_segments = (WasmDataSegment*)malloc(count * sizeof(WasmDataSegment));
+            module->data_segments = (WasmDataSegment*)wasm_arena_calloc(&module->arena, count, sizeof(WasmDataSegment));
             if (!module->data_segments) {
                 return -1;
             }
-            memset(module->data_segments, 0, count * sizeof(WasmDataSegment));
 
             module->data_segments_offset = module->sections[i].offset + size_read;
 
@@ -1764,14 +2331,33 @@ int wasm_load_data(WasmModule* module) {
 
                 uint32_t data_size = read_uleb128(module, &size_read);
                 segment->size = data_size;
-                if (data_size > 0) {
-                    segment->data = (uint8_t*)malloc(data_size);
-                    if (!segment->data) {
+                segment->data_offset = module->cursor;
+                if (data_size == 0) {
+                    continue;
+                }
+                if (module->buffer) {
+                    /* Borrowed: the module outlives every instance built from it. */
+                    if ((uint64_t)segment->data_offset + data_size > (uint64_t)module->buffer_size) {
                         return -1;
                     }
-                    if (wasm_stream_read(module, segment->data, data_size) != (ssize_t)data_size) {
+                    segment->data = module->buffer + segment->data_offset;
+                } else if (module->fd < 0 && !module->reader.read) {
+                    /* Nothing to come back to. Active bytes are needed by every
+                       instantiation; passive ones only until the last data.drop. */
+                    uint8_t* copy = segment->is_passive ? (uint8_t*)malloc(data_size)
+                                                        : (uint8_t*)wasm_arena_alloc(&module->arena, data_size);
+                    if (!copy) {
                         return -1;
                     }
+                    segment->data = copy;
+                    segment->data_owned = true;
+                    if (wasm_stream_read(module, copy, data_size) != (ssize_t)data_size) {
+                        return -1;
+                    }
+                    continue;
+                }
+                if (wasm_stream_seek(module, (off_t)data_size, SEEK_CUR) < 0) {
+                    return -1;
                 }
             }
 
@@ -1780,7 +2366,7 @@ int wasm_load_data(WasmModule* module) {
     }
 
     module->num_data_segments = 0;
-    return 0;
+    return module->has_data_count && module->data_count != 0 ? -1 : 0;
 }
 
 // Carica un byte code di una funzione on-demand
@@ -1810,6 +2396,767 @@ uint8_t* wasm_load_function_body(WasmModule* module, uint32_t func_idx) {
     return body;
 }
 
+int wasm_module_content_digest(WasmModule* module, uint8_t digest_out[FA_SHA256_BYTES]) {
+    if (!module || !digest_out) {
+        return -1;
+    }
+    if (module->content_digest_valid) {
+        memcpy(digest_out, module->content_digest, FA_SHA256_BYTES);
+        return 0;
+    }
+    fa_Sha256 sha;
+    fa_sha256_init(&sha);
+    if (module->buffer) {
+        fa_sha256_update(&sha, module->buffer, module->buffer_size);
+    } else {
+        const off_t saved = module->cursor;
+        uint8_t chunk[WASM_READ_AHEAD_MAX_BYTES];
+        off_t remaining = wasm_stream_size(module);
+        if (wasm_stream_seek(module, 0, SEEK_SET) < 0) {
+            return -1;
+        }
+        while (remaining > 0) {
+            const size_t want = remaining < (off_t)sizeof(chunk) ? (size_t)remaining : sizeof(chunk);
+            const ssize_t got = wasm_stream_read(module, chunk, want);
+            if (got <= 0) {
+                module->cursor = saved;
+                return -1;
+            }
+            fa_sha256_update(&sha, chunk, (size_t)got);
+            remaining -= (off_t)got;
+        }
+        module->cursor = saved;
+    }
+    fa_sha256_final(&sha, module->content_digest);
+    module->content_digest_valid = true;
+    memcpy(digest_out, module->content_digest, FA_SHA256_BYTES);
+    return 0;
+}
+
+/* ----- streaming parser ----- */
+
+typedef enum {
+    WASM_PARSE_HEADER = 0,
+    WASM_PARSE_SECTION_ID,
+    WASM_PARSE_SECTION_SIZE,
+    WASM_PARSE_SECTION_BYTES, /* retained in a window until parsed */
+    WASM_PARSE_CUSTOM_NAME_LEN,
+    WASM_PARSE_CUSTOM_NAME,
+    WASM_PARSE_SKIP,          /* custom section payload */
+    WASM_PARSE_CODE_COUNT,
+    WASM_PARSE_BODY_SIZE,
+    WASM_PARSE_BODY,
+    WASM_PARSE_DATA_COUNT,
+    WASM_PARSE_DATA_HEADER,   /* one segment's flags, offset expression and size */
+    WASM_PARSE_DATA_BYTES,    /* its payload: copied without a reader, else skipped */
+    WASM_PARSE_FAILED
+} WasmParseState;
+
+/* flags + memory index + i64.const expression + size, at their longest. */
+#define WASM_STREAM_SEGMENT_HEADER_BYTES 32U
+
+struct WasmModuleStream {
+    WasmModule* module;
+    WasmParseState state;
+    uint8_t header[8];
+    uint32_t header_len;
+    uint32_t uleb_value;
+    uint32_t uleb_shift;
+    uint8_t section_id;
+    uint32_t section_size;
+    off_t section_start;
+    WasmStreamWindow* window;  /* window being filled */
+    WasmSection* custom;       /* custom section being named */
+    char* custom_name;         /* its arena name buffer, filled in place */
+    uint32_t name_filled;
+    uint32_t code_count;
+    uint32_t bodies_ready;
+    uint64_t skip;
+    uint32_t data_index;       /* data segment being parsed */
+    uint8_t segment_header[WASM_STREAM_SEGMENT_HEADER_BYTES];
+    uint32_t segment_header_len;
+    uint8_t* segment_copy;     /* its copy when there is no reader */
+    bool metadata_loaded;
+    bool code_seen;
+    bool data_seen;
+    fa_Sha256 sha;
+};
+
+static bool wasm_has_section(const WasmModule* module, WasmSectionType type) {
+    for (uint32_t i = 0; i < module->num_sections; ++i) {
+        if (module->sections[i].type == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void wasm_release_windows(WasmModule* module) {
+    for (uint32_t i = 0; i < module->num_windows; ++i) {
+        free(module->windows[i].data);
+    }
+    free(module->windows);
+    module->windows = NULL;
+    module->num_windows = 0;
+}
+
+static WasmSection* wasm_stream_add_section(WasmModule* module, uint8_t id, uint32_t size, off_t offset) {
+    WasmSection* grown = (WasmSection*)realloc(module->sections, (module->num_sections + 1U) * sizeof(WasmSection));
+    if (!grown) {
+        return NULL;
+    }
+    module->sections = grown;
+    WasmSection* section = &grown[module->num_sections++];
+    memset(section, 0, sizeof(*section));
+    section->type = (WasmSectionType)id;
+    section->size = size;
+    section->offset = offset;
+    return section;
+}
+
+/* Every section before the code section has arrived: parse them with the
+   regular loaders, then drop the retained bytes. */
+static int wasm_stream_load_metadata(WasmModuleStream* stream) {
+    WasmModule* module = stream->module;
+    if ((wasm_has_section(module, SECTION_TYPE) && wasm_load_types(module) != 0) ||
+        wasm_load_functions(module) != 0 ||
+        (wasm_has_section(module, SECTION_EXPORT) && wasm_load_exports(module) != 0) ||
+        wasm_load_tables(module) != 0 ||
+        wasm_load_memories(module) != 0 ||
+        wasm_load_globals(module) != 0 ||
+        wasm_load_elements(module) != 0 ||
+        wasm_load_data_count(module) != 0) {
+        return -1;
+    }
+    wasm_release_windows(module);
+    stream->metadata_loaded = true;
+    return 0;
+}
+
+/* Feeds one byte of a LEB128 u32: 1 once complete, 0 for more, -1 when it
+   runs past five bytes. */
+static int wasm_stream_uleb(WasmModuleStream* stream, uint8_t byte) {
+    if (stream->uleb_shift >= 35U) {
+        return -1;
+    }
+    stream->uleb_value |= (uint32_t)(byte & 0x7F) << stream->uleb_shift;
+    stream->uleb_shift += 7U;
+    return (byte & 0x80) ? 0 : 1;
+}
+
+static uint32_t wasm_stream_take_uleb(WasmModuleStream* stream) {
+    const uint32_t value = stream->uleb_value;
+    stream->uleb_value = 0;
+    stream->uleb_shift = 0;
+    return value;
+}
+
+/* Bytes of the current section still to come. */
+static off_t wasm_stream_section_left(const WasmModuleStream* stream) {
+    return stream->section_start + (off_t)stream->section_size - stream->module->stream_size;
+}
+
+static int wasm_stream_end_section(WasmModuleStream* stream) {
+    WasmModule* module = stream->module;
+    if (stream->section_id == SECTION_CODE) {
+        /* Registered only now, so wasm_load_functions never goes looking for
+           bodies that have not arrived. */
+        if (!wasm_stream_add_section(module, SECTION_CODE, stream->section_size, stream->section_start)) {
+            return -1;
+        }
+    }
+    stream->state = WASM_PARSE_SECTION_ID;
+    return 0;
+}
+
+/* Windows grow with the bytes that actually arrived, never to the declared
+   section size up front: a forged size costs nothing until its bytes come. */
+static int wasm_stream_grow_window(WasmStreamWindow* window, size_t needed) {
+    size_t capacity = window->capacity > 0 ? window->capacity : WASM_READ_AHEAD_BYTES;
+    while (capacity < needed) {
+        capacity *= 2U;
+    }
+    if (capacity > window->size) {
+        capacity = window->size;
+    }
+    uint8_t* grown = (uint8_t*)realloc(window->data, capacity);
+    if (!grown) {
+        return -1;
+    }
+    window->data = grown;
+    window->capacity = capacity;
+    return 0;
+}
+
+/* LEB128 over the `len` bytes buffered at `p`, from *at: 1 once complete
+   (advancing *at), 0 when more bytes are needed, -1 when it runs past the
+   longest encoding of a `bits`-bit value. */
+static int wasm_buffer_leb(const uint8_t* p, size_t len, size_t* at, uint32_t bits, bool is_signed, int64_t* out) {
+    const uint32_t max_bytes = (bits + 6U) / 7U;
+    uint64_t result = 0;
+    uint32_t shift = 0;
+    for (uint32_t i = 0; i < max_bytes; ++i) {
+        if (*at + i >= len) {
+            return 0;
+        }
+        const uint8_t byte = p[*at + i];
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        shift += 7U;
+        if (!(byte & 0x80)) {
+            if (is_signed && shift < 64U && (byte & 0x40)) {
+                result |= ~0ULL << shift;
+            }
+            *at += i + 1U;
+            *out = (int64_t)result;
+            return 1;
+        }
+    }
+    return -1;
+}
+
+/* A data segment header as wasm_load_data reads it (flags, memory index,
+   constant offset expression, size), decoded from the bytes buffered so far:
+   1 once complete, 0 when more are needed, -1 when malformed. */
+static int wasm_stream_segment_header(const uint8_t* p, size_t len, WasmDataSegment* segment) {
+    size_t at = 0;
+    int64_t value = 0;
+    int done = wasm_buffer_leb(p, len, &at, 32U, false, &value);
+    if (done <= 0) {
+        return done;
+    }
+    const uint32_t flags = (uint32_t)value;
+    if (flags > 2U) {
+        return -1;
+    }
+    segment->memory_index = 0;
+    segment->is_passive = flags == 1U;
+    if (flags == 2U) {
+        done = wasm_buffer_leb(p, len, &at, 32U, false, &value);
+        if (done <= 0) {
+            return done;
+        }
+        segment->memory_index = (uint32_t)value;
+    }
+    if (flags != 1U) {
+        if (at >= len) {
+            return 0;
+        }
+        const uint8_t opcode = p[at++];
+        if (opcode != 0x41 && opcode != 0x42) {
+            return -1;
+        }
+        done = wasm_buffer_leb(p, len, &at, opcode == 0x41 ? 32U : 64U, true, &value);
+        if (done <= 0) {
+            return done;
+        }
+        if (opcode == 0x41) {
+            value = (int32_t)(uint32_t)value;
+        }
+        if (value < 0) {
+            return -1;
+        }
+        if (at >= len) {
+            return 0;
+        }
+        if (p[at++] != 0x0B) {
+            return -1;
+        }
+        segment->offset = (uint64_t)value;
+    }
+    done = wasm_buffer_leb(p, len, &at, 32U, false, &value);
+    if (done <= 0) {
+        return done;
+    }
+    segment->size = (uint32_t)value;
+    return 1;
+}
+
+/* Moves past a finished data segment: the next header, or the section end. */
+static int wasm_stream_next_segment(WasmModuleStream* stream) {
+    stream->segment_header_len = 0;
+    stream->segment_copy = NULL;
+    if (++stream->data_index < stream->module->num_data_segments) {
+        stream->state = WASM_PARSE_DATA_HEADER;
+        return 0;
+    }
+    return wasm_stream_section_left(stream) == 0 ? wasm_stream_end_section(stream) : -1;
+}
+
+/* A segment header is complete: its payload starts here. With a reader it is
+   read back by offset like a function body; without one there is nothing to
+   come back to, so it is copied as it streams by (active bytes in the arena,
+   passive ones on the heap until the last data.drop). */
+static int wasm_stream_begin_segment(WasmModuleStream* stream) {
+    WasmModule* module = stream->module;
+    WasmDataSegment* segment = &module->data_segments[stream->data_index];
+    segment->data_offset = module->stream_size;
+    if ((off_t)segment->size > wasm_stream_section_left(stream)) {
+        return -1;
+    }
+    if (segment->size == 0) {
+        return wasm_stream_next_segment(stream);
+    }
+    if (!module->reader.read) {
+        uint8_t* copy = segment->is_passive ? (uint8_t*)malloc(segment->size)
+                                            : (uint8_t*)wasm_arena_alloc(&module->arena, segment->size);
+        if (!copy) {
+            return -1;
+        }
+        segment->data = copy;
+        segment->data_owned = true;
+        stream->segment_copy = copy;
+    }
+    stream->skip = segment->size;
+    stream->state = WASM_PARSE_DATA_BYTES;
+    return 0;
+}
+
+/* The section size just arrived: record the section and pick how its
+   payload is consumed. */
+static int wasm_stream_begin_section(WasmModuleStream* stream) {
+    WasmModule* module = stream->module;
+    stream->section_size = wasm_stream_take_uleb(stream);
+    stream->section_start = module->stream_size;
+    /* Metadata is parsed by now: a late section would be silently lost. */
+    if (stream->section_id != SECTION_CUSTOM &&
+        (stream->data_seen || (stream->code_seen && stream->section_id != SECTION_DATA))) {
+        return -1;
+    }
+    if (stream->section_id == SECTION_CODE) {
+        if (!stream->metadata_loaded && wasm_stream_load_metadata(stream) != 0) {
+            return -1;
+        }
+        stream->code_seen = true;
+        stream->state = WASM_PARSE_CODE_COUNT;
+        return stream->section_size > 0 ? 0 : -1;
+    }
+    if (stream->section_id == SECTION_DATA &&
+        !stream->metadata_loaded && wasm_stream_load_metadata(stream) != 0) {
+        return -1;
+    }
+    WasmSection* section = wasm_stream_add_section(module, stream->section_id, stream->section_size,
+                                                   stream->section_start);
+    if (!section) {
+        return -1;
+    }
+    if (stream->section_id == SECTION_DATA) {
+        stream->data_seen = true;
+        stream->state = WASM_PARSE_DATA_COUNT;
+        return stream->section_size > 0 ? 0 : -1;
+    }
+    if (stream->section_id == SECTION_CUSTOM) {
+        stream->custom = section;
+        stream->state = WASM_PARSE_CUSTOM_NAME_LEN;
+        return stream->section_size > 0 ? 0 : -1;
+    }
+    if (stream->section_size == 0) {
+        return wasm_stream_end_section(stream);
+    }
+    WasmStreamWindow* grown =
+        (WasmStreamWindow*)realloc(module->windows, (module->num_windows + 1U) * sizeof(WasmStreamWindow));
+    if (!grown) {
+        return -1;
+    }
+    module->windows = grown;
+    WasmStreamWindow* window = &grown[module->num_windows];
+    memset(window, 0, sizeof(*window));
+    window->offset = stream->section_start;
+    window->size = stream->section_size;
+    module->num_windows++;
+    stream->window = window;
+    stream->state = WASM_PARSE_SECTION_BYTES;
+    return 0;
+}
+
+/* Consumes bytes from the front of [p, p + available) and returns how many
+   (at least one), or -1. Header and LEB128 states take one byte at a time,
+   payload states whatever is available. */
+static ssize_t wasm_stream_step(WasmModuleStream* stream, const uint8_t* p, size_t available) {
+    WasmModule* module = stream->module;
+    switch (stream->state) {
+        case WASM_PARSE_HEADER:
+            module->stream_size += 1;
+            stream->header[stream->header_len++] = *p;
+            if (stream->header_len == sizeof(stream->header)) {
+                module->magic = (uint32_t)stream->header[0] | ((uint32_t)stream->header[1] << 8) |
+                                ((uint32_t)stream->header[2] << 16) | ((uint32_t)stream->header[3] << 24);
+                module->version = (uint32_t)stream->header[4] | ((uint32_t)stream->header[5] << 8) |
+                                  ((uint32_t)stream->header[6] << 16) | ((uint32_t)stream->header[7] << 24);
+                if (module->magic != 0x6d736100 || module->version != 1) {
+                    return -1;
+                }
+                stream->state = WASM_PARSE_SECTION_ID;
+            }
+            return 1;
+        case WASM_PARSE_SECTION_ID:
+            module->stream_size += 1;
+            if (*p > SECTION_DATA_COUNT) {
+                return -1;
+            }
+            stream->section_id = *p;
+            stream->state = WASM_PARSE_SECTION_SIZE;
+            return 1;
+        case WASM_PARSE_SECTION_SIZE:
+        {
+            module->stream_size += 1;
+            const int done = wasm_stream_uleb(stream, *p);
+            if (done < 0 || (done > 0 && wasm_stream_begin_section(stream) != 0)) {
+                return -1;
+            }
+            return 1;
+        }
+        case WASM_PARSE_SECTION_BYTES:
+        {
+            WasmStreamWindow* window = stream->window;
+            size_t chunk = window->size - window->filled;
+            if (chunk > available) {
+                chunk = available;
+            }
+            if (window->filled + chunk > window->capacity &&
+                wasm_stream_grow_window(window, window->filled + chunk) != 0) {
+                return -1;
+            }
+            memcpy(window->data + window->filled, p, chunk);
+            window->filled += chunk;
+            module->stream_size += (off_t)chunk;
+            if (window->filled == window->size && wasm_stream_end_section(stream) != 0) {
+                return -1;
+            }
+            return (ssize_t)chunk;
+        }
+        case WASM_PARSE_CUSTOM_NAME_LEN:
+        {
+            module->stream_size += 1;
+            const int done = wasm_stream_uleb(stream, *p);
+            if (done < 0 || wasm_stream_section_left(stream) < 0) {
+                return -1;
+            }
+            if (done > 0) {
+                const uint32_t name_len = wasm_stream_take_uleb(stream);
+                if ((off_t)name_len > wasm_stream_section_left(stream)) {
+                    return -1;
+                }
+                stream->custom_name = (char*)wasm_arena_alloc(&module->arena, (size_t)name_len + 1U);
+                if (!stream->custom_name) {
+                    return -1;
+                }
+                stream->custom->name = stream->custom_name;
+                stream->custom->name_len = name_len;
+                stream->name_filled = 0;
+                stream->skip = (uint64_t)(wasm_stream_section_left(stream) - (off_t)name_len);
+                stream->state = name_len > 0 ? WASM_PARSE_CUSTOM_NAME
+                                             : (stream->skip > 0 ? WASM_PARSE_SKIP : WASM_PARSE_SECTION_ID);
+            }
+            return 1;
+        }
+        case WASM_PARSE_CUSTOM_NAME:
+        {
+            size_t chunk = stream->custom->name_len - stream->name_filled;
+            if (chunk > available) {
+                chunk = available;
+            }
+            memcpy(stream->custom_name + stream->name_filled, p, chunk);
+            stream->name_filled += (uint32_t)chunk;
+            module->stream_size += (off_t)chunk;
+            if (stream->name_filled == stream->custom->name_len) {
+                stream->state = stream->skip > 0 ? WASM_PARSE_SKIP : WASM_PARSE_SECTION_ID;
+            }
+            return (ssize_t)chunk;
+        }
+        case WASM_PARSE_CODE_COUNT:
+        {
+            module->stream_size += 1;
+            const int done = wasm_stream_uleb(stream, *p);
+            if (done < 0) {
+                return -1;
+            }
+            if (done > 0) {
+                stream->code_count = wasm_stream_take_uleb(stream);
+                if (stream->code_count != module->num_functions - module->num_imported_functions) {
+                    return -1;
+                }
+                if (stream->code_count > 0) {
+                    stream->state = WASM_PARSE_BODY_SIZE;
+                } else if (wasm_stream_section_left(stream) != 0 || wasm_stream_end_section(stream) != 0) {
+                    return -1;
+                }
+            }
+            return 1;
+        }
+        case WASM_PARSE_BODY_SIZE:
+        {
+            module->stream_size += 1;
+            const int done = wasm_stream_uleb(stream, *p);
+            if (done < 0 || wasm_stream_section_left(stream) <= 0) {
+                return -1;
+            }
+            if (done > 0) {
+                const uint32_t body_size = wasm_stream_take_uleb(stream);
+                if (body_size == 0 || (off_t)body_size > wasm_stream_section_left(stream)) {
+                    return -1;
+                }
+                WasmFunction* func = &module->functions[module->num_imported_functions + stream->bodies_ready];
+                func->body_offset = module->stream_size;
+                func->body_size = body_size;
+                stream->skip = body_size;
+                stream->state = WASM_PARSE_BODY;
+            }
+            return 1;
+        }
+        case WASM_PARSE_SKIP:
+        case WASM_PARSE_BODY:
+        {
+            const size_t chunk = stream->skip < (uint64_t)available ? (size_t)stream->skip : available;
+            stream->skip -= chunk;
+            module->stream_size += (off_t)chunk;
+            if (stream->skip > 0) {
+                return (ssize_t)chunk;
+            }
+            if (stream->state == WASM_PARSE_SKIP) {
+                stream->state = WASM_PARSE_SECTION_ID;
+                return (ssize_t)chunk;
+            }
+            stream->bodies_ready++;
+            if (stream->bodies_ready < stream->code_count) {
+                stream->state = WASM_PARSE_BODY_SIZE;
+            } else if (wasm_stream_section_left(stream) != 0 || wasm_stream_end_section(stream) != 0) {
+                return -1;
+            }
+            return (ssize_t)chunk;
+        }
+        case WASM_PARSE_DATA_COUNT:
+        {
+            module->stream_size += 1;
+            const int done = wasm_stream_uleb(stream, *p);
+            if (done < 0 || wasm_stream_section_left(stream) < 0) {
+                return -1;
+            }
+            if (done > 0) {
+                /* Every segment takes at least two bytes, so a count the
+                   section cannot hold is rejected before it is allocated. */
+                const uint32_t count = wasm_stream_take_uleb(stream);
+                if ((module->has_data_count && count != module->data_count) ||
+                    (off_t)count > wasm_stream_section_left(stream)) {
+                    return -1;
+                }
+                module->num_data_segments = count;
+                module->data_segments_offset = module->stream_size;
+                if (count == 0) {
+                    return wasm_stream_end_section(stream) == 0 && wasm_stream_section_left(stream) == 0 ? 1 : -1;
+                }
+                module->data_segments =
+                    (WasmDataSegment*)wasm_arena_calloc(&module->arena, count, sizeof(WasmDataSegment));
+                if (!module->data_segments) {
+                    return -1;
+                }
+                stream->data_index = 0;
+                stream->segment_header_len = 0;
+                stream->state = WASM_PARSE_DATA_HEADER;
+            }
+            return 1;
+        }
+        case WASM_PARSE_DATA_HEADER:
+        {
+            module->stream_size += 1;
+            if (wasm_stream_section_left(stream) < 0) {
+                return -1;
+            }
+            stream->segment_header[stream->segment_header_len++] = *p;
+            const int done = wasm_stream_segment_header(stream->segment_header, stream->segment_header_len,
+                                                        &module->data_segments[stream->data_index]);
+            if (done < 0 || (done == 0 && stream->segment_header_len == WASM_STREAM_SEGMENT_HEADER_BYTES) ||
+                (done > 0 && wasm_stream_begin_segment(stream) != 0)) {
+                return -1;
+            }
+            return 1;
+        }
+        case WASM_PARSE_DATA_BYTES:
+        {
+            const WasmDataSegment* segment = &module->data_segments[stream->data_index];
+            const size_t chunk = stream->skip < (uint64_t)available ? (size_t)stream->skip : available;
+            if (stream->segment_copy) {
+                memcpy(stream->segment_copy + (segment->size - stream->skip), p, chunk);
+            }
+            stream->skip -= chunk;
+            module->stream_size += (off_t)chunk;
+            if (stream->skip == 0 && wasm_stream_next_segment(stream) != 0) {
+                return -1;
+            }
+            return (ssize_t)chunk;
+        }
+        default:
+            return -1;
+    }
+}
+
+WasmModuleStream* wasm_module_stream_begin(const WasmModuleReader* reader) {
+    WasmModuleStream* stream = (WasmModuleStream*)calloc(1, sizeof(WasmModuleStream));
+    WasmModule* module = (WasmModule*)calloc(1, sizeof(WasmModule));
+    if (!stream || !module) {
+        free(stream);
+        free(module);
+        return NULL;
+    }
+    module->fd = -1;
+    module->filename = wasm_strdup("<stream>");
+    if (reader) {
+        module->reader = *reader;
+    }
+    stream->module = module;
+    stream->state = WASM_PARSE_HEADER;
+    fa_sha256_init(&stream->sha);
+    return stream;
+}
+
+int wasm_module_stream_feed(WasmModuleStream* stream, const uint8_t* bytes, size_t size) {
+    if (!stream || (!bytes && size > 0) || stream->state == WASM_PARSE_FAILED) {
+        return -1;
+    }
+    fa_sha256_update(&stream->sha, bytes, size);
+    size_t at = 0;
+    while (at < size) {
+        const ssize_t used = wasm_stream_step(stream, bytes + at, size - at);
+        if (used <= 0) {
+            stream->state = WASM_PARSE_FAILED;
+            return -1;
+        }
+        at += (size_t)used;
+    }
+    return 0;
+}
+
+WasmModule* wasm_module_stream_module(WasmModuleStream* stream) {
+    return stream ? stream->module : NULL;
+}
+
+uint32_t wasm_module_stream_bodies_ready(const WasmModuleStream* stream) {
+    return stream ? stream->bodies_ready : 0;
+}
+
+void wasm_module_stream_abort(WasmModuleStream* stream) {
+    if (!stream) {
+        return;
+    }
+    wasm_module_free(stream->module);
+    free(stream);
+}
+
+WasmModule* wasm_module_stream_finish(WasmModuleStream* stream) {
+    if (!stream) {
+        return NULL;
+    }
+    WasmModule* module = stream->module;
+    /* A module without a code section has nothing after its metadata. */
+    bool ok = stream->state == WASM_PARSE_SECTION_ID &&
+              (stream->metadata_loaded || wasm_stream_load_metadata(stream) == 0);
+    if (ok && !stream->code_seen && module->num_functions > module->num_imported_functions) {
+        ok = false;
+    }
+    if (ok && !stream->data_seen && module->has_data_count && module->data_count != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        wasm_module_stream_abort(stream);
+        return NULL;
+    }
+    fa_sha256_final(&stream->sha, module->content_digest);
+    module->content_digest_valid = true;
+    free(stream);
+    return module;
+}
+
+WasmModule* wasm_module_parse_stream(WasmModuleFeedFn feed, void* feed_user, const WasmModuleReader* reader) {
+    if (!feed) {
+        return NULL;
+    }
+    WasmModuleStream* stream = wasm_module_stream_begin(reader);
+    if (!stream) {
+        return NULL;
+    }
+    uint8_t chunk[WASM_READ_AHEAD_BYTES];
+    size_t got = 0;
+    while ((got = feed(feed_user, chunk, sizeof(chunk))) > 0) {
+        if (wasm_module_stream_feed(stream, chunk, got) != 0) {
+            wasm_module_stream_abort(stream);
+            return NULL;
+        }
+    }
+    return wasm_module_stream_finish(stream);
+}
+
+int wasm_read_data_segment(WasmModule* module, uint32_t index, uint64_t src_offset, uint8_t* out, size_t size) {
+    if (!module || !module->data_segments || index >= module->num_data_segments || (!out && size > 0)) {
+        return -1;
+    }
+    const WasmDataSegment* segment = &module->data_segments[index];
+    if (src_offset > segment->size || (uint64_t)size > segment->size - src_offset) {
+        return -1;
+    }
+    if (size == 0) {
+        return 0;
+    }
+    if (segment->data) {
+        memcpy(out, segment->data + src_offset, size);
+        return 0;
+    }
+    if (segment->live == WASM_DATA_SEGMENT_RELEASED ||
+        wasm_stream_seek(module, segment->data_offset + (off_t)src_offset, SEEK_SET) < 0) {
+        return -1;
+    }
+    return wasm_stream_read(module, out, size) == (ssize_t)size ? 0 : -1;
+}
+
+bool wasm_pin_data_segment(WasmModule* module, uint32_t index) {
+    if (!module || !module->data_segments || index >= module->num_data_segments) {
+        return false;
+    }
+    WasmDataSegment* segment = &module->data_segments[index];
+    uint32_t live = __atomic_load_n(&segment->live, __ATOMIC_ACQUIRE);
+    do {
+        if (live == WASM_DATA_SEGMENT_RELEASED) {
+            return false;
+        }
+    } while (!__atomic_compare_exchange_n(&segment->live, &live, live + 1U, false,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    return true;
+}
+
+void wasm_unpin_data_segment(WasmModule* module, uint32_t index) {
+    if (!module || !module->data_segments || index >= module->num_data_segments) {
+        return;
+    }
+    WasmDataSegment* segment = &module->data_segments[index];
+    /* The last reader of a copy that may go flips the count straight to
+       RELEASED, so a runtime attaching concurrently either pins first or
+       sees the segment as dropped, never a freed pointer. */
+    const bool frees_copy = segment->is_passive && segment->data_owned && module->release_passive_data;
+    uint32_t live = __atomic_load_n(&segment->live, __ATOMIC_ACQUIRE);
+    uint32_t next;
+    do {
+        if (live == 0U || live == WASM_DATA_SEGMENT_RELEASED) {
+            return;
+        }
+        next = live == 1U && frees_copy ? WASM_DATA_SEGMENT_RELEASED : live - 1U;
+    } while (!__atomic_compare_exchange_n(&segment->live, &live, next, false,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    if (next == WASM_DATA_SEGMENT_RELEASED) {
+        free((void*)segment->data);
+        segment->data = NULL;
+        return;
+    }
+#if defined(FA_WASM_HAS_MMAP)
+    if (next == 0U && module->buffer_mapped && segment->data) {
+        /* Clean file-backed pages: dropping them is invisible to readers. */
+        const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+        const uintptr_t start = ((uintptr_t)segment->data + page - 1U) & ~(page - 1U);
+        const uintptr_t end = ((uintptr_t)segment->data + segment->size) & ~(page - 1U);
+        if (end > start) {
+            (void)madvise((void*)start, (size_t)(end - start), MADV_DONTNEED);
+        }
+    }
+#endif
+}
+
 // Funzione per visualizzare informazioni sul modulo
 void wasm_print_info(WasmModule* module) {
     printf("=== WASM Module Info ===\n");
@@ -1,5 +1,6 @@
 #pragma once
 #include "fa_types.h"
+#include "fa_sha256.h"
 #include <stddef.h>
 // Macro per convertire byte LEB128 a intero
 #define MAX_LEB128_SIZE 5
@@ -26,13 +27,21 @@ typedef enum {
     SECTION_START = 8,
     SECTION_ELEMENT = 9,
     SECTION_CODE = 10,
-    SECTION_DATA = 11
+    SECTION_DATA = 11,
+    SECTION_DATA_COUNT = 12
 } WasmSectionType;
+// Tipi di import/export
+typedef enum {
+    WASM_EXTERNAL_FUNCTION = 0,
+    WASM_EXTERNAL_TABLE = 1,
+    WASM_EXTERNAL_MEMORY = 2,
+    WASM_EXTERNAL_GLOBAL = 3
+} WasmExternalKind;
 typedef struct {
     WasmSectionType type;
     uint32_t size;
     off_t offset;
-    char* name;            // Solo per sezioni custom
+    const char* name;      // Solo per sezioni custom
     uint32_t name_len;     // Solo per sezioni custom
 } WasmSection;
 // Sezione di memoria
@@ -42,9 +51,9 @@ typedef struct {
     uint64_t maximum_size; // Dimensione massima (in pagine, opzionale)
     bool has_max;          // Indica se è specificata una dimensione massima
     bool is_imported;
-    char* import_module;
+    const char* import_module;
     uint32_t import_module_len;
-    char* import_name;
+    const char* import_name;
     uint32_t import_name_len;
 } WasmMemory;
 typedef struct {
@@ -53,25 +62,26 @@ typedef struct {
     uint32_t maximum_size;
     bool has_max;
     bool is_imported;
-    char* import_module;
+    const char* import_module;
     uint32_t import_module_len;
-    char* import_name;
+    const char* import_name;
     uint32_t import_name_len;
 } WasmTable;
 typedef struct {
     uint32_t num_params;
     uint32_t num_results;
-    uint32_t* param_types;
-    uint32_t* result_types;
+    uint8_t* param_types;  // valtypes, one byte each
+    uint8_t* result_types;
+    uint32_t canonical_index; // first type with the same signature; equal indices mean equal types
 } WasmFunctionType;
 typedef struct {
     uint32_t type_index;
     off_t body_offset;
     uint32_t body_size;
     bool is_imported;
-    char* import_module;
+    const char* import_module;
     uint32_t import_module_len;
-    char* import_name;
+    const char* import_name;
     uint32_t import_name_len;
 } WasmFunction;
 typedef enum {
@@ -88,11 +98,24 @@ typedef struct {
     uint64_t init_raw;
 } WasmGlobal;
 typedef struct {
-    char* name;
+    const char* name;
     uint32_t name_len;
     uint32_t kind;         // 0=function, 1=table, 2=memory, 3=global
     uint32_t index;
 } WasmExport;
+/* A named function, table or memory import (imported globals keep no names).
+   `next` chains the imports that share one (module, name) pair. */
+typedef struct {
+    uint32_t kind;         // WasmExternalKind
+    uint32_t index;        // into functions, tables or memories
+    uint32_t next;         // imports[next - 1] has the same names; 0 ends the chain
+} WasmImport;
+/* Open-addressing hash index (linear probing, power-of-two slots): each slot
+   holds an entry index + 1, 0 when empty. */
+typedef struct {
+    uint32_t* slots;
+    uint32_t mask;
+} WasmNameIndex;
 typedef enum {
     WASM_ELEMENT_INIT_REF_VALUE = 0,
     WASM_ELEMENT_INIT_GLOBAL_GET = 1
@@ -114,10 +137,77 @@ typedef struct {
 typedef struct {
     uint32_t memory_index;
     uint32_t size;
-    uint8_t* data;
+    /* A view into the module buffer for in-memory and mmap'd modules, NULL
+       for fd- and reader-backed ones (read on demand from data_offset through
+       wasm_read_data_segment), or a copy (data_owned) when a streamed module
+       has no reader to come back to.
+       API change: this used to be a writable `uint8_t*` that always held a
+       private copy. Callers that patched segment bytes in place must now
+       copy the segment (wasm_read_data_segment) and write to the copy, since
+       a view aliases the module buffer or a read-only mapping. */
+    const uint8_t* data;
+    off_t data_offset;
+    bool data_owned; /* passive copies on the heap (releasable), active ones in the arena */
     uint64_t offset;
     bool is_passive;
+    /* Passive segments only: attached runtimes that have not dropped it yet,
+       or WASM_DATA_SEGMENT_RELEASED once its copy has been freed. */
+    uint32_t live;
 } WasmDataSegment;
+
+#define WASM_DATA_SEGMENT_RELEASED UINT32_MAX
+/* Bump arena holding a module's parsed metadata: section names, types and
+   their valtypes, the function/table/memory/global/export arrays, element and
+   data segment descriptors, and every import and export name, interned so a
+   name repeated across imports ("env", "wasi_snapshot_preview1") is stored
+   once. Blocks start at WASM_ARENA_BLOCK_BYTES and double up to
+   WASM_ARENA_MAX_BLOCK_BYTES (larger requests get a block of their own), and
+   the module releases the lot by freeing its blocks. */
+typedef struct WasmArenaBlock {
+    struct WasmArenaBlock* next;
+    size_t capacity;
+    size_t used;
+} WasmArenaBlock;
+typedef struct {
+    WasmArenaBlock* head;
+    size_t next_block_bytes;
+    size_t bytes;                 // handed out, including padding
+    uint32_t num_blocks;
+    const char** names;           // interned-name set (open addressing)
+    uint32_t names_mask;
+    uint32_t num_names;
+} WasmArena;
+
+#ifndef WASM_ARENA_BLOCK_BYTES
+#if defined(FAYASM_TARGET_ESP32) || defined(ESP_PLATFORM)
+#define WASM_ARENA_BLOCK_BYTES 1024U
+#else
+#define WASM_ARENA_BLOCK_BYTES 4096U
+#endif
+#endif
+#ifndef WASM_ARENA_MAX_BLOCK_BYTES
+#define WASM_ARENA_MAX_BLOCK_BYTES 65536U
+#endif
+
+/* Random-access source for modules built by the streaming parser: copies up
+   to `size` bytes at absolute `offset` into `out` and returns the number
+   copied (0 on failure). Serves function bodies and anything else read after
+   its section was parsed, typically from wherever the embedder stored the
+   bytes as they streamed by (flash, SD card, a file). */
+typedef struct {
+    size_t (*read)(void* user, uint64_t offset, uint8_t* out, size_t size);
+    void* user;
+} WasmModuleReader;
+
+// Section bytes the streaming parser keeps in RAM until they are parsed
+typedef struct {
+    off_t offset;
+    size_t size;     // declared section size
+    size_t filled;
+    size_t capacity; // allocated, grows with `filled` up to `size`
+    uint8_t* data;
+} WasmStreamWindow;
+
 typedef struct {
     uint32_t magic;        // 0x6d736100
     uint32_t version;      // 1
@@ -133,10 +223,18 @@ typedef struct {
     WasmFunction* functions;
     off_t functions_offset;
     uint32_t num_imported_functions;
+    // Start function (start section), loaded with the functions
+    bool has_start;
+    uint32_t start_function;
     // Export
     uint32_t num_exports;
     WasmExport* exports;
     off_t exports_offset;
+    WasmNameIndex export_index;
+    // Import (module, name) index, rebuilt by the function/table/memory loaders
+    uint32_t num_imports;
+    WasmImport* imports;
+    WasmNameIndex import_index;
     // Tabelle
     uint32_t num_tables;
     WasmTable* tables;
@@ -151,7 +249,11 @@ typedef struct {
     uint32_t num_elements;
     WasmElementSegment* elements;
     off_t elements_offset;
+    // Data count section: declared segment count, known before the code section
+    bool has_data_count;
+    uint32_t data_count;
     // Data segments
+    bool release_passive_data; // instantiated once: free passive copies at the last data.drop
     uint32_t num_data_segments;
     WasmDataSegment* data_segments;
     off_t data_segments_offset;
@@ -166,21 +268,133 @@ typedef struct {
     const uint8_t* buffer;
     size_t buffer_size;
     bool buffer_owned;
+    bool buffer_mapped; // buffer is a read-only mmap of `filename`
     off_t cursor;
     off_t stream_size;
+    // Read-ahead window for fd-backed modules that could not be mapped
+    uint8_t* read_ahead;
+    size_t read_ahead_capacity;
+    size_t read_ahead_len;
+    off_t read_ahead_start;
+    uint32_t read_ahead_refills; // block reads issued through the window
+    // Streaming parser backing (fd < 0, buffer == NULL): retained sections, then the reader
+    WasmModuleReader reader;
+    WasmStreamWindow* windows;
+    uint32_t num_windows;
+    // Parsed metadata (see WasmArena)
+    WasmArena arena;
+    // Cached wasm_module_content_digest result
+    uint8_t content_digest[FA_SHA256_BYTES];
+    bool content_digest_valid;
 } WasmModule;
+
+/* fd-backed modules refill a block-aligned read-ahead window (power of two in
+   [WASM_READ_AHEAD_MIN_BYTES, WASM_READ_AHEAD_MAX_BYTES]) so parsing from SD
+   cards and flash is dominated by sequential block reads, and seeks that land
+   inside the window cost nothing. */
+#define WASM_READ_AHEAD_MIN_BYTES 512U
+#define WASM_READ_AHEAD_MAX_BYTES 4096U
+#ifndef WASM_READ_AHEAD_BYTES
+#if defined(FAYASM_TARGET_ESP32) || defined(ESP_PLATFORM)
+#define WASM_READ_AHEAD_BYTES WASM_READ_AHEAD_MIN_BYTES
+#else
+#define WASM_READ_AHEAD_BYTES WASM_READ_AHEAD_MAX_BYTES
+#endif
+#endif
+
 WasmModule* wasm_module_init(const char* filename);
+/* Opens `filename` without mapping it, reading through a `read_ahead_bytes`
+   window (rounded to a power of two and clamped to the supported range). */
+WasmModule* wasm_module_init_buffered(const char* filename, size_t read_ahead_bytes);
 WasmModule* wasm_module_init_from_memory(const uint8_t* data, size_t size);
+/* Like wasm_module_init_from_memory without the copy: `data` is used in place
+   and must outlive the module (e.g. a read-only mapping or flash). */
+WasmModule* wasm_module_init_borrowed(const uint8_t* data, size_t size);
 void wasm_module_free(WasmModule* module);
 int wasm_load_header(WasmModule* module);
 int wasm_scan_sections(WasmModule* module);
 int wasm_load_types(WasmModule* module);
 int wasm_load_functions(WasmModule* module);
+/* Reads the start section (called by wasm_load_functions); a module without
+   one loads with has_start false. */
+int wasm_load_start(WasmModule* module);
 int wasm_load_exports(WasmModule* module);
 int wasm_load_tables(WasmModule* module);
 int wasm_load_memories(WasmModule* module);
 int wasm_load_globals(WasmModule* module);
 int wasm_load_elements(WasmModule* module);
+/* Reads the data count section (called by wasm_load_data and, for streamed
+   modules, before the code section); absent leaves has_data_count false. */
+int wasm_load_data_count(WasmModule* module);
 int wasm_load_data(WasmModule* module);
 uint8_t* wasm_load_function_body(WasmModule* module, uint32_t func_idx);
+/* Copies `size` bytes at `src_offset` of data segment `index` into `out`,
+   from the segment's view or straight from the module's backing store. */
+int wasm_read_data_segment(WasmModule* module, uint32_t index, uint64_t src_offset, uint8_t* out, size_t size);
+/* Passive segment readers. Attaching a runtime pins each passive segment
+   (false once its bytes are gone for good); data.drop or detach unpins it, and
+   the last unpin gives back what the segment keeps resident: the whole pages
+   of a segment inside an mmap'd module go back to the kernel (they fault in
+   again from the file if read), and a streamed module's heap copy is freed
+   when the module set release_passive_data. Segments read from a file or a
+   reader hold nothing resident. */
+bool wasm_pin_data_segment(WasmModule* module, uint32_t index);
+void wasm_unpin_data_segment(WasmModule* module, uint32_t index);
+/* Hash lookups over the indices built at parse time: export `name` of `kind`
+   (NULL when absent), and the first import of `kind` named (module_name,
+   name) in declaration order. wasm_module_next_import walks the rest of the
+   imports of that kind with the same names. */
+const WasmExport* wasm_module_find_export(const WasmModule* module, const char* name, uint32_t kind);
+const WasmImport* wasm_module_find_import(const WasmModule* module,
+                                          const char* module_name,
+                                          const char* name,
+                                          uint32_t kind);
+const WasmImport* wasm_module_next_import(const WasmModule* module, const WasmImport* import);
+
+/* ------------------------------------------------------------------------- *
+ * Streaming parser.
+ *
+ * Builds a module in one forward pass from chunks of any size as they arrive
+ * (socket, SD card, decompressor). Each section is recorded the moment its
+ * header arrives; metadata sections (types through elements and the data
+ * count) are held in RAM only until the code or data section starts, in a
+ * window that grows with the bytes received rather than the declared size,
+ * and the same wasm_load_* routines as the file path parse them. Function
+ * bodies, data segment payloads and custom section payloads are never
+ * buffered: bodies and segments are recorded by offset as their headers
+ * stream past and are read back through the WasmModuleReader, so the module
+ * never has to be in RAM as a whole. Without a reader, segment payloads are
+ * copied once, straight from the fed chunks. Only the data section and custom
+ * sections may follow the code section; any other known section there, or
+ * after the data section, is malformed.
+ * ------------------------------------------------------------------------- */
+typedef struct WasmModuleStream WasmModuleStream;
+/* Pulls the next chunk into `out`; returns its size, 0 at the end. */
+typedef size_t (*WasmModuleFeedFn)(void* user, uint8_t* out, size_t capacity);
+
+/* `reader` may be NULL when no function body will ever be loaded; data
+   segments are then kept as copies. */
+WasmModuleStream* wasm_module_stream_begin(const WasmModuleReader* reader);
+/* Consumes `size` bytes. Returns -1 (and stays failed) on malformed input or
+   allocation failure. */
+int wasm_module_stream_feed(WasmModuleStream* stream, const uint8_t* bytes, size_t size);
+/* The module under construction (owned by the stream until finish). Its
+   types, functions, imports, exports, tables, memories, globals and elements
+   are loaded once the code section has started, and the first
+   wasm_module_stream_bodies_ready defined functions have their body offsets,
+   so instantiation can start while the rest downloads. */
+WasmModule* wasm_module_stream_module(WasmModuleStream* stream);
+uint32_t wasm_module_stream_bodies_ready(const WasmModuleStream* stream);
+/* Checks the module ended on a section boundary, loads whatever is still
+   pending and hands the module over. The stream is freed either way; NULL
+   means the module was truncated or malformed. */
+WasmModule* wasm_module_stream_finish(WasmModuleStream* stream);
+void wasm_module_stream_abort(WasmModuleStream* stream);
+/* Pull-style wrapper: feeds `feed` chunks through a stream until it ends. */
+WasmModule* wasm_module_parse_stream(WasmModuleFeedFn feed, void* feed_user, const WasmModuleReader* reader);
+
+/* SHA-256 of the whole module image, computed once and cached. Keys the
+   persisted JIT code cache (fa_jit_persist.h) and module bundles, so a module
+   can never be handed code compiled for another one. */
+int wasm_module_content_digest(WasmModule* module, uint8_t digest_out[FA_SHA256_BYTES]);
 void wasm_print_info(WasmModule* module);
@@ -1,4 +1,10 @@
 #include "fa_runtime.h"
+#include "fa_aot.h"
+#include "fa_jit_closure.h"
+#include "fa_jit_code_cache.h"
+#include "fa_jit_native_ir.h"
+#include "fa_jit_persist.h"
+#include "fa_jit_worker.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,6 +17,22 @@
 #define PATH_MAX 1024
 #endif
 
+#if (defined(__unix__) || defined(__APPLE__)) && defined(FAYASM_TEST_C_COMPILER) && defined(FAYASM_TEST_BINARY_DIR)
+#include <dlfcn.h>
+#define TEST_AOT_CAN_BUILD 1
+#endif
+
+#if (defined(__unix__) || defined(__APPLE__)) && defined(FAYASM_TEST_BINARY_DIR)
+#include <dirent.h>
+#include <sys/stat.h>
+#define TEST_PERSIST_CAN_RUN 1
+#endif
+
+#if defined(FA_JIT_WORKERS_HOST)
+#include <pthread.h>
+#define TEST_THREADS_CAN_RUN 1
+#endif
+
 typedef struct {
     uint8_t* data;
     size_t size;
@@ -293,6 +315,16 @@ static int host_add(fa_Runtime* runtime, const fa_RuntimeHostCall* call, void* u
     return FA_RUNTIME_OK;
 }
 
+/* host_add plus the i32 behind user_data, so a result names its binding. */
+static int host_add_offset(fa_Runtime* runtime, const fa_RuntimeHostCall* call, void* user_data) {
+    if (!user_data || host_add(runtime, call, NULL) != FA_RUNTIME_OK ||
+        call->results[0].kind != fa_job_value_i32) {
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    const i32 sum = call->results[0].payload.i32_value;
+    return fa_RuntimeHostCall_set_i32(call, 0, sum + *(const i32*)user_data) ? FA_RUNTIME_OK : FA_RUNTIME_ERR_TRAP;
+}
+
 static const uint8_t kResultI32[] = { VALTYPE_I32 };
 static const uint8_t kResultI64[] = { VALTYPE_I64 };
 static const uint8_t kResultF32[] = { VALTYPE_F32 };
@@ -948,11 +980,16 @@ static WasmModule* load_module_from_bytes(const uint8_t* bytes, size_t size) {
     return module;
 }
 
+static WasmModule* parse_file_module(WasmModule* module, int load_exports);
+
 static WasmModule* load_module_from_path(const char* path, int load_exports) {
     if (!path) {
         return NULL;
     }
-    WasmModule* module = wasm_module_init(path);
+    return parse_file_module(wasm_module_init(path), load_exports);
+}
+
+static WasmModule* parse_file_module(WasmModule* module, int load_exports) {
     if (!module) {
         return NULL;
     }
@@ -1563,6 +1600,682 @@ static int test_host_import_call(void) {
     return 0;
 }
 
+/* Export and import hash indices: 40 env.fnN imports plus a second env.fn7,
+ * and env.shared imported both as a function and as a memory. Lookups go by
+ * (name, kind), duplicate imports chain in declaration order, and host
+ * functions resolve per import slot whether bound before or after attach,
+ * including after a rebind. */
+static int test_module_name_index(void) {
+    enum { kFnImports = 40 };
+    ByteBuffer imports = {0};
+    char name[16];
+    bb_write_uleb(&imports, kFnImports + 3);
+    for (uint32_t i = 0; i < kFnImports; ++i) {
+        snprintf(name, sizeof(name), "fn%u", i);
+        bb_write_string(&imports, "env");
+        bb_write_string(&imports, name);
+        bb_write_byte(&imports, 0x00);
+        bb_write_uleb(&imports, 0);
+    }
+    bb_write_string(&imports, "env");
+    bb_write_string(&imports, "fn7");
+    bb_write_byte(&imports, 0x00);
+    bb_write_uleb(&imports, 0);
+    bb_write_string(&imports, "env");
+    bb_write_string(&imports, "shared");
+    bb_write_byte(&imports, 0x00);
+    bb_write_uleb(&imports, 0);
+    bb_write_string(&imports, "env");
+    bb_write_string(&imports, "shared");
+    bb_write_byte(&imports, 0x02);
+    bb_write_uleb(&imports, 0x00);
+    bb_write_uleb(&imports, 1);
+
+    /* f42 = fn7'(7, 5) through the duplicate import, f43 = shared(7, 5) */
+    static const uint8_t f_dup[] = { 0x41, 0x07, 0x41, 0x05, 0x10, kFnImports, 0x0B };
+    static const uint8_t f_shared[] = { 0x41, 0x07, 0x41, 0x05, 0x10, kFnImports + 1, 0x0B };
+    const uint8_t* bodies[] = { f_dup, f_shared };
+    const size_t body_sizes[] = { sizeof(f_dup), sizeof(f_shared) };
+    const uint8_t params[] = { VALTYPE_I32, VALTYPE_I32 };
+    ByteBuffer module_bytes = {0};
+    ByteBuffer exports = {0};
+    bb_write_uleb(&exports, 3);
+    bb_write_string(&exports, "run");
+    bb_write_byte(&exports, 0x00);
+    bb_write_uleb(&exports, kFnImports + 2);
+    bb_write_string(&exports, "shared");
+    bb_write_byte(&exports, 0x00);
+    bb_write_uleb(&exports, kFnImports + 3);
+    bb_write_string(&exports, "mem");
+    bb_write_byte(&exports, 0x02);
+    bb_write_uleb(&exports, 0);
+    const int built = build_module_with_locals(&module_bytes, bodies, body_sizes, NULL, NULL, 2, &imports,
+                                               NULL, 0, 0, 0, 0, kResultI32, 1, params, 2) &&
+                      append_section(&module_bytes, SECTION_EXPORT, &exports);
+    bb_free(&imports);
+    bb_free(&exports);
+    WasmModule* module = built ? load_module_from_bytes(module_bytes.data, module_bytes.size) : NULL;
+    if (!module || wasm_load_exports(module) != 0) {
+        wasm_module_free(module);
+        bb_free(&module_bytes);
+        return 1;
+    }
+
+    int failed = 0;
+    const WasmExport* run = wasm_module_find_export(module, "run", WASM_EXTERNAL_FUNCTION);
+    const WasmExport* mem = wasm_module_find_export(module, "mem", WASM_EXTERNAL_MEMORY);
+    failed = failed || !run || run->index != kFnImports + 2 || !mem || mem->index != 0 ||
+             wasm_module_find_export(module, "run", WASM_EXTERNAL_MEMORY) != NULL ||
+             wasm_module_find_export(module, "mem", WASM_EXTERNAL_FUNCTION) != NULL ||
+             wasm_module_find_export(module, "missing", WASM_EXTERNAL_FUNCTION) != NULL;
+    failed = failed || module->num_imports != kFnImports + 3;
+    for (uint32_t i = 0; i < kFnImports && !failed; ++i) {
+        snprintf(name, sizeof(name), "fn%u", i);
+        const WasmImport* import = wasm_module_find_import(module, "env", name, WASM_EXTERNAL_FUNCTION);
+        failed = !import || import->index != i;
+    }
+    const WasmImport* fn7 = wasm_module_find_import(module, "env", "fn7", WASM_EXTERNAL_FUNCTION);
+    const WasmImport* fn7_dup = wasm_module_next_import(module, fn7);
+    failed = failed || !fn7_dup || fn7_dup->index != kFnImports || wasm_module_next_import(module, fn7_dup) != NULL;
+    const WasmImport* shared_fn = wasm_module_find_import(module, "env", "shared", WASM_EXTERNAL_FUNCTION);
+    const WasmImport* shared_mem = wasm_module_find_import(module, "env", "shared", WASM_EXTERNAL_MEMORY);
+    failed = failed || !shared_fn || shared_fn->index != kFnImports + 1 || !shared_mem || shared_mem->index != 0 ||
+             wasm_module_next_import(module, shared_fn) != NULL ||
+             wasm_module_find_import(module, "env", "shared", WASM_EXTERNAL_TABLE) != NULL ||
+             wasm_module_find_import(module, "env", "fn40", WASM_EXTERNAL_FUNCTION) != NULL ||
+             wasm_module_find_import(module, "nv", "efn7", WASM_EXTERNAL_FUNCTION) != NULL;
+
+    fa_Runtime* runtime = failed ? NULL : fa_Runtime_init();
+    fa_Job* job = NULL;
+    uint8_t* memory_data = (uint8_t*)calloc(1, FA_WASM_PAGE_SIZE);
+    i32 offsets[kFnImports + 2];
+    for (uint32_t i = 0; i < kFnImports + 2; ++i) {
+        offsets[i] = (i32)(i * 100U);
+    }
+    fa_RuntimeHostMemory host_memory = {0};
+    host_memory.data = memory_data;
+    host_memory.size_bytes = FA_WASM_PAGE_SIZE;
+    failed = failed || !runtime || !memory_data ||
+             fa_Runtime_bindImportedMemory(runtime, "env", "shared", &host_memory) != FA_RUNTIME_OK ||
+             fa_Runtime_bindHostFunction(runtime, "env", "shared", host_add_offset, &offsets[kFnImports]) !=
+                 FA_RUNTIME_OK ||
+             fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK;
+    for (uint32_t i = 0; i < kFnImports && !failed; ++i) {
+        snprintf(name, sizeof(name), "fn%u", i);
+        failed = fa_Runtime_bindHostFunction(runtime, "env", name, host_add_offset, &offsets[i]) != FA_RUNTIME_OK;
+    }
+    /* A name the module does not import still binds (and stays unused). */
+    failed = failed ||
+             fa_Runtime_bindHostFunction(runtime, "env", "unused", host_add_offset, &offsets[0]) != FA_RUNTIME_OK;
+    job = failed ? NULL : fa_Runtime_createJob(runtime);
+    failed = failed || !job || !execute_expect_i32(runtime, job, kFnImports + 2, 712) ||
+             !execute_expect_i32(runtime, job, kFnImports + 3, 4012);
+    /* Rebinding replaces the binding both fn7 slots point at. */
+    failed = failed ||
+             fa_Runtime_bindHostFunction(runtime, "env", "fn7", host_add_offset, &offsets[kFnImports + 1]) !=
+                 FA_RUNTIME_OK ||
+             runtime->host_binding_count != kFnImports + 2 ||
+             !execute_expect_i32(runtime, job, kFnImports + 2, 4112);
+    failed = failed || runtime->memories_count == 0 || runtime->memories[0].data != memory_data;
+
+    if (runtime && job) {
+        (void)fa_Runtime_destroyJob(runtime, job);
+    }
+    fa_Runtime_free(runtime);
+    free(memory_data);
+    wasm_module_free(module);
+    bb_free(&module_bytes);
+    return failed ? 1 : 0;
+}
+
+static int test_module_metadata_arena(void) {
+    enum { kFnImports = 64 };
+    ByteBuffer imports = {0};
+    char name[16];
+    bb_write_uleb(&imports, kFnImports + 2);
+    for (uint32_t i = 0; i < kFnImports; ++i) {
+        snprintf(name, sizeof(name), "fn%u", i);
+        bb_write_string(&imports, "env");
+        bb_write_string(&imports, name);
+        bb_write_byte(&imports, 0x00);
+        bb_write_uleb(&imports, 0);
+    }
+    bb_write_string(&imports, "env");
+    bb_write_string(&imports, "fn3");
+    bb_write_byte(&imports, 0x00);
+    bb_write_uleb(&imports, 0);
+    bb_write_string(&imports, "env");
+    bb_write_string(&imports, "mem");
+    bb_write_byte(&imports, 0x02);
+    bb_write_uleb(&imports, 0x00);
+    bb_write_uleb(&imports, 1);
+
+    static const uint8_t body[] = { 0x20, 0x00, 0x0B };
+    const uint8_t* bodies[] = { body };
+    const size_t body_sizes[] = { sizeof(body) };
+    const uint8_t params[] = { VALTYPE_I32, VALTYPE_I64, VALTYPE_F64 };
+    ByteBuffer module_bytes = {0};
+    ByteBuffer exports = {0};
+    bb_write_uleb(&exports, 2);
+    bb_write_string(&exports, "run");
+    bb_write_byte(&exports, 0x00);
+    bb_write_uleb(&exports, kFnImports + 1);
+    bb_write_string(&exports, "mem");
+    bb_write_byte(&exports, 0x02);
+    bb_write_uleb(&exports, 0);
+    const int built = build_module_with_locals(&module_bytes, bodies, body_sizes, NULL, NULL, 1, &imports,
+                                               NULL, 0, 0, 0, 0, kResultI32, 1, params, 3) &&
+                      append_section(&module_bytes, SECTION_EXPORT, &exports);
+    bb_free(&imports);
+    bb_free(&exports);
+    WasmModule* module = built ? load_module_from_bytes(module_bytes.data, module_bytes.size) : NULL;
+    if (!module || wasm_load_exports(module) != 0) {
+        wasm_module_free(module);
+        bb_free(&module_bytes);
+        return 1;
+    }
+
+    /* Every repeated name is one arena string: "env", fn0..fn63, "mem", "run". */
+    const char* env = module->functions[0].import_module;
+    int failed = !env || strcmp(env, "env") != 0 || module->num_functions != kFnImports + 2 ||
+                 module->num_memories != 1 || module->num_exports != 2;
+    for (uint32_t i = 0; i <= kFnImports && !failed; ++i) {
+        snprintf(name, sizeof(name), "fn%u", i == kFnImports ? 3U : i);
+        failed = module->functions[i].import_module != env || !module->functions[i].import_name ||
+                 strcmp(module->functions[i].import_name, name) != 0;
+    }
+    failed = failed || module->functions[kFnImports].import_name != module->functions[3].import_name ||
+             module->memories[0].import_module != env ||
+             module->exports[1].name != module->memories[0].import_name ||
+             strcmp(module->exports[0].name, "run") != 0 || module->arena.num_names != kFnImports + 3;
+
+    /* Valtypes are stored as the bytes the binary encodes them as. */
+    const WasmFunctionType* type = module->num_types == 1 ? &module->types[0] : NULL;
+    failed = failed || !type || type->num_params != 3 || type->num_results != 1 ||
+             memcmp(type->param_types, params, sizeof(params)) != 0 || type->result_types[0] != VALTYPE_I32;
+
+    /* A few hundred names and records fit in a handful of blocks. */
+    failed = failed || module->arena.num_blocks == 0 || module->arena.num_blocks > 4 ||
+             module->arena.bytes == 0;
+
+    wasm_module_free(module);
+    bb_free(&module_bytes);
+    return failed;
+}
+
+static int test_compiled_module_instances(void) {
+    /* f0: mem[0] += 5, returns mem[0]; f1: block (result i32) call f0 end */
+    static const uint8_t f_bump[] = { 0x41, 0x00, 0x41, 0x00, 0x28, 0x02, 0x00, 0x41, 0x05, 0x6A,
+                                      0x36, 0x02, 0x00, 0x41, 0x00, 0x28, 0x02, 0x00, 0x0B };
+    static const uint8_t f_block[] = { 0x02, 0x7F, 0x10, 0x00, 0x0B, 0x0B };
+    const uint8_t* bodies[] = { f_bump, f_block };
+    const size_t body_sizes[] = { sizeof(f_bump), sizeof(f_block) };
+    ByteBuffer module_bytes = {0};
+    const int built = build_module_with_locals(&module_bytes, bodies, body_sizes, NULL, NULL, 2, NULL, NULL,
+                                               1, 1, 0, 0, kResultI32, 1, NULL, 0);
+    WasmModule* module = built ? load_module_from_bytes(module_bytes.data, module_bytes.size) : NULL;
+    fa_CompiledModule* compiled = module ? fa_CompiledModule_create(module) : NULL;
+    if (!compiled) {
+        wasm_module_free(module);
+        bb_free(&module_bytes);
+        return 1;
+    }
+
+    fa_Instance* a = fa_Instance_create(compiled);
+    fa_Instance* b = fa_Instance_create(compiled);
+    fa_Job* job_a = a ? fa_Runtime_createJob(a) : NULL;
+    fa_Job* job_b = b ? fa_Runtime_createJob(b) : NULL;
+    int failed = !job_a || !job_b || fa_CompiledModule_module(compiled) != module ||
+                 a->module != module || b->module != module;
+    /* Code is shared, state is not: each instance has its own memory. */
+    failed = failed || !a->jit_cache_prescanned || a->jit_prescan_blocks != 1 ||
+             a->jit_prescan_programs != b->jit_prescan_programs || a->memories_count != 1 ||
+             a->memories[0].data == b->memories[0].data;
+    failed = failed || !execute_expect_i32(a, job_a, 1, 5) || !execute_expect_i32(a, job_a, 1, 10) ||
+             !execute_expect_i32(b, job_b, 1, 5);
+
+    /* The instances keep the compiled module (and the module) alive. */
+    fa_CompiledModule_release(compiled);
+    failed = failed || !execute_expect_i32(b, job_b, 0, 10) || !execute_expect_i32(a, job_a, 0, 15);
+    if (a && job_a) {
+        (void)fa_Runtime_destroyJob(a, job_a);
+    }
+    fa_Instance_free(a);
+
+    /* Re-attaching swaps the reference without disturbing the other instance. */
+    fa_CompiledModule* again = fa_CompiledModule_retain(b ? b->compiled : NULL);
+    failed = failed || !again || fa_Runtime_attachCompiled(b, again) != FA_RUNTIME_OK ||
+             !execute_expect_i32(b, job_b, 1, 5);
+    fa_CompiledModule_release(again);
+    if (b && job_b) {
+        (void)fa_Runtime_destroyJob(b, job_b);
+    }
+    fa_Instance_free(b);
+    bb_free(&module_bytes);
+    return failed;
+}
+
+/* type0 () -> i32, type1 () -> i64, type2 () -> i32; f0 (type0) returns
+   call_indirect type0 of table[0] = f1, whose declared type is type2. */
+static int build_bundle_module(ByteBuffer* module_bytes) {
+    static const uint8_t header[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    static const uint8_t caller[] = { 0x00, 0x41, 0x00, 0x11, 0x00, 0x00, 0x0B };
+    static const uint8_t callee[] = { 0x00, 0x02, 0x7F, 0x41, 0x07, 0x0B, 0x0B };
+    ByteBuffer payload = {0};
+    int ok = bb_write_bytes(module_bytes, header, sizeof(header));
+    bb_write_uleb(&payload, 3);
+    for (uint32_t i = 0; i < 3; ++i) {
+        bb_write_byte(&payload, 0x60);
+        bb_write_uleb(&payload, 0);
+        bb_write_uleb(&payload, 1);
+        bb_write_byte(&payload, i == 1 ? VALTYPE_I64 : VALTYPE_I32);
+    }
+    ok = ok && append_section(module_bytes, SECTION_TYPE, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 2);
+    bb_write_uleb(&payload, 0);
+    bb_write_uleb(&payload, 2);
+    ok = ok && append_section(module_bytes, SECTION_FUNCTION, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 1);
+    bb_write_byte(&payload, VALTYPE_FUNCREF);
+    bb_write_uleb(&payload, 0);
+    bb_write_uleb(&payload, 1);
+    ok = ok && append_section(module_bytes, SECTION_TABLE, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 1);
+    bb_write_uleb(&payload, 0);
+    bb_write_byte(&payload, 0x41);
+    bb_write_sleb32(&payload, 0);
+    bb_write_byte(&payload, 0x0B);
+    bb_write_uleb(&payload, 1);
+    bb_write_uleb(&payload, 1);
+    ok = ok && append_section(module_bytes, SECTION_ELEMENT, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 2);
+    bb_write_uleb(&payload, sizeof(caller));
+    bb_write_bytes(&payload, caller, sizeof(caller));
+    bb_write_uleb(&payload, sizeof(callee));
+    bb_write_bytes(&payload, callee, sizeof(callee));
+    ok = ok && append_section(module_bytes, SECTION_CODE, &payload);
+    bb_free(&payload);
+    return ok;
+}
+
+/* Runs f0 on a fresh instance of `compiled` and checks it returns 7. */
+static int bundle_instance_runs(fa_CompiledModule* compiled) {
+    fa_Instance* instance = compiled ? fa_Instance_create(compiled) : NULL;
+    fa_Job* job = instance ? fa_Runtime_createJob(instance) : NULL;
+    const int ok = job && instance->jit_cache_prescanned && instance->jit_prescan_blocks == 1 &&
+                   execute_expect_i32(instance, job, 0, 7);
+    if (job) {
+        (void)fa_Runtime_destroyJob(instance, job);
+    }
+    fa_Instance_free(instance);
+    return ok;
+}
+
+/* Offset of function `index`'s record in `bundle` (layout in fa_runtime.h). */
+static size_t bundle_record_at(const uint8_t* bundle, uint32_t index) {
+    const uint8_t* header = bundle + FA_SPILL_HEADER_BYTES;
+    size_t at = FA_SPILL_HEADER_BYTES + 80u + ((fa_spill_get_u32(header + 40) + 3u) & ~3u);
+    for (uint32_t i = 0; i < index; ++i) {
+        const uint32_t count = fa_spill_get_u32(bundle + at);
+        at += 20u + (size_t)count * 4u + (size_t)fa_spill_get_u32(bundle + at + 4) * 4u +
+              (size_t)fa_spill_get_u32(bundle + at + 8) * 12u + ((count + 3u) & ~3u);
+    }
+    return at;
+}
+
+/* Recomputes the record digest after a deliberate edit, so only the
+   structural checks stand between the record and the loader. */
+static void bundle_reseal(uint8_t* bundle, size_t size) {
+    uint8_t* header = bundle + FA_SPILL_HEADER_BYTES;
+    const size_t records = FA_SPILL_HEADER_BYTES + 80u + fa_spill_get_u32(header + 40);
+    fa_sha256(bundle + records, size - records, header + 48);
+}
+
+static int test_module_bundle(void) {
+    ByteBuffer module_bytes = {0};
+    WasmModule* module = build_bundle_module(&module_bytes)
+                             ? load_module_from_bytes(module_bytes.data, module_bytes.size)
+                             : NULL;
+    /* Structurally equal types share a canonical index; call_indirect
+       compares those, so type2's f1 satisfies a type0 call. */
+    int failed = !module || module->num_types != 3 || module->types[0].canonical_index != 0 ||
+                 module->types[1].canonical_index != 1 || module->types[2].canonical_index != 0;
+    fa_CompiledModule* compiled = failed ? NULL : fa_CompiledModule_create(module);
+    if (!compiled) {
+        wasm_module_free(module);
+        bb_free(&module_bytes);
+        return 1;
+    }
+    failed = !bundle_instance_runs(compiled);
+
+    const size_t size = fa_CompiledModule_bundleSize(compiled);
+    uint32_t* storage = size ? (uint32_t*)calloc(size / 4u + 2u, sizeof(uint32_t)) : NULL;
+    uint8_t* bundle = (uint8_t*)storage;
+    size_t written = 0;
+    failed = failed || !storage || !fa_CompiledModule_writeBundle(compiled, bundle, size, &written) ||
+             written != size || size % 4u != 0 || fa_CompiledModule_writeBundle(compiled, bundle, size - 1u, NULL);
+
+    /* Opened in place: the module reads its image out of the bundle itself. */
+    fa_CompiledModule* opened = failed ? NULL : fa_CompiledModule_openBundle(bundle, size);
+    const WasmModule* reopened = fa_CompiledModule_module(opened);
+    fa_Instance* instance = opened ? fa_Instance_create(opened) : NULL;
+    failed = failed || !instance || !reopened || reopened->buffer < bundle ||
+             reopened->buffer >= bundle + size || reopened->types[2].canonical_index != 0 ||
+             !reopened->content_digest_valid || !module->content_digest_valid ||
+             memcmp(reopened->content_digest, module->content_digest, FA_SHA256_BYTES) != 0;
+    fa_Instance_free(instance);
+    failed = failed || !bundle_instance_runs(opened);
+    /* Re-bundling what was opened reproduces the bundle byte for byte. */
+    uint8_t* again = failed ? NULL : (uint8_t*)malloc(size);
+    failed = failed || !again || fa_CompiledModule_bundleSize(opened) != size ||
+             !fa_CompiledModule_writeBundle(opened, again, size, NULL) || memcmp(again, bundle, size) != 0;
+    free(again);
+    fa_CompiledModule_release(opened);
+
+    /* A misaligned copy decodes into private tables instead. */
+    if (!failed) {
+        memmove(bundle + 1, bundle, size);
+        opened = fa_CompiledModule_openBundle(bundle + 1, size);
+        failed = !bundle_instance_runs(opened);
+        fa_CompiledModule_release(opened);
+        memmove(bundle, bundle + 1, size);
+    }
+
+    /* Any flipped bit in the body, a different ABI or a claimed module digest
+       other than the image's own is rejected. */
+    if (!failed) {
+        bundle[size - 1u] ^= 0x01u;
+        failed = fa_CompiledModule_openBundle(bundle, size) != NULL;
+        bundle[size - 1u] ^= 0x01u;
+        bundle[FA_SPILL_HEADER_BYTES + 32u] ^= 0x01u;
+        failed = failed || fa_CompiledModule_openBundle(bundle, size) != NULL;
+        bundle[FA_SPILL_HEADER_BYTES + 32u] ^= 0x01u;
+        bundle[FA_SPILL_HEADER_BYTES + 0u] ^= 0x01u;
+        failed = failed || fa_CompiledModule_openBundle(bundle, size) != NULL;
+        bundle[FA_SPILL_HEADER_BYTES + 0u] ^= 0x01u;
+        failed = failed || fa_CompiledModule_openBundle(bundle, size - 4u) != NULL;
+    }
+
+    /* Resealed records that disagree with their bodies are rejected too: an
+       unscanned defined function, an opcode pc past the body, a pc map entry
+       past the opcodes, an end pc past the body and a block that ends where
+       it starts. */
+    uint32_t* tampered_storage = failed ? NULL : (uint32_t*)calloc(size / 4u + 1u, sizeof(uint32_t));
+    uint8_t* tampered = (uint8_t*)tampered_storage;
+    failed = failed || !tampered;
+    const size_t f0 = failed ? 0 : bundle_record_at(bundle, 0);
+    const size_t f1 = failed ? 0 : bundle_record_at(bundle, 1);
+    const uint32_t f0_count = failed ? 0 : fa_spill_get_u32(bundle + f0);
+    const uint32_t f1_count = failed ? 0 : fa_spill_get_u32(bundle + f1);
+    const uint32_t f1_pc_len = failed ? 0 : fa_spill_get_u32(bundle + f1 + 4);
+    const size_t f1_blocks = f1 + 20u + (size_t)f1_count * 4u + (size_t)f1_pc_len * 4u;
+    failed = failed || f0_count == 0 || fa_spill_get_u32(bundle + f1 + 8) != 1u;
+    for (int edit = 0; !failed && edit < 5; ++edit) {
+        memcpy(tampered, bundle, size);
+        switch (edit) {
+            case 0: fa_spill_put_u32(tampered + f0 + 16, 0u); break;
+            case 1: fa_spill_put_u32(tampered + f0 + 20 + (f0_count - 1u) * 4u, 0xFFFFu); break;
+            case 2: fa_spill_put_u32(tampered + f0 + 20 + f0_count * 4u, f0_count); break;
+            case 3: fa_spill_put_u32(tampered + f1_blocks + 8u, 0xFFFFu); break;
+            default: fa_spill_put_u32(tampered + f1_blocks + 0u, fa_spill_get_u32(bundle + f1_blocks + 8u)); break;
+        }
+        bundle_reseal(tampered, size);
+        fa_CompiledModule* rejected = fa_CompiledModule_openBundle(tampered, size);
+        if (rejected) {
+            printf("bundle: tampered record %d accepted\n", edit);
+            fa_CompiledModule_release(rejected);
+            failed = 1;
+        }
+    }
+    /* The resealing itself is sound: an untouched copy still opens. */
+    if (!failed) {
+        memcpy(tampered, bundle, size);
+        bundle_reseal(tampered, size);
+        opened = fa_CompiledModule_openBundle(tampered, size);
+        failed = !bundle_instance_runs(opened);
+        fa_CompiledModule_release(opened);
+    }
+    free(tampered_storage);
+
+    /* Saved to disk and mapped back, it outlives the original compiled module. */
+    const char* path = "fayasm_test_module_bundle.fyb";
+    failed = failed || fa_CompiledModule_saveBundle(compiled, path) != FA_RUNTIME_OK;
+    fa_CompiledModule_release(compiled);
+    fa_CompiledModule* loaded = failed ? NULL : fa_CompiledModule_loadBundle(path);
+    failed = failed || !bundle_instance_runs(loaded) || fa_CompiledModule_loadBundle("fayasm_missing.fyb") != NULL;
+    fa_CompiledModule_release(loaded);
+    (void)remove(path);
+    free(storage);
+    bb_free(&module_bytes);
+    return failed;
+}
+
+/* type0 () -> (), type1 () -> i32. f0 (type0) is the start function, f1
+   (type1) returns mem[0]; table[1] = f1, data "abcd" at 8 and "wxyz" at
+   `second_offset`. The memory is imported as env.mem when `import_memory`. */
+static int build_start_module(ByteBuffer* module_bytes,
+                              int import_memory,
+                              uint32_t start_index,
+                              const uint8_t* start_body,
+                              size_t start_size,
+                              uint32_t second_offset) {
+    static const uint8_t header[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    static const uint8_t load[] = { 0x00, 0x41, 0x00, 0x28, 0x02, 0x00, 0x0B };
+    ByteBuffer payload = {0};
+    int ok = bb_write_bytes(module_bytes, header, sizeof(header));
+    bb_write_uleb(&payload, 2);
+    bb_write_byte(&payload, 0x60);
+    bb_write_uleb(&payload, 0);
+    bb_write_uleb(&payload, 0);
+    bb_write_byte(&payload, 0x60);
+    bb_write_uleb(&payload, 0);
+    bb_write_uleb(&payload, 1);
+    bb_write_byte(&payload, VALTYPE_I32);
+    ok = ok && append_section(module_bytes, SECTION_TYPE, &payload);
+    if (import_memory) {
+        bb_reset(&payload);
+        bb_write_uleb(&payload, 1);
+        bb_write_string(&payload, "env");
+        bb_write_string(&payload, "mem");
+        bb_write_byte(&payload, 0x02);
+        bb_write_uleb(&payload, 0x00);
+        bb_write_uleb(&payload, 1);
+        ok = ok && append_section(module_bytes, SECTION_IMPORT, &payload);
+    }
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 2);
+    bb_write_uleb(&payload, 0);
+    bb_write_uleb(&payload, 1);
+    ok = ok && append_section(module_bytes, SECTION_FUNCTION, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 1);
+    bb_write_byte(&payload, VALTYPE_FUNCREF);
+    bb_write_uleb(&payload, 0);
+    bb_write_uleb(&payload, 2);
+    ok = ok && append_section(module_bytes, SECTION_TABLE, &payload);
+    if (!import_memory) {
+        bb_reset(&payload);
+        bb_write_uleb(&payload, 1);
+        bb_write_uleb(&payload, 0x00);
+        bb_write_uleb(&payload, 1);
+        ok = ok && append_section(module_bytes, SECTION_MEMORY, &payload);
+    }
+    bb_reset(&payload);
+    bb_write_uleb(&payload, start_index);
+    ok = ok && append_section(module_bytes, SECTION_START, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 1);
+    bb_write_uleb(&payload, 0);
+    bb_write_byte(&payload, 0x41);
+    bb_write_sleb32(&payload, 1);
+    bb_write_byte(&payload, 0x0B);
+    bb_write_uleb(&payload, 1);
+    bb_write_uleb(&payload, 1);
+    ok = ok && append_section(module_bytes, SECTION_ELEMENT, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 2);
+    bb_write_uleb(&payload, (uint32_t)start_size + 1U);
+    bb_write_uleb(&payload, 0);
+    bb_write_bytes(&payload, start_body, start_size);
+    bb_write_uleb(&payload, sizeof(load));
+    bb_write_bytes(&payload, load, sizeof(load));
+    ok = ok && append_section(module_bytes, SECTION_CODE, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 2);
+    const uint32_t offsets[] = { 8U, second_offset };
+    const char* bytes[] = { "abcd", "wxyz" };
+    for (uint32_t i = 0; i < 2; ++i) {
+        bb_write_uleb(&payload, 0);
+        bb_write_byte(&payload, 0x41);
+        bb_write_sleb32(&payload, (int32_t)offsets[i]);
+        bb_write_byte(&payload, 0x0B);
+        bb_write_uleb(&payload, 4);
+        bb_write_bytes(&payload, (const uint8_t*)bytes[i], 4);
+    }
+    ok = ok && append_section(module_bytes, SECTION_DATA, &payload);
+    bb_free(&payload);
+    return ok;
+}
+
+/* Instantiation: active segments are range-checked as a batch before any is
+   applied, then the start function runs last and a trap in it fails the
+   attach. */
+static int test_instantiation_pipeline(void) {
+    static const uint8_t store_42[] = { 0x41, 0x00, 0x41, 0x2A, 0x36, 0x02, 0x00, 0x0B };
+    static const uint8_t trap[] = { 0x00, 0x0B };
+    ByteBuffer module_bytes = {0};
+    WasmModule* module = build_start_module(&module_bytes, 0, 0, store_42, sizeof(store_42), 16U)
+                             ? load_module_from_bytes(module_bytes.data, module_bytes.size)
+                             : NULL;
+    fa_Runtime* runtime = module ? fa_Runtime_init() : NULL;
+    fa_Job* job = NULL;
+    int failed = !runtime || !module->has_start || module->start_function != 0 ||
+                 fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK ||
+                 (job = fa_Runtime_createJob(runtime)) == NULL;
+    /* The start function ran after the data segments were copied in. */
+    failed = failed || runtime->memories_count != 1 || memcmp(runtime->memories[0].data + 8, "abcd", 4) != 0 ||
+             memcmp(runtime->memories[0].data + 16, "wxyz", 4) != 0 || runtime->tables_count != 1 ||
+             runtime->tables[0].data[0] != 0 || runtime->tables[0].data[1] == 0 ||
+             !execute_expect_i32(runtime, job, 1, 42);
+    if (job) {
+        (void)fa_Runtime_destroyJob(runtime, job);
+    }
+    fa_Runtime_free(runtime);
+    wasm_module_free(module);
+    bb_free(&module_bytes);
+
+    /* The second segment is out of range: nothing is written to the host
+       memory, not even the first segment, and start never runs. */
+    uint8_t* host_bytes = failed ? NULL : (uint8_t*)calloc(FA_WASM_PAGE_SIZE, 1);
+    module = host_bytes && build_start_module(&module_bytes, 1, 0, store_42, sizeof(store_42),
+                                              FA_WASM_PAGE_SIZE - 2U)
+                 ? load_module_from_bytes(module_bytes.data, module_bytes.size)
+                 : NULL;
+    runtime = module ? fa_Runtime_init() : NULL;
+    fa_RuntimeHostMemory host_memory = {0};
+    host_memory.data = host_bytes;
+    host_memory.size_bytes = FA_WASM_PAGE_SIZE;
+    failed = !runtime || fa_Runtime_bindImportedMemory(runtime, "env", "mem", &host_memory) != FA_RUNTIME_OK ||
+             fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_ERR_TRAP || runtime->module != NULL;
+    for (size_t i = 0; i < FA_WASM_PAGE_SIZE && !failed; ++i) {
+        failed = host_bytes[i] != 0;
+    }
+    fa_Runtime_free(runtime);
+    wasm_module_free(module);
+    bb_free(&module_bytes);
+    free(host_bytes);
+
+    /* A trapping start function fails the instantiation. */
+    module = !failed && build_start_module(&module_bytes, 0, 0, trap, sizeof(trap), 16U)
+                 ? load_module_from_bytes(module_bytes.data, module_bytes.size)
+                 : NULL;
+    runtime = module ? fa_Runtime_init() : NULL;
+    failed = !runtime || fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_ERR_TRAP ||
+             runtime->module != NULL || runtime->memories_count != 0;
+    fa_Runtime_free(runtime);
+    wasm_module_free(module);
+    bb_free(&module_bytes);
+
+    /* The start function must exist and take and return nothing. */
+    for (uint32_t start_index = 1; start_index <= 2 && !failed; ++start_index) {
+        module = build_start_module(&module_bytes, 0, start_index, store_42, sizeof(store_42), 16U)
+                     ? load_module_from_bytes(module_bytes.data, module_bytes.size)
+                     : NULL;
+        failed = module != NULL || module_bytes.size == 0;
+        wasm_module_free(module);
+        bb_free(&module_bytes);
+    }
+    return failed;
+}
+
+static int host_count_calls(fa_Runtime* runtime, const fa_RuntimeHostCall* call, void* user_data) {
+    (void)runtime;
+    if (!fa_RuntimeHostCall_expect(call, 0, 0) || !user_data) {
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    *(int*)user_data += 1;
+    return FA_RUNTIME_OK;
+}
+
+/* The start function runs inside attach, so an import it calls has to be
+ * bound first: bound beforehand it runs on every attach, left unbound the
+ * attach fails (and binding then attaching again recovers). */
+static int test_start_calls_host_import(void) {
+    static const uint8_t header[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    static const uint8_t start_body[] = { 0x00, 0x10, 0x00, 0x0B };
+    ByteBuffer module_bytes = {0};
+    ByteBuffer payload = {0};
+    int ok = bb_write_bytes(&module_bytes, header, sizeof(header));
+    bb_write_uleb(&payload, 1);
+    bb_write_byte(&payload, 0x60);
+    bb_write_uleb(&payload, 0);
+    bb_write_uleb(&payload, 0);
+    ok = ok && append_section(&module_bytes, SECTION_TYPE, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 1);
+    bb_write_string(&payload, "env");
+    bb_write_string(&payload, "ping");
+    bb_write_byte(&payload, 0x00);
+    bb_write_uleb(&payload, 0);
+    ok = ok && append_section(&module_bytes, SECTION_IMPORT, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 1);
+    bb_write_uleb(&payload, 0);
+    ok = ok && append_section(&module_bytes, SECTION_FUNCTION, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 1);
+    ok = ok && append_section(&module_bytes, SECTION_START, &payload);
+    bb_reset(&payload);
+    bb_write_uleb(&payload, 1);
+    bb_write_uleb(&payload, sizeof(start_body));
+    bb_write_bytes(&payload, start_body, sizeof(start_body));
+    ok = ok && append_section(&module_bytes, SECTION_CODE, &payload);
+    bb_free(&payload);
+
+    WasmModule* module = ok ? load_module_from_bytes(module_bytes.data, module_bytes.size) : NULL;
+    int calls = 0;
+    fa_Runtime* runtime = module ? fa_Runtime_init() : NULL;
+    int failed = !runtime || !module->has_start ||
+                 fa_Runtime_bindHostFunction(runtime, "env", "ping", host_count_calls, &calls) != FA_RUNTIME_OK ||
+                 fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK || calls != 1 ||
+                 fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK || calls != 2;
+    fa_Runtime_free(runtime);
+
+    runtime = failed ? NULL : fa_Runtime_init();
+    failed = failed || !runtime || fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_ERR_TRAP ||
+             runtime->module != NULL ||
+             fa_Runtime_bindHostFunction(runtime, "env", "ping", host_count_calls, &calls) != FA_RUNTIME_OK ||
+             fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK || calls != 3;
+    fa_Runtime_free(runtime);
+    wasm_module_free(module);
+    bb_free(&module_bytes);
+    return failed;
+}
+
 static int test_imported_memory_binding(void) {
     ByteBuffer imports = {0};
     if (!bb_write_uleb(&imports, 1)) {
@@ -2425,6 +3138,102 @@ static int test_jit_eviction_trap_reload_cycles(void) {
     return 0;
 }
 
+/* Churn workload for the eviction policies: a hot f0 called between one-shot
+ * calls to four cold functions, with programs sized so only three fit in the
+ * 64 KiB minimum budget (3.5 programs' worth of prepared ops). With spill
+ * hooks the churn shows up as spill/load traffic, without them as programs
+ * rebuilt after eviction. */
+static int jit_churn_run(fa_JitEvictionPolicy policy, OffloadState* state, uint64_t* reprepares_out) {
+    ByteBuffer bodies_bytes[5];
+    const uint8_t* bodies[5];
+    size_t sizes[5];
+    const int const_drop_pairs = (int)((65536U * 2U / (7U * sizeof(fa_JitPreparedOp)) - 2U) / 2U);
+    int ok = 1;
+    for (int f = 0; f < 5; ++f) {
+        memset(&bodies_bytes[f], 0, sizeof(bodies_bytes[f]));
+        for (int i = 0; i < const_drop_pairs && ok; ++i) {
+            ok = bb_write_byte(&bodies_bytes[f], 0x41) && bb_write_sleb32(&bodies_bytes[f], 0) &&
+                 bb_write_byte(&bodies_bytes[f], 0x1A);
+        }
+        ok = ok && bb_write_byte(&bodies_bytes[f], 0x41) && bb_write_sleb32(&bodies_bytes[f], 100 + f) &&
+             bb_write_byte(&bodies_bytes[f], 0x0B);
+        bodies[f] = bodies_bytes[f].data;
+        sizes[f] = bodies_bytes[f].size;
+    }
+    ByteBuffer module_bytes = {0};
+    ok = ok && build_module(&module_bytes, bodies, sizes, 5, 0, 0, 0, 0, kResultI32, 1, NULL, 0);
+    for (int f = 0; f < 5; ++f) {
+        bb_free(&bodies_bytes[f]);
+    }
+    fa_Runtime* runtime = NULL;
+    fa_Job* job = NULL;
+    WasmModule* module = NULL;
+    if (!ok || !run_job(&module_bytes, &runtime, &job, &module)) {
+        bb_free(&module_bytes);
+        return 0;
+    }
+    runtime->jit_context.config.min_ram_bytes = 0;
+    runtime->jit_context.config.min_cpu_count = 1;
+    runtime->jit_context.config.min_hot_loop_hits = 0;
+    runtime->jit_context.config.min_executed_ops = 1;
+    runtime->jit_context.config.min_advantage_score = 0.0f;
+    runtime->jit_context.config.max_cache_percent = 0;
+    runtime->jit_context.config.max_ops_per_chunk = 0;
+    runtime->jit_context.config.max_chunks = 0;
+    runtime->jit_context.config.eviction_policy = policy;
+    if (state) {
+        fa_RuntimeSpillHooks spill_hooks = { offload_jit_spill_hook, offload_jit_load_hook, NULL, NULL, state };
+        fa_Runtime_setSpillHooks(runtime, &spill_hooks);
+    }
+    for (int round = 0; round < 16 && ok; ++round) {
+        const uint32_t cold = 1U + (uint32_t)(round % 4);
+        ok = execute_expect_i32(runtime, job, 0, 100) && execute_expect_i32(runtime, job, cold, 100 + (i32)cold);
+    }
+    if (ok && runtime->jit_cache_bytes > (size_t)runtime->jit_context.decision.budget.cache_budget_bytes) {
+        ok = 0;
+    }
+    *reprepares_out = runtime->jit_cache_reprepares;
+    cleanup_job(runtime, job, module, &module_bytes, NULL);
+    return ok;
+}
+
+static int test_jit_eviction_policy_churn(void) {
+    test_set_env("FAYASM_MICROCODE", "1");
+    if (!fa_ops_microcode_enabled()) {
+        return 1;
+    }
+    static const fa_JitEvictionPolicy policies[] = { FA_JIT_EVICT_ROUND_ROBIN, FA_JIT_EVICT_LFU, FA_JIT_EVICT_CLOCK };
+    OffloadState states[3];
+    uint64_t hooked_reprepares[3] = { 0, 0, 0 };
+    uint64_t reprepares[3] = { 0, 0, 0 };
+    int failed = 0;
+    memset(states, 0, sizeof(states));
+    for (int p = 0; p < 3 && !failed; ++p) {
+        if (!jit_churn_run(policies[p], &states[p], &hooked_reprepares[p]) ||
+            !jit_churn_run(policies[p], NULL, &reprepares[p])) {
+            failed = 1;
+        }
+    }
+    if (!failed) {
+        const int rr_churn = states[0].jit_spill_calls + states[0].jit_load_calls;
+        const int lfu_churn = states[1].jit_spill_calls + states[1].jit_load_calls;
+        const int clock_churn = states[2].jit_spill_calls + states[2].jit_load_calls;
+        /* Round-robin spills the hot function; LFU and CLOCK keep it resident. */
+        if (!states[0].jit_blobs[0].opcodes || states[1].jit_blobs[0].opcodes || states[2].jit_blobs[0].opcodes ||
+            lfu_churn >= rr_churn || clock_churn >= rr_churn ||
+            reprepares[1] >= reprepares[0] || reprepares[2] >= reprepares[0]) {
+            printf("eviction churn: spill+load rr=%d lfu=%d clock=%d, reprepares rr=%llu lfu=%llu clock=%llu\n",
+                   rr_churn, lfu_churn, clock_churn, (unsigned long long)reprepares[0],
+                   (unsigned long long)reprepares[1], (unsigned long long)reprepares[2]);
+            failed = 1;
+        }
+    }
+    for (int p = 0; p < 3; ++p) {
+        offload_state_free(&states[p]);
+    }
+    return failed;
+}
+
 /* Validates offload of grown memory: memory.grow extends the page set, then a
  * repeated spill/load cycle (driven through the explicit fa_Runtime_loadMemory
  * API) must preserve the full grown region byte-for-byte across iterations.
@@ -2685,25 +3494,205 @@ static int test_spill_envelope_memory_roundtrip(void) {
     return 0;
 }
 
-static int run_wasm_sample_export_i32(const char* sample_name,
-                                      const char* test_name,
-                                      const char* const* exports,
-                                      size_t export_count,
-                                      i32 expected);
+#define TEST_PAGED_PAGE_BYTES 4096U
+#define TEST_PAGED_PAGE_COUNT (FA_WASM_PAGE_SIZE / TEST_PAGED_PAGE_BYTES)
 
-static int test_wasm_sample_arithmetic(void) {
-    const char* exports[] = { "sample_const42", "_sample_const42" };
-    return run_wasm_sample_export_i32("arithmetic.wasm",
-                                      "test_wasm_sample_arithmetic",
-                                      exports,
-                                      sizeof(exports) / sizeof(exports[0]),
-                                      42);
+typedef struct {
+    uint8_t pages[TEST_PAGED_PAGE_COUNT][TEST_PAGED_PAGE_BYTES];
+    uint8_t stored[TEST_PAGED_PAGE_COUNT];
+    int spill_calls;
+    int load_calls;
+} PagedBackingState;
+
+static int paged_page_spill_hook(fa_Runtime* runtime,
+                                 uint32_t memory_index,
+                                 uint64_t page_index,
+                                 const uint8_t* data,
+                                 uint32_t page_bytes,
+                                 void* user_data) {
+    (void)runtime;
+    (void)memory_index;
+    PagedBackingState* state = (PagedBackingState*)user_data;
+    if (!state || !data || page_bytes != TEST_PAGED_PAGE_BYTES || page_index >= TEST_PAGED_PAGE_COUNT) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    memcpy(state->pages[page_index], data, page_bytes);
+    state->stored[page_index] = 1;
+    state->spill_calls += 1;
+    return FA_RUNTIME_OK;
 }
 
-static int test_wasm_sample_arithmetic_mul_add(void) {
-    const char* exports[] = { "sample_mul_add_const", "_sample_mul_add_const" };
-    return run_wasm_sample_export_i32("arithmetic.wasm",
-                                      "test_wasm_sample_arithmetic_mul_add",
+static int paged_page_load_hook(fa_Runtime* runtime,
+                                uint32_t memory_index,
+                                uint64_t page_index,
+                                uint8_t* data_out,
+                                uint32_t page_bytes,
+                                void* user_data) {
+    (void)runtime;
+    (void)memory_index;
+    PagedBackingState* state = (PagedBackingState*)user_data;
+    if (!state || !data_out || page_bytes != TEST_PAGED_PAGE_BYTES || page_index >= TEST_PAGED_PAGE_COUNT) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    if (!state->stored[page_index]) {
+        return FA_RUNTIME_ERR_STREAM;
+    }
+    memcpy(data_out, state->pages[page_index], page_bytes);
+    state->load_calls += 1;
+    return FA_RUNTIME_OK;
+}
+
+static void emit_i32_store_const(ByteBuffer* instructions, int32_t addr, int32_t value) {
+    bb_write_byte(instructions, 0x41);
+    bb_write_sleb32(instructions, addr);
+    bb_write_byte(instructions, 0x41);
+    bb_write_sleb32(instructions, value);
+    bb_write_byte(instructions, 0x36);
+    bb_write_uleb(instructions, 2);
+    bb_write_uleb(instructions, 0);
+}
+
+static void emit_i32_load_const(ByteBuffer* instructions, int32_t addr) {
+    bb_write_byte(instructions, 0x41);
+    bb_write_sleb32(instructions, addr);
+    bb_write_byte(instructions, 0x28);
+    bb_write_uleb(instructions, 2);
+    bb_write_uleb(instructions, 0);
+}
+
+static int test_memory_paged_demand_faults(void) {
+    const int32_t page = (int32_t)TEST_PAGED_PAGE_BYTES;
+    ByteBuffer instructions = {0};
+    /* Touch four pages with only two resident frames, forcing CLOCK evictions. */
+    emit_i32_store_const(&instructions, 0, 11);
+    emit_i32_store_const(&instructions, 3 * page, 22);
+    emit_i32_store_const(&instructions, 7 * page, 33);
+    emit_i32_store_const(&instructions, 12 * page, 44);
+    /* memory.fill(4090, 7, 12) straddles the page 0/1 boundary. */
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, page - 6);
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 7);
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 12);
+    bb_write_byte(&instructions, 0xFC);
+    bb_write_uleb(&instructions, 11);
+    bb_write_uleb(&instructions, 0);
+    /* memory.copy(9 * page - 4, 4090, 8) lands across the page 8/9 boundary. */
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 9 * page - 4);
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, page - 6);
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 8);
+    bb_write_byte(&instructions, 0xFC);
+    bb_write_uleb(&instructions, 10);
+    bb_write_uleb(&instructions, 0);
+    bb_write_uleb(&instructions, 0);
+    /* Sum everything back; spilled pages must fault in through page_load. */
+    emit_i32_load_const(&instructions, 0);
+    emit_i32_load_const(&instructions, 3 * page);
+    bb_write_byte(&instructions, 0x6A);
+    emit_i32_load_const(&instructions, 7 * page);
+    bb_write_byte(&instructions, 0x6A);
+    emit_i32_load_const(&instructions, 12 * page);
+    bb_write_byte(&instructions, 0x6A);
+    emit_i32_load_const(&instructions, page - 4);
+    bb_write_byte(&instructions, 0x6A);
+    emit_i32_load_const(&instructions, 9 * page);
+    bb_write_byte(&instructions, 0x6A);
+    bb_write_byte(&instructions, 0x0B);
+
+    const uint8_t* bodies[] = { instructions.data };
+    const size_t sizes[] = { instructions.size };
+    ByteBuffer module_bytes = {0};
+    if (!build_module(&module_bytes, bodies, sizes, 1, 1, 1, 1, 1, kResultI32, 1, NULL, 0)) {
+        cleanup_job(NULL, NULL, NULL, &module_bytes, &instructions);
+        return 1;
+    }
+    WasmModule* module = load_module_from_bytes(module_bytes.data, module_bytes.size);
+    fa_Runtime* runtime = fa_Runtime_init();
+    PagedBackingState* state = (PagedBackingState*)calloc(1, sizeof(PagedBackingState));
+    if (!module || !runtime || !state) {
+        free(state);
+        cleanup_job(runtime, NULL, module, &module_bytes, &instructions);
+        return 1;
+    }
+
+    fa_RuntimeMemoryPaging paging = {
+        TEST_PAGED_PAGE_BYTES,
+        2U,
+        paged_page_spill_hook,
+        paged_page_load_hook,
+        state
+    };
+    fa_RuntimeMemoryPaging bad = paging;
+    bad.page_bytes = 3000U;
+    fa_Job* job = NULL;
+    int failed = fa_Runtime_setMemoryPaging(runtime, &bad) != FA_RUNTIME_ERR_INVALID_ARGUMENT ||
+                 fa_Runtime_setMemoryPaging(runtime, &paging) != FA_RUNTIME_OK ||
+                 fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK ||
+                 (job = fa_Runtime_createJob(runtime)) == NULL;
+    if (!failed) {
+        failed = runtime->memories[0].data != NULL || runtime->memories[0].pager == NULL ||
+                 runtime->memories[0].tlb == NULL ||
+                 !execute_expect_i32(runtime, job, 0, 110 + 2 * 0x07070707);
+    }
+
+    fa_RuntimeMemoryPagingStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!failed) {
+        failed = fa_Runtime_getMemoryPagingStats(runtime, 0, &stats) != FA_RUNTIME_OK ||
+                 stats.page_faults == 0 || stats.page_spills == 0 || stats.page_loads == 0 ||
+                 stats.tlb_hits == 0 || state->load_calls != (int)stats.page_loads;
+    }
+
+    /* A whole-memory spill on a paged memory flushes every dirty frame. */
+    if (!failed) {
+        i32 value = 0;
+        failed = fa_Runtime_spillMemory(runtime, 0) != FA_RUNTIME_OK ||
+                 !state->stored[12] || memcmp(state->pages[12], "\x2c\x00\x00\x00", 4) != 0 ||
+                 fa_Runtime_readMemory(runtime, 0, (uint64_t)(9 * page), &value, sizeof(value)) != FA_RUNTIME_OK ||
+                 value != 0x07070707 ||
+                 fa_Runtime_readMemory(runtime, 0, FA_WASM_PAGE_SIZE - 2U, &value, sizeof(value)) != FA_RUNTIME_ERR_TRAP;
+    }
+
+    /* A restored image may not outgrow the declared maximum (one page here). */
+    const size_t image_bytes = FA_SPILL_HEADER_BYTES + FA_SPILL_MEMORY_BODY_HEADER_BYTES + 2U * FA_WASM_PAGE_SIZE;
+    uint8_t* image = failed ? NULL : (uint8_t*)calloc(1, image_bytes);
+    if (image) {
+        (void)fa_spill_write_header(image, image_bytes, (uint16_t)FA_SPILL_KIND_MEMORY,
+                                    FA_SPILL_MEMORY_BODY_HEADER_BYTES + 2U * FA_WASM_PAGE_SIZE);
+        fa_spill_put_u64(image + FA_SPILL_HEADER_BYTES + 8, 2U * FA_WASM_PAGE_SIZE);
+        failed = fa_Runtime_deserializeMemory(runtime, 0, image, image_bytes) ||
+                 runtime->memories[0].size_bytes != FA_WASM_PAGE_SIZE;
+        free(image);
+    }
+
+    free(state);
+    cleanup_job(runtime, job, module, &module_bytes, &instructions);
+    return failed ? 1 : 0;
+}
+
+static int run_wasm_sample_export_i32(const char* sample_name,
+                                      const char* test_name,
+                                      const char* const* exports,
+                                      size_t export_count,
+                                      i32 expected);
+
+static int test_wasm_sample_arithmetic(void) {
+    const char* exports[] = { "sample_const42", "_sample_const42" };
+    return run_wasm_sample_export_i32("arithmetic.wasm",
+                                      "test_wasm_sample_arithmetic",
+                                      exports,
+                                      sizeof(exports) / sizeof(exports[0]),
+                                      42);
+}
+
+static int test_wasm_sample_arithmetic_mul_add(void) {
+    const char* exports[] = { "sample_mul_add_const", "_sample_mul_add_const" };
+    return run_wasm_sample_export_i32("arithmetic.wasm",
+                                      "test_wasm_sample_arithmetic_mul_add",
                                       exports,
                                       sizeof(exports) / sizeof(exports[0]),
                                       42);
@@ -2931,6 +3920,1753 @@ static int test_wasm_sample_typed_scale_i64(void) {
                                           sample_arg_i64(10000000001LL));
 }
 
+/* Shared module for the tier differential tests: every function takes two
+ * i32 arguments and returns an i32. Covers integer/float arithmetic, loops,
+ * br_table/select, linear memory (including out-of-bounds traps), recursion,
+ * traps, globals, memory.grow, call depth overflow and a call from compiled
+ * code into a function that stays interpreted (popcnt, function 7, is outside
+ * the baseline subset). */
+static int jit_differential_module(ByteBuffer* module_bytes, uint32_t* func_count_out) {
+    static const uint8_t f_arith[] = {
+        0x20, 0x00, 0x41, 0x03, 0x6C, 0x20, 0x01, 0x6A, 0x20, 0x00, 0x41, 0x02, 0x76, 0x73,
+        0x20, 0x00, 0x20, 0x01, 0x77, 0x6A,
+        0x20, 0x01, 0x67, 0x6B,
+        0x20, 0x00, 0x41, 0x80, 0x02, 0x72, 0x68, 0x6A,
+        0x20, 0x00, 0x41, 0xE8, 0x07, 0x6A, 0x20, 0x01, 0x41, 0x01, 0x72, 0x6D, 0x6A,
+        0x20, 0x00, 0x20, 0x01, 0x41, 0x01, 0x72, 0x70, 0x6A,
+        0x20, 0x00, 0x20, 0x01, 0x48, 0x6A,
+        0x20, 0x00, 0x20, 0x01, 0x4F, 0x41, 0x07, 0x74, 0x6A,
+        0x0B
+    };
+    static const uint8_t f_loop[] = {
+        0x20, 0x00, 0x41, 0xFF, 0x07, 0x71, 0x21, 0x00,
+        0x02, 0x40,
+        0x20, 0x00, 0x41, 0x00, 0x4C, 0x0D, 0x00,
+        0x03, 0x40,
+        0x20, 0x03, 0x20, 0x02, 0x20, 0x02, 0x6C, 0x6A, 0x21, 0x03,
+        0x20, 0x02, 0x41, 0x01, 0x6A, 0x22, 0x02, 0x20, 0x00, 0x48, 0x0D, 0x00,
+        0x0B,
+        0x0B,
+        0x20, 0x03,
+        0x0B
+    };
+    static const uint8_t f_memory[] = {
+        0x20, 0x01, 0x41, 0x02, 0x74, 0x20, 0x00, 0x36, 0x02, 0x00,
+        0x20, 0x01, 0x41, 0x02, 0x74, 0x2C, 0x00, 0x01,
+        0x20, 0x01, 0x41, 0x02, 0x74, 0x2F, 0x01, 0x02, 0x6A,
+        0x41, 0xC0, 0x00, 0x20, 0x00, 0xAC, 0x42, 0x89, 0xCF, 0x95, 0x9A, 0x12, 0x7E, 0x37, 0x03, 0x00,
+        0x41, 0xC0, 0x00, 0x29, 0x03, 0x00, 0x42, 0x11, 0x87, 0xA7, 0x6A,
+        0x3F, 0x00, 0x6A,
+        0x41, 0xC6, 0x00, 0x2D, 0x00, 0x00, 0x6A,
+        0x20, 0x01, 0x41, 0x02, 0x74, 0x41, 0x00, 0x3B, 0x01, 0x00,
+        0x20, 0x01, 0x41, 0x02, 0x74, 0x28, 0x02, 0x00, 0x6A,
+        0x0B
+    };
+    static const uint8_t f_fib[] = {
+        0x20, 0x00, 0x41, 0x0F, 0x71, 0x22, 0x00, 0x41, 0x02, 0x49,
+        0x04, 0x7F,
+        0x20, 0x00,
+        0x05,
+        0x20, 0x00, 0x41, 0x01, 0x6B, 0x20, 0x01, 0x10, 0x03,
+        0x20, 0x00, 0x41, 0x02, 0x6B, 0x20, 0x01, 0x10, 0x03, 0x6A,
+        0x0B,
+        0x0B
+    };
+    static const uint8_t f_float[] = {
+        /* trunc_s(sqrt(|f64(a) * 2.5 + f64_u(b)|) * 100) */
+        0x20, 0x00, 0xB7, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x40, 0xA2,
+        0x20, 0x01, 0xB8, 0xA0, 0x99, 0x9F,
+        0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x59, 0x40, 0xA2, 0xAA,
+        /* + wrap(i64.trunc_s(promote((-(f32(a) * 0.5) - f32(b)) / 3))) */
+        0x20, 0x00, 0xB2, 0x43, 0x00, 0x00, 0x00, 0x3F, 0x94, 0x8C,
+        0x20, 0x01, 0xB2, 0x93, 0x43, 0x00, 0x00, 0x40, 0x40, 0x95, 0xBB, 0xB0, 0xA7, 0x6A,
+        /* NaN compares: eq -> 0, ne -> 1 (x2), lt against f64(a) -> 0 */
+        0x44, 0, 0, 0, 0, 0, 0, 0, 0, 0x44, 0, 0, 0, 0, 0, 0, 0, 0, 0xA3, 0x21, 0x02,
+        0x20, 0x02, 0x20, 0x02, 0x61, 0x6A,
+        0x20, 0x02, 0x20, 0x02, 0x62, 0x41, 0x02, 0x6C, 0x6A,
+        0x20, 0x02, 0x20, 0x00, 0xB7, 0x63, 0x6A,
+        0x20, 0x00, 0xB7, 0x20, 0x01, 0xB7, 0x66, 0x41, 0x04, 0x74, 0x6A,
+        /* + trunc_s(copysign(1.5, f32(b))) */
+        0x43, 0x00, 0x00, 0xC0, 0x3F, 0x20, 0x01, 0xB2, 0x98, 0xA8, 0x6A,
+        /* + wrap(clz(rotl(i64_u(a) * 1000003 rem_s 7, 3))) */
+        0x20, 0x00, 0xAD, 0x42, 0xC3, 0x84, 0x3D, 0x7E, 0x42, 0x07, 0x81, 0x42, 0x03, 0x89, 0x79, 0xA7, 0x6A,
+        /* + reinterpret(demote(f64(a))) + trunc_u(f64(a & 0x7fff)) + extend8_s(a) */
+        0x20, 0x00, 0xB7, 0xB6, 0xBC, 0x6A,
+        0x20, 0x00, 0x41, 0xFF, 0xFF, 0x01, 0x71, 0xB7, 0xAB, 0x6A,
+        0x20, 0x00, 0xC0, 0x6A,
+        0x0B
+    };
+    static const uint8_t f_branch[] = {
+        0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40,
+        0x20, 0x00, 0x41, 0x03, 0x71, 0x0E, 0x03, 0x00, 0x01, 0x02, 0x03,
+        0x0B,
+        0x41, 0x0A, 0x20, 0x00, 0x20, 0x01, 0x20, 0x01, 0x20, 0x00, 0x4A, 0x1B, 0x6A, 0x0F,
+        0x0B,
+        0x41, 0x14, 0x0F,
+        0x0B,
+        0x41, 0x1E, 0x20, 0x01, 0x6A, 0x0F,
+        0x0B,
+        0x02, 0x7F, 0x41, 0x28, 0x20, 0x01, 0x0D, 0x00, 0x1A, 0x41, 0x29, 0x0B,
+        0x0B
+    };
+    static const uint8_t f_trap[] = {
+        0x20, 0x00, 0x41, 0x07, 0x46, 0x04, 0x40, 0x00, 0x0B,
+        0x20, 0x00, 0x20, 0x01, 0x6E,
+        0x20, 0x00, 0x20, 0x01, 0x6F, 0x6A,
+        0x20, 0x00, 0x20, 0x01, 0x6D, 0x6A,
+        0x0B
+    };
+    static const uint8_t f_popcnt[] = { 0x20, 0x00, 0x69, 0x20, 0x01, 0x6A, 0x0B };
+    static const uint8_t f_mixed_calls[] = {
+        0x20, 0x00, 0x20, 0x01, 0x10, 0x07, 0x20, 0x01, 0x20, 0x00, 0x10, 0x03, 0x6A, 0x0B
+    };
+    static const uint8_t f_global[] = {
+        0x23, 0x00, 0x20, 0x00, 0xAC, 0x7C, 0x24, 0x00, 0x23, 0x00, 0xA7, 0x0B
+    };
+    static const uint8_t f_grow[] = {
+        0x20, 0x00, 0x41, 0x01, 0x71, 0x40, 0x00, 0x3F, 0x00, 0x41, 0x10, 0x6C, 0x6A, 0x0B
+    };
+    static const uint8_t f_recurse[] = { 0x20, 0x00, 0x20, 0x01, 0x10, 0x0B, 0x0B };
+    static const uint8_t two_i32_locals[] = { 0x01, 0x02, 0x7F };
+    static const uint8_t one_f64_local[] = { 0x01, 0x01, 0x7C };
+
+    const uint8_t* bodies[] = {
+        f_arith, f_loop, f_memory, f_fib, f_float, f_branch,
+        f_trap, f_popcnt, f_mixed_calls, f_global, f_grow, f_recurse
+    };
+    const size_t body_sizes[] = {
+        sizeof(f_arith), sizeof(f_loop), sizeof(f_memory), sizeof(f_fib), sizeof(f_float), sizeof(f_branch),
+        sizeof(f_trap), sizeof(f_popcnt), sizeof(f_mixed_calls), sizeof(f_global), sizeof(f_grow), sizeof(f_recurse)
+    };
+    const uint8_t* locals[] = {
+        NULL, two_i32_locals, NULL, NULL, one_f64_local, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+    };
+    const size_t locals_sizes[] = { 0, sizeof(two_i32_locals), 0, 0, sizeof(one_f64_local), 0, 0, 0, 0, 0, 0, 0 };
+    const size_t func_count = sizeof(bodies) / sizeof(bodies[0]);
+    const uint8_t params[] = { VALTYPE_I32, VALTYPE_I32 };
+    const uint8_t results[] = { VALTYPE_I32 };
+    static const uint8_t global_bytes[] = { 0x01, VALTYPE_I64, 0x01, 0x42, 0x05, 0x0B };
+    ByteBuffer globals = {0};
+    if (!bb_write_bytes(&globals, global_bytes, sizeof(global_bytes)) ||
+        !build_module_with_locals(module_bytes, bodies, body_sizes, locals, locals_sizes, func_count,
+                                  NULL, &globals, 1, 1, 0, 0, results, 1, params, 2)) {
+        bb_free(&globals);
+        bb_free(module_bytes);
+        return 0;
+    }
+    bb_free(&globals);
+    *func_count_out = (uint32_t)func_count;
+    return 1;
+}
+
+/* Runs every function with the same argument pairs on `interp` and `tier`;
+   statuses and i32 results must agree. Returns nonzero on the first mismatch. */
+static int jit_differential_compare(fa_Runtime* interp, fa_Job* interp_job,
+                                    fa_Runtime* tier, fa_Job* tier_job,
+                                    uint32_t func_count, const char* label) {
+    static const i32 arg_pairs[][2] = {
+        { 0, 0 }, { 5, 3 }, { -7, 2 }, { 10, 0 }, { 7, 1 }, { 123456, -1 },
+        { INT32_MIN, -1 }, { 1000, 16383 }, { 3, 16384 }, { -1, 77 }
+    };
+    int failed = 0;
+    for (uint32_t f = 0; f < func_count && !failed; ++f) {
+        for (size_t i = 0; i < sizeof(arg_pairs) / sizeof(arg_pairs[0]); ++i) {
+            fa_JobValue args[2];
+            args[0] = sample_arg_i32(arg_pairs[i][0]);
+            args[1] = sample_arg_i32(arg_pairs[i][1]);
+            const int expected_status = fa_Runtime_executeJobWithArgs(interp, interp_job, f, args, 2);
+            const int tier_status = fa_Runtime_executeJobWithArgs(tier, tier_job, f, args, 2);
+            if (tier_status != expected_status) {
+                printf("%s tier: function %u args (%d, %d): status %d, interpreter %d\n",
+                       label, f, arg_pairs[i][0], arg_pairs[i][1], tier_status, expected_status);
+                failed = 1;
+                break;
+            }
+            if (expected_status != FA_RUNTIME_OK) {
+                continue;
+            }
+            const fa_JobValue* expected = fa_JobStack_peek(&interp_job->stack, 0);
+            const fa_JobValue* actual = fa_JobStack_peek(&tier_job->stack, 0);
+            if (!expected || !actual || actual->kind != fa_job_value_i32 ||
+                actual->payload.i32_value != expected->payload.i32_value) {
+                printf("%s tier: function %u args (%d, %d): result %d, interpreter %d\n",
+                       label, f, arg_pairs[i][0], arg_pairs[i][1],
+                       actual ? actual->payload.i32_value : 0, expected ? expected->payload.i32_value : 0);
+                failed = 1;
+                break;
+            }
+        }
+    }
+    return failed;
+}
+
+/* Differential check for the native tier: every function of the shared module
+ * runs on a pure interpreter runtime and on a runtime forced to
+ * FA_JIT_TIER_NATIVE. */
+static int test_jit_native_differential(void) {
+    if (!fa_jit_native_supported()) {
+#if defined(FAYASM_TEST_REQUIRE_NATIVE)
+        printf("native tier: backend required by the build but not compiled in\n");
+        return 1;
+#else
+        printf("SKIP: test_jit_native_differential (no native backend for this target)\n");
+        return 0;
+#endif
+    }
+    ByteBuffer module_bytes = {0};
+    uint32_t func_count = 0;
+    if (!jit_differential_module(&module_bytes, &func_count)) {
+        return 1;
+    }
+
+    fa_Runtime* interp = NULL;
+    fa_Job* interp_job = NULL;
+    WasmModule* interp_module = NULL;
+    fa_Runtime* native = NULL;
+    fa_Job* native_job = NULL;
+    WasmModule* native_module = NULL;
+    if (!run_job(&module_bytes, &interp, &interp_job, &interp_module)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    if (!run_job(&module_bytes, &native, &native_job, &native_module)) {
+        cleanup_job(interp, interp_job, interp_module, &module_bytes, NULL);
+        return 1;
+    }
+    interp->jit_context.config.min_advantage_score = 2.0f; /* never reachable: stays interpreted */
+    native->jit_context.config.min_ram_bytes = 0;
+    native->jit_context.config.min_cpu_count = 1;
+    native->jit_context.config.min_hot_loop_hits = 0;
+    native->jit_context.config.min_executed_ops = 1;
+    native->jit_context.config.min_advantage_score = 0.0f;
+    native->jit_context.config.native_tier = true;
+
+    int failed = jit_differential_compare(interp, interp_job, native, native_job, func_count, "native");
+    if (!failed) {
+        for (uint32_t f = 0; f < func_count; ++f) {
+            const bool compiled = fa_Runtime_jitIsNative(native, f);
+            if (compiled != (f != 7U)) {
+                printf("native tier: function %u compiled=%d\n", f, compiled ? 1 : 0);
+                failed = 1;
+            }
+        }
+        if (native->jit_native_calls == 0 || interp->jit_native_calls != 0) {
+            failed = 1;
+        }
+    }
+    /* Both backends are plain byte emitters: each must accept every body the
+       host backend compiled (AArch64 output is whole 4-byte words). */
+    for (uint32_t f = 0; f < func_count && !failed; ++f) {
+        if (f == 7U) {
+            continue;
+        }
+        fa_JitNativeRequest request;
+        memset(&request, 0, sizeof(request));
+        request.module = interp_module;
+        request.func_index = f;
+        request.body = wasm_load_function_body(interp_module, f);
+        request.body_size = interp_module->functions[f].body_size;
+        request.memory_flat = true;
+        for (int arch = FA_JIT_NATIVE_ARCH_X86_64; arch <= FA_JIT_NATIVE_ARCH_AARCH64; ++arch) {
+            uint8_t* code = NULL;
+            size_t size = 0;
+            if (!request.body ||
+                !fa_jit_native_emit(&request, (fa_JitNativeArch)arch, &code, &size, NULL) ||
+                size == 0 || (arch == FA_JIT_NATIVE_ARCH_AARCH64 && (size % 4U) != 0)) {
+                printf("native tier: function %u did not emit for arch %d\n", f, arch);
+                failed = 1;
+            }
+            free(code);
+        }
+        free((void*)request.body);
+    }
+    cleanup_job(native, native_job, native_module, NULL, NULL);
+    cleanup_job(interp, interp_job, interp_module, &module_bytes, NULL);
+    return failed;
+}
+
+/* Ahead-of-time compilation: the shared differential module is emitted as C.
+ * Every function the native frontend accepts gets an entry (popcnt, f7, stays
+ * interpreted); where a host C compiler is available the output is built as
+ * a shared object, registered with fa_Runtime_setAotFunctions on a runtime
+ * whose JIT never engages, and must agree with the interpreter. */
+static int test_aot_emit_c(void) {
+    ByteBuffer module_bytes = {0};
+    uint32_t func_count = 0;
+    if (!jit_differential_module(&module_bytes, &func_count)) {
+        return 1;
+    }
+    fa_Runtime* interp = NULL;
+    fa_Job* interp_job = NULL;
+    WasmModule* interp_module = NULL;
+    if (!run_job(&module_bytes, &interp, &interp_job, &interp_module)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    interp->jit_context.config.min_advantage_score = 2.0f; /* never reachable: stays interpreted */
+    fa_AotOptions options = { "aot_test", "differential.wasm" };
+    fa_AotOptions bad_prefix = { "9lives", NULL };
+    char* text = NULL;
+    size_t size = 0;
+    fa_AotStats stats;
+    int failed = 0;
+    if (!fa_aot_emit_c(interp_module, &options, &text, &size, &stats) || !text || size != strlen(text) ||
+        stats.function_count != func_count || stats.compiled_count != func_count - 1U ||
+        stats.imported_count != 0 || !strstr(text, "#include \"fa_aot_runtime.h\"") ||
+        !strstr(text, "static int aot_test_f3(fa_JitNativeContext* ctx, uint64_t* s) {") ||
+        !strstr(text, "status = aot_test_f3(ctx, s + ") ||       /* fib recursion: direct call */
+        !strstr(text, "status = ctx->call_slow(ctx, s + ") ||    /* f8 -> popcnt: interpreted */
+        !strstr(text, "    NULL, /* f7: interpreted */") ||
+        !strstr(text, "const uint32_t aot_test_function_count = 12U;")) {
+        printf("aot: emit failed (compiled %u of %u)\n", stats.compiled_count, stats.function_count);
+        failed = 1;
+    }
+    char* rejected = NULL;
+    if (fa_aot_emit_c(interp_module, &bad_prefix, &rejected, NULL, NULL) || rejected) {
+        failed = 1;
+    }
+    const fa_JitNativeEntry short_table[1] = { NULL };
+    if (!failed && (fa_Runtime_setAotFunctions(interp, NULL, 0) != FA_RUNTIME_OK ||
+                    fa_Runtime_setAotFunctions(interp, short_table, 1U) != FA_RUNTIME_ERR_INVALID_ARGUMENT)) {
+        failed = 1;
+    }
+#if defined(TEST_AOT_CAN_BUILD)
+    char source_path[PATH_MAX];
+    char library_path[PATH_MAX];
+    char command[3 * PATH_MAX + 128];
+    snprintf(source_path, sizeof(source_path), "%s/aot_differential.c", FAYASM_TEST_BINARY_DIR);
+    snprintf(library_path, sizeof(library_path), "%s/libaot_differential.so", FAYASM_TEST_BINARY_DIR);
+    snprintf(command, sizeof(command), "\"%s\" -std=c99 -O1 -shared -fPIC -I\"%s\" -o \"%s\" \"%s\" -lm",
+             FAYASM_TEST_C_COMPILER, FAYASM_TEST_SOURCE_DIR, library_path, source_path);
+    FILE* source = failed ? NULL : fopen(source_path, "wb");
+    const bool written = source && fwrite(text, 1, size, source) == size;
+    if (source) {
+        fclose(source);
+    }
+    void* library = written && system(command) == 0 ? dlopen(library_path, RTLD_NOW) : NULL;
+    if (!failed && !library) {
+        printf("SKIP: test_aot_emit_c build/run step (could not compile the generated C)\n");
+    }
+    if (!failed && library) {
+        const fa_JitNativeEntry* table = (const fa_JitNativeEntry*)dlsym(library, "aot_test_functions");
+        const uint32_t* count = (const uint32_t*)dlsym(library, "aot_test_function_count");
+        fa_Runtime* runtime = NULL;
+        fa_Job* job = NULL;
+        WasmModule* module = NULL;
+        if (!table || !count || *count != func_count || !run_job(&module_bytes, &runtime, &job, &module)) {
+            failed = 1;
+        } else {
+            runtime->jit_context.config.min_advantage_score = 2.0f;
+            if (fa_Runtime_setAotFunctions(runtime, table, *count) != FA_RUNTIME_OK) {
+                failed = 1;
+            }
+            if (!failed) {
+                failed = jit_differential_compare(interp, interp_job, runtime, job, func_count, "aot");
+            }
+            if (!failed && (runtime->jit_aot_calls == 0 || runtime->jit_native_calls != 0 ||
+                            runtime->jit_closure_calls != 0 || interp->jit_aot_calls != 0)) {
+                printf("aot: calls aot=%llu native=%llu\n", (unsigned long long)runtime->jit_aot_calls,
+                       (unsigned long long)runtime->jit_native_calls);
+                failed = 1;
+            }
+            cleanup_job(runtime, job, module, NULL, NULL);
+        }
+        dlclose(library);
+    }
+    remove(library_path);
+    remove(source_path);
+#endif
+    free(text);
+    cleanup_job(interp, interp_job, interp_module, &module_bytes, NULL);
+    return failed;
+}
+
+/* SHA-256 against the FIPS 180-4 examples (empty, one block, two blocks),
+ * and fed in uneven pieces, which must not change the digest. */
+static int test_sha256_digest(void) {
+    static const char* inputs[] = {
+        "", "abc", "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"
+    };
+    static const char* expected[] = {
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"
+    };
+    int failed = 0;
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]) && !failed; ++i) {
+        const size_t size = strlen(inputs[i]);
+        uint8_t digest[FA_SHA256_BYTES];
+        uint8_t pieces[FA_SHA256_BYTES];
+        fa_sha256((const uint8_t*)inputs[i], size, digest);
+        fa_Sha256 ctx;
+        fa_sha256_init(&ctx);
+        for (size_t at = 0; at < size; at += 3) {
+            fa_sha256_update(&ctx, (const uint8_t*)inputs[i] + at, size - at < 3 ? size - at : 3);
+        }
+        fa_sha256_final(&ctx, pieces);
+        char hex[FA_SHA256_BYTES * 2 + 1];
+        for (size_t b = 0; b < FA_SHA256_BYTES; ++b) {
+            snprintf(hex + b * 2, 3, "%02x", digest[b]);
+        }
+        if (strcmp(hex, expected[i]) != 0 || memcmp(digest, pieces, FA_SHA256_BYTES) != 0) {
+            printf("sha256: input %zu gave %s\n", i, hex);
+            failed = 1;
+        }
+    }
+    return failed;
+}
+
+#if defined(TEST_PERSIST_CAN_RUN)
+/* Empties (or creates) the persisted-code test directory. */
+static int persist_reset_dir(const char* dir) {
+    DIR* handle = opendir(dir);
+    if (!handle) {
+        return mkdir(dir, 0700) == 0;
+    }
+    struct dirent* item = NULL;
+    char path[PATH_MAX];
+    while ((item = readdir(handle)) != NULL) {
+        if (item->d_name[0] != '.') {
+            snprintf(path, sizeof(path), "%s/%s", dir, item->d_name);
+            remove(path);
+        }
+    }
+    closedir(handle);
+    return 1;
+}
+
+/* Path of any one cache file in `dir`. */
+static int persist_first_file(const char* dir, char* path, size_t capacity) {
+    DIR* handle = opendir(dir);
+    if (!handle) {
+        return 0;
+    }
+    struct dirent* item = NULL;
+    int found = 0;
+    while (!found && (item = readdir(handle)) != NULL) {
+        if (strstr(item->d_name, ".fyc") && !strstr(item->d_name, ".fyc.")) {
+            const int written = snprintf(path, capacity, "%s/%s", dir, item->d_name);
+            found = written > 0 && (size_t)written < capacity;
+        }
+    }
+    closedir(handle);
+    return found;
+}
+
+/* One runtime over `module_bytes` with the tier forced on and the cache at
+   `dir`, compared against a fresh interpreter (memory.grow in the module makes
+   state carry over between runs); reports the cache counters. */
+static int persist_tier_run(ByteBuffer* module_bytes, uint32_t func_count, bool native, const char* dir,
+                            uint64_t* hits_out, uint64_t* stores_out) {
+    fa_Runtime* interp = NULL;
+    fa_Job* interp_job = NULL;
+    WasmModule* interp_module = NULL;
+    fa_Runtime* runtime = NULL;
+    fa_Job* job = NULL;
+    WasmModule* module = NULL;
+    if (!run_job(module_bytes, &interp, &interp_job, &interp_module)) {
+        return 1;
+    }
+    if (!run_job(module_bytes, &runtime, &job, &module)) {
+        cleanup_job(interp, interp_job, interp_module, NULL, NULL);
+        return 1;
+    }
+    interp->jit_context.config.min_advantage_score = 2.0f; /* never reachable: stays interpreted */
+    runtime->jit_context.config.min_ram_bytes = 0;
+    runtime->jit_context.config.min_cpu_count = 1;
+    runtime->jit_context.config.min_hot_loop_hits = 0;
+    runtime->jit_context.config.min_executed_ops = 1;
+    runtime->jit_context.config.min_advantage_score = 0.0f;
+    runtime->jit_context.config.native_tier = native;
+    runtime->jit_context.config.closure_tier = !native;
+    runtime->jit_context.config.worker_threads = 0;
+    int failed = fa_Runtime_setJitCacheDir(runtime, dir) != FA_RUNTIME_OK;
+    if (!failed) {
+        failed = jit_differential_compare(interp, interp_job, runtime, job, func_count,
+                                          native ? "persisted native" : "persisted closure");
+    }
+    if (!failed && (native ? runtime->jit_native_calls : runtime->jit_closure_calls) == 0) {
+        failed = 1;
+    }
+    *hits_out = runtime->jit_persist_hits;
+    *stores_out = runtime->jit_persist_stores;
+    cleanup_job(runtime, job, module, NULL, NULL);
+    cleanup_job(interp, interp_job, interp_module, NULL, NULL);
+    return failed;
+}
+#endif
+
+/* Persisted code cache: a runtime given a cache directory writes every
+ * function it compiles, and a second runtime over the same module bytes
+ * installs them all from disk without lowering anything. Covers native code
+ * (where a backend exists) and closure records; a damaged entry is ignored
+ * and recompiled, an entry keyed to another module hash is rejected, and a
+ * group- or world-writable directory is not used at all. */
+static int test_jit_persisted_code(void) {
+#if !defined(TEST_PERSIST_CAN_RUN)
+    printf("SKIP: test_jit_persisted_code (no writable test directory)\n");
+    return 0;
+#else
+    ByteBuffer module_bytes = {0};
+    uint32_t func_count = 0;
+    if (!jit_differential_module(&module_bytes, &func_count)) {
+        return 1;
+    }
+    WasmModule* module = load_module_from_bytes(module_bytes.data, module_bytes.size);
+    if (!module) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s/jit_persist", FAYASM_TEST_BINARY_DIR);
+    const uint64_t compiled = func_count - 1U; /* f7 (popcnt) stays interpreted */
+    int failed = 0;
+    for (int pass = 0; pass < 2 && !failed; ++pass) {
+        const bool native = pass == 0;
+        if (native && !fa_jit_native_supported()) {
+            continue;
+        }
+        uint64_t hits = 0;
+        uint64_t stores = 0;
+        if (!persist_reset_dir(dir) ||
+            persist_tier_run(&module_bytes, func_count, native, dir, &hits, &stores) ||
+            hits != 0 || stores != compiled) {
+            printf("persisted %s: cold run hits=%llu stores=%llu\n", native ? "native" : "closure",
+                   (unsigned long long)hits, (unsigned long long)stores);
+            failed = 1;
+            break;
+        }
+        if (persist_tier_run(&module_bytes, func_count, native, dir, &hits, &stores) ||
+            hits != compiled || stores != 0) {
+            printf("persisted %s: warm run hits=%llu stores=%llu\n", native ? "native" : "closure",
+                   (unsigned long long)hits, (unsigned long long)stores);
+            failed = 1;
+            break;
+        }
+
+        /* Flip the last data byte of one entry: its checksum no longer
+           matches, so that function alone is compiled (and rewritten). */
+        char path[PATH_MAX];
+        FILE* file = persist_first_file(dir, path, sizeof(path)) ? fopen(path, "rb") : NULL;
+        uint8_t blob[65536];
+        const size_t size = file ? fread(blob, 1, sizeof(blob), file) : 0;
+        if (file) {
+            fclose(file);
+        }
+        fa_JitPersistKey key;
+        memset(&key, 0, sizeof(key));
+        uint32_t frame_slots = 0;
+        const uint8_t* data = NULL;
+        size_t data_bytes = 0;
+        if (size > FA_SPILL_HEADER_BYTES + FA_JIT_PERSIST_KEY_BYTES) {
+            const uint8_t* stored = blob + FA_SPILL_HEADER_BYTES;
+            memcpy(key.module_digest, stored, FA_SHA256_BYTES);
+            key.abi = fa_spill_get_u32(stored + 32);
+            key.func_index = fa_spill_get_u32(stored + 36);
+            key.tier = stored[40];
+            key.arch = stored[41];
+            key.memory_flat = stored[42] != 0;
+        }
+        uint8_t digest[FA_SHA256_BYTES];
+        if (size == 0 || size == sizeof(blob) || wasm_module_content_digest(module, digest) != 0 ||
+            memcmp(key.module_digest, digest, FA_SHA256_BYTES) != 0 ||
+            key.tier != (uint8_t)(native ? FA_JIT_TIER_NATIVE : FA_JIT_TIER_CLOSURE) ||
+            !fa_jit_persist_decode(blob, size, &key, &frame_slots, &data, &data_bytes)) {
+            printf("persisted %s: entry unreadable\n", native ? "native" : "closure");
+            failed = 1;
+            break;
+        }
+        /* Any other module, even one agreeing on the digest's file-name
+           prefix, is rejected. */
+        key.module_digest[FA_SHA256_BYTES - 1U] ^= 1U;
+        if (fa_jit_persist_decode(blob, size, &key, &frame_slots, &data, &data_bytes)) {
+            printf("persisted %s: entry accepted for another module\n", native ? "native" : "closure");
+            failed = 1;
+            break;
+        }
+        blob[size - 1U] ^= 0xFFU;
+        file = fopen(path, "wb");
+        if (!file || fwrite(blob, 1, size, file) != size) {
+            failed = 1;
+        }
+        if (file) {
+            fclose(file);
+        }
+        if (!failed &&
+            (persist_tier_run(&module_bytes, func_count, native, dir, &hits, &stores) ||
+             hits != compiled - 1U || stores != 1U)) {
+            printf("persisted %s: damaged run hits=%llu stores=%llu\n", native ? "native" : "closure",
+                   (unsigned long long)hits, (unsigned long long)stores);
+            failed = 1;
+        }
+    }
+    /* A directory others can write is neither read nor written: the entries
+       left by the last pass are ignored and nothing new is stored. */
+    uint64_t hits = 0;
+    uint64_t stores = 0;
+    if (!failed && chmod(dir, 0777) == 0) {
+        if (persist_tier_run(&module_bytes, func_count, false, dir, &hits, &stores) || hits != 0 ||
+            stores != 0) {
+            printf("persisted: shared directory hits=%llu stores=%llu\n", (unsigned long long)hits,
+                   (unsigned long long)stores);
+            failed = 1;
+        }
+        (void)chmod(dir, 0700);
+    }
+    (void)persist_reset_dir(dir);
+    remove(dir);
+    wasm_module_free(module);
+    bb_free(&module_bytes);
+    return failed;
+#endif
+}
+
+#if defined(TEST_THREADS_CAN_RUN)
+#define TEST_INSTANCE_THREADS 4
+#define TEST_INSTANCE_ARG_PAIRS 5
+
+typedef struct {
+    fa_CompiledModule* compiled;
+    uint32_t func_count;
+    bool native;
+    const int* expected_status;   /* func_count * TEST_INSTANCE_ARG_PAIRS */
+    const i32* expected_value;
+    int failed;
+    uint64_t tier_calls;
+    uint64_t shared_hits;
+} InstanceThreadRun;
+
+static const i32 kInstanceArgPairs[TEST_INSTANCE_ARG_PAIRS][2] = {
+    { 0, 0 }, { 5, 3 }, { -7, 2 }, { 7, 1 }, { 1000, 16383 }
+};
+
+/* One instance of `run->compiled` with the tier forced on, driven through
+   the same calls the reference interpreter made. */
+static void* instance_thread_main(void* user) {
+    InstanceThreadRun* run = (InstanceThreadRun*)user;
+    fa_Instance* instance = fa_Instance_create(run->compiled);
+    fa_Job* job = instance ? fa_Runtime_createJob(instance) : NULL;
+    run->failed = !job || fa_Runtime_setJitCacheDir(instance, NULL) != FA_RUNTIME_OK;
+    if (!run->failed) {
+        instance->jit_context.config.min_ram_bytes = 0;
+        instance->jit_context.config.min_cpu_count = 1;
+        instance->jit_context.config.min_hot_loop_hits = 0;
+        instance->jit_context.config.min_executed_ops = 1;
+        instance->jit_context.config.min_advantage_score = 0.0f;
+        instance->jit_context.config.native_tier = run->native;
+        instance->jit_context.config.closure_tier = !run->native;
+        instance->jit_context.config.worker_threads = 0;
+    }
+    for (uint32_t f = 0; f < run->func_count && !run->failed; ++f) {
+        for (uint32_t i = 0; i < TEST_INSTANCE_ARG_PAIRS && !run->failed; ++i) {
+            fa_JobValue args[2];
+            args[0] = sample_arg_i32(kInstanceArgPairs[i][0]);
+            args[1] = sample_arg_i32(kInstanceArgPairs[i][1]);
+            const size_t at = (size_t)f * TEST_INSTANCE_ARG_PAIRS + i;
+            const int status = fa_Runtime_executeJobWithArgs(instance, job, f, args, 2);
+            const fa_JobValue* top = status == FA_RUNTIME_OK ? fa_JobStack_peek(&job->stack, 0) : NULL;
+            run->failed = status != run->expected_status[at] ||
+                          (status == FA_RUNTIME_OK && (!top || top->payload.i32_value != run->expected_value[at]));
+        }
+    }
+    if (instance) {
+        run->tier_calls = run->native ? instance->jit_native_calls : instance->jit_closure_calls;
+        run->shared_hits = instance->jit_shared_hits;
+    }
+    if (instance && job) {
+        (void)fa_Runtime_destroyJob(instance, job);
+    }
+    fa_Instance_free(instance);
+    return NULL;
+}
+#endif
+
+/* Instances of one compiled module run on several threads at once, each with
+ * the native (where a backend exists) or closure tier forced on, and match a
+ * plain interpreter call for call. Tier-up code is shared through the
+ * compiled module: an instance created afterwards installs every function
+ * another instance compiled instead of lowering it again. */
+static int test_compiled_module_threads(void) {
+#if !defined(TEST_THREADS_CAN_RUN)
+    printf("SKIP: test_compiled_module_threads (no threads on this target)\n");
+    return 0;
+#else
+    ByteBuffer module_bytes = {0};
+    uint32_t func_count = 0;
+    if (!jit_differential_module(&module_bytes, &func_count)) {
+        return 1;
+    }
+    const size_t call_count = (size_t)func_count * TEST_INSTANCE_ARG_PAIRS;
+    int* expected_status = (int*)calloc(call_count, sizeof(int));
+    i32* expected_value = (i32*)calloc(call_count, sizeof(i32));
+    fa_Runtime* interp = NULL;
+    fa_Job* interp_job = NULL;
+    WasmModule* interp_module = NULL;
+    int failed = !expected_status || !expected_value || !run_job(&module_bytes, &interp, &interp_job, &interp_module);
+    if (!failed) {
+        interp->jit_context.config.min_advantage_score = 2.0f; /* never reachable: stays interpreted */
+    }
+    for (uint32_t f = 0; f < func_count && !failed; ++f) {
+        for (uint32_t i = 0; i < TEST_INSTANCE_ARG_PAIRS; ++i) {
+            fa_JobValue args[2];
+            args[0] = sample_arg_i32(kInstanceArgPairs[i][0]);
+            args[1] = sample_arg_i32(kInstanceArgPairs[i][1]);
+            const size_t at = (size_t)f * TEST_INSTANCE_ARG_PAIRS + i;
+            expected_status[at] = fa_Runtime_executeJobWithArgs(interp, interp_job, f, args, 2);
+            const fa_JobValue* top = fa_JobStack_peek(&interp_job->stack, 0);
+            expected_value[at] = expected_status[at] == FA_RUNTIME_OK && top ? top->payload.i32_value : 0;
+        }
+    }
+    cleanup_job(interp, interp_job, interp_module, NULL, NULL);
+
+    const uint64_t compiled_functions = func_count - 1U; /* f7 (popcnt) stays interpreted */
+    for (int pass = 0; pass < 2 && !failed; ++pass) {
+        const bool native = pass == 0;
+        if (native && !fa_jit_native_supported()) {
+            continue;
+        }
+        WasmModule* module = load_module_from_bytes(module_bytes.data, module_bytes.size);
+        fa_CompiledModule* compiled = module ? fa_CompiledModule_create(module) : NULL;
+        if (!compiled) {
+            wasm_module_free(module);
+            failed = 1;
+            break;
+        }
+        InstanceThreadRun runs[TEST_INSTANCE_THREADS + 1];
+        pthread_t threads[TEST_INSTANCE_THREADS];
+        bool started[TEST_INSTANCE_THREADS];
+        for (uint32_t t = 0; t <= TEST_INSTANCE_THREADS; ++t) {
+            memset(&runs[t], 0, sizeof(runs[t]));
+            runs[t].compiled = compiled;
+            runs[t].func_count = func_count;
+            runs[t].native = native;
+            runs[t].expected_status = expected_status;
+            runs[t].expected_value = expected_value;
+        }
+        for (uint32_t t = 0; t < TEST_INSTANCE_THREADS; ++t) {
+            started[t] = pthread_create(&threads[t], NULL, instance_thread_main, &runs[t]) == 0;
+            failed = failed || !started[t];
+        }
+        for (uint32_t t = 0; t < TEST_INSTANCE_THREADS; ++t) {
+            if (started[t]) {
+                (void)pthread_join(threads[t], NULL);
+            }
+            if (runs[t].failed || runs[t].tier_calls == 0) {
+                printf("%s instances: thread %u failed=%d tier calls=%llu\n", native ? "native" : "closure",
+                       t, runs[t].failed, (unsigned long long)runs[t].tier_calls);
+                failed = 1;
+            }
+        }
+        (void)instance_thread_main(&runs[TEST_INSTANCE_THREADS]);
+        if (runs[TEST_INSTANCE_THREADS].failed || runs[TEST_INSTANCE_THREADS].shared_hits != compiled_functions) {
+            printf("%s instances: late instance failed=%d shared hits=%llu\n", native ? "native" : "closure",
+                   runs[TEST_INSTANCE_THREADS].failed, (unsigned long long)runs[TEST_INSTANCE_THREADS].shared_hits);
+            failed = 1;
+        }
+        fa_CompiledModule_release(compiled);
+    }
+    free(expected_status);
+    free(expected_value);
+    bb_free(&module_bytes);
+    return failed;
+#endif
+}
+
+static fa_Runtime* prescan_runtime(const ByteBuffer* module_bytes,
+                                   uint32_t threads,
+                                   WasmModule** module_out,
+                                   int* status_out) {
+    *module_out = load_module_from_bytes(module_bytes->data, module_bytes->size);
+    fa_Runtime* runtime = fa_Runtime_init();
+    if (!*module_out || !runtime) {
+        fa_Runtime_free(runtime);
+        return NULL;
+    }
+    runtime->jit_context.config.min_ram_bytes = 0;
+    runtime->jit_context.config.min_cpu_count = 1;
+    runtime->jit_context.config.min_hot_loop_hits = 0;
+    runtime->jit_context.config.min_executed_ops = 1;
+    runtime->jit_context.config.min_advantage_score = 0.0f;
+    runtime->jit_context.config.prescan_functions = true;
+    runtime->jit_context.config.prescan_threads = threads;
+    *status_out = fa_Runtime_attachModule(runtime, *module_out);
+    return runtime;
+}
+
+/* Load-time prescan on a worker pool: whatever the thread count, the scanned
+ * opcodes, control side tables and lowered programs (measured through the
+ * cache bytes they charge) match the serial walk, execution matches, and a
+ * body with mismatched block nesting fails validation either way. */
+static int test_jit_parallel_prescan(void) {
+    test_set_env("FAYASM_MICROCODE", "1");
+    /* attachModule applies env overrides over the per-runtime thread counts. */
+    test_set_env("FAYASM_JIT_PRESCAN_THREADS", NULL);
+    test_set_env("FAYASM_JIT_PRESCAN_LAZY", NULL);
+    ByteBuffer module_bytes = {0};
+    uint32_t func_count = 0;
+    if (!jit_differential_module(&module_bytes, &func_count)) {
+        return 1;
+    }
+    int failed = 0;
+    int status = FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    static const uint32_t thread_counts[] = { 1U, 3U, FA_JIT_PRESCAN_THREADS_AUTO };
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]) && !failed; ++t) {
+        /* A fresh reference each round: the functions grow memory. */
+        WasmModule* serial_module = NULL;
+        fa_Runtime* serial = prescan_runtime(&module_bytes, 0, &serial_module, &status);
+        fa_Job* serial_job = serial && status == FA_RUNTIME_OK ? fa_Runtime_createJob(serial) : NULL;
+        failed = !serial_job || serial->jit_prescan_threads != 0 || serial->jit_prescan_blocks == 0 ||
+                 (fa_ops_microcode_enabled() && serial->jit_cache_bytes == 0);
+
+        WasmModule* module = NULL;
+        fa_Runtime* runtime = prescan_runtime(&module_bytes, thread_counts[t], &module, &status);
+        fa_Job* job = runtime && status == FA_RUNTIME_OK ? fa_Runtime_createJob(runtime) : NULL;
+        uint32_t expected_threads = thread_counts[t];
+        if (runtime && expected_threads == FA_JIT_PRESCAN_THREADS_AUTO) {
+            expected_threads = runtime->jit_context.probe.cpu_count;
+        }
+        if (expected_threads > FA_JIT_WORKERS_MAX) {
+            expected_threads = FA_JIT_WORKERS_MAX;
+        }
+        if (!fa_jit_workers_supported()) {
+            expected_threads = 0;
+        }
+        if (!failed && (!job || runtime->jit_prescan_threads != expected_threads ||
+                        runtime->jit_prescan_blocks != serial->jit_prescan_blocks ||
+                        runtime->jit_cache_bytes != serial->jit_cache_bytes)) {
+            if (runtime) {
+                printf("parallel prescan (%u threads): blocks %llu/%llu, cache bytes %zu/%zu\n",
+                       runtime->jit_prescan_threads, (unsigned long long)runtime->jit_prescan_blocks,
+                       (unsigned long long)serial->jit_prescan_blocks, runtime->jit_cache_bytes,
+                       serial->jit_cache_bytes);
+            }
+            failed = 1;
+        }
+        failed = failed || jit_differential_compare(serial, serial_job, runtime, job, func_count, "prescan");
+        if (runtime && job) {
+            (void)fa_Runtime_destroyJob(runtime, job);
+        }
+        fa_Runtime_free(runtime);
+        wasm_module_free(module);
+        if (serial && serial_job) {
+            (void)fa_Runtime_destroyJob(serial, serial_job);
+        }
+        fa_Runtime_free(serial);
+        wasm_module_free(serial_module);
+    }
+    bb_free(&module_bytes);
+
+    /* i32.const 1; end; end: the function ends before its last byte. */
+    static const uint8_t stray_end[] = { 0x41, 0x01, 0x0B, 0x0B };
+    const uint8_t* bodies[] = { stray_end, stray_end };
+    const size_t sizes[] = { sizeof(stray_end), sizeof(stray_end) };
+    if (!failed && !build_module(&module_bytes, bodies, sizes, 2, 0, 0, 0, 0, kResultI32, 1, NULL, 0)) {
+        failed = 1;
+    }
+    for (uint32_t threads = 0; threads <= 2 && !failed; threads += 2) {
+        WasmModule* module = NULL;
+        fa_Runtime* runtime = prescan_runtime(&module_bytes, threads, &module, &status);
+        failed = !runtime || status != FA_RUNTIME_ERR_STREAM;
+        fa_Runtime_free(runtime);
+        wasm_module_free(module);
+    }
+    bb_free(&module_bytes);
+    return failed ? 1 : 0;
+}
+
+/* Lazy prescan: nothing is scanned at attach (so a malformed body that is
+ * never called does not fail it), each function is scanned on its first
+ * call, and with workers the prefetcher scans a direct callee that has not
+ * run yet in the background. */
+static int test_jit_lazy_prescan(void) {
+    test_set_env("FAYASM_MICROCODE", "1");
+    test_set_env("FAYASM_JIT_PRESCAN_LAZY", NULL);
+    test_set_env("FAYASM_JIT_PRESCAN_PREFETCH", NULL);
+    static const uint8_t f_caller[] = { 0x10, 0x01, 0x0B };                    /* call 1 */
+    static const uint8_t f_callee[] = { 0x41, 0x05, 0x0B };                    /* i32.const 5 */
+    static const uint8_t f_stray_end[] = { 0x41, 0x01, 0x0B, 0x0B };           /* ends early */
+    static const uint8_t f_guarded[] = { 0x41, 0x00, 0x04, 0x40, 0x10, 0x04, 0x1A, 0x0B,
+                                         0x41, 0x07, 0x0B };                   /* if (0) call 4 */
+    static const uint8_t f_cold[] = { 0x41, 0x09, 0x0B };
+    const uint8_t* bodies[] = { f_caller, f_callee, f_stray_end, f_guarded, f_cold };
+    const size_t sizes[] = { sizeof(f_caller), sizeof(f_callee), sizeof(f_stray_end), sizeof(f_guarded),
+                             sizeof(f_cold) };
+    ByteBuffer module_bytes = {0};
+    if (!build_module(&module_bytes, bodies, sizes, 5, 0, 0, 0, 0, kResultI32, 1, NULL, 0)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    WasmModule* module = NULL;
+    int status = FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    fa_Runtime* runtime = prescan_runtime(&module_bytes, 0, &module, &status);
+    int failed = !runtime || status != FA_RUNTIME_ERR_STREAM;
+    fa_Runtime_free(runtime);
+    wasm_module_free(module);
+
+    for (int prefetch = 0; prefetch <= 1 && !failed; ++prefetch) {
+        module = load_module_from_bytes(module_bytes.data, module_bytes.size);
+        runtime = fa_Runtime_init();
+        fa_Job* job = NULL;
+        if (!module || !runtime) {
+            failed = 1;
+        } else {
+            runtime->jit_context.config.min_ram_bytes = 0;
+            runtime->jit_context.config.min_cpu_count = 1;
+            runtime->jit_context.config.min_hot_loop_hits = 0;
+            runtime->jit_context.config.min_executed_ops = 1;
+            runtime->jit_context.config.min_advantage_score = 0.0f;
+            runtime->jit_context.config.prescan_functions = true;
+            runtime->jit_context.config.prescan_lazy = true;
+            runtime->jit_context.config.prescan_prefetch = prefetch != 0;
+            runtime->jit_context.config.worker_threads = prefetch ? 2U : 0U;
+            failed = fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK ||
+                     (job = fa_Runtime_createJob(runtime)) == NULL ||
+                     runtime->jit_prescan_lazy != 0 || runtime->jit_cache_bytes != 0;
+        }
+        /* A prefetch of function 1 may land before function 0 reaches its
+           call or be dropped after it; either way it is scanned once. */
+        failed = failed || !execute_expect_i32(runtime, job, 0, 5) ||
+                 runtime->jit_prescan_lazy + runtime->jit_prescan_prefetched != 2;
+        failed = failed || fa_Runtime_executeJob(runtime, job, 2) != FA_RUNTIME_ERR_STREAM;
+        failed = failed || !execute_expect_i32(runtime, job, 3, 7);
+        /* Function 4 is only named by a call that never runs. */
+        fa_Runtime_jitFlush(runtime);
+        const bool prefetched = prefetch && fa_jit_workers_supported();
+        failed = failed || runtime->jit_prescan_lazy + runtime->jit_prescan_prefetched != (prefetched ? 4U : 3U) ||
+                 (prefetched ? runtime->jit_prescan_prefetched == 0 : runtime->jit_prescan_prefetched != 0) ||
+                 (fa_ops_microcode_enabled() && runtime->jit_cache_bytes == 0);
+        failed = failed || !execute_expect_i32(runtime, job, 4, 9) ||
+                 runtime->jit_prescan_lazy + runtime->jit_prescan_prefetched != 4U;
+        if (runtime && job) {
+            (void)fa_Runtime_destroyJob(runtime, job);
+        }
+        fa_Runtime_free(runtime);
+        wasm_module_free(module);
+    }
+    bb_free(&module_bytes);
+    return failed ? 1 : 0;
+}
+
+/* Writes `local.get 0` followed by `reps` x (i32.const step; i32.add). */
+static int native_cache_big_body(ByteBuffer* body, uint32_t reps, i32 step) {
+    if (!bb_write_byte(body, 0x20) || !bb_write_byte(body, 0x00)) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < reps; ++i) {
+        if (!bb_write_byte(body, 0x41) || !bb_write_sleb32(body, step) || !bb_write_byte(body, 0x6A)) {
+            return 0;
+        }
+    }
+    return bb_write_byte(body, 0x0B);
+}
+
+static int native_cache_call(fa_Runtime* runtime, fa_Job* job, uint32_t function_index, i32 arg, i32 expected) {
+    fa_JobValue args[1];
+    args[0] = sample_arg_i32(arg);
+    if (fa_Runtime_executeJobWithArgs(runtime, job, function_index, args, 1) != FA_RUNTIME_OK) {
+        return 0;
+    }
+    const fa_JobValue* value = fa_JobStack_peek(&job->stack, 0);
+    return value && value->kind == fa_job_value_i32 && value->payload.i32_value == expected;
+}
+
+static int test_jit_native_code_cache(void) {
+    if (!fa_jit_native_supported()) {
+        printf("SKIP: test_jit_native_code_cache (no native backend for this target)\n");
+        return 0;
+    }
+    int failed = 0;
+
+    /* Slab allocator: small blocks share a slab, first fit reuses a released
+       block, oversized code gets its own slab and empty slabs are unmapped. */
+#if defined(FA_JIT_NATIVE_X86_64)
+    static const uint8_t ret42[] = { 0xB8, 0x2A, 0x00, 0x00, 0x00, 0xC3 };             /* mov eax, 42; ret */
+#else
+    static const uint8_t ret42[] = { 0x40, 0x05, 0x80, 0x52, 0xC0, 0x03, 0x5F, 0xD6 }; /* mov w0, #42; ret */
+#endif
+    fa_JitCodeCache cache;
+    fa_jit_code_cache_init(&cache, 4096U);
+    void* blocks[3];
+    size_t block_bytes[3];
+    for (int i = 0; i < 3; ++i) {
+        blocks[i] = fa_jit_code_cache_install(&cache, ret42, sizeof(ret42), &block_bytes[i]);
+        if (!blocks[i] || block_bytes[i] != FA_JIT_CODE_ALIGN || ((uintptr_t)blocks[i] % FA_JIT_CODE_ALIGN) != 0) {
+            failed = 1;
+        }
+    }
+    if (!failed) {
+        int (*fn)(void) = NULL;
+        memcpy(&fn, &blocks[2], sizeof(fn));
+        if (cache.slab_count != 1 || (uint8_t*)blocks[1] != (uint8_t*)blocks[0] + FA_JIT_CODE_ALIGN || fn() != 42) {
+            failed = 1;
+        }
+        fa_jit_code_cache_release(&cache, blocks[1], block_bytes[1]);
+        if (fa_jit_code_cache_install(&cache, ret42, sizeof(ret42), &block_bytes[1]) != blocks[1]) {
+            failed = 1;
+        }
+        uint8_t* large = (uint8_t*)calloc(6000U, 1U);
+        size_t large_bytes = 0;
+        void* large_block = large ? fa_jit_code_cache_install(&cache, large, 6000U, &large_bytes) : NULL;
+        if (!large_block || cache.slab_count != 2 || cache.mapped_bytes < 4096U + 6000U) {
+            failed = 1;
+        }
+        free(large);
+        fa_jit_code_cache_release(&cache, large_block, large_bytes);
+        for (int i = 0; i < 3; ++i) {
+            fa_jit_code_cache_release(&cache, blocks[i], block_bytes[i]);
+        }
+        if (cache.slab_count != 0 || cache.mapped_bytes != 0 || cache.live_bytes != 0) {
+            failed = 1;
+        }
+    }
+    fa_jit_code_cache_destroy(&cache);
+    if (failed) {
+        printf("native code cache: slab allocator mismatch\n");
+        return 1;
+    }
+
+    /* Runtime: three functions of ~27 KiB against the 64 KiB minimum budget,
+       so only two fit. Size the bodies from a trial emission first. */
+    static const uint8_t params[] = { VALTYPE_I32 };
+    /* f3(a) = f4(0), f4(a); f4(a) = a ? f2(a) : 0 */
+    static const uint8_t f_outer[] = { 0x41, 0x00, 0x10, 0x04, 0x1A, 0x20, 0x00, 0x10, 0x04, 0x0B };
+    static const uint8_t f_inner[] = {
+        0x20, 0x00, 0x04, 0x7F, 0x20, 0x00, 0x10, 0x02, 0x05, 0x41, 0x00, 0x0B, 0x0B
+    };
+    ByteBuffer trial = {0};
+    ByteBuffer trial_module = {0};
+    const uint32_t trial_reps = 256U;
+    const uint8_t* trial_bodies[1];
+    size_t trial_sizes[1];
+    uint32_t reps = 0;
+    if (native_cache_big_body(&trial, trial_reps, 1)) {
+        trial_bodies[0] = trial.data;
+        trial_sizes[0] = trial.size;
+        if (build_module(&trial_module, trial_bodies, trial_sizes, 1, 0, 0, 0, 0, kResultI32, 1, params, 1)) {
+            WasmModule* module = load_module_from_bytes(trial_module.data, trial_module.size);
+            if (module) {
+                fa_JitNativeRequest request;
+                memset(&request, 0, sizeof(request));
+                request.module = module;
+                request.func_index = 0;
+                request.body = wasm_load_function_body(module, 0);
+                request.body_size = module->functions[0].body_size;
+                uint8_t* code = NULL;
+                size_t size = 0;
+                if (request.body && fa_jit_native_emit(&request, FA_JIT_NATIVE_ARCH_HOST, &code, &size, NULL) && size > 0) {
+                    reps = (uint32_t)((27U * 1024U * (size_t)trial_reps) / size);
+                }
+                free(code);
+                free((void*)request.body);
+                wasm_module_free(module);
+            }
+        }
+    }
+    bb_free(&trial);
+    bb_free(&trial_module);
+    if (reps == 0) {
+        return 1;
+    }
+
+    ByteBuffer big[3] = { {0}, {0}, {0} };
+    ByteBuffer module_bytes = {0};
+    for (int i = 0; i < 3; ++i) {
+        if (!native_cache_big_body(&big[i], reps, i + 1)) {
+            failed = 1;
+        }
+    }
+    const uint8_t* bodies[] = { big[0].data, big[1].data, big[2].data, f_outer, f_inner };
+    const size_t sizes[] = { big[0].size, big[1].size, big[2].size, sizeof(f_outer), sizeof(f_inner) };
+    if (failed || !build_module(&module_bytes, bodies, sizes, 5, 0, 0, 0, 0, kResultI32, 1, params, 1)) {
+        for (int i = 0; i < 3; ++i) {
+            bb_free(&big[i]);
+        }
+        bb_free(&module_bytes);
+        return 1;
+    }
+    for (int i = 0; i < 3; ++i) {
+        bb_free(&big[i]);
+    }
+    fa_Runtime* runtime = NULL;
+    fa_Job* job = NULL;
+    WasmModule* module = NULL;
+    if (!run_job(&module_bytes, &runtime, &job, &module)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    runtime->jit_context.config.min_ram_bytes = 0;
+    runtime->jit_context.config.min_cpu_count = 1;
+    runtime->jit_context.config.min_hot_loop_hits = 0;
+    runtime->jit_context.config.min_executed_ops = 1;
+    runtime->jit_context.config.min_advantage_score = 0.0f;
+    runtime->jit_context.config.max_cache_percent = 0;
+    runtime->jit_context.config.native_tier = true;
+
+    const i32 span = (i32)reps;
+    /* f0 is hot, f1 warm: both compiled and resident. */
+    for (int i = 0; i < 4 && !failed; ++i) {
+        failed = !native_cache_call(runtime, job, 0, i, i + span);
+    }
+    if (!failed) {
+        failed = !native_cache_call(runtime, job, 1, 1, 1 + 2 * span) ||
+                 !native_cache_call(runtime, job, 1, 2, 2 + 2 * span);
+    }
+    if (!failed && (!fa_Runtime_jitIsNative(runtime, 0) || !fa_Runtime_jitIsNative(runtime, 1) ||
+                    runtime->jit_cache_evictions != 0)) {
+        printf("native code cache: warm-up compiled f0=%d f1=%d evictions=%llu\n",
+               fa_Runtime_jitIsNative(runtime, 0) ? 1 : 0, fa_Runtime_jitIsNative(runtime, 1) ? 1 : 0,
+               (unsigned long long)runtime->jit_cache_evictions);
+        failed = 1;
+    }
+    /* f3 runs natively; its first call compiles f4 through call_slow and its
+       second calls f4 directly, native to native. f4 then reaches f2 through
+       call_slow, whose compilation has to evict while f4's code is on the
+       machine stack: f3 is pinned by its runtime-entered frame, so the
+       coldest functions are f4 (parked until f3 returns) and then f1, and
+       the hot f0 stays. */
+    if (!failed && !native_cache_call(runtime, job, 3, 5, 5 + 3 * span)) {
+        failed = 1;
+    }
+    const size_t budget = (size_t)runtime->jit_context.decision.budget.cache_budget_bytes;
+    if (!failed && (runtime->jit_cache_evictions == 0 || !fa_Runtime_jitIsNative(runtime, 0) ||
+                    fa_Runtime_jitIsNative(runtime, 1) || !fa_Runtime_jitIsNative(runtime, 2) ||
+                    !fa_Runtime_jitIsNative(runtime, 3) || fa_Runtime_jitIsNative(runtime, 4) ||
+                    runtime->jit_native_retired_count != 0 || runtime->jit_cache_bytes > budget ||
+                    !runtime->jit_code_cache || runtime->jit_code_cache->live_bytes > budget)) {
+        printf("native code cache: after eviction f0=%d f1=%d f2=%d retired=%u bytes=%zu budget=%zu\n",
+               fa_Runtime_jitIsNative(runtime, 0) ? 1 : 0, fa_Runtime_jitIsNative(runtime, 1) ? 1 : 0,
+               fa_Runtime_jitIsNative(runtime, 2) ? 1 : 0, runtime->jit_native_retired_count,
+               runtime->jit_cache_bytes, budget);
+        failed = 1;
+    }
+    /* Evicted functions recompile on their next call. */
+    if (!failed && (!native_cache_call(runtime, job, 3, 7, 7 + 3 * span) ||
+                    !native_cache_call(runtime, job, 1, 3, 3 + 2 * span) ||
+                    !native_cache_call(runtime, job, 0, 9, 9 + span) ||
+                    runtime->jit_cache_bytes > budget)) {
+        failed = 1;
+    }
+    cleanup_job(runtime, job, module, &module_bytes, NULL);
+    return failed;
+}
+
+static int osr_call(fa_Runtime* runtime, fa_Job* job, uint32_t function_index, i32 a, i32 b, i32* result) {
+    fa_JobValue args[2];
+    args[0] = sample_arg_i32(a);
+    args[1] = sample_arg_i32(b);
+    const int status = fa_Runtime_executeJobWithArgs(runtime, job, function_index, args, 2);
+    const fa_JobValue* value = fa_JobStack_peek(&job->stack, 0);
+    *result = (status == FA_RUNTIME_OK && value && value->kind == fa_job_value_i32) ? value->payload.i32_value : 0;
+    return status;
+}
+
+/* Tier-up and on-stack replacement. Each job starts with the JIT off (too few
+ * executed ops), so the function is entered by the interpreter; the native
+ * tier is chosen a few hundred ops into its loop and the frame then moves
+ * into native code at the loop header, carrying its locals and a live
+ * operand-stack value. A trap raised after the transfer surfaces as the
+ * job's status. Separately, native_threshold defers compilation until the
+ * N-th call. */
+static int test_jit_osr_loop(void) {
+    if (!fa_jit_native_supported()) {
+        printf("SKIP: test_jit_osr_loop (no native backend for this target)\n");
+        return 0;
+    }
+    /* f0(a, _) = 7 + sum(i for i < a), with the 7 on the stack across the loop */
+    static const uint8_t f_sum[] = {
+        0x41, 0x07,
+        0x02, 0x40, 0x03, 0x40,
+        0x20, 0x03, 0x20, 0x02, 0xAD, 0x7C, 0x21, 0x03,
+        0x20, 0x02, 0x41, 0x01, 0x6A, 0x22, 0x02, 0x20, 0x00, 0x48, 0x0D, 0x00,
+        0x0B, 0x0B,
+        0x20, 0x03, 0xA7, 0x6A,
+        0x0B
+    };
+    /* f1(a, b) = sum(100 / (a - i) for i < b): traps once i reaches a */
+    static const uint8_t f_div[] = {
+        0x03, 0x40,
+        0x20, 0x03, 0x41, 0xE4, 0x00, 0x20, 0x00, 0x20, 0x02, 0x6B, 0x6D, 0x6A, 0x21, 0x03,
+        0x20, 0x02, 0x41, 0x01, 0x6A, 0x22, 0x02, 0x20, 0x01, 0x48, 0x0D, 0x00,
+        0x0B,
+        0x20, 0x03,
+        0x0B
+    };
+    static const uint8_t f_add[] = { 0x20, 0x00, 0x20, 0x01, 0x6A, 0x0B };
+    static const uint8_t i32_and_i64_local[] = { 0x02, 0x01, 0x7F, 0x01, 0x7E };
+    static const uint8_t two_i32_locals[] = { 0x01, 0x02, 0x7F };
+    const uint8_t* bodies[] = { f_sum, f_div, f_add };
+    const size_t body_sizes[] = { sizeof(f_sum), sizeof(f_div), sizeof(f_add) };
+    const uint8_t* locals[] = { i32_and_i64_local, two_i32_locals, NULL };
+    const size_t locals_sizes[] = { sizeof(i32_and_i64_local), sizeof(two_i32_locals), 0 };
+    const uint8_t params[] = { VALTYPE_I32, VALTYPE_I32 };
+    ByteBuffer module_bytes = {0};
+    if (!build_module_with_locals(&module_bytes, bodies, body_sizes, locals, locals_sizes, 3,
+                                  NULL, NULL, 0, 0, 0, 0, kResultI32, 1, params, 2)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    fa_Runtime* runtime = NULL;
+    fa_Job* job = NULL;
+    WasmModule* module = NULL;
+    if (!run_job(&module_bytes, &runtime, &job, &module)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    runtime->jit_context.config.min_ram_bytes = 0;
+    runtime->jit_context.config.min_cpu_count = 1;
+    runtime->jit_context.config.min_hot_loop_hits = 16;
+    runtime->jit_context.config.min_executed_ops = 256;
+    runtime->jit_context.config.min_advantage_score = 0.5f;
+    runtime->jit_context.config.native_tier = true;
+    runtime->jit_context.config.osr_threshold = 32;
+
+    int failed = 0;
+    i32 result = 0;
+    for (i32 round = 0; round < 2 && !failed; ++round) {
+        const i32 n = 2000 + round;
+        if (osr_call(runtime, job, 0, n, 0, &result) != FA_RUNTIME_OK || result != 7 + n * (n - 1) / 2 ||
+            runtime->jit_osr_entries != (uint64_t)round + 1U) {
+            printf("osr: sum(%d) = %d, osr entries %llu\n", n, result, (unsigned long long)runtime->jit_osr_entries);
+            failed = 1;
+        }
+    }
+    i32 expected = 0;
+    for (i32 i = 0; i < 200; ++i) {
+        expected += 100 / (300 - i);
+    }
+    if (!failed && (osr_call(runtime, job, 1, 300, 200, &result) != FA_RUNTIME_OK || result != expected ||
+                    osr_call(runtime, job, 1, 300, 400, &result) != FA_RUNTIME_ERR_TRAP ||
+                    runtime->jit_osr_entries != 4U)) {
+        printf("osr: div loop result %d (expected %d), osr entries %llu\n",
+               result, expected, (unsigned long long)runtime->jit_osr_entries);
+        failed = 1;
+    }
+    /* osr_threshold 0 keeps the frame interpreted. */
+    runtime->jit_context.config.osr_threshold = 0;
+    if (!failed && (osr_call(runtime, job, 0, 500, 0, &result) != FA_RUNTIME_OK ||
+                    result != 7 + 500 * 499 / 2 || runtime->jit_osr_entries != 4U)) {
+        failed = 1;
+    }
+
+    /* Both backends emit the OSR entry; it only exists at a loop header. */
+    fa_JitNativeRequest request;
+    memset(&request, 0, sizeof(request));
+    request.module = module;
+    request.func_index = 0;
+    request.body = wasm_load_function_body(module, 0);
+    request.body_size = module->functions[0].body_size;
+    for (int arch = FA_JIT_NATIVE_ARCH_X86_64; arch <= FA_JIT_NATIVE_ARCH_AARCH64 && !failed; ++arch) {
+        uint8_t* code = NULL;
+        size_t size = 0;
+        request.osr_pc = sizeof(i32_and_i64_local) + 6U; /* past i32.const 7, block, loop */
+        if (!request.body || !fa_jit_native_emit(&request, (fa_JitNativeArch)arch, &code, &size, NULL)) {
+            printf("osr: no OSR entry for arch %d\n", arch);
+            failed = 1;
+        }
+        free(code);
+        code = NULL;
+        request.osr_pc += 2U;
+        if (fa_jit_native_emit(&request, (fa_JitNativeArch)arch, &code, &size, NULL)) {
+            failed = 1;
+        }
+        free(code);
+    }
+    free((void*)request.body);
+
+    /* Tier-up counter: f2 compiles on its third call. */
+    runtime->jit_context.config.min_hot_loop_hits = 0;
+    runtime->jit_context.config.min_executed_ops = 1;
+    runtime->jit_context.config.min_advantage_score = 0.0f;
+    runtime->jit_context.config.native_threshold = 3;
+    for (i32 call = 1; call <= 3 && !failed; ++call) {
+        if (osr_call(runtime, job, 2, call, 40, &result) != FA_RUNTIME_OK || result != call + 40 ||
+            fa_Runtime_jitIsNative(runtime, 2) != (call == 3)) {
+            printf("osr: tier-up call %d native=%d\n", call, fa_Runtime_jitIsNative(runtime, 2) ? 1 : 0);
+            failed = 1;
+        }
+    }
+    cleanup_job(runtime, job, module, &module_bytes, NULL);
+    return failed;
+}
+
+typedef struct {
+    uint8_t* blobs[TEST_JIT_BLOB_SLOTS];
+    size_t sizes[TEST_JIT_BLOB_SLOTS];
+    uint32_t spills;
+    uint32_t loads;
+    uint32_t closure_blobs;
+} ClosureBlobState;
+
+/* Spill hooks that persist the whole fa_JitProgram blob, closure records
+   included, the way an embedder with flash storage would. */
+static int closure_blob_spill_hook(fa_Runtime* runtime,
+                                   uint32_t function_index,
+                                   const fa_JitProgram* program,
+                                   size_t program_bytes,
+                                   void* user_data) {
+    (void)runtime;
+    (void)program_bytes;
+    ClosureBlobState* state = (ClosureBlobState*)user_data;
+    if (!state || !program || function_index >= TEST_JIT_BLOB_SLOTS) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    const size_t size = fa_jit_program_serialized_size(program);
+    uint8_t* blob = size ? (uint8_t*)malloc(size) : NULL;
+    size_t written = 0;
+    if (!blob || !fa_jit_program_serialize(program, blob, size, &written) || written != size) {
+        free(blob);
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    free(state->blobs[function_index]);
+    state->blobs[function_index] = blob;
+    state->sizes[function_index] = size;
+    state->spills += 1;
+    if (program->closure) {
+        state->closure_blobs += 1;
+    }
+    return FA_RUNTIME_OK;
+}
+
+static int closure_blob_load_hook(fa_Runtime* runtime,
+                                  uint32_t function_index,
+                                  fa_JitProgram* program_out,
+                                  void* user_data) {
+    (void)runtime;
+    ClosureBlobState* state = (ClosureBlobState*)user_data;
+    if (!state || !program_out || function_index >= TEST_JIT_BLOB_SLOTS) {
+        return FA_RUNTIME_ERR_INVALID_ARGUMENT;
+    }
+    if (!state->blobs[function_index]) {
+        return FA_RUNTIME_ERR_STREAM;
+    }
+    if (!fa_jit_program_deserialize(state->blobs[function_index], state->sizes[function_index], program_out)) {
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    state->loads += 1;
+    return FA_RUNTIME_OK;
+}
+
+/* env.spill() -> 0: spills memory 0 out from under its caller. */
+static int host_spill_memory(fa_Runtime* runtime, const fa_RuntimeHostCall* call, void* user_data) {
+    (void)user_data;
+    if (!fa_RuntimeHostCall_expect(call, 0, 1) || fa_Runtime_spillMemory(runtime, 0) != FA_RUNTIME_OK ||
+        !fa_RuntimeHostCall_set_i32(call, 0, 0)) {
+        return FA_RUNTIME_ERR_TRAP;
+    }
+    return FA_RUNTIME_OK;
+}
+
+/* f1 bumps the counter at mem[0], calls env.spill and loads the counter
+ * back: compiled code resumes
+ * after the import with memory 0 reloaded, as the interpreter does. Runs
+ * interpreted, in native code where there is a backend, and in closure
+ * records. */
+static int test_jit_host_spills_memory(void) {
+    static const uint8_t body[] = {
+        0x41, 0x00, 0x41, 0x00, 0x28, 0x02, 0x00, 0x41, 0x01, 0x6A, 0x36, 0x02, 0x00,
+        0x10, 0x00, 0x1A,
+        0x41, 0x00, 0x28, 0x02, 0x00, 0x0B
+    };
+    ByteBuffer imports = {0};
+    bb_write_uleb(&imports, 1);
+    bb_write_string(&imports, "env");
+    bb_write_string(&imports, "spill");
+    bb_write_byte(&imports, 0);
+    bb_write_uleb(&imports, 0);
+    const uint8_t* bodies[] = { body };
+    const size_t sizes[] = { sizeof(body) };
+    const uint8_t types[] = { VALTYPE_I32 };
+    ByteBuffer module_bytes = {0};
+    int failed = !build_module_with_locals(&module_bytes, bodies, sizes, NULL, NULL, 1, &imports, NULL, 1, 1, 0, 0,
+                                           types, 1, NULL, 0);
+    bb_free(&imports);
+
+    for (int tier = 0; tier < 3 && !failed; ++tier) {
+        if (tier == 1 && !fa_jit_native_supported()) {
+            continue;
+        }
+        fa_Runtime* runtime = NULL;
+        fa_Job* job = NULL;
+        WasmModule* module = NULL;
+        if (!run_job(&module_bytes, &runtime, &job, &module)) {
+            failed = 1;
+            break;
+        }
+        OffloadState state = {0};
+        fa_RuntimeSpillHooks hooks = {
+            NULL, NULL, offload_memory_spill_hook, offload_memory_load_hook, &state
+        };
+        fa_Runtime_setSpillHooks(runtime, &hooks);
+        failed = fa_Runtime_bindHostFunction(runtime, "env", "spill", host_spill_memory, NULL) != FA_RUNTIME_OK;
+        fa_JitConfig* config = &runtime->jit_context.config;
+        if (tier == 0) {
+            config->min_advantage_score = 2.0f; /* never reachable: stays interpreted */
+        } else {
+            config->min_ram_bytes = 0;
+            config->min_cpu_count = 1;
+            config->min_hot_loop_hits = 0;
+            config->min_executed_ops = 1;
+            config->min_advantage_score = 0.0f;
+            config->native_tier = tier == 1;
+            config->closure_tier = tier == 2;
+        }
+        for (i32 i = 0; i < 4 && !failed; ++i) {
+            failed = !execute_expect_i32(runtime, job, 1, i + 1);
+        }
+        const bool compiled = tier == 1 ? fa_Runtime_jitIsNative(runtime, 1)
+                                        : tier == 2 ? fa_Runtime_jitIsClosure(runtime, 1) : true;
+        if (failed || !compiled || state.memory_spill_calls < 4 || state.memory_load_calls < 4) {
+            printf("host spill: tier %d compiled=%d spills=%d loads=%d\n", tier, compiled ? 1 : 0,
+                   state.memory_spill_calls, state.memory_load_calls);
+            failed = 1;
+        }
+        offload_state_free(&state);
+        cleanup_job(runtime, job, module, NULL, NULL);
+    }
+    bb_free(&module_bytes);
+    return failed;
+}
+
+/* Closure tier: the shared differential module runs on a runtime forced to
+ * FA_JIT_TIER_CLOSURE with the native tier off, so it covers every target.
+ * Then a spilled function comes back from its persisted records without
+ * being lowered again, corrupt record blobs are rejected, and a hot
+ * interpreted loop transfers into closure records through OSR. */
+static int test_jit_closure_tier(void) {
+    ByteBuffer module_bytes = {0};
+    uint32_t func_count = 0;
+    if (!jit_differential_module(&module_bytes, &func_count)) {
+        return 1;
+    }
+    fa_Runtime* interp = NULL;
+    fa_Job* interp_job = NULL;
+    WasmModule* interp_module = NULL;
+    fa_Runtime* runtime = NULL;
+    fa_Job* job = NULL;
+    WasmModule* module = NULL;
+    if (!run_job(&module_bytes, &interp, &interp_job, &interp_module)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    if (!run_job(&module_bytes, &runtime, &job, &module)) {
+        cleanup_job(interp, interp_job, interp_module, &module_bytes, NULL);
+        return 1;
+    }
+    interp->jit_context.config.min_advantage_score = 2.0f; /* never reachable: stays interpreted */
+    runtime->jit_context.config.min_ram_bytes = 0;
+    runtime->jit_context.config.min_cpu_count = 1;
+    runtime->jit_context.config.min_hot_loop_hits = 0;
+    runtime->jit_context.config.min_executed_ops = 1;
+    runtime->jit_context.config.min_advantage_score = 0.0f;
+    runtime->jit_context.config.native_tier = false;
+    runtime->jit_context.config.closure_tier = true;
+    ClosureBlobState blobs;
+    memset(&blobs, 0, sizeof(blobs));
+    fa_RuntimeSpillHooks hooks = { closure_blob_spill_hook, closure_blob_load_hook, NULL, NULL, &blobs };
+    fa_Runtime_setSpillHooks(runtime, &hooks);
+
+    int failed = jit_differential_compare(interp, interp_job, runtime, job, func_count, "closure");
+    if (!failed) {
+        for (uint32_t f = 0; f < func_count; ++f) {
+            const bool compiled = fa_Runtime_jitIsClosure(runtime, f);
+            if (compiled != (f != 7U) || fa_Runtime_jitIsNative(runtime, f)) {
+                printf("closure tier: function %u compiled=%d\n", f, compiled ? 1 : 0);
+                failed = 1;
+            }
+        }
+        if (runtime->jit_context.decision.tier != FA_JIT_TIER_CLOSURE ||
+            runtime->jit_closure_calls == 0 || runtime->jit_native_calls != 0 ||
+            interp->jit_closure_calls != 0) {
+            failed = 1;
+        }
+    }
+
+    /* Spill f1 (the loop) and f3 (recursive fib): both come back from the
+       persisted records on their next call. */
+    if (!failed && (fa_Runtime_jitSpillProgram(runtime, 1) != FA_RUNTIME_OK ||
+                    fa_Runtime_jitSpillProgram(runtime, 3) != FA_RUNTIME_OK ||
+                    fa_Runtime_jitIsClosure(runtime, 1) || blobs.closure_blobs != 2U)) {
+        printf("closure tier: spill closure_blobs=%u\n", blobs.closure_blobs);
+        failed = 1;
+    }
+    if (!failed) {
+        const uint64_t calls_before = runtime->jit_closure_calls;
+        failed = jit_differential_compare(interp, interp_job, runtime, job, 4, "closure (reloaded)");
+        if (!failed && (blobs.loads < 2U || !fa_Runtime_jitIsClosure(runtime, 1) ||
+                        !fa_Runtime_jitIsClosure(runtime, 3) || runtime->jit_closure_calls == calls_before)) {
+            printf("closure tier: reload loads=%u\n", blobs.loads);
+            failed = 1;
+        }
+    }
+    if (!failed) {
+        fa_JitProgram program;
+        memset(&program, 0, sizeof(program));
+        if (!fa_jit_program_deserialize(blobs.blobs[1], blobs.sizes[1], &program) || !program.closure ||
+            program.closure->count == 0) {
+            failed = 1;
+        }
+        fa_jit_program_free(&program);
+        /* A record whose successor index points past the program is rejected. */
+        uint8_t* corrupt = (uint8_t*)malloc(blobs.sizes[1]);
+        if (!failed && corrupt) {
+            memcpy(corrupt, blobs.blobs[1], blobs.sizes[1]);
+            memset(corrupt + blobs.sizes[1] - 28U, 0x7F, 4U); /* last record's target */
+            memset(&program, 0, sizeof(program));
+            if (fa_jit_program_deserialize(corrupt, blobs.sizes[1], &program)) {
+                printf("closure tier: corrupt record blob accepted\n");
+                failed = 1;
+            }
+            fa_jit_program_free(&program);
+        }
+        free(corrupt);
+    }
+    /* f9 (global.get/global.set) spilled with its global index pushed past
+       the module's globals: the blob still decodes, but the runtime refuses
+       to adopt it and lowers the body again. */
+    if (!failed && fa_Runtime_jitSpillProgram(runtime, 9) != FA_RUNTIME_OK) {
+        failed = 1;
+    }
+    if (!failed) {
+        fa_JitProgram program;
+        memset(&program, 0, sizeof(program));
+        uint32_t patched = 0;
+        if (fa_jit_program_deserialize(blobs.blobs[9], blobs.sizes[9], &program) && program.closure) {
+            failed = !fa_jit_closure_globals_valid(program.closure, module);
+            for (uint32_t i = 0; i < program.closure->count; ++i) {
+                fa_JitClosure* record = &program.closure->records[i];
+                if (record->op == FA_NIR_GLOBAL_GET || record->op == FA_NIR_GLOBAL_SET) {
+                    record->imm = 1000U;
+                    patched++;
+                }
+            }
+        }
+        const size_t size = fa_jit_program_serialized_size(&program);
+        failed = failed || patched == 0 || fa_jit_closure_globals_valid(program.closure, module) ||
+                 size != blobs.sizes[9] || !fa_jit_program_serialize(&program, blobs.blobs[9], size, NULL);
+        fa_jit_program_free(&program);
+        const uint32_t loads_before = blobs.loads;
+        failed = failed || jit_differential_compare(interp, interp_job, runtime, job, 10, "closure (bad global)") ||
+                 blobs.loads != loads_before + 1U || !fa_Runtime_jitIsClosure(runtime, 9);
+        if (failed) {
+            printf("closure tier: out-of-range global record patched=%u\n", patched);
+        }
+    }
+
+    /* OSR: the job starts interpreted and its loop moves into closure
+       records once the tier comes on. */
+    runtime->jit_context.config.min_hot_loop_hits = 16;
+    runtime->jit_context.config.min_executed_ops = 256;
+    runtime->jit_context.config.min_advantage_score = 0.5f;
+    runtime->jit_context.config.osr_threshold = 32;
+    if (!failed) {
+        const uint64_t entries_before = runtime->jit_osr_entries;
+        i32 expected = 0;
+        i32 result = 0;
+        if (osr_call(interp, interp_job, 1, 2000, 0, &expected) != FA_RUNTIME_OK ||
+            osr_call(runtime, job, 1, 2000, 0, &result) != FA_RUNTIME_OK || result != expected ||
+            runtime->jit_osr_entries != entries_before + 1U) {
+            printf("closure tier: osr result %d (expected %d), osr entries %llu\n",
+                   result, expected, (unsigned long long)runtime->jit_osr_entries);
+            failed = 1;
+        }
+    }
+
+    /* Without the closure knob the portable fallback stays microcode. */
+    fa_JitConfig config = runtime->jit_context.config;
+    const fa_JitStats stats = { 100000U, 100000U, 1000U };
+    config.native_tier = false;
+    if (!failed && fa_jit_decide(&runtime->jit_context.probe, &config, &stats).tier != FA_JIT_TIER_CLOSURE) {
+        failed = 1;
+    }
+    config.closure_tier = false;
+    if (!failed && fa_jit_decide(&runtime->jit_context.probe, &config, &stats).tier != FA_JIT_TIER_MICROCODE) {
+        failed = 1;
+    }
+    cleanup_job(runtime, job, module, NULL, NULL);
+    cleanup_job(interp, interp_job, interp_module, &module_bytes, NULL);
+    for (size_t i = 0; i < TEST_JIT_BLOB_SLOTS; ++i) {
+        free(blobs.blobs[i]);
+    }
+    return failed;
+}
+
+/* Background compilation: with worker_threads set, the first call of a
+ * function only queues its compilation and keeps interpreting; results are
+ * installed at later safe points (or by fa_Runtime_jitFlush). Covers the
+ * native tier and, where microcode is enabled on this host, microcode
+ * preparation; every call must return what the interpreter returns. */
+static int test_jit_background_workers(void) {
+    if (!fa_jit_workers_supported()) {
+        printf("SKIP: test_jit_background_workers (no threads on this target)\n");
+        return 0;
+    }
+    /* f0(a, b) = sum(i for i < a) + b; f1(a, b) = a * b - f0(a, b) */
+    static const uint8_t f_sum[] = {
+        0x02, 0x40, 0x20, 0x00, 0x41, 0x00, 0x4C, 0x0D, 0x00,
+        0x03, 0x40,
+        0x20, 0x03, 0x20, 0x02, 0x6A, 0x21, 0x03,
+        0x20, 0x02, 0x41, 0x01, 0x6A, 0x22, 0x02, 0x20, 0x00, 0x48, 0x0D, 0x00,
+        0x0B, 0x0B,
+        0x20, 0x03, 0x20, 0x01, 0x6A,
+        0x0B
+    };
+    static const uint8_t f_mix[] = {
+        0x20, 0x00, 0x20, 0x01, 0x6C, 0x20, 0x00, 0x20, 0x01, 0x10, 0x00, 0x6B, 0x0B
+    };
+    static const uint8_t two_i32_locals[] = { 0x01, 0x02, 0x7F };
+    const uint8_t* bodies[] = { f_sum, f_mix };
+    const size_t body_sizes[] = { sizeof(f_sum), sizeof(f_mix) };
+    const uint8_t* locals[] = { two_i32_locals, NULL };
+    const size_t locals_sizes[] = { sizeof(two_i32_locals), 0 };
+    const uint8_t params[] = { VALTYPE_I32, VALTYPE_I32 };
+    ByteBuffer module_bytes = {0};
+    if (!build_module_with_locals(&module_bytes, bodies, body_sizes, locals, locals_sizes, 2,
+                                  NULL, NULL, 0, 0, 0, 0, kResultI32, 1, params, 2)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    int failed = 0;
+    for (int native_tier = 0; native_tier <= 1 && !failed; ++native_tier) {
+        if (native_tier ? !fa_jit_native_supported() : !fa_ops_microcode_enabled()) {
+            continue;
+        }
+        fa_Runtime* runtime = NULL;
+        fa_Job* job = NULL;
+        WasmModule* module = NULL;
+        if (!run_job(&module_bytes, &runtime, &job, &module)) {
+            bb_free(&module_bytes);
+            return 1;
+        }
+        runtime->jit_context.config.min_ram_bytes = 0;
+        runtime->jit_context.config.min_cpu_count = 1;
+        runtime->jit_context.config.min_hot_loop_hits = 0;
+        runtime->jit_context.config.min_executed_ops = 1;
+        runtime->jit_context.config.min_advantage_score = 0.0f;
+        runtime->jit_context.config.max_cache_percent = 0;
+        runtime->jit_context.config.native_tier = native_tier != 0;
+        runtime->jit_context.config.worker_threads = 2;
+        for (i32 call = 0; call < 200 && !failed; ++call) {
+            const i32 a = call % 37;
+            const i32 b = call - 100;
+            const i32 sum = a * (a - 1) / 2 + b;
+            i32 result = 0;
+            const uint32_t f = (uint32_t)(call % 2);
+            if (osr_call(runtime, job, f, a, b, &result) != FA_RUNTIME_OK || result != (f == 0 ? sum : a * b - sum)) {
+                printf("jit workers: tier %d call %d f%u(%d, %d) = %d\n", native_tier, call, f, a, b, result);
+                failed = 1;
+            }
+            if (call == 0 && !failed) {
+                /* The first call only queued work. */
+                if (!runtime->jit_workers || (native_tier && runtime->jit_native_calls != 0)) {
+                    failed = 1;
+                }
+                fa_Runtime_jitFlush(runtime);
+                if (runtime->jit_async_installs == 0 || (native_tier && !fa_Runtime_jitIsNative(runtime, 0))) {
+                    printf("jit workers: tier %d flush installed %llu\n", native_tier,
+                           (unsigned long long)runtime->jit_async_installs);
+                    failed = 1;
+                }
+            }
+        }
+        fa_Runtime_jitFlush(runtime);
+        if (!failed && (native_tier ? (runtime->jit_native_calls == 0 || !fa_Runtime_jitIsNative(runtime, 1))
+                                    : runtime->jit_prepared_executions == 0)) {
+            printf("jit workers: tier %d never ran compiled code\n", native_tier);
+            failed = 1;
+        }
+        cleanup_job(runtime, job, module, NULL, NULL);
+    }
+    bb_free(&module_bytes);
+    return failed;
+}
+
+/* Fused op pairs: every pair in the fused table, as i32 (f0) and i64 (f1),
+ * with shift counts past the width and negative operands. Results must match
+ * with fusion on and off, and only the fused run may report fused executions. */
+static int test_jit_fused_op_pairs(void) {
+    test_set_env("FAYASM_MICROCODE", "1");
+    if (!fa_ops_microcode_enabled()) {
+        return 1;
+    }
+    /* a + a*b + (a << b) + (b + a) + ((a & b) == 0) */
+    static const uint8_t f_i32[] = {
+        0x20, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6C, 0x6A,
+        0x20, 0x00, 0x20, 0x01, 0x74, 0x6A,
+        0x20, 0x01, 0x20, 0x00, 0x6A, 0x6A,
+        0x20, 0x00, 0x20, 0x01, 0x71, 0x45, 0x6A,
+        0x0B
+    };
+    /* the same in i64 over sign-extended operands, wrapped back to i32 */
+    static const uint8_t f_i64[] = {
+        0x20, 0x00, 0xAC, 0x20, 0x00, 0xAC, 0x20, 0x01, 0xAC, 0x7E, 0x7C,
+        0x20, 0x00, 0xAC, 0x20, 0x01, 0xAC, 0x86, 0x7C,
+        0x20, 0x01, 0xAC, 0x20, 0x00, 0xAC, 0x7C, 0x7C,
+        0x20, 0x00, 0xAC, 0x20, 0x01, 0xAC, 0x83, 0x50, 0xAD, 0x7C,
+        0xA7, 0x0B
+    };
+    const uint8_t* bodies[] = { f_i32, f_i64 };
+    const size_t body_sizes[] = { sizeof(f_i32), sizeof(f_i64) };
+    const uint8_t* locals[] = { NULL, NULL };
+    const size_t locals_sizes[] = { 0, 0 };
+    const uint8_t params[] = { VALTYPE_I32, VALTYPE_I32 };
+    ByteBuffer module_bytes = {0};
+    if (!build_module_with_locals(&module_bytes, bodies, body_sizes, locals, locals_sizes, 2,
+                                  NULL, NULL, 0, 0, 0, 0, kResultI32, 1, params, 2)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    static const i32 inputs[][2] = {
+        { 3, 5 }, { -7, 4 }, { 12, 33 }, { 0x40000000, 2 }, { -1, -1 }, { 6, 9 }, { 100000, 70 }
+    };
+    const size_t input_count = sizeof(inputs) / sizeof(inputs[0]);
+    int failed = 0;
+    for (int fuse = 0; fuse <= 1 && !failed; ++fuse) {
+        fa_Runtime* runtime = NULL;
+        fa_Job* job = NULL;
+        WasmModule* module = NULL;
+        if (!run_job(&module_bytes, &runtime, &job, &module)) {
+            bb_free(&module_bytes);
+            return 1;
+        }
+        runtime->jit_context.config.min_ram_bytes = 0;
+        runtime->jit_context.config.min_cpu_count = 1;
+        runtime->jit_context.config.min_hot_loop_hits = 0;
+        runtime->jit_context.config.min_executed_ops = 1;
+        runtime->jit_context.config.min_advantage_score = 0.0f;
+        runtime->jit_context.config.max_cache_percent = 0;
+        runtime->jit_context.config.fuse_ops = fuse != 0;
+        uint64_t fused_total = 0;
+        for (int round = 0; round < 3 && !failed; ++round) {
+            for (size_t i = 0; i < input_count && !failed; ++i) {
+                const i32 a = inputs[i][0];
+                const i32 b = inputs[i][1];
+                const u32 ua = (u32)a;
+                const u32 ub = (u32)b;
+                const u32 expect32 = ua + ua * ub + (ua << (ub & 31U)) + (ub + ua) + ((ua & ub) == 0 ? 1U : 0U);
+                const u64 la = (u64)(i64)a;
+                const u64 lb = (u64)(i64)b;
+                const u64 expect64 = la + la * lb + (la << (lb & 63U)) + (lb + la) + ((la & lb) == 0 ? 1U : 0U);
+                for (uint32_t f = 0; f < 2 && !failed; ++f) {
+                    i32 result = 0;
+                    const i32 expect = f == 0 ? (i32)expect32 : (i32)(u32)expect64;
+                    if (osr_call(runtime, job, f, a, b, &result) != FA_RUNTIME_OK || result != expect) {
+                        printf("fused pairs: fuse=%d f%u(%d, %d) = %d, expected %d\n", fuse, f, a, b, result, expect);
+                        failed = 1;
+                    }
+                    fused_total += runtime->jit_fused_executions;
+                }
+            }
+        }
+        if (!failed && (fuse ? fused_total == 0 : fused_total != 0)) {
+            printf("fused pairs: fuse=%d fused executions %llu\n", fuse, (unsigned long long)fused_total);
+            failed = 1;
+        }
+        cleanup_job(runtime, job, module, NULL, NULL);
+    }
+    bb_free(&module_bytes);
+    return failed;
+}
+
 /* Runs `f64.const value; (0xFC sub); end` as a one-shot i32-returning function
  * and checks the i32 payload. Exercises the scalar saturating truncation
  * conversions directly with hand-built bytecode. Returns 1 on match. */
@@ -3641,6 +6377,76 @@ static int test_bulk_memory_copy_fill(void) {
     return 0;
 }
 
+static void emit_bulk_memory_op(ByteBuffer* instructions, uint32_t subopcode, int32_t a, int32_t b, int32_t c) {
+    bb_write_byte(instructions, 0x41);
+    bb_write_sleb32(instructions, a);
+    bb_write_byte(instructions, 0x41);
+    bb_write_sleb32(instructions, b);
+    bb_write_byte(instructions, 0x41);
+    bb_write_sleb32(instructions, c);
+    bb_write_byte(instructions, 0xFC);
+    bb_write_uleb(instructions, subopcode);
+    bb_write_uleb(instructions, 0);
+    if (subopcode == 10) {
+        bb_write_uleb(instructions, 0);
+    }
+}
+
+static int test_bulk_memory_kernel_paths(void) {
+    /* Function 0: a misaligned fill and a disjoint 1 MiB copy (above the
+       streaming threshold when built with a lowered FA_BULK_NONTEMPORAL_BYTES),
+       then overlapping copies in both directions.
+       Function 1: a copy whose destination runs one byte past the end. */
+    const int32_t big = 0x100000;
+    ByteBuffer instructions = {0};
+    emit_bulk_memory_op(&instructions, 11, 3, 0x5A, big + 100);
+    emit_bulk_memory_op(&instructions, 10, 0x101000, 3, big);
+    emit_bulk_memory_op(&instructions, 10, 0x240001, 0x240000, 200);
+    emit_bulk_memory_op(&instructions, 10, 0x250000, 0x250003, 200);
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 1);
+    bb_write_byte(&instructions, 0x0B);
+
+    ByteBuffer trap_instructions = {0};
+    emit_bulk_memory_op(&trap_instructions, 10, 0x27FFFF, 0, 2);
+    bb_write_byte(&trap_instructions, 0x41);
+    bb_write_sleb32(&trap_instructions, 1);
+    bb_write_byte(&trap_instructions, 0x0B);
+
+    const uint8_t* bodies[] = { instructions.data, trap_instructions.data };
+    const size_t sizes[] = { instructions.size, trap_instructions.size };
+    ByteBuffer module_bytes = {0};
+    fa_Runtime* runtime = NULL;
+    fa_Job* job = NULL;
+    WasmModule* module = NULL;
+    int failed = !build_module(&module_bytes, bodies, sizes, 2, 1, 40, 0, 0, kResultI32, 1, NULL, 0) ||
+                 !run_job(&module_bytes, &runtime, &job, &module);
+    bb_free(&trap_instructions);
+    if (failed) {
+        cleanup_job(runtime, job, module, &module_bytes, &instructions);
+        return 1;
+    }
+
+    uint8_t* data = runtime->memories[0].data;
+    for (uint32_t i = 0; i < 203; ++i) {
+        data[0x240000 + i] = (uint8_t)(i * 7U);
+        data[0x250000 + i] = (uint8_t)(i * 7U);
+    }
+    failed = !execute_expect_i32(runtime, job, 0, 1);
+    failed = failed || data[2] != 0 || data[3] != 0x5A || data[3 + big + 99] != 0x5A || data[3 + big + 100] != 0;
+    for (uint32_t i = 0; !failed && i < (uint32_t)big; ++i) {
+        failed = data[0x101000 + i] != 0x5A;
+    }
+    failed = failed || data[0x101000 + big] != 0 || data[0x240000] != 0;
+    for (uint32_t i = 0; !failed && i < 200; ++i) {
+        failed = data[0x240001 + i] != (uint8_t)(i * 7U) || data[0x250000 + i] != (uint8_t)((i + 3U) * 7U);
+    }
+    failed = failed || fa_Runtime_executeJob(runtime, job, 1) != FA_RUNTIME_ERR_TRAP || data[0x27FFFF] != 0;
+
+    cleanup_job(runtime, job, module, &module_bytes, &instructions);
+    return failed ? 1 : 0;
+}
+
 static int test_data_segment_init(void) {
     ByteBuffer memory_payload = {0};
     bb_write_uleb(&memory_payload, 1);
@@ -3802,6 +6608,474 @@ static int test_data_segment_active(void) {
     return 0;
 }
 
+static int test_memory_image_copy_on_write(void) {
+    ByteBuffer memory_payload = {0};
+    bb_write_uleb(&memory_payload, 1);
+    bb_write_byte(&memory_payload, 0x00);
+    bb_write_uleb(&memory_payload, 1);
+
+    ByteBuffer data_payload = {0};
+    bb_write_uleb(&data_payload, 1);
+    bb_write_uleb(&data_payload, 0);
+    bb_write_byte(&data_payload, 0x41);
+    bb_write_sleb32(&data_payload, 0);
+    bb_write_byte(&data_payload, 0x0B);
+    bb_write_uleb(&data_payload, 4);
+    bb_write_byte(&data_payload, 0x2A);
+    bb_write_byte(&data_payload, 0);
+    bb_write_byte(&data_payload, 0);
+    bb_write_byte(&data_payload, 0);
+
+    /* Returns the image value at 0, then overwrites it with 99. */
+    ByteBuffer instructions = {0};
+    emit_i32_load_const(&instructions, 0);
+    emit_i32_store_const(&instructions, 0, 99);
+    bb_write_byte(&instructions, 0x0B);
+
+    const uint8_t* bodies[] = { instructions.data };
+    const size_t sizes[] = { instructions.size };
+    ByteBuffer module_bytes = {0};
+    int built = build_module_with_sections(&module_bytes, bodies, sizes, 1, NULL, &memory_payload, NULL,
+                                           &data_payload, kResultI32, 1, NULL, 0);
+    bb_free(&memory_payload);
+    bb_free(&data_payload);
+    if (!built) {
+        cleanup_job(NULL, NULL, NULL, &module_bytes, &instructions);
+        return 1;
+    }
+    WasmModule* module = load_module_from_bytes(module_bytes.data, module_bytes.size);
+    fa_RuntimeMemoryImage* image = module ? fa_RuntimeMemoryImage_create(module) : NULL;
+    if (!image) {
+        cleanup_job(NULL, NULL, module, &module_bytes, &instructions);
+        return 1;
+    }
+
+    fa_Runtime* runtimes[2] = { NULL, NULL };
+    fa_Job* jobs[2] = { NULL, NULL };
+    int failed = 0;
+    for (int i = 0; i < 2 && !failed; ++i) {
+        runtimes[i] = fa_Runtime_init();
+        if (!runtimes[i]) {
+            failed = 1;
+            break;
+        }
+        fa_Runtime_setMemoryImage(runtimes[i], image);
+        failed = fa_Runtime_attachModule(runtimes[i], module) != FA_RUNTIME_OK ||
+                 (jobs[i] = fa_Runtime_createJob(runtimes[i])) == NULL ||
+                 !runtimes[i]->memories[0].from_image ||
+                 runtimes[i]->memories[0].data[0] != 0x2A;
+#if defined(__linux__)
+        if (!failed && fa_RuntimeMemoryImage_isShared(image)) {
+            failed = runtimes[i]->memories[0].mapped_bytes != FA_WASM_PAGE_SIZE;
+        }
+#endif
+        /* The previous instance's write must not leak into the image. */
+        failed = failed || !execute_expect_i32(runtimes[i], jobs[i], 0, 42) ||
+                 runtimes[i]->memories[0].data[0] != 99;
+    }
+
+    /* Growing an image-backed memory moves it to a private heap buffer. */
+    if (!failed) {
+        uint64_t prev_pages = 0;
+        bool grew = false;
+        failed = fa_Runtime_growMemory(runtimes[0], 0, 1, &prev_pages, &grew) != FA_RUNTIME_OK ||
+                 !grew || prev_pages != 1 || runtimes[0]->memories[0].mapped_bytes != 0 ||
+                 runtimes[0]->memories[0].size_bytes != 2U * FA_WASM_PAGE_SIZE ||
+                 runtimes[0]->memories[0].data[0] != 99;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        if (runtimes[i] && jobs[i]) {
+            (void)fa_Runtime_destroyJob(runtimes[i], jobs[i]);
+        }
+        fa_Runtime_free(runtimes[i]);
+    }
+    fa_RuntimeMemoryImage_free(image);
+    cleanup_job(NULL, NULL, module, &module_bytes, &instructions);
+    return failed ? 1 : 0;
+}
+
+static int write_module_file(const char* path, const ByteBuffer* module_bytes) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return 0;
+    }
+    const size_t written = fwrite(module_bytes->data, 1, module_bytes->size, file);
+    const int closed = fclose(file);
+    return written == module_bytes->size && closed == 0;
+}
+
+/* Module with one memory, an active data segment storing 42 at address 0, and
+   a function returning i32.load(0). Shared by the file-backed loader tests. */
+static int build_data_load_module(ByteBuffer* module_bytes) {
+    ByteBuffer memory_payload = {0};
+    bb_write_uleb(&memory_payload, 1);
+    bb_write_byte(&memory_payload, 0x00);
+    bb_write_uleb(&memory_payload, 1);
+
+    ByteBuffer data_payload = {0};
+    bb_write_uleb(&data_payload, 1);
+    bb_write_uleb(&data_payload, 0);
+    bb_write_byte(&data_payload, 0x41);
+    bb_write_sleb32(&data_payload, 0);
+    bb_write_byte(&data_payload, 0x0B);
+    bb_write_uleb(&data_payload, 4);
+    bb_write_byte(&data_payload, 0x2A);
+    bb_write_byte(&data_payload, 0);
+    bb_write_byte(&data_payload, 0);
+    bb_write_byte(&data_payload, 0);
+
+    ByteBuffer instructions = {0};
+    emit_i32_load_const(&instructions, 0);
+    bb_write_byte(&instructions, 0x0B);
+
+    const uint8_t* bodies[] = { instructions.data };
+    const size_t sizes[] = { instructions.size };
+    int built = build_module_with_sections(module_bytes, bodies, sizes, 1, NULL, &memory_payload, NULL,
+                                           &data_payload, kResultI32, 1, NULL, 0);
+    bb_free(&memory_payload);
+    bb_free(&data_payload);
+    bb_free(&instructions);
+    return built;
+}
+
+static int run_file_module_expect_42(WasmModule* module) {
+    fa_Runtime* runtime = fa_Runtime_init();
+    fa_Job* job = NULL;
+    int ok = runtime && fa_Runtime_attachModule(runtime, module) == FA_RUNTIME_OK &&
+             (job = fa_Runtime_createJob(runtime)) != NULL &&
+             execute_expect_i32(runtime, job, 0, 42);
+    if (runtime && job) {
+        (void)fa_Runtime_destroyJob(runtime, job);
+    }
+    fa_Runtime_free(runtime);
+    return ok;
+}
+
+static int test_module_file_mmap_load(void) {
+    const char* path = "fayasm_test_mapped_module.wasm";
+    ByteBuffer module_bytes = {0};
+    if (!build_data_load_module(&module_bytes) || !write_module_file(path, &module_bytes)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    WasmModule* module = load_module_from_path(path, 0);
+    int failed = !module;
+#if defined(__unix__) || defined(__APPLE__)
+    /* Desktop POSIX targets parse file-backed modules through the mapped buffer. */
+    failed = failed || !module->buffer_mapped || module->fd >= 0 || module->buffer_size != module_bytes.size;
+#endif
+    failed = failed || !run_file_module_expect_42(module);
+    wasm_module_free(module);
+    remove(path);
+    bb_free(&module_bytes);
+    return failed ? 1 : 0;
+}
+
+static int test_module_file_buffered_read_ahead(void) {
+    const char* path = "fayasm_test_buffered_module.wasm";
+    ByteBuffer module_bytes = {0};
+    if (!build_data_load_module(&module_bytes) || !write_module_file(path, &module_bytes)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    /* Requests below the minimum clamp up to one 512-byte block. */
+    WasmModule* module = parse_file_module(wasm_module_init_buffered(path, 100), 0);
+    int failed = !module || module_bytes.size > WASM_READ_AHEAD_MIN_BYTES;
+    failed = failed || module->buffer || module->fd < 0 || module->read_ahead_capacity != WASM_READ_AHEAD_MIN_BYTES;
+    failed = failed || !run_file_module_expect_42(module);
+    /* Header, section scan, loaders and body fetches all seek inside one block. */
+    failed = failed || module->read_ahead_refills != 1;
+    wasm_module_free(module);
+
+    module = wasm_module_init_buffered(path, 3000);
+    failed = failed || !module || module->read_ahead_capacity != WASM_READ_AHEAD_MAX_BYTES;
+    wasm_module_free(module);
+    remove(path);
+    bb_free(&module_bytes);
+    return failed ? 1 : 0;
+}
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t at;    /* feed cursor */
+    size_t piece; /* feed chunk size */
+    uint32_t reads;
+} StreamSource;
+
+static size_t stream_source_read(void* user, uint64_t offset, uint8_t* out, size_t size) {
+    StreamSource* source = (StreamSource*)user;
+    source->reads++;
+    if (offset >= source->size) {
+        return 0;
+    }
+    const size_t left = source->size - (size_t)offset;
+    const size_t chunk = size < left ? size : left;
+    memcpy(out, source->data + offset, chunk);
+    return chunk;
+}
+
+static size_t stream_source_feed(void* user, uint8_t* out, size_t capacity) {
+    StreamSource* source = (StreamSource*)user;
+    size_t chunk = source->size - source->at;
+    if (chunk > source->piece) {
+        chunk = source->piece;
+    }
+    if (chunk > capacity) {
+        chunk = capacity;
+    }
+    memcpy(out, source->data + source->at, chunk);
+    source->at += chunk;
+    return chunk;
+}
+
+/* Streaming parser: the module arrives in chunks of any size, metadata is
+ * usable as soon as the code section starts, bodies and data segments are
+ * read back through the reader, and the result matches the file path's
+ * module. Forged section sizes and late sections are handled too. */
+static int test_module_stream_parse(void) {
+    ByteBuffer module_bytes = {0};
+    if (!build_data_load_module(&module_bytes)) {
+        return 1;
+    }
+    /* A trailing custom section: its name is kept, its payload skipped. */
+    static const uint8_t custom[] = { 0x00, 0x09, 0x04, 'm', 'e', 't', 'a', 0xDE, 0xAD, 0xBE, 0xEF };
+    for (size_t i = 0; i < sizeof(custom); ++i) {
+        bb_write_byte(&module_bytes, custom[i]);
+    }
+    WasmModule* reference = load_module_from_bytes(module_bytes.data, module_bytes.size);
+    uint8_t reference_digest[FA_SHA256_BYTES];
+    int failed = !reference || wasm_module_content_digest(reference, reference_digest) != 0;
+    StreamSource source = { module_bytes.data, module_bytes.size, 0, 0, 0 };
+    const WasmModuleReader reader = { stream_source_read, &source };
+    static const size_t pieces[] = { 1, 3, 64, 4096 };
+    for (size_t p = 0; p < sizeof(pieces) / sizeof(pieces[0]) && !failed; ++p) {
+        WasmModuleStream* stream = wasm_module_stream_begin(&reader);
+        /* Up to just past the body's size: metadata is in, the body is not. */
+        const size_t split = reference ? (size_t)reference->functions[0].body_offset : 0;
+        for (size_t at = 0; at < split && !failed; at += pieces[p]) {
+            const size_t chunk = split - at < pieces[p] ? split - at : pieces[p];
+            failed = wasm_module_stream_feed(stream, module_bytes.data + at, chunk) != 0;
+        }
+        const WasmModule* partial = wasm_module_stream_module(stream);
+        if (!failed && (wasm_module_stream_bodies_ready(stream) != 0 || partial->num_functions != 1 ||
+                        partial->num_types != reference->num_types || partial->num_memories != 1 ||
+                        partial->functions[0].body_offset != reference->functions[0].body_offset ||
+                        partial->num_windows != 0)) {
+            printf("stream parse: partial state after %zu-byte chunks\n", pieces[p]);
+            failed = 1;
+        }
+        /* From here on nothing is buffered: the data segment is recorded by
+           offset and read back through the reader like the body. */
+        for (size_t at = split; at < module_bytes.size && !failed; at += pieces[p]) {
+            const size_t chunk = module_bytes.size - at < pieces[p] ? module_bytes.size - at : pieces[p];
+            failed = wasm_module_stream_feed(stream, module_bytes.data + at, chunk) != 0 ||
+                     partial->num_windows != 0;
+        }
+        failed = failed || wasm_module_stream_bodies_ready(stream) != 1;
+        WasmModule* module = wasm_module_stream_finish(stream);
+        uint8_t digest[FA_SHA256_BYTES];
+        if (failed || !module || module->num_windows != 0 || module->num_sections != reference->num_sections ||
+            module->functions[0].body_size != reference->functions[0].body_size ||
+            module->num_data_segments != 1 || module->data_segments[0].size != 4 ||
+            module->data_segments[0].data != NULL ||
+            module->data_segments[0].data_offset != reference->data_segments[0].data_offset ||
+            module->sections[module->num_sections - 1U].type != SECTION_CUSTOM ||
+            !module->sections[module->num_sections - 1U].name ||
+            strcmp(module->sections[module->num_sections - 1U].name, "meta") != 0 ||
+            wasm_module_content_digest(module, digest) != 0 ||
+            memcmp(digest, reference_digest, FA_SHA256_BYTES) != 0) {
+            printf("stream parse: module mismatch after %zu-byte chunks\n", pieces[p]);
+            failed = 1;
+        }
+        source.reads = 0;
+        failed = failed || !run_file_module_expect_42(module) || source.reads == 0;
+        wasm_module_free(module);
+    }
+
+    /* Pull-style wrapper. */
+    source.at = 0;
+    source.piece = 5;
+    WasmModule* pulled = failed ? NULL : wasm_module_parse_stream(stream_source_feed, &source, &reader);
+    failed = failed || !pulled || !run_file_module_expect_42(pulled);
+    wasm_module_free(pulled);
+
+    /* A truncated module fails at finish; a bad magic fails on the spot. */
+    WasmModuleStream* stream = wasm_module_stream_begin(&reader);
+    failed = failed || wasm_module_stream_feed(stream, module_bytes.data, module_bytes.size - 1U) != 0 ||
+             wasm_module_stream_finish(stream) != NULL;
+    static const uint8_t bad_magic[] = { 0x00, 0x61, 0x73, 0x6E, 0x01, 0x00, 0x00, 0x00 };
+    stream = wasm_module_stream_begin(NULL);
+    failed = failed || wasm_module_stream_feed(stream, bad_magic, sizeof(bad_magic)) == 0 ||
+             wasm_module_stream_feed(stream, module_bytes.data + 8, 1) == 0;
+    wasm_module_stream_abort(stream);
+
+    /* A section claiming ~4 GiB allocates only for the bytes that arrive. */
+    static const uint8_t forged[] = { 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x01 };
+    stream = wasm_module_stream_begin(NULL);
+    const WasmModule* growing = wasm_module_stream_module(stream);
+    failed = failed || wasm_module_stream_feed(stream, module_bytes.data, 8) != 0 ||
+             wasm_module_stream_feed(stream, forged, sizeof(forged) - 1U) != 0 || growing->num_windows != 1 ||
+             growing->windows[0].capacity != 0 ||
+             wasm_module_stream_feed(stream, forged + sizeof(forged) - 1U, 1) != 0 ||
+             growing->windows[0].capacity > WASM_READ_AHEAD_BYTES || wasm_module_stream_finish(stream) != NULL;
+
+    /* A known section after the code and data sections is malformed, not
+       silently dropped. */
+    static const uint8_t late_type[] = { 0x01, 0x01, 0x00 };
+    stream = wasm_module_stream_begin(&reader);
+    failed = failed || wasm_module_stream_feed(stream, module_bytes.data, module_bytes.size) != 0 ||
+             wasm_module_stream_feed(stream, late_type, sizeof(late_type)) == 0;
+    wasm_module_stream_abort(stream);
+    wasm_module_free(reference);
+    bb_free(&module_bytes);
+    return failed ? 1 : 0;
+}
+
+#define TEST_SEGMENT_BYTES 600U
+
+static uint8_t segment_pattern_byte(uint32_t i) {
+    return (uint8_t)(i * 7U + 3U);
+}
+
+/* One memory, an active 600-byte pattern segment at 0 and a passive 4-byte
+   segment; the function memory.inits the passive one to 1024 and returns
+   i32.load(1024) + i32.load8_u(599). */
+static int build_segment_view_module(ByteBuffer* module_bytes) {
+    ByteBuffer memory_payload = {0};
+    bb_write_uleb(&memory_payload, 1);
+    bb_write_byte(&memory_payload, 0x00);
+    bb_write_uleb(&memory_payload, 1);
+
+    ByteBuffer data_payload = {0};
+    bb_write_uleb(&data_payload, 2);
+    bb_write_uleb(&data_payload, 0);
+    bb_write_byte(&data_payload, 0x41);
+    bb_write_sleb32(&data_payload, 0);
+    bb_write_byte(&data_payload, 0x0B);
+    bb_write_uleb(&data_payload, TEST_SEGMENT_BYTES);
+    for (uint32_t i = 0; i < TEST_SEGMENT_BYTES; ++i) {
+        bb_write_byte(&data_payload, segment_pattern_byte(i));
+    }
+    bb_write_uleb(&data_payload, 1);
+    bb_write_uleb(&data_payload, 4);
+    bb_write_byte(&data_payload, 0x11);
+    bb_write_byte(&data_payload, 0x22);
+    bb_write_byte(&data_payload, 0x33);
+    bb_write_byte(&data_payload, 0x44);
+
+    ByteBuffer instructions = {0};
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 1024);
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 0);
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 4);
+    bb_write_byte(&instructions, 0xFC);
+    bb_write_uleb(&instructions, 8);
+    bb_write_uleb(&instructions, 1);
+    bb_write_uleb(&instructions, 0);
+    emit_i32_load_const(&instructions, 1024);
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, (int32_t)TEST_SEGMENT_BYTES - 1);
+    bb_write_byte(&instructions, 0x2D);
+    bb_write_uleb(&instructions, 0);
+    bb_write_uleb(&instructions, 0);
+    bb_write_byte(&instructions, 0x6A);
+    bb_write_byte(&instructions, 0x0B);
+
+    const uint8_t* bodies[] = { instructions.data };
+    const size_t sizes[] = { instructions.size };
+    int built = build_module_with_sections(module_bytes, bodies, sizes, 1, NULL, &memory_payload, NULL,
+                                           &data_payload, kResultI32, 1, NULL, 0);
+    bb_free(&memory_payload);
+    bb_free(&data_payload);
+    bb_free(&instructions);
+    return built;
+}
+
+static int run_segment_view_module(WasmModule* module, PagedBackingState* paged) {
+    const i32 expected = (i32)(0x44332211U + segment_pattern_byte(TEST_SEGMENT_BYTES - 1U));
+    fa_Runtime* runtime = fa_Runtime_init();
+    fa_Job* job = NULL;
+    int ok = runtime != NULL;
+    if (ok && paged) {
+        const fa_RuntimeMemoryPaging paging = {
+            TEST_PAGED_PAGE_BYTES,
+            2U,
+            paged_page_spill_hook,
+            paged_page_load_hook,
+            paged
+        };
+        ok = fa_Runtime_setMemoryPaging(runtime, &paging) == FA_RUNTIME_OK;
+    }
+    ok = ok && fa_Runtime_attachModule(runtime, module) == FA_RUNTIME_OK &&
+         (job = fa_Runtime_createJob(runtime)) != NULL &&
+         execute_expect_i32(runtime, job, 0, expected);
+    if (ok) {
+        uint8_t bytes[TEST_SEGMENT_BYTES];
+        ok = fa_Runtime_readMemory(runtime, 0, 0, bytes, sizeof(bytes)) == FA_RUNTIME_OK;
+        for (uint32_t i = 0; ok && i < TEST_SEGMENT_BYTES; ++i) {
+            ok = bytes[i] == segment_pattern_byte(i);
+        }
+    }
+    if (runtime && job) {
+        (void)fa_Runtime_destroyJob(runtime, job);
+    }
+    fa_Runtime_free(runtime);
+    return ok;
+}
+
+/* Data segments borrow the module buffer instead of copying it; fd-backed
+ * modules keep no segment bytes and stream them for active and memory.init
+ * copies, including into paged memory. */
+static int test_module_data_segments_zero_copy(void) {
+    const char* path = "fayasm_test_segment_module.wasm";
+    ByteBuffer module_bytes = {0};
+    if (!build_segment_view_module(&module_bytes) || !write_module_file(path, &module_bytes)) {
+        bb_free(&module_bytes);
+        return 1;
+    }
+    WasmModule* module = load_module_from_bytes(module_bytes.data, module_bytes.size);
+    int failed = !module || module->num_data_segments != 2;
+    for (uint32_t i = 0; !failed && i < 2; ++i) {
+        const WasmDataSegment* segment = &module->data_segments[i];
+        failed = segment->data_owned || segment->data != module->buffer + segment->data_offset;
+    }
+    failed = failed || !run_segment_view_module(module, NULL);
+    uint8_t probe[4];
+    failed = failed || wasm_read_data_segment(module, 1, 0, probe, 4) != 0 || probe[3] != 0x44;
+    failed = failed || wasm_read_data_segment(module, 1, 1, probe, 4) == 0;
+    failed = failed || wasm_read_data_segment(module, 2, 0, probe, 1) == 0;
+    wasm_module_free(module);
+
+    module = load_module_from_path(path, 0);
+    failed = failed || !module;
+#if defined(__unix__) || defined(__APPLE__)
+    failed = failed || !module->buffer_mapped || module->data_segments[0].data_owned ||
+             module->data_segments[0].data != module->buffer + module->data_segments[0].data_offset;
+#endif
+    failed = failed || !run_segment_view_module(module, NULL);
+    wasm_module_free(module);
+
+    PagedBackingState* paged = (PagedBackingState*)calloc(1, sizeof(PagedBackingState));
+    module = parse_file_module(wasm_module_init_buffered(path, 100), 0);
+    failed = failed || !paged || !module || module->buffer;
+    for (uint32_t i = 0; !failed && i < 2; ++i) {
+        failed = module->data_segments[i].data != NULL || module->data_segments[i].data_owned;
+    }
+    failed = failed || !run_segment_view_module(module, NULL);
+    failed = failed || !run_segment_view_module(module, paged);
+    failed = failed || wasm_read_data_segment(module, 0, TEST_SEGMENT_BYTES - 1U, probe, 1) != 0 ||
+             probe[0] != segment_pattern_byte(TEST_SEGMENT_BYTES - 1U);
+    wasm_module_free(module);
+    free(paged);
+    remove(path);
+    bb_free(&module_bytes);
+    return failed ? 1 : 0;
+}
+
 static int test_data_drop_trap(void) {
     ByteBuffer memory_payload = {0};
     bb_write_uleb(&memory_payload, 1);
@@ -3876,6 +7150,166 @@ static int test_data_drop_trap(void) {
     return status == FA_RUNTIME_ERR_TRAP ? 0 : 1;
 }
 
+/* Large enough to cover whole pages once mapped. */
+#define TEST_PASSIVE_BYTES (3U * 65536U)
+
+/* Copies `module_bytes` with a data count section (id 12) of `count` in front
+   of the code section. */
+static int splice_data_count_section(const ByteBuffer* module_bytes, uint32_t count, ByteBuffer* out) {
+    size_t pos = 8;
+    while (pos < module_bytes->size && module_bytes->data[pos] != 0x0A) {
+        uint32_t size = 0;
+        uint32_t shift = 0;
+        size_t p = pos + 1;
+        uint8_t byte;
+        do {
+            byte = module_bytes->data[p++];
+            size |= (uint32_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        pos = p + size;
+    }
+    if (pos >= module_bytes->size) {
+        return 0;
+    }
+    for (size_t i = 0; i < pos; ++i) {
+        bb_write_byte(out, module_bytes->data[i]);
+    }
+    bb_write_byte(out, 0x0C);
+    bb_write_uleb(out, 1);
+    bb_write_uleb(out, count);
+    for (size_t i = pos; i < module_bytes->size; ++i) {
+        bb_write_byte(out, module_bytes->data[i]);
+    }
+    return 1;
+}
+
+static int run_passive_release_job(fa_Runtime* runtime) {
+    fa_Job* job = fa_Runtime_createJob(runtime);
+    int ok = job != NULL;
+    ok = ok && execute_expect_i32(runtime, job, 0, (i32)0x44332211);
+    if (job) {
+        (void)fa_Runtime_destroyJob(runtime, job);
+    }
+    return ok;
+}
+
+/* The data count section is parsed and checked against the data section;
+ * attached runtimes pin passive segments until data.drop, and the last unpin
+ * frees a streamed copy (with release_passive_data) or gives back the pages
+ * of an mmap'd module, which later instances still read. */
+static int test_passive_data_release(void) {
+    ByteBuffer memory_payload = {0};
+    bb_write_uleb(&memory_payload, 1);
+    bb_write_byte(&memory_payload, 0x00);
+    bb_write_uleb(&memory_payload, 1);
+
+    ByteBuffer data_payload = {0};
+    bb_write_uleb(&data_payload, 1);
+    bb_write_uleb(&data_payload, 1);
+    bb_write_uleb(&data_payload, TEST_PASSIVE_BYTES);
+    bb_write_byte(&data_payload, 0x11);
+    bb_write_byte(&data_payload, 0x22);
+    bb_write_byte(&data_payload, 0x33);
+    bb_write_byte(&data_payload, 0x44);
+    for (uint32_t k = 4; k < TEST_PASSIVE_BYTES; ++k) {
+        bb_write_byte(&data_payload, segment_pattern_byte(k));
+    }
+
+    ByteBuffer instructions = {0};
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 1024);
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 0);
+    bb_write_byte(&instructions, 0x41);
+    bb_write_sleb32(&instructions, 4);
+    bb_write_byte(&instructions, 0xFC);
+    bb_write_uleb(&instructions, 8);
+    bb_write_uleb(&instructions, 0);
+    bb_write_uleb(&instructions, 0);
+    bb_write_byte(&instructions, 0xFC);
+    bb_write_uleb(&instructions, 9);
+    bb_write_uleb(&instructions, 0);
+    emit_i32_load_const(&instructions, 1024);
+    bb_write_byte(&instructions, 0x0B);
+
+    const uint8_t* bodies[] = { instructions.data };
+    const size_t sizes[] = { instructions.size };
+    ByteBuffer plain = {0};
+    ByteBuffer counted = {0};
+    ByteBuffer mismatched = {0};
+    int failed = !build_module_with_sections(&plain, bodies, sizes, 1, NULL, &memory_payload, NULL,
+                                             &data_payload, kResultI32, 1, NULL, 0) ||
+                 !splice_data_count_section(&plain, 1, &counted) ||
+                 !splice_data_count_section(&plain, 2, &mismatched);
+    bb_free(&memory_payload);
+    bb_free(&data_payload);
+    bb_free(&instructions);
+
+    WasmModule* module = failed ? NULL : load_module_from_bytes(plain.data, plain.size);
+    failed = failed || !module || module->has_data_count;
+    wasm_module_free(module);
+    module = failed ? NULL : load_module_from_bytes(mismatched.data, mismatched.size);
+    failed = failed || module != NULL;
+    module = failed ? NULL : load_module_from_bytes(counted.data, counted.size);
+    failed = failed || !module || !module->has_data_count || module->data_count != 1;
+    fa_Runtime* runtime = fa_Runtime_init();
+    failed = failed || !runtime || fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK ||
+             module->data_segments[0].live != 1U || !run_passive_release_job(runtime) ||
+             module->data_segments[0].live != 0U;
+    fa_Runtime_free(runtime);
+    wasm_module_free(module);
+
+    /* A stream with no reader keeps a heap copy of the passive segment; with
+       release_passive_data the last unpin frees it for good. */
+    for (int release = 0; release < 2 && !failed; ++release) {
+        WasmModuleStream* stream = wasm_module_stream_begin(NULL);
+        failed = !stream || wasm_module_stream_feed(stream, counted.data, counted.size) != 0;
+        if (failed) {
+            wasm_module_stream_abort(stream);
+            break;
+        }
+        module = wasm_module_stream_finish(stream);
+        failed = !module || !module->has_data_count || !module->data_segments[0].data_owned;
+        if (!failed) {
+            module->release_passive_data = release != 0;
+            uint8_t probe[4] = {0};
+            failed = !wasm_pin_data_segment(module, 0) || !wasm_pin_data_segment(module, 0);
+            wasm_unpin_data_segment(module, 0);
+            failed = failed || module->data_segments[0].data == NULL;
+            wasm_unpin_data_segment(module, 0);
+            if (release) {
+                failed = failed || module->data_segments[0].data != NULL ||
+                         wasm_pin_data_segment(module, 0) || wasm_read_data_segment(module, 0, 0, probe, 4) == 0;
+            } else {
+                failed = failed || module->data_segments[0].live != 0U ||
+                         wasm_read_data_segment(module, 0, 0, probe, 4) != 0 || probe[3] != 0x44;
+            }
+        }
+        wasm_module_free(module);
+    }
+
+    /* mmap'd modules give the pages back and still serve later instances. */
+    const char* path = "fayasm_test_passive_release.wasm";
+    module = failed || !write_module_file(path, &counted) ? NULL : load_module_from_path(path, 0);
+    failed = failed || !module || !module->has_data_count;
+    for (int round = 0; round < 2 && !failed; ++round) {
+        runtime = fa_Runtime_init();
+        failed = !runtime || fa_Runtime_attachModule(runtime, module) != FA_RUNTIME_OK ||
+                 !run_passive_release_job(runtime);
+        fa_Runtime_free(runtime);
+    }
+    uint8_t last = 0;
+    failed = failed || wasm_read_data_segment(module, 0, TEST_PASSIVE_BYTES - 1U, &last, 1) != 0 ||
+             last != segment_pattern_byte(TEST_PASSIVE_BYTES - 1U);
+    wasm_module_free(module);
+    remove(path);
+    bb_free(&plain);
+    bb_free(&counted);
+    bb_free(&mismatched);
+    return failed ? 1 : 0;
+}
+
 static int test_table_init_copy(void) {
     ByteBuffer table_payload = {0};
     bb_write_uleb(&table_payload, 1);
@@ -6911,16 +10345,37 @@ static const TestCase kTestCases[] = {
     TEST_CASE("test_jit_cache_dispatch", "jit", "src/fa_runtime.c (jit dispatch), src/fa_jit.c (prepared ops)", test_jit_cache_dispatch),
     TEST_CASE("test_microcode_float_select", "jit", "src/fa_ops.c (microcode table)", test_microcode_float_select),
     TEST_CASE("test_jit_program_opcode_roundtrip", "jit", "src/fa_jit.c (opcode serialization)", test_jit_program_opcode_roundtrip),
+    TEST_CASE("test_jit_native_differential", "jit", "src/fa_jit_native*.c (baseline compiler, x86-64/AArch64 backends), src/fa_runtime.c (native dispatch/call_slow)", test_jit_native_differential),
+    TEST_CASE("test_jit_native_code_cache", "jit", "src/fa_jit_code_cache.c (slabs, W^X installs), src/fa_runtime.c (hotness eviction, pinning, parked code)", test_jit_native_code_cache),
+    TEST_CASE("test_jit_background_workers", "jit", "src/fa_jit_worker.c (thread pool), src/fa_runtime.c (async submit, safe-point installs)", test_jit_background_workers),
+    TEST_CASE("test_jit_fused_op_pairs", "jit", "src/fa_ops.c (fused pair handlers), src/fa_jit.c (fa_jit_program_fuse), src/fa_runtime.c (fused dispatch)", test_jit_fused_op_pairs),
+    TEST_CASE("test_jit_osr_loop", "jit", "src/fa_runtime.c (tier-up counters, OSR frame transfer), src/fa_jit_native.c (OSR entry)", test_jit_osr_loop),
+    TEST_CASE("test_jit_host_spills_memory", "jit", "src/fa_runtime.c (runtime_jit_native_call_slow memory reload)", test_jit_host_spills_memory),
+    TEST_CASE("test_jit_closure_tier", "jit", "src/fa_jit_closure.c (closure lowering, handlers, record spill envelope), src/fa_runtime.c (closure dispatch/OSR)", test_jit_closure_tier),
+    TEST_CASE("test_aot_emit_c", "jit", "src/fa_aot.c (C emitter), src/fa_aot_runtime.h (generated-code helpers), src/fa_runtime.c (AOT dispatch)", test_aot_emit_c),
+    TEST_CASE("test_jit_persisted_code", "jit", "src/fa_jit_persist.c (code cache files), src/fa_runtime.c (persisted native/closure install), src/fa_wasm.c (module digest)", test_jit_persisted_code),
+    TEST_CASE("test_sha256_digest", "jit", "src/fa_sha256.c (module digests for the code cache and bundles)", test_sha256_digest),
+    TEST_CASE("test_jit_parallel_prescan", "jit", "src/fa_runtime.c (parallel prescan, control side tables), src/fa_jit_worker.c (prescan tasks)", test_jit_parallel_prescan),
+    TEST_CASE("test_jit_lazy_prescan", "jit", "src/fa_runtime.c (first-call prescan, callee prefetch)", test_jit_lazy_prescan),
     TEST_CASE("test_spill_envelope_jit_roundtrip", "offload", "src/fa_jit.c (versioned spill envelope), fa_jit_program_serialize/deserialize", test_spill_envelope_jit_roundtrip),
     TEST_CASE("test_spill_envelope_jit_real_wasm", "offload", "src/fa_jit.c (versioned spill envelope) via real wasm + live spill hook", test_spill_envelope_jit_real_wasm),
     TEST_CASE("test_host_import_call", "runtime", "src/fa_runtime.c (host imports), src/fa_wasm.c (import parsing)", test_host_import_call),
+    TEST_CASE("test_module_name_index", "runtime", "src/fa_wasm.c (export/import hash index), src/fa_runtime.c (host import slots)", test_module_name_index),
+    TEST_CASE("test_module_metadata_arena", "loader", "src/fa_wasm.c (metadata arena, interned names)", test_module_metadata_arena),
+    TEST_CASE("test_compiled_module_instances", "runtime", "src/fa_runtime.c (fa_CompiledModule, fa_Instance)", test_compiled_module_instances),
+    TEST_CASE("test_compiled_module_threads", "runtime", "src/fa_runtime.c (fa_Instance on several threads, tier-up code shared through fa_CompiledModule)", test_compiled_module_threads),
+    TEST_CASE("test_module_bundle", "runtime", "src/fa_runtime.c (module bundles), src/fa_wasm.c (canonical types)", test_module_bundle),
+    TEST_CASE("test_instantiation_pipeline", "runtime", "src/fa_runtime.c (runtime_segments_init, runtime_run_start), src/fa_wasm.c (wasm_load_start)", test_instantiation_pipeline),
+    TEST_CASE("test_start_calls_host_import", "runtime", "src/fa_runtime.c (runtime_run_start, host binding before attach)", test_start_calls_host_import),
     TEST_CASE("test_imported_memory_binding", "memory", "src/fa_runtime.c (host memory imports), src/fa_ops.c (load)", test_imported_memory_binding),
     TEST_CASE("test_imported_memory_rebind_after_attach", "memory", "src/fa_runtime.c (host memory rebind propagation)", test_imported_memory_rebind_after_attach),
     TEST_CASE("test_imported_table_binding", "table", "src/fa_runtime.c (host table imports), src/fa_ops.c (table.size)", test_imported_table_binding),
     TEST_CASE("test_imported_table_rebind_after_attach", "table", "src/fa_runtime.c (host table rebind propagation)", test_imported_table_rebind_after_attach),
     TEST_CASE("test_memory_spill_load_cycles", "offload", "src/fa_runtime.c (memory spill/load hooks)", test_memory_spill_load_cycles),
+    TEST_CASE("test_jit_eviction_policy_churn", "offload", "src/fa_runtime.c (LFU/CLOCK/round-robin eviction, aging, pinning)", test_jit_eviction_policy_churn),
     TEST_CASE("test_jit_eviction_trap_reload_cycles", "offload", "src/fa_runtime.c (jit eviction/load), trap hooks", test_jit_eviction_trap_reload_cycles),
     TEST_CASE("test_memory_grow_spill_load_roundtrip", "offload", "src/fa_runtime.c (memory grow + spill/load), fa_Runtime_loadMemory", test_memory_grow_spill_load_roundtrip),
+    TEST_CASE("test_memory_paged_demand_faults", "offload", "src/fa_runtime.c (demand-paged memory, CLOCK eviction, TLB), src/fa_ops.c (load/store/bulk)", test_memory_paged_demand_faults),
     TEST_CASE("test_spill_envelope_memory_roundtrip", "offload", "src/fa_runtime.c (versioned memory spill envelope), fa_Runtime_serializeMemory/deserializeMemory", test_spill_envelope_memory_roundtrip),
     TEST_CASE("test_wasm_sample_arithmetic", "wasm-sample", "wasm_samples/build/arithmetic.wasm", test_wasm_sample_arithmetic),
     TEST_CASE("test_wasm_sample_arithmetic_mul_add", "wasm-sample", "wasm_samples/build/arithmetic.wasm", test_wasm_sample_arithmetic_mul_add),
@@ -6954,9 +10409,16 @@ static const TestCase kTestCases[] = {
     TEST_CASE("test_memory64_grow_size", "memory64", "src/fa_ops.c (memory.grow), src/fa_runtime.c (grow)", test_memory64_grow_size),
     TEST_CASE("test_multi_memory_memarg", "memory", "src/fa_runtime.c (memarg decode), src/fa_ops.c (load/store)", test_multi_memory_memarg),
     TEST_CASE("test_bulk_memory_copy_fill", "bulk-memory", "src/fa_ops.c (op_bulk_memory)", test_bulk_memory_copy_fill),
+    TEST_CASE("test_bulk_memory_kernel_paths", "bulk-memory", "src/fa_bulk.c (streaming/overlap kernels), src/fa_ops.c (memory.copy bounds)", test_bulk_memory_kernel_paths),
     TEST_CASE("test_data_segment_init", "bulk-memory", "src/fa_ops.c (memory.init), src/fa_runtime.c (segments)", test_data_segment_init),
     TEST_CASE("test_data_segment_active", "bulk-memory", "src/fa_runtime.c (segments init)", test_data_segment_active),
+    TEST_CASE("test_memory_image_copy_on_write", "memory", "src/fa_runtime.c (shared memory image, memfd + MAP_PRIVATE / copy fallback, growMemory)", test_memory_image_copy_on_write),
+    TEST_CASE("test_module_file_mmap_load", "loader", "src/fa_wasm.c (mmap-backed wasm_module_init)", test_module_file_mmap_load),
+    TEST_CASE("test_module_file_buffered_read_ahead", "loader", "src/fa_wasm.c (wasm_module_init_buffered read-ahead)", test_module_file_buffered_read_ahead),
+    TEST_CASE("test_module_stream_parse", "loader", "src/fa_wasm.c (wasm_module_stream_* single-pass parser, reader-backed bodies)", test_module_stream_parse),
+    TEST_CASE("test_module_data_segments_zero_copy", "loader", "src/fa_wasm.c (borrowed data segments), src/fa_runtime.c (fa_Runtime_initMemory)", test_module_data_segments_zero_copy),
     TEST_CASE("test_data_drop_trap", "bulk-memory", "src/fa_ops.c (data.drop)", test_data_drop_trap),
+    TEST_CASE("test_passive_data_release", "bulk-memory", "src/fa_wasm.c (data count section, wasm_pin/unpin_data_segment), src/fa_ops.c (data.drop)", test_passive_data_release),
     TEST_CASE("test_table_init_copy", "table", "src/fa_ops.c (table.init/copy), src/fa_runtime.c (tables)", test_table_init_copy),
     TEST_CASE("test_table_fill_size", "table", "src/fa_ops.c (table.fill/size)", test_table_fill_size),
     TEST_CASE("test_externref_table_active_null_elem_expr", "table", "src/fa_wasm.c (element expr parsing), src/fa_runtime.c (segment init)", test_externref_table_active_null_elem_expr),